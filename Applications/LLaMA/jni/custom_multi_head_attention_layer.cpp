@@ -15,6 +15,7 @@
 #include <algorithm>
 #include <cmath>
 #include <custom_multi_head_attention_layer.h>
+#include <flash_attention.h>
 #include <layer_context.h>
 #include <nntrainer_error.h>
 #include <nntrainer_log.h>
@@ -28,8 +29,10 @@ MultiHeadAttentionLayer::MultiHeadAttentionLayer() :
   multi_head_attention_props(
     props::NumHeads(), props::ProjectedKeyDim(), props::ProjectedValueDim(),
     props::OutputShape(), props::DropOutRate(), props::ReturnAttentionWeight(),
-    props::AverageAttentionWeight(), props::MaxTimestep()),
+    props::AverageAttentionWeight(), props::MaxTimestep(),
+    props::KVCacheDataType()),
   sm(ActivationType::ACT_SOFTMAX),
+  tiled_attention(false),
   epsilon(1e-3),
   cache_index(0) {
   weight_idx.fill(std::numeric_limits<unsigned>::max());
@@ -68,8 +71,190 @@ enum AttentionParams {
   attention_weight,
   dropout_mask,
   attention_output,
+  attention_lse,
+  cache_key_scale,
+  cache_value_scale,
 };
 
+namespace {
+
+/**
+ * @brief     tiled attention over the projected tensors of
+ * [batch, 1, length, num_heads * dim]
+ *
+ * @param[in] dim shape of the attention
+ * @param[in] query projected query
+ * @param[in] key projected key
+ * @param[in] value projected value
+ * @param[in] mask additive attention mask, empty if not provided
+ * @param[in] scale scale factor of the attention score
+ * @param[in] causal_from position of the first query
+ * @param[out] output attention output
+ * @param[out] lse log-sum-exp of the attention score, empty if not needed
+ */
+void flashAttention(const FlashAttentionDim &dim, const Tensor &query,
+                    const Tensor &key, const Tensor &value, const Tensor &mask,
+                    float scale, int causal_from, Tensor &output,
+                    Tensor &lse) {
+  const unsigned int mask_rows = mask.empty() ? 0 : mask.size() / dim.kv_len;
+  float *lse_data = lse.empty() ? nullptr : lse.getData<float>();
+
+  if (query.getDataType() == ml::train::TensorDim::DataType::FP32) {
+    flash_attention_forward(
+      dim, query.getData<float>(), key.getData<float>(),
+      value.getData<float>(), mask.empty() ? nullptr : mask.getData<float>(),
+      mask_rows, scale, causal_from, output.getData<float>(), lse_data);
+  } else if (query.getDataType() == ml::train::TensorDim::DataType::FP16) {
+#ifdef ENABLE_FP16
+    flash_attention_forward(
+      dim, query.getData<_FP16>(), key.getData<_FP16>(),
+      value.getData<_FP16>(), mask.empty() ? nullptr : mask.getData<_FP16>(),
+      mask_rows, scale, causal_from, output.getData<_FP16>(), lse_data);
+#else
+    throw std::invalid_argument("enable-fp16 is not set");
+#endif
+  }
+}
+
+/**
+ * @brief     derivative of flashAttention
+ */
+void flashAttentionDeriv(const FlashAttentionDim &dim, const Tensor &query,
+                         const Tensor &key, const Tensor &value,
+                         const Tensor &mask, float scale, int causal_from,
+                         const Tensor &output, const Tensor &lse,
+                         const Tensor &d_output, Tensor &d_query,
+                         Tensor &d_key, Tensor &d_value, Tensor &d_mask) {
+  const unsigned int mask_rows = mask.empty() ? 0 : mask.size() / dim.kv_len;
+
+  if (query.getDataType() == ml::train::TensorDim::DataType::FP32) {
+    flash_attention_backward(
+      dim, query.getData<float>(), key.getData<float>(),
+      value.getData<float>(), mask.empty() ? nullptr : mask.getData<float>(),
+      mask_rows, scale, causal_from, output.getData<float>(),
+      lse.getData<float>(), d_output.getData<float>(),
+      d_query.getData<float>(), d_key.getData<float>(),
+      d_value.getData<float>(),
+      d_mask.empty() ? nullptr : d_mask.getData<float>());
+  } else if (query.getDataType() == ml::train::TensorDim::DataType::FP16) {
+#ifdef ENABLE_FP16
+    flash_attention_backward(
+      dim, query.getData<_FP16>(), key.getData<_FP16>(),
+      value.getData<_FP16>(), mask.empty() ? nullptr : mask.getData<_FP16>(),
+      mask_rows, scale, causal_from, output.getData<_FP16>(),
+      lse.getData<float>(), d_output.getData<_FP16>(),
+      d_query.getData<_FP16>(), d_key.getData<_FP16>(),
+      d_value.getData<_FP16>(),
+      d_mask.empty() ? nullptr : d_mask.getData<_FP16>());
+#else
+    throw std::invalid_argument("enable-fp16 is not set");
+#endif
+  }
+}
+
+/**
+ * @brief     row of the ring buffer cache which keeps the key/value of a
+ * position
+ *
+ * @param[in] pos absolute position of the token
+ * @param[in] capacity number of the rows of the cache
+ */
+inline unsigned int cacheRow(unsigned int pos, unsigned int capacity) {
+  return pos % capacity;
+}
+
+/**
+ * @brief     store projected keys/values to the cache of a narrower data type
+ *
+ * @param[in] rows projected keys/values of [num_rows, num_heads * dim]
+ * @param[out] cache key/value cache of int8 or half-precision
+ * @param[out] cache_scale scale of every head of the cached rows, only for the
+ * int8 cache
+ * @param[in] at row of the cache to store the first row, counted over the
+ * batches
+ * @param[in] num_heads number of heads
+ */
+void storeCache(const Tensor &rows, Tensor &cache, Tensor &cache_scale,
+                size_t at, unsigned int num_heads) {
+  const unsigned int width = cache.width();
+  const unsigned int num_rows = rows.size() / width;
+
+  if (cache.getDataType() == ml::train::TensorDim::DataType::QINT8) {
+    int8_t *dst = cache.getData<int8_t>() + at * width;
+    float *scales = cache_scale.getData<float>() + at * num_heads;
+    if (rows.getDataType() == ml::train::TensorDim::DataType::FP32) {
+      flash_attention_quantize(num_rows * num_heads, width / num_heads,
+                               rows.getData<float>(), dst, scales);
+    } else {
+#ifdef ENABLE_FP16
+      flash_attention_quantize(num_rows * num_heads, width / num_heads,
+                               rows.getData<_FP16>(), dst, scales);
+#else
+      throw std::invalid_argument("enable-fp16 is not set");
+#endif
+    }
+  } else {
+#ifdef ENABLE_FP16
+    const float *src = rows.getData<float>();
+    _FP16 *dst = cache.getData<_FP16>() + at * width;
+    for (size_t i = 0; i < (size_t)num_rows * width; ++i)
+      dst[i] = static_cast<_FP16>(src[i]);
+#else
+    throw std::invalid_argument("enable-fp16 is not set");
+#endif
+  }
+}
+
+/**
+ * @brief     flashAttention over the cache of a narrower data type than the
+ * query
+ *
+ * @param[in] dim shape of the attention
+ * @param[in] query projected query
+ * @param[in] cache_key key cache of int8 or half-precision
+ * @param[in] key_scale scale of the int8 key cache, empty otherwise
+ * @param[in] cache_value value cache of int8 or half-precision
+ * @param[in] value_scale scale of the int8 value cache, empty otherwise
+ * @param[in] scale scale factor of the attention score
+ * @param[in] causal_from position of the first query
+ * @param[out] output attention output
+ */
+void flashAttentionCache(const FlashAttentionDim &dim, const Tensor &query,
+                         const Tensor &cache_key, const Tensor &key_scale,
+                         const Tensor &cache_value, const Tensor &value_scale,
+                         float scale, int causal_from, Tensor &output) {
+  if (cache_key.getDataType() == ml::train::TensorDim::DataType::QINT8) {
+    if (query.getDataType() == ml::train::TensorDim::DataType::FP32) {
+      flash_attention_forward(
+        dim, query.getData<float>(), cache_key.getData<int8_t>(),
+        key_scale.getData<float>(), cache_value.getData<int8_t>(),
+        value_scale.getData<float>(), nullptr, 0, scale, causal_from,
+        output.getData<float>(), nullptr);
+    } else {
+#ifdef ENABLE_FP16
+      flash_attention_forward(
+        dim, query.getData<_FP16>(), cache_key.getData<int8_t>(),
+        key_scale.getData<float>(), cache_value.getData<int8_t>(),
+        value_scale.getData<float>(), nullptr, 0, scale, causal_from,
+        output.getData<_FP16>(), nullptr);
+#else
+      throw std::invalid_argument("enable-fp16 is not set");
+#endif
+    }
+  } else {
+#ifdef ENABLE_FP16
+    flash_attention_forward(dim, query.getData<float>(),
+                            cache_key.getData<_FP16>(),
+                            cache_value.getData<_FP16>(), nullptr, 0, scale,
+                            causal_from, output.getData<float>(), nullptr);
+#else
+    throw std::invalid_argument("enable-fp16 is not set");
+#endif
+  }
+}
+
+} // namespace
+
 void MultiHeadAttentionLayer::finalize(InitLayerContext &context) {
   NNTR_THROW_IF(context.getNumInputs() < 3 || context.getNumInputs() > 4,
                 std::invalid_argument)
@@ -292,13 +477,39 @@ void MultiHeadAttentionLayer::finalize(InitLayerContext &context) {
   TensorDim cache_key_dim(
     {batch_size, 1, max_timestep, num_heads * projected_key_dim_prop},
     activation_type);
+  TensorDim cache_value_dim(
+    {batch_size, 1, max_timestep, num_heads * projected_value_dim_prop},
+    activation_type);
+
+  /** the cache may be kept narrower than the activation. An int8 cache keeps
+   * a scale for every head of every cached row */
+  const props::KVCacheDataTypeInfo::Enum kv_cache_dtype =
+    std::get<props::KVCacheDataType>(multi_head_attention_props).get();
+  if (kv_cache_dtype == props::KVCacheDataTypeInfo::Enum::fp16) {
+#ifndef ENABLE_FP16
+    throw std::invalid_argument("enable-fp16 is not set");
+#endif
+    cache_key_dim.setDataType(ml::train::TensorDim::DataType::FP16);
+    cache_value_dim.setDataType(ml::train::TensorDim::DataType::FP16);
+  } else if (kv_cache_dtype == props::KVCacheDataTypeInfo::Enum::int8) {
+    cache_key_dim.setDataType(ml::train::TensorDim::DataType::QINT8);
+    cache_value_dim.setDataType(ml::train::TensorDim::DataType::QINT8);
+
+    TensorDim cache_scale_dim(
+      {batch_size, 1, max_timestep, num_heads},
+      {context.getFormat(), ml::train::TensorDim::DataType::FP32});
+    weight_idx[AttentionParams::cache_key_scale] = context.requestTensor(
+      cache_scale_dim, "cache_key_scale", Tensor::Initializer::NONE, false,
+      TensorLifespan::MAX_LIFESPAN);
+    weight_idx[AttentionParams::cache_value_scale] = context.requestTensor(
+      cache_scale_dim, "cache_value_scale", Tensor::Initializer::NONE, false,
+      TensorLifespan::MAX_LIFESPAN);
+  }
+
   weight_idx[AttentionParams::cache_key] =
     context.requestTensor(cache_key_dim, "cache_key", Tensor::Initializer::NONE,
                           true, TensorLifespan::MAX_LIFESPAN);
 
-  TensorDim cache_value_dim(
-    {batch_size, 1, max_timestep, num_heads * projected_value_dim_prop},
-    activation_type);
   weight_idx[AttentionParams::cache_value] = context.requestTensor(
     cache_value_dim, "cache_value", Tensor::Initializer::NONE, true,
     TensorLifespan::MAX_LIFESPAN);
@@ -311,12 +522,26 @@ void MultiHeadAttentionLayer::finalize(InitLayerContext &context) {
     //   attention_mask_dim, "attention_mask", Tensor::Initializer::NONE, false,
     //   TensorLifespan::FORWARD_FUNC_LIFESPAN);
   }
-  /** tensor for attention weight */
-  TensorDim attention_weight_dim(
-    {batch_size, num_heads, query_height, key_height}, activation_type);
-  weight_idx[AttentionParams::attention_weight] = context.requestTensor(
-    attention_weight_dim, "attention_weight", Tensor::Initializer::NONE, true,
-    TensorLifespan::ITERATION_LIFESPAN);
+  /** the attention weight is only materialized when it is returned or
+   * dropped out, otherwise only the log-sum-exp of every row is kept */
+  tiled_attention =
+    dropout_rate <= epsilon &&
+    return_attention_weight == props::ReturnAttentionWeightInfo::Enum::none;
+  if (tiled_attention) {
+    TensorDim attention_lse_dim(
+      {batch_size, num_heads, query_height, 1},
+      {context.getFormat(), ml::train::TensorDim::DataType::FP32});
+    weight_idx[AttentionParams::attention_lse] = context.requestTensor(
+      attention_lse_dim, "attention_lse", Tensor::Initializer::NONE, false,
+      TensorLifespan::ITERATION_LIFESPAN);
+  } else {
+    /** tensor for attention weight */
+    TensorDim attention_weight_dim(
+      {batch_size, num_heads, query_height, key_height}, activation_type);
+    weight_idx[AttentionParams::attention_weight] = context.requestTensor(
+      attention_weight_dim, "attention_weight", Tensor::Initializer::NONE, true,
+      TensorLifespan::ITERATION_LIFESPAN);
+  }
   if (dropout_rate > epsilon) {
     /** tensor for dropout mask */
     TensorDim dropout_mask_dim(
@@ -427,8 +652,6 @@ void MultiHeadAttentionLayer::forwarding(RunLayerContext &context,
   Tensor &projected_value =
     context.getTensor(weight_idx[AttentionParams::projected_value]);
 
-  Tensor &attention_weight =
-    context.getTensor(weight_idx[AttentionParams::attention_weight]);
   Tensor &attention_output =
     context.getTensor(weight_idx[AttentionParams::attention_output]);
 
@@ -456,6 +679,29 @@ void MultiHeadAttentionLayer::forwarding(RunLayerContext &context,
   apply_rotary_emb_tensor(projected_query, projected_query_dim_prop, 0);
   apply_rotary_emb_tensor(projected_key, projected_key_dim_prop, 0);
 
+  if (tiled_attention) {
+    Tensor &attention_lse =
+      context.getTensor(weight_idx[AttentionParams::attention_lse]);
+    const FlashAttentionDim attention_dim = {
+      batch_size, num_heads, query_height, key_height, key_height,
+      projected_query_dim_prop, projected_value_dim_prop};
+
+    /** causal attention */
+    flashAttention(attention_dim, projected_query, projected_key,
+                   projected_value, mask,
+                   1 / sqrt((float)projected_query_dim_prop), 0,
+                   attention_output, attention_lse);
+
+    attention_output.dot(fc_weight, output);
+    if (!disable_bias) {
+      output.add_i(fc_bias);
+    }
+    return;
+  }
+
+  Tensor &attention_weight =
+    context.getTensor(weight_idx[AttentionParams::attention_weight]);
+
   projected_query.reshape(
     TensorDim({batch_size, query_height, num_heads, projected_query_dim_prop}));
   projected_key.reshape(
@@ -597,7 +843,6 @@ void MultiHeadAttentionLayer::initial_incremental_forwarding(
   unsigned int max_timestep =
     std::get<props::MaxTimestep>(multi_head_attention_props).get();
 
-  bool cache_shift = false;
   unsigned int from = _from;
   unsigned int to = _to;
   if (to > max_timestep) {
@@ -696,67 +941,64 @@ void MultiHeadAttentionLayer::initial_incremental_forwarding(
   /** get tensors */
   Tensor &projected_query =
     context.getTensor(weight_idx[AttentionParams::projected_query]);
-  Tensor &projected_key =
-    context.getTensor(weight_idx[AttentionParams::projected_key]);
-  Tensor &projected_value =
-    context.getTensor(weight_idx[AttentionParams::projected_value]);
   Tensor &cache_key = context.getTensor(weight_idx[AttentionParams::cache_key]);
   Tensor &cache_value =
     context.getTensor(weight_idx[AttentionParams::cache_value]);
 
   TensorDim projected_query_dim = projected_query.getDim();
-  TensorDim projected_key_dim = projected_key.getDim();
-  TensorDim projected_value_dim = projected_value.getDim();
   TensorDim cache_key_dim = cache_key.getDim();
   TensorDim cache_value_dim = cache_value.getDim();
 
   TensorDim projected_query_step_dim = projected_query_dim;
 
-  TensorDim projected_key_step_dim = projected_key_dim;
-  TensorDim projected_value_step_dim = projected_value_dim;
   TensorDim cache_key_step_dim = cache_key_dim;
   TensorDim cache_value_step_dim = cache_value_dim;
   projected_query_step_dim.height(to);
 
-  projected_key_step_dim.height(to);
-  projected_value_step_dim.height(to);
   cache_key_step_dim.height(to);
   cache_value_step_dim.height(to);
 
   Tensor projected_query_step =
     projected_query.getSharedDataTensor(projected_query_step_dim, 0, true);
-  Tensor projected_key_step =
-    projected_key.getSharedDataTensor(projected_key_step_dim, 0, true);
-  Tensor projected_value_step =
-    projected_value.getSharedDataTensor(projected_value_step_dim, 0, true);
-
-  Tensor cache_key_step =
-    cache_key.getSharedDataTensor(cache_key_step_dim, 0, true);
-  Tensor cache_value_step =
-    cache_value.getSharedDataTensor(cache_value_step_dim, 0, true);
-
-  TensorDim cached_key_dim = {cache_key_dim.batch(), cache_key_dim.channel(),
-                              to, cache_key_dim.width(),
-                              cache_key.getTensorType()};
-  TensorDim cached_value_dim = {
-    cache_value_dim.batch(), cache_value_dim.channel(), to,
-    cache_value_dim.width(), cache_value.getTensorType()};
-  Tensor cached_key = cache_key.getSharedDataTensor(cached_key_dim, 0, true);
-  Tensor cached_value =
-    cache_value.getSharedDataTensor(cached_value_dim, 0, true);
 
-  Tensor &attention_weight =
-    context.getTensor(weight_idx[AttentionParams::attention_weight]);
+  /** a cache narrower than the activation is written after the keys/values
+   * of the step are projected and rotated in projected_key/projected_value */
+  const bool narrow_cache =
+    cache_key.getDataType() != projected_query.getDataType();
+  Tensor cache_key_step;
+  Tensor cache_value_step;
+  if (narrow_cache) {
+    Tensor &projected_key =
+      context.getTensor(weight_idx[AttentionParams::projected_key]);
+    Tensor &projected_value =
+      context.getTensor(weight_idx[AttentionParams::projected_value]);
+    cache_key_step_dim = projected_key.getDim();
+    cache_value_step_dim = projected_value.getDim();
+    cache_key_step_dim.height(to);
+    cache_value_step_dim.height(to);
+    cache_key_step = projected_key.getSharedDataTensor(cache_key_step_dim, 0,
+                                                       true);
+    cache_value_step = projected_value.getSharedDataTensor(
+      cache_value_step_dim, 0, true);
+  } else {
+    cache_key_step =
+      cache_key.getSharedDataTensor(cache_key_step_dim, 0, true);
+    cache_value_step =
+      cache_value.getSharedDataTensor(cache_value_step_dim, 0, true);
+  }
+  const bool quantized_cache =
+    cache_key.getDataType() == ml::train::TensorDim::DataType::QINT8;
+  Tensor &cache_key_scale =
+    quantized_cache
+      ? context.getTensor(weight_idx[AttentionParams::cache_key_scale])
+      : empty_tensor;
+  Tensor &cache_value_scale =
+    quantized_cache
+      ? context.getTensor(weight_idx[AttentionParams::cache_value_scale])
+      : empty_tensor;
+
   Tensor &attention_output =
     context.getTensor(weight_idx[AttentionParams::attention_output]);
-  TensorDim attention_weight_dim = attention_weight.getDim();
-
-  TensorDim attention_weight_step_dim = attention_weight_dim;
-  attention_weight_step_dim.height(to);
-  attention_weight_step_dim.width(to);
-
-  Tensor attention_weight_step =
-    attention_weight.getSharedDataTensor(attention_weight_step_dim, 0, true);
 
   TensorDim attention_output_dim = attention_output.getDim();
   TensorDim attention_output_step_dim = attention_output_dim;
@@ -787,63 +1029,31 @@ void MultiHeadAttentionLayer::initial_incremental_forwarding(
                           _from);
   apply_rotary_emb_tensor(cache_key_step, projected_key_dim_prop, _from);
 
-  projected_query_step.reshape(
-    TensorDim({batch_size, to, num_heads, projected_query_dim_prop}));
-
-  cached_key.reshape(
-    TensorDim({batch_size, to, num_heads, projected_key_dim_prop}));
-  cached_value.reshape(
-    TensorDim({batch_size, to, num_heads, projected_value_dim_prop}));
-
-  projected_query_step.transpose("1:0:2", projected_query_step);
-  cached_key.transpose("1:0:2", projected_key_step);
-  cached_value.transpose("1:0:2", projected_value_step);
-
-  projected_query_step.reshape(
-    TensorDim({batch_size * num_heads, 1, to, projected_query_dim_prop}));
-  projected_key_step.reshape(
-    TensorDim({batch_size * num_heads, 1, to, projected_key_dim_prop}));
-  projected_value_step.reshape(
-    TensorDim({batch_size * num_heads, 1, to, projected_value_dim_prop}));
-
-  attention_weight_step.reshape(TensorDim({batch_size * num_heads, 1, to, to}));
-  attention_output_step.reshape(
-    TensorDim({batch_size * num_heads, 1, to, projected_value_dim_prop}));
-
-  /** scaled dot product attention */
-  projected_query_step.dotBatched(projected_key_step, attention_weight_step,
-                                  false, true);
-  attention_weight_step.multiply_i(1 / sqrt((float)projected_query_dim_prop));
-
-  if (!from) {
-    unsigned int mask_size = attention_weight_step.getDim().width();
-    unsigned int mask_dim_height = mask_size;
-    unsigned int mask_dim_width = mask_size;
-
-    Tensor causal_mask(TensorDim{1, 1, mask_size, mask_size,
-                                 attention_weight_step.getTensorType()});
-
-    causal_mask.setZero();
-
-    for (unsigned int i = 0; i < mask_dim_height; ++i) {
-      for (unsigned int j = i + 1; j < mask_dim_width; ++j) {
-        causal_mask.setValue(
-          0, 0, i, j, _MASK_NUM(attention_weight.getTensorType().data_type));
-      }
+  /** attend the cached keys/values in place, query at position from + i
+   * attends keys up to from + i (causal) */
+  const unsigned int cache_height = cache_key_dim.height();
+  const FlashAttentionDim attention_dim = {
+    batch_size, num_heads, to, to, cache_height,
+    projected_query_dim_prop, projected_value_dim_prop};
+  if (narrow_cache) {
+    for (unsigned int b = 0; b < batch_size; ++b) {
+      storeCache(cache_key_step.getBatchSlice(b, 1), cache_key,
+                 cache_key_scale, b * cache_height + from, num_heads);
+      storeCache(cache_value_step.getBatchSlice(b, 1), cache_value,
+                 cache_value_scale, b * cache_height + from, num_heads);
     }
-
-    attention_weight_step.add_i(causal_mask);
+    flashAttentionCache(attention_dim, projected_query_step, cache_key,
+                        cache_key_scale, cache_value, cache_value_scale,
+                        1 / sqrt((float)projected_query_dim_prop), from,
+                        attention_output_step);
+  } else {
+    Tensor empty_lse;
+    flashAttention(attention_dim, projected_query_step, cache_key,
+                   cache_value, empty_tensor,
+                   1 / sqrt((float)projected_query_dim_prop), from,
+                   attention_output_step, empty_lse);
   }
 
-  sm.run_fn(attention_weight_step, attention_weight_step);
-
-  attention_weight_step.dotBatched(projected_value_step, attention_output_step);
-
-  attention_output_step.reshape(
-    TensorDim({batch_size, num_heads, to, projected_value_dim_prop}));
-
-  attention_output_step = attention_output_step.transpose("1:0:2");
-
   attention_output_step.reshape(
     TensorDim({batch_size * to, 1, 1, num_heads * projected_value_dim_prop}));
 
@@ -874,14 +1084,16 @@ void MultiHeadAttentionLayer::incremental_forwarding(RunLayerContext &context,
   unsigned int max_timestep =
     std::get<props::MaxTimestep>(multi_head_attention_props).get();
 
-  bool cache_shift = false;
-  unsigned int from = _from;
-  unsigned int to = _to;
-  if (to >= max_timestep) {
-    cache_shift = true;
-    from = max_timestep - 1;
-    to = max_timestep;
-  }
+  /** the cache is a ring buffer of the last max_timestep positions. Once the
+   * positions wrap around, a step of a single token overwrites the oldest row
+   * and attends every row, so the window slides without moving the cache */
+  const bool window_full = _to > max_timestep;
+  NNTR_THROW_IF(window_full && _to - _from != 1, std::invalid_argument)
+    << "a step of " << _to - _from
+    << " tokens can not slide the window of the cache of " << context.getName();
+  const unsigned int from = cacheRow(_from, max_timestep);
+  const unsigned int to = from + (_to - _from);
+  const unsigned int attended = window_full ? max_timestep : _to;
 
   const bool disable_bias =
     std::get<props::DisableBias>(*layer_impl_props).get();
@@ -1002,67 +1214,64 @@ void MultiHeadAttentionLayer::incremental_forwarding(RunLayerContext &context,
   /** get tensors */
   Tensor &projected_query =
     context.getTensor(weight_idx[AttentionParams::projected_query]);
-  Tensor &projected_key =
-    context.getTensor(weight_idx[AttentionParams::projected_key]);
-  Tensor &projected_value =
-    context.getTensor(weight_idx[AttentionParams::projected_value]);
   Tensor &cache_key = context.getTensor(weight_idx[AttentionParams::cache_key]);
   Tensor &cache_value =
     context.getTensor(weight_idx[AttentionParams::cache_value]);
 
   TensorDim projected_query_dim = projected_query.getDim();
-  TensorDim projected_key_dim = projected_key.getDim();
-  TensorDim projected_value_dim = projected_value.getDim();
   TensorDim cache_key_dim = cache_key.getDim();
   TensorDim cache_value_dim = cache_value.getDim();
 
   TensorDim projected_query_step_dim = projected_query_dim;
 
-  TensorDim projected_key_step_dim = projected_key_dim;
-  TensorDim projected_value_step_dim = projected_value_dim;
   TensorDim cache_key_step_dim = cache_key_dim;
   TensorDim cache_value_step_dim = cache_value_dim;
   projected_query_step_dim.height(to - from);
 
-  projected_key_step_dim.height(to);
-  projected_value_step_dim.height(to);
   cache_key_step_dim.height(to - from);
   cache_value_step_dim.height(to - from);
 
   Tensor projected_query_step =
     projected_query.getSharedDataTensor(projected_query_step_dim, 0, true);
-  Tensor projected_key_step =
-    projected_key.getSharedDataTensor(projected_key_step_dim, 0, true);
-  Tensor projected_value_step =
-    projected_value.getSharedDataTensor(projected_value_step_dim, 0, true);
-
-  Tensor cache_key_step = cache_key.getSharedDataTensor(
-    cache_key_step_dim, from * cache_key_dim.width(), true);
-  Tensor cache_value_step = cache_value.getSharedDataTensor(
-    cache_value_step_dim, from * cache_value_dim.width(), true);
-
-  TensorDim cached_key_dim = {cache_key_dim.batch(), cache_key_dim.channel(),
-                              to, cache_key_dim.width(),
-                              cache_key.getTensorType()};
-  TensorDim cached_value_dim = {
-    cache_value_dim.batch(), cache_value_dim.channel(), to,
-    cache_value_dim.width(), cache_value.getTensorType()};
-  Tensor cached_key = cache_key.getSharedDataTensor(cached_key_dim, 0, true);
-  Tensor cached_value =
-    cache_value.getSharedDataTensor(cached_value_dim, 0, true);
 
-  Tensor &attention_weight =
-    context.getTensor(weight_idx[AttentionParams::attention_weight]);
+  /** a cache narrower than the activation is written after the keys/values
+   * of the step are projected and rotated in projected_key/projected_value */
+  const bool narrow_cache =
+    cache_key.getDataType() != projected_query.getDataType();
+  Tensor cache_key_step;
+  Tensor cache_value_step;
+  if (narrow_cache) {
+    Tensor &projected_key =
+      context.getTensor(weight_idx[AttentionParams::projected_key]);
+    Tensor &projected_value =
+      context.getTensor(weight_idx[AttentionParams::projected_value]);
+    cache_key_step_dim = projected_key.getDim();
+    cache_value_step_dim = projected_value.getDim();
+    cache_key_step_dim.height(to - from);
+    cache_value_step_dim.height(to - from);
+    cache_key_step = projected_key.getSharedDataTensor(cache_key_step_dim, 0,
+                                                       true);
+    cache_value_step = projected_value.getSharedDataTensor(
+      cache_value_step_dim, 0, true);
+  } else {
+    cache_key_step = cache_key.getSharedDataTensor(
+      cache_key_step_dim, from * cache_key_dim.width(), true);
+    cache_value_step = cache_value.getSharedDataTensor(
+      cache_value_step_dim, from * cache_value_dim.width(), true);
+  }
+  const bool quantized_cache =
+    cache_key.getDataType() == ml::train::TensorDim::DataType::QINT8;
+  Tensor &cache_key_scale =
+    quantized_cache
+      ? context.getTensor(weight_idx[AttentionParams::cache_key_scale])
+      : empty_tensor;
+  Tensor &cache_value_scale =
+    quantized_cache
+      ? context.getTensor(weight_idx[AttentionParams::cache_value_scale])
+      : empty_tensor;
+
   Tensor &attention_output =
     context.getTensor(weight_idx[AttentionParams::attention_output]);
-  TensorDim attention_weight_dim = attention_weight.getDim();
-
-  TensorDim attention_weight_step_dim = attention_weight_dim;
-  attention_weight_step_dim.height(to - from);
-  attention_weight_step_dim.width(to);
-
-  Tensor attention_weight_step =
-    attention_weight.getSharedDataTensor(attention_weight_step_dim, 0, true);
 
   TensorDim attention_output_dim = attention_output.getDim();
   TensorDim attention_output_step_dim = attention_output_dim;
@@ -1090,66 +1299,37 @@ void MultiHeadAttentionLayer::incremental_forwarding(RunLayerContext &context,
     cache_value_step.add_i(value_fc_bias);
   }
 
+  /** the keys are rotated at their absolute positions before being cached,
+   * so the rows of the ring buffer need no order */
   apply_rotary_emb_tensor(projected_query_step, projected_query_dim_prop,
                           _from);
   apply_rotary_emb_tensor(cache_key_step, projected_key_dim_prop, _from);
 
-  projected_query_step.reshape(
-    TensorDim({batch_size, 1, num_heads, projected_query_dim_prop}));
-  cached_key.reshape(
-    TensorDim({batch_size, to, num_heads, projected_key_dim_prop}));
-  cached_value.reshape(
-    TensorDim({batch_size, to, num_heads, projected_value_dim_prop}));
-
-  projected_query_step.transpose("1:0:2", projected_query_step);
-  cached_key.transpose("1:0:2", projected_key_step);
-  cached_value.transpose("1:0:2", projected_value_step);
-
-  projected_query_step.reshape(
-    TensorDim({batch_size * num_heads, 1, 1, projected_query_dim_prop}));
-  projected_key_step.reshape(
-    TensorDim({batch_size * num_heads, 1, to, projected_key_dim_prop}));
-  projected_value_step.reshape(
-    TensorDim({batch_size * num_heads, 1, to, projected_value_dim_prop}));
-
-  attention_weight_step.reshape(TensorDim({batch_size * num_heads, 1, 1, to}));
-  attention_output_step.reshape(
-    TensorDim({batch_size * num_heads, 1, 1, projected_value_dim_prop}));
-
-  /** scaled dot product attention */
-  projected_query_step.dotBatched(projected_key_step, attention_weight_step,
-                                  false, true);
-  attention_weight_step.multiply_i(1 / sqrt((float)projected_query_dim_prop));
-
-  if (!from) {
-    unsigned int mask_size = attention_weight_step.getDim().width();
-    unsigned int mask_dim_height = mask_size;
-    unsigned int mask_dim_width = mask_size;
-
-    Tensor causal_mask(TensorDim{1, 1, mask_size, mask_size,
-                                 attention_weight_step.getTensorType()});
-
-    causal_mask.setZero();
-
-    for (unsigned int i = 0; i < mask_dim_height; ++i) {
-      for (unsigned int j = i + 1; j < mask_dim_width; ++j) {
-        causal_mask.setValue(
-          0, 0, i, j, _MASK_NUM(attention_weight.getTensorType().data_type));
-      }
+  /** attend the cached keys/values in place, the i-th query of the step
+   * attends the first attended - (to - from) + i + 1 rows (causal) */
+  const unsigned int cache_height = cache_key_dim.height();
+  const FlashAttentionDim attention_dim = {
+    batch_size, num_heads, to - from, attended, cache_height,
+    projected_query_dim_prop, projected_value_dim_prop};
+  if (narrow_cache) {
+    for (unsigned int b = 0; b < batch_size; ++b) {
+      storeCache(cache_key_step.getBatchSlice(b, 1), cache_key,
+                 cache_key_scale, b * cache_height + from, num_heads);
+      storeCache(cache_value_step.getBatchSlice(b, 1), cache_value,
+                 cache_value_scale, b * cache_height + from, num_heads);
     }
-
-    attention_weight_step.add_i(causal_mask);
+    flashAttentionCache(attention_dim, projected_query_step, cache_key,
+                        cache_key_scale, cache_value, cache_value_scale,
+                        1 / sqrt((float)projected_query_dim_prop),
+                        attended - (to - from), attention_output_step);
+  } else {
+    Tensor empty_lse;
+    flashAttention(attention_dim, projected_query_step, cache_key,
+                   cache_value, empty_tensor,
+                   1 / sqrt((float)projected_query_dim_prop),
+                   attended - (to - from), attention_output_step, empty_lse);
   }
 
-  sm.run_fn(attention_weight_step, attention_weight_step);
-
-  attention_weight_step.dotBatched(projected_value_step, attention_output_step);
-
-  attention_output_step.reshape(
-    TensorDim({batch_size, num_heads, to - from, projected_value_dim_prop}));
-
-  attention_output_step = attention_output_step.transpose("1:0:2");
-
   attention_output_step.reshape(TensorDim(
     {batch_size * (to - from), 1, 1, num_heads * projected_value_dim_prop}));
 
@@ -1157,32 +1337,6 @@ void MultiHeadAttentionLayer::incremental_forwarding(RunLayerContext &context,
   if (!disable_bias) {
     output_step.add_i(fc_bias);
   }
-
-  if (cache_shift) {
-    if (cache_key.getDataType() == ml::train::TensorDim::DataType::FP32) {
-      float *buf = cache_key.getAddress<float>(0, 0, 1, 0);
-      float *dbuf = cache_key.getAddress<float>(0, 0, 0, 0);
-      memcpy(dbuf, buf, (cache_key.size() - cache_key.width()) * sizeof(float));
-      buf = cache_value.getAddress<float>(0, 0, 1, 0);
-      dbuf = cache_value.getAddress<float>(0, 0, 0, 0);
-      memcpy(dbuf, buf,
-             (cache_value.size() - cache_value.width()) * sizeof(float));
-    } else if (cache_key.getDataType() ==
-               ml::train::TensorDim::DataType::FP16) {
-#ifdef ENABLE_FP16
-
-      _FP16 *buf = cache_key.getAddress<_FP16>(0, 0, 1, 0);
-      _FP16 *dbuf = cache_key.getAddress<_FP16>(0, 0, 0, 0);
-      memcpy(dbuf, buf, (cache_key.size() - cache_key.width()) * sizeof(_FP16));
-      buf = cache_value.getAddress<_FP16>(0, 0, 1, 0);
-      dbuf = cache_value.getAddress<_FP16>(0, 0, 0, 0);
-      memcpy(dbuf, buf,
-             (cache_key.size() - cache_value.width()) * sizeof(_FP16));
-#else
-      throw std::invalid_argument("enable-fp16 is not set");
-#endif
-    }
-  }
 }
 
 void MultiHeadAttentionLayer::calcCommonDerivative(RunLayerContext &context) {
@@ -1229,6 +1383,39 @@ void MultiHeadAttentionLayer::calcCommonDerivative(RunLayerContext &context) {
   Tensor &d_projected_value =
     context.getTensorGrad(weight_idx[AttentionParams::projected_value]);
 
+  if (tiled_attention) {
+    Tensor &mask = provide_attention_mask
+                     ? context.getInput(INOUT_INDEX::MASK)
+                     : empty_tensor;
+    Tensor &d_mask = provide_attention_mask
+                       ? context.getOutgoingDerivative(INOUT_INDEX::MASK)
+                       : empty_tensor;
+    Tensor &attention_output =
+      context.getTensor(weight_idx[AttentionParams::attention_output]);
+    Tensor &d_attention_output =
+      context.getTensorGrad(weight_idx[AttentionParams::attention_output]);
+    Tensor &attention_lse =
+      context.getTensor(weight_idx[AttentionParams::attention_lse]);
+
+    const unsigned int batch_size = query.getDim().batch();
+    const unsigned int query_height = query.getDim().height();
+    const unsigned int key_height = key.getDim().height();
+    const FlashAttentionDim attention_dim = {
+      batch_size, num_heads, query_height, key_height, key_height,
+      projected_query_dim_prop, projected_value_dim_prop};
+
+    d_attention_output.dot_deriv_wrt_1(fc_weight, incoming_derivative);
+
+    /** attention weight is recomputed tile by tile from the saved lse */
+    flashAttentionDeriv(attention_dim, projected_query, projected_key,
+                        projected_value, mask,
+                        1 / sqrt((float)projected_query_dim_prop), 0,
+                        attention_output, attention_lse, d_attention_output,
+                        d_projected_query, d_projected_key, d_projected_value,
+                        d_mask);
+    return;
+  }
+
   Tensor &attention_weight =
     context.getTensor(weight_idx[AttentionParams::attention_weight]);
   Tensor &d_attention_weight =
@@ -1521,7 +1708,17 @@ void MultiHeadAttentionLayer::setBatch(RunLayerContext &context,
   context.updateTensor(weight_idx[AttentionParams::projected_value], batch);
   context.updateTensor(weight_idx[AttentionParams::cache_key], batch);
   context.updateTensor(weight_idx[AttentionParams::cache_value], batch);
-  context.updateTensor(weight_idx[AttentionParams::attention_weight], batch);
+  if (std::get<props::KVCacheDataType>(multi_head_attention_props).get() ==
+      props::KVCacheDataTypeInfo::Enum::int8) {
+    context.updateTensor(weight_idx[AttentionParams::cache_key_scale], batch);
+    context.updateTensor(weight_idx[AttentionParams::cache_value_scale],
+                         batch);
+  }
+  if (tiled_attention) {
+    context.updateTensor(weight_idx[AttentionParams::attention_lse], batch);
+  } else {
+    context.updateTensor(weight_idx[AttentionParams::attention_weight], batch);
+  }
   if (dropout_rate > epsilon) {
     context.updateTensor(weight_idx[AttentionParams::dropout_mask], batch);
   }
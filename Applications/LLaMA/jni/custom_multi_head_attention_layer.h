@@ -123,13 +123,16 @@ private:
   std::tuple<props::NumHeads, props::ProjectedKeyDim, props::ProjectedValueDim,
              props::OutputShape, props::DropOutRate,
              props::ReturnAttentionWeight, props::AverageAttentionWeight,
-             props::MaxTimestep>
+             props::MaxTimestep, props::KVCacheDataType>
     multi_head_attention_props; /**< multi_head_attention layer properties */
 
   ActiFunc sm; /** softmax activation operation */
-  std::array<unsigned int, 16>
+  std::array<unsigned int, 19>
     weight_idx; /**< indices of the weights and tensors */
 
+  bool tiled_attention; /**< compute attention tile by tile without storing
+                           the attention weight */
+
   /**
    * @brief     to protect overflow
    */
@@ -187,113 +190,63 @@ private:
    * @brief     apply rotary embedding
    * @param[in] in input tensor
    * @param[in] dim hidden dim size
-   * @param[in] from sequence order
+   * @param[in] from absolute position of the first row, which may exceed
+   * max_timestep once the cache slides
    */
   void apply_rotary_emb_tensor(Tensor &in, unsigned int dim,
                                unsigned int from) {
-    Tensor out(in.getDim());
-    float value = 0;
-    float transformed_value = 0.0;
     unsigned int half_ = dim / 2;
     unsigned int max_timestep =
       std::get<props::MaxTimestep>(multi_head_attention_props).get();
 
-    std::vector<float> *cos_;
-    std::vector<float> *sin_;
-
-    if (from >= max_timestep) {
-      cos_ = new std::vector<float>(dim);
-      sin_ = new std::vector<float>(dim);
+    /** the angles of a position past the precomputed ones */
+    std::vector<float> cos_pos(dim), sin_pos(dim);
+
+    /** the pairs (k, k + half_) of every head are rotated in place */
+    for (unsigned int b = 0; b < in.batch(); b++) {
+      for (unsigned int c = 0; c < in.channel(); c++) {
+        for (unsigned int h = 0; h < in.height(); h++) {
+          const unsigned int pos = from + h;
+          const float *cos_;
+          const float *sin_;
+          if (pos < max_timestep) {
+            cos_ = (*freqs_cos)[pos].data();
+            sin_ = (*freqs_sin)[pos].data();
+          } else {
 #ifdef USE_NEON
-      calc_trigonometric_vals_dup(half_, freqs.data(), cos_->data(),
-                                  sin_->data(), from);
+            calc_trigonometric_vals_dup(half_, freqs.data(), cos_pos.data(),
+                                        sin_pos.data(), pos);
 #else
-      for (unsigned int i = 0; i < half_; ++i) {
-        float angle = from * freqs[i];
-        (*cos_)[i] = std::cos(angle);
-        (*cos_)[i + half_] = std::cos(angle); // repeated 2 times
-
-        (*sin_)[i] = std::sin(angle);
-        (*sin_)[i + half_] = std::sin(angle); // repeated 2 times
-      }
-#endif
-    }
+            for (unsigned int i = 0; i < half_; ++i) {
+              float angle = pos * freqs[i];
+              cos_pos[i] = std::cos(angle);
+              cos_pos[i + half_] = std::cos(angle); // repeated 2 times
 
-    if (in.getDataType() == ml::train::TensorDim::DataType::FP32) {
-      for (unsigned int b = 0; b < in.batch(); b++) {
-        for (unsigned int c = 0; c < in.channel(); c++) {
-          for (unsigned int h = 0; h < in.height(); h++) {
-            if (from < max_timestep) {
-              cos_ = &(*freqs_cos)[from + h];
-              sin_ = &(*freqs_sin)[from + h];
-            }
-
-            for (unsigned int w = 0; w < in.width(); w = w + dim) {
-              for (unsigned int k = 0; k < dim; k++) {
-                unsigned int span = w + k;
-                value = in.getValue<float>(b, c, h, span);
-
-                if (k < half_) {
-                  transformed_value =
-                    -1.0 * in.getValue<float>(b, c, h, span + half_);
-                } else {
-                  transformed_value = in.getValue<float>(b, c, h, span - half_);
-                }
-                value = value * (*cos_)[k] + transformed_value * (*sin_)[k];
-                out.setValue(b, c, h, span, value);
-              }
+              sin_pos[i] = std::sin(angle);
+              sin_pos[i + half_] = std::sin(angle); // repeated 2 times
             }
+#endif
+            cos_ = cos_pos.data();
+            sin_ = sin_pos.data();
           }
-        }
-      }
-    } else if (in.getDataType() == ml::train::TensorDim::DataType::FP16) {
+
+          if (in.getDataType() == ml::train::TensorDim::DataType::FP32) {
+            float *row = in.getData<float>() + in.getIndex(b, c, h, 0);
+            for (unsigned int w = 0; w < in.width(); w = w + dim)
+              rotary_emb(half_, row + w, cos_, sin_);
+          } else if (in.getDataType() ==
+                     ml::train::TensorDim::DataType::FP16) {
 #ifdef ENABLE_FP16
-      for (unsigned int b = 0; b < in.batch(); b++) {
-        for (unsigned int c = 0; c < in.channel(); c++) {
-          for (unsigned int h = 0; h < in.height(); h++) {
-            if (from < max_timestep) {
-              cos_ = &(*freqs_cos)[from + h];
-              sin_ = &(*freqs_sin)[from + h];
-            }
-            for (unsigned int w = 0; w < in.width(); w = w + dim) {
-#ifdef USE_NEON
-              compute_rotary_embedding_value(
-                dim, half_, w, in.getData<_FP16>() + in.getIndex(b, c, h, 0),
-                out.getData<_FP16>() + out.getIndex(b, c, h, 0), cos_->data(),
-                sin_->data());
+            _FP16 *row = in.getData<_FP16>() + in.getIndex(b, c, h, 0);
+            for (unsigned int w = 0; w < in.width(); w = w + dim)
+              rotary_emb(half_, row + w, cos_, sin_);
 #else
-              for (unsigned int k = 0; k < dim; k++) {
-                unsigned int span = w + k;
-                value = static_cast<float>(in.getValue<_FP16>(b, c, h, span));
-
-                if (k < half_) {
-                  transformed_value =
-                    -1.0 * static_cast<float>(
-                             in.getValue<_FP16>(b, c, h, half_ + span));
-                } else {
-                  transformed_value = static_cast<float>(
-                    in.getValue<_FP16>(b, c, h, span - half_));
-                }
-                out.setValue(
-                  b, c, h, span,
-                  static_cast<_FP16>(value * (*cos_)[k] +
-                                     transformed_value * (*sin_)[k]));
-              }
+            throw std::invalid_argument("Error: enable-fp16 is not enabled");
 #endif
-            }
           }
         }
       }
-#else
-      throw std::invalid_argument("Error: enable-fp16 is not enabled");
-#endif
-    }
-
-    if (from >= max_timestep) {
-      delete cos_;
-      delete sin_;
     }
-    in.copy(out);
   }
 
   /**
@@ -16,6 +16,7 @@
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <random>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -24,19 +25,14 @@
 #include <model.h>
 #include <optimizer.h>
 
-#include <app_context.h>
+#include <bpe_tokenizer.h>
 #include <custom_multi_head_attention_layer.h>
-#include <rms_norm.h>
-#include <rotary_embedding.h>
-#include <swiglu.h>
+#include <token_sampler.h>
 #include <transpose_layer.h>
 
-#if defined(DENABLE_ENCODER)
-#include "json.hpp"
+#if defined(ENABLE_ENCODER)
 #include <codecvt>
-#include <encoder.hpp>
 #include <locale>
-using json = nlohmann::json;
 #endif
 
 using LayerHandle = std::shared_ptr<ml::train::Layer>;
@@ -58,6 +54,9 @@ int MAX_SEQ_LEN = 1024;
 int NUM_TO_GENERATE = 100;
 
 constexpr unsigned int INIT_SEQ_LEN = 28;
+constexpr unsigned int PREFILL_CHUNK = 8;
+/** data type of the key/value cache: activation, fp16 or int8 */
+std::string const KV_CACHE_DTYPE = "activation";
 unsigned int batch_size = 1;
 unsigned int epoch = 1;
 
@@ -102,64 +101,6 @@ static std::string withKey(const std::string &key,
   return ss.str();
 }
 
-/**
- * @brief Apply temperature & top-k & top-p to logits
- * @return Max logit for softmax
- */
-float applyTKP(float *logits, int len, float temperature, unsigned int top_k,
-               float top_p) {
-  // Apply temperature & Sort logits
-  std::vector<std::pair<int, float>> top_indices_and_logits;
-  for (int i = 0; i < len; ++i) {
-    if (temperature > 1e-5)
-      logits[i] = logits[i] / temperature;
-    top_indices_and_logits.push_back({i, logits[i]});
-  }
-  sort(top_indices_and_logits.begin(), top_indices_and_logits.end(),
-       [](auto &a, auto &b) { return a.second > b.second; });
-
-  // Accumulate logits
-  float cum_prob = 0;
-  unsigned int top_index = 0;
-  while (cum_prob <= top_p && top_index < top_k) {
-    cum_prob += top_indices_and_logits[top_index].second;
-    ++top_index;
-  }
-
-  // Apply Top-K and Top-P
-  std::fill_n(logits, sizeof(len), -INFINITY);
-  for (unsigned int i = 0; i < top_index; ++i) {
-    logits[top_indices_and_logits[i].first] = top_indices_and_logits[i].second;
-  }
-
-  return top_indices_and_logits[0].second;
-}
-
-/**
- * @brief Apply repetition penalty to logits
- */
-void applyRepetitionPenalty(float *logits, unsigned int *input_ids,
-                            unsigned int NUM_INPUT_IDS,
-                            float repetition_penalty = 1) {
-  for (unsigned int i = 0; i < NUM_INPUT_IDS; ++i) {
-    if (logits[input_ids[i]] < 0) {
-      logits[input_ids[i]] *= repetition_penalty;
-    } else {
-      logits[input_ids[i]] /= repetition_penalty;
-    }
-  }
-}
-
-/**
- * @brief Apply bad words penalty
- */
-void applyBadWordsPenalty(float *logits, unsigned int *bad_words_ids,
-                          unsigned int NUM_BAD_WORDS_IDS) {
-  for (unsigned int i = 0; i < NUM_BAD_WORDS_IDS; ++i) {
-    logits[bad_words_ids[i]] = -INFINITY;
-  }
-}
-
 std::vector<int> generate(float *logits, unsigned int NUM_VOCAB = 0,
                           unsigned int NUM_BATCH = 1, bool do_sample = false,
                           float temperature = 1, unsigned int top_k = 1,
@@ -168,56 +109,27 @@ std::vector<int> generate(float *logits, unsigned int NUM_VOCAB = 0,
                           unsigned int NUM_INPUT_IDS = 0,
                           unsigned int *bad_words_ids = nullptr,
                           unsigned int NUM_BAD_WORDS_IDS = 0) {
-  std::vector<int> outputs;
-  for (unsigned int iteration = 0; iteration < NUM_BATCH; ++iteration) {
-
-    // apply repetition penalty
-    if (repetition_penalty != 1 && input_ids != nullptr && NUM_INPUT_IDS != 0) {
-      applyRepetitionPenalty(logits, input_ids, NUM_INPUT_IDS,
-                             repetition_penalty);
-    }
-
-    // apply bad words penalty
-    if (bad_words_ids != nullptr && NUM_BAD_WORDS_IDS != 0) {
-      applyBadWordsPenalty(logits, bad_words_ids, NUM_BAD_WORDS_IDS);
-    }
-
-    // return argmax if do_sample is false
-    if (do_sample == false) {
-      int argmax_idx =
-        std::distance(logits, std::max_element(logits, logits + NUM_VOCAB));
-      outputs.push_back(argmax_idx);
-    } else {
-      // apply temperature & top-k & top-p to logits
-      float max_logits = applyTKP(logits, NUM_VOCAB, temperature, top_k, top_p);
-      // transform logits to softmax
-      float sum_exp_logits = 0;
-      for (unsigned int i = 0; i < NUM_VOCAB; i++) {
-        float exp_x = exp(logits[i] - max_logits);
-        sum_exp_logits += exp_x;
-        logits[i] = exp_x;
-      }
-
-      for (unsigned int i = 0; i < NUM_VOCAB; ++i) {
-        logits[i] /= sum_exp_logits;
-      }
-
-      // sample from final logits
-      std::random_device rd;
-      std::mt19937 gen(rd());
-      std::discrete_distribution<int> dist(logits, logits + NUM_VOCAB);
-      int sampled_idx = dist(gen);
-
-      // add sampled word
-      outputs.push_back(sampled_idx);
+  nntrainer::TokenSampler::Options options;
+  options.temperature = do_sample ? temperature : 0.0f;
+  options.top_k = top_k;
+  options.top_p = top_p;
+  options.repetition_penalty = repetition_penalty;
+  if (bad_words_ids != nullptr)
+    options.bad_words.assign(bad_words_ids, bad_words_ids + NUM_BAD_WORDS_IDS);
+
+  std::vector<std::vector<unsigned int>> histories;
+  if (input_ids != nullptr && NUM_INPUT_IDS != 0) {
+    for (unsigned int b = 0; b < NUM_BATCH; ++b) {
+      unsigned int *ids = input_ids + b * batch_size;
+      histories.emplace_back(ids, ids + NUM_INPUT_IDS);
     }
-
-    // set batch offset
-    logits = logits + NUM_VOCAB;
-    input_ids = input_ids + batch_size;
   }
 
-  return outputs;
+  nntrainer::TokenSampler sampler(options, std::random_device()());
+  std::vector<unsigned int> tokens =
+    sampler.sampleBatch(logits, NUM_BATCH, NUM_VOCAB, histories);
+
+  return std::vector<int>(tokens.begin(), tokens.end());
 }
 
 std::vector<int> generate_multi_tokens(
@@ -225,42 +137,22 @@ std::vector<int> generate_multi_tokens(
   float repetition_penalty = 1, unsigned int *input_ids = nullptr,
   unsigned int NUM_INPUT_IDS = 0, unsigned int *bad_words_ids = nullptr,
   unsigned int NUM_BAD_WORDS_IDS = 0) {
-  std::vector<int> outputs;
-  // apply repetition penalty
-  if (abs(repetition_penalty - 1) < EPS && input_ids != nullptr &&
-      NUM_INPUT_IDS != 0) {
-    applyRepetitionPenalty(logits, input_ids, NUM_INPUT_IDS,
-                           repetition_penalty);
-  }
-
-  // apply bad words penalty
-  if (bad_words_ids != nullptr && NUM_BAD_WORDS_IDS != 0) {
-    applyBadWordsPenalty(logits, bad_words_ids, NUM_BAD_WORDS_IDS);
-  }
-
-  // Sort and generate multiple tokens
-  std::vector<std::pair<int, float>> top_indices_and_logits;
-  for (unsigned int i = 0; i < NUM_VOCAB; ++i) {
-    top_indices_and_logits.push_back({i, logits[i]});
-  }
-  sort(top_indices_and_logits.begin(), top_indices_and_logits.end(),
-       [](auto &a, auto &b) { return a.second > b.second; });
-
-  // add sampled words
-  for (unsigned int i = 0; i < NUM_TARGET_TOKENS; ++i) {
-    outputs.push_back(top_indices_and_logits[i].first);
-  }
-
-  return outputs;
-}
-
-template <typename T>
-T unwrap(std::optional<T> &&value, const std::string &error_msg) {
-  if (value.has_value()) {
-    return value.value();
-  } else {
-    throw std::runtime_error(error_msg);
-  }
+  nntrainer::TokenSampler::Options options;
+  options.repetition_penalty = repetition_penalty;
+  if (bad_words_ids != nullptr)
+    options.bad_words.assign(bad_words_ids, bad_words_ids + NUM_BAD_WORDS_IDS);
+
+  std::vector<unsigned int> history;
+  if (input_ids != nullptr)
+    history.assign(input_ids, input_ids + NUM_INPUT_IDS);
+
+  // select the most probable tokens without sorting the vocabulary
+  nntrainer::TokenSampler sampler(options, 0);
+  sampler.penalize(logits, NUM_VOCAB, history);
+  std::vector<unsigned int> tokens =
+    nntrainer::TokenSampler::topK(logits, NUM_VOCAB, NUM_TARGET_TOKENS);
+
+  return std::vector<int>(tokens.begin(), tokens.end());
 }
 
 /**
@@ -309,23 +201,7 @@ std::vector<LayerHandle> createAttentionLayer(const int layer_id, int seq_len,
     std::string concat_input = "";
     // apply rotary embedding and dot_product attention
     for (int i = 0; i < n_heads; i++) {
-      // reshape q, k, v (apply num_heads)
-      layers.push_back(createLayer(
-        "reshape", {withKey("name", "layer" + std::to_string(layer_id) +
-                                      "_q_reshape_" + std::to_string(i)),
-                    withKey("target_shape", "1:" + std::to_string(seq_len) +
-                                              ":" + std::to_string(head_dim)),
-                    withKey("input_layers", "layer" + std::to_string(layer_id) +
-                                              "_wq_" + std::to_string(i))}));
-
-      layers.push_back(createLayer(
-        "reshape", {withKey("name", "layer" + std::to_string(layer_id) +
-                                      "_k_reshape_" + std::to_string(i)),
-                    withKey("target_shape", "1:" + std::to_string(seq_len) +
-                                              ":" + std::to_string(head_dim)),
-                    withKey("input_layers", "layer" + std::to_string(layer_id) +
-                                              "_wk_" + std::to_string(i))}));
-
+      // reshape v (apply num_heads)
       layers.push_back(createLayer(
         "reshape", {withKey("name", "layer" + std::to_string(layer_id) +
                                       "_v_reshape_" + std::to_string(i)),
@@ -334,20 +210,20 @@ std::vector<LayerHandle> createAttentionLayer(const int layer_id, int seq_len,
                     withKey("input_layers", "layer" + std::to_string(layer_id) +
                                               "_wv_" + std::to_string(i))}));
 
-      // apply rotary embedding to q, k
+      // apply rotary embedding to the projected q, k in place
       layers.push_back(createLayer(
         "rotary_embedding",
         {withKey("name", "layer" + std::to_string(layer_id) + "_q_rotary_" +
                            std::to_string(i)),
-         withKey("input_layers", "layer" + std::to_string(layer_id) +
-                                   "_q_reshape_" + std::to_string(i))}));
+         withKey("input_layers", "layer" + std::to_string(layer_id) + "_wq_" +
+                                   std::to_string(i))}));
 
       layers.push_back(createLayer(
         "rotary_embedding",
         {withKey("name", "layer" + std::to_string(layer_id) + "_k_rotary_" +
                            std::to_string(i)),
-         withKey("input_layers", "layer" + std::to_string(layer_id) +
-                                   "_k_reshape_" + std::to_string(i))}));
+         withKey("input_layers", "layer" + std::to_string(layer_id) + "_wk_" +
+                                   std::to_string(i))}));
 
       // apply scaled-dot product attention
       layers.push_back(ml::train::layer::Attention(
@@ -404,6 +280,7 @@ std::vector<LayerHandle> createAttentionLayer(const int layer_id, int seq_len,
       {withKey("name", "layer" + std::to_string(layer_id) + "_attention_out"),
        withKey("num_heads", std::to_string(NUM_HEADS)),
        withKey("max_timestep", std::to_string(MAX_SEQ_LEN)),
+       withKey("kv_cache_dtype", KV_CACHE_DTYPE),
        withKey("disable_bias", "true"),
        withKey("input_layers", {query_name, key_name, value_name})}));
   }
@@ -573,16 +450,22 @@ void run(std::string text, bool apply_temperature) {
 
   unsigned int init_len;
 
-#if defined(DENABLE_ENCODER)
+#if defined(ENABLE_ENCODER)
   std::string vocab_file_name = "../Applications/LLaMA/jni/vocab.json";
   std::string merge_file_name = "../Applications/LLaMA/jni/merges.txt";
+  std::string tokenizer_file_name = "./llama_tokenizer.bin";
 
-  auto tokenizer = unwrap(GPT2Encoder::load(vocab_file_name, merge_file_name),
-                          "Error initializising GPT2 tokenizer\n");
-
-  std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+  // the binary tokenizer is mapped as is, the text files are parsed once
+  std::unique_ptr<nntrainer::BPETokenizer> tokenizer;
+  try {
+    tokenizer = nntrainer::BPETokenizer::load(tokenizer_file_name);
+  } catch (const std::exception &e) {
+    tokenizer =
+      nntrainer::BPETokenizer::loadText(vocab_file_name, merge_file_name);
+    tokenizer->save(tokenizer_file_name);
+  }
 
-  auto init_input = tokenizer.encode(converter.from_bytes(text));
+  auto init_input = tokenizer->encode(text);
   init_len = init_input.size();
 
   input_len = (init_len > INIT_SEQ_LEN) ? INIT_SEQ_LEN : init_len;
@@ -604,11 +487,24 @@ void run(std::string text, bool apply_temperature) {
 
   std::vector<int64_t> token_ids;
 
-  auto output =
-    g_model->incremental_inference(1, input, label, MAX_SEQ_LEN, 0, input_len);
+  /** prefill the prompt in chunks against the growing cache, a chunk after the
+   * first one takes its tokens from the first element of the input */
+  std::vector<float *> output;
+  for (unsigned int begin = 0; begin < input_len; begin += PREFILL_CHUNK) {
+    unsigned int end = std::min(begin + PREFILL_CHUNK, input_len);
+    for (unsigned int i = begin; i < end; ++i)
+      input_sample[i - begin] = static_cast<float>(init_input[i]);
+
+#ifdef ENABLE_FP16
+    for (auto o : output) {
+      delete[] o;
+    }
+#endif
+    output =
+      g_model->incremental_inference(1, input, label, MAX_SEQ_LEN, begin, end);
+  }
 
-  unsigned int ids = std::distance(
-    output[0], std::max_element(output[0], output[0] + NUM_VOCAB));
+  unsigned int ids = generate(output[0], NUM_VOCAB)[0];
 
   input_sample[0] = static_cast<float>(ids);
 
@@ -620,8 +516,8 @@ void run(std::string text, bool apply_temperature) {
   std::cout << " Progress Reading: 100 % " << std::endl;
   std::cout << std::endl << "### Output : " << std::endl;
   if (init_len < INIT_SEQ_LEN) {
-#if defined(DENABLE_ENCODER)
-    auto decoded_str = tokenizer.decode({static_cast<int64_t>(ids)});
+#if defined(ENABLE_ENCODER)
+    auto decoded_str = tokenizer->decode({ids});
     std::cout << decoded_str << " ";
     std::cout.flush();
 #endif
@@ -630,14 +526,14 @@ void run(std::string text, bool apply_temperature) {
   for (unsigned int i = input_len + 1; i < input_len + NUM_TO_GENERATE; ++i) {
     auto output_interval =
       g_model->incremental_inference(1, input, label, MAX_SEQ_LEN, i - 1, i);
-    unsigned int ids = generate(output[0], NUM_VOCAB)[0];
+    unsigned int ids = generate(output_interval[0], NUM_VOCAB)[0];
 
     if (i < input_len) {
       input_sample[0] = static_cast<float>(init_input[i]);
     } else {
       input_sample[0] = static_cast<float>(ids);
-#if defined(DENABLE_ENCODER)
-      auto decoded_str = tokenizer.decode({static_cast<int64_t>(ids)});
+#if defined(ENABLE_ENCODER)
+      auto decoded_str = tokenizer->decode({ids});
       std::cout << decoded_str << " ";
       std::cout.flush();
 #endif
@@ -685,7 +581,7 @@ void createAndRun(unsigned int epochs, unsigned int batch_size) {
   g_model->load(weight_path);
 }
 
-#if defined(DENABLE_ENCODER)
+#if defined(ENABLE_ENCODER)
 std::wstring decodeUnicodeEscape(const std::wstring &input) {
   std::wstringstream result;
 
@@ -713,34 +609,17 @@ int main(int argc, char *argv[]) {
   // Setting locale
   std::locale::global(std::locale("ko_KR.UTF-8"));
 
-#if defined(DENABLE_ENCODER)
+#if defined(ENABLE_ENCODER)
   // Getting arguments From terminal
   std::wstring input;
   std::getline(std::wcin, input);
   std::wstring test = decodeUnicodeEscape(input);
-  std::wstring_convert<std::codecvt_utf16<wchar_t>> converter;
+  std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
   std::string text = converter.to_bytes(test);
 #else
   std::string text = "This is smaple input for LLaMA.";
 #endif
 
-  auto &app_context = nntrainer::AppContext::Global();
-  try {
-    app_context.registerFactory(nntrainer::createLayer<custom::SwiGLULayer>);
-  } catch (std::invalid_argument &e) {
-    std::cerr << "failed to register factory, reason: " << e.what()
-              << std::endl;
-    return 1;
-  }
-
-  try {
-    app_context.registerFactory(nntrainer::createLayer<custom::RMSNormLayer>);
-  } catch (std::invalid_argument &e) {
-    std::cerr << "failed to register factory, reason: " << e.what()
-              << std::endl;
-    return 1;
-  }
-
   try {
     const std::vector<std::string> args(argv + 1, argv + argc);
 
@@ -17,8 +17,8 @@
 #include <string.h>
 #include <tensor.h>
 
-#if defined(DENABLE_ENCODER)
-#include "encoder.hpp"
+#if defined(ENABLE_ENCODER)
+#include <bpe_tokenizer.h>
 #endif
 
 #include <iostream>
@@ -43,17 +43,6 @@ bool optimize = false;
 // bool optimize = true;
 bool optimize_attention = false;
 
-#if defined(DENABLE_ENCODER)
-template <typename T>
-T unwrap(std::optional<T> &&value, const std::string &error_msg) {
-  if (value.has_value()) {
-    return value.value();
-  } else {
-    throw std::runtime_error(error_msg);
-  }
-}
-#endif
-
 std::shared_ptr<ml::train::Model> genModel() {
   std::shared_ptr<ml::train::Model> model;
   model = ml::train::createModel(ml::train::ModelType::NEURAL_NET);
@@ -318,15 +307,25 @@ int main(int argc, char *argv[]) {
 
     std::vector<int64_t> init_input;
 
-#if defined(DENABLE_ENCODER)
+#if defined(ENABLE_ENCODER)
 
     std::string vocab_file_name = "../Applications/PicoGPT/jni/vocab.json";
     std::string merge_file_name = "../Applications/PicoGPT/jni/merges.txt";
 
-    auto tokenizer = unwrap(GPT2Encoder::load(vocab_file_name, merge_file_name),
-                            "Error initialising GPT2 tokenizer\n");
+    std::string tokenizer_file_name = "./pico_gpt_tokenizer.bin";
+
+    // the binary tokenizer is mapped as is, the text files are parsed once
+    std::unique_ptr<nntrainer::BPETokenizer> tokenizer;
+    try {
+      tokenizer = nntrainer::BPETokenizer::load(tokenizer_file_name);
+    } catch (const std::exception &e) {
+      tokenizer =
+        nntrainer::BPETokenizer::loadText(vocab_file_name, merge_file_name);
+      tokenizer->save(tokenizer_file_name);
+    }
 
-    init_input = tokenizer.encode(text);
+    std::vector<unsigned int> tokens = tokenizer->encode(text);
+    init_input.assign(tokens.begin(), tokens.end());
 #else
     text = "Elan Turing is";
     init_input = {36235, 39141, 18765, 1143, 326, 9061, 561, 530, 1110, 1716};
@@ -372,14 +371,9 @@ int main(int argc, char *argv[]) {
 
       ((uint *)(wpe_input))[0] = i;
 
-#if defined(DENABLE_ENCODER)
-      std::vector<int64_t> token_ids;
-      for (auto element : ids) {
-        token_ids.push_back(static_cast<int64_t>(element));
-      }
-
+#if defined(ENABLE_ENCODER)
       if (i >= init_input_seq_len) {
-        auto decoded_str = tokenizer.decode(token_ids);
+        auto decoded_str = tokenizer->decode(ids);
         std::cerr << decoded_str << " " << std::flush;
       }
 #endif
@@ -98,6 +98,10 @@ enum LayerType {
   LAYER_REDUCE_MEAN,              /**< Reduce mean Layer type */
   LAYER_LOSS_CONSTANT_DERIVATIVE, /**< Synthetic loss layer to feed constant
                                      derivative */
+  LAYER_DEPTHWISE_CONV2D,         /**< Depthwise Convolution 2D Layer type */
+  LAYER_RMS_NORM,                 /**< RMS Normalization Layer type */
+  LAYER_ROTARY_EMBEDDING,         /**< Rotary Embedding Layer type */
+  LAYER_SWIGLU,                   /**< SwiGLU Layer type */
   LAYER_UNKNOWN = ML_TRAIN_LAYER_TYPE_UNKNOWN /**< Unknown */
 };
 
@@ -319,6 +323,14 @@ Convolution2D(const std::vector<std::string> &properties = {}) {
   return createLayer(LayerType::LAYER_CONV2D, properties);
 }
 
+/**
+ * @brief Helper function to create depthwise convolution 2d layer
+ */
+inline std::unique_ptr<Layer>
+DepthwiseConvolution2D(const std::vector<std::string> &properties = {}) {
+  return createLayer(LayerType::LAYER_DEPTHWISE_CONV2D, properties);
+}
+
 /**
  * @brief Helper function to create convolution 1d layer
  */
@@ -528,6 +540,30 @@ ReduceMean(const std::vector<std::string> &properties = {}) {
   return createLayer(LayerType::LAYER_REDUCE_MEAN, properties);
 }
 
+/**
+ * @brief Helper function to create RMS Normalization Layer
+ */
+inline std::unique_ptr<Layer>
+RMSNorm(const std::vector<std::string> &properties = {}) {
+  return createLayer(LayerType::LAYER_RMS_NORM, properties);
+}
+
+/**
+ * @brief Helper function to create Rotary Embedding Layer
+ */
+inline std::unique_ptr<Layer>
+RotaryEmbedding(const std::vector<std::string> &properties = {}) {
+  return createLayer(LayerType::LAYER_ROTARY_EMBEDDING, properties);
+}
+
+/**
+ * @brief Helper function to create SwiGLU Layer
+ */
+inline std::unique_ptr<Layer>
+SwiGLU(const std::vector<std::string> &properties = {}) {
+  return createLayer(LayerType::LAYER_SWIGLU, properties);
+}
+
 /**
  * @brief Helper function to create Identity layer
  */
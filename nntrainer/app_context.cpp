@@ -41,6 +41,7 @@
 #include <conv2d_layer.h>
 #include <cross_entropy_sigmoid_loss_layer.h>
 #include <cross_entropy_softmax_loss_layer.h>
+#include <depthwise_conv2d_layer.h>
 #include <dropout.h>
 #include <embedding.h>
 #include <fc_layer.h>
@@ -69,9 +70,12 @@
 #include <preprocess_l2norm_layer.h>
 #include <preprocess_translate_layer.h>
 #include <reduce_mean_layer.h>
+#include <rms_norm_layer.h>
 #include <rnn.h>
 #include <rnncell.h>
+#include <rotary_embedding_layer.h>
 #include <split_layer.h>
+#include <swiglu_layer.h>
 #include <time_dist.h>
 #include <zoneout_lstmcell.h>
 
@@ -253,6 +257,9 @@ static void add_default_object(AppContext &ac) {
                      LayerType::LAYER_LAYER_NORMALIZATION);
   ac.registerFactory(nntrainer::createLayer<Conv2DLayer>, Conv2DLayer::type,
                      LayerType::LAYER_CONV2D);
+  ac.registerFactory(nntrainer::createLayer<DepthwiseConv2DLayer>,
+                     DepthwiseConv2DLayer::type,
+                     LayerType::LAYER_DEPTHWISE_CONV2D);
   ac.registerFactory(nntrainer::createLayer<Conv1DLayer>, Conv1DLayer::type,
                      LayerType::LAYER_CONV1D);
   ac.registerFactory(nntrainer::createLayer<Pooling2DLayer>,
@@ -306,6 +313,13 @@ static void add_default_object(AppContext &ac) {
                      LayerType::LAYER_POSITIONAL_ENCODING);
   ac.registerFactory(nntrainer::createLayer<IdentityLayer>, IdentityLayer::type,
                      LayerType::LAYER_IDENTITY);
+  ac.registerFactory(nntrainer::createLayer<RMSNormLayer>, RMSNormLayer::type,
+                     LayerType::LAYER_RMS_NORM);
+  ac.registerFactory(nntrainer::createLayer<RotaryEmbeddingLayer>,
+                     RotaryEmbeddingLayer::type,
+                     LayerType::LAYER_ROTARY_EMBEDDING);
+  ac.registerFactory(nntrainer::createLayer<SwiGLULayer>, SwiGLULayer::type,
+                     LayerType::LAYER_SWIGLU);
 
 #ifdef ENABLE_NNSTREAMER_BACKBONE
   ac.registerFactory(nntrainer::createLayer<NNStreamerLayer>,
@@ -405,13 +405,18 @@ TfOpNodes buildOpNodes(const GraphRepresentation &representation,
       tf_node->weightReorder(node_count);
     }
 
-    if (tf_node->getOpType() ==
-          tflite::BuiltinOperator::BuiltinOperator_CONV_2D &&
+    bool is_depthwise =
+      tf_node->getOpType() ==
+      tflite::BuiltinOperator::BuiltinOperator_DEPTHWISE_CONV_2D;
+    if ((tf_node->getOpType() ==
+           tflite::BuiltinOperator::BuiltinOperator_CONV_2D ||
+         is_depthwise) &&
+        node_count + 2 < static_cast<int>(nodes.size()) &&
         nodes.at(node_count + 1).get()->getOpType() ==
           tflite::BuiltinOperator::BuiltinOperator_MUL &&
         nodes.at(node_count + 2).get()->getOpType() ==
           tflite::BuiltinOperator::BuiltinOperator_RELU) {
-      // Fuse Conv2D + Mul(Batch Norm) + ReLU to Conv2D
+      // Fuse (Depthwise)Conv2D + Mul(Batch Norm) + ReLU to (Depthwise)Conv2D
 
       auto props = tf_node->getProps();
       auto tf_padding = tflite::Padding_SAME;
@@ -419,12 +424,22 @@ TfOpNodes buildOpNodes(const GraphRepresentation &representation,
       if (props[0] == 1) {
         tf_padding = tflite::Padding_VALID;
       }
-      auto new_options =
-        tflite::CreateConv2DOptions(fbb, tf_padding, props[1], props[2],
-                                    tflite::ActivationFunctionType_RELU)
-          .Union();
-      tf_node->setBuiltinOptions(tflite::BuiltinOptions_Conv2DOptions,
-                                 new_options);
+      if (is_depthwise) {
+        auto new_options =
+          tflite::CreateDepthwiseConv2DOptions(
+            fbb, tf_padding, props[1], props[2], props[3],
+            tflite::ActivationFunctionType_RELU, props[4], props[5])
+            .Union();
+        tf_node->setBuiltinOptions(
+          tflite::BuiltinOptions_DepthwiseConv2DOptions, new_options);
+      } else {
+        auto new_options =
+          tflite::CreateConv2DOptions(fbb, tf_padding, props[1], props[2],
+                                      tflite::ActivationFunctionType_RELU)
+            .Union();
+        tf_node->setBuiltinOptions(tflite::BuiltinOptions_Conv2DOptions,
+                                   new_options);
+      }
       // After Fusing Mark ReLU Node to be removed
       nodes.at(node_count + 2).get()->setToBeRemoved(true);
     }
@@ -459,8 +474,15 @@ TfOpNodes buildOpNodes(const GraphRepresentation &representation,
 
         Tensor reshape_mul_weight(mul_weight.getDim());
         reshape_mul_weight.copy(mul_weight);
-        reshape_mul_weight.reshape(
-          TensorDim{mul_weight.getDim().width(), 1, 1, 1});
+        // depthwise filters keep the output channel innermost
+        if (nodes.at(node_count - 1).get()->getOpType() ==
+            tflite::BuiltinOperator_DEPTHWISE_CONV_2D) {
+          reshape_mul_weight.reshape(
+            TensorDim{1, 1, 1, mul_weight.getDim().width()});
+        } else {
+          reshape_mul_weight.reshape(
+            TensorDim{mul_weight.getDim().width(), 1, 1, 1});
+        }
         conv_weight.multiply_i(reshape_mul_weight);
 
         conv_bias.subtract_i(mul_mean);
@@ -253,6 +253,7 @@ flatbuffers::Offset<void> TfOpNode::getBuiltinOps() const {
   case tflite::BuiltinOperator_ADD:
   case tflite::BuiltinOperator_AVERAGE_POOL_2D:
   case tflite::BuiltinOperator_CONV_2D:
+  case tflite::BuiltinOperator_DEPTHWISE_CONV_2D:
   case tflite::BuiltinOperator_FULLY_CONNECTED:
   case tflite::BuiltinOperator_RELU:
   case tflite::BuiltinOperator_RESHAPE:
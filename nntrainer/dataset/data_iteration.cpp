@@ -93,8 +93,17 @@ void Iteration::setEndSample(std::vector<Sample>::iterator sample_iterator) {
 
 void Iteration::setEndSample() { end_iterator = samples.end(); }
 
+std::vector<unsigned int> Iteration::getSampleIndices() const {
+  std::vector<unsigned int> indices;
+  indices.reserve(std::distance(begin(), end()));
+  std::transform(begin(), end(), std::back_inserter(indices),
+                 [](const Sample &sample) { return sample.getIndex(); });
+  return indices;
+}
+
 Sample::Sample(const Iteration &iter, unsigned int batch) :
   inputs(sliceTensor(iter.getInputsRef(), batch)),
-  labels(sliceTensor(iter.getLabelsRef(), batch)) {}
+  labels(sliceTensor(iter.getLabelsRef(), batch)),
+  index(NO_INDEX) {}
 
 } // namespace nntrainer
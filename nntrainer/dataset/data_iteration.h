@@ -124,6 +124,14 @@ public:
    */
   void setEndSample();
 
+  /**
+   * @brief Get the dataset indices of the samples till the end sample
+   *
+   * @return std::vector<unsigned int> indices, Sample::NO_INDEX for the
+   * samples which are not from a dataset of a known size
+   */
+  std::vector<unsigned int> getSampleIndices() const;
+
 private:
   std::vector<Tensor> inputs, labels;
   std::vector<Sample> samples;
@@ -137,6 +145,9 @@ private:
 class Sample {
 
 public:
+  static constexpr unsigned int NO_INDEX =
+    -1; /**< index of a sample which is not from a dataset of a known size */
+
   /**
    * @brief Construct a new Sample object
    * @note the batch dimension will be ignored to make a single sample
@@ -179,8 +190,23 @@ public:
    */
   const std::vector<Tensor> &getLabelsRef() const { return labels; }
 
+  /**
+   * @brief Set the index of the sample in the dataset
+   *
+   * @param index_ index of the sample
+   */
+  void setIndex(unsigned int index_) { index = index_; }
+
+  /**
+   * @brief Get the index of the sample in the dataset
+   *
+   * @return unsigned int index, NO_INDEX if not known
+   */
+  unsigned int getIndex() const { return index; }
+
 private:
   std::vector<Tensor> inputs, labels;
+  unsigned int index; /**< index of the sample in the dataset */
 };
 
 } // namespace nntrainer
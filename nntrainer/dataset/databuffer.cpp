@@ -141,8 +141,9 @@ DataBuffer::startFetchWorker(const std::vector<TensorDim> &input_dims,
         << "[Databuffer] Cannot fill empty buffer";
       auto &sample = sample_view.get();
       try {
-        generator(shuffle ? idxes[i] : i, sample.getInputsRef(),
-                  sample.getLabelsRef());
+        unsigned int idx = shuffle ? idxes[i] : i;
+        sample.setIndex(idx);
+        generator(idx, sample.getInputsRef(), sample.getLabelsRef());
       } catch (std::exception &e) {
         ml_loge("Fetching sample failed, Error: %s", e.what());
         throw;
@@ -276,8 +276,15 @@ void NetworkGraph::setBatchSize(unsigned int batch_size) {
     return;
 
   auto allocated = tensor_manager->isAllocated();
+  /**
+   * the memory planned for a batch fits any smaller batch, so the tensors are
+   * only detached to update their dimension and bound back to the same
+   * memory, without deallocating and planning again
+   */
+  bool keep_memory = allocated && batch_size <= allocated_batch_size &&
+                     tensor_manager->unbindTensors();
 
-  if (allocated)
+  if (allocated && !keep_memory)
     deallocateTensors();
 
   for (auto iter = cbegin(); iter != cend(); iter++) {
@@ -303,7 +310,9 @@ void NetworkGraph::setBatchSize(unsigned int batch_size) {
   /// resize input and output spec
   tensor_manager->setBatchSize(batch_size);
 
-  if (allocated)
+  if (keep_memory)
+    tensor_manager->bindTensors();
+  else if (allocated)
     allocateTensors(exec_mode);
 
   /** update input and label dimensions */
@@ -345,6 +354,10 @@ void NetworkGraph::applyGradients(
       continue;
     }
 
+    /** the gradient is applied once all the micro-batches are accumulated */
+    if (!rc.getWeightObject(i).accumulateGradient())
+      continue;
+
     apply_func(rc.getWeightObject(i));
   }
 }
@@ -353,6 +366,10 @@ sharedConstTensors NetworkGraph::forwarding(
   bool training,
   std::function<void(std::shared_ptr<LayerNode>, bool)> forwarding_op,
   std::function<bool(void *userdata)> stop_cb, void *userdata) {
+  /** the recomputed layers were left bound to the backwarding memory */
+  if (!recompute_layers.empty())
+    tensor_manager->bindForwardMemory();
+
   for (auto iter = cbegin(); iter != cend() && !stop_cb(userdata); iter++) {
     auto &ln = *iter;
     PROFILE_TIME_START(profile_keys.at(ln->getType()));
@@ -375,6 +392,9 @@ sharedConstTensors NetworkGraph::incremental_forwarding(
   unsigned int from, unsigned int to, bool training,
   std::function<void(std::shared_ptr<LayerNode>, bool)> forwarding_op,
   std::function<bool(void *userdata)> stop_cb, void *userdata) {
+  if (!recompute_layers.empty())
+    tensor_manager->bindForwardMemory();
+
   for (auto iter = cbegin(); iter != cend() && !stop_cb(userdata); iter++) {
     auto &ln = *iter;
     PROFILE_TIME_START(profile_keys.at(ln->getType()));
@@ -417,6 +437,17 @@ void NetworkGraph::backwarding(
 
   for (auto iter = iter_begin; iter != iter_end && !stop_cb(userdata); iter++) {
     auto &ln = *iter;
+    /** restore the activations of the segment ending at this checkpoint */
+    auto found = recompute_layers.find(std::get<1>(ln->getExecutionOrder()));
+    if (found != recompute_layers.end()) {
+      tensor_manager->bindRecomputeMemory(found->first);
+      for (auto const &node : found->second) {
+        auto group = std::get<0>(node->getExecutionOrder());
+        if (tensor_manager->isRecomputed(group))
+          node->forwarding(true);
+      }
+    }
+
     PROFILE_TIME_START(profile_keys.at(ln->getType()));
     backwarding_op(ln, iteration);
     PROFILE_TIME_END(profile_keys.at(ln->getType()));
@@ -426,6 +457,13 @@ void NetworkGraph::backwarding(
   if (clip_weights.empty())
     return;
 
+  /** the accumulated gradients are clipped on the last micro-batch only */
+  bool ready = true;
+  for (auto w : clip_weights)
+    ready = w->accumulateGradient() && ready;
+  if (!ready)
+    return;
+
   /** calculate the global norm */
   Tensor global_norm_t(
     TensorDim({1u, 1u, 1u, (unsigned int)clip_weights.size()}));
@@ -486,6 +524,7 @@ LayerNode *NetworkGraph::computeBackwardEnd() {
  */
 void NetworkGraph::allocateTensors(ExecutionMode exec_mode_) {
   exec_mode = exec_mode_;
+  allocated_batch_size = batch_size;
   if (exec_mode == ExecutionMode::INFERENCE)
     /**
      * get the order of execution/usage order for the forwarding of the last
@@ -1562,4 +1601,160 @@ void NetworkGraph::requestOptimizerVariable(
   }
 }
 
+void NetworkGraph::requestGradientAccumulator(unsigned int steps) {
+  grad_accumulation_steps = steps;
+  if (steps <= 1)
+    return;
+
+  for (auto const &w : tensor_manager->getWeights()) {
+    if (w->isGradientLastAccess() && w->hasGradient()) {
+      w->setGradientAccumulator(
+        tensor_manager->requestWeightGradientAccumulator(
+          w->getGradientRef().getDim(), w->getName(),
+          w->isGradientClipByGlobalNorm()),
+        steps);
+    }
+  }
+}
+
+void NetworkGraph::resetGradientAccumulation() {
+  for (auto const &w : tensor_manager->getWeights())
+    w->resetGradientAccumulation();
+}
+
+unsigned int NetworkGraph::getFrozenPrefix(std::string &output_name,
+                                           unsigned int &output_idx) const {
+  /** a recomputed frozen layer would need its inputs again */
+  if (!recompute_layers.empty())
+    return 0;
+
+  std::unordered_set<std::string> frozen;
+  unsigned int prefix = 0;
+  for (; prefix < graph.size(); ++prefix) {
+    auto const &lnode = getSortedLayerNode(prefix);
+    /** a random layer must run again at every epoch */
+    if (lnode->getTrainable() || lnode->needsCalcDerivative() ||
+        lnode->requireLabel() || lnode->isRandomInTraining())
+      break;
+    frozen.insert(lnode->getName());
+  }
+
+  if (prefix == 0 || prefix == graph.size())
+    return 0;
+
+  for (unsigned int i = 0; i < graph.getNumOutputNodes(); ++i) {
+    if (frozen.count(graph.getOutputNode(i)->getName()))
+      return 0;
+  }
+
+  bool found = false;
+  for (unsigned int idx = prefix; idx < graph.size(); ++idx) {
+    auto const &lnode = getSortedLayerNode(idx);
+    for (unsigned int i = 0; i < lnode->getNumInputConnections(); ++i) {
+      auto const &name = lnode->getInputConnectionName(i);
+      if (!frozen.count(name))
+        continue;
+
+      unsigned int out_idx = lnode->getInputConnectionIndex(i);
+      if (found && (name != output_name || out_idx != output_idx))
+        return 0;
+      output_name = name;
+      output_idx = out_idx;
+      found = true;
+    }
+  }
+
+  return found ? prefix : 0;
+}
+
+void NetworkGraph::requestRecompute(unsigned int segments) {
+  recompute_layers.clear();
+  if (exec_mode != ExecutionMode::TRAIN)
+    return;
+
+  std::vector<bool> is_checkpoint(graph.size(), false);
+  bool given = false;
+  for (unsigned int idx = 0; idx < graph.size(); ++idx) {
+    is_checkpoint[idx] = getSortedLayerNode(idx)->isCheckpoint();
+    given = given || is_checkpoint[idx];
+  }
+
+  /** split the output memory requested by the layers into even segments */
+  if (!given && segments > 1) {
+    std::vector<size_t> bytes(graph.size(), 0);
+    size_t total = 0;
+    for (unsigned int idx = 0; idx < graph.size(); ++idx) {
+      auto const &lnode = getSortedLayerNode(idx);
+      for (unsigned int i = 0; i < lnode->getNumOutputs(); ++i)
+        bytes[idx] += lnode->getOutput(i).bytes();
+      total += bytes[idx];
+    }
+
+    size_t acc = 0;
+    for (unsigned int idx = 0, next = 1; idx < graph.size(); ++idx) {
+      acc += bytes[idx];
+      if (next < segments && acc * segments >= total * next) {
+        is_checkpoint[idx] = true;
+        while (next < segments && acc * segments >= total * next)
+          ++next;
+      }
+    }
+  }
+
+  unsigned int num_layers = 0;
+  for (unsigned int idx = 0, begin = 0; idx < graph.size(); ++idx) {
+    if (!is_checkpoint[idx])
+      continue;
+
+    auto const &exec_order = getSortedLayerNode(idx)->getExecutionOrder();
+    auto forward_end = std::get<0>(exec_order);
+    auto recompute_order = std::get<1>(exec_order);
+    std::vector<std::shared_ptr<LayerNode>> layers;
+    std::unordered_set<std::string> names;
+    for (; begin < idx; ++begin) {
+      auto const &lnode = getSortedLayerNode(begin);
+      if (!lnode->supportRecompute())
+        continue;
+
+      /** an in-place layer writes the output of its input layers */
+      bool inputs_recomputed = true;
+      for (unsigned int i = 0; i < lnode->getNumInputConnections(); ++i)
+        inputs_recomputed = inputs_recomputed &&
+                            names.count(lnode->getInputConnectionName(i));
+      if (lnode->executeInPlace() != InPlace::NONE && !inputs_recomputed)
+        continue;
+
+      auto group = std::get<0>(lnode->getExecutionOrder());
+      auto &rc = lnode->getRunContext();
+      for (unsigned int i = 0; i < rc.getNumOutputs(); ++i)
+        tensor_manager->requestRecompute(rc.getOutput(i).getName(), group,
+                                         forward_end, recompute_order);
+      for (unsigned int i = 0; i < rc.getNumTensors(); ++i)
+        tensor_manager->requestRecompute(rc.getTensor(i).getName(), group,
+                                         forward_end, recompute_order);
+      for (unsigned int i = 0; i < rc.getNumInputs(); ++i)
+        tensor_manager->requestRecomputeInput(rc.getInput(i).getName(),
+                                              recompute_order);
+      layers.push_back(lnode);
+      names.insert(lnode->getName());
+    }
+    begin = idx + 1;
+
+    num_layers += layers.size();
+    if (!layers.empty())
+      recompute_layers.emplace(recompute_order, std::move(layers));
+  }
+
+  ml_logi("%u layers in %zu segments requested to be recomputed", num_layers,
+          recompute_layers.size());
+}
+
+void NetworkGraph::setSparseGradientAllowed(bool allow) {
+  for (auto const &w : tensor_manager->getWeights()) {
+    w->setSparseGradientAllowed(allow && w->hasGradient() &&
+                                w->isGradientFirstAccess() &&
+                                w->isGradientLastAccess());
+  }
+}
+
 } /* namespace nntrainer */
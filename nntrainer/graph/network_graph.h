@@ -158,6 +158,9 @@ public:
   /**
    * @brief     set batch size
    * @param[in] batch size
+   * @note      a batch not larger than the allocated one runs on the already
+   * allocated memory with the leading dimension reduced, a larger one
+   * replans the memory
    */
   void setBatchSize(unsigned int batch_size);
 
@@ -352,6 +355,16 @@ public:
     tensor_manager->deallocateTensors(dealloc_weights);
   }
 
+  /**
+   * @brief Check if the tensors are allocated for the given execution mode
+   *
+   * @param[in] exec_mode_ execution mode
+   * @return true if allocated for exec_mode_, else false
+   */
+  bool isAllocated(ExecutionMode exec_mode_) const {
+    return tensor_manager->isAllocated() && exec_mode == exec_mode_;
+  }
+
   /**
    * @brief Allocate memory for all the managed weights
    */
@@ -385,6 +398,66 @@ public:
     std::function<std::vector<TensorDim>(const TensorDim &)> cb,
     bool request_only_trainable = true);
 
+  /**
+   * @brief     Allow the layers to compute row sparse gradients for the
+   * weights which are not shared with other layers
+   *
+   * @param allow true if the optimizer supports row sparse gradients
+   */
+  void setSparseGradientAllowed(bool allow);
+
+  /**
+   * @brief     Create the tensors accumulating the gradients of every weight
+   * over micro-batches. Nothing is requested if steps is 1.
+   *
+   * @param steps number of micro-batches per update
+   */
+  void requestGradientAccumulator(unsigned int steps);
+
+  /**
+   * @brief     Get the number of micro-batches per update
+   *
+   * @return number of micro-batches given to requestGradientAccumulator()
+   */
+  unsigned int getGradientAccumulationSteps() const {
+    return grad_accumulation_steps;
+  }
+
+  /**
+   * @brief     Drop the gradients accumulated so far
+   */
+  void resetGradientAccumulation();
+
+  /**
+   * @brief     Recompute the activations between the checkpoints before the
+   * backwarding instead of keeping them alive from the forwarding
+   *
+   * @param segments number of segments to split the activations into when no
+   * layer is given as a checkpoint, 0 or 1 to disable
+   * @details the output of a checkpoint layer is kept and the layers after
+   * the previous checkpoint run their forwarding again right before the
+   * backwarding of the checkpoint. Without user given checkpoints, the
+   * checkpoints split the requested output memory into the given number of
+   * segments of about the same size. Whether a layer is recomputed is known
+   * once the memory is planned.
+   */
+  void requestRecompute(unsigned int segments);
+
+  /**
+   * @brief     Get the frozen layers at the beginning of the sorted graph,
+   * which are neither trainable, pass the derivative to a trainable layer nor
+   * are random in training
+   *
+   * @param[out] output_name name of the frozen layer of which the output is
+   * the only one read by the rest of the graph
+   * @param[out] output_idx index of the output
+   * @retval    number of the frozen layers, 0 if the rest of the graph reads
+   * more than a single output of them, a frozen layer is an output of the
+   * graph, or layers are recomputed
+   */
+  unsigned int getFrozenPrefix(std::string &output_name,
+                               unsigned int &output_idx) const;
+
   /**
    * @brief Feed inputs and labels to the graph
    *
@@ -472,6 +545,8 @@ private:
   bool optimize_memory;    /**< optimize memory */
   ExecutionMode exec_mode; /**< execution mode with which the graph has been
                               currently set or previously set */
+  unsigned int allocated_batch_size =
+    0; /**< batch size with which the tensors have been allocated */
 
   std::string tensor_format; /**< Model Tensor Format: NCHW or NHWC */
 
@@ -481,6 +556,10 @@ private:
     profile_keys; /**< profile keys based on the layer type */
   std::vector<Weight *>
     clip_weights; /**< weights with global norm based clipping enabled */
+  unsigned int grad_accumulation_steps =
+    1; /**< number of micro-batches accumulated per update */
+  std::map<unsigned int, std::vector<std::shared_ptr<LayerNode>>>
+    recompute_layers; /**< layers to recompute by the recompute order */
 
   /**
    * @brief     topological sort
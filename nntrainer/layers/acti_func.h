@@ -17,6 +17,7 @@
 #ifdef __cplusplus
 
 #include <common_properties.h>
+#include <util_simd.h>
 
 namespace nntrainer {
 
@@ -56,19 +57,21 @@ public:
 
     switch (acti_type) {
     case ActivationType::ACT_TANH:
-      this->setActivation<T>(tanhFloat<T>, tanhPrime<T>);
+      this->setElementwiseActivation<T, tanhFloat<T>, tanhPrime<T>>(
+        std::is_same<T, float>::value ? ele_tanh : nullptr);
       break;
     case ActivationType::ACT_SIGMOID:
-      this->setActivation<T>(sigmoid<T>, sigmoidPrime<T>);
+      this->setElementwiseActivation<T, sigmoid<T>, sigmoidPrime<T>>(
+        std::is_same<T, float>::value ? ele_sigmoid : nullptr);
       break;
     case ActivationType::ACT_SOFTMAX:
       this->setActivation<Tensor>(softmax<T>, softmaxPrime<T>);
       break;
     case ActivationType::ACT_RELU:
-      this->setActivation<T>(relu<T>, reluPrime<T>);
+      this->setElementwiseActivation<T, relu<T>, reluPrime<T>>();
       break;
     case ActivationType::ACT_LEAKY_RELU:
-      this->setActivation<T>(leakyRelu<T>, leakyReluPrime<T>);
+      this->setElementwiseActivation<T, leakyRelu<T>, leakyReluPrime<T>>();
       break;
     case ActivationType::ACT_SWISH:
       in_place = false;
@@ -83,19 +86,19 @@ public:
       this->setActivation<Tensor>(quickGelu<T>, quickGeluPrime<T>);
       break;
     case ActivationType::ACT_ELU:
-      this->setActivation<T>(elu<T>, eluPrime<T>);
+      this->setElementwiseActivation<T, elu<T>, eluPrime<T>>();
       break;
     case ActivationType::ACT_SELU:
-      this->setActivation<T>(selu<T>, seluPrime<T>);
+      this->setElementwiseActivation<T, selu<T>, seluPrime<T>>();
       break;
     case ActivationType::ACT_SOFTPLUS:
-      this->setActivation<T>(softplus<T>, softplusPrime<T>);
+      this->setElementwiseActivation<T, softplus<T>, softplusPrime<T>>();
       break;
     case ActivationType::ACT_MISH:
-      this->setActivation<T>(mish<T>, mishPrime<T>);
+      this->setElementwiseActivation<T, mish<T>, mishPrime<T>>();
       break;
     case ActivationType::ACT_NONE:
-      this->setActivation<T>(no_op<T>, no_op_prime<T>);
+      this->setElementwiseActivation<T, no_op<T>, no_op_prime<T>>();
       break;
     case ActivationType::ACT_UNKNOWN:
     default:
@@ -103,6 +106,56 @@ public:
     }
   }
 
+  /**
+   * @brief get the scalar float functions of an element-wise activation
+   *
+   * @param[out] fn activation function
+   * @param[out] prime derivative computed from the activation output
+   * @retval true if the activation is element-wise, false otherwise
+   */
+  bool getElementwiseFn(float (*&fn)(float), float (*&prime)(float)) const {
+    switch (activation_type) {
+    case ActivationType::ACT_TANH:
+      fn = tanhFloat<float>;
+      prime = tanhPrime<float>;
+      return true;
+    case ActivationType::ACT_SIGMOID:
+      fn = sigmoid<float>;
+      prime = sigmoidPrime<float>;
+      return true;
+    case ActivationType::ACT_RELU:
+      fn = relu<float>;
+      prime = reluPrime<float>;
+      return true;
+    case ActivationType::ACT_LEAKY_RELU:
+      fn = leakyRelu<float>;
+      prime = leakyReluPrime<float>;
+      return true;
+    case ActivationType::ACT_ELU:
+      fn = elu<float>;
+      prime = eluPrime<float>;
+      return true;
+    case ActivationType::ACT_SELU:
+      fn = selu<float>;
+      prime = seluPrime<float>;
+      return true;
+    case ActivationType::ACT_SOFTPLUS:
+      fn = softplus<float>;
+      prime = softplusPrime<float>;
+      return true;
+    case ActivationType::ACT_MISH:
+      fn = mish<float>;
+      prime = mishPrime<float>;
+      return true;
+    case ActivationType::ACT_NONE:
+      fn = no_op<float>;
+      prime = no_op_prime<float>;
+      return true;
+    default:
+      return false;
+    }
+  }
+
   /**
    * @brief run function
    *
@@ -187,7 +240,7 @@ public:
     }
 
     // take exp
-    output.apply<T>(exp_util<T>, output);
+    output.transform<T>([](T x) { return exp_util<T>(x); }, output);
 
     // take sum over the last dimension
     Tensor sum = output.sum(3);
@@ -388,10 +441,12 @@ public:
    */
   template <typename T = float>
   static Tensor &swish(Tensor const &t_in, Tensor &t_out) {
-    t_in.apply<T>([&](T x) { return sigmoid<T>(x); }, t_out);
-    t_out.multiply_i(t_in);
+    if (canRunKernel<T>(t_in, t_out)) {
+      ele_swish(t_in.size(), t_in.getData<float>(), t_out.getData<float>());
+      return t_out;
+    }
 
-    return t_out;
+    return t_in.transform<T>([](T x) { return x * sigmoid<T>(x); }, t_out);
   }
 
   /**
@@ -408,9 +463,19 @@ public:
     if (outgoing_derivative.empty())
       outgoing_derivative = Tensor(t_out.getDim());
 
+    if (canRunKernel<T>(t_in, t_out) &&
+        canRunKernel<T>(t_in, outgoing_derivative) &&
+        canRunKernel<T>(t_in, incoming_derivative)) {
+      ele_swish_deriv(t_in.size(), t_in.getData<float>(),
+                      t_out.getData<float>(),
+                      incoming_derivative.getData<float>(),
+                      outgoing_derivative.getData<float>());
+      return outgoing_derivative;
+    }
+
     Tensor tmp = Tensor(t_out.getDim());
-    t_in.apply<T>([&](T x) { return sigmoid(x); }, outgoing_derivative);
-    t_out.apply<T>([&](T x) { return 1 - x; }, tmp);
+    t_in.transform<T>([](T x) { return sigmoid<T>(x); }, outgoing_derivative);
+    t_out.transform<T>([](T x) { return 1 - x; }, tmp);
     outgoing_derivative.multiply_i(tmp);
     outgoing_derivative.add_i(t_out);
 
@@ -426,9 +491,15 @@ public:
    */
   template <typename T = float>
   static Tensor &gelu(Tensor const &t_in, Tensor &t_out) {
+    if (canRunKernel<T>(t_in, t_out)) {
+      ele_gelu(t_in.size(), t_in.getData<float>(), t_out.getData<float>());
+      return t_out;
+    }
+
     double tmp = 1.0 / sqrt(2.0);
-    t_in.apply<T>(
-      [&](T x) { return static_cast<T>(0.5 * x * (1 + erf(x * tmp))); }, t_out);
+    t_in.transform<T>(
+      [tmp](T x) { return static_cast<T>(0.5 * x * (1 + erf(x * tmp))); },
+      t_out);
     return t_out;
   }
 
@@ -447,9 +518,17 @@ public:
     if (outgoing_derivative.empty())
       outgoing_derivative = Tensor(t_out.getDim());
 
+    if (canRunKernel<T>(t_in, outgoing_derivative) &&
+        canRunKernel<T>(t_in, incoming_derivative)) {
+      ele_gelu_deriv(t_in.size(), t_in.getData<float>(),
+                     incoming_derivative.getData<float>(),
+                     outgoing_derivative.getData<float>());
+      return outgoing_derivative;
+    }
+
     T tmp = static_cast<T>(1 / sqrt(2));
-    t_in.apply<T>(
-      [&](T x) {
+    t_in.transform<T>(
+      [tmp](T x) {
         return static_cast<T>(
           0.5 * (1 + erf(x * tmp) +
                  x * ((2 / sqrt(M_PI)) * exp(-pow(x * tmp, 2))) * tmp));
@@ -468,8 +547,8 @@ public:
    */
   template <typename T = float>
   static Tensor &quickGelu(Tensor const &t_in, Tensor &t_out) {
-    t_in.apply<T>(
-      [&](T x) { return static_cast<T>(x * (sigmoid<T>(static_cast<T>(1.702 * x)))); }, t_out);
+    t_in.transform<T>(
+      [](T x) { return static_cast<T>(x * (sigmoid<T>(static_cast<T>(1.702 * x)))); }, t_out);
     return t_out;
   }
 
@@ -696,6 +775,59 @@ public:
     return ML_ERROR_NONE;
   }
 
+  /**
+   * @brief vector kernel computing an element-wise activation of N contiguous
+   * FP32 values
+   */
+  using ElementwiseKernel = void (*)(const unsigned int, const float *,
+                                     float *);
+
+  /**
+   * @brief setActivation by element-wise activation function. The functions
+   * are template arguments so that they are inlined into the loops of
+   * Tensor::transform(), and the derivative is fused with the multiplication
+   * by the incoming derivative
+   * @tparam T type of an input/output
+   * @tparam fn activation function
+   * @tparam prime derivative computed from the activation output
+   * @param[in] kernel vector kernel of fn used for contiguous FP32 tensors,
+   * nullable
+   * @retval #ML_ERROR_NONE when successful
+   */
+  template <typename T, T (*fn)(T), T (*prime)(T)>
+  int setElementwiseActivation(ElementwiseKernel kernel = nullptr) {
+    _act_fn = [kernel](Tensor const &x, Tensor &hidden) -> Tensor & {
+      if (kernel && canRunKernel<T>(x, hidden)) {
+        kernel(x.size(), x.getData<float>(), hidden.getData<float>());
+        return hidden;
+      }
+      return x.transform<T>([](T v) { return fn(v); }, hidden);
+    };
+
+    _act_prime_fn = [in_place = in_place](
+                      Tensor const &t_in, Tensor &t_out,
+                      Tensor &outgoing_derivative,
+                      Tensor const &incoming_derivative) -> Tensor & {
+      if (isFusable(t_out, incoming_derivative, outgoing_derivative)) {
+        return t_out.transform<T>(
+          [](T y, T d) { return static_cast<T>(prime(y) * d); },
+          incoming_derivative, outgoing_derivative);
+      }
+
+      if (!in_place) {
+        t_out.transform<T>([](T y) { return prime(y); }, outgoing_derivative);
+        outgoing_derivative.multiply_i_strided(incoming_derivative);
+      } else {
+        t_out.transform<T>([](T y) { return prime(y); }, t_out);
+        incoming_derivative.multiply_strided(t_out, outgoing_derivative);
+      }
+
+      return outgoing_derivative;
+    };
+
+    return ML_ERROR_NONE;
+  }
+
   /**
    * @brief setActivation by custom activation function
    * @note  apply derivative as this activation_prime_fn does not utilize
@@ -729,6 +861,37 @@ private:
   constexpr static inline float selu_alpha = 1.67326324f; /**< alpha for selu */
   constexpr static inline float selu_scale = 1.05070098f; /**< scale for selu */
 
+  /**
+   * @brief check if a vector kernel can compute @a out from @a in
+   *
+   * @param in input tensor
+   * @param out output tensor of the same dimension
+   * @retval true if both are contiguous FP32 tensors of the same dimension
+   */
+  template <typename T>
+  static bool canRunKernel(Tensor const &in, Tensor const &out) {
+    return std::is_same<T, float>::value &&
+           in.getDataType() == TensorDim::DataType::FP32 &&
+           in.getContiguous() && out.getContiguous() &&
+           in.getDim() == out.getDim();
+  }
+
+  /**
+   * @brief check if the derivative can be computed in a single fused pass
+   *
+   * @param out output of the activation
+   * @param incoming incoming derivative
+   * @param outgoing outgoing derivative, may be empty
+   * @retval true if all are contiguous and of the same dimension
+   */
+  static bool isFusable(Tensor const &out, Tensor const &incoming,
+                        Tensor const &outgoing) {
+    return out.getContiguous() && incoming.getContiguous() &&
+           out.getDim() == incoming.getDim() &&
+           (outgoing.empty() ||
+            (outgoing.getContiguous() && out.getDim() == outgoing.getDim()));
+  }
+
   std::function<Tensor &(Tensor const &, Tensor &)> _act_fn;
   std::function<Tensor &(Tensor const &, Tensor &, Tensor &, Tensor const &)>
     _act_prime_fn; /**< prime function with input and output*/
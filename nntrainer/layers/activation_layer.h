@@ -59,6 +59,11 @@ public:
    */
   bool supportBackwarding() const override { return true; };
 
+  /**
+   * @copydoc Layer::supportRecompute()
+   */
+  bool supportRecompute() const override { return true; }
+
   /**
    * @copydoc Layer::exportTo(Exporter &exporter, ml::train::ExportMethods
    * method)
@@ -23,31 +23,46 @@
 
 #include <bn_layer.h>
 #include <layer_context.h>
-#include <lazy_tensor.h>
 #include <nntrainer_error.h>
 #include <nntrainer_log.h>
 #include <node_exporter.h>
+#include <normalization_kernel.h>
 #include <util_func.h>
 
 namespace nntrainer {
 
 static constexpr size_t SINGLE_INOUT_IDX = 0;
 
-enum BNParams {
-  mu,
-  var,
-  gamma,
-  beta,
-  deviation,
-  invstd,
-  cvar,
-  t_reduced,
-  t_full
-};
+enum BNParams { mu, var, gamma, beta, normalized, invstd };
+
+/**
+ * @brief view the tensor as [outer, channel, inner] around the given axis in
+ * the memory order of the tensor format
+ */
+static void getChannelView(const TensorDim &dim, unsigned int axis,
+                           unsigned int &outer, unsigned int &channel,
+                           unsigned int &inner) {
+  static constexpr unsigned int nchw[] = {0, 1, 2, 3};
+  static constexpr unsigned int nhwc[] = {0, 2, 3, 1};
+  const unsigned int *order =
+    dim.getFormat() == ml::train::TensorDim::Format::NHWC ? nhwc : nchw;
+
+  outer = inner = 1;
+  channel = dim.getTensorDim(axis);
+  bool before_axis = true;
+  for (unsigned int i = 0; i < ml::train::TensorDim::MAXDIM; ++i) {
+    if (order[i] == axis)
+      before_axis = false;
+    else if (before_axis)
+      outer *= dim.getTensorDim(order[i]);
+    else
+      inner *= dim.getTensorDim(order[i]);
+  }
+}
 
 BatchNormalizationLayer::BatchNormalizationLayer() :
   Layer(),
-  divider(0),
+  axis(1),
   bn_props(props::Epsilon(), props::BNPARAMS_MU_INIT(),
            props::BNPARAMS_VAR_INIT(), props::BNPARAMS_BETA_INIT(),
            props::BNPARAMS_GAMMA_INIT(), props::Momentum(), props::Axis(),
@@ -75,29 +90,13 @@ void BatchNormalizationLayer::finalize(InitLayerContext &context) {
 
   /// @note this logic cannot tell channel is actually 1 or it is just not used.
   auto &axis_prop = std::get<props::Axis>(bn_props);
-  unsigned int axis;
   if (axis_prop.empty())
     axis = in_dim.channel() > 1 ? 1 : 3;
   else
     axis = axis_prop.get();
 
-  /**
-   * @todo This can be speedup by employing transpose for convolution. With
-   * transpose, the channel dimension can be made last, and the remaining
-   * dimensions can be squeezed. This would allow the sum and average to be
-   * faster, and no temporary allocations inside them.
-   */
-
   dim.setTensorDim(axis, in_dim.getTensorDim(axis));
 
-  divider = 1;
-  for (unsigned int i = 0; i < 4; ++i) {
-    if (axis != i) {
-      axes_to_reduce.push_back(i);
-      divider *= in_dim.getTensorDim(i);
-    }
-  }
-
   wt_idx[BNParams::mu] =
     context.requestWeight(dim, bnparams_mu, WeightRegularizer::NONE, 1.0f, 0.0f,
                           "moving_mean", false);
@@ -112,38 +111,18 @@ void BatchNormalizationLayer::finalize(InitLayerContext &context) {
                           bias_decay, "beta", true);
 
   /**
-   * caches the deviation -> input - avg(input)
-   * @todo check if avoiding this storage and adding dependency on input (no
-   * more in-place calculation) can save memory during memory optimization.
+   * caches the normalized input -> (input - avg(input)) * invstd. This is the
+   * only full sized tensor of the layer: the statistics and the derivative are
+   * computed by fused kernels without any other full sized temporary, and the
+   * layer can still run in-place as the input itself is not needed anymore.
    */
-  wt_idx[BNParams::deviation] =
-    context.requestTensor(in_dim, "deviation", Tensor::Initializer::NONE, false,
-                          TensorLifespan::ITERATION_LIFESPAN);
+  wt_idx[BNParams::normalized] =
+    context.requestTensor(in_dim, "normalized", Tensor::Initializer::NONE,
+                          false, TensorLifespan::ITERATION_LIFESPAN);
   /** caches the inverse standard deviation */
   wt_idx[BNParams::invstd] =
     context.requestTensor(dim, "invstd", Tensor::Initializer::NONE, false,
                           TensorLifespan::ITERATION_LIFESPAN);
-  /**
-   * Temporary tensor to store the full sized tensors in order to allow batch
-   * norm to execute in-place. Running in-place leads to same memory footprint
-   * for this layer in its backwarding, but reduces the peak memory requirement
-   * as the output of this layer need not be stored all the time.
-   */
-  wt_idx[BNParams::t_full] =
-    context.requestTensor(in_dim, "tensor_full", Tensor::Initializer::NONE,
-                          false, TensorLifespan::CALC_DERIV_LIFESPAN);
-  /**
-   * caches variance + epsilon as well.
-   */
-  wt_idx[BNParams::cvar] =
-    context.requestTensor(dim, "cvar", Tensor::Initializer::NONE, false,
-                          TensorLifespan::ITERATION_LIFESPAN);
-  /**
-   * Temporary tensor to store the reduced tensors along the axes_to_reduce.
-   */
-  wt_idx[BNParams::t_reduced] =
-    context.requestTensor(dim, "tensor_reduced", Tensor::Initializer::NONE,
-                          false, TensorLifespan::FORWARD_DERIV_LIFESPAN);
 }
 
 void BatchNormalizationLayer::setProperty(
@@ -166,40 +145,23 @@ void BatchNormalizationLayer::forwarding(RunLayerContext &context,
 
   Tensor &input_ = context.getInput(SINGLE_INOUT_IDX);
   Tensor &hidden_ = context.getOutput(SINGLE_INOUT_IDX);
-  Tensor &deviation = context.getTensor(wt_idx[BNParams::deviation]);
+  Tensor &normalized = context.getTensor(wt_idx[BNParams::normalized]);
   Tensor &invstd = context.getTensor(wt_idx[BNParams::invstd]);
 
-  /** @todo these are not needed for inference, support optimizing these */
-  Tensor &t_reduced = context.getTensor(wt_idx[BNParams::t_reduced]);
-  /** use hidden_ as temporary tensor before setting the result in hidden */
-  Tensor t_full = hidden_;
-  Tensor &cvar = context.getTensor(wt_idx[BNParams::cvar]);
-
-  if (training) {
-    input_.average(axes_to_reduce, t_reduced);
-    input_.subtract(t_reduced, deviation);
-
-    mu.multiply_i(momentum);
-    mu.add_i(t_reduced, 1 - momentum);
-
-    deviation.pow(2.0f, t_full);
-    t_full.average(axes_to_reduce, cvar);
-
-    var.multiply_i(momentum);
-    var.add_i(cvar, 1 - momentum);
-
-    cvar.add_i(epsilon);
-    cvar.pow(-0.5f, invstd);
-  } else {
-    input_.subtract(mu, deviation);
-    /** @todo do below 2 lines only for first iteration */
-    var.add(epsilon, invstd);
-    invstd.pow_i(-0.5f);
-  }
-
-  deviation.multiply(invstd, hidden_);
-  hidden_.multiply_i(gamma);
-  hidden_.add_i(beta);
+  unsigned int outer, channel, inner;
+  getChannelView(input_.getDim(), axis, outer, channel, inner);
+
+  normalization_dispatch(
+    input_.getDataType(), gamma.getDataType(), [&](auto t, auto p) {
+      using T = decltype(t);
+      using P = decltype(p);
+      /** the normalized input is only needed for the backwarding */
+      T *xhat = training ? normalized.getData<T>() : nullptr;
+      batch_norm_forward<T, P>(
+        input_.getData<T>(), xhat, hidden_.getData<T>(), outer, channel, inner,
+        mu.getData<P>(), var.getData<P>(), gamma.getData<P>(),
+        beta.getData<P>(), invstd.getData<P>(), epsilon, momentum, training);
+    });
 }
 
 void BatchNormalizationLayer::calcDerivative(RunLayerContext &context) {
@@ -207,40 +169,26 @@ void BatchNormalizationLayer::calcDerivative(RunLayerContext &context) {
   Tensor &gamma = context.getWeight(wt_idx[BNParams::gamma]);
   const Tensor &deriv = context.getIncomingDerivative(SINGLE_INOUT_IDX);
   Tensor &dx = context.getOutgoingDerivative(SINGLE_INOUT_IDX);
-  Tensor &deviation = context.getTensor(wt_idx[BNParams::deviation]);
+  Tensor &normalized = context.getTensor(wt_idx[BNParams::normalized]);
   Tensor &invstd = context.getTensor(wt_idx[BNParams::invstd]);
-  Tensor &cvar = context.getTensor(wt_idx[BNParams::cvar]);
-
-  Tensor &t_reduced = context.getTensor(wt_idx[BNParams::t_reduced]);
-  Tensor &t_full = context.getTensor(wt_idx[BNParams::t_full]);
-
-  deviation.multiply(deriv, t_full);
-  t_full.average(axes_to_reduce, t_reduced);
-  t_reduced.divide_i(cvar);
-  deviation.multiply_i(t_reduced);
-
-  if (context.getTrainable()) {
-    /**
-     * This calculates dgamma tensor.
-     */
-    Tensor &dgamma = context.getWeightGrad(wt_idx[BNParams::gamma]);
-    t_full.multiply_i(invstd);
-    t_full.sum(axes_to_reduce, dgamma);
-
-    /**
-     * This implementation depends on the pre-calculated dbeta calculated.
-     */
-    Tensor &dbeta = context.getWeightGrad(wt_idx[BNParams::beta]);
-    dbeta.divide(divider, t_reduced);
-  } else {
-    deriv.average(axes_to_reduce, t_reduced);
-  }
 
-  deriv.subtract(t_reduced, dx);
-  dx.subtract_i(deviation);
-
-  invstd.multiply_i(gamma);
-  dx.multiply_i(invstd);
+  unsigned int outer, channel, inner;
+  getChannelView(deriv.getDim(), axis, outer, channel, inner);
+
+  /** dgamma is calculated here as it shares the reduction with dx */
+  Tensor *dgamma = context.getTrainable()
+                     ? &context.getWeightGrad(wt_idx[BNParams::gamma])
+                     : nullptr;
+
+  normalization_dispatch(
+    deriv.getDataType(), gamma.getDataType(), [&](auto t, auto p) {
+      using T = decltype(t);
+      using P = decltype(p);
+      batch_norm_backward<T, P>(deriv.getData<T>(), normalized.getData<T>(),
+                                dx.getData<T>(), outer, channel, inner,
+                                gamma.getData<P>(), invstd.getData<P>(),
+                                dgamma ? dgamma->getData<P>() : nullptr);
+    });
 }
 
 void BatchNormalizationLayer::calcGradient(RunLayerContext &context) {
@@ -248,7 +196,16 @@ void BatchNormalizationLayer::calcGradient(RunLayerContext &context) {
   Tensor &dbeta = context.getWeightGrad(wt_idx[BNParams::beta]);
   const Tensor &deriv = context.getIncomingDerivative(SINGLE_INOUT_IDX);
 
-  deriv.sum(axes_to_reduce, dbeta);
+  unsigned int outer, channel, inner;
+  getChannelView(deriv.getDim(), axis, outer, channel, inner);
+
+  normalization_dispatch(
+    deriv.getDataType(), dbeta.getDataType(), [&](auto t, auto p) {
+      using T = decltype(t);
+      using P = decltype(p);
+      batch_norm_channel_sum<T, P>(deriv.getData<T>(), outer, channel, inner,
+                                   dbeta.getData<P>());
+    });
 }
 
 void BatchNormalizationLayer::exportTo(
@@ -258,20 +215,7 @@ void BatchNormalizationLayer::exportTo(
 
 void BatchNormalizationLayer::setBatch(RunLayerContext &context,
                                        unsigned int batch) {
-  context.updateTensor(wt_idx[BNParams::deviation], batch);
-  context.updateTensor(wt_idx[BNParams::t_full], batch);
-
-  /// reset divider
-  divider = 1;
-  auto input_dim = context.getInput(0).getDim();
-  for (auto axis : axes_to_reduce) {
-    if (axis == 0) {
-      /// @note input dim batch is not updated, it will be more sensible we
-      /// update batch before any node comes to this spot
-      divider *= batch;
-    }
-    divider *= input_dim.getTensorDim(axis);
-  }
+  context.updateTensor(wt_idx[BNParams::normalized], batch);
 }
 
 } /* namespace nntrainer */
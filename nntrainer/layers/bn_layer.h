@@ -121,10 +121,9 @@ public:
   inline static const std::string type = "batch_normalization";
 
 private:
-  float divider; /**< size of the axes of the reduced */
+  unsigned int axis; /**< axis to keep, the other axes are reduced */
 
-  std::vector<unsigned int> axes_to_reduce; /**< target axes to reduce */
-  std::array<unsigned int, 9> wt_idx; /**< indices of the weights and tensors */
+  std::array<unsigned int, 6> wt_idx; /**< indices of the weights and tensors */
   std::tuple<props::Epsilon, props::BNPARAMS_MU_INIT, props::BNPARAMS_VAR_INIT,
              props::BNPARAMS_BETA_INIT, props::BNPARAMS_GAMMA_INIT,
              props::Momentum, props::Axis, props::WeightDecay, props::BiasDecay>
@@ -12,8 +12,11 @@
  * @details This layer takes centroid and calculate l2 distance
  */
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <limits>
+#include <numeric>
 #include <regex>
 #include <sstream>
 
@@ -23,6 +26,7 @@
 #include <nntrainer_log.h>
 #include <node_exporter.h>
 #include <tensor.h>
+#include <util_simd.h>
 #include <weight.h>
 
 namespace nntrainer {
@@ -31,7 +35,25 @@ static constexpr size_t SINGLE_INOUT_IDX = 0;
 
 enum KNNParams { map, num_samples };
 
-CentroidKNN::CentroidKNN() : Layer(), centroid_knn_props(props::NumClass()) {
+static constexpr unsigned int KMEANS_MAX_ITERATION = 10;
+
+/** score of a class which has no sample seen yet */
+static constexpr float EMPTY_CLASS_SCORE = std::numeric_limits<float>::min();
+
+/** score of a class which is not searched */
+static constexpr float UNSEARCHED_SCORE = std::numeric_limits<float>::lowest();
+
+/**
+ * @brief get the score of a class, -||a - b|| from ||a||^2 + ||b||^2 - 2a.b
+ */
+static inline float distanceScore(float a_norm, float b_norm, float dot) {
+  return -std::sqrt(std::max(a_norm + b_norm - 2 * dot, 0.0f));
+}
+
+CentroidKNN::CentroidKNN() :
+  Layer(),
+  centroid_knn_props(props::NumClass(), props::TopK(), props::IVFLists(),
+                     props::IVFProbes()) {
   weight_idx.fill(std::numeric_limits<unsigned>::max());
 }
 
@@ -80,11 +102,6 @@ void CentroidKNN::forwarding(nntrainer::RunLayerContext &context,
   auto &num_samples = context.getWeight(weight_idx[KNNParams::num_samples]);
   auto feature_len = input_dim.getFeatureLen();
 
-  auto get_distance = [](const nntrainer::Tensor &a,
-                         const nntrainer::Tensor &b) {
-    return -a.subtract(b).l2norm();
-  };
-
   if (training) {
     auto &label = context.getLabel(SINGLE_INOUT_IDX);
     auto ans = label.argmax();
@@ -104,22 +121,208 @@ void CentroidKNN::forwarding(nntrainer::RunLayerContext &context,
     }
   }
 
-  for (unsigned int i = 0; i < std::get<props::NumClass>(centroid_knn_props);
-       ++i) {
-    auto saved_feature =
-      map.getSharedDataTensor({feature_len}, i * feature_len);
-    // nntrainer::Tensor::Map(map.getData(), {feature_len}, i * feature_len);
+  unsigned int batch = input_.batch();
+  unsigned int num_class = std::get<props::NumClass>(centroid_knn_props);
+  auto features = input_.getSharedDataTensor({batch, feature_len}, 0);
+  auto scores = hidden_.getSharedDataTensor({batch, num_class}, 0);
 
-    auto num_sample = num_samples.getValue(0, 0, 0, i);
+  auto &ivf_lists = std::get<props::IVFLists>(centroid_knn_props);
+  if (!training && !ivf_lists.empty() && ivf_lists.get() < num_class) {
+    searchIndex(features, map, num_samples, scores);
+  } else {
+    /// distances of the whole batch to all the centroids by a single GEMM
+    features.dot(map, scores, false, true);
 
-    for (unsigned int b = 0; b < input_.batch(); ++b) {
-      auto current_feature = input_.getBatchSlice(b, 1);
+    const float *map_data = map.getData();
+    std::vector<float> class_norms(num_class);
+    for (unsigned int i = 0; i < num_class; ++i)
+      class_norms[i] =
+        reduce_sum_squares(feature_len, map_data + i * feature_len);
+
+    const float *sample_data = num_samples.getData();
+    float *score_data = scores.getData();
+    const float *feature_data = features.getData();
+    for (unsigned int b = 0; b < batch; ++b) {
+      float *row = score_data + b * num_class;
+      float norm =
+        reduce_sum_squares(feature_len, feature_data + b * feature_len);
+      for (unsigned int i = 0; i < num_class; ++i)
+        row[i] = sample_data[i] == 0
+                   ? EMPTY_CLASS_SCORE
+                   : distanceScore(norm, class_norms[i], row[i]);
+    }
+  }
+
+  auto &top_k = std::get<props::TopK>(centroid_knn_props);
+  if (top_k.empty() || top_k.get() >= num_class)
+    return;
+
+  /// keep the scores of the k nearest classes only
+  unsigned int k = top_k.get();
+  std::vector<unsigned int> order(num_class);
+  std::vector<float> kept(k);
+  float *score_data = scores.getData();
+  for (unsigned int b = 0; b < batch; ++b) {
+    float *row = score_data + b * num_class;
+    std::iota(order.begin(), order.end(), 0);
+    std::nth_element(
+      order.begin(), order.begin() + (k - 1), order.end(),
+      [row](unsigned int l, unsigned int r) { return row[l] > row[r]; });
+
+    for (unsigned int i = 0; i < k; ++i)
+      kept[i] = row[order[i]];
+    std::fill(row, row + num_class, UNSEARCHED_SCORE);
+    for (unsigned int i = 0; i < k; ++i)
+      row[order[i]] = kept[i];
+  }
+}
+
+bool CentroidKNN::isIndexValid(const Tensor &map,
+                               const Tensor &num_samples) const {
+  /// centroids loaded from a file may differ with the same samples seen
+  const float *sample_data = num_samples.getData();
+  const float *map_data = map.getData();
+  return ivf_num_samples.size() == num_samples.size() &&
+         std::equal(ivf_num_samples.begin(), ivf_num_samples.end(),
+                    sample_data) &&
+         ivf_map.size() == map.size() &&
+         std::equal(ivf_map.begin(), ivf_map.end(), map_data);
+}
+
+void CentroidKNN::buildIndex(const Tensor &map, const Tensor &num_samples) {
+  unsigned int num_class = map.height();
+  unsigned int feature_len = map.width();
+  const float *map_data = map.getData();
+  const float *sample_data = num_samples.getData();
+
+  ivf_map.assign(map_data, map_data + map.size());
+  ivf_num_samples.assign(sample_data, sample_data + num_samples.size());
+
+  std::vector<unsigned int> seen;
+  for (unsigned int i = 0; i < num_class; ++i) {
+    if (sample_data[i] != 0)
+      seen.push_back(i);
+  }
+
+  unsigned int num_lists = std::min<unsigned int>(
+    std::get<props::IVFLists>(centroid_knn_props).get(), seen.size());
+  ivf_members.assign(num_lists, {});
+  if (num_lists == 0) {
+    ivf_centroids = Tensor();
+    return;
+  }
+
+  /// start from the classes evenly spread over the seen ones
+  ivf_centroids = Tensor(TensorDim({num_lists, feature_len}));
+  float *centroids = ivf_centroids.getData();
+  for (unsigned int l = 0; l < num_lists; ++l) {
+    unsigned int c = seen[(size_t)l * seen.size() / num_lists];
+    std::copy(map_data + c * feature_len, map_data + (c + 1) * feature_len,
+              centroids + l * feature_len);
+  }
+
+  std::vector<unsigned int> assigned(seen.size(), num_lists);
+  std::vector<float> list_norms(num_lists);
+  std::vector<unsigned int> counts(num_lists);
+  for (unsigned int iter = 0; iter < KMEANS_MAX_ITERATION; ++iter) {
+    Tensor dots = map.dot(ivf_centroids, false, true);
+    const float *dot_data = dots.getData();
+    for (unsigned int l = 0; l < num_lists; ++l)
+      list_norms[l] =
+        reduce_sum_squares(feature_len, centroids + l * feature_len);
+
+    bool changed = false;
+    for (unsigned int j = 0; j < seen.size(); ++j) {
+      const float *row = dot_data + seen[j] * num_lists;
+      unsigned int nearest = 0;
+      for (unsigned int l = 1; l < num_lists; ++l) {
+        if (list_norms[l] - 2 * row[l] <
+            list_norms[nearest] - 2 * row[nearest])
+          nearest = l;
+      }
+      changed |= assigned[j] != nearest;
+      assigned[j] = nearest;
+    }
+
+    if (!changed)
+      break;
+
+    /// a cluster left without a class keeps its centroid
+    std::fill(counts.begin(), counts.end(), 0);
+    for (unsigned int l : assigned)
+      counts[l]++;
+    for (unsigned int l = 0; l < num_lists; ++l) {
+      if (counts[l] != 0)
+        std::fill_n(centroids + l * feature_len, feature_len, 0.0f);
+    }
+    for (unsigned int j = 0; j < seen.size(); ++j) {
+      const float *feature = map_data + seen[j] * feature_len;
+      float *centroid = centroids + assigned[j] * feature_len;
+      for (unsigned int f = 0; f < feature_len; ++f)
+        centroid[f] += feature[f] / counts[assigned[j]];
+    }
+  }
+
+  for (unsigned int j = 0; j < seen.size(); ++j)
+    ivf_members[assigned[j]].push_back(seen[j]);
+}
+
+void CentroidKNN::searchIndex(const Tensor &input, const Tensor &map,
+                              const Tensor &num_samples, Tensor &scores) {
+  if (!isIndexValid(map, num_samples))
+    buildIndex(map, num_samples);
+
+  unsigned int batch = input.height();
+  unsigned int feature_len = input.width();
+  unsigned int num_class = map.height();
+  unsigned int num_lists = ivf_members.size();
+  const float *input_data = input.getData();
+  const float *map_data = map.getData();
+  const float *sample_data = num_samples.getData();
+  float *score_data = scores.getData();
+
+  for (unsigned int i = 0; i < num_class; ++i)
+    score_data[i] = sample_data[i] == 0 ? EMPTY_CLASS_SCORE : UNSEARCHED_SCORE;
+  for (unsigned int b = 1; b < batch; ++b)
+    std::copy(score_data, score_data + num_class,
+              score_data + b * num_class);
+
+  if (num_lists == 0)
+    return;
+
+  unsigned int num_probes = std::min<unsigned int>(
+    std::get<props::IVFProbes>(centroid_knn_props).get(), num_lists);
+  Tensor list_dots = input.dot(ivf_centroids, false, true);
+  const float *centroids = ivf_centroids.getData();
+  std::vector<float> list_norms(num_lists);
+  for (unsigned int l = 0; l < num_lists; ++l)
+    list_norms[l] = reduce_sum_squares(feature_len, centroids + l * feature_len);
+
+  std::vector<float> list_dist(num_lists);
+  std::vector<unsigned int> order(num_lists);
+  for (unsigned int b = 0; b < batch; ++b) {
+    const float *feature = input_data + b * feature_len;
+    const float *dots = list_dots.getData() + b * num_lists;
+    float *row = score_data + b * num_class;
+
+    for (unsigned int l = 0; l < num_lists; ++l)
+      list_dist[l] = list_norms[l] - 2 * dots[l];
+
+    std::iota(order.begin(), order.end(), 0);
+    std::partial_sort(order.begin(), order.begin() + num_probes, order.end(),
+                      [&list_dist](unsigned int l, unsigned int r) {
+                        return list_dist[l] < list_dist[r];
+                      });
 
-      if (num_sample == 0) {
-        hidden_.setValue(b, 0, 0, i, std::numeric_limits<float>::min());
-      } else {
-        hidden_.setValue(b, 0, 0, i,
-                         get_distance(current_feature, saved_feature));
+    /// the few classes searched are compared directly, which does not lose
+    /// the precision as the norm expansion does for far away features
+    for (unsigned int p = 0; p < num_probes; ++p) {
+      for (unsigned int c : ivf_members[order[p]]) {
+        const float *centroid = map_data + c * feature_len;
+        float sum = 0.0f;
+        for (unsigned int f = 0; f < feature_len; ++f)
+          sum += (feature[f] - centroid[f]) * (feature[f] - centroid[f]);
+        row[c] = -std::sqrt(sum);
       }
     }
   }
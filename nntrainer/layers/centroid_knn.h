@@ -5,7 +5,9 @@
  * @file   centroid_knn.h
  * @date   09 Jan 2021
  * @details  This file contains the simple nearest neighbor layer, this layer
- * takes centroid and calculate l2 distance
+ * takes centroid and calculate l2 distance. The distances of a batch to all the
+ * centroids are computed by a single GEMM, and for a large number of classes an
+ * inverted file index searches only the classes of the nearest clusters.
  * @see    https://github.com/nnstreamer/nntrainer
  * @author Jihoon Lee <jhoon.it.lee@samsung.com>
  * @bug    No known bugs except for NYI items
@@ -14,9 +16,11 @@
 #ifndef __CENTROID_KNN_H__
 #define __CENTROID_KNN_H__
 #include <string>
+#include <vector>
 
 #include <common_properties.h>
 #include <layer_devel.h>
+#include <tensor.h>
 
 namespace nntrainer {
 
@@ -94,8 +98,46 @@ public:
   inline static const std::string type = "centroid_knn";
 
 private:
-  std::tuple<props::NumClass> centroid_knn_props;
+  /**
+   * @brief Check if the index is built with the current centroids
+   *
+   * @param map centroid of each class
+   * @param num_samples samples seen for each class
+   * @return true if the centroids and the samples seen are the same as the
+   * index is built with
+   */
+  bool isIndexValid(const Tensor &map, const Tensor &num_samples) const;
+
+  /**
+   * @brief Group the classes seen into ivf_lists clusters by k-means
+   *
+   * @param map centroid of each class
+   * @param num_samples samples seen for each class
+   */
+  void buildIndex(const Tensor &map, const Tensor &num_samples);
+
+  /**
+   * @brief Compute the scores of the classes of the nearest clusters only,
+   * the other classes get the lowest score
+   *
+   * @param input features, batch x feature_len
+   * @param map centroid of each class
+   * @param num_samples samples seen for each class
+   * @param[out] scores scores, batch x num_class
+   */
+  void searchIndex(const Tensor &input, const Tensor &map,
+                   const Tensor &num_samples, Tensor &scores);
+
+  std::tuple<props::NumClass, props::TopK, props::IVFLists, props::IVFProbes>
+    centroid_knn_props;
   std::array<unsigned int, 2> weight_idx; /**< indices of the weights */
+
+  Tensor ivf_centroids; /**< centroid of each cluster of the index */
+  std::vector<std::vector<unsigned int>> ivf_members; /**< classes of each
+                                                         cluster */
+  std::vector<float> ivf_map; /**< centroids when the index is built */
+  std::vector<float> ivf_num_samples; /**< samples seen when the index is
+                                         built */
 };
 } // namespace nntrainer
 
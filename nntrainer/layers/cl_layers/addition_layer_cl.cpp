@@ -86,10 +86,8 @@ void AdditionLayerCL::incremental_forwarding(RunLayerContext &context,
   TensorDim hidden_step_dim = hidden_dim;
 
   if (from) {
-    NNTR_THROW_IF(to - from != 1, std::invalid_argument)
-      << "incremental step size is not 1";
+    to -= from;
     from = 0;
-    to = 1;
   }
 
   hidden_step_dim.batch(1);
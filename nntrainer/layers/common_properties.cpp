@@ -82,6 +82,8 @@ Bidirectional::Bidirectional(bool value) { set(value); }
 
 bool NumClass::isValid(const unsigned int &v) const { return v > 0; }
 
+IVFProbes::IVFProbes(unsigned int value) { set(value); }
+
 InputConnection::InputConnection() : nntrainer::Property<Connection>() {}
 InputConnection::InputConnection(const Connection &value) :
   nntrainer::Property<Connection>(value) {} /**< default value if any */
@@ -342,11 +344,19 @@ CausalMask::CausalMask(bool value) { set(value); }
 
 NumHeads::NumHeads(unsigned int value) { set(value); }
 
+RopeTheta::RopeTheta(float value) { set(value); }
+
+bool RopeTheta::isValid(const float &value) const { return value > 1.0f; }
+
 ReturnAttentionWeight::ReturnAttentionWeight(
   ReturnAttentionWeightInfo::Enum value) {
   set(value);
 }
 
+KVCacheDataType::KVCacheDataType(KVCacheDataTypeInfo::Enum value) {
+  set(value);
+}
+
 } // namespace props
 
 template <>
@@ -113,6 +113,22 @@ public:
   using prop_tag = bool_prop_tag;
 };
 
+/**
+ * @brief checkpoint property, the output of a checkpoint layer is kept till
+ * the backwarding while the layers in between two checkpoints are recomputed
+ *
+ */
+class Checkpoint : public nntrainer::Property<bool> {
+public:
+  /**
+   * @brief Construct a new Checkpoint object
+   *
+   */
+  Checkpoint(bool val = false) : nntrainer::Property<bool>(val) {}
+  static constexpr const char *key = "checkpoint";
+  using prop_tag = bool_prop_tag;
+};
+
 /**
  * @brief trainable property, use this to set and check how if certain layer is
  * trainable
@@ -735,6 +751,43 @@ public:
   bool isValid(const unsigned int &v) const override;
 };
 
+/**
+ * @brief TopK property, number of the nearest classes to keep the score of
+ *
+ */
+class TopK final : public nntrainer::PositiveIntegerProperty {
+public:
+  static constexpr const char *key = "top_k"; /**< unique key to access */
+  using prop_tag = uint_prop_tag;             /**< property type */
+};
+
+/**
+ * @brief IVFLists property, number of the clusters the classes are grouped
+ * into for the approximate search, the search is exact if not set
+ *
+ */
+class IVFLists final : public nntrainer::PositiveIntegerProperty {
+public:
+  static constexpr const char *key = "ivf_lists"; /**< unique key to access */
+  using prop_tag = uint_prop_tag;                 /**< property type */
+};
+
+/**
+ * @brief IVFProbes property, number of the nearest clusters searched by the
+ * approximate search
+ *
+ */
+class IVFProbes final : public nntrainer::PositiveIntegerProperty {
+public:
+  /**
+   * @brief Construct a new IVFProbes object with a default value 1
+   *
+   */
+  IVFProbes(unsigned int value = 1);
+  static constexpr const char *key = "ivf_probes"; /**< unique key to access */
+  using prop_tag = uint_prop_tag;                  /**< property type */
+};
+
 /**
  * @brief BasicRegularizerConstant property, this defines how much regularize
  * the weight
@@ -1254,6 +1307,30 @@ public:
   using prop_tag = uint_prop_tag;                 /**< property type */
 };
 
+/**
+ * @brief RopeTheta property, base of the rotary embedding frequencies
+ *
+ */
+class RopeTheta : public nntrainer::Property<float> {
+public:
+  /**
+   * @brief Construct a new RopeTheta object with a default value 10000
+   *
+   */
+  RopeTheta(float value = 10000.0f);
+  static constexpr const char *key = "rope_theta"; /**< unique key to access */
+  using prop_tag = float_prop_tag;                 /**< property type */
+
+  /**
+   * @brief RopeTheta validator
+   *
+   * @param value float to validate
+   * @retval true if it is greater than 1.0
+   * @retval false if it is smaller or equal than 1.0
+   */
+  bool isValid(const float &value) const override;
+};
+
 /**
  * @brief ProjectedKeyDim property, projected key dim per head in multi head
  * attention
@@ -1327,6 +1404,39 @@ public:
                           ReturnAttentionWeightInfo::Enum::none);
 };
 
+/**
+ * @brief Enumeration of the data type of the key/value cache
+ */
+struct KVCacheDataTypeInfo {
+  enum class Enum { activation, fp16, int8 };
+  static constexpr std::initializer_list<Enum> EnumList = {
+    Enum::activation, Enum::fp16, Enum::int8};
+
+  static constexpr const char *EnumStr[] = {"activation", "fp16", "int8"};
+};
+
+/**
+ * @brief KVCacheDataType, data type the keys/values are cached at for the
+ * incremental forwarding
+ * @details "activation" caches at the data type of the activation. "fp16"
+ * caches half-precision keys/values under a single precision model. "int8"
+ * quantizes every head of every cached key/value with its own scale.
+ *
+ */
+class KVCacheDataType : public EnumProperty<KVCacheDataTypeInfo> {
+public:
+  static constexpr const char *key =
+    "kv_cache_dtype";                   /**< unique key to access */
+  using prop_tag = enum_class_prop_tag; /**< property type */
+
+  /**
+   * @brief Construct a new KVCacheDataType object
+   *
+   */
+  KVCacheDataType(
+    KVCacheDataTypeInfo::Enum value = KVCacheDataTypeInfo::Enum::activation);
+};
+
 /**
  * @brief AverageAttentionWeight, average attention weight
  * @details Correspond with average_attn_weights of torch
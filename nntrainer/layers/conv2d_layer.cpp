@@ -15,6 +15,7 @@
 #include <cstring>
 #include <limits>
 #include <string>
+#include <vector>
 
 #include <blas_interface.h>
 #include <conv2d_layer.h>
@@ -241,6 +242,30 @@ static void im2col(const Tensor &in, const TensorDim &kdim,
   }
 }
 
+/**
+ * @brief     describe the convolution of a single image for conv2d_kernel
+ */
+static Conv2DShape
+getConv2DShape(const TensorDim &in, const TensorDim &out,
+               const TensorDim &kdim, const std::array<unsigned, 4> &padding,
+               const std::array<props::Stride, CONV2D_DIM> &mstride,
+               const std::array<props::Dilation, CONV2D_DIM> &dilation) {
+  return {static_cast<unsigned int>(in.channel()),
+          static_cast<unsigned int>(in.height()),
+          static_cast<unsigned int>(in.width()),
+          static_cast<unsigned int>(out.channel()),
+          static_cast<unsigned int>(out.height()),
+          static_cast<unsigned int>(out.width()),
+          static_cast<unsigned int>(kdim.height()),
+          static_cast<unsigned int>(kdim.width()),
+          mstride[0],
+          mstride[1],
+          dilation[0],
+          dilation[1],
+          padding[0],
+          padding[2]};
+}
+
 } // namespace
 
 enum ConvParams { weight, bias };
@@ -249,6 +274,7 @@ Conv2DLayer::Conv2DLayer(
   const std::array<unsigned int, CONV2D_DIM * 2> &padding_) :
   LayerImpl(),
   padding(padding_),
+  conv_algorithm(Conv2DAlgorithm::IM2COL),
   conv_props(props::FilterSize(), std::array<props::KernelSize, CONV2D_DIM>(),
              std::array<props::Stride, CONV2D_DIM>(), props::Padding2D(),
              std::array<props::Dilation, CONV2D_DIM>()) {
@@ -322,6 +348,12 @@ void Conv2DLayer::finalize(InitLayerContext &context) {
                   eff_in_width - padding[2] - kernel_size[1] > IM,
                 std::invalid_argument)
     << "Failed to initialize: Calculated patch end is over int max";
+  /**
+   * im2col + gemm needs a [K * K * C, H * W] column matrix per image. Shapes
+   * where a workspace free kernel is faster do not allocate it at all.
+   */
+  conv_algorithm = conv2d_select_algorithm(
+    getConv2DShape(in_dim, out_dim, kernel_dim, padding, stride, dilation));
 }
 
 void Conv2DLayer::forwarding(RunLayerContext &context, bool training) {
@@ -381,12 +413,39 @@ void Conv2DLayer::forwarding(RunLayerContext &context, bool training) {
 
   filter_kernel.reshape(filter_dim_squeezed);
 
+  const Conv2DShape shape =
+    getConv2DShape(in_dim, out_dim, filter_dim, padding, stride, dilation);
+  const bool is_winograd = conv_algorithm == Conv2DAlgorithm::WINOGRAD_2X2 ||
+                           conv_algorithm == Conv2DAlgorithm::WINOGRAD_4X4;
+
+  /** the filter is transformed once and shared by every image */
+  std::vector<float> winograd_filter;
+  if (is_winograd) {
+    winograd_filter.resize(conv2d_winograd_filter_size(shape, conv_algorithm));
+    conv2d_winograd_transform_filter(shape, conv_algorithm,
+                                     filter_kernel.getData(),
+                                     winograd_filter.data());
+  }
+
   /**
    * Below sets the pad area values to zero
    * it is faster to do this way than seting selective area to zero
    */
   auto forwarding_job = [&](unsigned int s, unsigned int e, unsigned int pid,
                             void *user_data) {
+    if (conv_algorithm != Conv2DAlgorithm::IM2COL) {
+      for (unsigned int b = s; b < e; ++b) {
+        const float *in = input_.getAddress<float>(b, 0, 0, 0);
+        float *out = hidden_.getAddress<float>(b, 0, 0, 0);
+        if (is_winograd)
+          conv2d_winograd(shape, conv_algorithm, in, winograd_filter.data(),
+                          out);
+        else
+          conv2d_direct(shape, in, filter_kernel.getData(), out);
+      }
+      return;
+    }
+
     Tensor result = Tensor(calcCol2ImOutputDim(out_dim, filter_dim));
     result.setZero();
     for (unsigned int b = s; b < e; ++b) {
@@ -18,6 +18,7 @@
 #include <memory.h>
 
 #include <common_properties.h>
+#include <conv2d_kernel.h>
 #include <layer_impl.h>
 
 namespace nntrainer {
@@ -90,6 +91,11 @@ public:
    */
   bool supportBackwarding() const override { return true; }
 
+  /**
+   * @copydoc Layer::supportRecompute()
+   */
+  bool supportRecompute() const override { return true; }
+
   using Layer::setProperty;
 
   /**
@@ -110,6 +116,7 @@ public:
 
 private:
   std::array<unsigned int, CONV2D_DIM * 2> padding;
+  Conv2DAlgorithm conv_algorithm; /**< algorithm used for the forwarding */
   std::tuple<props::FilterSize, std::array<props::KernelSize, CONV2D_DIM>,
              std::array<props::Stride, CONV2D_DIM>, props::Padding2D,
              std::array<props::Dilation, CONV2D_DIM>>
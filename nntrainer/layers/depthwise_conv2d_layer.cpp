@@ -0,0 +1,306 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   depthwise_conv2d_layer.cpp
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  This is Depthwise Convolution Layer Class for Neural Network
+ *
+ */
+#include <limits>
+#include <string>
+
+#include <conv2d_kernel.h>
+#include <depthwise_conv2d_layer.h>
+#include <layer_context.h>
+#include <nntr_threads.h>
+#include <nntrainer_error.h>
+#include <nntrainer_log.h>
+#include <node_exporter.h>
+#include <util_func.h>
+
+namespace nntrainer {
+
+static constexpr size_t SINGLE_INOUT_IDX = 0;
+
+enum DepthwiseConvParams { weight, bias };
+
+namespace {
+
+/**
+ * @brief     describe the depthwise convolution of a single image
+ */
+Conv2DShape getDepthwiseShape(
+  const TensorDim &in, const TensorDim &out, const TensorDim &kdim,
+  const std::array<unsigned int, DEPTHWISE_CONV2D_DIM * 2> &padding,
+  const std::array<props::Stride, DEPTHWISE_CONV2D_DIM> &stride,
+  const std::array<props::Dilation, DEPTHWISE_CONV2D_DIM> &dilation) {
+  return {static_cast<unsigned int>(in.channel()),
+          static_cast<unsigned int>(in.height()),
+          static_cast<unsigned int>(in.width()),
+          static_cast<unsigned int>(out.channel()),
+          static_cast<unsigned int>(out.height()),
+          static_cast<unsigned int>(out.width()),
+          static_cast<unsigned int>(kdim.height()),
+          static_cast<unsigned int>(kdim.width()),
+          stride[0],
+          stride[1],
+          dilation[0],
+          dilation[1],
+          padding[0],
+          padding[2]};
+}
+
+/**
+ * @brief     run job(b) for every image of the batch, in parallel if possible
+ */
+template <typename F> void forEachImage(unsigned int batch, F &&job) {
+  auto batch_job = [&job](unsigned int s, unsigned int e, unsigned int pid,
+                          void *user_data) {
+    for (unsigned int b = s; b < e; ++b)
+      job(b);
+  };
+
+  auto workers = ParallelBatch(batch_job, batch, nullptr);
+  if (workers.getNumWorkers() > 1) {
+    workers.run();
+  } else {
+    batch_job(0, batch, 0, nullptr);
+  }
+}
+
+} // namespace
+
+DepthwiseConv2DLayer::DepthwiseConv2DLayer(
+  const std::array<unsigned int, DEPTHWISE_CONV2D_DIM * 2> &padding_) :
+  LayerImpl(),
+  padding(padding_),
+  depth_multiplier(1),
+  depthwise_conv_props(
+    props::FilterSize(),
+    std::array<props::KernelSize, DEPTHWISE_CONV2D_DIM>(),
+    std::array<props::Stride, DEPTHWISE_CONV2D_DIM>(), props::Padding2D(),
+    std::array<props::Dilation, DEPTHWISE_CONV2D_DIM>()) {
+  wt_idx.fill(std::numeric_limits<unsigned>::max());
+}
+
+void DepthwiseConv2DLayer::finalize(InitLayerContext &context) {
+  NNTR_THROW_IF(context.getNumInputs() != 1, std::invalid_argument)
+    << "Depthwise convolution layer takes only one input";
+
+  const TensorDim &in_dim = context.getInputDimensions()[0];
+
+  NNTR_THROW_IF(in_dim.getDataType() != TensorDim::DataType::FP32,
+                std::invalid_argument)
+    << "Depthwise convolution layer only supports fp32 activations";
+
+  auto &weight_regularizer =
+    std::get<props::WeightRegularizer>(*layer_impl_props);
+  auto &weight_regularizer_constant =
+    std::get<props::WeightRegularizerConstant>(*layer_impl_props);
+  auto &weight_initializer =
+    std::get<props::WeightInitializer>(*layer_impl_props);
+  auto &weight_decay = std::get<props::WeightDecay>(*layer_impl_props);
+  auto &bias_decay = std::get<props::BiasDecay>(*layer_impl_props);
+  auto &bias_initializer = std::get<props::BiasInitializer>(*layer_impl_props);
+  auto &disable_bias = std::get<props::DisableBias>(*layer_impl_props);
+
+  auto &filters = std::get<props::FilterSize>(depthwise_conv_props);
+  auto &kernel_size =
+    std::get<std::array<props::KernelSize, DEPTHWISE_CONV2D_DIM>>(
+      depthwise_conv_props);
+  auto &stride = std::get<std::array<props::Stride, DEPTHWISE_CONV2D_DIM>>(
+    depthwise_conv_props);
+  auto &dilation =
+    std::get<std::array<props::Dilation, DEPTHWISE_CONV2D_DIM>>(
+      depthwise_conv_props);
+
+  /** filters = in_channel * depth multiplier, multiplier 1 by default */
+  unsigned int in_channel = in_dim.channel();
+  unsigned int filter_size = filters.empty() ? in_channel : filters.get();
+  NNTR_THROW_IF(filter_size % in_channel != 0, std::invalid_argument)
+    << "Depthwise convolution filters must be a multiple of the input "
+       "channels, filters: "
+    << filter_size << " input channels: " << in_channel;
+  depth_multiplier = filter_size / in_channel;
+
+  TensorDim kernel_dim =
+    TensorDim(filter_size, 1, kernel_size[0], kernel_size[1]);
+  TensorDim bias_dim = TensorDim(1, filter_size, 1, 1);
+
+  padding = std::get<props::Padding2D>(depthwise_conv_props)
+              .compute(in_dim, kernel_dim, {stride[0], stride[1]},
+                       {dilation[0], dilation[1]});
+
+  wt_idx[DepthwiseConvParams::weight] = context.requestWeight(
+    kernel_dim, weight_initializer, weight_regularizer,
+    weight_regularizer_constant, weight_decay, "filter", true, 0);
+
+  if (disable_bias.empty() || disable_bias.get() == false) {
+    wt_idx[DepthwiseConvParams::bias] =
+      context.requestWeight(bias_dim, bias_initializer, WeightRegularizer::NONE,
+                            1.0f, bias_decay, "bias", true, 0);
+  }
+
+  unsigned int eff_in_height = in_dim.height() + padding[0] + padding[1];
+  unsigned int eff_in_width = in_dim.width() + padding[2] + padding[3];
+
+  unsigned int eff_k_height = (kernel_size[0] - 1) * dilation[0] + 1;
+  unsigned int eff_k_width = (kernel_size[1] - 1) * dilation[1] + 1;
+
+  NNTR_THROW_IF(eff_in_height < eff_k_height || eff_in_width < eff_k_width,
+                std::invalid_argument)
+    << "Failed to initialize: in size + padding is smaller than effective "
+       "kernel";
+
+  TensorDim out_dim(in_dim.getFormat(), in_dim.getDataType());
+  out_dim.batch(in_dim.batch());
+  out_dim.channel(filter_size);
+  out_dim.height((eff_in_height - eff_k_height) / stride[0] + 1);
+  out_dim.width((eff_in_width - eff_k_width) / stride[1] + 1);
+  context.setOutputDimensions({out_dim});
+}
+
+void DepthwiseConv2DLayer::forwarding(RunLayerContext &context,
+                                      bool training) {
+  auto &stride = std::get<std::array<props::Stride, DEPTHWISE_CONV2D_DIM>>(
+    depthwise_conv_props);
+  auto &dilation =
+    std::get<std::array<props::Dilation, DEPTHWISE_CONV2D_DIM>>(
+      depthwise_conv_props);
+
+  Tensor &input_ = context.getInput(SINGLE_INOUT_IDX);
+  Tensor &hidden_ = context.getOutput(SINGLE_INOUT_IDX);
+  Tensor &filter_kernel =
+    context.getWeight(wt_idx[DepthwiseConvParams::weight]);
+
+  const TensorDim in_dim = input_.getDim();
+  const TensorDim out_dim = hidden_.getDim();
+  const Conv2DShape shape = getDepthwiseShape(
+    in_dim, out_dim, filter_kernel.getDim(), padding, stride, dilation);
+  const bool nhwc = input_.getFormat() == Tformat::NHWC;
+
+  const float *in = input_.getData();
+  const float *filter = filter_kernel.getData();
+  float *out = hidden_.getData();
+  const size_t in_len = in_dim.getFeatureLen();
+  const size_t out_len = out_dim.getFeatureLen();
+
+  forEachImage(in_dim.batch(), [&](unsigned int b) {
+    depthwise_conv2d(shape, nhwc, in + b * in_len, filter, out + b * out_len);
+  });
+
+  if (auto &disable_bias = std::get<props::DisableBias>(*layer_impl_props);
+      disable_bias.empty() || disable_bias.get() == false) {
+    Tensor &bias_kernel = context.getWeight(wt_idx[DepthwiseConvParams::bias]);
+    int status = hidden_.add_i(bias_kernel);
+    if (status != ML_ERROR_NONE) {
+      throw std::invalid_argument("[DepthwiseConv2D] adding bias failed");
+    }
+  }
+}
+
+void DepthwiseConv2DLayer::calcDerivative(RunLayerContext &context) {
+  auto &stride = std::get<std::array<props::Stride, DEPTHWISE_CONV2D_DIM>>(
+    depthwise_conv_props);
+  auto &dilation =
+    std::get<std::array<props::Dilation, DEPTHWISE_CONV2D_DIM>>(
+      depthwise_conv_props);
+
+  const Tensor &derivative = context.getIncomingDerivative(SINGLE_INOUT_IDX);
+  Tensor &input_derivative = context.getOutgoingDerivative(SINGLE_INOUT_IDX);
+  Tensor &filter_kernel =
+    context.getWeight(wt_idx[DepthwiseConvParams::weight]);
+
+  const TensorDim in_dim = input_derivative.getDim();
+  const TensorDim out_dim = derivative.getDim();
+  const Conv2DShape shape = getDepthwiseShape(
+    in_dim, out_dim, filter_kernel.getDim(), padding, stride, dilation);
+  const bool nhwc = derivative.getFormat() == Tformat::NHWC;
+
+  const float *dy = derivative.getData();
+  const float *filter = filter_kernel.getData();
+  float *dx = input_derivative.getData();
+  const size_t in_len = in_dim.getFeatureLen();
+  const size_t out_len = out_dim.getFeatureLen();
+
+  forEachImage(in_dim.batch(), [&](unsigned int b) {
+    depthwise_conv2d_derivative(shape, nhwc, dy + b * out_len, filter,
+                                dx + b * in_len);
+  });
+}
+
+void DepthwiseConv2DLayer::calcGradient(RunLayerContext &context) {
+  auto &stride = std::get<std::array<props::Stride, DEPTHWISE_CONV2D_DIM>>(
+    depthwise_conv_props);
+  auto &dilation =
+    std::get<std::array<props::Dilation, DEPTHWISE_CONV2D_DIM>>(
+      depthwise_conv_props);
+
+  const Tensor &derivative = context.getIncomingDerivative(SINGLE_INOUT_IDX);
+  Tensor &input_ = context.getInput(SINGLE_INOUT_IDX);
+  Tensor &delK = context.getWeightGrad(wt_idx[DepthwiseConvParams::weight]);
+
+  const TensorDim in_dim = input_.getDim();
+  const TensorDim out_dim = derivative.getDim();
+  const Conv2DShape shape = getDepthwiseShape(in_dim, out_dim, delK.getDim(),
+                                              padding, stride, dilation);
+  const bool nhwc = input_.getFormat() == Tformat::NHWC;
+
+  const float *dy = derivative.getData();
+  const float *in = input_.getData();
+  const size_t in_len = in_dim.getFeatureLen();
+  const size_t out_len = out_dim.getFeatureLen();
+
+  /** every image accumulates into the same filter, so this is serial. The
+   * gradient is only cleared on its first access to accumulate over the
+   * shared weights and the gradient accumulation */
+  if (context.isGradientFirstAccess(wt_idx[DepthwiseConvParams::weight]))
+    delK.setZero();
+  for (unsigned int b = 0; b < in_dim.batch(); ++b)
+    depthwise_conv2d_gradient(shape, nhwc, dy + b * out_len, in + b * in_len,
+                              delK.getData());
+
+  if (auto &disable_bias = std::get<props::DisableBias>(*layer_impl_props);
+      disable_bias.empty() || disable_bias.get() == false) {
+    Tensor &delBias = context.getWeightGrad(wt_idx[DepthwiseConvParams::bias]);
+    if (context.isGradientFirstAccess(wt_idx[DepthwiseConvParams::bias]))
+      delBias.setZero();
+
+    /** the channel is the outermost axis of an image plane in NCHW and the
+     * innermost one in NHWC */
+    const unsigned int channel = out_dim.channel();
+    const size_t plane = out_len / channel;
+    float *dbias = delBias.getData();
+    for (unsigned int b = 0; b < out_dim.batch(); ++b) {
+      const float *d_img = dy + b * out_len;
+      if (nhwc) {
+        for (size_t p = 0; p < plane; ++p)
+          for (unsigned int k = 0; k < channel; ++k)
+            dbias[k] += d_img[p * channel + k];
+      } else {
+        for (unsigned int k = 0; k < channel; ++k) {
+          const float *d_plane = d_img + k * plane;
+          float sum = 0.0f;
+          for (size_t p = 0; p < plane; ++p)
+            sum += d_plane[p];
+          dbias[k] += sum;
+        }
+      }
+    }
+  }
+}
+
+void DepthwiseConv2DLayer::exportTo(
+  Exporter &exporter, const ml::train::ExportMethods &method) const {
+  LayerImpl::exportTo(exporter, method);
+  exporter.saveResult(depthwise_conv_props, method, this);
+}
+
+void DepthwiseConv2DLayer::setProperty(const std::vector<std::string> &values) {
+  auto remain_props = loadProperties(values, depthwise_conv_props);
+  LayerImpl::setProperty(remain_props);
+}
+
+} /* namespace nntrainer */
@@ -33,8 +33,8 @@ public:
   /**
    * @brief     Constructor of Depthwise Convolution 2D Layer
    */
-  DepthwiseConv2DLayer(
-    const std::array<unsigned int, CONV2D_DIM * 2> &padding_ = {0, 0, 0, 0});
+  DepthwiseConv2DLayer(const std::array<unsigned int, DEPTHWISE_CONV2D_DIM * 2>
+                         &padding_ = {0, 0, 0, 0});
 
   /**
    * @brief     Destructor of Depthwise Convolution 2D Layer
@@ -92,6 +92,11 @@ public:
    */
   bool supportBackwarding() const override { return true; }
 
+  /**
+   * @copydoc Layer::supportRecompute()
+   */
+  bool supportRecompute() const override { return true; }
+
   using Layer::setProperty;
 
   /**
@@ -108,10 +113,17 @@ public:
   /*   unknown = 3, */
   /* }; */
 
+  /**
+   * @brief     get the number of filters per input channel
+   * @return    unsigned int depth multiplier, valid after finalize
+   */
+  unsigned int getDepthMultiplier() const { return depth_multiplier; }
+
   inline static const std::string type = "depthwiseconv2d";
 
 private:
   std::array<unsigned int, DEPTHWISE_CONV2D_DIM * 2> padding;
+  unsigned int depth_multiplier; /**< filters / input channels */
   std::tuple<props::FilterSize,
              std::array<props::KernelSize, DEPTHWISE_CONV2D_DIM>,
              std::array<props::Stride, DEPTHWISE_CONV2D_DIM>, props::Padding2D,
@@ -96,6 +96,13 @@ public:
    */
   bool supportInPlace() const override { return false; }
 
+  /**
+   * @copydoc Layer::isRandomInTraining()
+   */
+  bool isRandomInTraining() const override {
+    return std::get<props::DropOutRate>(dropout_rate).get() > epsilon;
+  }
+
   inline static const std::string type = "dropout";
 
 private:
@@ -19,6 +19,7 @@
 #include <node_exporter.h>
 #include <util_func.h>
 
+#include <algorithm>
 #include <iostream>
 
 namespace nntrainer {
@@ -120,11 +121,10 @@ void EmbeddingLayer::incremental_forwarding(RunLayerContext &context,
   unsigned int in_dim = std::get<props::InDim>(embedding_props);
   unsigned int out_dim = std::get<props::OutDim>(embedding_props);
 
+  /** the tokens of a step after the first one start from the first element */
   if (from) {
-    NNTR_THROW_IF(to - from != 1, std::invalid_argument)
-      << "incremental step size is not 1";
+    to -= from;
     from = 0;
-    to = 1;
   }
 
   Tensor &weight = context.getWeight(weight_idx);
@@ -161,25 +161,64 @@ void EmbeddingLayer::calcDerivative(RunLayerContext &context) {
     "calcDerivative for Embedding layer is not supported");
 }
 
-void EmbeddingLayer::calcGradient(RunLayerContext &context) {
+void EmbeddingLayer::calcSparseGradient(RunLayerContext &context) {
   unsigned int out_dim = std::get<props::OutDim>(embedding_props);
 
   Tensor &djdw = context.getWeightGrad(weight_idx);
   const Tensor &derivative_ = context.getIncomingDerivative(SINGLE_INOUT_IDX);
   Tensor &input_ = context.getInput(SINGLE_INOUT_IDX);
 
-  djdw.setZero();
+  unsigned int width = input_.width();
+  unsigned int feature_len = input_.getDim().getFeatureLen();
+  unsigned int deriv_len = derivative_.getDim().getFeatureLen();
+
+  std::vector<unsigned int> rows;
+  rows.reserve(input_.batch() * width);
+  for (unsigned int b = 0; b < input_.batch(); ++b) {
+    const float *in_data = input_.getAddress<float>(b * feature_len);
+    for (unsigned int i = 0; i < width; ++i)
+      rows.push_back(static_cast<unsigned int>(in_data[i]));
+  }
+  std::sort(rows.begin(), rows.end());
+  rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+  /** row k of djdw accumulates the gradient of the weight row rows[k] */
+  float *djdw_data = djdw.getData<float>();
+  std::fill(djdw_data, djdw_data + rows.size() * out_dim, 0.0f);
 
-  // TODO:
-  // This is to calculate gradient with current implementation of optimizer.
-  // In order to accelerate, we need to better way like using index to weight.
+  for (unsigned int b = 0; b < input_.batch(); ++b) {
+    const float *in_data = input_.getAddress<float>(b * feature_len);
+    for (unsigned int i = 0; i < width; ++i) {
+      unsigned int embed_idx = static_cast<unsigned int>(in_data[i]);
+      size_t k = std::lower_bound(rows.begin(), rows.end(), embed_idx) -
+                 rows.begin();
+
+      float *row = djdw_data + k * out_dim;
+      const float *grad_data =
+        derivative_.getAddress<float>(b * deriv_len + i * out_dim);
+      std::transform(row, row + out_dim, grad_data, row, std::plus<float>());
+    }
+  }
+
+  context.setWeightGradientRows(weight_idx, std::move(rows));
+}
 
- /// @todo
-  // Current nntrainer gradient Tensor shape is identical to its
-  // weight shape. However, this creates a sparse Tensor since we are only using
-  // certain indices of the Tensor that we are interested in. Since we have such
-  // indices before accessing to the Tensor, we can optimize it by deleting the
-  // sparse-value indices. Also left as an Issue as well.
+void EmbeddingLayer::calcGradient(RunLayerContext &context) {
+  unsigned int out_dim = std::get<props::OutDim>(embedding_props);
+
+  Tensor &djdw = context.getWeightGrad(weight_idx);
+  const Tensor &derivative_ = context.getIncomingDerivative(SINGLE_INOUT_IDX);
+  Tensor &input_ = context.getInput(SINGLE_INOUT_IDX);
+
+  /** only the looked up rows have a gradient, so update those rows if the
+   * optimizer supports it instead of clearing and applying the whole table */
+  if (djdw.getDataType() == TensorDim::DataType::FP32 &&
+      context.isSparseGradientAllowed(weight_idx)) {
+    calcSparseGradient(context);
+    return;
+  }
+
+  djdw.setZero();
 
   for (unsigned int b = 0; b < input_.batch(); ++b) {
     float *in_data =
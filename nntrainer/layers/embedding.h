@@ -106,6 +106,14 @@ public:
 private:
   std::tuple<props::InDim, props::OutDim> embedding_props;
   unsigned int weight_idx;
+
+  /**
+   * @brief calculate the gradient of the rows looked up by the input only and
+   * store it as a row sparse gradient
+   *
+   * @param context Context of the layer
+   */
+  void calcSparseGradient(RunLayerContext &context);
 };
 } // namespace nntrainer
 
@@ -97,6 +97,11 @@ public:
    */
   bool supportBackwarding() const override { return true; }
 
+  /**
+   * @copydoc Layer::supportRecompute()
+   */
+  bool supportRecompute() const override { return true; }
+
   /**
    * @copydoc Layer::setProperty(const PropertyType type, const std::string
    * &value)
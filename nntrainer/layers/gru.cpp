@@ -32,6 +32,7 @@
 #include <nntrainer_error.h>
 #include <nntrainer_log.h>
 #include <node_exporter.h>
+#include <recurrent_kernel.h>
 #include <util_func.h>
 
 namespace nntrainer {
@@ -233,98 +234,162 @@ void GRULayer::forwarding(RunLayerContext &context, bool training) {
   // gt = tanh((h_prev*rt).W_hr + W_xg.xs)
   // h_nx = (1-zt)*gt + zt*h_prev
 
-  for (unsigned int b = 0; b < batch_size; ++b) {
-    Tensor islice = input.getBatchSlice(b, 1);
-    Tensor oslice = hidden_state.getBatchSlice(b, 1);
-    Tensor zrg_ = zrg.getBatchSlice(b, 1);
-
-    for (unsigned int t = 0; t < max_timestep; ++t) {
-      Tensor xs = islice.getSharedDataTensor({feature_size}, t * feature_size);
-
-      /** @todo verify this dropout working */
-      // if (dropout_rate > 0.0 && training) {
-      //   xs.multiply_i(xs.dropout_mask(dropout_rate));
-      // }
-      hs = oslice.getSharedDataTensor({unit}, t * unit);
-      Tensor zrg_t =
-        zrg_.getSharedDataTensor({unit * NUM_GATE}, unit * t * NUM_GATE);
-
-      if (t > 0) {
-        prev_hs = oslice.getSharedDataTensor({unit}, (t - 1) * unit);
+  RecurrentActivation act, recurrent_act;
+  if (input.getDataType() == TensorDim::DataType::FP32 &&
+      acti_func.getElementwiseFn(act.fn, act.prime) &&
+      recurrent_acti_func.getElementwiseFn(recurrent_act.fn,
+                                           recurrent_act.prime)) {
+    const unsigned int gate_size = NUM_GATE * unit;
+    const unsigned int ld_gate = max_timestep * gate_size;
+    const unsigned int ld_state = max_timestep * unit;
+
+    /** biases which are not scaled by the reset gate are added upfront */
+    std::vector<float> bias;
+    const float *bias_hh_g = nullptr;
+    if (!disable_bias) {
+      if (integrate_bias) {
+        bias.assign(bias_h.getData<float>(),
+                    bias_h.getData<float>() + gate_size);
       } else {
-        prev_hs = h_prev.getBatchSlice(b, 1);
+        bias.assign(bias_ih.getData<float>(),
+                    bias_ih.getData<float>() + gate_size);
+        const float *bias_hh_data = bias_hh.getData<float>();
+        const unsigned int upfront = reset_after ? 2 * unit : gate_size;
+        for (unsigned int i = 0; i < upfront; ++i)
+          bias[i] += bias_hh_data[i];
+        if (reset_after)
+          bias_hh_g = bias_hh_data + 2 * unit;
       }
+    }
 
-      xs.dot(weight_ih, zrg_t); // x_z, x_r, x_g
-
-      Tensor ztrt = zrg_t.getSharedDataTensor({unit * 2}, 0);
-
-      Tensor w_hh;
-      w_hh.copy_with_stride(
-        weight_hh.getSharedDataTensor({1, 1, unit, unit * 2}, 0, false));
-      Tensor w_g;
-      w_g.copy_with_stride(
-        weight_hh.getSharedDataTensor({1, 1, unit, unit}, unit * 2, false));
-
-      Tensor gt = zrg_t.getSharedDataTensor({unit}, unit * 2);
+    float *zrg_data = zrg.getData<float>();
+    recurrent_projection(batch_size * max_timestep, feature_size, gate_size,
+                         input.getData<float>(), weight_ih.getData<float>(),
+                         disable_bias ? nullptr : bias.data(), zrg_data);
+
+    const bool enable_dropout = dropout_rate > epsilon && training;
+    const float *mask_data = nullptr;
+    unsigned int mask_height = 0;
+    if (enable_dropout) {
+      Tensor &mask = context.getTensor(wt_idx[GRUParams::dropout_mask]);
+      mask.dropout_mask(dropout_rate);
+      mask_data = mask.getData<float>();
+      mask_height = mask.height();
+    }
 
-      ztrt.add_i(prev_hs.dot(w_hh));
-      if (!disable_bias) {
-        if (integrate_bias) {
-          Tensor ztrt_bias_h = bias_h.getSharedDataTensor({unit * 2}, 0);
-          ztrt.add_i(ztrt_bias_h);
-        } else {
-          Tensor ztrt_bias_ih = bias_ih.getSharedDataTensor({unit * 2}, 0);
-          ztrt.add_i(ztrt_bias_ih);
-          Tensor ztrt_bias_hh = bias_hh.getSharedDataTensor({unit * 2}, 0);
-          ztrt.add_i(ztrt_bias_hh);
+    std::vector<float> workspace(batch_size * unit);
+    float *hs_data = hidden_state.getData<float>();
+    for (unsigned int t = 0; t < max_timestep; ++t) {
+      float *h = hs_data + t * unit;
+      gru_step_forward(batch_size, unit, zrg_data + t * gate_size, ld_gate,
+                       t ? h - unit : nullptr, h, ld_state,
+                       weight_hh.getData<float>(), bias_hh_g, reset_after, act,
+                       recurrent_act, workspace.data());
+
+      if (enable_dropout) {
+        const unsigned int mask_t = mask_height == max_timestep ? t : 0;
+        for (unsigned int b = 0; b < batch_size; ++b) {
+          const float *m = mask_data + (b * mask_height + mask_t) * unit;
+          for (unsigned int u = 0; u < unit; ++u)
+            h[b * ld_state + u] *= m[u];
         }
       }
+    }
+  } else {
+    for (unsigned int b = 0; b < batch_size; ++b) {
+      Tensor islice = input.getBatchSlice(b, 1);
+      Tensor oslice = hidden_state.getBatchSlice(b, 1);
+      Tensor zrg_ = zrg.getBatchSlice(b, 1);
+
+      for (unsigned int t = 0; t < max_timestep; ++t) {
+        Tensor xs =
+          islice.getSharedDataTensor({feature_size}, t * feature_size);
+
+        /** @todo verify this dropout working */
+        // if (dropout_rate > 0.0 && training) {
+        //   xs.multiply_i(xs.dropout_mask(dropout_rate));
+        // }
+        hs = oslice.getSharedDataTensor({unit}, t * unit);
+        Tensor zrg_t =
+          zrg_.getSharedDataTensor({unit * NUM_GATE}, unit * t * NUM_GATE);
+
+        if (t > 0) {
+          prev_hs = oslice.getSharedDataTensor({unit}, (t - 1) * unit);
+        } else {
+          prev_hs = h_prev.getBatchSlice(b, 1);
+        }
 
-      recurrent_acti_func.run_fn(ztrt, ztrt);
+        xs.dot(weight_ih, zrg_t); // x_z, x_r, x_g
+
+        Tensor ztrt = zrg_t.getSharedDataTensor({unit * 2}, 0);
+
+        Tensor w_hh;
+        w_hh.copy_with_stride(
+          weight_hh.getSharedDataTensor({1, 1, unit, unit * 2}, 0, false));
+        Tensor w_g;
+        w_g.copy_with_stride(
+          weight_hh.getSharedDataTensor({1, 1, unit, unit}, unit * 2, false));
+
+        Tensor gt = zrg_t.getSharedDataTensor({unit}, unit * 2);
+
+        ztrt.add_i(prev_hs.dot(w_hh));
+        if (!disable_bias) {
+          if (integrate_bias) {
+            Tensor ztrt_bias_h = bias_h.getSharedDataTensor({unit * 2}, 0);
+            ztrt.add_i(ztrt_bias_h);
+          } else {
+            Tensor ztrt_bias_ih = bias_ih.getSharedDataTensor({unit * 2}, 0);
+            ztrt.add_i(ztrt_bias_ih);
+            Tensor ztrt_bias_hh = bias_hh.getSharedDataTensor({unit * 2}, 0);
+            ztrt.add_i(ztrt_bias_hh);
+          }
+        }
 
-      Tensor zt = ztrt.getSharedDataTensor({unit}, 0);
-      Tensor rt = ztrt.getSharedDataTensor({unit}, unit);
+        recurrent_acti_func.run_fn(ztrt, ztrt);
 
-      Tensor temp;
-      if (reset_after) {
-        prev_hs.dot(w_g, temp);
-        if (!disable_bias && !integrate_bias) {
-          Tensor bias_hh_g = bias_hh.getSharedDataTensor({unit}, 2 * unit);
-          temp.add_i(bias_hh_g);
-        }
-        temp.multiply_i(rt);
-        gt.add_i(temp);
-      } else {
-        rt.multiply(prev_hs, temp);
-        temp.dot(w_g, gt, false, false, 1.0f);
-        if (!disable_bias && !integrate_bias) {
-          Tensor bias_hh_g = bias_hh.getSharedDataTensor({unit}, 2 * unit);
-          gt.add_i(bias_hh_g);
-        }
-      }
-      if (!disable_bias) {
-        if (integrate_bias) {
-          Tensor gt_bias_h = bias_h.getSharedDataTensor({unit}, unit * 2);
-          gt.add_i(gt_bias_h);
+        Tensor zt = ztrt.getSharedDataTensor({unit}, 0);
+        Tensor rt = ztrt.getSharedDataTensor({unit}, unit);
+
+        Tensor temp;
+        if (reset_after) {
+          prev_hs.dot(w_g, temp);
+          if (!disable_bias && !integrate_bias) {
+            Tensor bias_hh_g = bias_hh.getSharedDataTensor({unit}, 2 * unit);
+            temp.add_i(bias_hh_g);
+          }
+          temp.multiply_i(rt);
+          gt.add_i(temp);
         } else {
-          Tensor gt_bias_ih = bias_ih.getSharedDataTensor({unit}, unit * 2);
-          gt.add_i(gt_bias_ih);
+          rt.multiply(prev_hs, temp);
+          temp.dot(w_g, gt, false, false, 1.0f);
+          if (!disable_bias && !integrate_bias) {
+            Tensor bias_hh_g = bias_hh.getSharedDataTensor({unit}, 2 * unit);
+            gt.add_i(bias_hh_g);
+          }
+        }
+        if (!disable_bias) {
+          if (integrate_bias) {
+            Tensor gt_bias_h = bias_h.getSharedDataTensor({unit}, unit * 2);
+            gt.add_i(gt_bias_h);
+          } else {
+            Tensor gt_bias_ih = bias_ih.getSharedDataTensor({unit}, unit * 2);
+            gt.add_i(gt_bias_ih);
+          }
         }
-      }
 
-      acti_func.run_fn(gt, gt);
+        acti_func.run_fn(gt, gt);
 
-      zt.multiply(prev_hs, hs);
-      temp = zt.multiply(-1.0).add(1.0);
-      hs.add_i(gt.multiply(temp));
+        zt.multiply(prev_hs, hs);
+        temp = zt.multiply(-1.0).add(1.0);
+        hs.add_i(gt.multiply(temp));
 
-      if (dropout_rate > epsilon && training) {
-        Tensor mask_ = context.getTensor(wt_idx[GRUParams::dropout_mask])
-                         .getBatchSlice(b, 1);
-        Tensor msk = mask_.getSharedDataTensor({unit}, t * unit);
-        msk.dropout_mask(dropout_rate);
-        hs.multiply_i(msk);
+        if (dropout_rate > epsilon && training) {
+          Tensor mask_ = context.getTensor(wt_idx[GRUParams::dropout_mask])
+                           .getBatchSlice(b, 1);
+          Tensor msk = mask_.getSharedDataTensor({unit}, t * unit);
+          msk.dropout_mask(dropout_rate);
+          hs.multiply_i(msk);
+        }
       }
     }
   }
@@ -425,6 +490,61 @@ void GRULayer::calcGradient(RunLayerContext &context) {
       context.getTensor(wt_idx[GRUParams::dropout_mask]));
   }
 
+  RecurrentActivation act, recurrent_act;
+  if (input.getDataType() == TensorDim::DataType::FP32 &&
+      acti_func.getElementwiseFn(act.fn, act.prime) &&
+      recurrent_acti_func.getElementwiseFn(recurrent_act.fn,
+                                           recurrent_act.prime)) {
+    const unsigned int gate_size = NUM_GATE * unit;
+    const unsigned int ld_gate = max_timestep * gate_size;
+    const unsigned int ld_state = max_timestep * unit;
+
+    const float *bias_hh_g = nullptr;
+    float *d_bias_hh_g = nullptr;
+    if (!disable_bias && !integrate_bias) {
+      if (reset_after)
+        bias_hh_g = bias_hh.getData<float>() + 2 * unit;
+      d_bias_hh_g = djdbias_hh.getData<float>() + 2 * unit;
+    }
+
+    djdweight_hh.setZero();
+
+    const float *zrg_data = zrg.getData<float>();
+    float *d_zrg_data = d_zrg.getData<float>();
+    const float *hs_data = hidden_state.getData<float>();
+    float *d_hs_data = hidden_state_derivative.getData<float>();
+
+    std::vector<float> workspace(2 * batch_size * unit);
+    for (unsigned int t = max_timestep; t-- > 0;) {
+      const float *h_prev = t ? hs_data + (t - 1) * unit : nullptr;
+      float *dh = d_hs_data + t * unit;
+      gru_step_backward(batch_size, unit, zrg_data + t * gate_size,
+                        d_zrg_data + t * gate_size, ld_gate, h_prev, dh,
+                        t ? dh - unit : nullptr, ld_state,
+                        weight_hh.getData<float>(), bias_hh_g, reset_after,
+                        djdweight_hh.getData<float>(), d_bias_hh_g, act,
+                        recurrent_act, workspace.data());
+    }
+
+    /** gradients of the input projection over every timestep at once */
+    const unsigned int rows = batch_size * max_timestep;
+    recurrent_projection_gradient(rows, feature_size, gate_size,
+                                  input.getData<float>(), d_zrg_data,
+                                  djdweight_ih.getData<float>());
+    if (!disable_bias) {
+      if (integrate_bias) {
+        recurrent_column_sum(rows, gate_size, d_zrg_data, gate_size,
+                             djdbias_h.getData<float>());
+      } else {
+        recurrent_column_sum(rows, gate_size, d_zrg_data, gate_size,
+                             djdbias_ih.getData<float>());
+        recurrent_column_sum(rows, 2 * unit, d_zrg_data, gate_size,
+                             djdbias_hh.getData<float>());
+      }
+    }
+    return;
+  }
+
   Tensor dh_nx = Tensor({unit});
 
   for (unsigned int b = 0; b < batch_size; ++b) {
@@ -68,6 +68,11 @@ public:
    */
   bool supportBackwarding() const override { return true; };
 
+  /**
+   * @copydoc Layer::supportRecompute()
+   */
+  bool supportRecompute() const override { return true; }
+
   /**
    * @copydoc Layer::supportInPlace()
    */
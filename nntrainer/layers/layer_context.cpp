@@ -402,6 +402,15 @@ bool RunLayerContext::isGradientClipByGlobalNorm(unsigned int idx) const {
   return weights[idx]->isGradientClipByGlobalNorm();
 }
 
+bool RunLayerContext::isSparseGradientAllowed(unsigned int idx) const {
+  return weights[idx]->isSparseGradientAllowed();
+}
+
+void RunLayerContext::setWeightGradientRows(unsigned int idx,
+                                            std::vector<unsigned int> &&rows) {
+  weights[idx]->setGradientRows(std::move(rows));
+}
+
 /**
  * @brief Get the tensor name
  *
@@ -659,6 +659,24 @@ public:
    */
   bool isGradientClipByGlobalNorm(unsigned int idx) const;
 
+  /**
+   * @brief check if the gradient may be set as row sparse
+   *
+   * @param idx index
+   * @return bool true if setWeightGradientRows() can be used
+   */
+  bool isSparseGradientAllowed(unsigned int idx) const;
+
+  /**
+   * @brief mark the gradient as row sparse, the k-th row of the gradient
+   * holds the gradient of the rows[k]-th row of the weight
+   *
+   * @param idx index
+   * @param rows sorted and unique row indices of the weight
+   */
+  void setWeightGradientRows(unsigned int idx,
+                             std::vector<unsigned int> &&rows);
+
   /**
    * @brief Get the tensor name
    *
@@ -864,6 +882,27 @@ public:
   }
 #endif
 
+  /**
+   * @brief Set the position of every batch for the incremental forwarding.
+   * When independent sequences are batched, every batch is at its own
+   * position and the layers keeping a cache use it instead of from.
+   *
+   * @param positions position of every batch, empty if all the batches are at
+   * the position given to the incremental forwarding
+   */
+  void setIncrementalPositions(const std::vector<unsigned int> &positions) {
+    incremental_positions = positions;
+  }
+
+  /**
+   * @brief Get the position of every batch for the incremental forwarding
+   *
+   * @return const std::vector<unsigned int>& positions, empty if not set
+   */
+  const std::vector<unsigned int> &getIncrementalPositions() const {
+    return incremental_positions;
+  }
+
   /**
    * @brief set the compute engine for this node
    * @param compute engine: (CPU/GPU)
@@ -889,6 +928,10 @@ private:
   std::vector<Var_Grad *> outputs; /**< outputs of the layer */
   std::vector<Var_Grad *> tensors; /**< tensors of the layer */
 
+  std::vector<unsigned int>
+    incremental_positions; /**< position of every batch of the incremental
+                              step, empty if not set */
+
   ml::train::LayerComputeEngine compute_engine =
     ml::train::LayerComputeEngine::CPU;
 
@@ -243,6 +243,29 @@ public:
    */
   virtual bool supportInPlace() const { return false; }
 
+  /**
+   * @brief   If the current layer can be recomputed before the backwarding
+   *
+   * @return  true if the forwarding can be run again, else false
+   * @details a recomputed layer runs its forwarding once more right before
+   * its backwarding instead of keeping its outputs alive in between. The
+   * forwarding must only depend on the inputs and the weights and must write
+   * nothing but the outputs and the tensors requested by the layer.
+   * @note all layers default to not being recomputed
+   */
+  virtual bool supportRecompute() const { return false; }
+
+  /**
+   * @brief   If the training forwarding of the current layer is random
+   *
+   * @return  true if the same inputs may give other outputs at every training
+   * forwarding, else false
+   * @details the outputs of a random layer, such as a dropout or a data
+   * augmentation, can not be cached and replayed across the epochs
+   * @note all layers default to being deterministic
+   */
+  virtual bool isRandomInTraining() const { return false; }
+
   /**
    * @brief  check if this layer requires label to be passed
    * @note   if requireLabel() == true means, for now, that it is endpoint of a
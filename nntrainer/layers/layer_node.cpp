@@ -193,7 +193,8 @@ LayerNode::LayerNode(std::unique_ptr<nntrainer::Layer> &&l) :
   layer_node_props(
     new PropsType(props::Name(), props::Distribute(), props::Trainable(), {},
                   {}, props::SharedFrom(), props::ClipGradByGlobalNorm(),
-                  props::Packed(), props::LossScaleForMixed())),
+                  props::Packed(), props::LossScaleForMixed(),
+                  props::Checkpoint())),
   layer_node_props_realization(
     new RealizationPropsType(props::Flatten(), props::Activation())),
   loss(new props::Loss()),
@@ -370,6 +371,20 @@ ActivationType LayerNode::getActivationToBeRealized() const {
 
 const std::string LayerNode::getType() const { return getLayer()->getType(); }
 
+bool LayerNode::supportRecompute() const {
+  if (getDistribute())
+    return false;
+  return layer->supportRecompute();
+}
+
+bool LayerNode::isRandomInTraining() const {
+  return layer->isRandomInTraining();
+}
+
+bool LayerNode::isCheckpoint() const {
+  return std::get<props::Checkpoint>(*layer_node_props);
+}
+
 bool LayerNode::getTrainable() const {
   if (run_context)
     /**
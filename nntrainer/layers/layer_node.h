@@ -336,6 +336,27 @@ public:
    */
   bool supportInPlace() const;
 
+  /**
+   * @brief   If the forwarding of the current layer can be run again before
+   * its backwarding to restore the outputs
+   * @return  true if the layer can be recomputed, else false
+   */
+  bool supportRecompute() const;
+
+  /**
+   * @brief   If the training forwarding of the current layer is random
+   * @return  true if the outputs may differ at every training forwarding,
+   * else false
+   */
+  bool isRandomInTraining() const;
+
+  /**
+   * @brief   Check if the output of this layer is kept for the backwarding
+   * when the layers around it are recomputed
+   * @return  true if the layer is a checkpoint, else false
+   */
+  bool isCheckpoint() const;
+
   /**
    * @brief   Notify that this layer will execute in-place
    *
@@ -951,7 +972,8 @@ properties in the context/graph unless intended. */
                                std::vector<props::InputConnection>,
                                std::vector<props::InputShape>,
                                props::SharedFrom, props::ClipGradByGlobalNorm,
-                               props::Packed, props::LossScaleForMixed>;
+                               props::Packed, props::LossScaleForMixed,
+                               props::Checkpoint>;
 
   using RealizationPropsType = std::tuple<props::Flatten, props::Activation>;
   /** these realization properties results in addition of new layers, hence
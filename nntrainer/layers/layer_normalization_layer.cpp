@@ -20,6 +20,7 @@
 #include <nntrainer_error.h>
 #include <nntrainer_log.h>
 #include <node_exporter.h>
+#include <normalization_kernel.h>
 #include <util_func.h>
 
 namespace nntrainer {
@@ -34,10 +35,60 @@ enum LNParams {
   inv_std_dev,
   temp_origin_size,
   temp_normalized_size,
+  normalized,
 };
 
+/**
+ * @brief check if the given axes are the innermost axes in the memory order of
+ * the tensor format. Axes of size 1 are skipped except the batch axis, whose
+ * size can change after finalize.
+ */
+static bool isInnermostAxes(const TensorDim &dim,
+                            const std::vector<unsigned int> &axes) {
+  static constexpr unsigned int nchw[] = {0, 1, 2, 3};
+  static constexpr unsigned int nhwc[] = {0, 2, 3, 1};
+  const unsigned int *order =
+    dim.getFormat() == ml::train::TensorDim::Format::NHWC ? nhwc : nchw;
+
+  bool normalizing = false;
+  for (unsigned int i = 0; i < ml::train::TensorDim::MAXDIM; ++i) {
+    unsigned int axis = order[i];
+    if (axis != 0 && dim.getTensorDim(axis) == 1)
+      continue;
+    bool is_normalize_axis =
+      std::find(axes.begin(), axes.end(), axis) != axes.end();
+    if (normalizing && !is_normalize_axis)
+      return false;
+    normalizing = is_normalize_axis;
+  }
+  return true;
+}
+
+/**
+ * @brief normalize every row of the [rows, cols] view of the input, where cols
+ * is the size of gamma. normalized is nullptr if not needed
+ */
+static void rowNormalize(const Tensor &input, Tensor *normalized,
+                         Tensor &output, const Tensor &gamma,
+                         const Tensor &beta, Tensor &inv_std_dev,
+                         float epsilon) {
+  unsigned int cols = gamma.size();
+  unsigned int rows = input.size() / cols;
+
+  normalization_dispatch(
+    input.getDataType(), gamma.getDataType(), [&](auto t, auto p) {
+      using T = decltype(t);
+      using P = decltype(p);
+      layer_norm_forward<T, P>(
+        input.getData<T>(), normalized ? normalized->getData<T>() : nullptr,
+        output.getData<T>(), rows, cols, gamma.getData<P>(), beta.getData<P>(),
+        inv_std_dev.getData<P>(), epsilon);
+    });
+}
+
 LayerNormalizationLayer::LayerNormalizationLayer() :
   Layer(),
+  row_normalize(false),
   layer_normalization_props(
     std::vector<props::Axis>(), props::Epsilon(), props::BNPARAMS_GAMMA_INIT(),
     props::BNPARAMS_BETA_INIT(), props::WeightDecay(), props::BiasDecay()) {
@@ -96,6 +147,24 @@ void LayerNormalizationLayer::finalize(InitLayerContext &context) {
     remain_dim.setTensorDim(axis, input_dim.getTensorDim(axis));
   }
 
+  row_normalize = isInnermostAxes(input_dim, normalize_axes);
+
+  if (row_normalize) {
+    /**
+     * caches the normalized input. Statistics and derivatives are computed
+     * row by row by fused kernels, so no other full sized tensor is needed.
+     */
+    wt_idx[LNParams::normalized] =
+      context.requestTensor(input_dim, "normalized", Tensor::Initializer::NONE,
+                            false, TensorLifespan::ITERATION_LIFESPAN);
+    /** caches the inverse standard deviation */
+    wt_idx[LNParams::inv_std_dev] = context.requestTensor(
+      remain_dim, "inv_std_dev", Tensor::Initializer::NONE, false,
+      TensorLifespan::ITERATION_LIFESPAN);
+    return;
+  }
+
+  /** the other axes are normalized with the tensor operations */
   /** caches the deviation -> input - avg(input) */
   wt_idx[LNParams::deviation] =
     context.requestTensor(input_dim, "deviation", Tensor::Initializer::NONE,
@@ -138,9 +207,17 @@ void LayerNormalizationLayer::forwarding(RunLayerContext &context,
   Tensor &gamma = context.getWeight(wt_idx[LNParams::gamma]);
   Tensor &beta = context.getWeight(wt_idx[LNParams::beta]);
 
+  Tensor &inv_std_dev = context.getTensor(wt_idx[LNParams::inv_std_dev]);
+
+  if (row_normalize) {
+    Tensor &normalized = context.getTensor(wt_idx[LNParams::normalized]);
+    rowNormalize(input, training ? &normalized : nullptr, output, gamma, beta,
+                 inv_std_dev, epsilon);
+    return;
+  }
+
   Tensor &deviation = context.getTensor(wt_idx[LNParams::deviation]);
   Tensor &variance = context.getTensor(wt_idx[LNParams::variance]);
-  Tensor &inv_std_dev = context.getTensor(wt_idx[LNParams::inv_std_dev]);
 
   Tensor &temp_full_size = output;
   Tensor &temp_norm_size = inv_std_dev;
@@ -172,9 +249,15 @@ void LayerNormalizationLayer::incremental_forwarding(RunLayerContext &context,
   Tensor &gamma = context.getWeight(wt_idx[LNParams::gamma]);
   Tensor &beta = context.getWeight(wt_idx[LNParams::beta]);
 
+  Tensor &inv_std_dev = context.getTensor(wt_idx[LNParams::inv_std_dev]);
+
+  if (row_normalize) {
+    rowNormalize(input, nullptr, output, gamma, beta, inv_std_dev, epsilon);
+    return;
+  }
+
   Tensor &deviation = context.getTensor(wt_idx[LNParams::deviation]);
   Tensor &variance = context.getTensor(wt_idx[LNParams::variance]);
-  Tensor &inv_std_dev = context.getTensor(wt_idx[LNParams::inv_std_dev]);
 
   // @todo: consider NHWC format
   bool is_height_normalize =
@@ -220,7 +303,7 @@ void LayerNormalizationLayer::incremental_forwarding(RunLayerContext &context,
     for (unsigned int j = 0; j < axis_dim; ++j) {
       sum += powf(static_cast<float>(data[j]), 2.0f);
     }
-    inv_std_dev.setValue(0, 0, i, 0, 1.0 / sqrt(sum / axis_dim - epsilon));
+    inv_std_dev.setValue(0, 0, i, 0, 1.0 / sqrt(sum / axis_dim + epsilon));
   }
 #endif
 
@@ -246,6 +329,26 @@ void LayerNormalizationLayer::calcDerivative(RunLayerContext &context) {
   Tensor &d_gamma =
     trainable ? context.getWeightGrad(wt_idx[LNParams::gamma]) : empty;
 
+  if (row_normalize) {
+    const Tensor &normalized = context.getTensor(wt_idx[LNParams::normalized]);
+    const Tensor &inv_std_dev =
+      context.getTensor(wt_idx[LNParams::inv_std_dev]);
+    unsigned int cols = gamma.size();
+    unsigned int rows = incoming_derivative.size() / cols;
+
+    normalization_dispatch(
+      incoming_derivative.getDataType(), gamma.getDataType(),
+      [&](auto t, auto p) {
+        using T = decltype(t);
+        using P = decltype(p);
+        layer_norm_backward<T, P>(
+          incoming_derivative.getData<T>(), normalized.getData<T>(),
+          outgoing_derivative.getData<T>(), rows, cols, gamma.getData<P>(),
+          inv_std_dev.getData<P>(), trainable ? d_gamma.getData<P>() : nullptr);
+      });
+    return;
+  }
+
   Tensor &deviation = context.getTensor(wt_idx[LNParams::deviation]);
   Tensor &variance = context.getTensor(wt_idx[LNParams::variance]);
   Tensor &inv_std_dev = context.getTensor(wt_idx[LNParams::inv_std_dev]);
@@ -279,6 +382,21 @@ void LayerNormalizationLayer::calcGradient(RunLayerContext &context) {
     context.getIncomingDerivative(SINGLE_INOUT_IDX);
   Tensor &d_beta = context.getWeightGrad(wt_idx[LNParams::beta]);
 
+  if (row_normalize) {
+    unsigned int cols = d_beta.size();
+    unsigned int rows = incoming_derivative.size() / cols;
+
+    normalization_dispatch(
+      incoming_derivative.getDataType(), d_beta.getDataType(),
+      [&](auto t, auto p) {
+        using T = decltype(t);
+        using P = decltype(p);
+        layer_norm_column_sum<T, P>(incoming_derivative.getData<T>(), rows,
+                                    cols, d_beta.getData<P>());
+      });
+    return;
+  }
+
   incoming_derivative.sum(remain_axes, d_beta);
 }
 
@@ -289,9 +407,14 @@ void LayerNormalizationLayer::exportTo(
 
 void LayerNormalizationLayer::setBatch(RunLayerContext &context,
                                        unsigned int batch) {
+  context.updateTensor(wt_idx[LNParams::inv_std_dev], batch);
+  if (row_normalize) {
+    context.updateTensor(wt_idx[LNParams::normalized], batch);
+    return;
+  }
+
   context.updateTensor(wt_idx[LNParams::deviation], batch);
   context.updateTensor(wt_idx[LNParams::variance], batch);
-  context.updateTensor(wt_idx[LNParams::inv_std_dev], batch);
   context.updateTensor(wt_idx[LNParams::temp_origin_size], batch);
   context.updateTensor(wt_idx[LNParams::temp_normalized_size], batch);
 }
@@ -99,6 +99,11 @@ public:
    */
   bool supportBackwarding() const override { return true; }
 
+  /**
+   * @copydoc Layer::supportRecompute()
+   */
+  bool supportRecompute() const override { return true; }
+
   using Layer::setProperty;
 
   /**
@@ -122,8 +127,10 @@ private:
   std::vector<unsigned int> normalize_axes; /**< normalize axes */
   std::vector<unsigned int>
     remain_axes; /**< remained axes (exclusive with normalize axes) */
+  bool row_normalize; /**< true if the normalize axes are the innermost axes
+                         in memory so the input is normalized row by row */
 
-  std::array<unsigned int, 7> wt_idx;
+  std::array<unsigned int, 8> wt_idx;
   std::tuple<std::vector<props::Axis>, props::Epsilon,
              props::BNPARAMS_GAMMA_INIT, props::BNPARAMS_BETA_INIT,
              props::WeightDecay, props::BiasDecay>
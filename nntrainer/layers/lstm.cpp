@@ -55,6 +55,65 @@ void LSTMLayer::forwardingBatchFirstLSTM(
   hidden_state_.setZero();
   cell_state_.setZero();
 
+  RecurrentActivation act, recurrent_act;
+  if (useBatchedKernel(input_, weight_ih, max_timestep, acti_func,
+                       recurrent_acti_func, act, recurrent_act)) {
+    const unsigned int gate_size = NUM_GATE * unit;
+    const unsigned int ld_gate = max_timestep * gate_size;
+    const unsigned int ld_state = max_timestep * unit;
+
+    std::vector<float> bias;
+    if (!disable_bias) {
+      if (integrate_bias) {
+        bias.assign(bias_h.getData<float>(),
+                    bias_h.getData<float>() + gate_size);
+      } else {
+        bias.assign(bias_ih.getData<float>(),
+                    bias_ih.getData<float>() + gate_size);
+        const float *bias_hh_data = bias_hh.getData<float>();
+        for (unsigned int i = 0; i < gate_size; ++i)
+          bias[i] += bias_hh_data[i];
+      }
+    }
+
+    /** input projection of every timestep as a single gemm */
+    float *ifgo = ifgo_.getData<float>();
+    recurrent_projection(batch_size * max_timestep, feature_size, gate_size,
+                         input_.getData<float>(), weight_ih.getData<float>(),
+                         disable_bias ? nullptr : bias.data(), ifgo);
+
+    Tensor mask;
+    if (enable_dropout) {
+      mask = mask_.getBatchSlice(0, batch_size);
+      /** both directions share the mask which is also used by the backward */
+      if (!reverse)
+        mask.dropout_mask(dropout_rate);
+    }
+
+    float *hs = hidden_state_.getData<float>();
+    float *cs = cell_state_.getData<float>();
+    for (unsigned int s = 0; s < max_timestep; ++s) {
+      const unsigned int t = reverse ? max_timestep - 1 - s : s;
+      const unsigned int prev = reverse ? t + 1 : t - 1;
+
+      lstm_step_forward(batch_size, unit, ifgo + t * gate_size, ld_gate,
+                        s ? hs + prev * unit : nullptr,
+                        s ? cs + prev * unit : nullptr, hs + t * unit,
+                        cs + t * unit, ld_state, weight_hh.getData<float>(),
+                        act, recurrent_act);
+
+      if (enable_dropout) {
+        const float *mask_data = mask.getData<float>();
+        for (unsigned int b = 0; b < batch_size; ++b) {
+          const size_t offset = b * ld_state + t * unit;
+          for (unsigned int u = 0; u < unit; ++u)
+            hs[offset + u] *= mask_data[offset + u];
+        }
+      }
+    }
+    return;
+  }
+
   TensorDim::TensorType tensor_type = weight_ih.getTensorType();
   TensorDim input_tensor_dim({feature_size}, tensor_type);
   TensorDim unit_tensor_dim({unit}, tensor_type);
@@ -184,6 +243,52 @@ void LSTMLayer::calcGradientBatchFirstLSTM(
     d_hidden_state_.multiply_i(mask_);
   }
 
+  RecurrentActivation act, recurrent_act;
+  if (useBatchedKernel(input_, d_weight_ih, max_timestep, acti_func,
+                       recurrent_acti_func, act, recurrent_act)) {
+    const unsigned int gate_size = NUM_GATE * unit;
+    const unsigned int ld_gate = max_timestep * gate_size;
+    const unsigned int ld_state = max_timestep * unit;
+
+    const float *ifgo = ifgo_.getData<float>();
+    float *d_ifgo = d_ifgo_.getData<float>();
+    const float *hs = hidden_state_.getData<float>();
+    float *d_hs = d_hidden_state_.getData<float>();
+    const float *cs = cell_state_.getData<float>();
+    float *d_cs = d_cell_state_.getData<float>();
+
+    for (unsigned int s = max_timestep; s-- > 0;) {
+      const unsigned int t = reverse ? max_timestep - 1 - s : s;
+      const unsigned int prev = reverse ? t + 1 : t - 1;
+
+      lstm_step_backward(
+        batch_size, unit, ifgo + t * gate_size, d_ifgo + t * gate_size, ld_gate,
+        s ? hs + prev * unit : nullptr, s ? d_hs + prev * unit : nullptr,
+        s ? cs + prev * unit : nullptr, cs + t * unit, d_hs + t * unit,
+        d_cs + t * unit, s ? d_cs + prev * unit : nullptr, ld_state,
+        weight_hh.getData<float>(), d_weight_hh.getData<float>(), act,
+        recurrent_act);
+    }
+
+    /** gradients of the input projection over every timestep at once */
+    const unsigned int rows = batch_size * max_timestep;
+    recurrent_projection_gradient(rows, feature_size, gate_size,
+                                  input_.getData<float>(), d_ifgo,
+                                  d_weight_ih.getData<float>());
+    if (!disable_bias) {
+      if (integrate_bias) {
+        recurrent_column_sum(rows, gate_size, d_ifgo, gate_size,
+                             d_bias_h.getData<float>());
+      } else {
+        recurrent_column_sum(rows, gate_size, d_ifgo, gate_size,
+                             d_bias_ih.getData<float>());
+        recurrent_column_sum(rows, gate_size, d_ifgo, gate_size,
+                             d_bias_hh.getData<float>());
+      }
+    }
+    return;
+  }
+
   auto workers = ParallelBatch(batch_size);
 
   if (workers.getNumWorkers() > 1) {
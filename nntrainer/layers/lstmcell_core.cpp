@@ -26,6 +26,20 @@ LSTMCore::LSTMCore() :
   recurrent_acti_func(ActivationType::ACT_NONE, true),
   epsilon(1e-3) {}
 
+bool LSTMCore::useBatchedKernel(const Tensor &input, const Tensor &weight,
+                                const unsigned int max_timestep,
+                                const ActiFunc &acti_func,
+                                const ActiFunc &recurrent_acti_func,
+                                RecurrentActivation &act,
+                                RecurrentActivation &recurrent_act) {
+  return input.getDataType() == TensorDim::DataType::FP32 &&
+         weight.getDataType() == TensorDim::DataType::FP32 &&
+         input.height() == max_timestep &&
+         acti_func.getElementwiseFn(act.fn, act.prime) &&
+         recurrent_acti_func.getElementwiseFn(recurrent_act.fn,
+                                              recurrent_act.prime);
+}
+
 void LSTMCore::forwardLSTM(const unsigned int batch_size,
                            const unsigned int unit, const bool disable_bias,
                            const bool integrate_bias, ActiFunc &acti_func,
@@ -47,6 +61,16 @@ void LSTMCore::forwardLSTM(const unsigned int batch_size,
     }
   }
 
+  RecurrentActivation act, recurrent_act;
+  if (useBatchedKernel(input, weight_ih, input.height(), acti_func,
+                       recurrent_acti_func, act, recurrent_act)) {
+    lstm_gates_forward(batch_size, unit, ifgo.getData<float>(), 4 * unit,
+                       prev_cell_state.getData<float>(),
+                       cell_state.getData<float>(),
+                       hidden_state.getData<float>(), unit, act, recurrent_act);
+    return;
+  }
+
   TensorDim::TensorType tensor_type = ifgo.getTensorType();
 
   Tensor input_forget_gate = ifgo.getSharedDataTensor(
@@ -87,49 +111,62 @@ void LSTMCore::calcGradientLSTM(
   const Tensor &d_cell_state, Tensor &d_weight_ih, const Tensor &weight_hh,
   Tensor &d_weight_hh, Tensor &d_bias_h, Tensor &d_bias_ih, Tensor &d_bias_hh,
   const Tensor &ifgo, Tensor &d_ifgo) {
-  TensorDim::TensorType tensor_type = ifgo.getTensorType();
-  Tensor input_forget_gate = ifgo.getSharedDataTensor(
-    {batch_size, 1, 1, unit * 2, tensor_type}, 0, false);
-  Tensor input_gate =
-    ifgo.getSharedDataTensor({batch_size, 1, 1, unit, tensor_type}, 0, false);
-  Tensor forget_gate = ifgo.getSharedDataTensor(
-    {batch_size, 1, 1, unit, tensor_type}, unit, false);
-  Tensor memory_cell = ifgo.getSharedDataTensor(
-    {batch_size, 1, 1, unit, tensor_type}, unit * 2, false);
-  Tensor output_gate = ifgo.getSharedDataTensor(
-    {batch_size, 1, 1, unit, tensor_type}, unit * 3, false);
-
-  Tensor d_input_forget_gate = d_ifgo.getSharedDataTensor(
-    {batch_size, 1, 1, unit * 2, tensor_type}, 0, false);
-  Tensor d_input_gate =
-    d_ifgo.getSharedDataTensor({batch_size, 1, 1, unit, tensor_type}, 0, false);
-  Tensor d_forget_gate = d_ifgo.getSharedDataTensor(
-    {batch_size, 1, 1, unit, tensor_type}, unit, false);
-  Tensor d_memory_cell = d_ifgo.getSharedDataTensor(
-    {batch_size, 1, 1, unit, tensor_type}, unit * 2, false);
-  Tensor d_output_gate = d_ifgo.getSharedDataTensor(
-    {batch_size, 1, 1, unit, tensor_type}, unit * 3, false);
-
-  Tensor activated_cell_state = Tensor(
-    "activated_cell_state", cell_state.getFormat(), cell_state.getDataType());
-
-  acti_func.run_fn(cell_state, activated_cell_state);
-  d_hidden_state.multiply_strided(activated_cell_state, d_output_gate);
-  acti_func.run_prime_fn(activated_cell_state, d_prev_cell_state,
-                         d_hidden_state);
-  d_prev_cell_state.multiply_i_strided(output_gate);
-  d_prev_cell_state.add_i(d_cell_state);
-
-  d_prev_cell_state.multiply_strided(input_gate, d_memory_cell);
-  d_prev_cell_state.multiply_strided(memory_cell, d_input_gate);
-
-  d_prev_cell_state.multiply_strided(prev_cell_state, d_forget_gate);
-  d_prev_cell_state.multiply_i_strided(forget_gate);
-
-  recurrent_acti_func.run_prime_fn(output_gate, d_output_gate, d_output_gate);
-  recurrent_acti_func.run_prime_fn(input_forget_gate, d_input_forget_gate,
-                                   d_input_forget_gate);
-  acti_func.run_prime_fn(memory_cell, d_memory_cell, d_memory_cell);
+  RecurrentActivation act, recurrent_act;
+  if (!d_prev_cell_state.empty() &&
+      useBatchedKernel(input, d_weight_ih, input.height(), acti_func,
+                       recurrent_acti_func, act, recurrent_act)) {
+    lstm_gates_backward(
+      batch_size, unit, ifgo.getData<float>(), 4 * unit,
+      prev_cell_state.getData<float>(), cell_state.getData<float>(),
+      d_hidden_state.getData<float>(),
+      d_cell_state.empty() ? nullptr : d_cell_state.getData<float>(),
+      d_prev_cell_state.getData<float>(), d_ifgo.getData<float>(), unit, act,
+      recurrent_act);
+  } else {
+    TensorDim::TensorType tensor_type = ifgo.getTensorType();
+    Tensor input_forget_gate = ifgo.getSharedDataTensor(
+      {batch_size, 1, 1, unit * 2, tensor_type}, 0, false);
+    Tensor input_gate =
+      ifgo.getSharedDataTensor({batch_size, 1, 1, unit, tensor_type}, 0, false);
+    Tensor forget_gate = ifgo.getSharedDataTensor(
+      {batch_size, 1, 1, unit, tensor_type}, unit, false);
+    Tensor memory_cell = ifgo.getSharedDataTensor(
+      {batch_size, 1, 1, unit, tensor_type}, unit * 2, false);
+    Tensor output_gate = ifgo.getSharedDataTensor(
+      {batch_size, 1, 1, unit, tensor_type}, unit * 3, false);
+
+    Tensor d_input_forget_gate = d_ifgo.getSharedDataTensor(
+      {batch_size, 1, 1, unit * 2, tensor_type}, 0, false);
+    Tensor d_input_gate = d_ifgo.getSharedDataTensor(
+      {batch_size, 1, 1, unit, tensor_type}, 0, false);
+    Tensor d_forget_gate = d_ifgo.getSharedDataTensor(
+      {batch_size, 1, 1, unit, tensor_type}, unit, false);
+    Tensor d_memory_cell = d_ifgo.getSharedDataTensor(
+      {batch_size, 1, 1, unit, tensor_type}, unit * 2, false);
+    Tensor d_output_gate = d_ifgo.getSharedDataTensor(
+      {batch_size, 1, 1, unit, tensor_type}, unit * 3, false);
+
+    Tensor activated_cell_state = Tensor(
+      "activated_cell_state", cell_state.getFormat(), cell_state.getDataType());
+
+    acti_func.run_fn(cell_state, activated_cell_state);
+    d_hidden_state.multiply_strided(activated_cell_state, d_output_gate);
+    acti_func.run_prime_fn(activated_cell_state, d_prev_cell_state,
+                           d_hidden_state);
+    d_prev_cell_state.multiply_i_strided(output_gate);
+    d_prev_cell_state.add_i(d_cell_state);
+
+    d_prev_cell_state.multiply_strided(input_gate, d_memory_cell);
+    d_prev_cell_state.multiply_strided(memory_cell, d_input_gate);
+
+    d_prev_cell_state.multiply_strided(prev_cell_state, d_forget_gate);
+    d_prev_cell_state.multiply_i_strided(forget_gate);
+
+    recurrent_acti_func.run_prime_fn(output_gate, d_output_gate, d_output_gate);
+    recurrent_acti_func.run_prime_fn(input_forget_gate, d_input_forget_gate,
+                                     d_input_forget_gate);
+    acti_func.run_prime_fn(memory_cell, d_memory_cell, d_memory_cell);
+  }
 
   if (!disable_bias) {
     if (integrate_bias) {
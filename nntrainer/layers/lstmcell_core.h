@@ -19,6 +19,7 @@
 #include <common.h>
 #include <layer_impl.h>
 #include <node_exporter.h>
+#include <recurrent_kernel.h>
 
 namespace nntrainer {
 
@@ -136,6 +137,27 @@ public:
                 const ml::train::ExportMethods &method) const override;
 
 protected:
+  /**
+   * @brief check if the fused float kernels of recurrent_kernel.h can be used
+   *
+   * @param input input of the layer
+   * @param weight weight of the layer
+   * @param max_timestep number of timesteps iterated by the layer
+   * @param acti_func activation function for memory cell, cell state
+   * @param recurrent_acti_func activation function for input/output/forget
+   * gate
+   * @param[out] act scalar functions of acti_func
+   * @param[out] recurrent_act scalar functions of recurrent_acti_func
+   * @retval true if input and weight are float, input holds max_timestep
+   * timesteps and both activations are element-wise
+   */
+  static bool useBatchedKernel(const Tensor &input, const Tensor &weight,
+                               const unsigned int max_timestep,
+                               const ActiFunc &acti_func,
+                               const ActiFunc &recurrent_acti_func,
+                               RecurrentActivation &act,
+                               RecurrentActivation &recurrent_act);
+
   /**
    * Unit: number of output neurons
    * IntegrateBias: integrate bias_ih, bias_hh to bias_h
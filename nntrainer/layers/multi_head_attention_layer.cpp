@@ -14,11 +14,14 @@
 
 #include <cmath>
 
+#include <flash_attention.h>
 #include <layer_context.h>
 #include <multi_head_attention_layer.h>
 #include <nntrainer_error.h>
 #include <nntrainer_log.h>
 #include <node_exporter.h>
+#include <util_func.h>
+#include <util_simd.h>
 
 namespace nntrainer {
 
@@ -26,8 +29,9 @@ MultiHeadAttentionLayer::MultiHeadAttentionLayer() :
   multi_head_attention_props(
     props::NumHeads(), props::ProjectedKeyDim(), props::ProjectedValueDim(),
     props::OutputShape(), props::DropOutRate(), props::ReturnAttentionWeight(),
-    props::AverageAttentionWeight()),
-  sm(ActivationType::ACT_SOFTMAX),
+    props::AverageAttentionWeight(), props::MaxTimestep(),
+    props::KVCacheDataType()),
+  tiled_attention(false),
   epsilon(1e-3) {
   weight_idx.fill(std::numeric_limits<unsigned>::max());
 }
@@ -64,8 +68,314 @@ enum AttentionParams {
   attention_weight,
   dropout_mask,
   attention_output,
+  attention_lse,
+  cache_key_scale,
+  cache_value_scale,
 };
 
+namespace {
+
+/**
+ * @brief     scale, mask, softmax and dropout every row of the attention
+ * weight in a single pass per row
+ *
+ * @param[in/out] weight attention weight, holds softmax result afterwards
+ * @param[in] mask additive attention mask, empty if not provided
+ * @param[in] scale scale factor of the attention score
+ * @param[in] causal_from position of the first query if causal mask is
+ * applied, -1 otherwise
+ * @param[in] dropout_rate dropout rate
+ * @param[out] dropped dropped out attention weight, empty if not applied
+ */
+template <typename T>
+void attentionSoftmax(Tensor &weight, const Tensor &mask, float scale,
+                      int causal_from, float dropout_rate, Tensor &dropped) {
+  const unsigned int width = weight.width();
+  const unsigned int height = weight.height();
+  const unsigned int rows = weight.size() / width;
+  const unsigned int mask_rows = mask.empty() ? 0 : mask.size() / width;
+  const unsigned int seed = dropped.empty() ? 0 : rng();
+
+  T *data = weight.getData<T>();
+  T *dropped_data = dropped.empty() ? nullptr : dropped.getData<T>();
+  const T *mask_data = mask.empty() ? nullptr : mask.getData<T>();
+
+  for (unsigned int r = 0; r < rows; ++r) {
+    unsigned int len = width;
+    if (causal_from >= 0)
+      len = std::min(width, causal_from + r % height + 1);
+    softmax_row_fused(width, data + r * width, scale,
+                      mask_data ? mask_data + (r % mask_rows) * width
+                                : nullptr,
+                      len, dropout_rate, seed + r * 8,
+                      dropped_data ? dropped_data + r * width : nullptr);
+  }
+}
+
+/**
+ * @brief     derivative of attentionSoftmax
+ *
+ * @param[in] weight softmax result of the attention weight
+ * @param[in] dropped dropped out attention weight, empty if not applied
+ * @param[in] dropout_rate dropout rate
+ * @param[in/out] d_weight derivative of the attention weight, holds the
+ * derivative of the attention score afterwards
+ * @param[in] d_extra derivative added after dropout, empty if not provided
+ * @param[in] scale scale factor of the attention score
+ * @param[out] d_mask derivative of the attention mask, empty if not provided
+ */
+template <typename T>
+void attentionSoftmaxDeriv(const Tensor &weight, const Tensor &dropped,
+                           float dropout_rate, Tensor &d_weight,
+                           const Tensor &d_extra, float scale, Tensor &d_mask) {
+  const unsigned int width = weight.width();
+  const unsigned int rows = weight.size() / width;
+
+  const T *data = weight.getData<T>();
+  const T *dropped_data = dropped.empty() ? nullptr : dropped.getData<T>();
+  const T *d_extra_data = d_extra.empty() ? nullptr : d_extra.getData<T>();
+  T *d_data = d_weight.getData<T>();
+  T *d_mask_data = d_mask.empty() ? nullptr : d_mask.getData<T>();
+
+  for (unsigned int r = 0; r < rows; ++r) {
+    const unsigned int offset = r * width;
+    softmax_row_fused_deriv(
+      width, data + offset, dropped_data ? dropped_data + offset : nullptr,
+      dropout_rate, d_data + offset,
+      d_extra_data ? d_extra_data + offset : nullptr, scale,
+      d_mask_data ? d_mask_data + offset : nullptr);
+  }
+}
+
+/**
+ * @brief     run attentionSoftmax according to the data type of the weight
+ */
+void attentionSoftmax(Tensor &weight, const Tensor &mask, float scale,
+                      int causal_from, float dropout_rate, Tensor &dropped) {
+  if (weight.getDataType() == TensorDim::DataType::FP32) {
+    attentionSoftmax<float>(weight, mask, scale, causal_from, dropout_rate,
+                            dropped);
+  } else if (weight.getDataType() == TensorDim::DataType::FP16) {
+#ifdef ENABLE_FP16
+    attentionSoftmax<_FP16>(weight, mask, scale, causal_from, dropout_rate,
+                            dropped);
+#else
+    throw std::invalid_argument("Error: enable-fp16 is not enabled");
+#endif
+  }
+}
+
+/**
+ * @brief     run attentionSoftmaxDeriv according to the data type of the
+ * weight
+ */
+void attentionSoftmaxDeriv(const Tensor &weight, const Tensor &dropped,
+                           float dropout_rate, Tensor &d_weight,
+                           const Tensor &d_extra, float scale, Tensor &d_mask) {
+  if (weight.getDataType() == TensorDim::DataType::FP32) {
+    attentionSoftmaxDeriv<float>(weight, dropped, dropout_rate, d_weight,
+                                 d_extra, scale, d_mask);
+  } else if (weight.getDataType() == TensorDim::DataType::FP16) {
+#ifdef ENABLE_FP16
+    attentionSoftmaxDeriv<_FP16>(weight, dropped, dropout_rate, d_weight,
+                                 d_extra, scale, d_mask);
+#else
+    throw std::invalid_argument("Error: enable-fp16 is not enabled");
+#endif
+  }
+}
+
+/**
+ * @brief     tiled attention over the projected tensors of
+ * [batch, 1, length, num_heads * dim]
+ *
+ * @param[in] dim shape of the attention
+ * @param[in] query projected query
+ * @param[in] key projected key
+ * @param[in] value projected value
+ * @param[in] mask additive attention mask, empty if not provided
+ * @param[in] scale scale factor of the attention score
+ * @param[in] causal_from position of the first query if causal mask is
+ * applied, -1 otherwise
+ * @param[out] output attention output
+ * @param[out] lse log-sum-exp of the attention score, empty if not needed
+ */
+template <typename T>
+void flashAttention(const FlashAttentionDim &dim, const Tensor &query,
+                    const Tensor &key, const Tensor &value, const Tensor &mask,
+                    float scale, int causal_from, Tensor &output,
+                    Tensor &lse) {
+  flash_attention_forward(
+    dim, query.getData<T>(), key.getData<T>(), value.getData<T>(),
+    mask.empty() ? nullptr : mask.getData<T>(),
+    mask.empty() ? 0 : mask.size() / dim.kv_len, scale, causal_from,
+    output.getData<T>(), lse.empty() ? nullptr : lse.getData<float>());
+}
+
+/**
+ * @brief     derivative of flashAttention
+ */
+template <typename T>
+void flashAttentionDeriv(const FlashAttentionDim &dim, const Tensor &query,
+                         const Tensor &key, const Tensor &value,
+                         const Tensor &mask, float scale, int causal_from,
+                         const Tensor &output, const Tensor &lse,
+                         const Tensor &d_output, Tensor &d_query,
+                         Tensor &d_key, Tensor &d_value, Tensor &d_mask) {
+  flash_attention_backward(
+    dim, query.getData<T>(), key.getData<T>(), value.getData<T>(),
+    mask.empty() ? nullptr : mask.getData<T>(),
+    mask.empty() ? 0 : mask.size() / dim.kv_len, scale, causal_from,
+    output.getData<T>(), lse.getData<float>(), d_output.getData<T>(),
+    d_query.getData<T>(), d_key.getData<T>(), d_value.getData<T>(),
+    d_mask.empty() ? nullptr : d_mask.getData<T>());
+}
+
+/**
+ * @brief     run flashAttention according to the data type of the query
+ */
+void flashAttention(const FlashAttentionDim &dim, const Tensor &query,
+                    const Tensor &key, const Tensor &value, const Tensor &mask,
+                    float scale, int causal_from, Tensor &output,
+                    Tensor &lse) {
+  if (query.getDataType() == TensorDim::DataType::FP32) {
+    flashAttention<float>(dim, query, key, value, mask, scale, causal_from,
+                          output, lse);
+  } else if (query.getDataType() == TensorDim::DataType::FP16) {
+#ifdef ENABLE_FP16
+    flashAttention<_FP16>(dim, query, key, value, mask, scale, causal_from,
+                          output, lse);
+#else
+    throw std::invalid_argument("Error: enable-fp16 is not enabled");
+#endif
+  }
+}
+
+/**
+ * @brief     run flashAttentionDeriv according to the data type of the query
+ */
+void flashAttentionDeriv(const FlashAttentionDim &dim, const Tensor &query,
+                         const Tensor &key, const Tensor &value,
+                         const Tensor &mask, float scale, int causal_from,
+                         const Tensor &output, const Tensor &lse,
+                         const Tensor &d_output, Tensor &d_query,
+                         Tensor &d_key, Tensor &d_value, Tensor &d_mask) {
+  if (query.getDataType() == TensorDim::DataType::FP32) {
+    flashAttentionDeriv<float>(dim, query, key, value, mask, scale,
+                               causal_from, output, lse, d_output, d_query,
+                               d_key, d_value, d_mask);
+  } else if (query.getDataType() == TensorDim::DataType::FP16) {
+#ifdef ENABLE_FP16
+    flashAttentionDeriv<_FP16>(dim, query, key, value, mask, scale,
+                               causal_from, output, lse, d_output, d_query,
+                               d_key, d_value, d_mask);
+#else
+    throw std::invalid_argument("Error: enable-fp16 is not enabled");
+#endif
+  }
+}
+
+/**
+ * @brief     store projected keys/values to the cache of a narrower data type
+ *
+ * @param[in] rows projected keys/values of [num_rows, num_heads * dim]
+ * @param[out] cache key/value cache of int8 or half-precision
+ * @param[out] cache_scale scale of every head of the cached rows, only for the
+ * int8 cache
+ * @param[in] at row of the cache to store the first row, counted over the
+ * batches
+ * @param[in] num_heads number of heads
+ */
+void storeCache(const Tensor &rows, Tensor &cache, Tensor &cache_scale,
+                size_t at, unsigned int num_heads) {
+  const unsigned int width = cache.width();
+  const unsigned int num_rows = rows.size() / width;
+
+  if (cache.getDataType() == TensorDim::DataType::QINT8) {
+    int8_t *dst = cache.getData<int8_t>() + at * width;
+    float *scales = cache_scale.getData<float>() + at * num_heads;
+    if (rows.getDataType() == TensorDim::DataType::FP32) {
+      flash_attention_quantize(num_rows * num_heads, width / num_heads,
+                               rows.getData<float>(), dst, scales);
+    } else {
+#ifdef ENABLE_FP16
+      flash_attention_quantize(num_rows * num_heads, width / num_heads,
+                               rows.getData<_FP16>(), dst, scales);
+#else
+      throw std::invalid_argument("Error: enable-fp16 is not enabled");
+#endif
+    }
+  } else {
+#ifdef ENABLE_FP16
+    const float *src = rows.getData<float>();
+    _FP16 *dst = cache.getData<_FP16>() + at * width;
+    for (size_t i = 0; i < (size_t)num_rows * width; ++i)
+      dst[i] = static_cast<_FP16>(src[i]);
+#else
+    throw std::invalid_argument("Error: enable-fp16 is not enabled");
+#endif
+  }
+}
+
+/**
+ * @brief     run flashAttention over the cache of a narrower data type than
+ * the query
+ *
+ * @param[in] dim shape of the attention
+ * @param[in] query projected query
+ * @param[in] cache_key key cache of int8 or half-precision
+ * @param[in] key_scale scale of the int8 key cache, empty otherwise
+ * @param[in] cache_value value cache of int8 or half-precision
+ * @param[in] value_scale scale of the int8 value cache, empty otherwise
+ * @param[in] first_batch batch of the cache attended by the first query
+ * @param[in] scale scale factor of the attention score
+ * @param[in] causal_from position of the first query
+ * @param[out] output attention output
+ */
+void flashAttentionCache(const FlashAttentionDim &dim, const Tensor &query,
+                         const Tensor &cache_key, const Tensor &key_scale,
+                         const Tensor &cache_value, const Tensor &value_scale,
+                         unsigned int first_batch, float scale,
+                         int causal_from, Tensor &output) {
+  const size_t first_row = (size_t)first_batch * dim.kv_capacity;
+  const size_t key_offset = first_row * dim.num_heads * dim.head_dim;
+  const size_t value_offset = first_row * dim.num_heads * dim.value_dim;
+
+  if (cache_key.getDataType() == TensorDim::DataType::QINT8) {
+    const int8_t *K = cache_key.getData<int8_t>() + key_offset;
+    const int8_t *V = cache_value.getData<int8_t>() + value_offset;
+    const float *K_scale =
+      key_scale.getData<float>() + first_row * dim.num_heads;
+    const float *V_scale =
+      value_scale.getData<float>() + first_row * dim.num_heads;
+    if (query.getDataType() == TensorDim::DataType::FP32) {
+      flash_attention_forward(dim, query.getData<float>(), K, K_scale, V,
+                              V_scale, nullptr, 0, scale, causal_from,
+                              output.getData<float>(), nullptr);
+    } else {
+#ifdef ENABLE_FP16
+      flash_attention_forward(dim, query.getData<_FP16>(), K, K_scale, V,
+                              V_scale, nullptr, 0, scale, causal_from,
+                              output.getData<_FP16>(), nullptr);
+#else
+      throw std::invalid_argument("Error: enable-fp16 is not enabled");
+#endif
+    }
+  } else {
+#ifdef ENABLE_FP16
+    flash_attention_forward(dim, query.getData<float>(),
+                            cache_key.getData<_FP16>() + key_offset,
+                            cache_value.getData<_FP16>() + value_offset,
+                            nullptr, 0, scale, causal_from,
+                            output.getData<float>(), nullptr);
+#else
+    throw std::invalid_argument("Error: enable-fp16 is not enabled");
+#endif
+  }
+}
+
+} // namespace
+
 void MultiHeadAttentionLayer::finalize(InitLayerContext &context) {
   NNTR_THROW_IF(context.getNumInputs() < 3 || context.getNumInputs() > 4,
                 std::invalid_argument)
@@ -157,17 +467,11 @@ void MultiHeadAttentionLayer::finalize(InitLayerContext &context) {
 
   const unsigned int projected_query_dim_prop = projected_key_dim_prop;
 
-  if (activation_type.data_type == TensorDim::DataType::FP32) {
-    sm.setActiFunc(ActivationType::ACT_SOFTMAX);
-  } else if (activation_type.data_type == TensorDim::DataType::FP16) {
-#ifdef ENABLE_FP16
-    sm.setActiFunc<_FP16>(ActivationType::ACT_SOFTMAX);
-#else
+#ifndef ENABLE_FP16
+  if (activation_type.data_type == TensorDim::DataType::FP16) {
     throw std::invalid_argument("Error: enable-fp16 is not enabled");
-#endif
   }
-
-  // sm.setActiFunc(ActivationType::ACT_SOFTMAX);
+#endif
 
   NNTR_THROW_IF(query_dim.channel() != 1, std::invalid_argument)
     << "Dimension of input query channel: " << query_dim.channel()
@@ -278,12 +582,60 @@ void MultiHeadAttentionLayer::finalize(InitLayerContext &context) {
     projected_value_dim, "projected_value", Tensor::Initializer::NONE, true,
     TensorLifespan::ITERATION_LIFESPAN);
 
+  /** the cache keeps max_timestep keys/values for the incremental forwarding
+   * when it is given, the height of the key otherwise */
+  TensorDim cache_key_dim = projected_key_dim;
+  TensorDim cache_value_dim = projected_value_dim;
+  auto &max_timestep = std::get<props::MaxTimestep>(multi_head_attention_props);
+  if (!max_timestep.empty()) {
+    NNTR_THROW_IF(max_timestep.get() < key_height, std::invalid_argument)
+      << "max_timestep: " << max_timestep.get()
+      << " is less than the height of the key: " << key_height
+      << " for layer " << context.getName();
+    cache_key_dim.height(max_timestep.get());
+    cache_value_dim.height(max_timestep.get());
+  }
+
+  /** the cache may be kept narrower than the activation. An int8 cache keeps
+   * a scale for every head of every cached row, so that a new row never
+   * requantizes the rows cached before */
+  const props::KVCacheDataTypeInfo::Enum kv_cache_dtype =
+    std::get<props::KVCacheDataType>(multi_head_attention_props).get();
+  if (kv_cache_dtype != props::KVCacheDataTypeInfo::Enum::activation) {
+    NNTR_THROW_IF(return_attention_weight !=
+                    props::ReturnAttentionWeightInfo::Enum::none,
+                  std::invalid_argument)
+      << "attention weight can not be returned from a fp16/int8 key/value "
+         "cache for layer "
+      << context.getName();
+  }
+  if (kv_cache_dtype == props::KVCacheDataTypeInfo::Enum::fp16) {
+#ifndef ENABLE_FP16
+    throw std::invalid_argument("Error: enable-fp16 is not enabled");
+#endif
+    cache_key_dim.setDataType(TensorDim::DataType::FP16);
+    cache_value_dim.setDataType(TensorDim::DataType::FP16);
+  } else if (kv_cache_dtype == props::KVCacheDataTypeInfo::Enum::int8) {
+    cache_key_dim.setDataType(TensorDim::DataType::QINT8);
+    cache_value_dim.setDataType(TensorDim::DataType::QINT8);
+
+    TensorDim cache_scale_dim(
+      {batch_size, 1, cache_key_dim.height(), num_heads},
+      {context.getFormat(), TensorDim::DataType::FP32});
+    weight_idx[AttentionParams::cache_key_scale] = context.requestTensor(
+      cache_scale_dim, "cache_key_scale", Tensor::Initializer::NONE, false,
+      TensorLifespan::MAX_LIFESPAN);
+    weight_idx[AttentionParams::cache_value_scale] = context.requestTensor(
+      cache_scale_dim, "cache_value_scale", Tensor::Initializer::NONE, false,
+      TensorLifespan::MAX_LIFESPAN);
+  }
+
   weight_idx[AttentionParams::cache_key] = context.requestTensor(
-    projected_key_dim, "cache_key", Tensor::Initializer::NONE, true,
+    cache_key_dim, "cache_key", Tensor::Initializer::NONE, true,
     TensorLifespan::MAX_LIFESPAN);
 
   weight_idx[AttentionParams::cache_value] = context.requestTensor(
-    projected_value_dim, "cache_value", Tensor::Initializer::NONE, true,
+    cache_value_dim, "cache_value", Tensor::Initializer::NONE, true,
     TensorLifespan::MAX_LIFESPAN);
 
   if (provide_attention_mask) {
@@ -294,14 +646,33 @@ void MultiHeadAttentionLayer::finalize(InitLayerContext &context) {
     //   attention_mask_dim, "attention_mask", Tensor::Initializer::NONE, false,
     //   TensorLifespan::FORWARD_FUNC_LIFESPAN);
   }
-  /** tensor for attention weight */
-  TensorDim attention_weight_dim(
-    {batch_size, num_heads, query_height, key_height}, activation_type);
-  weight_idx[AttentionParams::attention_weight] = context.requestTensor(
-    attention_weight_dim, "attention_weight", Tensor::Initializer::NONE, true,
-    TensorLifespan::ITERATION_LIFESPAN);
+  /**
+   * The attention weight is only materialized when it has to be observed,
+   * which is when it is returned or dropped out. Otherwise the attention is
+   * computed tile by tile and only the log-sum-exp of every score row is kept
+   * for the backward.
+   */
+  tiled_attention =
+    dropout_rate <= epsilon &&
+    return_attention_weight == props::ReturnAttentionWeightInfo::Enum::none;
+  if (tiled_attention) {
+    TensorDim attention_lse_dim(
+      {batch_size, num_heads, query_height, 1},
+      {context.getFormat(), TensorDim::DataType::FP32});
+    weight_idx[AttentionParams::attention_lse] = context.requestTensor(
+      attention_lse_dim, "attention_lse", Tensor::Initializer::NONE, false,
+      TensorLifespan::ITERATION_LIFESPAN);
+  } else {
+    /** tensor for attention weight */
+    TensorDim attention_weight_dim(
+      {batch_size, num_heads, query_height, key_height}, activation_type);
+    weight_idx[AttentionParams::attention_weight] = context.requestTensor(
+      attention_weight_dim, "attention_weight", Tensor::Initializer::NONE, true,
+      TensorLifespan::ITERATION_LIFESPAN);
+  }
   if (dropout_rate > epsilon) {
-    /** tensor for dropout mask */
+    /** tensor for attention weight after dropout. The dropout mask itself is
+     * not stored as it can be recovered from the dropped out weight */
     TensorDim dropout_mask_dim(
       {batch_size, num_heads, query_height, key_height}, activation_type);
     weight_idx[AttentionParams::dropout_mask] = context.requestTensor(
@@ -398,8 +769,6 @@ void MultiHeadAttentionLayer::forwarding(RunLayerContext &context,
   Tensor &projected_value =
     context.getTensor(weight_idx[AttentionParams::projected_value]);
 
-  Tensor &attention_weight =
-    context.getTensor(weight_idx[AttentionParams::attention_weight]);
   Tensor &attention_output =
     context.getTensor(weight_idx[AttentionParams::attention_output]);
 
@@ -424,6 +793,28 @@ void MultiHeadAttentionLayer::forwarding(RunLayerContext &context,
     projected_value.add_i(value_fc_bias);
   }
 
+  if (tiled_attention) {
+    Tensor &attention_lse =
+      context.getTensor(weight_idx[AttentionParams::attention_lse]);
+    const FlashAttentionDim attention_dim = {
+      batch_size, num_heads, query_height, key_height, key_height,
+      projected_query_dim_prop, projected_value_dim_prop};
+
+    flashAttention(attention_dim, projected_query, projected_key,
+                   projected_value, mask,
+                   1 / sqrt((float)projected_query_dim_prop), -1,
+                   attention_output, attention_lse);
+
+    attention_output.dot(fc_weight, output);
+    if (!disable_bias) {
+      output.add_i(fc_bias);
+    }
+    return;
+  }
+
+  Tensor &attention_weight =
+    context.getTensor(weight_idx[AttentionParams::attention_weight]);
+
   projected_query.reshape(
     TensorDim({batch_size, query_height, num_heads, projected_query_dim_prop}));
   projected_key.reshape(
@@ -453,34 +844,22 @@ void MultiHeadAttentionLayer::forwarding(RunLayerContext &context,
   attention_output.reshape(TensorDim(
     {batch_size * num_heads, 1, query_height, projected_value_dim_prop}));
 
+  Tensor &dropped_attention_weight =
+    enable_dropout
+      ? context.getTensor(weight_idx[AttentionParams::dropout_mask])
+      : empty_tensor;
+  /** attention weight which is multiplied with the value */
+  Tensor &applied_attention_weight =
+    enable_dropout ? dropped_attention_weight : attention_weight;
+
   /** scaled dot product attention */
   projected_query.dotBatched(projected_key, attention_weight, false, true);
-  attention_weight.multiply_i(1 / sqrt((float)projected_query_dim_prop));
 
-  if (provide_attention_mask) {
-    // Tensor &attention_mask =
-    //   context.getTensor(weight_idx[AttentionParams::attention_mask]);
-    /** @todo: enable bool type tensor */
-    // if (torch_ref) {
-    //   attention_mask.setValue(-1e9);
-    // } else {
-    //   // flip
-    //   attention_mask.setValue(1);
-    //   attention_mask.subtract_i(mask);
-
-    //   attention_mask.multiply_i(-1e9);
-    // }
-    // attention_mask.multiply_i(mask);
-    // attention_weight.add_i(attention_mask);
-
-    attention_weight.reshape(
-      TensorDim({batch_size, num_heads, query_height, key_height}));
-    attention_weight.add_i(mask);
-    attention_weight.reshape(
-      TensorDim({batch_size * num_heads, 1, query_height, key_height}));
-  }
-
-  sm.run_fn(attention_weight, attention_weight);
+  /** @todo: enable bool type tensor for the attention mask */
+  attentionSoftmax(attention_weight, mask,
+                   1 / sqrt((float)projected_query_dim_prop), -1,
+                   enable_dropout ? dropout_rate : 0.0f,
+                   dropped_attention_weight);
 
   if (return_attention_weight ==
       props::ReturnAttentionWeightInfo::Enum::before) {
@@ -488,27 +867,25 @@ void MultiHeadAttentionLayer::forwarding(RunLayerContext &context,
   }
 
   if (enable_dropout) {
-    Tensor &dropout_mask =
-      context.getTensor(weight_idx[AttentionParams::dropout_mask]);
-    dropout_mask.dropout_mask(dropout_rate);
-    attention_weight.multiply_i(dropout_mask);
+    dropped_attention_weight.reshape(
+      TensorDim({batch_size * num_heads, 1, query_height, key_height}));
   }
 
   if (return_attention_weight ==
       props::ReturnAttentionWeightInfo::Enum::after) {
     if (average_attention_weight) {
-      attention_weight.reshape(
+      applied_attention_weight.reshape(
         TensorDim({batch_size, num_heads, query_height, key_height}));
-      attention_weight.sum(1, ret_attention_weight, 1, 0);
+      applied_attention_weight.sum(1, ret_attention_weight, 1, 0);
       ret_attention_weight.divide_i(num_heads);
-      attention_weight.reshape(
+      applied_attention_weight.reshape(
         TensorDim({batch_size * num_heads, 1, query_height, key_height}));
     } else {
-      ret_attention_weight.copyData(attention_weight);
+      ret_attention_weight.copyData(applied_attention_weight);
     }
   }
 
-  attention_weight.dotBatched(projected_value, attention_output);
+  applied_attention_weight.dotBatched(projected_value, attention_output);
 
   attention_output.reshape(
     TensorDim({batch_size, num_heads, query_height, projected_value_dim_prop}));
@@ -537,6 +914,10 @@ void MultiHeadAttentionLayer::forwarding(RunLayerContext &context,
 
   attention_weight.reshape(
     TensorDim({batch_size, num_heads, query_height, key_height}));
+  if (enable_dropout) {
+    dropped_attention_weight.reshape(
+      TensorDim({batch_size, num_heads, query_height, key_height}));
+  }
   attention_output.reshape(TensorDim(
     {batch_size, 1, query_height, num_heads * projected_value_dim_prop}));
 }
@@ -622,6 +1003,18 @@ void MultiHeadAttentionLayer::incremental_forwarding(RunLayerContext &context,
   Tensor &cache_key = context.getTensor(weight_idx[AttentionParams::cache_key]);
   Tensor &cache_value =
     context.getTensor(weight_idx[AttentionParams::cache_value]);
+  const bool narrow_cache =
+    cache_key.getDataType() != projected_key.getDataType();
+  const bool quantized_cache =
+    cache_key.getDataType() == TensorDim::DataType::QINT8;
+  Tensor &cache_key_scale =
+    quantized_cache
+      ? context.getTensor(weight_idx[AttentionParams::cache_key_scale])
+      : empty_tensor;
+  Tensor &cache_value_scale =
+    quantized_cache
+      ? context.getTensor(weight_idx[AttentionParams::cache_value_scale])
+      : empty_tensor;
 
   TensorDim projected_query_dim = projected_query.getDim();
   TensorDim projected_key_dim = projected_key.getDim();
@@ -664,18 +1057,8 @@ void MultiHeadAttentionLayer::incremental_forwarding(RunLayerContext &context,
   Tensor cached_value =
     cache_value.getSharedDataTensor(cached_value_dim, 0, true);
 
-  Tensor &attention_weight =
-    context.getTensor(weight_idx[AttentionParams::attention_weight]);
   Tensor &attention_output =
     context.getTensor(weight_idx[AttentionParams::attention_output]);
-  TensorDim attention_weight_dim = attention_weight.getDim();
-
-  TensorDim attention_weight_step_dim = attention_weight_dim;
-  attention_weight_step_dim.height(to - from);
-  attention_weight_step_dim.width(to);
-
-  Tensor attention_weight_step =
-    attention_weight.getSharedDataTensor(attention_weight_step_dim, 0, true);
 
   TensorDim attention_output_dim = attention_output.getDim();
   TensorDim attention_output_step_dim = attention_output_dim;
@@ -689,79 +1072,220 @@ void MultiHeadAttentionLayer::incremental_forwarding(RunLayerContext &context,
   const unsigned int key_height = key_dim.height();
   const unsigned int value_height = value_dim.height();
 
-  query.dot(query_fc_weight, projected_query_step);
-  if (!disable_bias) {
-    projected_query_step.add_i(query_fc_bias);
-  }
-  key.dot(key_fc_weight, cache_key_step);
-  if (!disable_bias) {
-    cache_key_step.add_i(key_fc_bias);
-  }
-  value.dot(value_fc_weight, cache_value_step);
-  if (!disable_bias) {
-    cache_value_step.add_i(value_fc_bias);
-  }
-
-  projected_query_step.reshape(
-    TensorDim({batch_size, 1, num_heads, projected_query_dim_prop}));
-  cached_key.reshape(
-    TensorDim({batch_size, to, num_heads, projected_key_dim_prop}));
-  cached_value.reshape(
-    TensorDim({batch_size, to, num_heads, projected_value_dim_prop}));
-
-  projected_query_step.transpose("1:0:2", projected_query_step);
-  cached_key.transpose("1:0:2", projected_key_step);
-  cached_value.transpose("1:0:2", projected_value_step);
-
-  projected_query_step.reshape(
-    TensorDim({batch_size * num_heads, 1, 1, projected_query_dim_prop}));
-  projected_key_step.reshape(
-    TensorDim({batch_size * num_heads, 1, to, projected_key_dim_prop}));
-  projected_value_step.reshape(
-    TensorDim({batch_size * num_heads, 1, to, projected_value_dim_prop}));
-
-  attention_weight_step.reshape(TensorDim({batch_size * num_heads, 1, 1, to}));
-  attention_output_step.reshape(
-    TensorDim({batch_size * num_heads, 1, 1, projected_value_dim_prop}));
-
-  /** scaled dot product attention */
-  projected_query_step.dotBatched(projected_key_step, attention_weight_step,
-                                  false, true);
-  attention_weight_step.multiply_i(1 / sqrt((float)projected_query_dim_prop));
-
-  if (!from) {
-    unsigned int mask_size = attention_weight_step.getDim().width();
-    unsigned int mask_dim_height = mask_size;
-    unsigned int mask_dim_width = mask_size;
-
-    Tensor causal_mask(TensorDim{1, 1, mask_size, mask_size,
-                                 attention_weight_step.getTensorType()});
-
-    causal_mask.setZero();
+  const std::vector<unsigned int> &positions =
+    context.getIncrementalPositions();
+  if (!positions.empty()) {
+    /** every batch is an independent sequence at its own position */
+    NNTR_THROW_IF(positions.size() != batch_size, std::invalid_argument)
+      << "number of positions: " << positions.size()
+      << " is not matched with the batch size: " << batch_size
+      << " for layer " << context.getName();
+    NNTR_THROW_IF(query_height != 1 || key_height != 1, std::invalid_argument)
+      << "a step at the positions of the batches takes a single token for "
+         "layer "
+      << context.getName();
+    NNTR_THROW_IF(return_attention_weight !=
+                    props::ReturnAttentionWeightInfo::Enum::none,
+                  std::invalid_argument)
+      << "attention weight can not be returned for the positions of the "
+         "batches for layer "
+      << context.getName();
 
-#ifdef ENABLE_FP16
-#define _MASK_NUM -1e4
-#else
-#define _MASK_NUM -1e10
-#endif
+    query.dot(query_fc_weight, projected_query);
+    key.dot(key_fc_weight, projected_key);
+    value.dot(value_fc_weight, projected_value);
+    if (!disable_bias) {
+      projected_query.add_i(query_fc_bias);
+      projected_key.add_i(key_fc_bias);
+      projected_value.add_i(value_fc_bias);
+    }
 
-    for (unsigned int i = 0; i < mask_dim_height; ++i) {
-      for (unsigned int j = i + 1; j < mask_dim_width; ++j) {
-        causal_mask.setValue(0, 0, i, j, _MASK_NUM);
+    const unsigned int cache_height = cache_key_dim.height();
+    TensorDim cache_key_row_dim = cache_key_dim;
+    TensorDim cache_value_row_dim = cache_value_dim;
+    cache_key_row_dim.batch(1);
+    cache_key_row_dim.height(1);
+    cache_value_row_dim.batch(1);
+    cache_value_row_dim.height(1);
+
+    Tensor empty_lse;
+    for (unsigned int b = 0; b < batch_size; ++b) {
+      const unsigned int pos = positions[b];
+      NNTR_THROW_IF(pos >= cache_height, std::invalid_argument)
+        << "position: " << pos << " of batch " << b
+        << " exceeds the cache size: " << cache_height << " for layer "
+        << context.getName();
+
+      const FlashAttentionDim attention_dim = {
+        1,        num_heads, 1, pos + 1, cache_height, projected_query_dim_prop,
+        projected_value_dim_prop};
+      Tensor attention_output_b = attention_output.getBatchSlice(b, 1);
+
+      if (narrow_cache) {
+        storeCache(projected_key.getBatchSlice(b, 1), cache_key,
+                   cache_key_scale, b * cache_height + pos, num_heads);
+        storeCache(projected_value.getBatchSlice(b, 1), cache_value,
+                   cache_value_scale, b * cache_height + pos, num_heads);
+        flashAttentionCache(attention_dim, projected_query.getBatchSlice(b, 1),
+                            cache_key, cache_key_scale, cache_value,
+                            cache_value_scale, b,
+                            1 / sqrt((float)projected_query_dim_prop), pos,
+                            attention_output_b);
+        continue;
       }
+
+      cache_key
+        .getSharedDataTensor(cache_key_row_dim,
+                             (b * cache_height + pos) * cache_key_dim.width())
+        .copyData(projected_key.getBatchSlice(b, 1));
+      cache_value
+        .getSharedDataTensor(cache_value_row_dim,
+                             (b * cache_height + pos) *
+                               cache_value_dim.width())
+        .copyData(projected_value.getBatchSlice(b, 1));
+
+      flashAttention(attention_dim, projected_query.getBatchSlice(b, 1),
+                     cache_key.getBatchSlice(b, 1),
+                     cache_value.getBatchSlice(b, 1), empty_tensor,
+                     1 / sqrt((float)projected_query_dim_prop), pos,
+                     attention_output_b, empty_lse);
     }
 
-    attention_weight_step.add_i(causal_mask);
+    attention_output.dot(fc_weight, output);
+    if (!disable_bias) {
+      output.add_i(fc_bias);
+    }
+    return;
   }
 
-  sm.run_fn(attention_weight_step, attention_weight_step);
-
-  attention_weight_step.dotBatched(projected_value_step, attention_output_step);
+  NNTR_THROW_IF(to > cache_key_dim.height(), std::invalid_argument)
+    << "step to: " << to << " exceeds the cache size: "
+    << cache_key_dim.height() << " for layer " << context.getName();
+
+  /** the tokens of the step are in the first to - from rows of the inputs */
+  TensorDim query_step_dim = query_dim;
+  TensorDim key_step_dim = key_dim;
+  TensorDim value_step_dim = value_dim;
+  query_step_dim.height(to - from);
+  key_step_dim.height(to - from);
+  value_step_dim.height(to - from);
+  Tensor query_step = query.getSharedDataTensor(query_step_dim, 0, true);
+  Tensor key_step = key.getSharedDataTensor(key_step_dim, 0, true);
+  Tensor value_step = value.getSharedDataTensor(value_step_dim, 0, true);
+
+  query_step.dot(query_fc_weight, projected_query_step);
+  if (!disable_bias) {
+    projected_query_step.add_i(query_fc_bias);
+  }
+  if (narrow_cache) {
+    /** the keys/values of the step are projected at the activation type and
+     * stored to the cache afterwards */
+    TensorDim key_rows_dim = projected_key_dim;
+    TensorDim value_rows_dim = projected_value_dim;
+    key_rows_dim.height(to - from);
+    value_rows_dim.height(to - from);
+    Tensor key_rows =
+      projected_key.getSharedDataTensor(key_rows_dim, 0, true);
+    Tensor value_rows =
+      projected_value.getSharedDataTensor(value_rows_dim, 0, true);
+
+    key_step.dot(key_fc_weight, key_rows);
+    value_step.dot(value_fc_weight, value_rows);
+    if (!disable_bias) {
+      key_rows.add_i(key_fc_bias);
+      value_rows.add_i(value_fc_bias);
+    }
 
-  attention_output_step.reshape(
-    TensorDim({batch_size, num_heads, to - from, projected_value_dim_prop}));
+    const unsigned int cache_height = cache_key_dim.height();
+    for (unsigned int b = 0; b < batch_size; ++b) {
+      storeCache(key_rows.getBatchSlice(b, 1), cache_key, cache_key_scale,
+                 b * cache_height + from, num_heads);
+      storeCache(value_rows.getBatchSlice(b, 1), cache_value,
+                 cache_value_scale, b * cache_height + from, num_heads);
+    }
+  } else {
+    key_step.dot(key_fc_weight, cache_key_step);
+    if (!disable_bias) {
+      cache_key_step.add_i(key_fc_bias);
+    }
+    value_step.dot(value_fc_weight, cache_value_step);
+    if (!disable_bias) {
+      cache_value_step.add_i(value_fc_bias);
+    }
+  }
 
-  attention_output_step = attention_output_step.transpose("1:0:2");
+  if (return_attention_weight == props::ReturnAttentionWeightInfo::Enum::none) {
+    /** attend the cached keys/values in place, query at position from + i
+     * attends keys up to from + i (causal) */
+    const unsigned int cache_height = cache_key_dim.height();
+    const FlashAttentionDim attention_dim = {
+      batch_size, num_heads, to - from, to, cache_height,
+      projected_query_dim_prop, projected_value_dim_prop};
+    Tensor empty_lse;
+    if (narrow_cache) {
+      flashAttentionCache(attention_dim, projected_query_step, cache_key,
+                          cache_key_scale, cache_value, cache_value_scale, 0,
+                          1 / sqrt((float)projected_query_dim_prop), from,
+                          attention_output_step);
+    } else {
+      flashAttention(attention_dim, projected_query_step, cache_key,
+                     cache_value, empty_tensor,
+                     1 / sqrt((float)projected_query_dim_prop), from,
+                     attention_output_step, empty_lse);
+    }
+  } else {
+    Tensor &attention_weight =
+      context.getTensor(weight_idx[AttentionParams::attention_weight]);
+    TensorDim attention_weight_step_dim = attention_weight.getDim();
+    attention_weight_step_dim.height(to - from);
+    attention_weight_step_dim.width(to);
+
+    Tensor attention_weight_step =
+      attention_weight.getSharedDataTensor(attention_weight_step_dim, 0, true);
+
+    const unsigned int step_height = to - from;
+    projected_query_step.reshape(TensorDim(
+      {batch_size, step_height, num_heads, projected_query_dim_prop}));
+    cached_key.reshape(
+      TensorDim({batch_size, to, num_heads, projected_key_dim_prop}));
+    cached_value.reshape(
+      TensorDim({batch_size, to, num_heads, projected_value_dim_prop}));
+
+    /** the rows of the step can not be transposed in place */
+    Tensor query_heads = projected_query_step.transpose("1:0:2");
+    cached_key.transpose("1:0:2", projected_key_step);
+    cached_value.transpose("1:0:2", projected_value_step);
+
+    query_heads.reshape(TensorDim(
+      {batch_size * num_heads, 1, step_height, projected_query_dim_prop}));
+    projected_key_step.reshape(
+      TensorDim({batch_size * num_heads, 1, to, projected_key_dim_prop}));
+    projected_value_step.reshape(
+      TensorDim({batch_size * num_heads, 1, to, projected_value_dim_prop}));
+
+    attention_weight_step.reshape(
+      TensorDim({batch_size * num_heads, 1, step_height, to}));
+    attention_output_step.reshape(TensorDim(
+      {batch_size * num_heads, 1, step_height, projected_value_dim_prop}));
+
+    /** scaled dot product attention */
+    query_heads.dotBatched(projected_key_step, attention_weight_step, false,
+                           true);
+
+    /** query at position from + i attends keys up to from + i (causal) */
+    Tensor empty_mask;
+    attentionSoftmax(attention_weight_step, empty_mask,
+                     1 / sqrt((float)projected_query_dim_prop), from, 0.0f,
+                     empty_tensor);
+
+    attention_weight_step.dotBatched(projected_value_step,
+                                     attention_output_step);
+
+    attention_output_step.reshape(TensorDim(
+      {batch_size, num_heads, step_height, projected_value_dim_prop}));
+
+    attention_output_step = attention_output_step.transpose("1:0:2");
+  }
 
   attention_output_step.reshape(TensorDim(
     {batch_size * (to - from), 1, 1, num_heads * projected_value_dim_prop}));
@@ -788,6 +1312,7 @@ void MultiHeadAttentionLayer::calcCommonDerivative(RunLayerContext &context) {
 
   const bool provide_attention_mask = context.getNumInputs() == 4;
   const unsigned int projected_query_dim_prop = projected_key_dim_prop;
+  const bool enable_dropout = dropout_rate > epsilon;
 
   Tensor empty_tensor;
 
@@ -816,12 +1341,55 @@ void MultiHeadAttentionLayer::calcCommonDerivative(RunLayerContext &context) {
   Tensor &d_projected_value =
     context.getTensorGrad(weight_idx[AttentionParams::projected_value]);
 
+  if (tiled_attention) {
+    Tensor &mask = provide_attention_mask
+                     ? context.getInput(INOUT_INDEX::MASK)
+                     : empty_tensor;
+    Tensor &d_mask = provide_attention_mask
+                       ? context.getOutgoingDerivative(INOUT_INDEX::MASK)
+                       : empty_tensor;
+    Tensor &attention_output =
+      context.getTensor(weight_idx[AttentionParams::attention_output]);
+    Tensor &d_attention_output =
+      context.getTensorGrad(weight_idx[AttentionParams::attention_output]);
+    Tensor &attention_lse =
+      context.getTensor(weight_idx[AttentionParams::attention_lse]);
+
+    const unsigned int batch_size = query.getDim().batch();
+    const unsigned int query_height = query.getDim().height();
+    const unsigned int key_height = key.getDim().height();
+    const FlashAttentionDim attention_dim = {
+      batch_size, num_heads, query_height, key_height, key_height,
+      projected_query_dim_prop, projected_value_dim_prop};
+
+    d_attention_output.dot_deriv_wrt_1(fc_weight, incoming_derivative);
+
+    /** attention weight is recomputed tile by tile from the saved lse */
+    flashAttentionDeriv(attention_dim, projected_query, projected_key,
+                        projected_value, mask,
+                        1 / sqrt((float)projected_query_dim_prop), -1,
+                        attention_output, attention_lse, d_attention_output,
+                        d_projected_query, d_projected_key, d_projected_value,
+                        d_mask);
+    return;
+  }
+
   Tensor &attention_weight =
     context.getTensor(weight_idx[AttentionParams::attention_weight]);
   Tensor &d_attention_weight =
     context.getTensorGrad(weight_idx[AttentionParams::attention_weight]);
   Tensor &d_attention_output =
     context.getTensorGrad(weight_idx[AttentionParams::attention_output]);
+  Tensor &dropped_attention_weight =
+    enable_dropout
+      ? context.getTensor(weight_idx[AttentionParams::dropout_mask])
+      : empty_tensor;
+  /** attention weight which was multiplied with the value */
+  Tensor &applied_attention_weight =
+    enable_dropout ? dropped_attention_weight : attention_weight;
+  Tensor &d_mask = provide_attention_mask
+                     ? context.getOutgoingDerivative(INOUT_INDEX::MASK)
+                     : empty_tensor;
 
   const TensorDim query_dim = query.getDim();
   const unsigned int batch_size = query_dim.batch();
@@ -861,11 +1429,15 @@ void MultiHeadAttentionLayer::calcCommonDerivative(RunLayerContext &context) {
     TensorDim({batch_size * num_heads, 1, query_height, key_height}));
   d_attention_output.reshape(TensorDim(
     {batch_size * num_heads, 1, query_height, projected_value_dim_prop}));
+  if (enable_dropout) {
+    dropped_attention_weight.reshape(
+      TensorDim({batch_size * num_heads, 1, query_height, key_height}));
+  }
 
   d_attention_weight.dot_batched_deriv_wrt_1(projected_value,
                                              d_attention_output);
-  attention_weight.dot_batched_deriv_wrt_2(d_projected_value,
-                                           d_attention_output);
+  applied_attention_weight.dot_batched_deriv_wrt_2(d_projected_value,
+                                                   d_attention_output);
 
   if (return_attention_weight ==
       props::ReturnAttentionWeightInfo::Enum::after) {
@@ -873,24 +1445,14 @@ void MultiHeadAttentionLayer::calcCommonDerivative(RunLayerContext &context) {
     d_attention_weight.add_i(d_ret_attention_weight, scale);
   }
 
-  if (dropout_rate > epsilon) {
-    Tensor &dropout_mask =
-      context.getTensor(weight_idx[AttentionParams::dropout_mask]);
-    d_attention_weight.multiply_i(dropout_mask);
-  }
-
-  if (return_attention_weight ==
-      props::ReturnAttentionWeightInfo::Enum::before) {
-    d_attention_weight.add_i(d_ret_attention_weight);
-  }
-
-  sm.run_prime_fn(attention_weight, d_attention_weight, d_attention_weight);
-  if (provide_attention_mask) {
-    Tensor &d_mask = context.getOutgoingDerivative(INOUT_INDEX::MASK);
-    d_mask.copyData(d_attention_weight);
-  }
-  d_attention_weight.multiply_i(
-    1 / sqrt((float)projected_query_dim_prop)); /** scale */
+  /** dropout, softmax, mask and scale derivative in a single pass per row */
+  attentionSoftmaxDeriv(
+    attention_weight, dropped_attention_weight,
+    enable_dropout ? dropout_rate : 0.0f, d_attention_weight,
+    return_attention_weight == props::ReturnAttentionWeightInfo::Enum::before
+      ? d_ret_attention_weight
+      : empty_tensor,
+    1 / sqrt((float)projected_query_dim_prop), d_mask);
 
   d_projected_query.dot_batched_deriv_wrt_1(projected_key, d_attention_weight,
                                             false, true);
@@ -932,6 +1494,10 @@ void MultiHeadAttentionLayer::calcCommonDerivative(RunLayerContext &context) {
     TensorDim({batch_size, num_heads, query_height, key_height}));
   d_attention_weight.reshape(
     TensorDim({batch_size, num_heads, query_height, key_height}));
+  if (enable_dropout) {
+    dropped_attention_weight.reshape(
+      TensorDim({batch_size, num_heads, query_height, key_height}));
+  }
   d_attention_output.reshape(TensorDim(
     {batch_size, 1, query_height, num_heads * projected_value_dim_prop}));
 }
@@ -1109,7 +1675,17 @@ void MultiHeadAttentionLayer::setBatch(RunLayerContext &context,
   context.updateTensor(weight_idx[AttentionParams::cache_key], batch);
   context.updateTensor(weight_idx[AttentionParams::cache_value], batch);
   // context.updateTensor(weight_idx[AttentionParams::cache_value], batch);
-  context.updateTensor(weight_idx[AttentionParams::attention_weight], batch);
+  if (std::get<props::KVCacheDataType>(multi_head_attention_props).get() ==
+      props::KVCacheDataTypeInfo::Enum::int8) {
+    context.updateTensor(weight_idx[AttentionParams::cache_key_scale], batch);
+    context.updateTensor(weight_idx[AttentionParams::cache_value_scale],
+                         batch);
+  }
+  if (tiled_attention) {
+    context.updateTensor(weight_idx[AttentionParams::attention_lse], batch);
+  } else {
+    context.updateTensor(weight_idx[AttentionParams::attention_weight], batch);
+  }
   if (dropout_rate > epsilon) {
     context.updateTensor(weight_idx[AttentionParams::dropout_mask], batch);
   }
@@ -16,7 +16,6 @@
 #define __MULTI_HEAD_ATTENTION_LAYER_H__
 #ifdef __cplusplus
 
-#include <acti_func.h>
 #include <layer_impl.h>
 
 namespace nntrainer {
@@ -111,13 +110,16 @@ public:
 private:
   std::tuple<props::NumHeads, props::ProjectedKeyDim, props::ProjectedValueDim,
              props::OutputShape, props::DropOutRate,
-             props::ReturnAttentionWeight, props::AverageAttentionWeight>
+             props::ReturnAttentionWeight, props::AverageAttentionWeight,
+             props::MaxTimestep, props::KVCacheDataType>
     multi_head_attention_props; /**< multi_head_attention layer properties */
 
-  ActiFunc sm; /** softmax activation operation */
-  std::array<unsigned int, 16>
+  std::array<unsigned int, 19>
     weight_idx; /**< indices of the weights and tensors */
 
+  bool tiled_attention; /**< compute attention tile by tile without storing
+                           the attention weight */
+
   /**
    * @brief     to protect overflow
    */
@@ -122,6 +122,20 @@ public:
    */
   bool supportInPlace() const override { return layerImpl->supportInPlace(); }
 
+  /**
+   * @copydoc Layer::supportRecompute()
+   */
+  bool supportRecompute() const override {
+    return layerImpl->supportRecompute();
+  }
+
+  /**
+   * @copydoc Layer::isRandomInTraining()
+   */
+  bool isRandomInTraining() const override {
+    return layerImpl->isRandomInTraining();
+  }
+
   /**
    * @copydoc Layer::requireLabel()
    */
@@ -89,6 +89,11 @@ public:
    */
   void setProperty(const std::vector<std::string> &values) override;
 
+  /**
+   * @copydoc Layer::isRandomInTraining()
+   */
+  bool isRandomInTraining() const override { return true; }
+
   inline static const std::string type = "preprocess_flip";
 
 private:
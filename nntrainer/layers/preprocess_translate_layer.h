@@ -93,6 +93,14 @@ public:
    */
   void setProperty(const std::vector<std::string> &values) override;
 
+  /**
+   * @copydoc Layer::isRandomInTraining()
+   */
+  bool isRandomInTraining() const override {
+    return std::get<props::RandomTranslate>(preprocess_translate_props).get() >=
+           epsilon;
+  }
+
   inline static const std::string type = "preprocess_translate";
 
 private:
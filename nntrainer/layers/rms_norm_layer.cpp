@@ -0,0 +1,208 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   rms_norm_layer.cpp
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ *         https://arxiv.org/abs/1910.07467
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  This is RMS Normalization Layer Class for Neural Network
+ *
+ */
+
+#include <layer_context.h>
+#include <nntrainer_error.h>
+#include <nntrainer_log.h>
+#include <node_exporter.h>
+#include <normalization_kernel.h>
+#include <rms_norm_layer.h>
+
+namespace nntrainer {
+
+static constexpr size_t SINGLE_INOUT_IDX = 0;
+
+enum RMSParams {
+  gamma,
+  inv_rms,
+  normalized,
+};
+
+/**
+ * @brief normalize the rows of the [rows, width] view of the input starting
+ * at the offset. normalized and inv_rms are nullptr if not needed
+ */
+static void rmsNormalize(const Tensor &input, Tensor *normalized,
+                         Tensor &output, const Tensor &gamma, Tensor *inv_rms,
+                         size_t offset, unsigned int rows, float epsilon) {
+  unsigned int cols = gamma.size();
+
+  normalization_dispatch(
+    input.getDataType(), gamma.getDataType(), [&](auto t, auto p) {
+      using T = decltype(t);
+      using P = decltype(p);
+      rms_norm_forward<T, P>(
+        input.getData<T>() + offset,
+        normalized ? normalized->getData<T>() + offset : nullptr,
+        output.getData<T>() + offset, rows, cols, gamma.getData<P>(),
+        inv_rms ? inv_rms->getData<P>() + offset / cols : nullptr, epsilon);
+    });
+}
+
+RMSNormLayer::RMSNormLayer() :
+  Layer(),
+  rms_norm_props(props::Epsilon(), props::BNPARAMS_GAMMA_INIT(),
+                 props::WeightDecay()) {
+  wt_idx.fill(std::numeric_limits<unsigned>::max());
+}
+
+void RMSNormLayer::finalize(InitLayerContext &context) {
+  NNTR_THROW_IF(context.getNumInputs() != 1, std::invalid_argument)
+    << "Only one input is allowed for rms norm layer";
+  NNTR_THROW_IF(context.getFormat() != ml::train::TensorDim::Format::NCHW,
+                std::invalid_argument)
+    << "[RMSNorm] only NCHW format is supported";
+
+  auto gamma_initializer =
+    std::get<props::BNPARAMS_GAMMA_INIT>(rms_norm_props).get();
+  auto weight_decay = std::get<props::WeightDecay>(rms_norm_props);
+
+  auto const &input_dim = context.getInputDimensions()[0];
+  context.setOutputDimensions({input_dim});
+
+  TensorDim gamma_dim(1, 1, 1, input_dim.width(),
+                      TensorDim::TensorType(context.getFormat(),
+                                            context.getWeightDataType()));
+  wt_idx[RMSParams::gamma] =
+    context.requestWeight(gamma_dim, gamma_initializer, WeightRegularizer::NONE,
+                          1.0f, weight_decay, "gamma", true);
+
+  /** caches the normalized input, the input may be overwritten in place */
+  wt_idx[RMSParams::normalized] =
+    context.requestTensor(input_dim, "normalized", Tensor::Initializer::NONE,
+                          false, TensorLifespan::ITERATION_LIFESPAN);
+
+  /** caches the inverse root mean square of every row */
+  TensorDim inv_rms_dim = input_dim;
+  inv_rms_dim.width(1);
+  inv_rms_dim.setDataType(context.getWeightDataType());
+  wt_idx[RMSParams::inv_rms] =
+    context.requestTensor(inv_rms_dim, "inv_rms", Tensor::Initializer::NONE,
+                          false, TensorLifespan::ITERATION_LIFESPAN);
+}
+
+void RMSNormLayer::setProperty(const std::vector<std::string> &values) {
+  auto remain_props = loadProperties(values, rms_norm_props);
+  NNTR_THROW_IF(!remain_props.empty(), std::invalid_argument)
+    << "[RMSNorm] Unknown Layer Properties count " +
+         std::to_string(values.size());
+}
+
+void RMSNormLayer::forwarding(RunLayerContext &context, bool training) {
+  const float epsilon = std::get<props::Epsilon>(rms_norm_props).get();
+
+  const Tensor &input = context.getInput(SINGLE_INOUT_IDX);
+  Tensor &output = context.getOutput(SINGLE_INOUT_IDX);
+  const Tensor &gamma = context.getWeight(wt_idx[RMSParams::gamma]);
+
+  Tensor &normalized = context.getTensor(wt_idx[RMSParams::normalized]);
+  Tensor &inv_rms = context.getTensor(wt_idx[RMSParams::inv_rms]);
+
+  rmsNormalize(input, training ? &normalized : nullptr, output, gamma,
+               training ? &inv_rms : nullptr, 0, input.size() / gamma.size(),
+               epsilon);
+}
+
+void RMSNormLayer::incremental_forwarding(RunLayerContext &context,
+                                          unsigned int from, unsigned int to,
+                                          bool training) {
+  const float epsilon = std::get<props::Epsilon>(rms_norm_props).get();
+
+  const Tensor &input = context.getInput(SINGLE_INOUT_IDX);
+  Tensor &output = context.getOutput(SINGLE_INOUT_IDX);
+  const Tensor &gamma = context.getWeight(wt_idx[RMSParams::gamma]);
+
+  if (from) {
+    to -= from;
+    from = 0;
+  }
+
+  const TensorDim &dim = input.getDim();
+  NNTR_THROW_IF(to > dim.height(), std::invalid_argument)
+    << "[RMSNorm] incremental step of " << to
+    << " rows exceeds the input height: " << dim.height();
+
+  /** only the rows of the step are normalized in every batch and channel */
+  for (unsigned int b = 0; b < dim.batch(); ++b) {
+    for (unsigned int c = 0; c < dim.channel(); ++c) {
+      size_t offset = input.getIndex(b, c, 0, 0);
+      rmsNormalize(input, nullptr, output, gamma, nullptr, offset, to,
+                   epsilon);
+    }
+  }
+}
+
+void RMSNormLayer::calcDerivative(RunLayerContext &context) {
+  Tensor &outgoing_derivative = context.getOutgoingDerivative(SINGLE_INOUT_IDX);
+  const Tensor &incoming_derivative =
+    context.getIncomingDerivative(SINGLE_INOUT_IDX);
+
+  const Tensor &gamma = context.getWeight(wt_idx[RMSParams::gamma]);
+  const Tensor &normalized = context.getTensor(wt_idx[RMSParams::normalized]);
+  const Tensor &inv_rms = context.getTensor(wt_idx[RMSParams::inv_rms]);
+
+  unsigned int cols = gamma.size();
+  unsigned int rows = incoming_derivative.size() / cols;
+
+  normalization_dispatch(
+    incoming_derivative.getDataType(), gamma.getDataType(),
+    [&](auto t, auto p) {
+      using T = decltype(t);
+      using P = decltype(p);
+      rms_norm_backward<T, P>(incoming_derivative.getData<T>(),
+                              normalized.getData<T>(),
+                              outgoing_derivative.getData<T>(), rows, cols,
+                              gamma.getData<P>(), inv_rms.getData<P>(),
+                              nullptr);
+    });
+}
+
+void RMSNormLayer::calcGradient(RunLayerContext &context) {
+  /** computed before calcDerivative overwrites the incoming derivative in
+   * place */
+  const Tensor &incoming_derivative =
+    context.getIncomingDerivative(SINGLE_INOUT_IDX);
+  const Tensor &gamma = context.getWeight(wt_idx[RMSParams::gamma]);
+  const Tensor &normalized = context.getTensor(wt_idx[RMSParams::normalized]);
+  const Tensor &inv_rms = context.getTensor(wt_idx[RMSParams::inv_rms]);
+  Tensor &d_gamma = context.getWeightGrad(wt_idx[RMSParams::gamma]);
+
+  unsigned int cols = gamma.size();
+  unsigned int rows = incoming_derivative.size() / cols;
+
+  /** the kernel accumulates to the gradient shared over the accesses */
+  if (context.isGradientFirstAccess(wt_idx[RMSParams::gamma]))
+    d_gamma.setZero();
+
+  normalization_dispatch(
+    incoming_derivative.getDataType(), gamma.getDataType(),
+    [&](auto t, auto p) {
+      using T = decltype(t);
+      using P = decltype(p);
+      rms_norm_backward<T, P>(incoming_derivative.getData<T>(),
+                              normalized.getData<T>(), nullptr, rows, cols,
+                              gamma.getData<P>(), inv_rms.getData<P>(),
+                              d_gamma.getData<P>());
+    });
+}
+
+void RMSNormLayer::exportTo(Exporter &exporter,
+                            const ml::train::ExportMethods &method) const {
+  exporter.saveResult(rms_norm_props, method, this);
+}
+
+void RMSNormLayer::setBatch(RunLayerContext &context, unsigned int batch) {
+  context.updateTensor(wt_idx[RMSParams::normalized], batch);
+  context.updateTensor(wt_idx[RMSParams::inv_rms], batch);
+}
+
+} /* namespace nntrainer */
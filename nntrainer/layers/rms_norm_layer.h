@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   rms_norm_layer.h
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ *         https://arxiv.org/abs/1910.07467
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  This is RMS Normalization Layer Class for Neural Network
+ *
+ */
+
+#ifndef __RMS_NORM_LAYER_H__
+#define __RMS_NORM_LAYER_H__
+#ifdef __cplusplus
+
+#include <array>
+
+#include <common_properties.h>
+#include <layer_devel.h>
+
+namespace nntrainer {
+
+/**
+ * @class   RMSNormLayer
+ * @brief   RMS Normalization Layer, scales every row of the width by the
+ * inverse of its root mean square and by gamma
+ */
+class RMSNormLayer : public Layer {
+public:
+  /**
+   * @brief     Constructor of RMSNormLayer
+   */
+  RMSNormLayer();
+
+  /**
+   * @brief     Destructor of RMSNormLayer
+   */
+  ~RMSNormLayer() {}
+
+  /**
+   * @brief  Move constructor of RMSNormLayer
+   * @param[in] rhs RMSNormLayer to be moved
+   */
+  RMSNormLayer(RMSNormLayer &&rhs) noexcept = default;
+
+  /**
+   * @brief  Move assignment operator
+   * @param[in] rhs RMSNormLayer to be moved
+   */
+  RMSNormLayer &operator=(RMSNormLayer &&rhs) = default;
+
+  /**
+   * @copydoc Layer::finalize(InitLayerContext &context)
+   */
+  void finalize(InitLayerContext &context) override;
+
+  /**
+   * @copydoc Layer::forwarding(RunLayerContext &context, bool training)
+   */
+  void forwarding(RunLayerContext &context, bool training) override;
+
+  /**
+   * @copydoc Layer::incremental_forwarding(RunLayerContext &context, unsigned
+   * int from, unsigned int to, bool training)
+   */
+  void incremental_forwarding(RunLayerContext &context, unsigned int from,
+                              unsigned int to, bool training) override;
+
+  /**
+   * @copydoc Layer::calcDerivative(RunLayerContext &context)
+   */
+  void calcDerivative(RunLayerContext &context) override;
+
+  /**
+   * @copydoc Layer::calcGradient(RunLayerContext &context)
+   */
+  void calcGradient(RunLayerContext &context) override;
+
+  /**
+   * @copydoc Layer::exportTo(Exporter &exporter, const ml::train::ExportMethods
+   * method)
+   */
+  void exportTo(Exporter &exporter,
+                const ml::train::ExportMethods &method) const override;
+
+  /**
+   * @copydoc Layer::getType()
+   */
+  const std::string getType() const override { return RMSNormLayer::type; };
+
+  /**
+   * @copydoc Layer::supportBackwarding()
+   */
+  bool supportBackwarding() const override { return true; }
+
+  using Layer::setProperty;
+
+  /**
+   * @copydoc Layer::setProperty(const std::vector<std::string> &values)
+   */
+  void setProperty(const std::vector<std::string> &values) override;
+
+  /**
+   * @copydoc Layer::supportInPlace()
+   */
+  bool supportInPlace() const override { return true; }
+
+  /**
+   * @copydoc Layer::setBatch(RunLayerContext &context, unsigned int batch)
+   */
+  void setBatch(RunLayerContext &context, unsigned int batch) override;
+
+  inline static const std::string type = "rms_norm";
+
+private:
+  std::array<unsigned int, 3> wt_idx;
+  std::tuple<props::Epsilon, props::BNPARAMS_GAMMA_INIT, props::WeightDecay>
+    rms_norm_props;
+};
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __RMS_NORM_LAYER_H__ */
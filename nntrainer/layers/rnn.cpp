@@ -16,6 +16,7 @@
 #include <nntrainer_error.h>
 #include <nntrainer_log.h>
 #include <node_exporter.h>
+#include <recurrent_kernel.h>
 #include <rnn.h>
 #include <util_func.h>
 
@@ -193,43 +194,94 @@ void RNNLayer::forwarding(RunLayerContext &context, bool training) {
 
   Tensor &hidden_state = context.getTensor(wt_idx[RNNParams::hidden_state]);
 
-  // TODO: swap batch and timestep index with transpose
-  for (unsigned int batch = 0; batch < batch_size; ++batch) {
-    Tensor input_slice = input.getBatchSlice(batch, 1);
-    Tensor hidden_state_slice = hidden_state.getBatchSlice(batch, 1);
+  RecurrentActivation act;
+  if (input.getDataType() == TensorDim::DataType::FP32 &&
+      acti_func.getElementwiseFn(act.fn, act.prime)) {
+    const unsigned int ld_state = max_timestep * unit;
+
+    std::vector<float> bias;
+    if (!disable_bias) {
+      if (integrate_bias) {
+        bias.assign(bias_h.getData<float>(), bias_h.getData<float>() + unit);
+      } else {
+        bias.assign(bias_ih.getData<float>(), bias_ih.getData<float>() + unit);
+        const float *bias_hh_data = bias_hh.getData<float>();
+        for (unsigned int i = 0; i < unit; ++i)
+          bias[i] += bias_hh_data[i];
+      }
+    }
 
-    for (unsigned int timestep = 0; timestep < max_timestep; ++timestep) {
-      Tensor in = input_slice.getSharedDataTensor({feature_size},
-                                                  timestep * feature_size);
-      Tensor hs =
-        hidden_state_slice.getSharedDataTensor({unit}, timestep * unit);
+    /** input projection of every timestep as a single gemm */
+    float *hs_data = hidden_state.getData<float>();
+    recurrent_projection(batch_size * max_timestep, feature_size, unit,
+                         input.getData<float>(), weight_ih.getData<float>(),
+                         disable_bias ? nullptr : bias.data(), hs_data);
+
+    const bool enable_dropout = dropout_rate > epsilon && training;
+    const float *mask_data = nullptr;
+    unsigned int mask_height = 0;
+    if (enable_dropout) {
+      Tensor &mask = context.getTensor(wt_idx[RNNParams::dropout_mask]);
+      mask.dropout_mask(dropout_rate);
+      mask_data = mask.getData<float>();
+      mask_height = mask.height();
+    }
 
-      in.dot(weight_ih, hs);
-      if (!disable_bias) {
-        if (integrate_bias) {
-          hs.add_i(bias_h);
-        } else {
-          hs.add_i(bias_ih);
-          hs.add_i(bias_hh);
+    for (unsigned int timestep = 0; timestep < max_timestep; ++timestep) {
+      float *h = hs_data + timestep * unit;
+      rnn_step_forward(batch_size, unit, timestep ? h - unit : nullptr, h,
+                       ld_state, weight_hh.getData<float>(), act);
+
+      if (enable_dropout) {
+        const unsigned int mask_t =
+          mask_height == max_timestep ? timestep : 0;
+        for (unsigned int b = 0; b < batch_size; ++b) {
+          const float *m = mask_data + (b * mask_height + mask_t) * unit;
+          for (unsigned int u = 0; u < unit; ++u)
+            h[b * ld_state + u] *= m[u];
         }
       }
+    }
+  } else {
+    // TODO: swap batch and timestep index with transpose
+    for (unsigned int batch = 0; batch < batch_size; ++batch) {
+      Tensor input_slice = input.getBatchSlice(batch, 1);
+      Tensor hidden_state_slice = hidden_state.getBatchSlice(batch, 1);
+
+      for (unsigned int timestep = 0; timestep < max_timestep; ++timestep) {
+        Tensor in = input_slice.getSharedDataTensor({feature_size},
+                                                    timestep * feature_size);
+        Tensor hs =
+          hidden_state_slice.getSharedDataTensor({unit}, timestep * unit);
+
+        in.dot(weight_ih, hs);
+        if (!disable_bias) {
+          if (integrate_bias) {
+            hs.add_i(bias_h);
+          } else {
+            hs.add_i(bias_ih);
+            hs.add_i(bias_hh);
+          }
+        }
 
-      if (timestep) {
-        Tensor prev_hs =
-          hidden_state_slice.getSharedDataTensor({unit}, (timestep - 1) * unit);
-        prev_hs.dot(weight_hh, hs, false, false, 1.0);
-      }
-
-      // In-place calculation for activation
-      acti_func.run_fn(hs, hs);
+        if (timestep) {
+          Tensor prev_hs = hidden_state_slice.getSharedDataTensor(
+            {unit}, (timestep - 1) * unit);
+          prev_hs.dot(weight_hh, hs, false, false, 1.0);
+        }
 
-      if (dropout_rate > epsilon && training) {
-        Tensor dropout_mask = context.getTensor(wt_idx[RNNParams::dropout_mask])
-                                .getBatchSlice(batch, 1);
-        Tensor dropout_mask_t =
-          dropout_mask.getSharedDataTensor({unit}, timestep * unit);
-        dropout_mask_t.dropout_mask(dropout_rate);
-        hs.multiply_i(dropout_mask_t);
+        // In-place calculation for activation
+        acti_func.run_fn(hs, hs);
+
+        if (dropout_rate > epsilon && training) {
+          Tensor dropout_mask =
+            context.getTensor(wt_idx[RNNParams::dropout_mask])
+              .getBatchSlice(batch, 1);
+          Tensor dropout_mask_t =
+            dropout_mask.getSharedDataTensor({unit}, timestep * unit);
+          dropout_mask_t.dropout_mask(dropout_rate);
+          hs.multiply_i(dropout_mask_t);
+        }
       }
     }
   }
@@ -322,6 +374,42 @@ void RNNLayer::calcGradient(RunLayerContext &context) {
 
   Tensor &hidden_state = context.getTensor(wt_idx[RNNParams::hidden_state]);
 
+  RecurrentActivation act;
+  if (input.getDataType() == TensorDim::DataType::FP32 &&
+      acti_func.getElementwiseFn(act.fn, act.prime)) {
+    const unsigned int feature_size = input_dim.width();
+    const unsigned int ld_state = max_timestep * unit;
+    const float *hs_data = hidden_state.getData<float>();
+    float *d_hs_data = hidden_state_derivative.getData<float>();
+
+    for (unsigned int timestep = max_timestep; timestep-- > 0;) {
+      const size_t offset = timestep * unit;
+      rnn_step_backward(
+        batch_size, unit, timestep ? hs_data + offset - unit : nullptr,
+        hs_data + offset, d_hs_data + offset,
+        timestep ? d_hs_data + offset - unit : nullptr, ld_state,
+        weight_hh.getData<float>(), djdweight_hh.getData<float>(), act);
+    }
+
+    /** gradients of the input projection over every timestep at once */
+    const unsigned int rows = batch_size * max_timestep;
+    recurrent_projection_gradient(rows, feature_size, unit,
+                                  input.getData<float>(), d_hs_data,
+                                  djdweight_ih.getData<float>());
+    if (!disable_bias) {
+      if (integrate_bias) {
+        recurrent_column_sum(rows, unit, d_hs_data, unit,
+                             djdbias_h.getData<float>());
+      } else {
+        recurrent_column_sum(rows, unit, d_hs_data, unit,
+                             djdbias_ih.getData<float>());
+        recurrent_column_sum(rows, unit, d_hs_data, unit,
+                             djdbias_hh.getData<float>());
+      }
+    }
+    return;
+  }
+
   for (unsigned int batch = 0; batch < batch_size; ++batch) {
     Tensor deriv_t = hidden_state_derivative.getBatchSlice(batch, 1);
     Tensor input_t = input.getBatchSlice(batch, 1);
@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   rotary_embedding_layer.cpp
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ *         https://arxiv.org/abs/2104.09864
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  This is Rotary Embedding Layer Class for Neural Network
+ *
+ */
+
+#include <cmath>
+
+#include <layer_context.h>
+#include <nntrainer_error.h>
+#include <nntrainer_log.h>
+#include <node_exporter.h>
+#include <rotary_embedding_layer.h>
+#include <util_simd.h>
+
+namespace nntrainer {
+
+static constexpr size_t SINGLE_INOUT_IDX = 0;
+
+RotaryEmbeddingLayer::RotaryEmbeddingLayer() :
+  Layer(),
+  head_dim(0),
+  rotary_props(props::NumHeads(), props::RopeTheta()) {}
+
+void RotaryEmbeddingLayer::finalize(InitLayerContext &context) {
+  NNTR_THROW_IF(context.getNumInputs() != 1, std::invalid_argument)
+    << "Only one input is allowed for rotary embedding layer";
+  NNTR_THROW_IF(context.getFormat() != ml::train::TensorDim::Format::NCHW,
+                std::invalid_argument)
+    << "[RotaryEmbedding] only NCHW format is supported";
+
+  const unsigned int num_heads = std::get<props::NumHeads>(rotary_props).get();
+  const float theta = std::get<props::RopeTheta>(rotary_props).get();
+
+  auto const &input_dim = context.getInputDimensions()[0];
+  NNTR_THROW_IF(input_dim.width() % (2 * num_heads), std::invalid_argument)
+    << "[RotaryEmbedding] width: " << input_dim.width()
+    << " is not divisible into " << num_heads << " heads of even dimension";
+
+  context.setOutputDimensions({input_dim});
+
+  head_dim = input_dim.width() / num_heads;
+  const unsigned int half = head_dim / 2;
+
+  freqs.resize(half);
+  for (unsigned int i = 0; i < half; ++i)
+    freqs[i] = std::pow(theta, -2.0f * i / head_dim);
+
+  cosine.clear();
+  sine.clear();
+  reserve(input_dim.height() - 1);
+}
+
+void RotaryEmbeddingLayer::setProperty(const std::vector<std::string> &values) {
+  auto remain_props = loadProperties(values, rotary_props);
+  NNTR_THROW_IF(!remain_props.empty(), std::invalid_argument)
+    << "[RotaryEmbedding] Unknown Layer Properties count " +
+         std::to_string(values.size());
+}
+
+void RotaryEmbeddingLayer::reserve(unsigned int position) {
+  const unsigned int half = freqs.size();
+  size_t positions = cosine.size() / half;
+  if (position < positions)
+    return;
+
+  cosine.resize((size_t)(position + 1) * half);
+  sine.resize((size_t)(position + 1) * half);
+  for (size_t p = positions; p <= position; ++p) {
+    for (unsigned int i = 0; i < half; ++i) {
+      float angle = p * freqs[i];
+      cosine[p * half + i] = std::cos(angle);
+      sine[p * half + i] = std::sin(angle);
+    }
+  }
+}
+
+void RotaryEmbeddingLayer::rotate(RunLayerContext &context, Tensor &tensor,
+                                  unsigned int rows, unsigned int from,
+                                  bool inverse) {
+  const TensorDim &dim = tensor.getDim();
+  const unsigned int half = freqs.size();
+  const unsigned int width = dim.width();
+
+  const std::vector<unsigned int> &positions =
+    context.getIncrementalPositions();
+  NNTR_THROW_IF(!positions.empty() && positions.size() != dim.batch(),
+                std::invalid_argument)
+    << "number of positions: " << positions.size()
+    << " is not matched with the batch size: " << dim.batch()
+    << " for layer " << context.getName();
+
+  for (unsigned int b = 0; b < dim.batch(); ++b) {
+    const unsigned int start = positions.empty() ? from : positions[b];
+    reserve(start + rows - 1);
+
+    for (unsigned int c = 0; c < dim.channel(); ++c) {
+      for (unsigned int h = 0; h < rows; ++h) {
+        const float *cos_ = cosine.data() + (size_t)(start + h) * half;
+        const float *sin_ = sine.data() + (size_t)(start + h) * half;
+        size_t offset = tensor.getIndex(b, c, h, 0);
+
+        if (tensor.getDataType() == ml::train::TensorDim::DataType::FP32) {
+          float *row = tensor.getData<float>() + offset;
+          for (unsigned int w = 0; w < width; w += head_dim)
+            rotary_emb(half, row + w, cos_, sin_, inverse);
+        } else if (tensor.getDataType() ==
+                   ml::train::TensorDim::DataType::FP16) {
+#ifdef ENABLE_FP16
+          _FP16 *row = tensor.getData<_FP16>() + offset;
+          for (unsigned int w = 0; w < width; w += head_dim)
+            rotary_emb(half, row + w, cos_, sin_, inverse);
+#else
+          throw std::invalid_argument("Error: enable-fp16 is not enabled");
+#endif
+        }
+      }
+    }
+  }
+}
+
+void RotaryEmbeddingLayer::forwarding(RunLayerContext &context,
+                                      bool training) {
+  const Tensor &input = context.getInput(SINGLE_INOUT_IDX);
+  Tensor &output = context.getOutput(SINGLE_INOUT_IDX);
+
+  if (output.getData() != input.getData())
+    output.copyData(input);
+
+  rotate(context, output, output.height(), 0, false);
+}
+
+void RotaryEmbeddingLayer::incremental_forwarding(RunLayerContext &context,
+                                                  unsigned int from,
+                                                  unsigned int to,
+                                                  bool training) {
+  const Tensor &input = context.getInput(SINGLE_INOUT_IDX);
+  Tensor &output = context.getOutput(SINGLE_INOUT_IDX);
+
+  /** the rows of the step start at the row 0, at the position from */
+  const unsigned int position = from;
+  if (from) {
+    to -= from;
+    from = 0;
+  }
+
+  NNTR_THROW_IF(to > input.height(), std::invalid_argument)
+    << "[RotaryEmbedding] incremental step of " << to
+    << " rows exceeds the input height: " << input.height();
+
+  if (output.getData() != input.getData())
+    output.copyData(input);
+
+  rotate(context, output, to, position, false);
+}
+
+void RotaryEmbeddingLayer::calcDerivative(RunLayerContext &context) {
+  const Tensor &incoming_derivative =
+    context.getIncomingDerivative(SINGLE_INOUT_IDX);
+  Tensor &outgoing_derivative = context.getOutgoingDerivative(SINGLE_INOUT_IDX);
+
+  if (outgoing_derivative.getData() != incoming_derivative.getData())
+    outgoing_derivative.copyData(incoming_derivative);
+
+  /** the rotation is orthogonal, its transpose rotates by the negated angles */
+  rotate(context, outgoing_derivative, outgoing_derivative.height(), 0, true);
+}
+
+void RotaryEmbeddingLayer::exportTo(
+  Exporter &exporter, const ml::train::ExportMethods &method) const {
+  exporter.saveResult(rotary_props, method, this);
+}
+
+} /* namespace nntrainer */
@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   rotary_embedding_layer.h
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ *         https://arxiv.org/abs/2104.09864
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  This is Rotary Embedding Layer Class for Neural Network
+ *
+ */
+
+#ifndef __ROTARY_EMBEDDING_LAYER_H__
+#define __ROTARY_EMBEDDING_LAYER_H__
+#ifdef __cplusplus
+
+#include <vector>
+
+#include <common_properties.h>
+#include <layer_devel.h>
+
+namespace nntrainer {
+
+/**
+ * @class   RotaryEmbeddingLayer
+ * @brief   Rotary Embedding Layer, rotates every head of the projected query
+ * or key by the angles of its position
+ *
+ * The width of the input holds num_heads heads one after another, as given by
+ * a fully connected layer, so no reshape or transpose is needed before the
+ * layer. The pairs (x[i], x[i + head_dim / 2]) of a head at position p are
+ * rotated by p * rope_theta ^ (-2i / head_dim). The rotation is done in place.
+ */
+class RotaryEmbeddingLayer : public Layer {
+public:
+  /**
+   * @brief     Constructor of RotaryEmbeddingLayer
+   */
+  RotaryEmbeddingLayer();
+
+  /**
+   * @brief     Destructor of RotaryEmbeddingLayer
+   */
+  ~RotaryEmbeddingLayer() {}
+
+  /**
+   * @brief  Move constructor of RotaryEmbeddingLayer
+   * @param[in] rhs RotaryEmbeddingLayer to be moved
+   */
+  RotaryEmbeddingLayer(RotaryEmbeddingLayer &&rhs) noexcept = default;
+
+  /**
+   * @brief  Move assignment operator
+   * @param[in] rhs RotaryEmbeddingLayer to be moved
+   */
+  RotaryEmbeddingLayer &operator=(RotaryEmbeddingLayer &&rhs) = default;
+
+  /**
+   * @copydoc Layer::finalize(InitLayerContext &context)
+   */
+  void finalize(InitLayerContext &context) override;
+
+  /**
+   * @copydoc Layer::forwarding(RunLayerContext &context, bool training)
+   */
+  void forwarding(RunLayerContext &context, bool training) override;
+
+  /**
+   * @copydoc Layer::incremental_forwarding(RunLayerContext &context, unsigned
+   * int from, unsigned int to, bool training)
+   */
+  void incremental_forwarding(RunLayerContext &context, unsigned int from,
+                              unsigned int to, bool training) override;
+
+  /**
+   * @copydoc Layer::calcDerivative(RunLayerContext &context)
+   */
+  void calcDerivative(RunLayerContext &context) override;
+
+  /**
+   * @copydoc Layer::exportTo(Exporter &exporter, const ml::train::ExportMethods
+   * method)
+   */
+  void exportTo(Exporter &exporter,
+                const ml::train::ExportMethods &method) const override;
+
+  /**
+   * @copydoc Layer::getType()
+   */
+  const std::string getType() const override {
+    return RotaryEmbeddingLayer::type;
+  };
+
+  /**
+   * @copydoc Layer::supportBackwarding()
+   */
+  bool supportBackwarding() const override { return true; }
+
+  using Layer::setProperty;
+
+  /**
+   * @copydoc Layer::setProperty(const std::vector<std::string> &values)
+   */
+  void setProperty(const std::vector<std::string> &values) override;
+
+  /**
+   * @copydoc Layer::supportInPlace()
+   */
+  bool supportInPlace() const override { return true; }
+
+  inline static const std::string type = "rotary_embedding";
+
+private:
+  /**
+   * @brief rotate the first rows of every batch and channel in place
+   *
+   * @param context context of the layer
+   * @param tensor tensor to rotate
+   * @param rows number of the rows to rotate
+   * @param from position of the first row, unless the context gives the
+   * position of every batch
+   * @param inverse rotate by the negated angles
+   */
+  void rotate(RunLayerContext &context, Tensor &tensor, unsigned int rows,
+              unsigned int from, bool inverse);
+
+  /**
+   * @brief extend the cosine and sine tables to hold the position
+   */
+  void reserve(unsigned int position);
+
+  unsigned int head_dim;     /**< dimension of a head */
+  std::vector<float> freqs;  /**< angle of every pair for position 1 */
+  std::vector<float> cosine; /**< cosine of the angles of every position */
+  std::vector<float> sine;   /**< sine of the angles of every position */
+  std::tuple<props::NumHeads, props::RopeTheta> rotary_props;
+};
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __ROTARY_EMBEDDING_LAYER_H__ */
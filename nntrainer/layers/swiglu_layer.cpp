@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   swiglu_layer.cpp
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ *         https://arxiv.org/abs/2002.05202
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  This is SwiGLU Layer Class for Neural Network
+ *
+ */
+
+#include <layer_context.h>
+#include <nntrainer_error.h>
+#include <nntrainer_log.h>
+#include <swiglu_layer.h>
+#include <util_simd.h>
+
+namespace nntrainer {
+
+static constexpr size_t OUT_IDX = 0;
+static constexpr size_t INPUT_IDX = 0;
+static constexpr size_t GATE_IDX = 1;
+
+/**
+ * @brief gate the swish of len elements of the input from the offset
+ */
+static void swiglu(const Tensor &input, const Tensor &gate, Tensor &output,
+                   size_t offset, size_t len) {
+  if (input.getDataType() == ml::train::TensorDim::DataType::FP32) {
+    ele_swiglu(len, input.getData<float>() + offset,
+               gate.getData<float>() + offset,
+               output.getData<float>() + offset);
+  } else if (input.getDataType() == ml::train::TensorDim::DataType::FP16) {
+#ifdef ENABLE_FP16
+    ele_swiglu(len, input.getData<_FP16>() + offset,
+               gate.getData<_FP16>() + offset,
+               output.getData<_FP16>() + offset);
+#else
+    throw std::invalid_argument("Error: enable-fp16 is not enabled");
+#endif
+  }
+}
+
+void SwiGLULayer::finalize(InitLayerContext &context) {
+  NNTR_THROW_IF(context.getNumInputs() != 2, std::invalid_argument)
+    << "SwiGLU layer takes the input and the gate, number of inputs: "
+    << context.getNumInputs();
+
+  auto const &input_dims = context.getInputDimensions();
+  NNTR_THROW_IF(input_dims[0] != input_dims[1], std::invalid_argument)
+    << "[SwiGLU] the input: " << input_dims[0]
+    << " and the gate: " << input_dims[1] << " must be of the same shape";
+
+  context.setOutputDimensions({input_dims[0]});
+}
+
+void SwiGLULayer::setProperty(const std::vector<std::string> &values) {
+  NNTR_THROW_IF(!values.empty(), std::invalid_argument)
+    << "[SwiGLU] Unknown Layer Properties count " +
+         std::to_string(values.size());
+}
+
+void SwiGLULayer::forwarding(RunLayerContext &context, bool training) {
+  const Tensor &input = context.getInput(INPUT_IDX);
+  swiglu(input, context.getInput(GATE_IDX), context.getOutput(OUT_IDX), 0,
+         input.size());
+}
+
+void SwiGLULayer::incremental_forwarding(RunLayerContext &context,
+                                         unsigned int from, unsigned int to,
+                                         bool training) {
+  const Tensor &input = context.getInput(INPUT_IDX);
+  const Tensor &gate = context.getInput(GATE_IDX);
+  Tensor &output = context.getOutput(OUT_IDX);
+
+  if (from) {
+    to -= from;
+    from = 0;
+  }
+
+  const TensorDim &dim = input.getDim();
+  NNTR_THROW_IF(to > dim.height(), std::invalid_argument)
+    << "[SwiGLU] incremental step of " << to
+    << " rows exceeds the input height: " << dim.height();
+
+  /** only the rows of the step are computed in every batch and channel */
+  for (unsigned int b = 0; b < dim.batch(); ++b) {
+    for (unsigned int c = 0; c < dim.channel(); ++c)
+      swiglu(input, gate, output, input.getIndex(b, c, 0, 0),
+             (size_t)to * dim.width());
+  }
+}
+
+void SwiGLULayer::calcDerivative(RunLayerContext &context) {
+  const Tensor &input = context.getInput(INPUT_IDX);
+  const Tensor &gate = context.getInput(GATE_IDX);
+  const Tensor &incoming_derivative = context.getIncomingDerivative(OUT_IDX);
+  Tensor &d_input = context.getOutgoingDerivative(INPUT_IDX);
+  Tensor &d_gate = context.getOutgoingDerivative(GATE_IDX);
+
+  if (input.getDataType() == ml::train::TensorDim::DataType::FP32) {
+    ele_swiglu_deriv(input.size(), input.getData<float>(),
+                     gate.getData<float>(),
+                     incoming_derivative.getData<float>(),
+                     d_input.getData<float>(), d_gate.getData<float>());
+  } else if (input.getDataType() == ml::train::TensorDim::DataType::FP16) {
+#ifdef ENABLE_FP16
+    ele_swiglu_deriv(input.size(), input.getData<_FP16>(),
+                     gate.getData<_FP16>(),
+                     incoming_derivative.getData<_FP16>(),
+                     d_input.getData<_FP16>(), d_gate.getData<_FP16>());
+#else
+    throw std::invalid_argument("Error: enable-fp16 is not enabled");
+#endif
+  }
+}
+
+} /* namespace nntrainer */
@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   swiglu_layer.h
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ *         https://arxiv.org/abs/2002.05202
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  This is SwiGLU Layer Class for Neural Network
+ *
+ */
+
+#ifndef __SWIGLU_LAYER_H__
+#define __SWIGLU_LAYER_H__
+#ifdef __cplusplus
+
+#include <layer_devel.h>
+
+namespace nntrainer {
+
+/**
+ * @class   SwiGLULayer
+ * @brief   SwiGLU Layer, gates the swish of the first input with the second
+ * input : out = in1 * sigmoid(in1) * in2
+ */
+class SwiGLULayer : public Layer {
+public:
+  /**
+   * @brief     Constructor of SwiGLULayer
+   */
+  SwiGLULayer() : Layer() {}
+
+  /**
+   * @brief     Destructor of SwiGLULayer
+   */
+  ~SwiGLULayer() {}
+
+  /**
+   * @brief  Move constructor of SwiGLULayer
+   * @param[in] rhs SwiGLULayer to be moved
+   */
+  SwiGLULayer(SwiGLULayer &&rhs) noexcept = default;
+
+  /**
+   * @brief  Move assignment operator
+   * @param[in] rhs SwiGLULayer to be moved
+   */
+  SwiGLULayer &operator=(SwiGLULayer &&rhs) = default;
+
+  /**
+   * @copydoc Layer::finalize(InitLayerContext &context)
+   */
+  void finalize(InitLayerContext &context) override;
+
+  /**
+   * @copydoc Layer::forwarding(RunLayerContext &context, bool training)
+   */
+  void forwarding(RunLayerContext &context, bool training) override;
+
+  /**
+   * @copydoc Layer::incremental_forwarding(RunLayerContext &context, unsigned
+   * int from, unsigned int to, bool training)
+   */
+  void incremental_forwarding(RunLayerContext &context, unsigned int from,
+                              unsigned int to, bool training) override;
+
+  /**
+   * @copydoc Layer::calcDerivative(RunLayerContext &context)
+   */
+  void calcDerivative(RunLayerContext &context) override;
+
+  /**
+   * @copydoc Layer::exportTo(Exporter &exporter, const ml::train::ExportMethods
+   * method)
+   */
+  void exportTo(Exporter &exporter,
+                const ml::train::ExportMethods &method) const override {}
+
+  /**
+   * @copydoc Layer::getType()
+   */
+  const std::string getType() const override { return SwiGLULayer::type; };
+
+  /**
+   * @copydoc Layer::supportBackwarding()
+   */
+  bool supportBackwarding() const override { return true; }
+
+  using Layer::setProperty;
+
+  /**
+   * @copydoc Layer::setProperty(const std::vector<std::string> &values)
+   */
+  void setProperty(const std::vector<std::string> &values) override;
+
+  inline static const std::string type = "swiglu";
+};
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __SWIGLU_LAYER_H__ */
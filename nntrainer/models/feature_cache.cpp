@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   feature_cache.cpp
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Cache of the features computed by the frozen layers per sample
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <feature_cache.h>
+#include <nntrainer_error.h>
+#include <nntrainer_log.h>
+
+namespace nntrainer {
+
+FeatureCache::FeatureCache(size_t feature_len_, const std::string &path) :
+  feature_len(feature_len_),
+  capacity(0),
+  data(nullptr),
+  spill_path(path),
+  fd(-1) {
+  NNTR_THROW_IF(feature_len == 0, std::invalid_argument)
+    << "FeatureCache: feature length must be positive";
+
+  if (spill_path.empty())
+    return;
+
+  fd = open(spill_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, (mode_t)0600);
+  NNTR_THROW_IF(fd < 0, std::runtime_error)
+    << "FeatureCache: open file: " << spill_path;
+}
+
+FeatureCache::~FeatureCache() {
+  if (fd < 0)
+    return;
+
+  if (data)
+    munmap(data, capacity * feature_len * sizeof(float));
+  close(fd);
+  if (unlink(spill_path.c_str()) != 0)
+    ml_logw("FeatureCache: failed to remove %s", spill_path.c_str());
+}
+
+bool FeatureCache::contains(const std::vector<unsigned int> &indices) const {
+  if (indices.empty())
+    return false;
+
+  return std::all_of(indices.begin(), indices.end(),
+                     [this](unsigned int index) { return contains(index); });
+}
+
+void FeatureCache::store(unsigned int index, const float *feature) {
+  auto iter = slots.find(index);
+  if (iter == slots.end()) {
+    if (slots.size() == capacity)
+      reserve(std::max<size_t>(capacity * 2, 64));
+    iter = slots.emplace(index, slots.size()).first;
+  }
+
+  std::memcpy(getSlot(iter->second), feature, feature_len * sizeof(float));
+}
+
+void FeatureCache::load(unsigned int index, float *feature) const {
+  auto iter = slots.find(index);
+  NNTR_THROW_IF(iter == slots.end(), std::out_of_range)
+    << "FeatureCache: sample " << index << " is not cached";
+
+  std::memcpy(feature, getSlot(iter->second), feature_len * sizeof(float));
+}
+
+void FeatureCache::reserve(size_t num_slots) {
+  if (num_slots <= capacity)
+    return;
+
+  if (fd < 0) {
+    memory.resize(num_slots * feature_len);
+    data = memory.data();
+    capacity = num_slots;
+    return;
+  }
+
+  size_t old_bytes = capacity * feature_len * sizeof(float);
+  size_t bytes = num_slots * feature_len * sizeof(float);
+  NNTR_THROW_IF(ftruncate(fd, bytes) != 0, std::runtime_error)
+    << "FeatureCache: resize file: " << spill_path;
+
+  if (data) {
+    munmap(data, old_bytes);
+    data = nullptr;
+  }
+
+  void *ptr = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  NNTR_THROW_IF(ptr == MAP_FAILED, std::runtime_error)
+    << "FeatureCache: mmap file: " << spill_path;
+
+  data = static_cast<float *>(ptr);
+  capacity = num_slots;
+}
+
+} // namespace nntrainer
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   feature_cache.h
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Cache of the features computed by the frozen layers per sample
+ *
+ * When the layers at the beginning of a model are frozen, their output for a
+ * sample does not change from epoch to epoch. The features are stored by the
+ * index of the sample in the dataset at the first epoch, and later epochs
+ * feed them to the trainable layers instead of running the frozen layers.
+ */
+
+#ifndef __FEATURE_CACHE_H__
+#define __FEATURE_CACHE_H__
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nntrainer {
+
+/**
+ * @class   FeatureCache
+ * @brief   fixed length float features stored by the sample index, in memory
+ * or in a memory mapped spill file
+ */
+class FeatureCache {
+public:
+  /**
+   * @brief Construct a new Feature Cache object
+   *
+   * @param feature_len number of floats of a feature
+   * @param spill_path path of the file the features are mapped from, the
+   * features are kept in memory if empty
+   */
+  FeatureCache(size_t feature_len, const std::string &spill_path = "");
+
+  /**
+   * @brief Destroy the Feature Cache object, the spill file is removed
+   */
+  ~FeatureCache();
+
+  FeatureCache(const FeatureCache &) = delete;
+  FeatureCache &operator=(const FeatureCache &) = delete;
+
+  /**
+   * @brief Check if the feature of the sample is cached
+   *
+   * @param index index of the sample
+   * @return true if cached
+   */
+  bool contains(unsigned int index) const {
+    return slots.find(index) != slots.end();
+  }
+
+  /**
+   * @brief Check if the features of all the samples are cached
+   *
+   * @param indices indices of the samples
+   * @return true if all of them are cached, false if any is not or there is
+   * no sample
+   */
+  bool contains(const std::vector<unsigned int> &indices) const;
+
+  /**
+   * @brief Store the feature of the sample, overwriting the cached one
+   *
+   * @param index index of the sample
+   * @param feature feature_len floats
+   */
+  void store(unsigned int index, const float *feature);
+
+  /**
+   * @brief Load the cached feature of the sample
+   *
+   * @param index index of the sample
+   * @param[out] feature feature_len floats
+   * @throw std::out_of_range if the sample is not cached
+   */
+  void load(unsigned int index, float *feature) const;
+
+  /**
+   * @brief Get the number of the cached samples
+   */
+  size_t size() const { return slots.size(); }
+
+  /**
+   * @brief Get the number of floats of a feature
+   */
+  size_t getFeatureLen() const { return feature_len; }
+
+private:
+  /**
+   * @brief Grow the storage to hold at least the given number of features
+   *
+   * @param num_slots number of features
+   */
+  void reserve(size_t num_slots);
+
+  /**
+   * @brief Get the memory of a slot
+   */
+  float *getSlot(size_t slot) const { return data + slot * feature_len; }
+
+  size_t feature_len; /**< number of floats of a feature */
+  std::unordered_map<unsigned int, size_t> slots; /**< slot by sample index */
+  size_t capacity; /**< number of features the storage holds */
+  float *data;     /**< storage of the features */
+
+  std::vector<float> memory; /**< storage when there is no spill file */
+  std::string spill_path;    /**< path of the spill file */
+  int fd;                    /**< descriptor of the spill file, -1 if none */
+};
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __FEATURE_CACHE_H__ */
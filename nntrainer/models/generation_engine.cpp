@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   generation_engine.cpp
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Continuous batching text generation on the incremental inference
+ */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <generation_engine.h>
+#include <neuralnet.h>
+#include <nntrainer_error.h>
+#include <util_simd.h>
+
+namespace nntrainer {
+
+GenerationEngine::GenerationEngine(NeuralNetwork &model_,
+                                   unsigned int max_batch_,
+                                   unsigned int max_length_, unsigned int eos_,
+                                   Sampler sampler_) :
+  model(model_),
+  max_batch(max_batch_),
+  max_length(max_length_),
+  eos(eos_),
+  sampler(std::move(sampler_)),
+  slots(max_batch_, NO_TOKEN),
+  num_active(0),
+  next_id(0) {
+  NNTR_THROW_IF(max_batch == 0 || max_length == 0, std::invalid_argument)
+    << "GenerationEngine: max_batch and max_length must be positive";
+
+  auto input_dims = model.getInputDimension();
+  NNTR_THROW_IF(input_dims.empty() || input_dims.size() > 2,
+                std::invalid_argument)
+    << "GenerationEngine: the model must take the token and optionally the "
+       "position, number of inputs: "
+    << input_dims.size();
+
+  for (auto &dim : input_dims) {
+    NNTR_THROW_IF(dim.getFeatureLen() != 1, std::invalid_argument)
+      << "GenerationEngine: an input must take a single token, input: " << dim;
+    dim.batch(max_batch);
+    inputs.emplace_back(dim);
+  }
+
+  if (!sampler) {
+    sampler = [](const float *logits, unsigned int num_vocab) {
+      return argmax(num_vocab, logits);
+    };
+  }
+}
+
+unsigned int GenerationEngine::submit(const std::vector<unsigned int> &prompt,
+                                      unsigned int max_new_tokens) {
+  NNTR_THROW_IF(prompt.empty(), std::invalid_argument)
+    << "GenerationEngine: prompt is empty";
+  NNTR_THROW_IF(prompt.size() > max_length, std::invalid_argument)
+    << "GenerationEngine: prompt of " << prompt.size()
+    << " tokens exceeds max_length: " << max_length;
+
+  unsigned int id = next_id++;
+  sequences[id] = {prompt, {}, max_new_tokens, 0, max_new_tokens == 0,
+                   Clock::now(), -1.0};
+  if (max_new_tokens != 0)
+    waiting.push_back(id);
+
+  return id;
+}
+
+void GenerationEngine::admit() {
+  for (unsigned int slot = 0; slot < max_batch && !waiting.empty(); ++slot) {
+    if (slots[slot] != NO_TOKEN)
+      continue;
+
+    slots[slot] = waiting.front();
+    waiting.pop_front();
+    num_active++;
+  }
+}
+
+void GenerationEngine::retire(unsigned int slot) {
+  sequences.at(slots[slot]).finished = true;
+  slots[slot] = NO_TOKEN;
+  num_active--;
+}
+
+bool GenerationEngine::step() {
+  admit();
+  if (num_active == 0)
+    return false;
+
+  auto start = Clock::now();
+
+  /** a free slot runs a dummy token at position 0, which is overwritten by
+   * the first token of the sequence admitted next */
+  std::vector<unsigned int> positions(max_batch, 0);
+  for (auto &input : inputs)
+    input.setZero();
+
+  for (unsigned int slot = 0; slot < max_batch; ++slot) {
+    if (slots[slot] == NO_TOKEN)
+      continue;
+
+    Sequence &seq = sequences.at(slots[slot]);
+    unsigned int pos = seq.position;
+    positions[slot] = pos;
+    inputs[0].getData()[slot] = static_cast<float>(
+      pos < seq.prompt.size() ? seq.prompt[pos] : seq.generated.back());
+    if (inputs.size() > 1)
+      inputs[1].getData()[slot] = static_cast<float>(pos);
+  }
+
+  sharedConstTensors in;
+  for (auto &input : inputs)
+    in.push_back(MAKE_SHARED_TENSOR(input));
+
+  auto out = model.incremental_inference(in, positions);
+  NNTR_THROW_IF(out.empty() || out[0]->getDataType() != Tdatatype::FP32,
+                std::runtime_error)
+    << "GenerationEngine: the logits must be FP32";
+  const float *logits = out[0]->getData();
+  unsigned int num_vocab = out[0]->getDim().getFeatureLen();
+
+  auto now = Clock::now();
+  for (unsigned int slot = 0; slot < max_batch; ++slot) {
+    if (slots[slot] == NO_TOKEN)
+      continue;
+
+    Sequence &seq = sequences.at(slots[slot]);
+    if (seq.position < seq.prompt.size())
+      stats.prompt_tokens++;
+    seq.position++;
+
+    /** the logits of a prompt token but the last one are not needed */
+    if (seq.position < seq.prompt.size())
+      continue;
+
+    unsigned int token = sampler(logits + (size_t)slot * num_vocab, num_vocab);
+    seq.generated.push_back(token);
+    stats.generated_tokens++;
+
+    if (seq.generated.size() == 1) {
+      seq.time_to_first_token =
+        std::chrono::duration<double>(now - seq.start).count();
+      stats.time_to_first_token += seq.time_to_first_token;
+      stats.first_tokens++;
+    }
+
+    if (token == eos || seq.generated.size() >= seq.max_new_tokens ||
+        seq.position >= max_length)
+      retire(slot);
+  }
+
+  stats.steps++;
+  stats.elapsed += std::chrono::duration<double>(Clock::now() - start).count();
+
+  return true;
+}
+
+void GenerationEngine::run() {
+  while (step())
+    ;
+}
+
+const GenerationEngine::Sequence &
+GenerationEngine::getSequence(unsigned int id) const {
+  auto iter = sequences.find(id);
+  NNTR_THROW_IF(iter == sequences.end(), std::out_of_range)
+    << "GenerationEngine: unknown sequence " << id;
+  return iter->second;
+}
+
+bool GenerationEngine::isFinished(unsigned int id) const {
+  return getSequence(id).finished;
+}
+
+const std::vector<unsigned int> &
+GenerationEngine::getTokens(unsigned int id) const {
+  return getSequence(id).generated;
+}
+
+double GenerationEngine::getTimeToFirstToken(unsigned int id) const {
+  return getSequence(id).time_to_first_token;
+}
+
+void GenerationEngine::release(unsigned int id) {
+  NNTR_THROW_IF(!getSequence(id).finished, std::invalid_argument)
+    << "GenerationEngine: sequence " << id << " is not finished";
+  sequences.erase(id);
+}
+
+} // namespace nntrainer
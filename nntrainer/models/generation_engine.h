@@ -0,0 +1,211 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   generation_engine.h
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Continuous batching text generation on the incremental inference
+ *
+ * Every batch of the model is a slot holding an independent sequence. A step
+ * feeds a single token of every slot at the position of its own sequence, so
+ * sequences reading their prompt and sequences generating share one forward
+ * pass. A waiting sequence is admitted as soon as a slot is retired, without
+ * waiting for the others to finish.
+ */
+
+#ifndef __GENERATION_ENGINE_H__
+#define __GENERATION_ENGINE_H__
+#ifdef __cplusplus
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include <tensor.h>
+
+namespace nntrainer {
+
+class NeuralNetwork;
+
+/**
+ * @class   GenerationEngine
+ * @brief   batches independent sequences at different positions into the
+ * incremental forwarding of a model
+ *
+ * The first input of the model takes the token id and the second input, if
+ * any, takes the position of the token. Both are of 1:1:1. The first output
+ * is the logits of the next token. The layers keeping a cache have to be
+ * able to hold max_length tokens, e.g. max_timestep of multi_head_attention.
+ */
+class GenerationEngine {
+public:
+  static constexpr unsigned int NO_TOKEN =
+    std::numeric_limits<unsigned int>::max(); /**< no end of sequence token */
+
+  /**
+   * @brief pick the next token from the logits
+   */
+  using Sampler =
+    std::function<unsigned int(const float *logits, unsigned int num_vocab)>;
+
+  /**
+   * @brief statistics of the steps run so far
+   */
+  struct Stats {
+    unsigned int steps = 0;      /**< number of the steps */
+    size_t prompt_tokens = 0;    /**< prompt tokens read */
+    size_t generated_tokens = 0; /**< tokens generated */
+    size_t first_tokens = 0;     /**< sequences which generated a token */
+    double elapsed = 0.0;        /**< seconds spent in the steps */
+    double time_to_first_token = 0.0; /**< sum of the seconds from the
+                                         submission to the first token */
+
+    /**
+     * @brief Get the generated tokens per second
+     */
+    double tokensPerSecond() const {
+      return elapsed > 0.0 ? generated_tokens / elapsed : 0.0;
+    }
+
+    /**
+     * @brief Get the mean seconds from the submission to the first token
+     */
+    double meanTimeToFirstToken() const {
+      return first_tokens ? time_to_first_token / first_tokens : 0.0;
+    }
+  };
+
+  /**
+   * @brief Construct a new Generation Engine object
+   *
+   * @param model initialized model
+   * @param max_batch number of the slots, the batch size of a step
+   * @param max_length maximum number of the tokens of a sequence
+   * @param eos end of sequence token, NO_TOKEN if there is none
+   * @param sampler sampler of the next token, the greedy one if empty
+   */
+  GenerationEngine(NeuralNetwork &model, unsigned int max_batch,
+                   unsigned int max_length, unsigned int eos = NO_TOKEN,
+                   Sampler sampler = nullptr);
+
+  /**
+   * @brief Submit a sequence, which waits until a slot is free
+   *
+   * @param prompt prompt tokens
+   * @param max_new_tokens maximum number of the tokens to generate
+   * @return unsigned int id of the sequence
+   */
+  unsigned int submit(const std::vector<unsigned int> &prompt,
+                      unsigned int max_new_tokens);
+
+  /**
+   * @brief Admit the waiting sequences to the free slots and run a step
+   *
+   * @return true if a step is run, false if there is no sequence to run
+   */
+  bool step();
+
+  /**
+   * @brief Run the steps until all the submitted sequences are finished
+   */
+  void run();
+
+  /**
+   * @brief Check if the sequence is finished
+   *
+   * @param id id of the sequence
+   */
+  bool isFinished(unsigned int id) const;
+
+  /**
+   * @brief Get the tokens generated for the sequence so far
+   *
+   * @param id id of the sequence
+   */
+  const std::vector<unsigned int> &getTokens(unsigned int id) const;
+
+  /**
+   * @brief Get the seconds from the submission to the first token
+   *
+   * @param id id of the sequence
+   * @return double seconds, negative if no token is generated yet
+   */
+  double getTimeToFirstToken(unsigned int id) const;
+
+  /**
+   * @brief Forget a finished sequence
+   *
+   * @param id id of the sequence
+   */
+  void release(unsigned int id);
+
+  /**
+   * @brief Get the number of the sequences in the slots
+   */
+  unsigned int getNumActive() const { return num_active; }
+
+  /**
+   * @brief Get the number of the sequences waiting for a slot
+   */
+  unsigned int getNumWaiting() const { return waiting.size(); }
+
+  /**
+   * @brief Get the statistics
+   */
+  const Stats &getStats() const { return stats; }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief a submitted sequence
+   */
+  struct Sequence {
+    std::vector<unsigned int> prompt;    /**< prompt tokens */
+    std::vector<unsigned int> generated; /**< generated tokens */
+    unsigned int max_new_tokens;         /**< tokens to generate at most */
+    unsigned int position;   /**< position of the next token to feed */
+    bool finished;           /**< true if retired */
+    Clock::time_point start; /**< time of the submission */
+    double time_to_first_token; /**< negative if no token yet */
+  };
+
+  /**
+   * @brief Get the sequence of the id
+   */
+  const Sequence &getSequence(unsigned int id) const;
+
+  /**
+   * @brief Move the waiting sequences into the free slots
+   */
+  void admit();
+
+  /**
+   * @brief Retire the sequence of the slot
+   */
+  void retire(unsigned int slot);
+
+  NeuralNetwork &model;    /**< model to run */
+  unsigned int max_batch;  /**< number of the slots */
+  unsigned int max_length; /**< maximum tokens of a sequence */
+  unsigned int eos;        /**< end of sequence token */
+  Sampler sampler;         /**< sampler of the next token */
+
+  std::unordered_map<unsigned int, Sequence> sequences; /**< by the id */
+  std::deque<unsigned int> waiting; /**< ids waiting for a slot */
+  std::vector<unsigned int> slots;  /**< id in every slot, NO_TOKEN if free */
+  unsigned int num_active;          /**< number of the occupied slots */
+  unsigned int next_id;             /**< id of the next submission */
+
+  std::vector<Tensor> inputs; /**< token, and position if taken, per slot */
+  Stats stats;                /**< statistics of the steps */
+};
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __GENERATION_ENGINE_H__ */
@@ -25,6 +25,12 @@ bool LossType::isValid(const std::string &value) const {
 
 TrainingBatchSize::TrainingBatchSize(unsigned int value) { set(value); }
 
+AccumulationSteps::AccumulationSteps(unsigned int value) { set(value); }
+
+CheckpointSegments::CheckpointSegments(unsigned int value) { set(value); }
+
+FeatureCache::FeatureCache(bool value) { set(value); }
+
 ContinueTrain::ContinueTrain(bool value) { set(value); }
 
 MemoryOptimization::MemoryOptimization(bool value) { set(value); }
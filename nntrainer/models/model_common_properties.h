@@ -90,6 +90,75 @@ public:
   TrainingBatchSize(unsigned int value = 1);
 };
 
+/**
+ * @brief number of micro-batches whose gradients are accumulated before the
+ * optimizer is applied
+ *
+ */
+class AccumulationSteps : public PositiveIntegerProperty {
+public:
+  static constexpr const char *key =
+    "accumulation_steps";         /**< unique key to access */
+  using prop_tag = uint_prop_tag; /**< property type */
+
+  /**
+   * @brief Construct a new AccumulationSteps object
+   *
+   * @param value value to set, defaults to 1
+   */
+  AccumulationSteps(unsigned int value = 1);
+};
+
+/**
+ * @brief number of segments the activations are split into for recomputation
+ * when no layer is set as a checkpoint, 0 to disable
+ *
+ */
+class CheckpointSegments : public Property<unsigned int> {
+public:
+  static constexpr const char *key =
+    "checkpoint_segments";        /**< unique key to access */
+  using prop_tag = uint_prop_tag; /**< property type */
+
+  /**
+   * @brief Construct a new CheckpointSegments object
+   *
+   * @param value value to set, defaults to 0
+   */
+  CheckpointSegments(unsigned int value = 0);
+};
+
+/**
+ * @brief cache the output of the frozen layers per sample at the first epoch
+ * and skip those layers in the later epochs
+ *
+ */
+class FeatureCache : public Property<bool> {
+public:
+  static constexpr const char *key =
+    "feature_cache";              /**< unique key to access */
+  using prop_tag = bool_prop_tag; /**< property type */
+
+  /**
+   * @brief Construct a new FeatureCache object
+   *
+   * @param value value to set, defaults to false
+   */
+  FeatureCache(bool value = false);
+};
+
+/**
+ * @brief path of the file the cached features are mapped from, the features
+ * are kept in memory if empty
+ *
+ */
+class FeatureCachePath : public Property<std::string> {
+public:
+  static constexpr const char *key =
+    "feature_cache_path";        /**< unique key to access */
+  using prop_tag = str_prop_tag; /**< property type */
+};
+
 /**
  * @brief model continue property
  *
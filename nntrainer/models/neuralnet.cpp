@@ -33,6 +33,7 @@
 #include <activation_realizer.h>
 #include <common_properties.h>
 #include <databuffer.h>
+#include <feature_cache.h>
 #include <flatten_realizer.h>
 #include <ini_interpreter.h>
 #include <ini_wrapper.h>
@@ -44,11 +45,13 @@
 #include <nntrainer_log.h>
 #include <node_exporter.h>
 #include <optimizer_context.h>
+#include <prefix_cache.h>
 #include <previous_input_realizer.h>
 #include <profiler.h>
 #include <recurrent_realizer.h>
 #include <remap_realizer.h>
 #include <slice_realizer.h>
+#include <tensor_allocator.h>
 #include <util_func.h>
 
 #ifdef ENABLE_TFLITE_INTERPRETER
@@ -71,7 +74,9 @@ NeuralNetwork::NeuralNetwork() :
     props::Epochs(), props::TrainingBatchSize(), props::SavePath(),
     props::ContinueTrain(), props::SaveBestPath(), props::MemoryOptimization(),
     props::MemorySwap(), props::MemorySwapPath(), props::MemorySwapLookahead(),
-    props::TensorFormat(), props::ModelTensorDataType()),
+    props::TensorFormat(), props::ModelTensorDataType(),
+    props::AccumulationSteps(), props::CheckpointSegments(),
+    props::FeatureCache(), props::FeatureCachePath()),
   load_path(std::string()),
   epoch_idx(0),
   iter(0),
@@ -90,7 +95,9 @@ NeuralNetwork::NeuralNetwork(AppContext app_context_) :
     props::Epochs(), props::TrainingBatchSize(), props::SavePath(),
     props::ContinueTrain(), props::SaveBestPath(), props::MemoryOptimization(),
     props::MemorySwap(), props::MemorySwapPath(), props::MemorySwapLookahead(),
-    props::TensorFormat(), props::ModelTensorDataType()),
+    props::TensorFormat(), props::ModelTensorDataType(),
+    props::AccumulationSteps(), props::CheckpointSegments(),
+    props::FeatureCache(), props::FeatureCachePath()),
   load_path(std::string()),
   epoch_idx(0),
   iter(0),
@@ -257,6 +264,11 @@ int NeuralNetwork::initialize(ExecutionMode mode) {
         return opt->getOptimizerVariableDim(dim);
       };
     model_graph.requestOptimizerVariable(cb, true);
+    model_graph.requestGradientAccumulator(
+      std::get<props::AccumulationSteps>(model_flex_props));
+    model_graph.setSparseGradientAllowed(opt->supportsSparseGradient());
+    model_graph.requestRecompute(
+      std::get<props::CheckpointSegments>(model_flex_props));
   }
 
   // Allocate weights
@@ -338,6 +350,45 @@ sharedConstTensors NeuralNetwork::forwarding(
   return model_graph.forwarding(training, forwarding_op, stop_cb, userdata);
 }
 
+sharedConstTensors NeuralNetwork::forwarding(
+  FeatureCache &cache, unsigned int frozen_layers, LayerNode &feature_node,
+  unsigned int feature_idx, const std::vector<unsigned int> &indices,
+  std::function<bool(void *userdata)> stop_cb, void *userdata) {
+  bool cached = cache.contains(indices);
+  auto resume_node = model_graph.getSortedLayerNode(frozen_layers);
+  auto resume_order = std::get<0>(resume_node->getExecutionOrder());
+
+  std::function<void(std::shared_ptr<LayerNode>, bool)> forwarding_op =
+    [&](std::shared_ptr<LayerNode> node, bool training) -> void {
+    auto f = std::get<0>(node->getExecutionOrder());
+    if (cached && f < resume_order)
+      return;
+
+    /** the features are read or written right before the first layer which
+     * is not frozen, as their memory is valid from then */
+    if (node == resume_node) {
+      Tensor &features = feature_node.getOutput(feature_idx);
+      NNTR_THROW_IF(features.batch() != indices.size(), std::invalid_argument)
+        << "number of the sample indices does not match the batch";
+
+      float *data = features.getData<float>();
+      size_t feature_len = cache.getFeatureLen();
+      for (unsigned int b = 0; b < indices.size(); ++b) {
+        if (cached)
+          cache.load(indices[b], data + b * feature_len);
+        else if (indices[b] != Sample::NO_INDEX && !cache.contains(indices[b]))
+          cache.store(indices[b], data + b * feature_len);
+      }
+    }
+
+    PROFILE_MEM_ANNOTATE("Forwarding for layer: " + node->getName());
+    model_graph.flushCacheExcept(f);
+    node->forwarding(training);
+  };
+
+  return model_graph.forwarding(true, forwarding_op, stop_cb, userdata);
+}
+
 /**
  * @brief     forward propagation using layers object which has layer
  */
@@ -714,7 +765,9 @@ sharedConstTensors NeuralNetwork::inference(sharedConstTensors X,
   if (!validateInput(X))
     throw std::invalid_argument("Input validation failed.");
 
-  allocate(ExecutionMode::INFERENCE);
+  /** memory allocated by a previous inference is reused as is */
+  if (!model_graph.isAllocated(ExecutionMode::INFERENCE))
+    allocate(ExecutionMode::INFERENCE);
 
   int nn_foward;
   PROFILE_TIME_REGISTER_EVENT(nn_foward, "nn_forward");
@@ -813,6 +866,138 @@ sharedConstTensors NeuralNetwork::incremental_inference(
   return out;
 }
 
+sharedConstTensors
+NeuralNetwork::incremental_inference(sharedConstTensors X,
+                                     const std::vector<unsigned int> &positions) {
+  if (model_graph.getBatchSize() != X[0]->batch()) {
+    model_graph.setBatchSize(X[0]->batch());
+  }
+
+  NNTR_THROW_IF(positions.size() != X[0]->batch(), std::invalid_argument)
+    << "number of positions: " << positions.size()
+    << " is not matched with the batch size: " << X[0]->batch();
+
+  if (!validateInput(X))
+    throw std::invalid_argument("Input validation failed.");
+
+  if (!model_graph.isAllocated(ExecutionMode::INFERENCE))
+    allocate(ExecutionMode::INFERENCE);
+
+  for (auto iter = model_graph.cbegin(); iter != model_graph.cend(); ++iter)
+    (*iter)->getRunContext().setIncrementalPositions(positions);
+
+  /** the layers without a cache only see the single token of every batch */
+  sharedConstTensors out = incremental_forwarding(0, 1, X, {}, false);
+
+  for (auto iter = model_graph.cbegin(); iter != model_graph.cend(); ++iter)
+    (*iter)->getRunContext().setIncrementalPositions({});
+  model_graph.setInputsLabels({}, {});
+
+  return out;
+}
+
+sharedConstTensors NeuralNetwork::incremental_prefill(
+  sharedConstTensors X, unsigned int init_seq_len, unsigned int to,
+  unsigned int chunk_size, PrefixCache *prefix_cache) {
+  NNTR_THROW_IF(X.empty() || to == 0 || chunk_size == 0, std::invalid_argument)
+    << "prefill takes the inputs, a prompt and a positive chunk size";
+  for (auto &x : X) {
+    NNTR_THROW_IF(to > x->getDim().getFeatureLen(), std::invalid_argument)
+      << "prompt of " << to << " tokens exceeds the input: " << x->getDim();
+  }
+
+  const unsigned int batch = X[0]->batch();
+  std::vector<unsigned int> tokens;
+  unsigned int from = 0;
+  if (prefix_cache) {
+    NNTR_THROW_IF(batch != 1, std::invalid_argument)
+      << "a prefix cache takes a single sequence, batch size: " << batch;
+    NNTR_THROW_IF(X[0]->getDataType() != Tdatatype::FP32, std::invalid_argument)
+      << "a prefix cache takes the tokens of a FP32 input";
+
+    const float *data = X[0]->getData();
+    for (unsigned int i = 0; i < to; ++i)
+      tokens.push_back(static_cast<unsigned int>(data[i]));
+    from = prefix_cache->restore(tokens, getKVCaches());
+  }
+
+  /** a chunk after the first one takes its tokens from the first element */
+  sharedConstTensors out;
+  unsigned int last_from = from;
+  for (unsigned int begin = from; begin < to; begin += chunk_size) {
+    const unsigned int end = std::min(begin + chunk_size, to);
+
+    sharedConstTensors chunk;
+    for (auto &x : X) {
+      if (begin == 0) {
+        chunk.push_back(x);
+        continue;
+      }
+
+      const size_t feature_len = x->getDim().getFeatureLen();
+      TensorDim step_dim({1, 1, 1, end - begin}, x->getTensorType());
+      Tensor step_input(x->getDim());
+      step_input.setZero();
+      for (unsigned int b = 0; b < batch; ++b) {
+        step_input.getSharedDataTensor(step_dim, b * feature_len)
+          .copyData(x->getSharedDataTensor(step_dim, b * feature_len + begin));
+      }
+      chunk.push_back(MAKE_SHARED_TENSOR(step_input));
+    }
+
+    out = incremental_inference(chunk, init_seq_len, begin, end);
+    last_from = begin;
+  }
+
+  if (prefix_cache)
+    prefix_cache->store(tokens, getKVCaches());
+
+  /** the last chunk holds the last token at its row of to - 1 - last_from */
+  const unsigned int row = to - 1 - last_from;
+  sharedConstTensors last;
+  for (auto &o : out) {
+    TensorDim dim = o->getDim();
+    NNTR_THROW_IF(row >= dim.height() || dim.channel() != 1,
+                  std::invalid_argument)
+      << "an output must hold a row for every token of a chunk, output: "
+      << dim;
+
+    TensorDim row_dim = dim;
+    row_dim.batch(1);
+    row_dim.height(1);
+    TensorDim last_dim = dim;
+    last_dim.height(1);
+
+    Tensor last_out(last_dim);
+    for (unsigned int b = 0; b < dim.batch(); ++b) {
+      last_out.getBatchSlice(b, 1).copyData(o->getSharedDataTensor(
+        row_dim, b * dim.getFeatureLen() + row * dim.width()));
+    }
+    last.push_back(MAKE_SHARED_TENSOR(last_out));
+  }
+
+  return last;
+}
+
+std::vector<Tensor *> NeuralNetwork::getKVCaches() {
+  if (!model_graph.isAllocated(ExecutionMode::INFERENCE))
+    allocate(ExecutionMode::INFERENCE);
+
+  std::vector<Tensor *> caches;
+  for (auto iter = model_graph.cbegin(); iter != model_graph.cend(); ++iter) {
+    RunLayerContext &context = (*iter)->getRunContext();
+    for (unsigned int i = 0; i < context.getNumTensors(); ++i) {
+      const std::string &name = context.getTensorName(i);
+      if (endswith(name, "cache_key") || endswith(name, "cache_value") ||
+          endswith(name, "cache_key_scale") ||
+          endswith(name, "cache_value_scale"))
+        caches.push_back(&context.getTensor(i));
+    }
+  }
+
+  return caches;
+}
+
 std::vector<float *> NeuralNetwork::incremental_inference(
   unsigned int batch_size, const std::vector<float *> &input,
   const std::vector<float *> &label, unsigned int init_seq_len,
@@ -846,7 +1031,8 @@ std::vector<float *> NeuralNetwork::incremental_inference(
 
   std::vector<float *> output;
 
-  unsigned int step = from ? 0 : to - 1;
+  /** a step after the first one holds its tokens from the first row */
+  unsigned int step = to - from - 1;
 
   for (auto &out : output_tensors) {
     const auto &out_t = *out.get();
@@ -933,6 +1119,7 @@ int NeuralNetwork::train(const std::vector<std::string> &values,
    * Weights of the model will be freed when the model is destroyed.
    */
   model_graph.deallocateTensors(false);
+  TensorAllocator::Global().release();
   return status;
 }
 
@@ -955,7 +1142,18 @@ int NeuralNetwork::train_run(
 
   auto batch_size = std::get<props::TrainingBatchSize>(model_flex_props);
 
-  auto const &outputs = model_graph.getOutputTensors();
+  unsigned int accumulation_steps =
+    std::get<props::AccumulationSteps>(model_flex_props);
+  NNTR_THROW_IF(accumulation_steps !=
+                  model_graph.getGradientAccumulationSteps(),
+                std::invalid_argument)
+    << "accumulation_steps must be set before initialize, requested: "
+    << accumulation_steps
+    << " initialized: " << model_graph.getGradientAccumulationSteps();
+  model_graph.resetGradientAccumulation();
+  unsigned int micro_step = 0;
+
+  auto outputs = model_graph.getOutputTensors();
   auto in_dims = model_graph.getInputDimension();
   auto label_dims = model_graph.getOutputDimension();
 
@@ -966,6 +1164,42 @@ int NeuralNetwork::train_run(
     return ML_ERROR_INVALID_PARAMETER;
   }
 
+  /**
+   * the features output by the frozen layers are cached by the sample index
+   * at the first epoch, the later epochs skip the frozen layers for them
+   */
+  std::unique_ptr<FeatureCache> feature_cache;
+  std::shared_ptr<LayerNode> feature_node;
+  std::string feature_name;
+  unsigned int feature_idx = 0;
+  unsigned int frozen_layers = 0;
+  if (std::get<props::FeatureCache>(model_flex_props)) {
+    if (!std::get<props::MemorySwap>(model_flex_props))
+      frozen_layers = model_graph.getFrozenPrefix(feature_name, feature_idx);
+
+    if (frozen_layers > 0) {
+      feature_node = model_graph.getLayerNode(feature_name);
+      auto const &features = feature_node->getOutput(feature_idx);
+      if (features.getDataType() != ml::train::TensorDim::DataType::FP32)
+        frozen_layers = 0;
+    }
+
+    if (frozen_layers > 0) {
+      auto &path = std::get<props::FeatureCachePath>(model_flex_props);
+      feature_cache = std::make_unique<FeatureCache>(
+        feature_node->getOutput(feature_idx).getDim().getFeatureLen(),
+        path.empty() ? "" : path.get());
+      ml_logi("[NeuralNetwork] caching the output of %s, skipping %u frozen "
+              "layers after the first epoch",
+              feature_name.c_str(), frozen_layers);
+    } else {
+      ml_logw("[NeuralNetwork] feature cache is not used as there are no "
+              "frozen layers handing a single FP32 output to the rest, or "
+              "memory swap or recomputation is enabled");
+    }
+  }
+  std::vector<unsigned int> sample_indices;
+
   /**
    * @brief run a single epoch with given callback, @a auto is used instead of
    * std::function for performance measure
@@ -976,8 +1210,8 @@ int NeuralNetwork::train_run(
    * @param on_epoch_end function that will receive reference to stat,
    * buffer which will be called on the epoch end
    */
-  auto run_epoch = [this, &in_dims, &label_dims, &outputs, batch_size](
-                     DataBuffer *buffer, bool shuffle,
+  auto run_epoch = [this, &in_dims, &label_dims, &outputs, &sample_indices,
+                    batch_size](DataBuffer *buffer, bool shuffle,
                      auto &&on_iteration_fetch, auto &&on_iteration_update_stat,
                      auto &&on_epoch_end, RunStats &stat) {
     /// @todo managing metrics must be handled here as well!! for now it is
@@ -999,14 +1233,26 @@ int NeuralNetwork::train_run(
         break;
       }
       auto &iteration = iter_view.get();
-      if (iteration.batch() != batch_size) {
-        /// @todo support partial batch
-        continue;
+      /**
+       * a partial batch runs on the allocated memory with a smaller batch, the
+       * iteration tensors are sliced so that only the filled samples are used
+       */
+      unsigned int current_batch = iteration.batch();
+      if (current_batch != model_graph.getBatchSize()) {
+        model_graph.setBatchSize(current_batch);
+        outputs = model_graph.getOutputTensors();
       }
 
-      auto const &labels = iteration.getLabelsRef();
-      auto const &inputs = iteration.getInputsRef();
+      std::vector<Tensor> labels = iteration.getLabelsRef();
+      std::vector<Tensor> inputs = iteration.getInputsRef();
+      if (current_batch != batch_size) {
+        for (auto &t : labels)
+          t = t.getBatchSlice(0, current_batch);
+        for (auto &t : inputs)
+          t = t.getBatchSlice(0, current_batch);
+      }
       model_graph.setInputsLabels(inputs, labels);
+      sample_indices = iteration.getSampleIndices();
 
       on_iteration_fetch(stat, *buffer);
       on_iteration_update_stat(stat, outputs, labels);
@@ -1021,22 +1267,44 @@ int NeuralNetwork::train_run(
     return stat;
   };
 
-  auto train_for_iteration =
-    [this, stop_cb, stop_user_data](RunStats &stat, DataBuffer &buffer) {
-      ml_loge("train for iteration");
+  auto train_for_iteration = [this, stop_cb, stop_user_data,
+                              accumulation_steps, &micro_step, &feature_cache,
+                              &feature_node, feature_idx, frozen_layers,
+                              &sample_indices](RunStats &stat,
+                                               DataBuffer &buffer) {
+    ml_loge("train for iteration");
+    auto &allocator = TensorAllocator::Global();
+    allocator.resetStats();
+    if (feature_cache)
+      forwarding(*feature_cache, frozen_layers, *feature_node, feature_idx,
+                 sample_indices, stop_cb, stop_user_data);
+    else
       forwarding(true, stop_cb, stop_user_data);
-      backwarding(iter++, stop_cb, stop_user_data);
+    /** the gradients of accumulation_steps micro-batches are accumulated and
+     * the optimizer, which counts iterations, runs on the last one */
+    backwarding(iter, stop_cb, stop_user_data);
+    if (++micro_step == accumulation_steps) {
+      micro_step = 0;
+      iter++;
+    }
 
-      // To avoid unconsidered memory leak, we need to clear the cache
-      model_graph.flushCache();
+    /** churn of the standalone tensors allocated outside of the planned pool */
+    auto alloc_stats = allocator.getStats();
+    ml_logd("[NNTrainer] iteration %u: %zu tensor allocations, %zu from the "
+            "system, %zu bytes",
+            iter, alloc_stats.allocations, alloc_stats.system_allocations,
+            alloc_stats.bytes);
 
-      if (!stop_cb(stop_user_data)) {
-        std::cout << "#" << epoch_idx << "/" << getEpochs();
-        ml_logi("# %d / %d", epoch_idx, getEpochs());
-        auto loss = getLoss();
-        buffer.displayProgress(stat.num_iterations, loss);
-      }
-    };
+    // To avoid unconsidered memory leak, we need to clear the cache
+    model_graph.flushCache();
+
+    if (!stop_cb(stop_user_data)) {
+      std::cout << "#" << epoch_idx << "/" << getEpochs();
+      ml_logi("# %d / %d", epoch_idx, getEpochs());
+      auto loss = getLoss();
+      buffer.displayProgress(stat.num_iterations, loss);
+    }
+  };
 
   auto update_train_stat = [this](RunStats &stat,
                                   const std::vector<Tensor> &outputs,
@@ -1077,32 +1345,37 @@ int NeuralNetwork::train_run(
     forwarding(false, stop_cb, stop_user_data);
   };
 
-  auto update_eval_stat = [batch_size, &update_train_stat](
+  /** number of samples evaluated in the epoch, the last batch may be partial */
+  unsigned int num_eval_samples = 0;
+
+  auto update_eval_stat = [&num_eval_samples, &update_train_stat](
                             RunStats &stat, const std::vector<Tensor> &outputs,
                             const std::vector<Tensor> &labels) {
     auto model_out = outputs[0].argmax();
     auto label_out = labels[0].argmax();
 
-    for (unsigned int b = 0; b < batch_size; b++) {
+    for (unsigned int b = 0; b < label_out.size(); b++) {
       if (model_out[b] == label_out[b])
         stat.num_correct_predictions++;
     }
+    num_eval_samples += label_out.size();
 
     update_train_stat(stat, outputs, labels);
   };
 
-  auto eval_epoch_end = [this, batch_size, max_acc = 0.0f,
+  auto eval_epoch_end = [this, &num_eval_samples, max_acc = 0.0f,
                          min_loss = std::numeric_limits<float>::max()](
                           RunStats &stat, DataBuffer &buffer) mutable {
+    unsigned int num_samples = num_eval_samples;
+    num_eval_samples = 0;
     if (stat.num_iterations != 0) {
       stat.loss /= static_cast<float>(stat.num_iterations);
     } else {
       std::cerr << "stat.num_iterations is 0" << std::endl;
       return;
     }
-    stat.accuracy = stat.num_correct_predictions /
-                    static_cast<float>(stat.num_iterations * batch_size) *
-                    100.0f;
+    stat.accuracy =
+      stat.num_correct_predictions / static_cast<float>(num_samples) * 100.0f;
 
     if (stat.accuracy > max_acc ||
         (stat.accuracy == max_acc && stat.loss < min_loss)) {
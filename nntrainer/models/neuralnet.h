@@ -66,6 +66,8 @@ using NetType = ml::train::ModelType;
 using ExecutionMode = ml::train::ExecutionMode;
 
 class DataBuffer;
+class FeatureCache;
+class PrefixCache;
 using DatasetType = ml::train::DatasetType;
 using DatasetModeType = ml::train::DatasetModeType;
 using RunStats = ml::train::RunStats;
@@ -393,6 +395,45 @@ s   * @retval shared_ptr<const Tensor>
                                            unsigned int init_seq_len,
                                            unsigned int from, unsigned int to);
 
+  /**
+   * @brief     Run an incremental inference step in which every batch is an
+   * independent sequence at its own position
+   * @param[in] X input tensors holding a single token of every batch
+   * @param[in] positions position of the token of every batch
+   * @retval    output tensors of the step
+   */
+  sharedConstTensors
+  incremental_inference(sharedConstTensors X,
+                        const std::vector<unsigned int> &positions);
+
+  /**
+   * @brief     Run the incremental inference over a prompt in chunks, each of
+   * which attends the caches filled by the chunks before
+   * @param[in] X input tensors of which the elements [0, to) of every batch
+   * hold the tokens of the prompt
+   * @param[in] init_seq_len initial sequence length
+   * @param[in] to number of the tokens of the prompt
+   * @param[in] chunk_size number of the tokens of a chunk at most
+   * @param[in] prefix_cache cache of the prefixes to restore the rows of the
+   * first tokens from and to store the rows of the prompt to, nullptr if none
+   * @retval    output tensors at the last token of the prompt
+   * @note      a prefix cache takes a single sequence, the batch size must be
+   * 1 to use it
+   */
+  sharedConstTensors incremental_prefill(sharedConstTensors X,
+                                         unsigned int init_seq_len,
+                                         unsigned int to,
+                                         unsigned int chunk_size,
+                                         PrefixCache *prefix_cache = nullptr);
+
+  /**
+   * @brief     Get the key/value caches of the layers, allocating the tensors
+   * for the inference if not yet
+   * @retval    cache_key and cache_value tensors of every layer keeping them,
+   * with the scales of the int8 caches
+   */
+  std::vector<Tensor *> getKVCaches();
+
   /**
    * @brief     Run the incremental inference of the model
    * @param[in] batch batch size of current input
@@ -629,7 +670,9 @@ private:
                props::ContinueTrain, props::SaveBestPath,
                props::MemoryOptimization, props::MemorySwap,
                props::MemorySwapPath, props::MemorySwapLookahead,
-               props::TensorFormat, props::ModelTensorDataType>;
+               props::TensorFormat, props::ModelTensorDataType,
+               props::AccumulationSteps, props::CheckpointSegments,
+               props::FeatureCache, props::FeatureCachePath>;
   using RigidPropTypes =
     std::tuple<props::LossType, std::vector<props::InputConnection>,
                std::vector<props::LabelLayer>, props::ClipGradByGlobalNorm,
@@ -719,6 +762,27 @@ private:
       [](void *) { return false; },
     void *data = nullptr);
 
+  /**
+   * @brief     forward propagation of a training iteration which skips the
+   * frozen layers when the features of all the samples are cached, and
+   * caches the features of the new samples otherwise
+   * @param[in] cache cached features
+   * @param[in] frozen_layers number of the frozen layers from the beginning
+   * of the sorted graph
+   * @param[in] feature_node frozen layer which outputs the features
+   * @param[in] feature_idx index of the output
+   * @param[in] indices dataset indices of the samples of the iteration
+   * @param[in] stop_cb callback function to decide stop training or not
+   * @param[in] user_data user data used for stop_cb
+   * @retval    output tensors
+   */
+  sharedConstTensors forwarding(FeatureCache &cache, unsigned int frozen_layers,
+                                LayerNode &feature_node,
+                                unsigned int feature_idx,
+                                const std::vector<unsigned int> &indices,
+                                std::function<bool(void *)> stop_cb,
+                                void *user_data);
+
   /**
    * @brief     Swap function for the class
    */
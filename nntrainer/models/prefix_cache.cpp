@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   prefix_cache.cpp
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Cache of the key/value rows of the prompt prefixes already computed
+ */
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+#include <nntrainer_error.h>
+#include <prefix_cache.h>
+
+namespace nntrainer {
+
+PrefixCache::PrefixCache(unsigned int block_size_, unsigned int max_blocks_) :
+  block_size(block_size_),
+  max_blocks(max_blocks_),
+  num_restored_tokens(0) {
+  NNTR_THROW_IF(block_size == 0 || max_blocks == 0, std::invalid_argument)
+    << "PrefixCache: block_size and max_blocks must be positive";
+}
+
+size_t
+PrefixCache::hashBlock(size_t parent,
+                       std::vector<unsigned int>::const_iterator begin) const {
+  size_t hash = parent;
+  for (unsigned int i = 0; i < block_size; ++i)
+    hash ^= std::hash<unsigned int>()(begin[i]) + 0x9e3779b9 + (hash << 6) +
+            (hash >> 2);
+  return hash;
+}
+
+PrefixCache::Block *
+PrefixCache::find(size_t hash, size_t parent,
+                  std::vector<unsigned int>::const_iterator begin) {
+  auto iter = blocks.find(hash);
+  if (iter == blocks.end())
+    return nullptr;
+
+  /** a different prefix of the same hash is not a hit */
+  Block &block = iter->second;
+  if (block.parent != parent ||
+      !std::equal(block.tokens.begin(), block.tokens.end(), begin))
+    return nullptr;
+
+  return &block;
+}
+
+Tensor PrefixCache::getRows(Tensor &cache, unsigned int block) const {
+  TensorDim dim = cache.getDim();
+  NNTR_THROW_IF(dim.channel() != 1, std::invalid_argument)
+    << "PrefixCache: a cache must be of a single channel, cache: " << dim;
+  NNTR_THROW_IF((block + 1) * block_size > dim.height(), std::invalid_argument)
+    << "PrefixCache: block " << block << " exceeds the cache: " << dim;
+
+  dim.batch(1);
+  dim.height(block_size);
+  return cache.getSharedDataTensor(dim, block * block_size * dim.width());
+}
+
+unsigned int PrefixCache::restore(const std::vector<unsigned int> &tokens,
+                                  const std::vector<Tensor *> &caches) {
+  if (tokens.empty())
+    return 0;
+
+  std::vector<Block *> hits;
+  size_t parent = 0;
+  for (unsigned int b = 0; (b + 1) * block_size < tokens.size(); ++b) {
+    auto begin = tokens.begin() + b * block_size;
+    size_t hash = hashBlock(parent, begin);
+    Block *block = find(hash, parent, begin);
+    if (block == nullptr)
+      break;
+
+    NNTR_THROW_IF(block->rows.size() != caches.size(), std::invalid_argument)
+      << "PrefixCache: number of the caches: " << caches.size()
+      << " is not matched with the cached: " << block->rows.size();
+
+    for (unsigned int i = 0; i < caches.size(); ++i)
+      getRows(*caches[i], b).copyData(block->rows[i]);
+
+    hits.push_back(block);
+    parent = hash;
+  }
+
+  /** the prefix is used more recently than the blocks following it */
+  for (auto iter = hits.rbegin(); iter != hits.rend(); ++iter)
+    usage.splice(usage.begin(), usage, (*iter)->usage);
+
+  unsigned int num_tokens = hits.size() * block_size;
+  num_restored_tokens += num_tokens;
+  return num_tokens;
+}
+
+void PrefixCache::store(const std::vector<unsigned int> &tokens,
+                        const std::vector<Tensor *> &caches) {
+  std::vector<size_t> chain;
+  size_t parent = 0;
+  for (unsigned int b = 0; (b + 1) * block_size <= tokens.size(); ++b) {
+    auto begin = tokens.begin() + b * block_size;
+    size_t hash = hashBlock(parent, begin);
+    Block *block = find(hash, parent, begin);
+
+    if (block == nullptr) {
+      /** a colliding block of another prefix is replaced */
+      auto found = blocks.find(hash);
+      if (found != blocks.end()) {
+        usage.erase(found->second.usage);
+        blocks.erase(found);
+      }
+
+      if (blocks.size() == max_blocks) {
+        blocks.erase(usage.back());
+        usage.pop_back();
+      }
+
+      usage.push_front(hash);
+      block = &blocks[hash];
+      block->parent = parent;
+      block->tokens.assign(begin, begin + block_size);
+      block->usage = usage.begin();
+      for (auto &cache : caches) {
+        Tensor rows = getRows(*cache, b);
+        block->rows.emplace_back(rows.getDim());
+        block->rows.back().copyData(rows);
+      }
+    } else {
+      usage.splice(usage.begin(), usage, block->usage);
+    }
+
+    chain.push_back(hash);
+    parent = hash;
+  }
+
+  /** a block of the chain may be evicted already if the chain is longer than
+   * max_blocks */
+  for (auto iter = chain.rbegin(); iter != chain.rend(); ++iter) {
+    auto found = blocks.find(*iter);
+    if (found != blocks.end())
+      usage.splice(usage.begin(), usage, found->second.usage);
+  }
+}
+
+} // namespace nntrainer
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   prefix_cache.h
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Cache of the key/value rows of the prompt prefixes already computed
+ *
+ * A prompt is split into blocks of a fixed number of tokens. A block is keyed
+ * by the hash of all the tokens up to its end, chained from the hash of the
+ * block before, so a block is only found after the same prefix. When a prompt
+ * starts with blocks already cached, their rows are copied back into the
+ * key/value caches of the attention layers and the prefill starts after them.
+ */
+
+#ifndef __PREFIX_CACHE_H__
+#define __PREFIX_CACHE_H__
+#ifdef __cplusplus
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include <tensor.h>
+
+namespace nntrainer {
+
+/**
+ * @class   PrefixCache
+ * @brief   key/value cache rows of the token blocks by the hash of the prefix,
+ * evicting the least recently used block
+ */
+class PrefixCache {
+public:
+  /**
+   * @brief Construct a new Prefix Cache object
+   *
+   * @param block_size number of the tokens of a block
+   * @param max_blocks number of the blocks kept at most
+   */
+  PrefixCache(unsigned int block_size, unsigned int max_blocks);
+
+  /**
+   * @brief Copy the rows of the longest cached prefix of the tokens into the
+   * caches of the first batch
+   *
+   * @param tokens prompt tokens
+   * @param caches key/value caches of the model
+   * @return unsigned int number of the tokens restored, a multiple of the
+   * block size less than the number of the tokens so the last token is always
+   * computed
+   */
+  unsigned int restore(const std::vector<unsigned int> &tokens,
+                       const std::vector<Tensor *> &caches);
+
+  /**
+   * @brief Store the rows of the full blocks of the tokens from the caches of
+   * the first batch
+   *
+   * @param tokens prompt tokens of which the caches hold the rows
+   * @param caches key/value caches of the model
+   */
+  void store(const std::vector<unsigned int> &tokens,
+             const std::vector<Tensor *> &caches);
+
+  /**
+   * @brief Get the number of the tokens of a block
+   */
+  unsigned int getBlockSize() const { return block_size; }
+
+  /**
+   * @brief Get the number of the cached blocks
+   */
+  size_t size() const { return blocks.size(); }
+
+  /**
+   * @brief Get the number of the tokens restored so far
+   */
+  size_t getNumRestoredTokens() const { return num_restored_tokens; }
+
+private:
+  /**
+   * @brief rows of a block
+   */
+  struct Block {
+    size_t parent;                     /**< hash of the prefix before */
+    std::vector<unsigned int> tokens;  /**< tokens of the block */
+    std::vector<Tensor> rows;          /**< rows of every cache */
+    std::list<size_t>::iterator usage; /**< place in the usage order */
+  };
+
+  /**
+   * @brief Get the hash of the prefix ending with the block
+   *
+   * @param parent hash of the prefix before the block
+   * @param begin first token of the block
+   */
+  size_t hashBlock(size_t parent,
+                   std::vector<unsigned int>::const_iterator begin) const;
+
+  /**
+   * @brief Find the block following the prefix
+   *
+   * @return Block* the block, nullptr if not cached
+   */
+  Block *find(size_t hash, size_t parent,
+              std::vector<unsigned int>::const_iterator begin);
+
+  /**
+   * @brief Get the rows of a block in the cache of the first batch
+   *
+   * @param cache key/value cache
+   * @param block index of the block
+   */
+  Tensor getRows(Tensor &cache, unsigned int block) const;
+
+  unsigned int block_size; /**< number of the tokens of a block */
+  unsigned int max_blocks; /**< number of the blocks kept at most */
+
+  std::unordered_map<size_t, Block> blocks; /**< blocks by the prefix hash */
+  std::list<size_t> usage; /**< hashes, the most recently used first */
+  size_t num_restored_tokens; /**< tokens restored so far */
+};
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __PREFIX_CACHE_H__ */
@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   speculative_decoder.cpp
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Greedy speculative decoding of a target model with a draft model
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include <neuralnet.h>
+#include <nntrainer_error.h>
+#include <speculative_decoder.h>
+#include <util_simd.h>
+
+namespace nntrainer {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Get the seconds since the time point
+ */
+double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
+SpeculativeDecoder::SpeculativeDecoder(NeuralNetwork &target_,
+                                       NeuralNetwork &draft_,
+                                       unsigned int num_draft_tokens_,
+                                       unsigned int max_length_,
+                                       unsigned int eos_) :
+  target(target_),
+  draft(draft_),
+  num_draft_tokens(num_draft_tokens_),
+  max_length(max_length_),
+  eos(eos_) {
+  NNTR_THROW_IF(num_draft_tokens == 0 || max_length == 0,
+                std::invalid_argument)
+    << "SpeculativeDecoder: num_draft_tokens and max_length must be positive";
+
+  for (NeuralNetwork *model : {&target, &draft}) {
+    auto input_dims = model->getInputDimension();
+    NNTR_THROW_IF(input_dims.empty() || input_dims.size() > 2,
+                  std::invalid_argument)
+      << "SpeculativeDecoder: a model must take the tokens and optionally the "
+         "positions, number of inputs: "
+      << input_dims.size();
+    for (auto &dim : input_dims) {
+      NNTR_THROW_IF(dim.getFeatureLen() < max_length, std::invalid_argument)
+        << "SpeculativeDecoder: an input must hold max_length: " << max_length
+        << " tokens, input: " << dim;
+    }
+  }
+}
+
+sharedConstTensors
+SpeculativeDecoder::run(NeuralNetwork &model,
+                        const std::vector<unsigned int> &tokens,
+                        unsigned int from) {
+  auto input_dims = model.getInputDimension();
+
+  sharedConstTensors inputs;
+  for (unsigned int i = 0; i < input_dims.size(); ++i) {
+    input_dims[i].batch(1);
+    Tensor input(input_dims[i]);
+    input.setZero();
+
+    float *data = input.getData();
+    for (unsigned int j = 0; j < tokens.size(); ++j)
+      data[j] = static_cast<float>(i == 0 ? tokens[j] : from + j);
+    inputs.push_back(MAKE_SHARED_TENSOR(input));
+  }
+
+  return model.incremental_inference(inputs, max_length, from,
+                                     from + tokens.size());
+}
+
+unsigned int SpeculativeDecoder::argmax(const Tensor &logits,
+                                        unsigned int row) {
+  NNTR_THROW_IF(logits.getDataType() != Tdatatype::FP32, std::runtime_error)
+    << "SpeculativeDecoder: the logits must be FP32";
+
+  const unsigned int num_vocab = logits.width();
+  const float *data = logits.getData() + (size_t)row * num_vocab;
+  return nntrainer::argmax(num_vocab, data);
+}
+
+std::vector<unsigned int>
+SpeculativeDecoder::generate(const std::vector<unsigned int> &prompt,
+                             unsigned int max_new_tokens) {
+  NNTR_THROW_IF(prompt.empty(), std::invalid_argument)
+    << "SpeculativeDecoder: prompt is empty";
+  NNTR_THROW_IF(prompt.size() >= max_length, std::invalid_argument)
+    << "SpeculativeDecoder: prompt of " << prompt.size()
+    << " tokens leaves no room in max_length: " << max_length;
+
+  std::vector<unsigned int> sequence = prompt;
+  std::vector<unsigned int> generated;
+
+  /** number of the leading tokens of which the caches hold the rows */
+  unsigned int target_len = 0;
+  unsigned int draft_len = 0;
+
+  bool finished = max_new_tokens == 0;
+  while (!finished) {
+    const unsigned int len = sequence.size();
+    /** the target step ends at the last proposal, which must fit the cache,
+     * and yields one token after the proposals kept */
+    const unsigned int num_proposals =
+      std::min({num_draft_tokens,
+                max_new_tokens - (unsigned int)generated.size() - 1,
+                max_length - len});
+
+    std::vector<unsigned int> proposals;
+    if (num_proposals > 0) {
+      auto start = Clock::now();
+      std::vector<unsigned int> tokens(sequence.begin() + draft_len,
+                                       sequence.end());
+      unsigned int from = draft_len;
+      for (unsigned int i = 0; i < num_proposals; ++i) {
+        auto out = run(draft, tokens, from);
+        proposals.push_back(argmax(*out[0], tokens.size() - 1));
+        from += tokens.size();
+        tokens = {proposals.back()};
+        stats.draft_passes++;
+      }
+      /** the last proposal is not read by the draft model */
+      draft_len = from;
+      stats.draft_time += secondsSince(start);
+    }
+
+    auto start = Clock::now();
+    std::vector<unsigned int> tokens(sequence.begin() + target_len,
+                                     sequence.end());
+    tokens.insert(tokens.end(), proposals.begin(), proposals.end());
+    auto out = run(target, tokens, target_len);
+
+    /** row of the last token of the sequence predicts the first proposal */
+    const unsigned int row = len - 1 - target_len;
+    unsigned int num_accepted = 0;
+    unsigned int token = argmax(*out[0], row);
+    while (num_accepted < num_proposals && token == proposals[num_accepted]) {
+      num_accepted++;
+      token = argmax(*out[0], row + num_accepted);
+    }
+    stats.target_passes++;
+    stats.target_time += secondsSince(start);
+    stats.drafted += num_proposals;
+    stats.accepted += num_accepted;
+
+    /** roll back the rows of the rejected proposals */
+    target_len = len + num_accepted;
+    draft_len = std::min(draft_len, len + num_accepted);
+
+    proposals.resize(num_accepted);
+    proposals.push_back(token);
+    for (unsigned int t : proposals) {
+      sequence.push_back(t);
+      generated.push_back(t);
+      stats.generated++;
+      if (t == eos || generated.size() == max_new_tokens ||
+          sequence.size() == max_length) {
+        finished = true;
+        break;
+      }
+    }
+  }
+
+  return generated;
+}
+
+} // namespace nntrainer
@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   speculative_decoder.h
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Greedy speculative decoding of a target model with a draft model
+ *
+ * A small draft model proposes the next k tokens one by one. The target model
+ * reads all of them in a single incremental step and keeps the proposals up to
+ * the first one it would not have chosen, followed by its own token. The
+ * output is the same as decoding the target model token by token, while the
+ * target weights are read once for up to k + 1 tokens.
+ */
+
+#ifndef __SPECULATIVE_DECODER_H__
+#define __SPECULATIVE_DECODER_H__
+#ifdef __cplusplus
+
+#include <limits>
+#include <vector>
+
+#include <tensor.h>
+
+namespace nntrainer {
+
+class NeuralNetwork;
+
+/**
+ * @class   SpeculativeDecoder
+ * @brief   decodes a target model greedily with the tokens proposed by a draft
+ * model
+ *
+ * Both models take the tokens in the first input and, if any, the positions
+ * in the second input, one element per token, and give the logits of every
+ * token in the rows of the first output. A rejected proposal is rolled back
+ * by moving the position a model continues from back to the last accepted
+ * token: the attention only reads the cache rows before the end of a step and
+ * the next step overwrites the rows from its start.
+ */
+class SpeculativeDecoder {
+public:
+  static constexpr unsigned int NO_TOKEN =
+    std::numeric_limits<unsigned int>::max(); /**< no end of sequence token */
+
+  /**
+   * @brief statistics of the decoding so far
+   */
+  struct Stats {
+    size_t drafted = 0;         /**< tokens proposed by the draft model */
+    size_t accepted = 0;        /**< proposals kept by the target model */
+    size_t generated = 0;       /**< tokens generated */
+    size_t target_passes = 0;   /**< incremental steps of the target model */
+    size_t draft_passes = 0;    /**< incremental steps of the draft model */
+    double target_time = 0.0;   /**< seconds spent in the target model */
+    double draft_time = 0.0;    /**< seconds spent in the draft model */
+
+    /**
+     * @brief Get the ratio of the proposals kept
+     */
+    double acceptanceRate() const {
+      return drafted ? (double)accepted / drafted : 0.0;
+    }
+
+    /**
+     * @brief Get the tokens generated per step of the target model, which is
+     * the speedup over decoding token by token when the target model bounds
+     * the time
+     */
+    double speedup() const {
+      return target_passes ? (double)generated / target_passes : 0.0;
+    }
+  };
+
+  /**
+   * @brief Construct a new Speculative Decoder object
+   *
+   * @param target initialized target model
+   * @param draft initialized draft model of the same vocabulary
+   * @param num_draft_tokens number of the tokens proposed in a step
+   * @param max_length maximum number of the tokens of a sequence, bounded by
+   * the inputs and the caches of both models
+   * @param eos end of sequence token, NO_TOKEN if there is none
+   */
+  SpeculativeDecoder(NeuralNetwork &target, NeuralNetwork &draft,
+                     unsigned int num_draft_tokens, unsigned int max_length,
+                     unsigned int eos = NO_TOKEN);
+
+  /**
+   * @brief Generate the tokens following the prompt
+   *
+   * @param prompt prompt tokens
+   * @param max_new_tokens maximum number of the tokens to generate
+   * @return std::vector<unsigned int> generated tokens
+   */
+  std::vector<unsigned int> generate(const std::vector<unsigned int> &prompt,
+                                     unsigned int max_new_tokens);
+
+  /**
+   * @brief Get the statistics
+   */
+  const Stats &getStats() const { return stats; }
+
+private:
+  /**
+   * @brief Run an incremental step over the tokens from the position
+   *
+   * @param model model to run
+   * @param tokens tokens of the step
+   * @param from position of the first token
+   * @return sharedConstTensors outputs of which the first holds the logits
+   */
+  sharedConstTensors run(NeuralNetwork &model,
+                         const std::vector<unsigned int> &tokens,
+                         unsigned int from);
+
+  /**
+   * @brief Get the most likely token of a row of the logits
+   */
+  static unsigned int argmax(const Tensor &logits, unsigned int row);
+
+  NeuralNetwork &target;         /**< model generating the tokens */
+  NeuralNetwork &draft;          /**< model proposing the tokens */
+  unsigned int num_draft_tokens; /**< tokens proposed in a step */
+  unsigned int max_length;       /**< maximum tokens of a sequence */
+  unsigned int eos;              /**< end of sequence token */
+  Stats stats;                   /**< statistics of the decoding */
+};
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __SPECULATIVE_DECODER_H__ */
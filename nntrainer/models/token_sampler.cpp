@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   token_sampler.cpp
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Sampling of the next token from the logits of a language model
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include <nntrainer_error.h>
+#include <token_sampler.h>
+#include <util_simd.h>
+
+namespace nntrainer {
+
+namespace {
+
+/**
+ * @brief fill the k tokens of the largest logits in descending order
+ *
+ * A min-heap of k tokens is kept over a single pass, so most of the
+ * vocabulary is rejected by a comparison with the smallest one kept.
+ */
+void selectTopK(const float *logits, unsigned int num_vocab, unsigned int k,
+                std::vector<unsigned int> &selected) {
+  auto before = [logits](unsigned int a, unsigned int b) {
+    return logits[a] > logits[b] || (logits[a] == logits[b] && a < b);
+  };
+
+  selected.resize(k);
+  if (k == 0)
+    return;
+
+  std::iota(selected.begin(), selected.end(), 0);
+  std::make_heap(selected.begin(), selected.end(), before);
+
+  for (unsigned int i = k; i < num_vocab; ++i) {
+    if (logits[i] <= logits[selected.front()])
+      continue;
+    std::pop_heap(selected.begin(), selected.end(), before);
+    selected.back() = i;
+    std::push_heap(selected.begin(), selected.end(), before);
+  }
+
+  std::sort_heap(selected.begin(), selected.end(), before);
+}
+
+} // namespace
+
+TokenSampler::TokenSampler(const Options &options_, unsigned int seed) :
+  options(options_),
+  rng(seed) {
+  NNTR_THROW_IF(!(options.temperature >= 0.0f), std::invalid_argument)
+    << "TokenSampler: temperature must not be negative, temperature: "
+    << options.temperature;
+  NNTR_THROW_IF(!(options.top_p > 0.0f && options.top_p <= 1.0f),
+                std::invalid_argument)
+    << "TokenSampler: top_p must be in (0, 1], top_p: " << options.top_p;
+  NNTR_THROW_IF(!(options.repetition_penalty > 0.0f), std::invalid_argument)
+    << "TokenSampler: repetition_penalty must be positive, penalty: "
+    << options.repetition_penalty;
+}
+
+void TokenSampler::penalize(float *logits, unsigned int num_vocab,
+                            const std::vector<unsigned int> &history) {
+  if (options.repetition_penalty != 1.0f && !history.empty()) {
+    /** a token is penalized once however often it is repeated */
+    penalized.assign(history.begin(), history.end());
+    std::sort(penalized.begin(), penalized.end());
+    penalized.erase(std::unique(penalized.begin(), penalized.end()),
+                    penalized.end());
+    NNTR_THROW_IF(penalized.back() >= num_vocab, std::invalid_argument)
+      << "TokenSampler: token " << penalized.back()
+      << " of the history is out of the vocabulary of " << num_vocab;
+
+    for (unsigned int token : penalized) {
+      float &logit = logits[token];
+      logit = logit < 0.0f ? logit * options.repetition_penalty
+                           : logit / options.repetition_penalty;
+    }
+  }
+
+  for (unsigned int token : options.bad_words) {
+    NNTR_THROW_IF(token >= num_vocab, std::invalid_argument)
+      << "TokenSampler: bad word " << token
+      << " is out of the vocabulary of " << num_vocab;
+    logits[token] = -std::numeric_limits<float>::infinity();
+  }
+}
+
+unsigned int TokenSampler::sample(float *logits, unsigned int num_vocab,
+                                  const std::vector<unsigned int> &history) {
+  NNTR_THROW_IF(num_vocab == 0, std::invalid_argument)
+    << "TokenSampler: the vocabulary is empty";
+
+  penalize(logits, num_vocab, history);
+
+  if (options.temperature == 0.0f || options.top_k == 1)
+    return argmax(num_vocab, logits);
+
+  const float scale = 1.0f / options.temperature;
+  unsigned int num_candidates = num_vocab;
+  bool sorted = false;
+
+  if (options.top_k != 0 && options.top_k < num_vocab) {
+    /** only the candidates are exponentiated, then scattered back */
+    num_candidates = options.top_k;
+    selectTopK(logits, num_vocab, num_candidates, candidates);
+    probs.resize(num_candidates);
+    for (unsigned int j = 0; j < num_candidates; ++j)
+      probs[j] = logits[candidates[j]];
+    softmax_row_fused(num_candidates, probs.data(), scale, nullptr,
+                      num_candidates, 0.0f, 0, nullptr);
+    for (unsigned int j = 0; j < num_candidates; ++j)
+      logits[candidates[j]] = probs[j];
+    sorted = true;
+  } else {
+    softmax_row_fused(num_vocab, logits, scale, nullptr, num_vocab, 0.0f, 0,
+                      nullptr);
+    if (options.top_p >= 1.0f)
+      return draw(logits, nullptr, num_vocab, 1.0f);
+    candidates.resize(num_vocab);
+    std::iota(candidates.begin(), candidates.end(), 0);
+  }
+
+  float mass = 1.0f;
+  if (options.top_p < 1.0f)
+    num_candidates = nucleus(logits, num_candidates, sorted, mass);
+
+  return draw(logits, candidates.data(), num_candidates, mass);
+}
+
+std::vector<unsigned int> TokenSampler::sampleBatch(
+  float *logits, unsigned int batch, unsigned int num_vocab,
+  const std::vector<std::vector<unsigned int>> &histories) {
+  NNTR_THROW_IF(!histories.empty() && histories.size() != batch,
+                std::invalid_argument)
+    << "TokenSampler: number of the histories: " << histories.size()
+    << " is not matched with the batch: " << batch;
+
+  static const std::vector<unsigned int> no_history;
+  std::vector<unsigned int> tokens;
+  tokens.reserve(batch);
+  for (unsigned int b = 0; b < batch; ++b)
+    tokens.push_back(sample(logits + (size_t)b * num_vocab, num_vocab,
+                            histories.empty() ? no_history : histories[b]));
+
+  return tokens;
+}
+
+std::vector<unsigned int> TokenSampler::topK(const float *logits,
+                                             unsigned int num_vocab,
+                                             unsigned int k) {
+  NNTR_THROW_IF(k > num_vocab, std::invalid_argument)
+    << "TokenSampler: " << k << " tokens are requested from the vocabulary of "
+    << num_vocab;
+
+  std::vector<unsigned int> selected;
+  selectTopK(logits, num_vocab, k, selected);
+  return selected;
+}
+
+unsigned int TokenSampler::nucleus(const float *probs,
+                                   unsigned int num_candidates, bool sorted,
+                                   float &mass) {
+  auto before = [probs](unsigned int a, unsigned int b) {
+    return probs[a] > probs[b] || (probs[a] == probs[b] && a < b);
+  };
+
+  /** the candidates are ordered in growing blocks, as far as needed */
+  unsigned int sorted_end = sorted ? num_candidates : 0;
+  unsigned int kept = 0;
+  mass = 0.0f;
+  while (kept < num_candidates) {
+    if (kept == sorted_end) {
+      unsigned int next =
+        std::min(num_candidates, std::max(64u, sorted_end * 4));
+      std::partial_sort(candidates.begin() + sorted_end,
+                        candidates.begin() + next,
+                        candidates.begin() + num_candidates, before);
+      sorted_end = next;
+    }
+
+    mass += probs[candidates[kept++]];
+    if (mass >= options.top_p)
+      break;
+  }
+
+  return kept;
+}
+
+unsigned int TokenSampler::draw(const float *probs, const unsigned int *tokens,
+                                unsigned int num_candidates, float mass) {
+  std::uniform_real_distribution<float> uniform(0.0f, mass);
+  const float u = uniform(rng);
+
+  float acc = 0.0f;
+  for (unsigned int j = 0; j < num_candidates; ++j) {
+    unsigned int token = tokens ? tokens[j] : j;
+    acc += probs[token];
+    if (u < acc)
+      return token;
+  }
+
+  /** rounding left u beyond the sum, the most probable one is taken */
+  return tokens ? tokens[0] : argmax(num_candidates, probs);
+}
+
+} /* namespace nntrainer */
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   token_sampler.h
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Sampling of the next token from the logits of a language model
+ *
+ * The logits are penalized, the top-k candidates are picked with a bounded
+ * heap instead of sorting the vocabulary, and the softmax of the candidates is
+ * vectorized. The top-p cutoff only orders the candidates until the
+ * cumulative probability is reached.
+ */
+
+#ifndef __TOKEN_SAMPLER_H__
+#define __TOKEN_SAMPLER_H__
+#ifdef __cplusplus
+
+#include <random>
+#include <vector>
+
+namespace nntrainer {
+
+/**
+ * @class   TokenSampler
+ * @brief   picks the next token from the logits with temperature, top-k,
+ * top-p, repetition penalty and bad words
+ */
+class TokenSampler {
+public:
+  /**
+   * @brief options of the sampling
+   */
+  struct Options {
+    float temperature = 1.0f; /**< 0 picks the most probable token */
+    unsigned int top_k = 0;   /**< candidates to keep, 0 keeps all */
+    float top_p = 1.0f;       /**< cumulative probability to keep */
+    float repetition_penalty = 1.0f;     /**< 1 disables the penalty */
+    std::vector<unsigned int> bad_words; /**< tokens never picked */
+  };
+
+  /**
+   * @brief Construct a new Token Sampler object
+   *
+   * @param options options of the sampling
+   * @param seed seed of the random number generator
+   */
+  TokenSampler(const Options &options, unsigned int seed);
+
+  /**
+   * @brief Pick the next token of a sequence
+   *
+   * @param logits logits of the vocabulary, overwritten while sampling
+   * @param num_vocab size of the vocabulary
+   * @param history tokens of the sequence so far for the repetition penalty
+   * @return unsigned int token picked
+   */
+  unsigned int sample(float *logits, unsigned int num_vocab,
+                      const std::vector<unsigned int> &history = {});
+
+  /**
+   * @brief Pick the next token of every sequence of a batch
+   *
+   * @param logits batch rows of num_vocab logits, overwritten while sampling
+   * @param batch number of the sequences
+   * @param num_vocab size of the vocabulary
+   * @param histories tokens of every sequence so far, empty if not penalized
+   * @return std::vector<unsigned int> token picked for every sequence
+   */
+  std::vector<unsigned int>
+  sampleBatch(float *logits, unsigned int batch, unsigned int num_vocab,
+              const std::vector<std::vector<unsigned int>> &histories = {});
+
+  /**
+   * @brief Get the k most probable tokens without sampling
+   *
+   * @param logits logits of the vocabulary
+   * @param num_vocab size of the vocabulary
+   * @param k number of the tokens
+   * @return std::vector<unsigned int> tokens in descending order of the logit
+   */
+  static std::vector<unsigned int> topK(const float *logits,
+                                        unsigned int num_vocab,
+                                        unsigned int k);
+
+  /**
+   * @brief Apply the repetition penalty and the bad words to the logits
+   *
+   * @param logits logits of the vocabulary, penalized in place
+   * @param num_vocab size of the vocabulary
+   * @param history tokens of the sequence so far
+   */
+  void penalize(float *logits, unsigned int num_vocab,
+                const std::vector<unsigned int> &history);
+
+  /**
+   * @brief Reset the random number generator
+   *
+   * @param seed seed of the random number generator
+   */
+  void setSeed(unsigned int seed) { rng.seed(seed); }
+
+  /**
+   * @brief Get the options
+   */
+  const Options &getOptions() const { return options; }
+
+private:
+
+  /**
+   * @brief Keep the most probable candidates until the cumulative
+   * probability reaches top_p
+   *
+   * @param probs probability of every token
+   * @param num_candidates number of the candidates
+   * @param sorted true if the candidates are in descending order
+   * @param[out] mass cumulative probability of the kept candidates
+   * @return unsigned int number of the kept candidates, which lead candidates
+   */
+  unsigned int nucleus(const float *probs, unsigned int num_candidates,
+                       bool sorted, float &mass);
+
+  /**
+   * @brief Draw a token from the candidates in proportion to the probability
+   *
+   * @param probs probability of every token
+   * @param tokens candidates to draw from, nullptr for the first tokens
+   * @param num_candidates number of the candidates
+   * @param mass sum of the probabilities of the candidates
+   */
+  unsigned int draw(const float *probs, const unsigned int *tokens,
+                    unsigned int num_candidates, float mass);
+
+  Options options;                      /**< options of the sampling */
+  std::mt19937 rng;                     /**< random number generator */
+  std::vector<unsigned int> candidates; /**< scratch of the candidates */
+  std::vector<float> probs;             /**< scratch of the probabilities */
+  std::vector<unsigned int> penalized;  /**< scratch of repeated tokens */
+};
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __TOKEN_SAMPLER_H__ */
@@ -15,6 +15,7 @@
 #include <fstream>
 
 #include <adam.h>
+#include <lazy_tensor.h>
 #include <nntrainer_error.h>
 #include <nntrainer_log.h>
 #include <node_exporter.h>
@@ -22,13 +23,15 @@
 
 namespace nntrainer {
 
-Adam::Adam() : adam_props(PropsB1(), PropsB2(), PropsEpsilon(), TorchRef()) {
+Adam::Adam() :
+  adam_props(PropsB1(), PropsB2(), PropsEpsilon(), TorchRef(), LazyUpdate()) {
   /** default properties */
-  auto &[b1, b2, eps, torch_ref] = adam_props;
+  auto &[b1, b2, eps, torch_ref, lazy_update] = adam_props;
   b1.set(0.9f);
   b2.set(0.999f);
   eps.set(1.0e-7f);
   torch_ref.set(false);
+  lazy_update.set(false);
 }
 
 Adam::~Adam() {}
@@ -63,7 +66,53 @@ double Adam::getUpdatedLearningRate(unsigned int iteration, double ll) const {
   return ll;
 }
 
+bool Adam::supportsSparseGradient() const {
+  return std::get<LazyUpdate>(adam_props).get();
+}
+
+void Adam::applySparseGradient(RunOptimizerContext &context) {
+  Tensor &x_grad = context.getGradient();
+  Tensor &wm = context.getOptimizerVariable(AdamParams::wm);
+  Tensor &wv = context.getOptimizerVariable(AdamParams::wv);
+
+  float beta1 = std::get<PropsB1>(adam_props).get();
+  float beta2 = std::get<PropsB2>(adam_props).get();
+  float epsilon = std::get<PropsEpsilon>(adam_props).get();
+  auto &torch_ref = std::get<TorchRef>(adam_props).get();
+
+  unsigned int iteration = context.getIteration();
+  float biasCorrection1 = 1 - pow(beta1, iteration + 1);
+  float biasCorrection2 = 1 - pow(beta2, iteration + 1);
+  float denom_scale = torch_ref ? 1.0f / sqrtFloat(biasCorrection2) : 1.0f;
+
+  /** the update of each row is written over its gradient */
+  const std::vector<unsigned int> &rows = context.getGradientRows();
+  unsigned int width = x_grad.width();
+  float *g = x_grad.getData<float>();
+  for (size_t k = 0; k < rows.size(); ++k) {
+    float *g_row = g + k * width;
+    float *m_row = wm.getAddress<float>(rows[k] * width);
+    float *v_row = wv.getAddress<float>(rows[k] * width);
+    for (unsigned int i = 0; i < width; ++i) {
+      m_row[i] = beta1 * m_row[i] + (1.0f - beta1) * g_row[i];
+      v_row[i] = beta2 * v_row[i] + (1.0f - beta2) * g_row[i] * g_row[i];
+      g_row[i] = m_row[i] / (sqrtFloat(v_row[i]) * denom_scale + epsilon);
+    }
+  }
+
+  if (torch_ref)
+    context.applyGradient(context.getLearningRate() / biasCorrection1);
+  else
+    context.applyGradient(
+      getUpdatedLearningRate(iteration, context.getLearningRate()));
+}
+
 void Adam::applyGradient(RunOptimizerContext &context) {
+  if (context.isGradientSparse()) {
+    applySparseGradient(context);
+    return;
+  }
+
   Tensor &x_grad = context.getGradient();
 
   auto &beta1 = std::get<PropsB1>(adam_props).get();
@@ -79,16 +128,20 @@ void Adam::applyGradient(RunOptimizerContext &context) {
   Tensor &wm = context.getOptimizerVariable(AdamParams::wm);
   Tensor &wv = context.getOptimizerVariable(AdamParams::wv);
 
-  wm.multiply_i(beta1);
-  wm.add_i(x_grad, 1.0f - beta1);
-
-  wv.multiply_i(beta2);
-  wv.add_i(x_grad.multiply(x_grad), 1.0f - beta2);
+  /** each update is fused to a single pass without temporaries */
+  wm.chain().multiply_i(beta1).add_i(x_grad, 1.0f - beta1).run(wm);
+  x_grad.chain()
+    .multiply_i(x_grad)
+    .multiply_i(1.0f - beta2)
+    .add_i(wv, beta2)
+    .run(wv);
 
   if (torch_ref) {
-    Tensor denom = wv.apply<float>(sqrtFloat<float>);
-    denom.divide_i(sqrtFloat(biasCorrection2));
-    denom.add_i(epsilon);
+    Tensor denom = wv.chain()
+                     .apply(sqrtFloat<float>)
+                     .divide_i(sqrtFloat(biasCorrection2))
+                     .add_i(epsilon)
+                     .run();
     wm.divide(denom, x_grad);
 
     context.applyGradient(context.getLearningRate() / biasCorrection1);
@@ -98,8 +151,7 @@ void Adam::applyGradient(RunOptimizerContext &context) {
       return 1 / (sqrtDouble(f) + epsilon);
     };
 
-    x_grad = wv.apply<float>(sqrtEps, x_grad);
-    x_grad.multiply_i(wm);
+    wv.chain().apply(sqrtEps).multiply_i(wm).run(x_grad);
     context.applyGradient(getUpdatedLearningRate(context.getIteration(),
                                                  context.getLearningRate()));
   }
@@ -62,6 +62,18 @@ public:
   using prop_tag = bool_prop_tag;                 /**< property type */
 };
 
+/**
+ * @brief lazy update of the rows of a sparse gradient
+ * @details the moments and the weight are only updated for the rows that have
+ * a gradient, which differs from adam for the other rows
+ *
+ */
+class LazyUpdate : public Property<bool> {
+public:
+  static constexpr const char *key = "lazy_update"; /**< unique key to access */
+  using prop_tag = bool_prop_tag;                   /**< property type */
+};
+
 /**
  * @class   Adam optimizer class
  * @brief   Adam optimizer
@@ -91,6 +103,11 @@ public:
    */
   void applyGradient(RunOptimizerContext &context) override;
 
+  /**
+   * @copydoc Optimizer::supportsSparseGradient()
+   */
+  bool supportsSparseGradient() const override;
+
   /**
    * @copydoc Optimizer::getType()
    */
@@ -116,7 +133,14 @@ public:
   void setProperty(const std::vector<std::string> &values) override;
 
 private:
-  std::tuple<PropsB1, PropsB2, PropsEpsilon, TorchRef> adam_props;
+  std::tuple<PropsB1, PropsB2, PropsEpsilon, TorchRef, LazyUpdate> adam_props;
+
+  /**
+   * @brief apply a row sparse gradient lazily
+   *
+   * @param context optimizer context
+   */
+  void applySparseGradient(RunOptimizerContext &context);
 
   /**
    * @brief Get updated learning rate
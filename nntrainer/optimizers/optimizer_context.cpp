@@ -42,4 +42,18 @@ Tensor &RunOptimizerContext::getOptimizerVariable(unsigned int idx) const {
 void RunOptimizerContext::applyGradient(double lr) const {
   weight->applyGradient(lr);
 }
+
+/**
+ * @brief   Check if the gradient is row sparse
+ */
+bool RunOptimizerContext::isGradientSparse() const {
+  return weight->isGradientSparse();
+}
+
+/**
+ * @brief   Get the weight rows of a row sparse gradient
+ */
+const std::vector<unsigned int> &RunOptimizerContext::getGradientRows() const {
+  return weight->getGradientRows();
+}
 } // namespace nntrainer
@@ -75,6 +75,22 @@ public:
    */
   void applyGradient(double lr) const;
 
+  /**
+   * @brief   Check if the gradient is row sparse. If so, the k-th row of the
+   * gradient holds the gradient of the getGradientRows()[k]-th row of the
+   * weight and applyGradient() only updates those rows.
+   *
+   * @return true if the gradient is row sparse
+   */
+  bool isGradientSparse() const;
+
+  /**
+   * @brief   Get the weight rows of a row sparse gradient
+   *
+   * @return sorted row indices
+   */
+  const std::vector<unsigned int> &getGradientRows() const;
+
   /**
    * @brief   Get the current iteration value
    *
@@ -50,6 +50,13 @@ public:
    */
   virtual void applyGradient(RunOptimizerContext &context) = 0;
 
+  /**
+   * @brief     check if applyGradient() handles a row sparse gradient, see
+   * RunOptimizerContext::isGradientSparse()
+   * @retval    true if row sparse gradient is supported
+   */
+  virtual bool supportsSparseGradient() const { return false; }
+
   /**
    * @brief     set Optimizer Parameters
    * @param[in] values Optimizer Parameter list
@@ -80,6 +80,10 @@ void OptimizerWrapped::applyGradient(RunOptimizerContext &context) {
   optimizer->applyGradient(context);
 }
 
+bool OptimizerWrapped::supportsSparseGradient() const {
+  return optimizer->supportsSparseGradient();
+}
+
 void OptimizerWrapped::exportTo(Exporter &exporter,
                                 const ml::train::ExportMethods &method) const {
   optimizer->exportTo(exporter, method);
@@ -70,6 +70,7 @@ public:
    * - beta1 : float,
    * - beta2 : float,
    * - epsilon : float,
+   * - lazy_update : bool,
    */
 
   /**
@@ -107,6 +108,12 @@ public:
    */
   void applyGradient(RunOptimizerContext &context);
 
+  /**
+   * @brief     check if the optimizer handles a row sparse gradient
+   * @retval    true if row sparse gradient is supported
+   */
+  bool supportsSparseGradient() const;
+
   /**
    * @brief this function helps exporting the optimizer in a predefined format,
    * while workarounding issue caused by templated function type eraser
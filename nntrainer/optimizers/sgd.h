@@ -41,6 +41,11 @@ public:
    */
   void applyGradient(RunOptimizerContext &context) override;
 
+  /**
+   * @copydoc Optimizer::supportsSparseGradient()
+   */
+  bool supportsSparseGradient() const override { return true; }
+
   /**
    * @copydoc Optimizer::getType()
    */
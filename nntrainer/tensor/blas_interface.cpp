@@ -1020,7 +1020,11 @@ static void ele_mul_fallback(const unsigned int N, const float *X,
                              const float *Y, float *Z, float alpha, float beta,
                              unsigned int i_stride, unsigned int o_stride) {
   for (unsigned int i = 0; i < N; ++i) {
-    *Z = *X * alpha * *Y + beta * *Z;
+    /** like the neon kernels, Z is not read without beta */
+    if (std::abs(beta) > __FLT_MIN__)
+      *Z = *X * alpha * *Y + beta * *Z;
+    else
+      *Z = *X * alpha * *Y;
     X += o_stride;
     Y += i_stride;
     Z += o_stride;
@@ -1031,7 +1035,11 @@ static void ele_add_fallback(const unsigned int N, const float *X,
                              const float *Y, float *Z, float alpha, float beta,
                              unsigned int i_stride, unsigned int o_stride) {
   for (unsigned int i = 0; i < N; ++i) {
-    *Z = *X + alpha * *Y + beta * *Z;
+    /** like the neon kernels, Z is not read without beta */
+    if (std::abs(beta) > __FLT_MIN__)
+      *Z = *X + alpha * *Y + beta * *Z;
+    else
+      *Z = *X + alpha * *Y;
     X += o_stride;
     Y += i_stride;
     Z += o_stride;
@@ -1042,7 +1050,11 @@ static void ele_sub_fallback(const unsigned int N, const float *X,
                              const float *Y, float *Z, float alpha, float beta,
                              unsigned int i_stride, unsigned int o_stride) {
   for (unsigned int i = 0; i < N; ++i) {
-    *Z = *X - alpha * *Y + beta * *Z;
+    /** like the neon kernels, Z is not read without beta */
+    if (std::abs(beta) > __FLT_MIN__)
+      *Z = *X - alpha * *Y + beta * *Z;
+    else
+      *Z = *X - alpha * *Y;
     X += o_stride;
     Y += i_stride;
     Z += o_stride;
@@ -1053,7 +1065,11 @@ static void ele_div_fallback(const unsigned int N, const float *X,
                              const float *Y, float *Z, float alpha, float beta,
                              unsigned int i_stride, unsigned int o_stride) {
   for (unsigned int i = 0; i < N; ++i) {
-    *Z = *X / (alpha * *Y) + beta * *Z;
+    /** like the neon kernels, Z is not read without beta */
+    if (std::abs(beta) > __FLT_MIN__)
+      *Z = *X / (alpha * *Y) + beta * *Z;
+    else
+      *Z = *X / (alpha * *Y);
     X += o_stride;
     Y += i_stride;
     Z += o_stride;
@@ -0,0 +1,585 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   conv2d_kernel.cpp
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ *         https://arxiv.org/abs/1509.09308
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Workspace free convolution kernels
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <blas_interface.h>
+#include <conv2d_kernel.h>
+
+namespace nntrainer {
+
+namespace {
+
+/** number of tiles transformed together before running the gemms */
+constexpr unsigned int WINOGRAD_TILE_BLOCK = 64;
+
+/** maximum input channels for which the direct convolution is chosen */
+constexpr unsigned int DIRECT_MAX_CHANNEL = 4;
+
+/** maximum kernel height and width for which the direct convolution is
+ * chosen, larger kernels make the im2col gemm deep enough */
+constexpr unsigned int DIRECT_MAX_KERNEL = 5;
+
+/** minimum channels for which the Winograd transforms pay off */
+constexpr unsigned int WINOGRAD_MIN_CHANNEL = 8;
+
+/**
+ * @brief transform matrices of Winograd F(m x m, 3 x 3), alpha = m + 2
+ */
+struct WinogradMatrices {
+  unsigned int m;     /**< output tile size */
+  unsigned int alpha; /**< input tile size */
+  const float *BT;    /**< input transform, alpha x alpha */
+  const float *G;     /**< filter transform, alpha x 3 */
+  const float *AT;    /**< output transform, m x alpha */
+};
+
+// clang-format off
+constexpr float BT_2X2[] = {
+  1.0f,  0.0f, -1.0f,  0.0f,
+  0.0f,  1.0f,  1.0f,  0.0f,
+  0.0f, -1.0f,  1.0f,  0.0f,
+  0.0f,  1.0f,  0.0f, -1.0f,
+};
+
+constexpr float G_2X2[] = {
+  1.0f,  0.0f, 0.0f,
+  0.5f,  0.5f, 0.5f,
+  0.5f, -0.5f, 0.5f,
+  0.0f,  0.0f, 1.0f,
+};
+
+constexpr float AT_2X2[] = {
+  1.0f, 1.0f,  1.0f,  0.0f,
+  0.0f, 1.0f, -1.0f, -1.0f,
+};
+
+constexpr float BT_4X4[] = {
+  4.0f,  0.0f, -5.0f,  0.0f, 1.0f, 0.0f,
+  0.0f, -4.0f, -4.0f,  1.0f, 1.0f, 0.0f,
+  0.0f,  4.0f, -4.0f, -1.0f, 1.0f, 0.0f,
+  0.0f, -2.0f, -1.0f,  2.0f, 1.0f, 0.0f,
+  0.0f,  2.0f, -1.0f, -2.0f, 1.0f, 0.0f,
+  0.0f,  4.0f,  0.0f, -5.0f, 0.0f, 1.0f,
+};
+
+constexpr float G_4X4[] = {
+  1.0f / 4,   0.0f,       0.0f,
+  -1.0f / 6,  -1.0f / 6,  -1.0f / 6,
+  -1.0f / 6,  1.0f / 6,   -1.0f / 6,
+  1.0f / 24,  1.0f / 12,  1.0f / 6,
+  1.0f / 24,  -1.0f / 12, 1.0f / 6,
+  0.0f,       0.0f,       1.0f,
+};
+
+constexpr float AT_4X4[] = {
+  1.0f, 1.0f,  1.0f, 1.0f,  1.0f, 0.0f,
+  0.0f, 1.0f, -1.0f, 2.0f, -2.0f, 0.0f,
+  0.0f, 1.0f,  1.0f, 4.0f,  4.0f, 0.0f,
+  0.0f, 1.0f, -1.0f, 8.0f, -8.0f, 1.0f,
+};
+// clang-format on
+
+/** largest alpha supported */
+constexpr unsigned int MAX_ALPHA = 6;
+
+WinogradMatrices getWinogradMatrices(Conv2DAlgorithm algo) {
+  if (algo == Conv2DAlgorithm::WINOGRAD_4X4)
+    return {4, 6, BT_4X4, G_4X4, AT_4X4};
+  return {2, 4, BT_2X2, G_2X2, AT_2X2};
+}
+
+/**
+ * @brief dst (rows x alpha) = src (rows x inner) * mat^T where mat is
+ * alpha x inner
+ */
+inline void multiplyTransposed(const float *src, unsigned int rows,
+                               unsigned int inner, const float *mat,
+                               unsigned int alpha, float *dst) {
+  for (unsigned int r = 0; r < rows; ++r) {
+    for (unsigned int a = 0; a < alpha; ++a) {
+      float sum = 0.0f;
+      for (unsigned int i = 0; i < inner; ++i)
+        sum += src[r * inner + i] * mat[a * inner + i];
+      dst[r * alpha + a] = sum;
+    }
+  }
+}
+
+/**
+ * @brief dst (alpha x cols) = mat (alpha x inner) * src (inner x cols)
+ */
+inline void multiply(const float *mat, unsigned int alpha, unsigned int inner,
+                     const float *src, unsigned int cols, float *dst) {
+  for (unsigned int a = 0; a < alpha; ++a) {
+    for (unsigned int c = 0; c < cols; ++c) {
+      float sum = 0.0f;
+      for (unsigned int i = 0; i < inner; ++i)
+        sum += mat[a * inner + i] * src[i * cols + c];
+      dst[a * cols + c] = sum;
+    }
+  }
+}
+
+/**
+ * @brief output column range [begin, end) whose input column
+ * ow * stride + offset falls inside [0, width)
+ */
+inline void validColumns(int offset, unsigned int stride, int width,
+                         unsigned int out_width, unsigned int &begin,
+                         unsigned int &end) {
+  int b = offset >= 0 ? 0 : (-offset + stride - 1) / stride;
+  int e = width - 1 - offset >= 0 ? (width - 1 - offset) / stride + 1 : 0;
+  begin = std::min<unsigned int>(b, out_width);
+  end = std::max(begin, std::min<unsigned int>(e, out_width));
+}
+
+/**
+ * @brief transpose a depthwise filter [K, KH * KW] to [KH * KW, K] so that
+ * the taps of all the channels are contiguous
+ */
+inline std::vector<float> channelLastFilter(const Conv2DShape &shape,
+                                            const float *filter) {
+  const unsigned int K = shape.out_channel;
+  const unsigned int taps = shape.k_height * shape.k_width;
+  std::vector<float> out(static_cast<size_t>(taps) * K);
+  for (unsigned int o = 0; o < K; ++o)
+    for (unsigned int t = 0; t < taps; ++t)
+      out[t * K + o] = filter[o * taps + t];
+  return out;
+}
+
+} // namespace
+
+Conv2DAlgorithm conv2d_select_algorithm(const Conv2DShape &shape) {
+  bool is_3x3_unit = shape.k_height == 3 && shape.k_width == 3 &&
+                     shape.stride_h == 1 && shape.stride_w == 1 &&
+                     shape.dilation_h == 1 && shape.dilation_w == 1;
+
+  if (is_3x3_unit && shape.in_channel >= WINOGRAD_MIN_CHANNEL &&
+      shape.out_channel >= WINOGRAD_MIN_CHANNEL && shape.out_height >= 4 &&
+      shape.out_width >= 4) {
+    /** larger tiles save more multiplications once there are enough tiles */
+    return shape.out_height >= 16 && shape.out_width >= 16
+             ? Conv2DAlgorithm::WINOGRAD_4X4
+             : Conv2DAlgorithm::WINOGRAD_2X2;
+  }
+
+  /** the gemm is too thin to amortize the im2col copy. The direct kernel
+   * only vectorizes along the output width at unit stride, a strided one
+   * gathers the inputs one by one */
+  if (shape.in_channel <= DIRECT_MAX_CHANNEL && shape.stride_w == 1 &&
+      shape.k_height <= DIRECT_MAX_KERNEL && shape.k_width <= DIRECT_MAX_KERNEL)
+    return Conv2DAlgorithm::DIRECT;
+
+  return Conv2DAlgorithm::IM2COL;
+}
+
+size_t conv2d_winograd_filter_size(const Conv2DShape &shape,
+                                   Conv2DAlgorithm algo) {
+  unsigned int alpha = getWinogradMatrices(algo).alpha;
+  return static_cast<size_t>(alpha) * alpha * shape.out_channel *
+         shape.in_channel;
+}
+
+void conv2d_winograd_transform_filter(const Conv2DShape &shape,
+                                      Conv2DAlgorithm algo,
+                                      const float *filter,
+                                      float *transformed) {
+  const WinogradMatrices w = getWinogradMatrices(algo);
+  const unsigned int alpha = w.alpha;
+  const size_t plane =
+    static_cast<size_t>(shape.out_channel) * shape.in_channel;
+
+  float tmp[MAX_ALPHA * 3];
+  float u[MAX_ALPHA * MAX_ALPHA];
+  for (unsigned int k = 0; k < shape.out_channel; ++k) {
+    for (unsigned int c = 0; c < shape.in_channel; ++c) {
+      const float *g = filter + (k * shape.in_channel + c) * 9;
+      multiply(w.G, alpha, 3, g, 3, tmp);
+      multiplyTransposed(tmp, alpha, 3, w.G, alpha, u);
+      /** stored as alpha * alpha matrices of [out_channel, in_channel] */
+      for (unsigned int i = 0; i < alpha * alpha; ++i)
+        transformed[i * plane + k * shape.in_channel + c] = u[i];
+    }
+  }
+}
+
+void conv2d_winograd(const Conv2DShape &shape, Conv2DAlgorithm algo,
+                     const float *in, const float *transformed, float *out) {
+  const WinogradMatrices w = getWinogradMatrices(algo);
+  const unsigned int m = w.m;
+  const unsigned int alpha = w.alpha;
+  const unsigned int n_elem = alpha * alpha;
+  const unsigned int C = shape.in_channel;
+  const unsigned int K = shape.out_channel;
+  const int H = shape.in_height;
+  const int W = shape.in_width;
+  const int pad_top = shape.pad_top;
+  const int pad_left = shape.pad_left;
+
+  const unsigned int tiles_h = (shape.out_height + m - 1) / m;
+  const unsigned int tiles_w = (shape.out_width + m - 1) / m;
+  const unsigned int tiles = tiles_h * tiles_w;
+  const unsigned int TB = WINOGRAD_TILE_BLOCK;
+
+  std::vector<float> V(static_cast<size_t>(n_elem) * C * TB);
+  std::vector<float> M(static_cast<size_t>(n_elem) * K * TB);
+
+  float d[MAX_ALPHA * MAX_ALPHA];
+  float tmp[MAX_ALPHA * MAX_ALPHA];
+  float v[MAX_ALPHA * MAX_ALPHA];
+
+  for (unsigned int t0 = 0; t0 < tiles; t0 += TB) {
+    const unsigned int tb = std::min(TB, tiles - t0);
+
+    /** 1. input transform, V = B^T d B */
+    for (unsigned int c = 0; c < C; ++c) {
+      const float *plane = in + static_cast<size_t>(c) * H * W;
+      for (unsigned int j = 0; j < tb; ++j) {
+        const unsigned int t = t0 + j;
+        const int y0 = static_cast<int>((t / tiles_w) * m) - pad_top;
+        const int x0 = static_cast<int>((t % tiles_w) * m) - pad_left;
+        for (unsigned int r = 0; r < alpha; ++r) {
+          const int y = y0 + static_cast<int>(r);
+          for (unsigned int s = 0; s < alpha; ++s) {
+            const int x = x0 + static_cast<int>(s);
+            d[r * alpha + s] = (y < 0 || y >= H || x < 0 || x >= W)
+                                 ? 0.0f
+                                 : plane[y * W + x];
+          }
+        }
+        multiply(w.BT, alpha, alpha, d, alpha, tmp);
+        multiplyTransposed(tmp, alpha, alpha, w.BT, alpha, v);
+        for (unsigned int i = 0; i < n_elem; ++i)
+          V[(static_cast<size_t>(i) * C + c) * TB + j] = v[i];
+      }
+    }
+
+    /** 2. element-wise product in the Winograd domain as alpha^2 gemms */
+    for (unsigned int i = 0; i < n_elem; ++i) {
+      sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, K, tb, C, 1.0f,
+            transformed + static_cast<size_t>(i) * K * C, C,
+            V.data() + static_cast<size_t>(i) * C * TB, TB, 0.0f,
+            M.data() + static_cast<size_t>(i) * K * TB, TB);
+    }
+
+    /** 3. output transform, Y = A^T M A */
+    for (unsigned int k = 0; k < K; ++k) {
+      float *plane = out + static_cast<size_t>(k) * shape.out_height *
+                             shape.out_width;
+      for (unsigned int j = 0; j < tb; ++j) {
+        for (unsigned int i = 0; i < n_elem; ++i)
+          v[i] = M[(static_cast<size_t>(i) * K + k) * TB + j];
+        multiply(w.AT, m, alpha, v, alpha, tmp);
+        multiplyTransposed(tmp, m, alpha, w.AT, m, d);
+
+        const unsigned int t = t0 + j;
+        const unsigned int oy = (t / tiles_w) * m;
+        const unsigned int ox = (t % tiles_w) * m;
+        const unsigned int rows = std::min(m, shape.out_height - oy);
+        const unsigned int cols = std::min(m, shape.out_width - ox);
+        for (unsigned int r = 0; r < rows; ++r)
+          std::memcpy(plane + (oy + r) * shape.out_width + ox, d + r * m,
+                      cols * sizeof(float));
+      }
+    }
+  }
+}
+
+void conv2d_direct(const Conv2DShape &shape, const float *in,
+                   const float *filter, float *out) {
+  const unsigned int C = shape.in_channel;
+  const int H = shape.in_height;
+  const int W = shape.in_width;
+  const unsigned int OH = shape.out_height;
+  const unsigned int OW = shape.out_width;
+  const unsigned int KH = shape.k_height;
+  const unsigned int KW = shape.k_width;
+  const unsigned int sw = shape.stride_w;
+  const int pad_top = shape.pad_top;
+  const int pad_left = shape.pad_left;
+
+  /** valid output column range of every kernel column */
+  std::vector<unsigned int> ow_begin(KW), ow_end(KW);
+  std::vector<int> x_offset(KW);
+  for (unsigned int kw = 0; kw < KW; ++kw) {
+    x_offset[kw] = static_cast<int>(kw * shape.dilation_w) - pad_left;
+    validColumns(x_offset[kw], sw, W, OW, ow_begin[kw], ow_end[kw]);
+  }
+
+  for (unsigned int k = 0; k < shape.out_channel; ++k) {
+    const float *kernel = filter + static_cast<size_t>(k) * C * KH * KW;
+    for (unsigned int oh = 0; oh < OH; ++oh) {
+      float *orow = out + (static_cast<size_t>(k) * OH + oh) * OW;
+      std::fill(orow, orow + OW, 0.0f);
+
+      for (unsigned int c = 0; c < C; ++c) {
+        for (unsigned int kh = 0; kh < KH; ++kh) {
+          int ih =
+            static_cast<int>(oh * shape.stride_h + kh * shape.dilation_h) -
+            pad_top;
+          if (ih < 0 || ih >= H)
+            continue;
+
+          const float *irow = in + (static_cast<size_t>(c) * H + ih) * W;
+          const float *taps = kernel + (c * KH + kh) * KW;
+          for (unsigned int kw = 0; kw < KW; ++kw) {
+            const float wv = taps[kw];
+            const unsigned int begin = ow_begin[kw], end = ow_end[kw];
+            if (sw == 1) {
+              const float *src = irow + (begin + x_offset[kw]);
+              float *dst = orow + begin;
+              for (unsigned int i = 0; i < end - begin; ++i)
+                dst[i] += wv * src[i];
+            } else {
+              for (unsigned int ow = begin; ow < end; ++ow)
+                orow[ow] += wv * irow[ow * sw + x_offset[kw]];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+void depthwise_conv2d(const Conv2DShape &shape, bool nhwc, const float *in,
+                      const float *filter, float *out) {
+  const unsigned int C = shape.in_channel;
+  const unsigned int K = shape.out_channel;
+  const unsigned int M = K / C;
+
+  if (!nhwc) {
+    /** every input plane is a direct convolution producing M planes */
+    Conv2DShape plane_shape = shape;
+    plane_shape.in_channel = 1;
+    plane_shape.out_channel = M;
+    const size_t in_plane = static_cast<size_t>(shape.in_height) *
+                            shape.in_width;
+    const size_t out_plane = static_cast<size_t>(shape.out_height) *
+                             shape.out_width;
+    const size_t taps = shape.k_height * shape.k_width;
+    for (unsigned int c = 0; c < C; ++c)
+      conv2d_direct(plane_shape, in + c * in_plane, filter + c * M * taps,
+                    out + c * M * out_plane);
+    return;
+  }
+
+  const int H = shape.in_height;
+  const int W = shape.in_width;
+  const int pad_top = shape.pad_top;
+  const int pad_left = shape.pad_left;
+  std::vector<float> wt = channelLastFilter(shape, filter);
+
+  for (unsigned int oh = 0; oh < shape.out_height; ++oh) {
+    for (unsigned int ow = 0; ow < shape.out_width; ++ow) {
+      float *o_px = out + (static_cast<size_t>(oh) * shape.out_width + ow) * K;
+      std::fill(o_px, o_px + K, 0.0f);
+      for (unsigned int kh = 0; kh < shape.k_height; ++kh) {
+        int ih =
+          static_cast<int>(oh * shape.stride_h + kh * shape.dilation_h) -
+          pad_top;
+        if (ih < 0 || ih >= H)
+          continue;
+        for (unsigned int kw = 0; kw < shape.k_width; ++kw) {
+          int iw =
+            static_cast<int>(ow * shape.stride_w + kw * shape.dilation_w) -
+            pad_left;
+          if (iw < 0 || iw >= W)
+            continue;
+          const float *i_px = in + (static_cast<size_t>(ih) * W + iw) * C;
+          const float *w_px = wt.data() + (kh * shape.k_width + kw) * K;
+          if (M == 1) {
+            for (unsigned int c = 0; c < C; ++c)
+              o_px[c] += i_px[c] * w_px[c];
+          } else {
+            for (unsigned int o = 0; o < K; ++o)
+              o_px[o] += i_px[o / M] * w_px[o];
+          }
+        }
+      }
+    }
+  }
+}
+
+void depthwise_conv2d_derivative(const Conv2DShape &shape, bool nhwc,
+                                 const float *dy, const float *filter,
+                                 float *dx) {
+  const unsigned int C = shape.in_channel;
+  const unsigned int K = shape.out_channel;
+  const unsigned int M = K / C;
+  const int H = shape.in_height;
+  const int W = shape.in_width;
+  const unsigned int OH = shape.out_height;
+  const unsigned int OW = shape.out_width;
+  const unsigned int KH = shape.k_height;
+  const unsigned int KW = shape.k_width;
+  const unsigned int sw = shape.stride_w;
+  const int pad_top = shape.pad_top;
+  const int pad_left = shape.pad_left;
+
+  std::fill(dx, dx + static_cast<size_t>(C) * H * W, 0.0f);
+
+  if (!nhwc) {
+    std::vector<unsigned int> ow_begin(KW), ow_end(KW);
+    std::vector<int> x_offset(KW);
+    for (unsigned int kw = 0; kw < KW; ++kw) {
+      x_offset[kw] = static_cast<int>(kw * shape.dilation_w) - pad_left;
+      validColumns(x_offset[kw], sw, W, OW, ow_begin[kw], ow_end[kw]);
+    }
+
+    for (unsigned int o = 0; o < K; ++o) {
+      float *dx_plane = dx + static_cast<size_t>(o / M) * H * W;
+      const float *taps = filter + static_cast<size_t>(o) * KH * KW;
+      for (unsigned int oh = 0; oh < OH; ++oh) {
+        const float *drow = dy + (static_cast<size_t>(o) * OH + oh) * OW;
+        for (unsigned int kh = 0; kh < KH; ++kh) {
+          int ih =
+            static_cast<int>(oh * shape.stride_h + kh * shape.dilation_h) -
+            pad_top;
+          if (ih < 0 || ih >= H)
+            continue;
+          float *dx_row = dx_plane + static_cast<size_t>(ih) * W;
+          for (unsigned int kw = 0; kw < KW; ++kw) {
+            const float wv = taps[kh * KW + kw];
+            const unsigned int begin = ow_begin[kw], end = ow_end[kw];
+            if (sw == 1) {
+              float *dst = dx_row + (begin + x_offset[kw]);
+              for (unsigned int i = 0; i < end - begin; ++i)
+                dst[i] += wv * drow[begin + i];
+            } else {
+              for (unsigned int ow = begin; ow < end; ++ow)
+                dx_row[ow * sw + x_offset[kw]] += wv * drow[ow];
+            }
+          }
+        }
+      }
+    }
+    return;
+  }
+
+  std::vector<float> wt = channelLastFilter(shape, filter);
+  for (unsigned int oh = 0; oh < OH; ++oh) {
+    for (unsigned int ow = 0; ow < OW; ++ow) {
+      const float *d_px = dy + (static_cast<size_t>(oh) * OW + ow) * K;
+      for (unsigned int kh = 0; kh < KH; ++kh) {
+        int ih =
+          static_cast<int>(oh * shape.stride_h + kh * shape.dilation_h) -
+          pad_top;
+        if (ih < 0 || ih >= H)
+          continue;
+        for (unsigned int kw = 0; kw < KW; ++kw) {
+          int iw = static_cast<int>(ow * sw + kw * shape.dilation_w) - pad_left;
+          if (iw < 0 || iw >= W)
+            continue;
+          float *dx_px = dx + (static_cast<size_t>(ih) * W + iw) * C;
+          const float *w_px = wt.data() + (kh * KW + kw) * K;
+          if (M == 1) {
+            for (unsigned int c = 0; c < C; ++c)
+              dx_px[c] += d_px[c] * w_px[c];
+          } else {
+            for (unsigned int o = 0; o < K; ++o)
+              dx_px[o / M] += d_px[o] * w_px[o];
+          }
+        }
+      }
+    }
+  }
+}
+
+void depthwise_conv2d_gradient(const Conv2DShape &shape, bool nhwc,
+                               const float *dy, const float *in,
+                               float *dfilter) {
+  const unsigned int C = shape.in_channel;
+  const unsigned int K = shape.out_channel;
+  const unsigned int M = K / C;
+  const int H = shape.in_height;
+  const int W = shape.in_width;
+  const unsigned int OH = shape.out_height;
+  const unsigned int OW = shape.out_width;
+  const unsigned int KH = shape.k_height;
+  const unsigned int KW = shape.k_width;
+  const unsigned int sw = shape.stride_w;
+  const int pad_top = shape.pad_top;
+  const int pad_left = shape.pad_left;
+
+  if (!nhwc) {
+    std::vector<unsigned int> ow_begin(KW), ow_end(KW);
+    std::vector<int> x_offset(KW);
+    for (unsigned int kw = 0; kw < KW; ++kw) {
+      x_offset[kw] = static_cast<int>(kw * shape.dilation_w) - pad_left;
+      validColumns(x_offset[kw], sw, W, OW, ow_begin[kw], ow_end[kw]);
+    }
+
+    for (unsigned int o = 0; o < K; ++o) {
+      const float *in_plane = in + static_cast<size_t>(o / M) * H * W;
+      float *taps = dfilter + static_cast<size_t>(o) * KH * KW;
+      for (unsigned int oh = 0; oh < OH; ++oh) {
+        const float *drow = dy + (static_cast<size_t>(o) * OH + oh) * OW;
+        for (unsigned int kh = 0; kh < KH; ++kh) {
+          int ih =
+            static_cast<int>(oh * shape.stride_h + kh * shape.dilation_h) -
+            pad_top;
+          if (ih < 0 || ih >= H)
+            continue;
+          const float *irow = in_plane + static_cast<size_t>(ih) * W;
+          for (unsigned int kw = 0; kw < KW; ++kw) {
+            const unsigned int begin = ow_begin[kw], end = ow_end[kw];
+            float sum = 0.0f;
+            for (unsigned int ow = begin; ow < end; ++ow)
+              sum += drow[ow] * irow[ow * sw + x_offset[kw]];
+            taps[kh * KW + kw] += sum;
+          }
+        }
+      }
+    }
+    return;
+  }
+
+  /** accumulate in the channel last layout and add back once */
+  std::vector<float> dwt(static_cast<size_t>(KH) * KW * K, 0.0f);
+  for (unsigned int oh = 0; oh < OH; ++oh) {
+    for (unsigned int ow = 0; ow < OW; ++ow) {
+      const float *d_px = dy + (static_cast<size_t>(oh) * OW + ow) * K;
+      for (unsigned int kh = 0; kh < KH; ++kh) {
+        int ih =
+          static_cast<int>(oh * shape.stride_h + kh * shape.dilation_h) -
+          pad_top;
+        if (ih < 0 || ih >= H)
+          continue;
+        for (unsigned int kw = 0; kw < KW; ++kw) {
+          int iw = static_cast<int>(ow * sw + kw * shape.dilation_w) - pad_left;
+          if (iw < 0 || iw >= W)
+            continue;
+          const float *i_px = in + (static_cast<size_t>(ih) * W + iw) * C;
+          float *dw_px = dwt.data() + (kh * KW + kw) * K;
+          if (M == 1) {
+            for (unsigned int c = 0; c < C; ++c)
+              dw_px[c] += d_px[c] * i_px[c];
+          } else {
+            for (unsigned int o = 0; o < K; ++o)
+              dw_px[o] += d_px[o] * i_px[o / M];
+          }
+        }
+      }
+    }
+  }
+
+  const unsigned int taps = KH * KW;
+  for (unsigned int o = 0; o < K; ++o)
+    for (unsigned int t = 0; t < taps; ++t)
+      dfilter[o * taps + t] += dwt[t * K + o];
+}
+
+} /* namespace nntrainer */
@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   conv2d_kernel.h
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ *         https://arxiv.org/abs/1509.09308
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Workspace free convolution kernels used instead of im2col + gemm
+ * when they fit the shape better: Winograd F(2x2,3x3) / F(4x4,3x3) for 3x3
+ * stride 1 convolutions, a direct convolution for small channel counts and
+ * depthwise convolutions.
+ *
+ */
+
+#ifndef __CONV2D_KERNEL_H__
+#define __CONV2D_KERNEL_H__
+#ifdef __cplusplus
+
+#include <cstddef>
+
+namespace nntrainer {
+
+/**
+ * @brief algorithm used to compute the forward of a 2D convolution
+ */
+enum class Conv2DAlgorithm {
+  IM2COL,       /**< im2col + gemm, handles every shape */
+  WINOGRAD_2X2, /**< Winograd F(2x2, 3x3) */
+  WINOGRAD_4X4, /**< Winograd F(4x4, 3x3) */
+  DIRECT,       /**< direct convolution on the image rows */
+};
+
+/**
+ * @brief shape of a 2D convolution of a single NCHW image
+ */
+struct Conv2DShape {
+  unsigned int in_channel;  /**< number of input channels */
+  unsigned int in_height;   /**< input height */
+  unsigned int in_width;    /**< input width */
+  unsigned int out_channel; /**< number of filters */
+  unsigned int out_height;  /**< output height */
+  unsigned int out_width;   /**< output width */
+  unsigned int k_height;    /**< kernel height */
+  unsigned int k_width;     /**< kernel width */
+  unsigned int stride_h;    /**< stride along the height */
+  unsigned int stride_w;    /**< stride along the width */
+  unsigned int dilation_h;  /**< dilation along the height */
+  unsigned int dilation_w;  /**< dilation along the width */
+  unsigned int pad_top;     /**< padding at the top */
+  unsigned int pad_left;    /**< padding at the left */
+};
+
+/**
+ * @brief     pick the forward algorithm of a convolution from its shape
+ * @param[in] shape shape of the convolution
+ * @return    Conv2DAlgorithm the algorithm to use
+ */
+Conv2DAlgorithm conv2d_select_algorithm(const Conv2DShape &shape);
+
+/**
+ * @brief     number of floats of the transformed filter of a Winograd
+ * convolution
+ * @param[in] shape shape of the convolution
+ * @param[in] algo WINOGRAD_2X2 or WINOGRAD_4X4
+ */
+size_t conv2d_winograd_filter_size(const Conv2DShape &shape,
+                                   Conv2DAlgorithm algo);
+
+/**
+ * @brief     transform the filter [out_channel, in_channel, 3, 3] to the
+ * Winograd domain, U = G g G^T
+ * @param[in] shape shape of the convolution
+ * @param[in] algo WINOGRAD_2X2 or WINOGRAD_4X4
+ * @param[in] filter filter
+ * @param[out] transformed buffer of conv2d_winograd_filter_size() floats
+ */
+void conv2d_winograd_transform_filter(const Conv2DShape &shape,
+                                      Conv2DAlgorithm algo,
+                                      const float *filter, float *transformed);
+
+/**
+ * @brief     Winograd convolution of a single image. Tiles are processed in
+ * blocks so the workspace is bounded regardless of the image size.
+ * @param[in] shape shape of the convolution
+ * @param[in] algo WINOGRAD_2X2 or WINOGRAD_4X4
+ * @param[in] in input [in_channel, in_height, in_width]
+ * @param[in] transformed filter from conv2d_winograd_transform_filter()
+ * @param[out] out output [out_channel, out_height, out_width]
+ */
+void conv2d_winograd(const Conv2DShape &shape, Conv2DAlgorithm algo,
+                     const float *in, const float *transformed, float *out);
+
+/**
+ * @brief     direct convolution of a single image, accumulating kernel taps
+ * over output rows. Needs no workspace.
+ * @param[in] shape shape of the convolution
+ * @param[in] in input [in_channel, in_height, in_width]
+ * @param[in] filter filter [out_channel, in_channel, k_height, k_width]
+ * @param[out] out output [out_channel, out_height, out_width]
+ */
+void conv2d_direct(const Conv2DShape &shape, const float *in,
+                   const float *filter, float *out);
+
+/**
+ * @brief     depthwise convolution of a single image. Output channel o is
+ * computed from input channel o / (out_channel / in_channel).
+ * @param[in] shape shape of the convolution
+ * @param[in] nhwc true if in and out are [height, width, channel]. NCHW
+ * images are vectorized along the width, NHWC ones along the channels.
+ * @param[in] in input
+ * @param[in] filter filter [out_channel, k_height, k_width]
+ * @param[out] out output
+ */
+void depthwise_conv2d(const Conv2DShape &shape, bool nhwc, const float *in,
+                      const float *filter, float *out);
+
+/**
+ * @brief     derivative of depthwise_conv2d with respect to its input
+ * @param[in] shape shape of the convolution
+ * @param[in] nhwc true if dy and dx are [height, width, channel]
+ * @param[in] dy incoming derivative
+ * @param[in] filter filter [out_channel, k_height, k_width]
+ * @param[out] dx outgoing derivative, overwritten
+ */
+void depthwise_conv2d_derivative(const Conv2DShape &shape, bool nhwc,
+                                 const float *dy, const float *filter,
+                                 float *dx);
+
+/**
+ * @brief     derivative of depthwise_conv2d with respect to its filter
+ * @param[in] shape shape of the convolution
+ * @param[in] nhwc true if dy and in are [height, width, channel]
+ * @param[in] dy incoming derivative
+ * @param[in] in input of the forward
+ * @param[in/out] dfilter gradient [out_channel, k_height, k_width], the
+ * gradient of this image is accumulated
+ */
+void depthwise_conv2d_gradient(const Conv2DShape &shape, bool nhwc,
+                               const float *dy, const float *in,
+                               float *dfilter);
+
+} /* namespace nntrainer */
+
+#endif /* __cplusplus */
+#endif /* __CONV2D_KERNEL_H__ */
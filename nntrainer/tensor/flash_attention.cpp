@@ -0,0 +1,424 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   flash_attention.cpp
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ *         https://arxiv.org/abs/2205.14135
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Tiled scaled dot product attention with online softmax
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <blas_interface.h>
+#include <flash_attention.h>
+
+namespace nntrainer {
+
+namespace {
+
+/**
+ * @brief     copy a rows x cols block with leading dimension ld into a
+ * contiguous float tile
+ */
+template <typename T>
+void loadTile(const T *src, unsigned int rows, unsigned int cols,
+              unsigned int ld, float *dst) {
+  for (unsigned int r = 0; r < rows; ++r)
+    for (unsigned int c = 0; c < cols; ++c)
+      dst[r * cols + c] = static_cast<float>(src[r * ld + c]);
+}
+
+/**
+ * @brief     copy a contiguous float tile into a rows x cols block with
+ * leading dimension ld
+ */
+template <typename T>
+void storeTile(const float *src, unsigned int rows, unsigned int cols, T *dst,
+               unsigned int ld) {
+  for (unsigned int r = 0; r < rows; ++r)
+    for (unsigned int c = 0; c < cols; ++c)
+      dst[r * ld + c] = static_cast<T>(src[r * cols + c]);
+}
+
+/**
+ * @brief     rows of keys or values kept at the type of the query
+ */
+template <typename T> struct DenseRows {
+  const T *data; /**< [batch, kv_capacity, num_heads, dim] */
+
+  /**
+   * @brief     load rows vectors of cols elements into a float tile, from the
+   * vector of index vec, every stride-th vector
+   */
+  void load(size_t vec, unsigned int rows, unsigned int cols,
+            unsigned int stride, float *dst) const {
+    loadTile(data + vec * cols, rows, cols, stride * cols, dst);
+  }
+};
+
+/**
+ * @brief     rows of keys or values quantized to int8 with a scale per vector
+ */
+struct QuantizedRows {
+  const int8_t *data;  /**< [batch, kv_capacity, num_heads, dim] */
+  const float *scales; /**< [batch, kv_capacity, num_heads] */
+
+  /**
+   * @brief     dequantize rows vectors of cols elements into a float tile,
+   * from the vector of index vec, every stride-th vector
+   */
+  void load(size_t vec, unsigned int rows, unsigned int cols,
+            unsigned int stride, float *dst) const {
+    for (unsigned int r = 0; r < rows; ++r) {
+      const size_t v = vec + (size_t)r * stride;
+      const int8_t *src = data + v * cols;
+      const float s = scales[v];
+      float *d = dst + r * cols;
+      for (unsigned int c = 0; c < cols; ++c)
+        d[c] = s * src[c];
+    }
+  }
+};
+
+/**
+ * @brief     number of keys in [j0, j0 + bc) visible to the query at row i
+ */
+inline unsigned int visibleKeys(int causal_from, unsigned int i,
+                                unsigned int j0, unsigned int bc) {
+  if (causal_from < 0)
+    return bc;
+  const long long end = (long long)causal_from + i + 1;
+  if (end <= j0)
+    return 0;
+  return (unsigned int)std::min<long long>(bc, end - j0);
+}
+
+/**
+ * @brief     number of keys visible to any query in [i0, i0 + br)
+ */
+inline unsigned int visibleKeyEnd(const FlashAttentionDim &dim,
+                                  int causal_from, unsigned int i0,
+                                  unsigned int br) {
+  if (causal_from < 0)
+    return dim.kv_len;
+  return (unsigned int)std::min<long long>(dim.kv_len,
+                                           (long long)causal_from + i0 + br);
+}
+
+template <typename T, typename KV>
+void flashForward(const FlashAttentionDim &dim, const T *Q, const KV &K,
+                  const KV &V, const T *mask, unsigned int mask_rows,
+                  float scale, int causal_from, T *O, float *lse) {
+  constexpr unsigned int BQ = FLASH_ATTENTION_BLOCK_Q;
+  constexpr unsigned int BKV = FLASH_ATTENTION_BLOCK_KV;
+  constexpr float neg_inf = -std::numeric_limits<float>::infinity();
+
+  const unsigned int H = dim.num_heads;
+  const unsigned int D = dim.head_dim;
+  const unsigned int Dv = dim.value_dim;
+  const unsigned int qk_ld = H * D;
+  const unsigned int v_ld = H * Dv;
+
+  std::vector<float> q_tile(BQ * D), k_tile(BKV * D), v_tile(BKV * Dv);
+  std::vector<float> s_tile(BQ * BKV), acc(BQ * Dv);
+  std::vector<float> row_max(BQ), row_sum(BQ);
+
+  for (unsigned int b = 0; b < dim.batch; ++b) {
+    for (unsigned int h = 0; h < H; ++h) {
+      const unsigned int head_row = (b * H + h) * dim.q_len;
+
+      for (unsigned int i0 = 0; i0 < dim.q_len; i0 += BQ) {
+        const unsigned int br = std::min(BQ, dim.q_len - i0);
+        loadTile(Q + ((b * dim.q_len + i0) * H + h) * D, br, D, qk_ld,
+                 q_tile.data());
+        std::fill(acc.begin(), acc.end(), 0.0f);
+        std::fill(row_max.begin(), row_max.end(), neg_inf);
+        std::fill(row_sum.begin(), row_sum.end(), 0.0f);
+
+        const unsigned int kv_end = visibleKeyEnd(dim, causal_from, i0, br);
+        for (unsigned int j0 = 0; j0 < kv_end; j0 += BKV) {
+          const unsigned int bc = std::min(BKV, kv_end - j0);
+          const unsigned int kv_offset = (b * dim.kv_capacity + j0) * H + h;
+          K.load(kv_offset, bc, D, H, k_tile.data());
+          V.load(kv_offset, bc, Dv, H, v_tile.data());
+
+          sgemm(CblasRowMajor, CblasNoTrans, CblasTrans, br, bc, D, scale,
+                q_tile.data(), D, k_tile.data(), D, 0.0f, s_tile.data(), bc);
+
+          for (unsigned int i = 0; i < br; ++i) {
+            float *s = s_tile.data() + i * bc;
+            const unsigned int len = visibleKeys(causal_from, i0 + i, j0, bc);
+            if (mask) {
+              const T *m =
+                mask + ((head_row + i0 + i) % mask_rows) * dim.kv_len + j0;
+              for (unsigned int c = 0; c < len; ++c)
+                s[c] += static_cast<float>(m[c]);
+            }
+
+            float m_new = row_max[i];
+            for (unsigned int c = 0; c < len; ++c)
+              m_new = std::max(m_new, s[c]);
+
+            if (m_new == neg_inf) {
+              std::fill(s, s + bc, 0.0f);
+              continue;
+            }
+
+            /** rescale what has been accumulated with the previous maximum */
+            const float alpha = std::exp(row_max[i] - m_new);
+            float sum = 0.0f;
+            for (unsigned int c = 0; c < len; ++c) {
+              s[c] = std::exp(s[c] - m_new);
+              sum += s[c];
+            }
+            std::fill(s + len, s + bc, 0.0f);
+
+            row_sum[i] = row_sum[i] * alpha + sum;
+            row_max[i] = m_new;
+            if (alpha != 1.0f) {
+              float *a = acc.data() + i * Dv;
+              for (unsigned int c = 0; c < Dv; ++c)
+                a[c] *= alpha;
+            }
+          }
+
+          sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, br, Dv, bc, 1.0f,
+                s_tile.data(), bc, v_tile.data(), Dv, 1.0f, acc.data(), Dv);
+        }
+
+        for (unsigned int i = 0; i < br; ++i) {
+          const float inv = row_sum[i] > 0.0f ? 1.0f / row_sum[i] : 0.0f;
+          float *a = acc.data() + i * Dv;
+          for (unsigned int c = 0; c < Dv; ++c)
+            a[c] *= inv;
+          if (lse)
+            lse[head_row + i0 + i] =
+              row_sum[i] > 0.0f ? row_max[i] + std::log(row_sum[i])
+                                : std::numeric_limits<float>::infinity();
+        }
+        storeTile(acc.data(), br, Dv, O + ((b * dim.q_len + i0) * H + h) * Dv,
+                  v_ld);
+      }
+    }
+  }
+}
+
+/**
+ * @brief     quantize every vector of len elements symmetrically to int8
+ */
+template <typename T>
+void quantizeRows(unsigned int num_vectors, unsigned int len, const T *src,
+                  int8_t *dst, float *scales) {
+  for (unsigned int v = 0; v < num_vectors; ++v) {
+    const T *x = src + (size_t)v * len;
+    int8_t *q = dst + (size_t)v * len;
+
+    float max_abs = 0.0f;
+    for (unsigned int c = 0; c < len; ++c)
+      max_abs = std::max(max_abs, std::abs(static_cast<float>(x[c])));
+
+    const float s = max_abs / 127.0f;
+    const float inv = s > 0.0f ? 1.0f / s : 0.0f;
+    for (unsigned int c = 0; c < len; ++c)
+      q[c] = static_cast<int8_t>(std::nearbyint(static_cast<float>(x[c]) * inv));
+    scales[v] = s;
+  }
+}
+
+template <typename T>
+void flashBackward(const FlashAttentionDim &dim, const T *Q, const T *K,
+                   const T *V, const T *mask, unsigned int mask_rows,
+                   float scale, int causal_from, const T *O, const float *lse,
+                   const T *dO, T *dQ, T *dK, T *dV, T *dMask) {
+  constexpr unsigned int BQ = FLASH_ATTENTION_BLOCK_Q;
+  constexpr unsigned int BKV = FLASH_ATTENTION_BLOCK_KV;
+
+  const unsigned int H = dim.num_heads;
+  const unsigned int D = dim.head_dim;
+  const unsigned int Dv = dim.value_dim;
+  const unsigned int qk_ld = H * D;
+  const unsigned int v_ld = H * Dv;
+
+  std::vector<float> q_tile(BQ * D), k_tile(BKV * D), v_tile(BKV * Dv);
+  std::vector<float> do_tile(BQ * Dv), p_tile(BQ * BKV), ds_tile(BQ * BKV);
+  std::vector<float> dk_acc(BKV * D), dv_acc(BKV * Dv);
+  std::vector<float> dq_acc(dim.q_len * D), delta(dim.q_len);
+
+  for (unsigned int b = 0; b < dim.batch; ++b) {
+    for (unsigned int h = 0; h < H; ++h) {
+      const unsigned int head_row = (b * H + h) * dim.q_len;
+      const float *head_lse = lse + head_row;
+
+      /** delta_i = dO_i . O_i equals sum_j P_ij * dP_ij */
+      for (unsigned int i = 0; i < dim.q_len; ++i) {
+        const unsigned int offset = ((b * dim.q_len + i) * H + h) * Dv;
+        float sum = 0.0f;
+        for (unsigned int c = 0; c < Dv; ++c)
+          sum += static_cast<float>(dO[offset + c]) *
+                 static_cast<float>(O[offset + c]);
+        delta[i] = sum;
+      }
+      std::fill(dq_acc.begin(), dq_acc.end(), 0.0f);
+      if (dMask)
+        std::fill(dMask + (size_t)head_row * dim.kv_len,
+                  dMask + (size_t)(head_row + dim.q_len) * dim.kv_len,
+                  static_cast<T>(0));
+
+      for (unsigned int j0 = 0; j0 < dim.kv_len; j0 += BKV) {
+        const unsigned int bc = std::min(BKV, dim.kv_len - j0);
+        const unsigned int kv_offset = (b * dim.kv_capacity + j0) * H + h;
+        loadTile(K + kv_offset * D, bc, D, qk_ld, k_tile.data());
+        loadTile(V + kv_offset * Dv, bc, Dv, v_ld, v_tile.data());
+        std::fill(dk_acc.begin(), dk_acc.end(), 0.0f);
+        std::fill(dv_acc.begin(), dv_acc.end(), 0.0f);
+
+        for (unsigned int i0 = 0; i0 < dim.q_len; i0 += BQ) {
+          const unsigned int br = std::min(BQ, dim.q_len - i0);
+          if (visibleKeyEnd(dim, causal_from, i0, br) <= j0)
+            continue;
+
+          loadTile(Q + ((b * dim.q_len + i0) * H + h) * D, br, D, qk_ld,
+                   q_tile.data());
+          loadTile(dO + ((b * dim.q_len + i0) * H + h) * Dv, br, Dv, v_ld,
+                   do_tile.data());
+
+          /** recompute the attention weight of the tile */
+          sgemm(CblasRowMajor, CblasNoTrans, CblasTrans, br, bc, D, scale,
+                q_tile.data(), D, k_tile.data(), D, 0.0f, p_tile.data(), bc);
+          for (unsigned int i = 0; i < br; ++i) {
+            float *p = p_tile.data() + i * bc;
+            const unsigned int len = visibleKeys(causal_from, i0 + i, j0, bc);
+            if (mask) {
+              const T *m =
+                mask + ((head_row + i0 + i) % mask_rows) * dim.kv_len + j0;
+              for (unsigned int c = 0; c < len; ++c)
+                p[c] += static_cast<float>(m[c]);
+            }
+            for (unsigned int c = 0; c < len; ++c)
+              p[c] = std::exp(p[c] - head_lse[i0 + i]);
+            std::fill(p + len, p + bc, 0.0f);
+          }
+
+          /** dV += P^T dO */
+          sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, bc, Dv, br, 1.0f,
+                p_tile.data(), bc, do_tile.data(), Dv, 1.0f, dv_acc.data(),
+                Dv);
+          /** dP = dO V^T */
+          sgemm(CblasRowMajor, CblasNoTrans, CblasTrans, br, bc, Dv, 1.0f,
+                do_tile.data(), Dv, v_tile.data(), Dv, 0.0f, ds_tile.data(),
+                bc);
+          /** dS = P * (dP - delta) */
+          for (unsigned int i = 0; i < br; ++i) {
+            const float *p = p_tile.data() + i * bc;
+            float *ds = ds_tile.data() + i * bc;
+            for (unsigned int c = 0; c < bc; ++c)
+              ds[c] = p[c] * (ds[c] - delta[i0 + i]);
+            if (dMask)
+              storeTile(ds, 1, bc,
+                        dMask + (size_t)(head_row + i0 + i) * dim.kv_len + j0,
+                        bc);
+          }
+
+          /** dQ += scale * dS K, dK += scale * dS^T Q */
+          sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, br, D, bc, scale,
+                ds_tile.data(), bc, k_tile.data(), D, 1.0f,
+                dq_acc.data() + i0 * D, D);
+          sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, bc, D, br, scale,
+                ds_tile.data(), bc, q_tile.data(), D, 1.0f, dk_acc.data(), D);
+        }
+
+        storeTile(dk_acc.data(), bc, D, dK + kv_offset * D, qk_ld);
+        storeTile(dv_acc.data(), bc, Dv, dV + kv_offset * Dv, v_ld);
+      }
+
+      storeTile(dq_acc.data(), dim.q_len, D,
+                dQ + ((b * dim.q_len) * H + h) * D, qk_ld);
+    }
+  }
+}
+
+} // namespace
+
+void flash_attention_forward(const FlashAttentionDim &dim, const float *Q,
+                             const float *K, const float *V, const float *mask,
+                             unsigned int mask_rows, float scale,
+                             int causal_from, float *O, float *lse) {
+  flashForward(dim, Q, DenseRows<float>{K}, DenseRows<float>{V}, mask,
+               mask_rows, scale, causal_from, O, lse);
+}
+
+void flash_attention_forward(const FlashAttentionDim &dim, const float *Q,
+                             const int8_t *K, const float *K_scale,
+                             const int8_t *V, const float *V_scale,
+                             const float *mask, unsigned int mask_rows,
+                             float scale, int causal_from, float *O,
+                             float *lse) {
+  flashForward(dim, Q, QuantizedRows{K, K_scale}, QuantizedRows{V, V_scale},
+               mask, mask_rows, scale, causal_from, O, lse);
+}
+
+void flash_attention_quantize(unsigned int num_vectors, unsigned int len,
+                              const float *src, int8_t *dst, float *scales) {
+  quantizeRows(num_vectors, len, src, dst, scales);
+}
+
+void flash_attention_backward(const FlashAttentionDim &dim, const float *Q,
+                              const float *K, const float *V,
+                              const float *mask, unsigned int mask_rows,
+                              float scale, int causal_from, const float *O,
+                              const float *lse, const float *dO, float *dQ,
+                              float *dK, float *dV, float *dMask) {
+  flashBackward(dim, Q, K, V, mask, mask_rows, scale, causal_from, O, lse, dO,
+                dQ, dK, dV, dMask);
+}
+
+#ifdef ENABLE_FP16
+void flash_attention_forward(const FlashAttentionDim &dim, const _FP16 *Q,
+                             const _FP16 *K, const _FP16 *V, const _FP16 *mask,
+                             unsigned int mask_rows, float scale,
+                             int causal_from, _FP16 *O, float *lse) {
+  flashForward(dim, Q, DenseRows<_FP16>{K}, DenseRows<_FP16>{V}, mask,
+               mask_rows, scale, causal_from, O, lse);
+}
+
+void flash_attention_forward(const FlashAttentionDim &dim, const _FP16 *Q,
+                             const int8_t *K, const float *K_scale,
+                             const int8_t *V, const float *V_scale,
+                             const _FP16 *mask, unsigned int mask_rows,
+                             float scale, int causal_from, _FP16 *O,
+                             float *lse) {
+  flashForward(dim, Q, QuantizedRows{K, K_scale}, QuantizedRows{V, V_scale},
+               mask, mask_rows, scale, causal_from, O, lse);
+}
+
+void flash_attention_forward(const FlashAttentionDim &dim, const float *Q,
+                             const _FP16 *K, const _FP16 *V, const float *mask,
+                             unsigned int mask_rows, float scale,
+                             int causal_from, float *O, float *lse) {
+  flashForward(dim, Q, DenseRows<_FP16>{K}, DenseRows<_FP16>{V}, mask,
+               mask_rows, scale, causal_from, O, lse);
+}
+
+void flash_attention_quantize(unsigned int num_vectors, unsigned int len,
+                              const _FP16 *src, int8_t *dst, float *scales) {
+  quantizeRows(num_vectors, len, src, dst, scales);
+}
+
+void flash_attention_backward(const FlashAttentionDim &dim, const _FP16 *Q,
+                              const _FP16 *K, const _FP16 *V,
+                              const _FP16 *mask, unsigned int mask_rows,
+                              float scale, int causal_from, const _FP16 *O,
+                              const float *lse, const _FP16 *dO, _FP16 *dQ,
+                              _FP16 *dK, _FP16 *dV, _FP16 *dMask) {
+  flashBackward(dim, Q, K, V, mask, mask_rows, scale, causal_from, O, lse, dO,
+                dQ, dK, dV, dMask);
+}
+#endif
+
+} /* namespace nntrainer */
@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   flash_attention.h
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ *         https://arxiv.org/abs/2205.14135
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Tiled scaled dot product attention with online softmax. K and V
+ * are streamed through cache sized blocks so the score matrix of size
+ * q_len * kv_len is never stored.
+ *
+ */
+
+#ifndef __FLASH_ATTENTION_H__
+#define __FLASH_ATTENTION_H__
+#ifdef __cplusplus
+
+#include <cstdint>
+
+#include <tensor_dim.h>
+
+namespace nntrainer {
+
+/**
+ * @brief number of query rows processed per tile
+ */
+constexpr unsigned int FLASH_ATTENTION_BLOCK_Q = 32;
+
+/**
+ * @brief number of key/value rows processed per tile
+ */
+constexpr unsigned int FLASH_ATTENTION_BLOCK_KV = 64;
+
+/**
+ * @brief shape of a tiled attention problem
+ * @note Q, K, V and O are laid out as [batch, length, num_heads, dim] which is
+ * the layout of the projected tensors before splitting the heads, so no
+ * transpose is needed around the kernel.
+ */
+struct FlashAttentionDim {
+  unsigned int batch;       /**< batch size */
+  unsigned int num_heads;   /**< number of heads */
+  unsigned int q_len;       /**< number of queries */
+  unsigned int kv_len;      /**< number of keys/values attended */
+  unsigned int kv_capacity; /**< rows reserved per batch in K, V (>= kv_len) */
+  unsigned int head_dim;    /**< dimension of query/key per head */
+  unsigned int value_dim;   /**< dimension of value per head */
+};
+
+/**
+ * @brief     O = softmax(scale * Q K^T + mask) V computed tile by tile
+ * @param[in] dim shape of the problem
+ * @param[in] Q query
+ * @param[in] K key
+ * @param[in] V value
+ * @param[in] mask additive mask of [mask_rows, kv_len], row r of the score
+ * matrix uses mask row r % mask_rows. nullptr if not provided
+ * @param[in] mask_rows number of rows of the mask
+ * @param[in] scale scale factor of the attention score
+ * @param[in] causal_from position of the first query if causal mask is
+ * applied (query i attends keys up to causal_from + i), -1 otherwise
+ * @param[out] O output
+ * @param[out] lse log-sum-exp of every score row [batch, num_heads, q_len],
+ * needed by the backward pass. nullptr if not needed
+ */
+void flash_attention_forward(const FlashAttentionDim &dim, const float *Q,
+                             const float *K, const float *V, const float *mask,
+                             unsigned int mask_rows, float scale,
+                             int causal_from, float *O, float *lse);
+
+/**
+ * @brief     flash_attention_forward over keys and values kept as int8, which
+ * are dequantized tile by tile
+ * @param[in] K key quantized to int8
+ * @param[in] K_scale scale of every vector of the key
+ * [batch, kv_capacity, num_heads]
+ * @param[in] V value quantized to int8
+ * @param[in] V_scale scale of every vector of the value
+ * [batch, kv_capacity, num_heads]
+ * @note the other parameters are the ones of flash_attention_forward
+ */
+void flash_attention_forward(const FlashAttentionDim &dim, const float *Q,
+                             const int8_t *K, const float *K_scale,
+                             const int8_t *V, const float *V_scale,
+                             const float *mask, unsigned int mask_rows,
+                             float scale, int causal_from, float *O,
+                             float *lse);
+
+/**
+ * @brief     quantize vectors to int8 with a symmetric scale per vector, as
+ * read by the int8 flash_attention_forward
+ * @param[in] num_vectors number of the vectors
+ * @param[in] len number of the elements of a vector
+ * @param[in] src vectors to quantize
+ * @param[out] dst quantized vectors
+ * @param[out] scales scale of every vector, max(|x|) / 127
+ */
+void flash_attention_quantize(unsigned int num_vectors, unsigned int len,
+                              const float *src, int8_t *dst, float *scales);
+
+/**
+ * @brief     derivative of flash_attention_forward. The attention weight is
+ * recomputed tile by tile from Q, K and lse.
+ * @param[in] dim shape of the problem
+ * @param[in] Q query
+ * @param[in] K key
+ * @param[in] V value
+ * @param[in] mask additive mask, nullptr if not provided
+ * @param[in] mask_rows number of rows of the mask
+ * @param[in] scale scale factor of the attention score
+ * @param[in] causal_from same as the one given to the forward
+ * @param[in] O output of the forward
+ * @param[in] lse log-sum-exp saved by the forward
+ * @param[in] dO derivative of the output
+ * @param[out] dQ derivative of the query
+ * @param[out] dK derivative of the key
+ * @param[out] dV derivative of the value
+ * @param[out] dMask derivative of the mask [batch * num_heads * q_len,
+ * kv_len], nullptr if not needed
+ */
+void flash_attention_backward(const FlashAttentionDim &dim, const float *Q,
+                              const float *K, const float *V,
+                              const float *mask, unsigned int mask_rows,
+                              float scale, int causal_from, const float *O,
+                              const float *lse, const float *dO, float *dQ,
+                              float *dK, float *dV, float *dMask);
+
+#ifdef ENABLE_FP16
+/**
+ * @brief     half-precision flash_attention_forward, accumulates in float
+ */
+void flash_attention_forward(const FlashAttentionDim &dim, const _FP16 *Q,
+                             const _FP16 *K, const _FP16 *V, const _FP16 *mask,
+                             unsigned int mask_rows, float scale,
+                             int causal_from, _FP16 *O, float *lse);
+
+/**
+ * @brief     half-precision flash_attention_forward over int8 keys and values
+ */
+void flash_attention_forward(const FlashAttentionDim &dim, const _FP16 *Q,
+                             const int8_t *K, const float *K_scale,
+                             const int8_t *V, const float *V_scale,
+                             const _FP16 *mask, unsigned int mask_rows,
+                             float scale, int causal_from, _FP16 *O,
+                             float *lse);
+
+/**
+ * @brief     flash_attention_forward over half-precision keys and values
+ */
+void flash_attention_forward(const FlashAttentionDim &dim, const float *Q,
+                             const _FP16 *K, const _FP16 *V, const float *mask,
+                             unsigned int mask_rows, float scale,
+                             int causal_from, float *O, float *lse);
+
+/**
+ * @brief     quantize half-precision vectors to int8
+ */
+void flash_attention_quantize(unsigned int num_vectors, unsigned int len,
+                              const _FP16 *src, int8_t *dst, float *scales);
+
+/**
+ * @brief     half-precision flash_attention_backward, accumulates in float
+ */
+void flash_attention_backward(const FlashAttentionDim &dim, const _FP16 *Q,
+                              const _FP16 *K, const _FP16 *V,
+                              const _FP16 *mask, unsigned int mask_rows,
+                              float scale, int causal_from, const _FP16 *O,
+                              const float *lse, const _FP16 *dO, _FP16 *dQ,
+                              _FP16 *dK, _FP16 *dV, _FP16 *dMask);
+#endif
+
+} /* namespace nntrainer */
+
+#endif /* __cplusplus */
+#endif /* __FLASH_ATTENTION_H__ */
@@ -11,18 +11,62 @@
  *
  */
 
+#include <algorithm>
+
 #include <lazy_tensor.h>
 #include <nntrainer_error.h>
 
 namespace nntrainer {
 
+namespace {
+
+constexpr size_t FUSED_TILE = 256; /**< elements kept in a tile */
+
+/**
+ * @brief check if the tensor can be read or written by a fused pass
+ */
+bool isFusable(const Tensor &t) {
+  return t.getDataType() == Tdatatype::FP32 &&
+         t.getFormat() == Tformat::NCHW && t.isAllocated();
+}
+
+/**
+ * @brief get the strides of the tensor broadcast to the dimension
+ *
+ * @param t tensor
+ * @param dim dimension to broadcast to
+ * @param[out] st strides, 0 on the broadcast axes
+ * @retval true if t can be broadcast to dim
+ */
+bool getBroadcastStrides(const Tensor &t, const TensorDim &dim,
+                         std::array<size_t, TensorDim::MAXDIM> &st) {
+  auto strides = t.getStrides();
+  for (unsigned int i = 0; i < TensorDim::MAXDIM; ++i) {
+    unsigned int len = t.getDim().getTensorDim(i);
+    if (len == 1)
+      st[i] = 0;
+    else if (len == dim.getTensorDim(i))
+      st[i] = strides[i];
+    else
+      return false;
+  }
+  return true;
+}
+
+} // namespace
+
+void LazyTensor::pushElementwise(std::function<int(Tensor &)> fn,
+                                 ElementwiseOp op) {
+  call_chain.push_back({std::move(fn), std::move(op)});
+}
+
 /**
  * @brief Wrapper method of add_i (immediate version of add)
  * @retval this
  */
 LazyTensor &LazyTensor::add_i(float const &value) {
-  call_chain.push_back(
-    [value](Tensor &t) mutable -> int { return t.add_i(value); });
+  pushElementwise([value](Tensor &t) mutable -> int { return t.add_i(value); },
+                  {ElementwiseOp::Type::ADD, nullptr, value});
   return *this;
 }
 /**
@@ -32,7 +76,7 @@ LazyTensor &LazyTensor::add_i(float const &value) {
  */
 LazyTensor &LazyTensor::add_i(Tensor const &m, float const alpha) {
   auto f = [&m, alpha](Tensor &t) mutable -> int { return t.add_i(m, alpha); };
-  call_chain.push_back(f);
+  pushElementwise(f, {ElementwiseOp::Type::ADD, &m, alpha});
   return *this;
 }
 
@@ -43,7 +87,7 @@ LazyTensor &LazyTensor::add_i(Tensor const &m, float const alpha) {
  */
 LazyTensor &LazyTensor::subtract_i(Tensor const &m) {
   auto f = [&m](Tensor &t) mutable -> int { return t.subtract_i(m); };
-  call_chain.push_back(f);
+  pushElementwise(f, {ElementwiseOp::Type::SUBTRACT, &m});
   return *this;
 }
 
@@ -54,7 +98,7 @@ LazyTensor &LazyTensor::subtract_i(Tensor const &m) {
  */
 LazyTensor &LazyTensor::subtract_i(float const &value) {
   auto f = [value](Tensor &t) mutable -> int { return t.subtract_i(value); };
-  call_chain.push_back(f);
+  pushElementwise(f, {ElementwiseOp::Type::SUBTRACT, nullptr, value});
   return *this;
 }
 
@@ -65,7 +109,7 @@ LazyTensor &LazyTensor::subtract_i(float const &value) {
  */
 LazyTensor &LazyTensor::multiply_i(float const &value) {
   auto f = [value](Tensor &t) mutable -> int { return t.multiply_i(value); };
-  call_chain.push_back(f);
+  pushElementwise(f, {ElementwiseOp::Type::MULTIPLY, nullptr, value});
   return *this;
 }
 
@@ -76,7 +120,7 @@ LazyTensor &LazyTensor::multiply_i(float const &value) {
  */
 LazyTensor &LazyTensor::multiply_i(Tensor const &m) {
   auto f = [&m](Tensor &t) mutable -> int { return t.multiply_i(m); };
-  call_chain.push_back(f);
+  pushElementwise(f, {ElementwiseOp::Type::MULTIPLY, &m});
   return *this;
 }
 
@@ -87,7 +131,7 @@ LazyTensor &LazyTensor::multiply_i(Tensor const &m) {
  */
 LazyTensor &LazyTensor::divide_i(float const &value) {
   auto f = [value](Tensor &t) mutable -> int { return t.divide_i(value); };
-  call_chain.push_back(f);
+  pushElementwise(f, {ElementwiseOp::Type::DIVIDE, nullptr, value});
   return *this;
 }
 
@@ -98,7 +142,7 @@ LazyTensor &LazyTensor::divide_i(float const &value) {
  */
 LazyTensor &LazyTensor::divide_i(Tensor const &m) {
   auto f = [&m](Tensor &t) mutable -> int { return t.divide_i(m); };
-  call_chain.push_back(f);
+  pushElementwise(f, {ElementwiseOp::Type::DIVIDE, &m});
   return *this;
 }
 
@@ -118,7 +162,7 @@ LazyTensor &LazyTensor::dot(Tensor const &m) {
     }
   };
 
-  call_chain.push_back(f);
+  call_chain.push_back({f, {}});
   return *this;
 }
 
@@ -138,7 +182,7 @@ LazyTensor &LazyTensor::transpose(std::string direction) {
     }
   };
 
-  call_chain.push_back(f);
+  call_chain.push_back({f, {}});
   return *this;
 }
 
@@ -158,7 +202,7 @@ LazyTensor &LazyTensor::sum_by_batch() {
     }
   };
 
-  call_chain.push_back(f);
+  call_chain.push_back({f, {}});
   return *this;
 }
 
@@ -178,7 +222,7 @@ LazyTensor &LazyTensor::sum(int axis) {
     }
   };
 
-  call_chain.push_back(f);
+  call_chain.push_back({f, {}});
   return *this;
 }
 
@@ -197,7 +241,7 @@ LazyTensor &LazyTensor::average(int axis) {
     }
   };
 
-  call_chain.push_back(f);
+  call_chain.push_back({f, {}});
   return *this;
 }
 
@@ -216,23 +260,253 @@ LazyTensor &LazyTensor::average() {
     }
   };
 
-  call_chain.push_back(f);
+  call_chain.push_back({f, {}});
   return *this;
 }
 
+/**
+ * @brief     Apply the function element by element
+ * @param[in] f function to apply
+ * @retval    LazyTensor *this
+ */
+LazyTensor &LazyTensor::apply(std::function<float(float)> f) {
+  auto g = [f](Tensor &t) mutable -> int {
+    t.apply<float>(f, t);
+    return ML_ERROR_NONE;
+  };
+  pushElementwise(g, {ElementwiseOp::Type::APPLY, nullptr, 0.0f, f});
+  return *this;
+}
+
+int LazyTensor::runFused(const Tensor &src, size_t from, size_t to,
+                         Tensor &dst) const {
+  const TensorDim &dim = src.getDim();
+
+  /** strides of every tensor: dst, src and the tensor operands in order */
+  std::vector<std::array<size_t, TensorDim::MAXDIM>> st(2);
+  if (!getBroadcastStrides(dst, dim, st[0]) ||
+      !getBroadcastStrides(src, dim, st[1]))
+    return ML_ERROR_INVALID_PARAMETER;
+
+  for (size_t i = from; i < to; ++i) {
+    const ElementwiseOp &op = call_chain[i].op;
+    if (op.type == ElementwiseOp::Type::DIVIDE && op.m == nullptr &&
+        op.value == 0.0f)
+      return ML_ERROR_INVALID_PARAMETER;
+    if (op.m == nullptr)
+      continue;
+
+    st.emplace_back();
+    if (!isFusable(*op.m) || !getBroadcastStrides(*op.m, dim, st.back()))
+      return ML_ERROR_INVALID_PARAMETER;
+  }
+
+  /**
+   * loops from the innermost, an axis is merged to the inner loop when it is
+   * contiguous with it for every tensor, so that same sized contiguous
+   * tensors are a single loop
+   */
+  std::vector<size_t> len;
+  std::vector<std::vector<size_t>> step;
+  for (int axis = TensorDim::MAXDIM - 1; axis >= 0; --axis) {
+    size_t d = dim.getTensorDim(axis);
+    if (d == 1)
+      continue;
+
+    bool merge = !len.empty();
+    for (size_t t = 0; merge && t < st.size(); ++t)
+      merge = st[t][axis] == step.back()[t] * len.back();
+
+    if (merge) {
+      len.back() *= d;
+    } else {
+      len.push_back(d);
+      step.emplace_back(st.size());
+      for (size_t t = 0; t < st.size(); ++t)
+        step.back()[t] = st[t][axis];
+    }
+  }
+  if (len.empty()) {
+    len.push_back(1);
+    step.emplace_back(st.size(), 0);
+  }
+
+  std::vector<const float *> data(st.size());
+  data[1] = src.getData<float>();
+  for (size_t i = from, t = 2; i < to; ++i) {
+    if (call_chain[i].op.m)
+      data[t++] = call_chain[i].op.m->getData<float>();
+  }
+  float *out = dst.getData<float>();
+
+  const std::vector<size_t> &inner = step[0];
+  std::vector<size_t> idx(len.size(), 0);
+  std::vector<size_t> off(st.size(), 0);
+  float tile[FUSED_TILE];
+
+  while (true) {
+    for (size_t w = 0; w < len[0]; w += FUSED_TILE) {
+      size_t n = std::min(FUSED_TILE, len[0] - w);
+
+      const float *s = data[1] + off[1] + w * inner[1];
+      if (inner[1] == 1)
+        std::copy(s, s + n, tile);
+      else
+        for (size_t k = 0; k < n; ++k)
+          tile[k] = s[k * inner[1]];
+
+      for (size_t i = from, t = 2; i < to; ++i) {
+        const ElementwiseOp &op = call_chain[i].op;
+        const float *m = nullptr;
+        size_t ms = 0;
+        float v = op.value;
+        if (op.m) {
+          m = data[t] + off[t] + w * inner[t];
+          ms = inner[t];
+          ++t;
+        }
+
+        /** a broadcast element is a scalar for the tile */
+        bool scalar = m == nullptr || ms == 0;
+        if (m && ms == 0)
+          v = op.type == ElementwiseOp::Type::ADD ? op.value * m[0] : m[0];
+
+        switch (op.type) {
+        case ElementwiseOp::Type::ADD:
+          if (scalar)
+            for (size_t k = 0; k < n; ++k)
+              tile[k] += v;
+          else
+            for (size_t k = 0; k < n; ++k)
+              tile[k] += v * m[k * ms];
+          break;
+        case ElementwiseOp::Type::SUBTRACT:
+          if (scalar)
+            for (size_t k = 0; k < n; ++k)
+              tile[k] -= v;
+          else
+            for (size_t k = 0; k < n; ++k)
+              tile[k] -= m[k * ms];
+          break;
+        case ElementwiseOp::Type::MULTIPLY:
+          if (scalar)
+            for (size_t k = 0; k < n; ++k)
+              tile[k] *= v;
+          else
+            for (size_t k = 0; k < n; ++k)
+              tile[k] *= m[k * ms];
+          break;
+        case ElementwiseOp::Type::DIVIDE:
+          if (scalar)
+            for (size_t k = 0; k < n; ++k)
+              tile[k] /= v;
+          else
+            for (size_t k = 0; k < n; ++k)
+              tile[k] /= m[k * ms];
+          break;
+        case ElementwiseOp::Type::APPLY:
+          for (size_t k = 0; k < n; ++k)
+            tile[k] = op.fn(tile[k]);
+          break;
+        default:
+          break;
+        }
+      }
+
+      float *d = out + off[0] + w * inner[0];
+      if (inner[0] == 1)
+        std::copy(tile, tile + n, d);
+      else
+        for (size_t k = 0; k < n; ++k)
+          d[k * inner[0]] = tile[k];
+    }
+
+    /** advance the outer loops */
+    size_t l = 1;
+    for (; l < len.size(); ++l) {
+      for (size_t t = 0; t < st.size(); ++t)
+        off[t] += step[l][t];
+      if (++idx[l] < len[l])
+        break;
+      for (size_t t = 0; t < st.size(); ++t)
+        off[t] -= step[l][t] * len[l];
+      idx[l] = 0;
+    }
+    if (l == len.size())
+      break;
+  }
+
+  return ML_ERROR_NONE;
+}
+
 /**
  * @brief execute the call_chain to evaluate
  * @retval calculated tensor
  */
 Tensor LazyTensor::run() {
-  int status;
-  for (auto &item : call_chain) {
-    status = item(target);
+  Tensor output;
+  run(output);
+  return output;
+}
+
+Tensor &LazyTensor::run(Tensor &output) {
+  /** cur shares the memory of target until a call needs to modify it */
+  Tensor cur = target;
+  bool owned = false;
+  bool written = false;
+
+  size_t i = 0;
+  while (i < call_chain.size()) {
+    size_t j = i;
+    if (isFusable(cur)) {
+      while (j < call_chain.size() &&
+             call_chain[j].op.type != ElementwiseOp::Type::NONE)
+        ++j;
+    }
+
+    int status;
+    if (j > i) {
+      Tensor next;
+      Tensor *dst = &next;
+      if (j == call_chain.size()) {
+        CREATE_UNINITIALIZED_IF_EMPTY_DIMS(output, cur.getDim());
+        if (output.getDim() != cur.getDim() || !isFusable(output))
+          throw std::runtime_error("Error: evaluation failed");
+        dst = &output;
+      } else if (owned) {
+        dst = &cur;
+      } else {
+        CREATE_UNINITIALIZED_IF_EMPTY_DIMS(next, cur.getDim());
+      }
+
+      status = runFused(cur, i, j, *dst);
+      cur = *dst;
+      written = dst == &output;
+      i = j;
+    } else {
+      if (!owned) {
+        Tensor copied;
+        copied.copy(cur);
+        cur = copied;
+      }
+      status = call_chain[i].fn(cur);
+      written = false;
+      ++i;
+    }
+
     if (status != ML_ERROR_NONE) {
       throw std::runtime_error("Error: evaluation failed");
     }
+    owned = true;
   }
-  return target;
+
+  if (!written) {
+    if (!output.empty() && output.getDim() != cur.getDim())
+      throw std::runtime_error("Error: evaluation failed");
+    output.copy(cur);
+  }
+
+  return output;
 }
 
 } /* namespace nntrainer */
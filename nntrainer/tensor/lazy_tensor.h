@@ -24,14 +24,18 @@ namespace nntrainer {
  * @class   LazyTensor a wrapper class for lazy calculation of tensor
  * @brief   calculation is delayed until Tensor LazyTensor::run() is
  *          called, can be contructed by Tensor::chain() method
+ * @note    consecutive element-wise operations (add, subtract, multiply,
+ *          divide and apply) on FP32 tensors are fused to a single pass over
+ *          the data, which is processed tile by tile without intermediate
+ *          tensors. Other operations run one by one.
  */
 class LazyTensor {
 public:
   /**
-   * @brief Constructor of Lazy Tensor, Tensor is copied to gaurantee
-   * immutability
+   * @brief Constructor of Lazy Tensor, Tensor is never modified to gaurantee
+   * immutability. The copy is deferred to run()
    */
-  LazyTensor(const Tensor &from) { target.copy(from); };
+  LazyTensor(const Tensor &from) : target(from){};
 
   /**
    * @brief     Wrapper method of add_i. see tensor.h for more detail
@@ -135,15 +139,74 @@ public:
    */
   LazyTensor &average();
 
+  /**
+   * @brief     Apply the function element by element
+   * @param[in] f function to apply
+   * @retval    LazyTensor *this
+   */
+  LazyTensor &apply(std::function<float(float)> f);
+
   /**
    * @brief execute the call_chain to get the tensor
    * @retval calculated tensor
    */
   Tensor run();
 
+  /**
+   * @brief execute the call_chain and write the result to the output
+   * @param[out] output output tensor, allocated if empty. It may be the
+   * chained tensor or one of the operands to evaluate in place
+   * @retval output
+   * @throws std::runtime_error if the evaluation fails or the output dimension
+   * does not match
+   */
+  Tensor &run(Tensor &output);
+
 private:
+  /**
+   * @brief element-wise operation which can be fused with its neighbours
+   */
+  struct ElementwiseOp {
+    /**
+     * @brief type of the element-wise operation
+     */
+    enum class Type { NONE, ADD, SUBTRACT, MULTIPLY, DIVIDE, APPLY };
+
+    Type type = Type::NONE;         /**< type of the operation */
+    const Tensor *m = nullptr;      /**< tensor operand, or nullptr */
+    float value = 0.0f;             /**< scalar operand or alpha */
+    std::function<float(float)> fn; /**< function of APPLY */
+  };
+
+  /**
+   * @brief a call of the chain
+   */
+  struct Call {
+    std::function<int(Tensor &)> fn; /**< unfused evaluation of the call */
+    ElementwiseOp op;                /**< fusable description of the call */
+  };
+
+  /**
+   * @brief push an element-wise call to the chain
+   *
+   * @param fn unfused evaluation of the call
+   * @param op fusable description of the call
+   */
+  void pushElementwise(std::function<int(Tensor &)> fn, ElementwiseOp op);
+
+  /**
+   * @brief run the element-wise calls [from, to) in a single pass
+   *
+   * @param src tensor read
+   * @param from index of the first call
+   * @param to index after the last call
+   * @param dst tensor written, may be src
+   * @retval #ML_ERROR_NONE when successful
+   */
+  int runFused(const Tensor &src, size_t from, size_t to, Tensor &dst) const;
+
   /**< handle the data as a std::vector type */
-  std::vector<std::function<int(Tensor &)>> call_chain;
+  std::vector<Call> call_chain;
   Tensor target;
 };
 
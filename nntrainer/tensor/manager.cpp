@@ -691,6 +691,21 @@ std::vector<Tensor *> Manager::requestWeightOptimizerVariables(
   return ret;
 }
 
+Tensor *Manager::requestWeightGradientAccumulator(const TensorDim &dim,
+                                                  const std::string &name,
+                                                  bool is_grad_clip) {
+  std::vector<unsigned int> exec;
+  if (is_grad_clip) {
+    exec.emplace_back(TensorPool::PERSIST_END_ORDER);
+  } else {
+    exec.emplace_back(getMinMaxTensorExecutionOrder(name, true).second);
+  }
+
+  return weight_pool.request(name + ":grad_acc", dim, exec,
+                             TensorLifespan::MAX_LIFESPAN,
+                             Tensor::Initializer::ZEROS);
+}
+
 std::vector<Weight *>
 Manager::getWeights(const std::function<bool(const Weight *)> &condition) {
   std::vector<Weight *> conditional_weights;
@@ -227,6 +227,20 @@ public:
     const TensorLifespan &lifespan, bool is_grad_clip,
     Tensor::Initializer initializer = Tensor::Initializer::NONE);
 
+  /**
+   * @brief     Create the tensor accumulating the gradient of a weight over
+   * micro-batches, it lives as long as the optimizer variables
+   *
+   * @param dim Dimension of the gradient
+   * @param name Name of the weight
+   * @param is_grad_clip true if the gradient is clipped by global norm
+   *
+   * @return created tensor
+   */
+  Tensor *requestWeightGradientAccumulator(const TensorDim &dim,
+                                           const std::string &name,
+                                           bool is_grad_clip);
+
   /**
    * @brief     Create tensors with the given spec
    *
@@ -367,6 +381,21 @@ public:
    */
   void deallocateTensors(bool dealloc_weights = false);
 
+  /**
+   * @brief Detach the managed tensors from their memory, keeping the memory
+   * allocated, so that their batch can be updated
+   *
+   * @return true if detached, false if the tensors must be deallocated
+   * instead
+   */
+  bool unbindTensors() { return tensor_pool.unbind(); }
+
+  /**
+   * @brief Attach the managed tensors detached by unbindTensors() to their
+   * memory again
+   */
+  void bindTensors() { tensor_pool.bind(); }
+
   /**
    * @brief Allocate memory for all the managed weights
    *
@@ -466,6 +495,57 @@ public:
     const GraphNode::ExecutionOrder &exec_order, const std::string &scope = "",
     bool expose_var = false, bool expose_grad = false);
 
+  /**
+   * @brief Request the tensor to be recomputed before the backwarding
+   *
+   * @param name name of the tensor written by the forwarding of the layer
+   * @param group identifier of the layer recomputing the tensor
+   * @param forward_end last forward execution order of the segment
+   * @param recompute_order execution order at which the segment is recomputed
+   */
+  void requestRecompute(const std::string &name, unsigned int group,
+                        unsigned int forward_end,
+                        unsigned int recompute_order) {
+    tensor_pool.requestRecompute(name, group, forward_end, recompute_order);
+  }
+
+  /**
+   * @brief Request the tensor read by a recomputed layer to be valid at the
+   * recompute order
+   *
+   * @param name name of the tensor
+   * @param recompute_order execution order at which the segment is recomputed
+   */
+  void requestRecomputeInput(const std::string &name,
+                             unsigned int recompute_order) {
+    tensor_pool.requestRecomputeInput(name, recompute_order);
+  }
+
+  /**
+   * @brief Check if the layer is recomputed with the planned memory
+   *
+   * @param group identifier given to requestRecompute()
+   * @return true if the layer must run its forwarding before the backwarding
+   */
+  bool isRecomputed(unsigned int group) const {
+    return tensor_pool.isRecomputed(group);
+  }
+
+  /**
+   * @brief Bind the recomputed tensors to their forwarding memory
+   */
+  void bindForwardMemory() { tensor_pool.bindForwardMemory(); }
+
+  /**
+   * @brief Bind the tensors recomputed at the order to the memory kept for
+   * the backwarding
+   *
+   * @param recompute_order execution order given to requestRecompute()
+   */
+  void bindRecomputeMemory(unsigned int recompute_order) {
+    tensor_pool.bindRecomputeMemory(recompute_order);
+  }
+
   /**
    * @brief flush cache data
    */
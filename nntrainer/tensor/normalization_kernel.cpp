@@ -0,0 +1,517 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   normalization_kernel.cpp
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Fused single-pass statistics and affine kernels for batch, layer and
+ * RMS normalization.
+ *
+ * @note   The loops keep LANES independent accumulators with a shared
+ * trip count so that they are turned into SIMD code by the compiler on both
+ * NEON and AVX targets while the math stays in float for half precision.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <normalization_kernel.h>
+
+namespace nntrainer {
+
+namespace {
+
+/** number of independent accumulators of the vectorized reductions */
+constexpr unsigned int LANES = 8;
+
+/**
+ * @brief merge the moments (nb, mb, qb) into (na, ma, qa) with Chan's formula
+ * @param[in/out] na count
+ * @param[in/out] ma mean
+ * @param[in/out] qa sum of squared deviation
+ */
+inline void mergeMoments(double &na, float &ma, float &qa, double nb, float mb,
+                         float qb) {
+  double n = na + nb;
+  float delta = mb - ma;
+  ma += static_cast<float>(delta * (nb / n));
+  qa += qb + static_cast<float>(delta * delta * (na * nb / n));
+  na = n;
+}
+
+/**
+ * @brief single pass Welford mean and sum of squared deviation of x[0, n)
+ */
+template <typename T>
+void welford(const T *x, unsigned int n, float &mean, float &m2) {
+  float lane_mean[LANES] = {0.0f};
+  float lane_m2[LANES] = {0.0f};
+  unsigned int steps = n / LANES;
+
+  for (unsigned int s = 0; s < steps; ++s) {
+    const T *p = x + s * LANES;
+    const float r = 1.0f / static_cast<float>(s + 1);
+    for (unsigned int l = 0; l < LANES; ++l) {
+      float v = static_cast<float>(p[l]);
+      float d = v - lane_mean[l];
+      lane_mean[l] += d * r;
+      lane_m2[l] += d * (v - lane_mean[l]);
+    }
+  }
+
+  double count = 0.0;
+  mean = 0.0f;
+  m2 = 0.0f;
+  if (steps > 0) {
+    for (unsigned int l = 0; l < LANES; ++l)
+      mergeMoments(count, mean, m2, steps, lane_mean[l], lane_m2[l]);
+  }
+  for (unsigned int i = steps * LANES; i < n; ++i)
+    mergeMoments(count, mean, m2, 1.0, static_cast<float>(x[i]), 0.0f);
+}
+
+/**
+ * @brief sum of a[0, n) and, if b is given, of a[i] * b[i]
+ */
+template <typename T>
+void laneSums(const T *a, const T *b, unsigned int n, float &sum_a,
+              float &sum_ab) {
+  float acc_a[LANES] = {0.0f};
+  float acc_ab[LANES] = {0.0f};
+  unsigned int i = 0;
+
+  if (b != nullptr) {
+    for (; i + LANES <= n; i += LANES) {
+      for (unsigned int l = 0; l < LANES; ++l) {
+        float v = static_cast<float>(a[i + l]);
+        acc_a[l] += v;
+        acc_ab[l] += v * static_cast<float>(b[i + l]);
+      }
+    }
+  } else {
+    for (; i + LANES <= n; i += LANES) {
+      for (unsigned int l = 0; l < LANES; ++l)
+        acc_a[l] += static_cast<float>(a[i + l]);
+    }
+  }
+
+  sum_a = 0.0f;
+  sum_ab = 0.0f;
+  for (unsigned int l = 0; l < LANES; ++l) {
+    sum_a += acc_a[l];
+    sum_ab += acc_ab[l];
+  }
+  for (; i < n; ++i) {
+    float v = static_cast<float>(a[i]);
+    sum_a += v;
+    if (b != nullptr)
+      sum_ab += v * static_cast<float>(b[i]);
+  }
+}
+
+/**
+ * @brief sum of the squares of x[0, n)
+ */
+template <typename T> float sumSquares(const T *x, unsigned int n) {
+  float acc[LANES] = {0.0f};
+  unsigned int i = 0;
+  for (; i + LANES <= n; i += LANES) {
+    for (unsigned int l = 0; l < LANES; ++l) {
+      float v = static_cast<float>(x[i + l]);
+      acc[l] += v * v;
+    }
+  }
+
+  float sum = 0.0f;
+  for (unsigned int l = 0; l < LANES; ++l)
+    sum += acc[l];
+  for (; i < n; ++i) {
+    float v = static_cast<float>(x[i]);
+    sum += v * v;
+  }
+  return sum;
+}
+
+/**
+ * @brief per channel sum of dy and dy * xhat on the [outer, channel, inner]
+ * view, xhat can be nullptr
+ */
+template <typename T>
+void channelSums(const T *dy, const T *xhat, unsigned int outer,
+                 unsigned int channel, unsigned int inner,
+                 std::vector<float> &sum_dy, std::vector<float> &sum_dyx) {
+  sum_dy.assign(channel, 0.0f);
+  sum_dyx.assign(channel, 0.0f);
+
+  if (inner == 1) {
+    /** channel is the contiguous axis, vectorize over channels */
+    for (unsigned int o = 0; o < outer; ++o) {
+      const T *d = dy + static_cast<size_t>(o) * channel;
+      for (unsigned int c = 0; c < channel; ++c)
+        sum_dy[c] += static_cast<float>(d[c]);
+      if (xhat == nullptr)
+        continue;
+      const T *h = xhat + static_cast<size_t>(o) * channel;
+      for (unsigned int c = 0; c < channel; ++c)
+        sum_dyx[c] += static_cast<float>(d[c]) * static_cast<float>(h[c]);
+    }
+    return;
+  }
+
+  for (unsigned int o = 0; o < outer; ++o) {
+    for (unsigned int c = 0; c < channel; ++c) {
+      size_t offset = (static_cast<size_t>(o) * channel + c) * inner;
+      float s, sx;
+      laneSums(dy + offset, xhat ? xhat + offset : nullptr, inner, s, sx);
+      sum_dy[c] += s;
+      sum_dyx[c] += sx;
+    }
+  }
+}
+
+/**
+ * @brief copy a parameter vector to float
+ */
+template <typename P>
+std::vector<float> toFloat(const P *p, unsigned int len) {
+  std::vector<float> out(len);
+  for (unsigned int i = 0; i < len; ++i)
+    out[i] = static_cast<float>(p[i]);
+  return out;
+}
+
+} // namespace
+
+template <typename T, typename P>
+void batch_norm_forward(const T *x, T *xhat, T *y, unsigned int outer,
+                        unsigned int channel, unsigned int inner, P *mu,
+                        P *var, const P *gamma, const P *beta, P *invstd,
+                        float epsilon, float momentum, bool training) {
+  std::vector<float> mean(channel, 0.0f);
+  std::vector<float> istd(channel);
+
+  if (training) {
+    std::vector<float> m2(channel, 0.0f);
+    if (inner == 1) {
+      /** column-wise Welford, all the channels share the same count */
+      for (unsigned int o = 0; o < outer; ++o) {
+        const T *row = x + static_cast<size_t>(o) * channel;
+        const float r = 1.0f / static_cast<float>(o + 1);
+        for (unsigned int c = 0; c < channel; ++c) {
+          float v = static_cast<float>(row[c]);
+          float d = v - mean[c];
+          mean[c] += d * r;
+          m2[c] += d * (v - mean[c]);
+        }
+      }
+    } else {
+      for (unsigned int o = 0; o < outer; ++o) {
+        for (unsigned int c = 0; c < channel; ++c) {
+          const T *slab = x + (static_cast<size_t>(o) * channel + c) * inner;
+          float slab_mean, slab_m2;
+          welford(slab, inner, slab_mean, slab_m2);
+          double count = static_cast<double>(o) * inner;
+          mergeMoments(count, mean[c], m2[c], inner, slab_mean, slab_m2);
+        }
+      }
+    }
+
+    const float n = static_cast<float>(outer) * inner;
+    for (unsigned int c = 0; c < channel; ++c) {
+      float batch_var = m2[c] / n;
+      mu[c] = static_cast<P>(static_cast<float>(mu[c]) * momentum +
+                             mean[c] * (1 - momentum));
+      var[c] = static_cast<P>(static_cast<float>(var[c]) * momentum +
+                              batch_var * (1 - momentum));
+      istd[c] = 1.0f / std::sqrt(batch_var + epsilon);
+      invstd[c] = static_cast<P>(istd[c]);
+    }
+  } else {
+    for (unsigned int c = 0; c < channel; ++c) {
+      mean[c] = static_cast<float>(mu[c]);
+      istd[c] = 1.0f / std::sqrt(static_cast<float>(var[c]) + epsilon);
+      invstd[c] = static_cast<P>(istd[c]);
+    }
+  }
+
+  std::vector<float> g = toFloat(gamma, channel);
+  std::vector<float> b = toFloat(beta, channel);
+
+  for (unsigned int o = 0; o < outer; ++o) {
+    for (unsigned int c = 0; c < channel; ++c) {
+      size_t offset = (static_cast<size_t>(o) * channel + c) * inner;
+      const T *in = x + offset;
+      T *out = y + offset;
+      const float m = mean[c], s = istd[c], gc = g[c], bc = b[c];
+      if (xhat != nullptr) {
+        T *h = xhat + offset;
+        for (unsigned int i = 0; i < inner; ++i) {
+          float n = (static_cast<float>(in[i]) - m) * s;
+          h[i] = static_cast<T>(n);
+          out[i] = static_cast<T>(gc * n + bc);
+        }
+      } else {
+        for (unsigned int i = 0; i < inner; ++i) {
+          float n = (static_cast<float>(in[i]) - m) * s;
+          out[i] = static_cast<T>(gc * n + bc);
+        }
+      }
+    }
+  }
+}
+
+template <typename T, typename P>
+void batch_norm_backward(const T *dy, const T *xhat, T *dx, unsigned int outer,
+                         unsigned int channel, unsigned int inner,
+                         const P *gamma, const P *invstd, P *dgamma) {
+  std::vector<float> sum_dy, sum_dyx;
+  channelSums(dy, xhat, outer, channel, inner, sum_dy, sum_dyx);
+
+  const float inv_n = 1.0f / (static_cast<float>(outer) * inner);
+  std::vector<float> k(channel), a(channel), b(channel);
+  for (unsigned int c = 0; c < channel; ++c) {
+    if (dgamma != nullptr)
+      dgamma[c] = static_cast<P>(sum_dyx[c]);
+    k[c] = static_cast<float>(gamma[c]) * static_cast<float>(invstd[c]);
+    a[c] = sum_dy[c] * inv_n;
+    b[c] = sum_dyx[c] * inv_n;
+  }
+
+  for (unsigned int o = 0; o < outer; ++o) {
+    for (unsigned int c = 0; c < channel; ++c) {
+      size_t offset = (static_cast<size_t>(o) * channel + c) * inner;
+      const T *d = dy + offset;
+      const T *h = xhat + offset;
+      T *out = dx + offset;
+      const float kc = k[c], ac = a[c], bc = b[c];
+      for (unsigned int i = 0; i < inner; ++i)
+        out[i] = static_cast<T>(kc * (static_cast<float>(d[i]) - ac -
+                                      static_cast<float>(h[i]) * bc));
+    }
+  }
+}
+
+template <typename T, typename P>
+void batch_norm_channel_sum(const T *dy, unsigned int outer,
+                            unsigned int channel, unsigned int inner, P *sum) {
+  std::vector<float> sum_dy, unused;
+  channelSums(dy, static_cast<const T *>(nullptr), outer, channel, inner,
+              sum_dy, unused);
+  for (unsigned int c = 0; c < channel; ++c)
+    sum[c] = static_cast<P>(sum_dy[c]);
+}
+
+template <typename T, typename P>
+void layer_norm_forward(const T *x, T *xhat, T *y, unsigned int rows,
+                        unsigned int cols, const P *gamma, const P *beta,
+                        P *inv_std, float epsilon) {
+  std::vector<float> g = toFloat(gamma, cols);
+  std::vector<float> b = toFloat(beta, cols);
+
+  for (unsigned int r = 0; r < rows; ++r) {
+    size_t offset = static_cast<size_t>(r) * cols;
+    const T *in = x + offset;
+    T *out = y + offset;
+
+    float mean, m2;
+    welford(in, cols, mean, m2);
+    const float s = 1.0f / std::sqrt(m2 / cols + epsilon);
+    inv_std[r] = static_cast<P>(s);
+
+    if (xhat != nullptr) {
+      T *h = xhat + offset;
+      for (unsigned int i = 0; i < cols; ++i) {
+        float n = (static_cast<float>(in[i]) - mean) * s;
+        h[i] = static_cast<T>(n);
+        out[i] = static_cast<T>(g[i] * n + b[i]);
+      }
+    } else {
+      for (unsigned int i = 0; i < cols; ++i) {
+        float n = (static_cast<float>(in[i]) - mean) * s;
+        out[i] = static_cast<T>(g[i] * n + b[i]);
+      }
+    }
+  }
+}
+
+template <typename T, typename P>
+void layer_norm_backward(const T *dy, const T *xhat, T *dx, unsigned int rows,
+                         unsigned int cols, const P *gamma, const P *inv_std,
+                         P *dgamma) {
+  std::vector<float> g = toFloat(gamma, cols);
+  std::vector<float> dg;
+  if (dgamma != nullptr)
+    dg.assign(cols, 0.0f);
+
+  const float inv_cols = 1.0f / cols;
+  for (unsigned int r = 0; r < rows; ++r) {
+    size_t offset = static_cast<size_t>(r) * cols;
+    const T *d = dy + offset;
+    const T *h = xhat + offset;
+    T *out = dx + offset;
+
+    float acc_g[LANES] = {0.0f};
+    float acc_gx[LANES] = {0.0f};
+    unsigned int i = 0;
+    for (; i + LANES <= cols; i += LANES) {
+      for (unsigned int l = 0; l < LANES; ++l) {
+        float v = static_cast<float>(d[i + l]) * g[i + l];
+        acc_g[l] += v;
+        acc_gx[l] += v * static_cast<float>(h[i + l]);
+      }
+    }
+    float sum_g = 0.0f, sum_gx = 0.0f;
+    for (unsigned int l = 0; l < LANES; ++l) {
+      sum_g += acc_g[l];
+      sum_gx += acc_gx[l];
+    }
+    for (; i < cols; ++i) {
+      float v = static_cast<float>(d[i]) * g[i];
+      sum_g += v;
+      sum_gx += v * static_cast<float>(h[i]);
+    }
+
+    /** dgamma reads dy before dx, which may alias it, is written */
+    if (dgamma != nullptr) {
+      for (unsigned int j = 0; j < cols; ++j)
+        dg[j] += static_cast<float>(d[j]) * static_cast<float>(h[j]);
+    }
+
+    const float s = static_cast<float>(inv_std[r]);
+    const float mean_g = sum_g * inv_cols, mean_gx = sum_gx * inv_cols;
+    for (unsigned int j = 0; j < cols; ++j)
+      out[j] = static_cast<T>(s * (static_cast<float>(d[j]) * g[j] - mean_g -
+                                   static_cast<float>(h[j]) * mean_gx));
+  }
+
+  if (dgamma != nullptr) {
+    for (unsigned int j = 0; j < cols; ++j)
+      dgamma[j] = static_cast<P>(dg[j]);
+  }
+}
+
+template <typename T, typename P>
+void layer_norm_column_sum(const T *dy, unsigned int rows, unsigned int cols,
+                           P *sum) {
+  std::vector<float> acc(cols, 0.0f);
+  for (unsigned int r = 0; r < rows; ++r) {
+    const T *d = dy + static_cast<size_t>(r) * cols;
+    for (unsigned int j = 0; j < cols; ++j)
+      acc[j] += static_cast<float>(d[j]);
+  }
+  for (unsigned int j = 0; j < cols; ++j)
+    sum[j] = static_cast<P>(acc[j]);
+}
+
+template <typename T, typename P>
+void rms_norm_forward(const T *x, T *xhat, T *y, unsigned int rows,
+                      unsigned int cols, const P *gamma, P *inv_rms,
+                      float epsilon) {
+  std::vector<float> g = toFloat(gamma, cols);
+
+  for (unsigned int r = 0; r < rows; ++r) {
+    size_t offset = static_cast<size_t>(r) * cols;
+    const T *in = x + offset;
+    T *out = y + offset;
+
+    const float s = 1.0f / std::sqrt(sumSquares(in, cols) / cols + epsilon);
+    if (inv_rms != nullptr)
+      inv_rms[r] = static_cast<P>(s);
+
+    if (xhat != nullptr) {
+      T *h = xhat + offset;
+      for (unsigned int i = 0; i < cols; ++i) {
+        float n = static_cast<float>(in[i]) * s;
+        h[i] = static_cast<T>(n);
+        out[i] = static_cast<T>(g[i] * n);
+      }
+    } else {
+      for (unsigned int i = 0; i < cols; ++i)
+        out[i] = static_cast<T>(g[i] * static_cast<float>(in[i]) * s);
+    }
+  }
+}
+
+template <typename T, typename P>
+void rms_norm_backward(const T *dy, const T *xhat, T *dx, unsigned int rows,
+                       unsigned int cols, const P *gamma, const P *inv_rms,
+                       P *dgamma) {
+  std::vector<float> g = toFloat(gamma, cols);
+  std::vector<float> dg;
+  if (dgamma != nullptr)
+    dg.assign(cols, 0.0f);
+
+  const float inv_cols = 1.0f / cols;
+  for (unsigned int r = 0; r < rows; ++r) {
+    size_t offset = static_cast<size_t>(r) * cols;
+    const T *d = dy + offset;
+    const T *h = xhat + offset;
+
+    /** dgamma reads dy before dx, which may alias it, is written */
+    if (dgamma != nullptr) {
+      for (unsigned int j = 0; j < cols; ++j)
+        dg[j] += static_cast<float>(d[j]) * static_cast<float>(h[j]);
+    }
+
+    if (dx == nullptr)
+      continue;
+
+    float acc_gx[LANES] = {0.0f};
+    unsigned int i = 0;
+    for (; i + LANES <= cols; i += LANES) {
+      for (unsigned int l = 0; l < LANES; ++l)
+        acc_gx[l] += static_cast<float>(d[i + l]) * g[i + l] *
+                     static_cast<float>(h[i + l]);
+    }
+    float sum_gx = 0.0f;
+    for (unsigned int l = 0; l < LANES; ++l)
+      sum_gx += acc_gx[l];
+    for (; i < cols; ++i)
+      sum_gx += static_cast<float>(d[i]) * g[i] * static_cast<float>(h[i]);
+
+    T *out = dx + offset;
+    const float s = static_cast<float>(inv_rms[r]);
+    const float mean_gx = sum_gx * inv_cols;
+    for (unsigned int j = 0; j < cols; ++j)
+      out[j] = static_cast<T>(s * (static_cast<float>(d[j]) * g[j] -
+                                   static_cast<float>(h[j]) * mean_gx));
+  }
+
+  if (dgamma != nullptr) {
+    for (unsigned int j = 0; j < cols; ++j)
+      dgamma[j] = static_cast<P>(static_cast<float>(dgamma[j]) + dg[j]);
+  }
+}
+
+#define INSTANTIATE_NORMALIZATION_KERNEL(T, P)                                \
+  template void batch_norm_forward<T, P>(                                     \
+    const T *, T *, T *, unsigned int, unsigned int, unsigned int, P *, P *,  \
+    const P *, const P *, P *, float, float, bool);                           \
+  template void batch_norm_backward<T, P>(const T *, const T *, T *,          \
+                                          unsigned int, unsigned int,         \
+                                          unsigned int, const P *, const P *, \
+                                          P *);                               \
+  template void batch_norm_channel_sum<T, P>(const T *, unsigned int,         \
+                                             unsigned int, unsigned int, P *); \
+  template void layer_norm_forward<T, P>(const T *, T *, T *, unsigned int,   \
+                                         unsigned int, const P *, const P *,  \
+                                         P *, float);                         \
+  template void layer_norm_backward<T, P>(const T *, const T *, T *,          \
+                                          unsigned int, unsigned int,         \
+                                          const P *, const P *, P *);         \
+  template void layer_norm_column_sum<T, P>(const T *, unsigned int,          \
+                                            unsigned int, P *);               \
+  template void rms_norm_forward<T, P>(const T *, T *, T *, unsigned int,     \
+                                       unsigned int, const P *, P *, float);  \
+  template void rms_norm_backward<T, P>(const T *, const T *, T *,            \
+                                        unsigned int, unsigned int,           \
+                                        const P *, const P *, P *)
+
+INSTANTIATE_NORMALIZATION_KERNEL(float, float);
+#ifdef ENABLE_FP16
+INSTANTIATE_NORMALIZATION_KERNEL(_FP16, _FP16);
+INSTANTIATE_NORMALIZATION_KERNEL(_FP16, float);
+#endif
+
+} /* namespace nntrainer */
@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   normalization_kernel.h
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Fused single-pass statistics and affine kernels for batch, layer and
+ * RMS normalization. Statistics are gathered with Welford/Chan updates so the
+ * forward and backward passes never build full sized temporaries.
+ *
+ */
+
+#ifndef __NORMALIZATION_KERNEL_H__
+#define __NORMALIZATION_KERNEL_H__
+#ifdef __cplusplus
+
+#include <stdexcept>
+
+#include <tensor_dim.h>
+
+namespace nntrainer {
+
+/**
+ * @brief     call fn(T{}, P{}) where T and P are the c++ types of the given
+ * activation and parameter data types
+ * @param[in] act data type of the activation
+ * @param[in] param data type of the parameters
+ * @param[in] fn generic callable
+ * @throws std::invalid_argument if the combination is not supported
+ */
+template <typename F>
+void normalization_dispatch(ml::train::TensorDim::DataType act,
+                            ml::train::TensorDim::DataType param, F &&fn) {
+  using DataType = ml::train::TensorDim::DataType;
+  if (act == DataType::FP32 && param == DataType::FP32) {
+    fn(float{}, float{});
+#ifdef ENABLE_FP16
+  } else if (act == DataType::FP16 && param == DataType::FP16) {
+    fn(_FP16{}, _FP16{});
+  } else if (act == DataType::FP16 && param == DataType::FP32) {
+    fn(_FP16{}, float{});
+#endif
+  } else {
+    throw std::invalid_argument(
+      "[normalization] unsupported activation/parameter data type");
+  }
+}
+
+/**
+ * @brief     batch normalization forward on data viewed as
+ * [outer, channel, inner] where channel is the normalized (kept) axis
+ * @tparam T data type of the activation
+ * @tparam P data type of the parameters
+ * @param[in] x input
+ * @param[out] xhat normalized input saved for the backward, nullptr to skip
+ * @param[out] y output, may alias x
+ * @param[in] outer number of slabs before the channel axis
+ * @param[in] channel size of the channel axis
+ * @param[in] inner number of contiguous elements after the channel axis
+ * @param[in/out] mu moving mean, updated when training
+ * @param[in/out] var moving variance, updated when training
+ * @param[in] gamma scale
+ * @param[in] beta shift
+ * @param[out] invstd inverse standard deviation used for the normalization
+ * @param[in] epsilon epsilon
+ * @param[in] momentum momentum of the moving statistics
+ * @param[in] training use batch statistics if true, moving statistics if not
+ */
+template <typename T, typename P>
+void batch_norm_forward(const T *x, T *xhat, T *y, unsigned int outer,
+                        unsigned int channel, unsigned int inner, P *mu,
+                        P *var, const P *gamma, const P *beta, P *invstd,
+                        float epsilon, float momentum, bool training);
+
+/**
+ * @brief     batch normalization derivative on the [outer, channel, inner]
+ * view. dx = gamma * invstd * (dy - mean(dy) - xhat * mean(dy * xhat))
+ * @param[in] dy incoming derivative
+ * @param[in] xhat normalized input saved by the forward
+ * @param[out] dx outgoing derivative, may alias dy
+ * @param[in] outer number of slabs before the channel axis
+ * @param[in] channel size of the channel axis
+ * @param[in] inner number of contiguous elements after the channel axis
+ * @param[in] gamma scale
+ * @param[in] invstd inverse standard deviation saved by the forward
+ * @param[out] dgamma gradient of gamma, nullptr to skip
+ */
+template <typename T, typename P>
+void batch_norm_backward(const T *dy, const T *xhat, T *dx, unsigned int outer,
+                         unsigned int channel, unsigned int inner,
+                         const P *gamma, const P *invstd, P *dgamma);
+
+/**
+ * @brief     sum of dy over all the axes except the channel axis of the
+ * [outer, channel, inner] view
+ * @param[in] dy incoming derivative
+ * @param[in] outer number of slabs before the channel axis
+ * @param[in] channel size of the channel axis
+ * @param[in] inner number of contiguous elements after the channel axis
+ * @param[out] sum result of size channel
+ */
+template <typename T, typename P>
+void batch_norm_channel_sum(const T *dy, unsigned int outer,
+                            unsigned int channel, unsigned int inner, P *sum);
+
+/**
+ * @brief     layer normalization forward on data viewed as [rows, cols]
+ * where every row is normalized on its own
+ * @param[in] x input
+ * @param[out] xhat normalized input saved for the backward, nullptr to skip
+ * @param[out] y output, may alias x
+ * @param[in] rows number of rows
+ * @param[in] cols number of elements of a row
+ * @param[in] gamma scale of size cols
+ * @param[in] beta shift of size cols
+ * @param[out] inv_std inverse standard deviation of each row
+ * @param[in] epsilon epsilon
+ */
+template <typename T, typename P>
+void layer_norm_forward(const T *x, T *xhat, T *y, unsigned int rows,
+                        unsigned int cols, const P *gamma, const P *beta,
+                        P *inv_std, float epsilon);
+
+/**
+ * @brief     layer normalization derivative on the [rows, cols] view.
+ * dx = inv_std * (g - mean(g) - xhat * mean(g * xhat)) where g = dy * gamma
+ * @param[in] dy incoming derivative
+ * @param[in] xhat normalized input saved by the forward
+ * @param[out] dx outgoing derivative, may alias dy
+ * @param[in] rows number of rows
+ * @param[in] cols number of elements of a row
+ * @param[in] gamma scale
+ * @param[in] inv_std inverse standard deviation saved by the forward
+ * @param[out] dgamma gradient of gamma, nullptr to skip
+ */
+template <typename T, typename P>
+void layer_norm_backward(const T *dy, const T *xhat, T *dx, unsigned int rows,
+                         unsigned int cols, const P *gamma, const P *inv_std,
+                         P *dgamma);
+
+/**
+ * @brief     column sum of the [rows, cols] view
+ * @param[in] dy incoming derivative
+ * @param[in] rows number of rows
+ * @param[in] cols number of elements of a row
+ * @param[out] sum result of size cols
+ */
+template <typename T, typename P>
+void layer_norm_column_sum(const T *dy, unsigned int rows, unsigned int cols,
+                           P *sum);
+
+/**
+ * @brief     RMS normalization forward on data viewed as [rows, cols] where
+ * every row is scaled by the inverse of its root mean square
+ * @param[in] x input
+ * @param[out] xhat normalized input saved for the backward, nullptr to skip
+ * @param[out] y output, may alias x
+ * @param[in] rows number of rows
+ * @param[in] cols number of elements of a row
+ * @param[in] gamma scale of size cols
+ * @param[out] inv_rms inverse root mean square of each row, nullptr to skip
+ * @param[in] epsilon epsilon added to the mean square
+ */
+template <typename T, typename P>
+void rms_norm_forward(const T *x, T *xhat, T *y, unsigned int rows,
+                      unsigned int cols, const P *gamma, P *inv_rms,
+                      float epsilon);
+
+/**
+ * @brief     RMS normalization derivative on the [rows, cols] view.
+ * dx = inv_rms * (g - xhat * mean(g * xhat)) where g = dy * gamma
+ * @param[in] dy incoming derivative
+ * @param[in] xhat normalized input saved by the forward
+ * @param[out] dx outgoing derivative, may alias dy, nullptr to skip
+ * @param[in] rows number of rows
+ * @param[in] cols number of elements of a row
+ * @param[in] gamma scale
+ * @param[in] inv_rms inverse root mean square saved by the forward
+ * @param[in,out] dgamma gradient of gamma accumulated to, nullptr to skip
+ */
+template <typename T, typename P>
+void rms_norm_backward(const T *dy, const T *xhat, T *dx, unsigned int rows,
+                       unsigned int cols, const P *gamma, const P *inv_rms,
+                       P *dgamma);
+
+} /* namespace nntrainer */
+
+#endif /* __cplusplus */
+#endif /* __NORMALIZATION_KERNEL_H__ */
@@ -0,0 +1,386 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   recurrent_kernel.cpp
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Batched kernels of the recurrent layers
+ *
+ */
+
+#include <blas_interface.h>
+#include <recurrent_kernel.h>
+
+namespace nntrainer {
+
+void recurrent_projection(unsigned int rows, unsigned int in_size,
+                          unsigned int out_size, const float *x,
+                          const float *weight, const float *bias, float *y) {
+  if (bias) {
+    for (unsigned int r = 0; r < rows; ++r) {
+      float *y_row = y + static_cast<size_t>(r) * out_size;
+      for (unsigned int i = 0; i < out_size; ++i)
+        y_row[i] = bias[i];
+    }
+  }
+
+  sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, rows, out_size, in_size,
+        1.0f, x, in_size, weight, out_size, bias ? 1.0f : 0.0f, y, out_size);
+}
+
+void recurrent_projection_gradient(unsigned int rows, unsigned int in_size,
+                                   unsigned int out_size, const float *x,
+                                   const float *dy, float *d_weight) {
+  sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, in_size, out_size, rows, 1.0f,
+        x, in_size, dy, out_size, 1.0f, d_weight, out_size);
+}
+
+void recurrent_column_sum(unsigned int rows, unsigned int cols, const float *x,
+                          unsigned int ld, float *sum) {
+  for (unsigned int r = 0; r < rows; ++r) {
+    const float *x_row = x + static_cast<size_t>(r) * ld;
+    for (unsigned int i = 0; i < cols; ++i)
+      sum[i] += x_row[i];
+  }
+}
+
+void lstm_gates_forward(unsigned int batch, unsigned int unit, float *ifgo,
+                        unsigned int ld_gate, const float *c_prev, float *c,
+                        float *h, unsigned int ld_state,
+                        const RecurrentActivation &act,
+                        const RecurrentActivation &recurrent_act) {
+  for (unsigned int b = 0; b < batch; ++b) {
+    float *i_gate = ifgo + static_cast<size_t>(b) * ld_gate;
+    float *f_gate = i_gate + unit;
+    float *g_gate = f_gate + unit;
+    float *o_gate = g_gate + unit;
+    const size_t offset = static_cast<size_t>(b) * ld_state;
+    float *c_row = c + offset;
+    float *h_row = h + offset;
+
+    for (unsigned int u = 0; u < unit; ++u) {
+      i_gate[u] = recurrent_act.fn(i_gate[u]);
+      f_gate[u] = recurrent_act.fn(f_gate[u]);
+      g_gate[u] = act.fn(g_gate[u]);
+      o_gate[u] = recurrent_act.fn(o_gate[u]);
+    }
+
+    if (c_prev) {
+      const float *c_prev_row = c_prev + offset;
+      for (unsigned int u = 0; u < unit; ++u)
+        c_row[u] = f_gate[u] * c_prev_row[u] + i_gate[u] * g_gate[u];
+    } else {
+      for (unsigned int u = 0; u < unit; ++u)
+        c_row[u] = i_gate[u] * g_gate[u];
+    }
+
+    for (unsigned int u = 0; u < unit; ++u)
+      h_row[u] = o_gate[u] * act.fn(c_row[u]);
+  }
+}
+
+void lstm_gates_backward(unsigned int batch, unsigned int unit,
+                         const float *ifgo, unsigned int ld_gate,
+                         const float *c_prev, const float *c, const float *dh,
+                         const float *dc, float *dc_prev, float *d_ifgo,
+                         unsigned int ld_state, const RecurrentActivation &act,
+                         const RecurrentActivation &recurrent_act) {
+  for (unsigned int b = 0; b < batch; ++b) {
+    const float *i_gate = ifgo + static_cast<size_t>(b) * ld_gate;
+    const float *f_gate = i_gate + unit;
+    const float *g_gate = f_gate + unit;
+    const float *o_gate = g_gate + unit;
+    float *d_i = d_ifgo + static_cast<size_t>(b) * ld_gate;
+    float *d_f = d_i + unit;
+    float *d_g = d_f + unit;
+    float *d_o = d_g + unit;
+    const size_t offset = static_cast<size_t>(b) * ld_state;
+    const float *c_row = c + offset;
+    const float *dh_row = dh + offset;
+    const float *dc_row = dc ? dc + offset : nullptr;
+    const float *c_prev_row = c_prev ? c_prev + offset : nullptr;
+    float *dc_prev_row = dc_prev ? dc_prev + offset : nullptr;
+
+    for (unsigned int u = 0; u < unit; ++u) {
+      const float activated = act.fn(c_row[u]);
+      float d_cell = dh_row[u] * o_gate[u] * act.prime(activated);
+      if (dc_row)
+        d_cell += dc_row[u];
+
+      d_o[u] = dh_row[u] * activated * recurrent_act.prime(o_gate[u]);
+      d_g[u] = d_cell * i_gate[u] * act.prime(g_gate[u]);
+      d_i[u] = d_cell * g_gate[u] * recurrent_act.prime(i_gate[u]);
+      d_f[u] = c_prev_row
+                 ? d_cell * c_prev_row[u] * recurrent_act.prime(f_gate[u])
+                 : 0.0f;
+      if (dc_prev_row)
+        dc_prev_row[u] = d_cell * f_gate[u];
+    }
+  }
+}
+
+void lstm_step_forward(unsigned int batch, unsigned int unit, float *ifgo,
+                       unsigned int ld_gate, const float *h_prev,
+                       const float *c_prev, float *h, float *c,
+                       unsigned int ld_state, const float *weight_hh,
+                       const RecurrentActivation &act,
+                       const RecurrentActivation &recurrent_act) {
+  const unsigned int n_gate = 4 * unit;
+  if (h_prev)
+    sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, batch, n_gate, unit,
+          1.0f, h_prev, ld_state, weight_hh, n_gate, 1.0f, ifgo, ld_gate);
+
+  lstm_gates_forward(batch, unit, ifgo, ld_gate, c_prev, c, h, ld_state, act,
+                     recurrent_act);
+}
+
+void lstm_step_backward(unsigned int batch, unsigned int unit,
+                        const float *ifgo, float *d_ifgo, unsigned int ld_gate,
+                        const float *h_prev, float *dh_prev,
+                        const float *c_prev, const float *c, const float *dh,
+                        const float *dc, float *dc_prev, unsigned int ld_state,
+                        const float *weight_hh, float *d_weight_hh,
+                        const RecurrentActivation &act,
+                        const RecurrentActivation &recurrent_act) {
+  lstm_gates_backward(batch, unit, ifgo, ld_gate, c_prev, c, dh, dc, dc_prev,
+                      d_ifgo, ld_state, act, recurrent_act);
+
+  if (!h_prev)
+    return;
+
+  const unsigned int n_gate = 4 * unit;
+  sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, unit, n_gate, batch, 1.0f,
+        h_prev, ld_state, d_ifgo, ld_gate, 1.0f, d_weight_hh, n_gate);
+  sgemm(CblasRowMajor, CblasNoTrans, CblasTrans, batch, unit, n_gate, 1.0f,
+        d_ifgo, ld_gate, weight_hh, n_gate, 1.0f, dh_prev, ld_state);
+}
+
+void gru_step_forward(unsigned int batch, unsigned int unit, float *zrg,
+                      unsigned int ld_gate, const float *h_prev, float *h,
+                      unsigned int ld_state, const float *weight_hh,
+                      const float *bias_hh_g, bool reset_after,
+                      const RecurrentActivation &act,
+                      const RecurrentActivation &recurrent_act,
+                      float *workspace) {
+  const unsigned int n_gate = 3 * unit;
+  const float *weight_hh_g = weight_hh + 2 * unit;
+
+  if (h_prev)
+    sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, batch, 2 * unit, unit,
+          1.0f, h_prev, ld_state, weight_hh, n_gate, 1.0f, zrg, ld_gate);
+
+  for (unsigned int b = 0; b < batch; ++b) {
+    float *zr = zrg + static_cast<size_t>(b) * ld_gate;
+    for (unsigned int u = 0; u < 2 * unit; ++u)
+      zr[u] = recurrent_act.fn(zr[u]);
+  }
+
+  if (reset_after) {
+    /** g += r * (h_prev . W_g + bias_hh_g) */
+    if (h_prev)
+      sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, batch, unit, unit, 1.0f,
+            h_prev, ld_state, weight_hh_g, n_gate, 0.0f, workspace, unit);
+
+    for (unsigned int b = 0; b < batch; ++b) {
+      float *r_gate = zrg + static_cast<size_t>(b) * ld_gate + unit;
+      float *g_gate = r_gate + unit;
+      const float *tmp = workspace + static_cast<size_t>(b) * unit;
+      for (unsigned int u = 0; u < unit; ++u) {
+        float hidden = h_prev ? tmp[u] : 0.0f;
+        if (bias_hh_g)
+          hidden += bias_hh_g[u];
+        g_gate[u] += r_gate[u] * hidden;
+      }
+    }
+  } else if (h_prev) {
+    /** g += (r * h_prev) . W_g */
+    for (unsigned int b = 0; b < batch; ++b) {
+      const float *r_gate = zrg + static_cast<size_t>(b) * ld_gate + unit;
+      const float *h_prev_row = h_prev + static_cast<size_t>(b) * ld_state;
+      float *tmp = workspace + static_cast<size_t>(b) * unit;
+      for (unsigned int u = 0; u < unit; ++u)
+        tmp[u] = r_gate[u] * h_prev_row[u];
+    }
+
+    sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, batch, unit, unit, 1.0f,
+          workspace, unit, weight_hh_g, n_gate, 1.0f, zrg + 2 * unit, ld_gate);
+  }
+
+  for (unsigned int b = 0; b < batch; ++b) {
+    const float *z_gate = zrg + static_cast<size_t>(b) * ld_gate;
+    float *g_gate = zrg + static_cast<size_t>(b) * ld_gate + 2 * unit;
+    float *h_row = h + static_cast<size_t>(b) * ld_state;
+
+    for (unsigned int u = 0; u < unit; ++u)
+      g_gate[u] = act.fn(g_gate[u]);
+
+    if (h_prev) {
+      const float *h_prev_row = h_prev + static_cast<size_t>(b) * ld_state;
+      for (unsigned int u = 0; u < unit; ++u)
+        h_row[u] = z_gate[u] * h_prev_row[u] + (1.0f - z_gate[u]) * g_gate[u];
+    } else {
+      for (unsigned int u = 0; u < unit; ++u)
+        h_row[u] = (1.0f - z_gate[u]) * g_gate[u];
+    }
+  }
+}
+
+void gru_step_backward(unsigned int batch, unsigned int unit, const float *zrg,
+                       float *d_zrg, unsigned int ld_gate, const float *h_prev,
+                       const float *dh, float *dh_prev, unsigned int ld_state,
+                       const float *weight_hh, const float *bias_hh_g,
+                       bool reset_after, float *d_weight_hh,
+                       float *d_bias_hh_g, const RecurrentActivation &act,
+                       const RecurrentActivation &recurrent_act,
+                       float *workspace) {
+  const unsigned int n_gate = 3 * unit;
+  const float *weight_hh_g = weight_hh + 2 * unit;
+  float *d_weight_hh_g = d_weight_hh + 2 * unit;
+  float *tmp = workspace;
+  float *hidden = workspace + static_cast<size_t>(batch) * unit;
+
+  /** dz, dg and the direct path of dh_prev */
+  for (unsigned int b = 0; b < batch; ++b) {
+    const float *z_gate = zrg + static_cast<size_t>(b) * ld_gate;
+    const float *g_gate = z_gate + 2 * unit;
+    float *d_z = d_zrg + static_cast<size_t>(b) * ld_gate;
+    float *d_g = d_z + 2 * unit;
+    const size_t offset = static_cast<size_t>(b) * ld_state;
+    const float *dh_row = dh + offset;
+
+    if (h_prev) {
+      const float *h_prev_row = h_prev + offset;
+      float *dh_prev_row = dh_prev + offset;
+      for (unsigned int u = 0; u < unit; ++u) {
+        dh_prev_row[u] += z_gate[u] * dh_row[u];
+        d_z[u] = dh_row[u] * (h_prev_row[u] - g_gate[u]) *
+                 recurrent_act.prime(z_gate[u]);
+      }
+    } else {
+      for (unsigned int u = 0; u < unit; ++u)
+        d_z[u] = -dh_row[u] * g_gate[u] * recurrent_act.prime(z_gate[u]);
+    }
+
+    for (unsigned int u = 0; u < unit; ++u)
+      d_g[u] = (1.0f - z_gate[u]) * dh_row[u] * act.prime(g_gate[u]);
+  }
+
+  if (reset_after) {
+    /** hidden = h_prev . W_g + bias_hh_g, tmp = dg * r */
+    if (h_prev)
+      sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, batch, unit, unit, 1.0f,
+            h_prev, ld_state, weight_hh_g, n_gate, 0.0f, hidden, unit);
+
+    for (unsigned int b = 0; b < batch; ++b) {
+      const float *r_gate = zrg + static_cast<size_t>(b) * ld_gate + unit;
+      float *d_r = d_zrg + static_cast<size_t>(b) * ld_gate + unit;
+      const float *d_g = d_r + unit;
+      float *hidden_row = hidden + static_cast<size_t>(b) * unit;
+      float *tmp_row = tmp + static_cast<size_t>(b) * unit;
+      for (unsigned int u = 0; u < unit; ++u) {
+        float value = h_prev ? hidden_row[u] : 0.0f;
+        if (bias_hh_g)
+          value += bias_hh_g[u];
+        d_r[u] = d_g[u] * value;
+        tmp_row[u] = d_g[u] * r_gate[u];
+      }
+    }
+
+    if (d_bias_hh_g)
+      recurrent_column_sum(batch, unit, tmp, unit, d_bias_hh_g);
+
+    if (h_prev) {
+      sgemm(CblasRowMajor, CblasNoTrans, CblasTrans, batch, unit, unit, 1.0f,
+            tmp, unit, weight_hh_g, n_gate, 1.0f, dh_prev, ld_state);
+      sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, unit, unit, batch, 1.0f,
+            h_prev, ld_state, tmp, unit, 1.0f, d_weight_hh_g, n_gate);
+    }
+  } else {
+    if (d_bias_hh_g)
+      recurrent_column_sum(batch, unit, d_zrg + 2 * unit, ld_gate,
+                           d_bias_hh_g);
+
+    if (h_prev) {
+      /** tmp = dg . W_g^T, dr = tmp * h_prev, dh_prev += tmp * r */
+      sgemm(CblasRowMajor, CblasNoTrans, CblasTrans, batch, unit, unit, 1.0f,
+            d_zrg + 2 * unit, ld_gate, weight_hh_g, n_gate, 0.0f, tmp, unit);
+
+      for (unsigned int b = 0; b < batch; ++b) {
+        const float *r_gate = zrg + static_cast<size_t>(b) * ld_gate + unit;
+        float *d_r = d_zrg + static_cast<size_t>(b) * ld_gate + unit;
+        const size_t offset = static_cast<size_t>(b) * ld_state;
+        const float *h_prev_row = h_prev + offset;
+        float *dh_prev_row = dh_prev + offset;
+        const float *tmp_row = tmp + static_cast<size_t>(b) * unit;
+        float *hidden_row = hidden + static_cast<size_t>(b) * unit;
+        for (unsigned int u = 0; u < unit; ++u) {
+          d_r[u] = tmp_row[u] * h_prev_row[u];
+          dh_prev_row[u] += tmp_row[u] * r_gate[u];
+          hidden_row[u] = r_gate[u] * h_prev_row[u];
+        }
+      }
+
+      sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, unit, unit, batch, 1.0f,
+            hidden, unit, d_zrg + 2 * unit, ld_gate, 1.0f, d_weight_hh_g,
+            n_gate);
+    } else {
+      for (unsigned int b = 0; b < batch; ++b) {
+        float *d_r = d_zrg + static_cast<size_t>(b) * ld_gate + unit;
+        for (unsigned int u = 0; u < unit; ++u)
+          d_r[u] = 0.0f;
+      }
+    }
+  }
+
+  for (unsigned int b = 0; b < batch; ++b) {
+    const float *r_gate = zrg + static_cast<size_t>(b) * ld_gate + unit;
+    float *d_r = d_zrg + static_cast<size_t>(b) * ld_gate + unit;
+    for (unsigned int u = 0; u < unit; ++u)
+      d_r[u] *= recurrent_act.prime(r_gate[u]);
+  }
+
+  if (h_prev) {
+    sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, unit, 2 * unit, batch, 1.0f,
+          h_prev, ld_state, d_zrg, ld_gate, 1.0f, d_weight_hh, n_gate);
+    sgemm(CblasRowMajor, CblasNoTrans, CblasTrans, batch, unit, 2 * unit, 1.0f,
+          d_zrg, ld_gate, weight_hh, n_gate, 1.0f, dh_prev, ld_state);
+  }
+}
+
+void rnn_step_forward(unsigned int batch, unsigned int unit,
+                      const float *h_prev, float *h, unsigned int ld_state,
+                      const float *weight_hh, const RecurrentActivation &act) {
+  if (h_prev)
+    sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, batch, unit, unit, 1.0f,
+          h_prev, ld_state, weight_hh, unit, 1.0f, h, ld_state);
+
+  for (unsigned int b = 0; b < batch; ++b) {
+    float *h_row = h + static_cast<size_t>(b) * ld_state;
+    for (unsigned int u = 0; u < unit; ++u)
+      h_row[u] = act.fn(h_row[u]);
+  }
+}
+
+void rnn_step_backward(unsigned int batch, unsigned int unit,
+                       const float *h_prev, const float *h, float *dh,
+                       float *dh_prev, unsigned int ld_state,
+                       const float *weight_hh, float *d_weight_hh,
+                       const RecurrentActivation &act) {
+  for (unsigned int b = 0; b < batch; ++b) {
+    const float *h_row = h + static_cast<size_t>(b) * ld_state;
+    float *dh_row = dh + static_cast<size_t>(b) * ld_state;
+    for (unsigned int u = 0; u < unit; ++u)
+      dh_row[u] *= act.prime(h_row[u]);
+  }
+
+  if (!h_prev)
+    return;
+
+  sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, unit, unit, batch, 1.0f,
+        h_prev, ld_state, dh, ld_state, 1.0f, d_weight_hh, unit);
+  sgemm(CblasRowMajor, CblasNoTrans, CblasTrans, batch, unit, unit, 1.0f, dh,
+        ld_state, weight_hh, unit, 1.0f, dh_prev, ld_state);
+}
+
+} /* namespace nntrainer */
@@ -0,0 +1,230 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   recurrent_kernel.h
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Batched kernels of the recurrent layers. The input projection of
+ * every timestep is computed by a single gemm, each step runs one batch wide
+ * gemm for the recurrent projection followed by a fused gate kernel.
+ *
+ * States are stored batch first, [batch, timestep, size], so the rows of one
+ * timestep are ld = timestep * size floats apart and are passed to gemm as a
+ * strided matrix without any copy.
+ */
+
+#ifndef __RECURRENT_KERNEL_H__
+#define __RECURRENT_KERNEL_H__
+#ifdef __cplusplus
+
+namespace nntrainer {
+
+/**
+ * @brief element-wise activation of a recurrent cell
+ */
+struct RecurrentActivation {
+  float (*fn)(float);    /**< activation */
+  float (*prime)(float); /**< derivative computed from the activation output */
+};
+
+/**
+ * @brief     y = x . weight + bias for every row of x
+ * @param[in] rows number of rows, batch * timestep
+ * @param[in] in_size width of x
+ * @param[in] out_size width of y
+ * @param[in] x input [rows, in_size]
+ * @param[in] weight weight [in_size, out_size]
+ * @param[in] bias bias [out_size], nullptr if none
+ * @param[out] y output [rows, out_size]
+ */
+void recurrent_projection(unsigned int rows, unsigned int in_size,
+                          unsigned int out_size, const float *x,
+                          const float *weight, const float *bias, float *y);
+
+/**
+ * @brief     d_weight += x^T . dy, the gradient of recurrent_projection
+ * @param[in] rows number of rows, batch * timestep
+ * @param[in] in_size width of x
+ * @param[in] out_size width of dy
+ * @param[in] x input [rows, in_size]
+ * @param[in] dy derivative of the output [rows, out_size]
+ * @param[in/out] d_weight gradient [in_size, out_size], accumulated
+ */
+void recurrent_projection_gradient(unsigned int rows, unsigned int in_size,
+                                   unsigned int out_size, const float *x,
+                                   const float *dy, float *d_weight);
+
+/**
+ * @brief     sum += column sums of x
+ * @param[in] rows number of rows
+ * @param[in] cols number of columns
+ * @param[in] x matrix [rows, cols]
+ * @param[in] ld distance between two rows of x
+ * @param[in/out] sum result [cols], accumulated
+ */
+void recurrent_column_sum(unsigned int rows, unsigned int cols, const float *x,
+                          unsigned int ld, float *sum);
+
+/**
+ * @brief     LSTM gates of one timestep. ifgo holds the pre-activations of
+ * the input, forget, memory and output gates and is overwritten with their
+ * activations.
+ * @param[in] batch batch size
+ * @param[in] unit number of units
+ * @param[in/out] ifgo gates [batch, 4 * unit] with row distance ld_gate
+ * @param[in] ld_gate distance between two rows of ifgo
+ * @param[in] c_prev previous cell state, nullptr for the zero state
+ * @param[out] c cell state
+ * @param[out] h hidden state
+ * @param[in] ld_state distance between two rows of c_prev, c and h
+ * @param[in] act activation of the memory cell and cell state
+ * @param[in] recurrent_act activation of the input, forget and output gates
+ */
+void lstm_gates_forward(unsigned int batch, unsigned int unit, float *ifgo,
+                        unsigned int ld_gate, const float *c_prev, float *c,
+                        float *h, unsigned int ld_state,
+                        const RecurrentActivation &act,
+                        const RecurrentActivation &recurrent_act);
+
+/**
+ * @brief     derivative of lstm_gates_forward
+ * @param[in] batch batch size
+ * @param[in] unit number of units
+ * @param[in] ifgo activated gates saved by the forward
+ * @param[in] ld_gate distance between two rows of ifgo and d_ifgo
+ * @param[in] c_prev previous cell state, nullptr for the zero state
+ * @param[in] c cell state
+ * @param[in] dh derivative of the hidden state
+ * @param[in] dc derivative of the cell state from the next timestep
+ * @param[out] dc_prev derivative of the previous cell state, may be nullptr
+ * @param[out] d_ifgo derivative of the gate pre-activations
+ * @param[in] ld_state distance between two rows of the states
+ * @param[in] act activation of the memory cell and cell state
+ * @param[in] recurrent_act activation of the input, forget and output gates
+ */
+void lstm_gates_backward(unsigned int batch, unsigned int unit,
+                         const float *ifgo, unsigned int ld_gate,
+                         const float *c_prev, const float *c, const float *dh,
+                         const float *dc, float *dc_prev, float *d_ifgo,
+                         unsigned int ld_state, const RecurrentActivation &act,
+                         const RecurrentActivation &recurrent_act);
+
+/**
+ * @brief     one LSTM timestep: ifgo += h_prev . weight_hh, then the gates
+ * @param[in] h_prev previous hidden state, nullptr for the zero state
+ * @param[in] weight_hh recurrent weight [unit, 4 * unit]
+ * @note      see lstm_gates_forward for the other parameters
+ */
+void lstm_step_forward(unsigned int batch, unsigned int unit, float *ifgo,
+                       unsigned int ld_gate, const float *h_prev,
+                       const float *c_prev, float *h, float *c,
+                       unsigned int ld_state, const float *weight_hh,
+                       const RecurrentActivation &act,
+                       const RecurrentActivation &recurrent_act);
+
+/**
+ * @brief     derivative of lstm_step_forward. dh_prev and d_weight_hh are
+ * accumulated.
+ * @param[in] h_prev previous hidden state, nullptr for the zero state
+ * @param[in/out] dh_prev derivative of the previous hidden state, nullptr
+ * when h_prev is nullptr
+ * @param[in] weight_hh recurrent weight [unit, 4 * unit]
+ * @param[in/out] d_weight_hh gradient of weight_hh
+ * @note      see lstm_gates_backward for the other parameters
+ */
+void lstm_step_backward(unsigned int batch, unsigned int unit,
+                        const float *ifgo, float *d_ifgo, unsigned int ld_gate,
+                        const float *h_prev, float *dh_prev,
+                        const float *c_prev, const float *c, const float *dh,
+                        const float *dc, float *dc_prev, unsigned int ld_state,
+                        const float *weight_hh, float *d_weight_hh,
+                        const RecurrentActivation &act,
+                        const RecurrentActivation &recurrent_act);
+
+/**
+ * @brief     one GRU timestep. zrg holds x . weight_ih plus the biases that
+ * do not depend on the reset gate and is overwritten with the activated
+ * update, reset and candidate gates.
+ * @param[in] batch batch size
+ * @param[in] unit number of units
+ * @param[in/out] zrg gates [batch, 3 * unit]
+ * @param[in] ld_gate distance between two rows of zrg
+ * @param[in] h_prev previous hidden state, nullptr for the zero state
+ * @param[out] h hidden state
+ * @param[in] ld_state distance between two rows of h_prev and h
+ * @param[in] weight_hh recurrent weight [unit, 3 * unit]
+ * @param[in] bias_hh_g recurrent bias of the candidate, used if reset_after
+ * @param[in] reset_after apply the reset gate after the recurrent projection
+ * @param[in] act activation of the candidate
+ * @param[in] recurrent_act activation of the update and reset gates
+ * @param[in] workspace buffer of batch * unit floats
+ */
+void gru_step_forward(unsigned int batch, unsigned int unit, float *zrg,
+                      unsigned int ld_gate, const float *h_prev, float *h,
+                      unsigned int ld_state, const float *weight_hh,
+                      const float *bias_hh_g, bool reset_after,
+                      const RecurrentActivation &act,
+                      const RecurrentActivation &recurrent_act,
+                      float *workspace);
+
+/**
+ * @brief     derivative of gru_step_forward. dh_prev, d_weight_hh and
+ * d_bias_hh_g are accumulated.
+ * @param[in] zrg activated gates saved by the forward
+ * @param[out] d_zrg derivative of the gate pre-activations
+ * @param[in] h_prev previous hidden state, nullptr for the zero state
+ * @param[in] dh derivative of the hidden state
+ * @param[in/out] dh_prev derivative of the previous hidden state, nullptr
+ * when h_prev is nullptr
+ * @param[in/out] d_weight_hh gradient of weight_hh
+ * @param[in/out] d_bias_hh_g gradient of the candidate recurrent bias,
+ * nullptr if none
+ * @param[in] workspace buffer of 2 * batch * unit floats
+ * @note      see gru_step_forward for the other parameters
+ */
+void gru_step_backward(unsigned int batch, unsigned int unit, const float *zrg,
+                       float *d_zrg, unsigned int ld_gate, const float *h_prev,
+                       const float *dh, float *dh_prev, unsigned int ld_state,
+                       const float *weight_hh, const float *bias_hh_g,
+                       bool reset_after, float *d_weight_hh,
+                       float *d_bias_hh_g, const RecurrentActivation &act,
+                       const RecurrentActivation &recurrent_act,
+                       float *workspace);
+
+/**
+ * @brief     one simple RNN timestep, h = act(h + h_prev . weight_hh) where h
+ * holds the input projection
+ * @param[in] batch batch size
+ * @param[in] unit number of units
+ * @param[in] h_prev previous hidden state, nullptr for the zero state
+ * @param[in/out] h hidden state
+ * @param[in] ld_state distance between two rows of h_prev and h
+ * @param[in] weight_hh recurrent weight [unit, unit]
+ * @param[in] act activation
+ */
+void rnn_step_forward(unsigned int batch, unsigned int unit,
+                      const float *h_prev, float *h, unsigned int ld_state,
+                      const float *weight_hh, const RecurrentActivation &act);
+
+/**
+ * @brief     derivative of rnn_step_forward. dh is turned into the
+ * derivative of the pre-activation, dh_prev and d_weight_hh are accumulated.
+ * @param[in] h_prev previous hidden state, nullptr for the zero state
+ * @param[in] h hidden state
+ * @param[in/out] dh derivative of the hidden state
+ * @param[in/out] dh_prev derivative of the previous hidden state, nullptr
+ * when h_prev is nullptr
+ * @param[in/out] d_weight_hh gradient of weight_hh
+ * @note      see rnn_step_forward for the other parameters
+ */
+void rnn_step_backward(unsigned int batch, unsigned int unit,
+                       const float *h_prev, const float *h, float *dh,
+                       float *dh_prev, unsigned int ld_state,
+                       const float *weight_hh, float *d_weight_hh,
+                       const RecurrentActivation &act);
+
+} /* namespace nntrainer */
+
+#endif /* __cplusplus */
+#endif /* __RECURRENT_KERNEL_H__ */
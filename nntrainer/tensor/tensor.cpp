@@ -29,6 +29,7 @@
 #include <iomanip>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <numeric>
 #include <regex>
 #include <sstream>
@@ -36,8 +37,11 @@
 #include <stdio.h>
 
 #include <lazy_tensor.h>
+#include <nntr_threads.h>
 #include <tensor.h>
+#include <tensor_allocator.h>
 #include <util_func.h>
+#include <util_simd.h>
 
 #define transposeloop(cl, ci, cj, ck, sl, si, sj, sk)                 \
   do {                                                                \
@@ -69,33 +73,6 @@
 
 namespace nntrainer {
 
-/**
- * @struct External Loop Info for broadcasted info
- * @brief External Loop Info for broadcasted iteration. Please refer to
- * DISABLED_private_external_loop_n in unittest_nntrainer_tensor.
- * @note This should better be implemented in iterator fashion before used
- * extensively.
- */
-struct Tensor::BroadcastInfo {
-
-  /**
-   * @brief Construct a new External Loop Info object
-   *
-   */
-  BroadcastInfo() :
-    buffer_size(0),
-    buffer_axis(-1),
-    strides{0, 0, 0, 0},
-    tensor_type(nntrainer::TensorDim::TensorType()) {}
-
-  unsigned int buffer_size; /**< virtual size of the buffer */
-  int buffer_axis;          /**< the smallest axis that should be looped.
-                                 -1 means no loop needed*/
-  std::array<unsigned int, TensorDim::MAXDIM>
-    strides; /**< modified strides for the loop */
-  nntrainer::TensorDim::TensorType tensor_type;
-};
-
 Tensor::Tensor(const TensorDim &d, bool alloc_now, Tensor::Initializer init,
                std::string name_) :
   Tensor(name_, d.getFormat()) {
@@ -108,10 +85,14 @@ Tensor::Tensor(const TensorDim &d, bool alloc_now, Tensor::Initializer init,
   }
 }
 
-Tensor::Tensor(const TensorDim &d, const void *buf) : Tensor(d, true) {
+Tensor::Tensor(const TensorDim &d, const void *buf) :
+  Tensor(d, buf == nullptr) {
   if (d.getDataLen() != 0) {
-    if (buf != nullptr)
+    if (buf != nullptr) {
+      /** every element is overwritten by the copy */
+      allocate(false);
       copy(buf);
+    }
   }
 }
 
@@ -149,7 +130,263 @@ private:
   size_t off;        /**< offset from the source data ptr */
 };
 
-void Tensor::allocate() {
+namespace {
+
+/** reductions over more elements than this are split over the threads */
+constexpr size_t REDUCE_PARALLEL_MIN = 1 << 20;
+
+/** elements given to a single call of the reduction kernels */
+constexpr size_t REDUCE_KERNEL_MAX = 1 << 30;
+
+/**
+ * @brief sum of the contiguous elements or of their squares, split over the
+ * threads when there are many elements
+ *
+ * @param N number of elements
+ * @param data data
+ * @param square sum the squares if true
+ * @return float the sum
+ */
+float reduce_all(size_t N, const float *data, bool square) {
+  auto reduce = [square](size_t n, const float *x) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; i += REDUCE_KERNEL_MAX) {
+      unsigned int len = std::min(n - i, REDUCE_KERNEL_MAX);
+      sum += square ? reduce_sum_squares(len, x + i) : reduce_sum(len, x + i);
+    }
+    return sum;
+  };
+
+  unsigned int num_chunks = N >= REDUCE_PARALLEL_MIN ? NNTR_NUM_THREADS : 1;
+  if (num_chunks <= 1)
+    return reduce(N, data);
+
+  size_t chunk = (N + num_chunks - 1) / num_chunks;
+  std::vector<float> partial(num_chunks, 0.0f);
+  auto job = [&](unsigned int s, unsigned int e, unsigned int pid,
+                 void *user_data) {
+    for (unsigned int c = s; c < e; ++c) {
+      size_t begin = c * chunk;
+      if (begin < N)
+        partial[c] = reduce(std::min(chunk, N - begin), data + begin);
+    }
+  };
+
+  auto workers = ParallelBatch(job, num_chunks, nullptr);
+  if (workers.getNumWorkers() > 1)
+    workers.run();
+  else
+    job(0, num_chunks, 0, nullptr);
+
+  return reduce_sum(num_chunks, partial.data());
+}
+
+/**
+ * @brief euclidean norm of the contiguous elements. The squares are summed
+ * directly unless they may overflow or underflow, in which case the norm is
+ * accumulated with a running scale as snrm2 does
+ *
+ * @param N number of elements
+ * @param data data
+ * @return float the norm
+ */
+float l2norm_scaled(size_t N, const float *data) {
+  float sum = reduce_all(N, data, true);
+
+  /** the squares lost to underflow are below the rounding of the sum */
+  if (std::isfinite(sum) &&
+      sum >= N * (std::numeric_limits<float>::min() /
+                  std::numeric_limits<float>::epsilon()))
+    return std::sqrt(sum);
+
+  float scale = 0.0f, ssq = 1.0f;
+  for (size_t i = 0; i < N; ++i) {
+    if (data[i] == 0.0f)
+      continue;
+    float a = std::fabs(data[i]);
+    if (scale < a) {
+      float r = scale / a;
+      ssq = 1.0f + ssq * r * r;
+      scale = a;
+    } else {
+      float r = a / scale;
+      ssq += r * r;
+    }
+  }
+  return scale * std::sqrt(ssq);
+}
+
+/**
+ * @brief out = alpha * sum + beta * out where the sum is taken over the
+ * reduced axes of a contiguous row major NCHW tensor in a single pass
+ *
+ * @param data data of the tensor
+ * @param dim dimension of the tensor
+ * @param reduce true for the axes to reduce
+ * @param alpha scale of the sum
+ * @param beta scale of the output
+ * @param out output of the dimension with the reduced axes set to 1
+ */
+void reduce_axes(const float *data, const TensorDim &dim,
+                 const std::array<bool, TensorDim::MAXDIM> &reduce,
+                 float alpha, float beta, float *out) {
+  /** consecutive axes which are all reduced or all kept are merged */
+  std::vector<size_t> len;
+  std::vector<bool> reduced;
+  size_t out_len = 1;
+  for (unsigned int axis = 0; axis < TensorDim::MAXDIM; ++axis) {
+    size_t d = dim.getTensorDim(axis);
+    if (!reduce[axis])
+      out_len *= d;
+    if (d == 1)
+      continue;
+
+    if (!len.empty() && reduced.back() == reduce[axis]) {
+      len.back() *= d;
+    } else {
+      len.push_back(d);
+      reduced.push_back(reduce[axis]);
+    }
+  }
+
+  if (beta == 0.0f)
+    std::fill(out, out + out_len, 0.0f);
+  else if (beta != 1.0f)
+    sscal(out_len, beta, out, 1);
+
+  if (len.empty() || (len.size() == 1 && !reduced[0])) {
+    saxpy(out_len, alpha, data, 1, out, 1);
+    return;
+  }
+
+  if (len.size() == 1) {
+    out[0] += alpha * reduce_all(len[0], data, false);
+    return;
+  }
+
+  size_t groups = len.size();
+  size_t inner = len.back();
+  std::vector<size_t> in_stride(groups), out_stride(groups);
+  for (size_t g = groups, is = 1, os = 1; g-- > 0;) {
+    in_stride[g] = is;
+    out_stride[g] = reduced[g] ? 0 : os;
+    is *= len[g];
+    if (!reduced[g])
+      os *= len[g];
+  }
+
+  /** reduces the inner group for each index of the outer groups, where the
+   * outermost index is in [begin, end) */
+  auto job = [&](unsigned int begin, unsigned int end, unsigned int pid,
+                 void *user_data) {
+    std::vector<size_t> idx(groups - 1, 0);
+    idx[0] = begin;
+    while (idx[0] < end) {
+      size_t in_off = 0, out_off = 0;
+      for (size_t g = 0; g < groups - 1; ++g) {
+        in_off += idx[g] * in_stride[g];
+        out_off += idx[g] * out_stride[g];
+      }
+
+      if (reduced.back())
+        out[out_off] += alpha * reduce_sum(inner, data + in_off);
+      else
+        saxpy(inner, alpha, data + in_off, 1, out + out_off, 1);
+
+      for (size_t g = groups - 1; g-- > 0;) {
+        if (++idx[g] < len[g] || g == 0)
+          break;
+        idx[g] = 0;
+      }
+    }
+  };
+
+  /** the outermost group is split over the threads when it is kept, so that
+   * the threads write disjoint outputs */
+  if (!reduced[0] && dim.getDataLen() >= REDUCE_PARALLEL_MIN) {
+    auto workers = ParallelBatch(job, len[0], nullptr);
+    if (workers.getNumWorkers() > 1) {
+      workers.run();
+      return;
+    }
+  }
+
+  job(0, len[0], 0, nullptr);
+}
+
+/** element-wise operations over more elements than this are split over the
+ * threads */
+constexpr size_t ELEMENTWISE_PARALLEL_MIN = 1 << 18;
+
+/** elements in a cache line. chunks of the threads start on a cache line so
+ * that two threads never write to the same line */
+constexpr size_t CACHE_LINE_ELEMENTS = 64 / sizeof(float);
+
+/**
+ * @brief run fn(begin, end) over [0, N), split into cache line aligned chunks
+ * over the threads when there are many elements
+ *
+ * @param N number of elements
+ * @param fn function computing the elements in [begin, end)
+ */
+template <typename Fn> void parallel_for(size_t N, Fn &&fn) {
+  unsigned int num_chunks =
+    N >= ELEMENTWISE_PARALLEL_MIN ? NNTR_NUM_THREADS : 1;
+  if (num_chunks <= 1) {
+    fn(size_t(0), N);
+    return;
+  }
+
+  size_t chunk = (N + num_chunks - 1) / num_chunks;
+  chunk = (chunk + CACHE_LINE_ELEMENTS - 1) / CACHE_LINE_ELEMENTS *
+          CACHE_LINE_ELEMENTS;
+  auto job = [&](unsigned int s, unsigned int e, unsigned int pid,
+                 void *user_data) {
+    for (unsigned int c = s; c < e; ++c) {
+      size_t begin = c * chunk;
+      if (begin < N)
+        fn(begin, std::min(N, begin + chunk));
+    }
+  };
+
+  auto workers = ParallelBatch(job, num_chunks, nullptr);
+  if (workers.getNumWorkers() > 1)
+    workers.run();
+  else
+    job(0, num_chunks, 0, nullptr);
+}
+
+/**
+ * @brief out = op(in) element by element over contiguous FP32 tensors, split
+ * over the threads when they are large
+ *
+ * @param in input tensor
+ * @param[out] out output tensor, created if empty
+ * @param op functor computing float from float
+ * @return true if computed, false if the tensors need the generic path
+ */
+template <typename Op>
+bool transform_contiguous(const Tensor &in, Tensor &out, Op op) {
+  if (in.getDataType() != ml::train::TensorDim::DataType::FP32 ||
+      !in.getContiguous())
+    return false;
+
+  CREATE_UNINITIALIZED_IF_EMPTY_DIMS(out, in.getDim());
+  if (!out.getContiguous() || out.getDim() != in.getDim())
+    return false;
+
+  const float *data = in.getData<float>();
+  float *rdata = out.getData<float>();
+  parallel_for(in.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i)
+      rdata[i] = op(data[i]);
+  });
+  return true;
+}
+
+} // namespace
+
+void Tensor::allocate(bool zero_fill) {
   if (empty() || data)
     /// already allocated
     return;
@@ -160,41 +397,24 @@ void Tensor::allocate() {
     offset = src_tensor->tensor()->offset + src_tensor->offset();
     /** as this memory is shared, do NOT initialize */
   } else {
-    /// allocate new memory for the tensor data
-
-    MemoryData *mem_data;
+    /// allocate new memory for the tensor data from the pooled allocator
+    size_t bytes = 0;
 
     if (getDataType() == ml::train::TensorDim::DataType::FP32) {
-      mem_data = new MemoryData((void *)(new float[dim.getDataLen()]{}));
-      data = std::shared_ptr<MemoryData>(mem_data, [](auto *mem_data) {
-        delete[] mem_data->template getAddr<float>();
-        delete mem_data;
-      });
-
+      bytes = dim.getDataLen() * sizeof(float);
     } else if (getDataType() == ml::train::TensorDim::DataType::FP16) {
 #ifdef ENABLE_FP16
-      mem_data = new MemoryData((void *)(new _FP16[dim.getDataLen()]{}));
-      data = std::shared_ptr<MemoryData>(mem_data, [](auto *mem_data) {
-        delete[] mem_data->template getAddr<_FP16>();
-        delete mem_data;
-      });
+      bytes = dim.getDataLen() * sizeof(_FP16);
 #else
       throw std::invalid_argument("Error: enable-fp16 is not enabled");
 #endif
     } else if (getDataType() == ml::train::TensorDim::DataType::QINT8) {
-      mem_data = new MemoryData((void *)(new uint8_t[dim.getDataLen()]{}));
-      data = std::shared_ptr<MemoryData>(mem_data, [](auto *mem_data) {
-        delete[] mem_data->template getAddr<uint8_t>();
-        delete mem_data;
-      });
+      bytes = dim.getDataLen() * sizeof(uint8_t);
     } else if (getDataType() == ml::train::TensorDim::DataType::QINT4) {
-      mem_data =
-        new MemoryData((void *)(new uint8_t[(dim.getDataLen() + 1) / 2]{}));
-      data = std::shared_ptr<MemoryData>(mem_data, [](auto *mem_data) {
-        delete[] mem_data->template getAddr<uint8_t>();
-        delete mem_data;
-      });
+      bytes = (dim.getDataLen() + 1) / 2;
     }
+
+    data = TensorAllocator::Global().allocate(bytes, zero_fill);
     offset = 0;
     initialize();
   }
@@ -751,9 +971,9 @@ int Tensor::multiply_i(float const &value) {
   /// version for multiply_i
   if (dim.getDataType() == ml::train::TensorDim::DataType::FP32) {
     float *data = getData<float>();
-    unsigned int len = size();
-
-    sscal(len, value, data, 1);
+    parallel_for(size(), [&](size_t begin, size_t end) {
+      sscal(end - begin, value, data + begin, 1);
+    });
   } else if (dim.getDataType() == ml::train::TensorDim::DataType::FP16) {
 #ifdef ENABLE_FP16
     _FP16 *data = getData<_FP16>();
@@ -774,6 +994,10 @@ Tensor Tensor::multiply(float const &value) const {
 Tensor &Tensor::multiply(float const &value, Tensor &out) const {
   /// @todo add unittest
   if (dim.getDataType() == ml::train::TensorDim::DataType::FP32) {
+    if (transform_contiguous(*this, out,
+                             [value](float x) { return x * value; }))
+      return out;
+
     auto f = std::bind(std::multiplies<float>(), std::placeholders::_1, value);
     apply<float>(f, out);
     return out;
@@ -830,6 +1054,9 @@ Tensor &Tensor::multiply(Tensor const &m, Tensor &output,
       ele_mul(e.buffer_size, buf, m_buf, out_buf, 1, beta, e.strides[3],
               strides[3]);
     };
+    /** the output is read when beta is given */
+    if (beta != 0.0f)
+      CREATE_IF_EMPTY_DIMS(output, dim);
     apply_broadcast(m, f, output);
 
   } else if (dim.getDataType() == ml::train::TensorDim::DataType::FP16) {
@@ -870,6 +1097,10 @@ Tensor &Tensor::divide(float const &value, Tensor &out) const {
   }
 
   if (dim.getDataType() == ml::train::TensorDim::DataType::FP32) {
+    if (transform_contiguous(*this, out,
+                             [value](float x) { return x / value; }))
+      return out;
+
     auto f = std::bind(std::divides<float>(), std::placeholders::_1, value);
     apply<float>(f, out);
     return out;
@@ -942,6 +1173,10 @@ Tensor Tensor::add(float const &value) const {
 Tensor &Tensor::add(float const &value, Tensor &out) const {
   /// @todo add unittest
   if (dim.getDataType() == ml::train::TensorDim::DataType::FP32) {
+    if (transform_contiguous(*this, out,
+                             [value](float x) { return x + value; }))
+      return out;
+
     auto f = std::bind(std::plus<float>(), std::placeholders::_1, value);
     apply<float>(f, out);
     return out;
@@ -1611,8 +1846,8 @@ void Tensor::apply_broadcast(
   std::function<void(const BroadcastInfo &e, const float *, const float *,
                      float *)>
     v_func,
-  Tensor &output) const {
-  CREATE_IF_EMPTY_DIMS(output, dim);
+  Tensor &output, bool threaded) const {
+  CREATE_UNINITIALIZED_IF_EMPTY_DIMS(output, dim);
 
   NNTR_THROW_IF(getData() == nullptr, std::invalid_argument)
     << getName() << " is not allocated";
@@ -1624,7 +1859,7 @@ void Tensor::apply_broadcast(
   /// shortcut to cover when dimension matches
   /// note that buffer_size, the last stride is only used in v_func but it
   /// might be changed
-  if (dim == m.dim) {
+  if (dim == m.dim && !threaded) {
     BroadcastInfo e;
     e.buffer_size = size();
     e.strides[3] = 1;
@@ -1633,7 +1868,63 @@ void Tensor::apply_broadcast(
     return;
   }
 
-  return apply_broadcast_util(m, v_func, output, this->computeBroadcastInfo(m));
+  if (dim == m.dim) {
+    const float *buf = getData();
+    const float *m_buf = m.getData();
+    float *out_buf = output.getData();
+    parallel_for(size(), [&](size_t begin, size_t end) {
+      BroadcastInfo e;
+      e.buffer_size = end - begin;
+      e.strides[3] = 1;
+      e.tensor_type = getTensorType();
+      v_func(e, buf + begin, m_buf + begin, out_buf + begin);
+    });
+    return;
+  }
+
+  BroadcastInfo e = this->computeBroadcastInfo(m);
+  if (!threaded || size() < ELEMENTWISE_PARALLEL_MIN)
+    return apply_broadcast_util(m, v_func, output, e);
+
+  /**
+   * large tensors are walked as size() / e.buffer_size runs of e.buffer_size
+   * elements. the threads are given chunks of the runs, which may start or
+   * end in the middle of a run, and the offsets of a run are decoded from its
+   * index over the looped axes
+   */
+  uint continuity[4] = {0, 1, 2, 3};
+  if (getFormat() == Tformat::NHWC) {
+    continuity[1] = 2;
+    continuity[2] = 3;
+    continuity[3] = 1;
+  }
+
+  const float *buf = getData();
+  const float *m_buf = m.getData();
+  float *out_buf = output.getData();
+  size_t run_len = e.buffer_size;
+  parallel_for(size(), [&](size_t begin, size_t end) {
+    BroadcastInfo sub = e;
+    for (size_t pos = begin; pos < end;) {
+      size_t run = pos / run_len;
+      size_t in_run = pos % run_len;
+
+      size_t offset = 0, m_offset = 0;
+      for (int axis = e.buffer_axis; axis >= 0; --axis) {
+        size_t axis_len = dim.getTensorDim(continuity[axis]);
+        size_t i = run % axis_len;
+        run /= axis_len;
+        offset += i * strides[axis];
+        m_offset += i * e.strides[axis];
+      }
+      offset += in_run * strides[3];
+      m_offset += in_run * e.strides[3];
+
+      sub.buffer_size = std::min(run_len - in_run, end - pos);
+      v_func(sub, buf + offset, m_buf + m_offset, out_buf + offset);
+      pos += sub.buffer_size;
+    }
+  });
 }
 
 #ifdef ENABLE_FP16
@@ -1642,7 +1933,7 @@ void Tensor::apply_broadcast(
   std::function<void(const BroadcastInfo &e, const _FP16 *, const _FP16 *,
                      _FP16 *)>
     v_func,
-  Tensor &output) const {
+  Tensor &output, bool threaded) const {
   CREATE_IF_EMPTY_DIMS(output, dim, nullptr);
 
   NNTR_THROW_IF(getData<_FP16>() == nullptr, std::invalid_argument)
@@ -1735,19 +2026,15 @@ Tensor Tensor::sum_by_batch() const {
     << getName() << " is not contiguous, cannot sum";
 
   Tensor ret(dim.batch(), 1, 1, 1, this->getFormat(), getDataType());
-  size_t feat_len = dim.getFeatureLen();
-  size_t batch = dim.batch();
 
   if (getDataType() == ml::train::TensorDim::DataType::FP32) {
-    const float *data = getData();
-    float *rdata = ret.getData();
-
-    Tensor ones(1, 1, 1, feat_len, this->getFormat());
-    ones.setValue(1.0);
-    sgemv(CblasRowMajor, CblasNoTrans, batch, feat_len, 1, data, feat_len,
-          ones.getData<float>(), 1, 0.0, rdata, 1);
+    /** the features of a batch are contiguous in either format */
+    reduce_axes(getData<float>(), dim, {false, true, true, true}, 1.0f, 0.0f,
+                ret.getData<float>());
   } else if (getDataType() == ml::train::TensorDim::DataType::FP16) {
 #ifdef ENABLE_FP16
+    size_t feat_len = dim.getFeatureLen();
+    size_t batch = dim.batch();
     const _FP16 *data = getData<_FP16>();
     _FP16 *rdata = ret.getData<_FP16>();
 
@@ -1789,6 +2076,18 @@ Tensor &Tensor::sum(unsigned int axis, Tensor &ret, float alpha,
       return ret;
     }
 
+    if (getFormat() == Tformat::NCHW &&
+        dim.getStorageOrder() == TStorageOrder::ROW_MAJOR) {
+      TensorDim ret_dim = dim;
+      ret_dim.setTensorDim(axis, 1);
+      CREATE_IF_EMPTY_DIMS(ret, ret_dim);
+
+      std::array<bool, TensorDim::MAXDIM> reduce = {false, false, false, false};
+      reduce[axis] = true;
+      reduce_axes(data, dim, reduce, alpha, beta, ret.getData<float>());
+      return ret;
+    }
+
     switch (axis) {
     case 0: {
       CREATE_IF_EMPTY_DIMS(ret, 1, dim.channel(), dim.height(), dim.width(),
@@ -2041,6 +2340,25 @@ Tensor &Tensor::sum(const std::vector<unsigned int> &axes, Tensor &output,
   if (axes.empty())
     throw std::invalid_argument("empty axes given");
 
+  if (getDataType() == ml::train::TensorDim::DataType::FP32 && contiguous &&
+      getFormat() == Tformat::NCHW &&
+      dim.getStorageOrder() == TStorageOrder::ROW_MAJOR) {
+    /** all the axes are reduced in a single pass */
+    std::array<bool, TensorDim::MAXDIM> reduce = {false, false, false, false};
+    TensorDim ret_dim = dim;
+    for (auto axis : axes) {
+      if (axis >= TensorDim::MAXDIM)
+        throw std::out_of_range("Error: axis is invalid");
+      reduce[axis] = true;
+      ret_dim.setTensorDim(axis, 1);
+    }
+
+    CREATE_IF_EMPTY_DIMS(output, ret_dim);
+    reduce_axes(getData<float>(), dim, reduce, alpha, 0.0f,
+                output.getData<float>());
+    return output;
+  }
+
   if (axes.size() == 1) {
     this->sum(axes[0], output, alpha);
   } else {
@@ -2488,12 +2806,14 @@ void Tensor::dropout_mask(float dropout) {
   if (dim.getDataType() == ml::train::TensorDim::DataType::FP32) {
     float scale = 1.0 / (1 - dropout);
     float *data_ = getData();
-    for (unsigned int i = 0; i < size(); ++i) {
-      if (data_[i] >= dropout)
-        data_[i] = scale;
-      else
-        data_[i] = 0.0;
-    }
+    parallel_for(size(), [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        if (data_[i] >= dropout)
+          data_[i] = scale;
+        else
+          data_[i] = 0.0;
+      }
+    });
   } else if (getDataType() == ml::train::TensorDim::DataType::FP16) {
 #ifdef ENABLE_FP16
     _FP16 scale = static_cast<_FP16>(1.0 / (1 - dropout));
@@ -2917,7 +3237,11 @@ void Tensor::copy(const void *buf) {
   }
 
   if (getDataType() == ml::train::TensorDim::DataType::FP32) {
-    scopy(size(), (float *)buf, 1, getData<float>(), 1);
+    const float *from = static_cast<const float *>(buf);
+    float *data = getData<float>();
+    parallel_for(size(), [&](size_t begin, size_t end) {
+      scopy(end - begin, from + begin, 1, data + begin, 1);
+    });
   } else if (getDataType() == ml::train::TensorDim::DataType::FP16) {
 #ifdef ENABLE_FP16
     scopy(size(), (_FP16 *)buf, 1, getData<_FP16>(), 1);
@@ -3330,9 +3654,12 @@ void Tensor::setValue(float val) {
 
 void Tensor::setZero() {
   if (dim.getDataType() == ml::train::TensorDim::DataType::FP32) {
-    if (contiguous)
-      sscal(size(), 0, getData<float>(), 1);
-    else
+    if (contiguous) {
+      float *data = getData<float>();
+      parallel_for(size(), [&](size_t begin, size_t end) {
+        sscal(end - begin, 0, data + begin, 1);
+      });
+    } else
       apply_i<float>([](float val) -> float { return 0; });
   } else if (dim.getDataType() == ml::train::TensorDim::DataType::FP16) {
 #ifdef ENABLE_FP16
@@ -3474,8 +3801,7 @@ float Tensor::l2norm() const {
   float ret = 0;
   unsigned int len = size();
   if (getDataType() == ml::train::TensorDim::DataType::FP32) {
-    const float *data = getData<float>();
-    ret = snrm2(len, data, 1);
+    ret = l2norm_scaled(len, getData<float>());
   } else if (getDataType() == ml::train::TensorDim::DataType::FP16) {
 #ifdef ENABLE_FP16
     const _FP16 *data = getData<_FP16>();
@@ -3513,8 +3839,7 @@ float Tensor::max_abs() const {
 }
 
 Tensor &Tensor::normalization(Tensor &output) const {
-  if (output.empty())
-    output = Tensor(dim);
+  CREATE_UNINITIALIZED_IF_EMPTY_DIMS(output, dim);
 
   output.copy(*this);
   output.normalization_i();
@@ -3564,8 +3889,7 @@ void Tensor::normalization_i() {
 LazyTensor Tensor::chain() const { return LazyTensor(*this); }
 
 Tensor &Tensor::standardization(Tensor &output) const {
-  if (output.empty())
-    output = Tensor(dim);
+  CREATE_UNINITIALIZED_IF_EMPTY_DIMS(output, dim);
 
   output.copy(*this);
   output.standardization_i();
@@ -55,6 +55,18 @@
       tensor = Tensor(__VA_ARGS__);       \
   } while (0);
 
+/**
+ * @brief create the tensor without zero filling its memory, for outputs of
+ * which every element is written by the operation
+ */
+#define CREATE_UNINITIALIZED_IF_EMPTY_DIMS(tensor, dim) \
+  do {                                                  \
+    if (tensor.empty()) {                               \
+      tensor = Tensor(dim, false);                      \
+      tensor.allocate(false);                           \
+    }                                                   \
+  } while (0);
+
 namespace nntrainer {
 
 using TensorDim = ml::train::TensorDim;
@@ -511,8 +523,10 @@ public:
 
   /**
    * @brief    Allocate memory for this tensor
+   * @param[in] zero_fill fill the memory with zeros, false if every element
+   * is written by the caller
    */
-  void allocate();
+  void allocate(bool zero_fill = true);
 
   /**
    * @brief    Deallocate memory for this tensor
@@ -1344,34 +1358,37 @@ public:
   };
 
   /**
-   * @brief     Apply function element by element
-   * @param[in] *function function pointer applied
-   * @param[out] output output tensor
+   * @brief     Apply the functor element by element. The functor is not type
+   * erased, so it is inlined into the loop which the compiler can vectorize
+   * @param[in] op functor computing T from T
+   * @param[out] output output tensor, created if empty
    * @retval    Tensor
    */
-  template <typename T = float>
-  Tensor &apply(std::function<T(T)> f, Tensor &output) const {
-    CREATE_IF_EMPTY_DIMS(output, dim, nullptr);
+  template <typename T = float, typename Op>
+  Tensor &transform(Op op, Tensor &output) const {
+    CREATE_UNINITIALIZED_IF_EMPTY_DIMS(output, dim);
 
     if (dim != output.dim) {
       /// @todo add unittest
       throw std::invalid_argument(
-        "[Tensor::apply] output dimension does not match");
+        "[Tensor::transform] output dimension does not match");
     }
 
     if (contiguous && output.contiguous) {
-      const T *data = (getData<T>());
-      T *rdata = (output.getData<T>());
+      const T *data = getData<T>();
+      T *rdata = output.getData<T>();
+      size_t len = size();
 
-      std::transform(data, data + size(), rdata, f);
+      for (size_t i = 0; i < len; ++i)
+        rdata[i] = op(data[i]);
     } else if (strides[3] == 1 && output.strides[3] == 1) {
-      /** @todo optimize this with combining these loops where stride is 1 */
       for (unsigned int b = 0; b < batch(); ++b) {
         for (unsigned int c = 0; c < channel(); ++c) {
           for (unsigned int h = 0; h < height(); ++h) {
             T *out_data = output.getAddress<T>(b, c, h, 0);
             const T *in_data = getAddress<T>(b, c, h, 0);
-            std::transform(in_data, in_data + width(), out_data, f);
+            for (unsigned int w = 0; w < width(); ++w)
+              out_data[w] = op(in_data[w]);
           }
         }
       }
@@ -1380,7 +1397,7 @@ public:
         for (unsigned int c = 0; c < channel(); ++c) {
           for (unsigned int h = 0; h < height(); ++h) {
             for (unsigned int w = 0; w < width(); ++w) {
-              output.setValue(b, c, h, w, f(getValue<T>(b, c, h, w)));
+              output.setValue(b, c, h, w, op(getValue<T>(b, c, h, w)));
             }
           }
         }
@@ -1388,6 +1405,53 @@ public:
     }
 
     return output;
+  }
+
+  /**
+   * @brief     Apply the binary functor element by element, output =
+   * op(this, m) where m is broadcast to this. The functor is inlined into
+   * each contiguous run found by the broadcast iteration. Like apply(), op is
+   * called on the calling thread only, so it may keep a state
+   * @param[in] op functor computing T from (T, T)
+   * @param[in] m second operand
+   * @param[out] output output tensor, created if empty
+   * @retval    Tensor
+   */
+  template <typename T = float, typename Op>
+  Tensor &transform(Op op, Tensor const &m, Tensor &output) const {
+    unsigned int o_stride = strides[3];
+    auto f = [op, o_stride](const BroadcastInfo &e, const T *buf,
+                            const T *m_buf, T *out_buf) {
+      unsigned int len = e.buffer_size;
+      unsigned int m_stride = e.strides[3];
+      if (o_stride == 1 && m_stride == 1) {
+        for (unsigned int i = 0; i < len; ++i)
+          out_buf[i] = op(buf[i], m_buf[i]);
+      } else if (o_stride == 1 && m_stride == 0) {
+        T m_val = m_buf[0];
+        for (unsigned int i = 0; i < len; ++i)
+          out_buf[i] = op(buf[i], m_val);
+      } else {
+        for (unsigned int i = 0; i < len; ++i)
+          out_buf[i * o_stride] = op(buf[i * o_stride], m_buf[i * m_stride]);
+      }
+    };
+    apply_broadcast(m, f, output, false);
+
+    return output;
+  }
+
+  /**
+   * @brief     Apply function element by element
+   * @param[in] *function function pointer applied
+   * @param[out] output output tensor
+   * @retval    Tensor
+   * @note      the function is called through std::function for every
+   * element, prefer transform() on hot paths
+   */
+  template <typename T = float>
+  Tensor &apply(std::function<T(T)> f, Tensor &output) const {
+    return transform<T>(f, output);
   };
 
   /**
@@ -1904,6 +1968,13 @@ public:
   const std::array<size_t, TensorDim::MAXDIM> getStrides() const noexcept {
     return strides;
   }
+
+  /**
+   * @brief     Get if the data of the tensor is contiguous in memory
+   * @retval    true if contiguous
+   */
+  bool getContiguous() const noexcept { return contiguous; }
+
   /**
    * @brief Get linear index given the n-d index
    */
@@ -2071,7 +2142,32 @@ private:
    */
   std::shared_ptr<SrcSharedTensor> src_tensor;
 
-  struct BroadcastInfo;
+  /**
+   * @struct External Loop Info for broadcasted info
+   * @brief External Loop Info for broadcasted iteration. Please refer to
+   * DISABLED_private_external_loop_n in unittest_nntrainer_tensor.
+   * @note This should better be implemented in iterator fashion before used
+   * extensively.
+   */
+  struct BroadcastInfo {
+
+    /**
+     * @brief Construct a new External Loop Info object
+     *
+     */
+    BroadcastInfo() :
+      buffer_size(0),
+      buffer_axis(-1),
+      strides{0, 0, 0, 0},
+      tensor_type(nntrainer::TensorDim::TensorType()) {}
+
+    unsigned int buffer_size; /**< virtual size of the buffer */
+    int buffer_axis;          /**< the smallest axis that should be looped.
+                                   -1 means no loop needed*/
+    std::array<unsigned int, TensorDim::MAXDIM>
+      strides; /**< modified strides for the loop */
+    nntrainer::TensorDim::TensorType tensor_type;
+  };
 
   /**
    * @brief Applies the given operator to the tensor with the passed argument
@@ -2098,6 +2194,8 @@ private:
    *
    * @param[in] m Tensor
    * @param[in] v_func vectorized function to apply
+   * @param[in] threaded split large tensors over the threads, false if
+   * v_func may not be called concurrently
    * @retval #ML_ERROR_NONE Successful
    * @retval #ML_ERROR_INVALID_PARAMETER Invalid Parameter
    */
@@ -2105,7 +2203,7 @@ private:
                        std::function<void(const BroadcastInfo &e, const float *,
                                           const float *, float *)>
                          v_func,
-                       Tensor &output) const;
+                       Tensor &output, bool threaded = true) const;
 #ifdef ENABLE_FP16
   /**
    * @brief Applies the given operator to the tensor with the passed argument
@@ -2131,6 +2229,8 @@ private:
    *
    * @param[in] m Tensor
    * @param[in] v_func vectorized function to apply
+   * @param[in] threaded split large tensors over the threads, false if
+   * v_func may not be called concurrently
    * @retval #ML_ERROR_NONE Successful
    * @retval #ML_ERROR_INVALID_PARAMETER Invalid Parameter
    */
@@ -2138,7 +2238,7 @@ private:
                        std::function<void(const BroadcastInfo &e, const _FP16 *,
                                           const _FP16 *, _FP16 *)>
                          v_func,
-                       Tensor &output) const;
+                       Tensor &output, bool threaded = true) const;
 #endif
   /**
    * @brief compute Loop info for broadcasting and vectorization
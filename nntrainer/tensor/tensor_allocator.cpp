@@ -0,0 +1,294 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   tensor_allocator.cpp
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Pooled allocator for the memory of standalone tensors
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <tensor_allocator.h>
+
+namespace nntrainer {
+
+namespace {
+
+/**
+ * size classes are 64 bytes and then four classes between two powers of two,
+ * 2^k + q * 2^(k - 2) for q = 1..4, so that at most a quarter is wasted
+ */
+constexpr unsigned int MIN_SHIFT = 6;
+constexpr unsigned int NUM_SUB_CLASSES = 4;
+constexpr unsigned int MAX_SHIFT = 26;
+constexpr unsigned int NUM_CLASSES =
+  (MAX_SHIFT - MIN_SHIFT) * NUM_SUB_CLASSES + 1;
+constexpr unsigned int UNPOOLED = NUM_CLASSES;
+
+constexpr size_t MAX_THREAD_CACHE_BLOCKS = 16; /**< blocks per size class */
+constexpr size_t MAX_THREAD_CACHE_BYTES = 32 << 20;
+constexpr size_t MAX_SHARED_CACHE_BYTES = 128 << 20;
+
+static_assert(size_t(1) << MAX_SHIFT == TensorAllocator::MAX_POOLED_BYTES,
+              "the last size class must be MAX_POOLED_BYTES");
+
+/**
+ * @brief get the size class of the request
+ *
+ * @param bytes bytes requested
+ * @param[out] class_bytes bytes of the size class
+ * @return unsigned int index of the size class, UNPOOLED if too large
+ */
+unsigned int getSizeClass(size_t bytes, size_t &class_bytes) {
+  if (bytes <= (size_t(1) << MIN_SHIFT)) {
+    class_bytes = size_t(1) << MIN_SHIFT;
+    return 0;
+  }
+
+  if (bytes > TensorAllocator::MAX_POOLED_BYTES) {
+    class_bytes = (bytes + TensorAllocator::ALIGNMENT - 1) /
+                  TensorAllocator::ALIGNMENT * TensorAllocator::ALIGNMENT;
+    return UNPOOLED;
+  }
+
+  /** 2^k < bytes <= 2^(k + 1) */
+  unsigned int k = 0;
+  for (size_t v = bytes - 1; v >>= 1;)
+    ++k;
+
+  size_t step = size_t(1) << (k - 2);
+  size_t q = (bytes - (size_t(1) << k) + step - 1) / step;
+  class_bytes = (size_t(1) << k) + q * step;
+  return (k - MIN_SHIFT) * NUM_SUB_CLASSES + q;
+}
+
+/**
+ * @brief get the bytes of the size class
+ *
+ * @param size_class index of the size class
+ * @return size_t bytes of the size class
+ */
+size_t getClassBytes(unsigned int size_class) {
+  if (size_class == 0)
+    return size_t(1) << MIN_SHIFT;
+
+  unsigned int k = (size_class - 1) / NUM_SUB_CLASSES + MIN_SHIFT;
+  size_t q = (size_class - 1) % NUM_SUB_CLASSES + 1;
+  return (size_t(1) << k) + q * (size_t(1) << (k - 2));
+}
+
+/**
+ * @brief allocate aligned memory from the system
+ */
+void *alignedAlloc(size_t bytes) {
+  void *ptr = nullptr;
+#ifdef _WIN32
+  ptr = _aligned_malloc(bytes, TensorAllocator::ALIGNMENT);
+#else
+  if (posix_memalign(&ptr, TensorAllocator::ALIGNMENT, bytes) != 0)
+    ptr = nullptr;
+#endif
+  if (ptr == nullptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+/**
+ * @brief free memory of alignedAlloc()
+ */
+void alignedFree(void *ptr) {
+#ifdef _WIN32
+  _aligned_free(ptr);
+#else
+  free(ptr);
+#endif
+}
+
+/** true once the cache of the thread is destroyed at the thread exit */
+thread_local bool thread_cache_destroyed = false;
+
+} // namespace
+
+/**
+ * @brief blocks freed by a thread, reused by its next allocations without
+ * locking
+ */
+struct ThreadCache {
+  /**
+   * @brief Construct a new Thread Cache object
+   */
+  ThreadCache() : blocks(NUM_CLASSES), bytes(0) {}
+
+  /**
+   * @brief Destroy the Thread Cache object, the blocks go to the shared cache
+   */
+  ~ThreadCache() {
+    thread_cache_destroyed = true;
+    auto &allocator = TensorAllocator::Global();
+    for (unsigned int idx = 0; idx < NUM_CLASSES; ++idx) {
+      for (void *ptr : blocks[idx])
+        allocator.put(ptr, idx, getClassBytes(idx));
+    }
+  }
+
+  /**
+   * @brief Get the cache of the calling thread
+   */
+  static ThreadCache &get() {
+    thread_local ThreadCache cache;
+    return cache;
+  }
+
+  std::vector<std::vector<void *>> blocks; /**< blocks per size class */
+  size_t bytes;                            /**< bytes held */
+};
+
+/**
+ * @class   PooledMemoryData
+ * @brief   memory of a standalone tensor, returned to the allocator when
+ * released
+ */
+class PooledMemoryData : public MemoryData {
+public:
+  /**
+   * @brief Construct a new Pooled Memory Data object
+   *
+   * @param addr memory
+   * @param size_class_ index of the size class
+   * @param bytes_ bytes of the size class
+   */
+  PooledMemoryData(void *addr, unsigned int size_class_, size_t bytes_) :
+    MemoryData(addr), size_class(size_class_), bytes(bytes_) {}
+
+  /**
+   * @brief Destroy the Pooled Memory Data object
+   */
+  ~PooledMemoryData() {
+    if (size_class == UNPOOLED)
+      alignedFree(getAddr<void>());
+    else
+      TensorAllocator::Global().put(getAddr<void>(), size_class, bytes);
+  }
+
+private:
+  unsigned int size_class; /**< index of the size class */
+  size_t bytes;            /**< bytes of the size class */
+};
+
+TensorAllocator::TensorAllocator() : shared_cache(NUM_CLASSES) {}
+
+TensorAllocator &TensorAllocator::Global() {
+  /** never destroyed as tensors may be released during the static destruction
+   */
+  static TensorAllocator *allocator = new TensorAllocator();
+  return *allocator;
+}
+
+size_t TensorAllocator::getAllocationSize(size_t bytes) {
+  size_t class_bytes;
+  getSizeClass(bytes, class_bytes);
+  return class_bytes;
+}
+
+std::shared_ptr<MemoryData> TensorAllocator::allocate(size_t bytes,
+                                                      bool zero_fill) {
+  num_allocations.fetch_add(1, std::memory_order_relaxed);
+  num_bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+  size_t class_bytes;
+  unsigned int size_class = getSizeClass(bytes, class_bytes);
+  void *ptr = get(size_class, class_bytes);
+  if (zero_fill)
+    std::memset(ptr, 0, bytes);
+
+  return std::make_shared<PooledMemoryData>(ptr, size_class, class_bytes);
+}
+
+void *TensorAllocator::get(unsigned int size_class, size_t bytes) {
+  if (size_class != UNPOOLED) {
+    if (!thread_cache_destroyed) {
+      auto &cache = ThreadCache::get();
+      auto &blocks = cache.blocks[size_class];
+      if (!blocks.empty()) {
+        void *ptr = blocks.back();
+        blocks.pop_back();
+        cache.bytes -= bytes;
+        return ptr;
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &shared = shared_cache[size_class];
+    if (!shared.empty()) {
+      void *ptr = shared.back();
+      shared.pop_back();
+      shared_bytes -= bytes;
+      return ptr;
+    }
+  }
+
+  num_system_allocations.fetch_add(1, std::memory_order_relaxed);
+  return alignedAlloc(bytes);
+}
+
+void TensorAllocator::put(void *ptr, unsigned int size_class, size_t bytes) {
+  if (!thread_cache_destroyed) {
+    auto &cache = ThreadCache::get();
+    auto &blocks = cache.blocks[size_class];
+    if (blocks.size() < MAX_THREAD_CACHE_BLOCKS &&
+        cache.bytes + bytes <= MAX_THREAD_CACHE_BYTES) {
+      blocks.push_back(ptr);
+      cache.bytes += bytes;
+      return;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (shared_bytes + bytes <= MAX_SHARED_CACHE_BYTES) {
+      shared_cache[size_class].push_back(ptr);
+      shared_bytes += bytes;
+      return;
+    }
+  }
+
+  alignedFree(ptr);
+}
+
+TensorAllocator::Stats TensorAllocator::getStats() const {
+  return {num_allocations.load(std::memory_order_relaxed),
+          num_system_allocations.load(std::memory_order_relaxed),
+          num_bytes.load(std::memory_order_relaxed)};
+}
+
+void TensorAllocator::resetStats() {
+  num_allocations = 0;
+  num_system_allocations = 0;
+  num_bytes = 0;
+}
+
+void TensorAllocator::release() {
+  if (!thread_cache_destroyed) {
+    auto &cache = ThreadCache::get();
+    for (auto &blocks : cache.blocks) {
+      for (void *ptr : blocks)
+        alignedFree(ptr);
+      blocks.clear();
+    }
+    cache.bytes = 0;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto &blocks : shared_cache) {
+    for (void *ptr : blocks)
+      alignedFree(ptr);
+    blocks.clear();
+  }
+  shared_bytes = 0;
+}
+
+} // namespace nntrainer
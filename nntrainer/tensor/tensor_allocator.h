@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   tensor_allocator.h
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Pooled allocator for the memory of standalone tensors
+ *
+ * Standalone tensors, which are not planned by the TensorPool, are mostly
+ * short lived temporaries created again every iteration. Their memory is
+ * rounded up to a size class and, once freed, kept in a per thread cache of
+ * that class so that the next request of a similar size reuses it without
+ * going to the system allocator.
+ */
+
+#ifndef __TENSOR_ALLOCATOR_H__
+#define __TENSOR_ALLOCATOR_H__
+#ifdef __cplusplus
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <memory_data.h>
+
+namespace nntrainer {
+
+/**
+ * @class   TensorAllocator
+ * @brief   size class pooled allocator of 64 byte aligned tensor memory
+ */
+class TensorAllocator {
+public:
+  static constexpr size_t ALIGNMENT = 64; /**< alignment of the memory */
+  static constexpr size_t MAX_POOLED_BYTES =
+    64 << 20; /**< larger requests are not pooled */
+
+  /**
+   * @brief allocation counters, reset by resetStats()
+   */
+  struct Stats {
+    size_t allocations;        /**< number of requested allocations */
+    size_t system_allocations; /**< allocations not served by the pool */
+    size_t bytes;              /**< bytes requested */
+  };
+
+  /**
+   * @brief Get the global allocator
+   *
+   * @return TensorAllocator& allocator
+   */
+  static TensorAllocator &Global();
+
+  /**
+   * @brief Allocate memory for a tensor
+   *
+   * @param bytes bytes to allocate
+   * @param zero_fill fill the memory with zeros, false if the caller
+   * overwrites all of it
+   * @return std::shared_ptr<MemoryData> memory which is returned to the pool
+   * when released
+   */
+  std::shared_ptr<MemoryData> allocate(size_t bytes, bool zero_fill = true);
+
+  /**
+   * @brief Get the counters since the last resetStats()
+   *
+   * @return Stats counters
+   */
+  Stats getStats() const;
+
+  /**
+   * @brief Reset the counters
+   */
+  void resetStats();
+
+  /**
+   * @brief Free the memory cached by the calling thread and the shared cache
+   */
+  void release();
+
+  /**
+   * @brief Get the bytes of the size class of the request
+   *
+   * @param bytes bytes requested
+   * @return size_t bytes actually allocated
+   */
+  static size_t getAllocationSize(size_t bytes);
+
+private:
+  /**
+   * @brief Construct a new Tensor Allocator object
+   */
+  TensorAllocator();
+
+  /**
+   * @brief Get memory of a size class from the caches or the system
+   *
+   * @param size_class index of the size class
+   * @param bytes bytes of the size class
+   * @return void* memory
+   */
+  void *get(unsigned int size_class, size_t bytes);
+
+  /**
+   * @brief Return memory of a size class to the caches
+   *
+   * @param ptr memory
+   * @param size_class index of the size class
+   * @param bytes bytes of the size class
+   */
+  void put(void *ptr, unsigned int size_class, size_t bytes);
+
+  friend class PooledMemoryData;
+  friend struct ThreadCache;
+
+  std::mutex mutex; /**< guards the shared cache */
+  std::vector<std::vector<void *>> shared_cache; /**< blocks per size class */
+  size_t shared_bytes = 0; /**< bytes held by the shared cache */
+
+  std::atomic<size_t> num_allocations{0};        /**< requested allocations */
+  std::atomic<size_t> num_system_allocations{0}; /**< system allocations */
+  std::atomic<size_t> num_bytes{0};              /**< requested bytes */
+};
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __TENSOR_ALLOCATOR_H__ */
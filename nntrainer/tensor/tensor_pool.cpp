@@ -14,6 +14,8 @@
  * @todo   check before allocate that finalize is done
  */
 
+#include <algorithm>
+
 #include <memory_pool.h>
 #include <nntrainer_log.h>
 #include <tensor.h>
@@ -116,7 +118,8 @@ void TensorPool::finalize(const MemoryPlanner &planner,
                           unsigned int start_order, unsigned int end_order) {
   // std::cout << name << " start Tensor Pool finalize"<< std::endl;
   mem_pool->clear();
-  unsigned int bytes_requested = 0;
+  planRecompute(start_order, end_order);
+  size_t bytes_requested = 0;
   /** if execution order is PERSIST_END_ORDER, then we think it has another
    * execution order for gradient clipping
    *  persist_end_order is for checking if the end order is updated */
@@ -131,6 +134,8 @@ void TensorPool::finalize(const MemoryPlanner &planner,
       continue;
     }
     details->token = 0;
+    details->recompute_token = 0;
+    details->bytes = spec.tensor->bytes();
 
     /**
      * 1. create the validity ranges for the all the requested tensors.
@@ -188,6 +193,25 @@ void TensorPool::finalize(const MemoryPlanner &planner,
      * 3. requestMemory for all the tensors and set their tokens
      * @note +1 is to make the validity_end exlusive in the interval range
      */
+    if (auto found = recompute_details.find(&spec - pool.data());
+        found != recompute_details.end() && found->second.split) {
+      /**
+       * a recomputed tensor is valid for the forward orders of its segment
+       * and again from the recompute order on, with different memory
+       */
+      auto const &rd = found->second;
+      unsigned int forward_end = validity_start;
+      for (auto order : details->exec_order) {
+        if (order <= rd.forward_end)
+          forward_end = std::max(forward_end, order);
+      }
+      details->recompute_token = mem_pool->requestMemory(
+        spec.tensor->bytes(), rd.recompute_order, validity_end + 1,
+        details->exec_order, details->lifespan, spec.is_weight_grad);
+      validity_end = forward_end;
+      bytes_requested += spec.tensor->bytes();
+    }
+
     details->token = mem_pool->requestMemory(
       spec.tensor->bytes(), validity_start, validity_end + 1,
       details->exec_order, details->lifespan, spec.is_weight_grad);
@@ -203,6 +227,134 @@ void TensorPool::finalize(const MemoryPlanner &planner,
   if (bytes_requested > 0) {
     double efficiency = mem_pool->planLayout(planner);
     ml_logd("Memory layout efficiency = %lf", efficiency);
+    /** report how much the lifespan based sharing saved on the activations */
+    size_t bytes_planned = mem_pool->size();
+    ml_logi("Memory requested = %zu bytes, planned = %zu bytes, saved = %zu "
+            "bytes",
+            bytes_requested, bytes_planned,
+            bytes_requested > bytes_planned ? bytes_requested - bytes_planned
+                                            : 0);
+    if (!recompute_groups.empty()) {
+      auto recomputed = std::count_if(
+        recompute_groups.begin(), recompute_groups.end(),
+        [](auto const &group) { return group.second; });
+      ml_logi("Recomputing %zu of %zu layers, peak memory = %zu bytes",
+              static_cast<size_t>(recomputed), recompute_groups.size(),
+              bytes_planned);
+    }
+  }
+}
+
+void TensorPool::planRecompute(unsigned int start_order,
+                               unsigned int end_order) {
+  std::vector<unsigned int> candidates;
+  for (auto &[group, recomputed] : recompute_groups)
+    recomputed = true;
+
+  for (auto &[idx, rd] : recompute_details) {
+    auto &details = std::get<SourceDetails>(pool.at(idx).details);
+    rd.split = false;
+
+    bool splittable = !rd.conflict && rd.recompute_order <= end_order &&
+                      details.lifespan != TensorLifespan::UNMANAGED &&
+                      !isTensorLongTerm(details.lifespan);
+    bool written = false;
+    for (auto order : details.exec_order) {
+      if (order >= start_order && order <= rd.forward_end)
+        written = true;
+      else if (order > rd.forward_end && order < rd.recompute_order)
+        splittable = false;
+    }
+
+    if (!splittable) {
+      for (auto group : rd.groups)
+        recompute_groups[group] = false;
+    } else if (written) {
+      candidates.push_back(idx);
+    }
+  }
+
+  /** a tensor shared with a group which is not recomputed must stay intact */
+  auto is_recomputed = [this](unsigned int group) {
+    return recompute_groups.at(group);
+  };
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (auto &[idx, rd] : recompute_details) {
+      if (std::all_of(rd.groups.begin(), rd.groups.end(), is_recomputed))
+        continue;
+      for (auto group : rd.groups) {
+        changed = changed || recompute_groups[group];
+        recompute_groups[group] = false;
+      }
+    }
+  }
+
+  for (auto idx : candidates) {
+    auto &rd = recompute_details.at(idx);
+    if (!std::all_of(rd.groups.begin(), rd.groups.end(), is_recomputed))
+      continue;
+
+    auto &exec_order = std::get<SourceDetails>(pool.at(idx).details).exec_order;
+    if (std::find(exec_order.begin(), exec_order.end(), rd.recompute_order) ==
+        exec_order.end())
+      exec_order.push_back(rd.recompute_order);
+    rd.split = true;
+  }
+}
+
+void TensorPool::requestRecompute(const std::string &name, unsigned int group,
+                                  unsigned int forward_end,
+                                  unsigned int recompute_order) {
+  NNTR_THROW_IF(cache_loader, std::invalid_argument)
+    << "recomputing the tensors is not supported with memory swap, name: "
+    << name;
+  NNTR_THROW_IF(recompute_order <= forward_end, std::invalid_argument)
+    << "recompute order must come after the forwarding, name: " << name;
+
+  auto &spec = getSourceSpec(name);
+  unsigned int idx = &spec - pool.data();
+  auto [iter, inserted] = recompute_details.try_emplace(
+    idx, RecomputeDetails{forward_end, recompute_order, {}});
+  auto &rd = iter->second;
+  if (rd.forward_end != forward_end || rd.recompute_order != recompute_order)
+    rd.conflict = true;
+  if (std::find(rd.groups.begin(), rd.groups.end(), group) == rd.groups.end())
+    rd.groups.push_back(group);
+  recompute_groups.try_emplace(group, false);
+}
+
+void TensorPool::requestRecomputeInput(const std::string &name,
+                                       unsigned int recompute_order) {
+  auto &details = std::get<SourceDetails>(getSourceSpec(name).details);
+  if (details.lifespan == TensorLifespan::UNMANAGED ||
+      std::find(details.exec_order.begin(), details.exec_order.end(),
+                recompute_order) != details.exec_order.end())
+    return;
+
+  details.exec_order.push_back(recompute_order);
+}
+
+bool TensorPool::isRecomputed(unsigned int group) const {
+  auto found = recompute_groups.find(group);
+  return found != recompute_groups.end() && found->second;
+}
+
+void TensorPool::bindForwardMemory() { bindRecomputed(false); }
+
+void TensorPool::bindRecomputeMemory(unsigned int recompute_order) {
+  bindRecomputed(true, recompute_order);
+}
+
+void TensorPool::bindRecomputed(bool recompute, unsigned int recompute_order) {
+  for (auto &[idx, rd] : recompute_details) {
+    if (!rd.split || !rd.forward_mem ||
+        (recompute && rd.recompute_order != recompute_order))
+      continue;
+
+    auto &spec = pool.at(idx);
+    spec.tensor->setData(recompute ? rd.recompute_mem : rd.forward_mem);
+    syncDependents(spec);
   }
 }
 
@@ -224,19 +376,49 @@ void TensorPool::allocate() {
     return;
   mem_pool->allocate();
 
-  // std::cout << "syncDependents start" << std::endl;
+  bind();
+
+  if (cache_loader)
+    cache_loader->init();
+}
+
+/**
+ * @brief Detach the tensors from the allocated memory
+ */
+bool TensorPool::unbind() {
+  if (cache_loader || !isAllocated())
+    return false;
+
+  for (auto &spec : pool) {
+    spec.tensor->setData(nullptr);
+  }
+
+  return true;
+}
+
+/**
+ * @brief Attach the tensors to their planned memory
+ */
+void TensorPool::bind() {
   /** set the pointers using the token for all the tensors */
   for (auto &spec : pool) {
     auto details = std::get_if<SourceDetails>(&spec.details);
     if (!details || details->token == 0) {
       continue;
     }
+    NNTR_THROW_IF(spec.tensor->bytes() > details->bytes, std::invalid_argument)
+      << "tensor " << spec.tensor->getName() << " of " << spec.tensor->bytes()
+      << " bytes does not fit in the planned " << details->bytes << " bytes";
+
     spec.tensor->setData(mem_pool->getMemory(details->token), 0, true);
     syncDependents(spec);
-  }
 
-  if (cache_loader)
-    cache_loader->init();
+    if (details->recompute_token != 0) {
+      auto &rd = recompute_details.at(&spec - pool.data());
+      rd.forward_mem = spec.tensor->getMemoryData();
+      rd.recompute_mem = mem_pool->getMemory(details->recompute_token);
+    }
+  }
 }
 
 /**
@@ -247,6 +429,10 @@ void TensorPool::deallocate() {
     cache_loader->finish();
 
   mem_pool->deallocate();
+  for (auto &[idx, rd] : recompute_details) {
+    rd.forward_mem = nullptr;
+    rd.recompute_mem = nullptr;
+  }
 
   /** nullify the data pointers for the tensors */
   for (auto &spec : pool) {
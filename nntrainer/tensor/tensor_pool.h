@@ -18,6 +18,7 @@
 
 #include <functional>
 #include <limits>
+#include <map>
 #include <memory>
 #include <unordered_map>
 #include <variant>
@@ -70,6 +71,8 @@ public:
    */
   void reinitialize() {
     name_map.clear();
+    recompute_details.clear();
+    recompute_groups.clear();
     mem_pool = std::make_shared<MemoryPool>();
   }
 
@@ -100,6 +103,24 @@ public:
    */
   void deallocate();
 
+  /**
+   * @brief Detach the tensors from the allocated memory while keeping the
+   * memory itself, so that their dimensions can be updated
+   *
+   * @return true if the tensors are detached, false if the pool is not
+   * allocated or its memory can not be kept (memory swap)
+   */
+  bool unbind();
+
+  /**
+   * @brief Attach the tensors detached by unbind() to their planned memory
+   * again
+   *
+   * @note a tensor may shrink between unbind() and bind() but may not grow
+   * beyond the bytes its memory was planned for
+   */
+  void bind();
+
   /**
    * @brief     Get execution order for the given tensor
    *
@@ -297,6 +318,52 @@ public:
    */
   void loadCacheCancel(int id);
 
+  /**
+   * @brief Request the tensor written by the forwarding of a layer to be
+   * recomputed before the backwarding instead of being kept alive in between
+   *
+   * @param name name of the tensor
+   * @param group identifier of the layer recomputing the tensor
+   * @param forward_end last forward execution order of the segment
+   * @param recompute_order execution order at which the segment is recomputed
+   * @note the tensor gets a memory block for the forwarding and another one
+   * from recompute_order on if every tensor of the groups writing it can be
+   * split that way, see isRecomputed()
+   */
+  void requestRecompute(const std::string &name, unsigned int group,
+                        unsigned int forward_end, unsigned int recompute_order);
+
+  /**
+   * @brief Request the tensor read by the forwarding of a recomputed layer to
+   * be valid at the recompute order
+   *
+   * @param name name of the tensor
+   * @param recompute_order execution order at which the segment is recomputed
+   */
+  void requestRecomputeInput(const std::string &name,
+                             unsigned int recompute_order);
+
+  /**
+   * @brief Check if the group is recomputed with the current memory plan
+   *
+   * @param group identifier given to requestRecompute()
+   * @return true if the tensors of the group were split by finalize()
+   */
+  bool isRecomputed(unsigned int group) const;
+
+  /**
+   * @brief Bind the recomputed tensors to their forwarding memory
+   */
+  void bindForwardMemory();
+
+  /**
+   * @brief Bind the tensors recomputed at the given order to their memory for
+   * the backwarding
+   *
+   * @param recompute_order execution order given to requestRecompute()
+   */
+  void bindRecomputeMemory(unsigned int recompute_order);
+
 private:
   /**
    * @brief Source tensor detailed specification
@@ -308,6 +375,22 @@ private:
     std::vector<unsigned int> exec_order; /**< exec order */
     std::vector<unsigned int>
       dependents; /**< list of dependents to the source */
+    unsigned int recompute_token = 0; /**< memory token when recomputed */
+    size_t bytes = 0;                 /**< bytes planned for the tokens */
+  };
+
+  /**
+   * @brief Recompute request of a source tensor
+   *
+   */
+  struct RecomputeDetails {
+    unsigned int forward_end;         /**< last forward order of the segment */
+    unsigned int recompute_order;     /**< order the segment is recomputed at */
+    std::vector<unsigned int> groups; /**< groups writing the tensor */
+    bool conflict = false; /**< requested by more than one segment */
+    bool split = false;    /**< memory is split by finalize */
+    std::shared_ptr<MemoryData> forward_mem;   /**< memory for forwarding */
+    std::shared_ptr<MemoryData> recompute_mem; /**< memory for backwarding */
   };
 
   /**
@@ -395,6 +478,31 @@ private:
     name_map;                           /**< indexing of requested tensors */
   std::shared_ptr<MemoryPool> mem_pool; /**< memory pool for the tensors */
   std::unique_ptr<CacheLoader> cache_loader; /**< memory pool for the tensors */
+  std::map<unsigned int, RecomputeDetails>
+    recompute_details; /**< recompute requests by the source index */
+  std::map<unsigned int, bool>
+    recompute_groups; /**< groups to recompute and if they are recomputed */
+
+  /**
+   * @brief Decide which recompute requests are met by the memory plan
+   *
+   * @param start_order start value for the order_exec (inclusive)
+   * @param end_order end value for the order_exec (inclusive)
+   * @details a tensor is split if all of its orders are either forward orders
+   * of the segment or come after the recompute order. A group is recomputed
+   * only if all the tensors it writes are split, and a tensor written by a
+   * group which is not recomputed is never split.
+   */
+  void planRecompute(unsigned int start_order, unsigned int end_order);
+
+  /**
+   * @brief Bind the split tensors to the forward or recompute memory
+   *
+   * @param recompute true to bind to the recompute memory
+   * @param recompute_order only the tensors of this order are bound, ignored
+   * if recompute is false
+   */
+  void bindRecomputed(bool recompute, unsigned int recompute_order = 0);
 
   /**
    * @brief     Check if the lifespan leads to long term valitidy
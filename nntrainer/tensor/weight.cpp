@@ -11,6 +11,9 @@
  *
  */
 
+#include <algorithm>
+
+#include <blas_interface.h>
 #include <util_func.h>
 #include <weight.h>
 
@@ -54,4 +57,74 @@ Weight::Weight(const TensorDim &dim_v, const TensorDim &dim_g,
     throw std::invalid_argument("Weight regularizer unknown");
 }
 
+void Weight::applyGradient(double lr) {
+  if (!sparse_grad) {
+    var->add_i(*grad.get(), -lr);
+    return;
+  }
+
+  unsigned int width = var->width();
+  float *v = var->getData<float>();
+  const float *g = grad->getData<float>();
+  for (size_t k = 0; k < grad_rows.size(); ++k)
+    saxpy(width, -lr, g + k * width, 1, v + (size_t)grad_rows[k] * width, 1);
+}
+
+void Weight::setGradientRows(std::vector<unsigned int> &&rows) {
+  NNTR_THROW_IF(!allow_sparse_grad, std::runtime_error)
+    << "sparse gradient is not allowed for " << getName();
+  NNTR_THROW_IF(grad->getDataType() != Tdatatype::FP32 ||
+                  var->getDataType() != Tdatatype::FP32,
+                std::invalid_argument)
+    << "sparse gradient is only supported for fp32, weight: " << getName();
+
+  grad_rows = std::move(rows);
+  sparse_grad = true;
+}
+
+void Weight::densifyGradient() {
+  if (!sparse_grad)
+    return;
+
+  /** rows are sorted and unique, so grad_rows[k] >= k and moving the rows
+   * from the last one never overwrites a row which is not moved yet */
+  size_t width = grad->width();
+  size_t num_rows = grad->size() / width;
+  float *g = grad->getData<float>();
+  for (size_t k = grad_rows.size(); k-- > 0;) {
+    if (grad_rows[k] != k)
+      std::copy(g + k * width, g + (k + 1) * width, g + grad_rows[k] * width);
+  }
+
+  size_t next = 0;
+  for (size_t r = 0; r < num_rows; ++r) {
+    if (next < grad_rows.size() && grad_rows[next] == r)
+      ++next;
+    else
+      std::fill(g + r * width, g + (r + 1) * width, 0.0f);
+  }
+
+  grad_rows.clear();
+  sparse_grad = false;
+}
+
+bool Weight::accumulateGradient() {
+  if (grad_acc == nullptr || acc_steps <= 1)
+    return true;
+
+  densifyGradient();
+  if (++acc_count < acc_steps) {
+    if (acc_count == 1)
+      grad_acc->copyData(*grad);
+    else
+      grad_acc->add_i(*grad);
+    return false;
+  }
+
+  grad->add_i(*grad_acc);
+  grad->multiply_i(1.0f / acc_steps);
+  acc_count = 0;
+  return true;
+}
+
 } // namespace nntrainer
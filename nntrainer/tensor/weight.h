@@ -170,6 +170,12 @@ public:
     swap(lhs.output_axis, rhs.output_axis);
     swap(lhs.opt_vars, rhs.opt_vars);
     swap(lhs.loss_scale, rhs.loss_scale);
+    swap(lhs.allow_sparse_grad, rhs.allow_sparse_grad);
+    swap(lhs.sparse_grad, rhs.sparse_grad);
+    swap(lhs.grad_rows, rhs.grad_rows);
+    swap(lhs.grad_acc, rhs.grad_acc);
+    swap(lhs.acc_steps, rhs.acc_steps);
+    swap(lhs.acc_count, rhs.acc_count);
   }
 
   /**
@@ -277,22 +283,97 @@ public:
    * @brief     Calculate gradient from the regularization of the weight
    */
   void calcRegularizationGradient() {
-    if (isWeightRegularizerL2Norm())
+    if (isWeightRegularizerL2Norm()) {
+      densifyGradient();
       grad->add_i(*var.get(), regularizer_constant);
+    }
   }
 
   /**
    * @brief     Calculate gradient from the decay of the weight
    */
   void calcWeightDecayGradient() {
-    if (isWeightDecay())
+    if (isWeightDecay()) {
+      densifyGradient();
       applyWeightDecay();
+    }
   }
 
   /**
    * @brief     Apply the gradient to the weight
+   * @note      only the listed rows are updated if the gradient is sparse
    */
-  void applyGradient(double lr) { var->add_i(*grad.get(), -lr); }
+  void applyGradient(double lr);
+
+  /**
+   * @brief     Allow the layer owning this weight to compute a row sparse
+   * gradient. This is refused if the gradient is regularized, decayed or
+   * clipped as those need the dense gradient.
+   * @param allow true if the optimizer supports sparse gradient
+   */
+  void setSparseGradientAllowed(bool allow) {
+    allow_sparse_grad = allow && !isWeightRegularizerL2Norm() &&
+                        !isWeightDecay() && !isGradientClipByGlobalNorm() &&
+                        grad_acc == nullptr;
+  }
+
+  /**
+   * @brief     Check if a row sparse gradient may be set
+   * @return    true if allowed
+   */
+  bool isSparseGradientAllowed() const { return allow_sparse_grad; }
+
+  /**
+   * @brief     Mark the gradient as row sparse. The weight is viewed as rows
+   * of width() elements, and the k-th row of the gradient holds the gradient
+   * of the rows[k]-th row of the weight. The rest of the gradient is unused.
+   * @param rows sorted and unique row indices of the weight
+   */
+  void setGradientRows(std::vector<unsigned int> &&rows);
+
+  /**
+   * @brief     Check if the gradient is row sparse
+   * @return    true if the gradient is row sparse
+   */
+  bool isGradientSparse() const { return sparse_grad; }
+
+  /**
+   * @brief     Get the weight rows of a row sparse gradient
+   * @return    sorted row indices
+   */
+  const std::vector<unsigned int> &getGradientRows() const {
+    return grad_rows;
+  }
+
+  /**
+   * @brief     Scatter a row sparse gradient to the dense layout. No-op if
+   * the gradient is already dense.
+   */
+  void densifyGradient();
+
+  /**
+   * @brief     Set the tensor accumulating the gradient over micro-batches
+   * @param acc accumulator of the gradient dimension
+   * @param steps number of micro-batches per update
+   */
+  void setGradientAccumulator(Tensor *acc, unsigned int steps) {
+    grad_acc = acc;
+    acc_steps = steps;
+    acc_count = 0;
+  }
+
+  /**
+   * @brief     Accumulate the gradient of the current micro-batch. On the last
+   * micro-batch, the gradient is replaced by the mean of the gradients of all
+   * the micro-batches.
+   * @return    true if the gradient is ready to be applied
+   */
+  bool accumulateGradient();
+
+  /**
+   * @brief     Drop the gradient accumulated so far
+   */
+  void resetGradientAccumulation() { acc_count = 0; }
 
   /**
    * @brief Check if the gradient is supposed to be clipped by global norm with
@@ -322,8 +403,10 @@ public:
    * @param global_norm the global norm for all the weights
    */
   void clipGradientByGlobalNorm(const float global_norm) {
-    if ((global_norm + epsilon) > clip_by_global_norm)
+    if ((global_norm + epsilon) > clip_by_global_norm) {
+      densifyGradient();
       grad->multiply_i(clip_by_global_norm / (global_norm + epsilon));
+    }
   }
 
 private:
@@ -339,6 +422,12 @@ private:
   float loss_scale;
   std::vector<Tensor *> opt_vars; /**< optimizer variables */
   std::shared_ptr<Tensor> var32;
+  bool allow_sparse_grad = false; /**< row sparse gradient may be set */
+  bool sparse_grad = false;       /**< gradient is row sparse */
+  std::vector<unsigned int> grad_rows; /**< rows of a sparse gradient */
+  Tensor *grad_acc = nullptr;    /**< gradient accumulated over micro-batches */
+  unsigned int acc_steps = 1;    /**< number of micro-batches per update */
+  unsigned int acc_count = 0;    /**< micro-batches accumulated so far */
 
   /**
    * @brief     Apply the weight decay to the weight
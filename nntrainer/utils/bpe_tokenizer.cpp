@@ -0,0 +1,602 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   bpe_tokenizer.cpp
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Byte level BPE tokenizer of the GPT-2 family
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <bpe_tokenizer.h>
+#include <nntr_threads.h>
+#include <nntrainer_error.h>
+
+namespace nntrainer {
+
+namespace {
+
+constexpr uint32_t BPE_MAGIC = 0x4550424e; /**< "NBPE" */
+constexpr uint32_t BPE_VERSION = 1;
+constexpr uint32_t NONE = UINT32_MAX;
+
+/**
+ * @brief header of the binary image, followed by the token of every byte, the
+ * offsets of the tokens, the merge slots and the bytes of the tokens
+ */
+struct Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t num_tokens;
+  uint32_t num_slots;
+  uint32_t num_bytes;
+  uint32_t reserved[3];
+};
+
+/**
+ * @brief hash of a pair of tokens into the merge slots
+ */
+inline uint32_t hashPair(uint32_t left, uint32_t right) {
+  uint32_t h = left * 0x9e3779b1u ^ right * 0x85ebca77u;
+  return h ^ (h >> 15);
+}
+
+/**
+ * @brief the printable code points GPT-2 stands for every byte in the
+ * vocabulary, as utf-8
+ */
+std::vector<std::string> byteSymbols() {
+  auto utf8 = [](uint32_t cp) {
+    std::string s;
+    if (cp < 0x80) {
+      s += (char)cp;
+    } else {
+      s += (char)(0xc0 | (cp >> 6));
+      s += (char)(0x80 | (cp & 0x3f));
+    }
+    return s;
+  };
+
+  std::vector<std::string> symbols(256);
+  uint32_t shifted = 0;
+  for (uint32_t b = 0; b < 256; ++b) {
+    bool printable = (b >= '!' && b <= '~') || (b >= 0xa1 && b <= 0xac) ||
+                     (b >= 0xae && b <= 0xff);
+    symbols[b] = utf8(printable ? b : 256 + shifted++);
+  }
+  return symbols;
+}
+
+/**
+ * @brief read a whole file
+ */
+std::string readFile(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  NNTR_THROW_IF(!file.good(), std::invalid_argument)
+    << "BPETokenizer: cannot open file: " << path;
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+/**
+ * @brief parse the flat json object from the tokens to the ids
+ */
+std::unordered_map<std::string, uint32_t> parseVocab(const std::string &json,
+                                                     const std::string &path) {
+  size_t pos = 0;
+  auto fail = [&path, &pos]() {
+    std::stringstream ss;
+    ss << "BPETokenizer: malformed vocabulary: " << path << " at " << pos;
+    return std::invalid_argument(ss.str());
+  };
+  auto skip = [&json, &pos]() {
+    while (pos < json.size() && std::isspace((unsigned char)json[pos]))
+      ++pos;
+  };
+  auto expect = [&](char c) {
+    skip();
+    if (pos >= json.size() || json[pos] != c)
+      throw fail();
+    ++pos;
+  };
+  auto hex = [&](size_t at) {
+    if (at + 4 > json.size())
+      throw fail();
+    return (uint32_t)std::stoul(json.substr(at, 4), nullptr, 16);
+  };
+  auto appendUtf8 = [](std::string &s, uint32_t cp) {
+    if (cp < 0x80) {
+      s += (char)cp;
+    } else if (cp < 0x800) {
+      s += (char)(0xc0 | (cp >> 6));
+      s += (char)(0x80 | (cp & 0x3f));
+    } else if (cp < 0x10000) {
+      s += (char)(0xe0 | (cp >> 12));
+      s += (char)(0x80 | ((cp >> 6) & 0x3f));
+      s += (char)(0x80 | (cp & 0x3f));
+    } else {
+      s += (char)(0xf0 | (cp >> 18));
+      s += (char)(0x80 | ((cp >> 12) & 0x3f));
+      s += (char)(0x80 | ((cp >> 6) & 0x3f));
+      s += (char)(0x80 | (cp & 0x3f));
+    }
+  };
+
+  std::unordered_map<std::string, uint32_t> vocab;
+  expect('{');
+  skip();
+  if (pos < json.size() && json[pos] == '}')
+    return vocab;
+
+  while (true) {
+    expect('"');
+    std::string key;
+    while (pos < json.size() && json[pos] != '"') {
+      if (json[pos] != '\\') {
+        key += json[pos++];
+        continue;
+      }
+      if (++pos >= json.size())
+        throw fail();
+      char c = json[pos++];
+      switch (c) {
+      case 'b':
+        key += '\b';
+        break;
+      case 'f':
+        key += '\f';
+        break;
+      case 'n':
+        key += '\n';
+        break;
+      case 'r':
+        key += '\r';
+        break;
+      case 't':
+        key += '\t';
+        break;
+      case 'u': {
+        uint32_t cp = hex(pos);
+        pos += 4;
+        if (cp >= 0xd800 && cp < 0xdc00 && json.compare(pos, 2, "\\u") == 0) {
+          cp = 0x10000 + ((cp - 0xd800) << 10) + (hex(pos + 2) - 0xdc00);
+          pos += 6;
+        }
+        appendUtf8(key, cp);
+        break;
+      }
+      default:
+        key += c;
+      }
+    }
+    expect('"');
+    expect(':');
+    skip();
+    size_t end = pos;
+    while (end < json.size() && std::isdigit((unsigned char)json[end]))
+      ++end;
+    if (end == pos)
+      throw fail();
+    vocab.emplace(std::move(key), std::stoul(json.substr(pos, end - pos)));
+    pos = end;
+
+    skip();
+    if (pos < json.size() && json[pos] == ',') {
+      ++pos;
+      continue;
+    }
+    expect('}');
+    return vocab;
+  }
+}
+
+/**
+ * @brief class of a character for the GPT-2 split pattern
+ */
+enum class CharClass { SPACE, LETTER, DIGIT, OTHER };
+
+/**
+ * @brief classify the character at pos, non-ASCII characters are letters
+ *
+ * @param[out] len bytes of the character
+ */
+inline CharClass classify(const std::string &text, size_t pos, size_t &len) {
+  unsigned char c = text[pos];
+  len = 1;
+  if (c >= 0x80) {
+    while (len < 4 && pos + len < text.size() &&
+           ((unsigned char)text[pos + len] & 0xc0) == 0x80)
+      ++len;
+    return CharClass::LETTER;
+  }
+  if (c == ' ' || (c >= '\t' && c <= '\r'))
+    return CharClass::SPACE;
+  if (std::isalpha(c))
+    return CharClass::LETTER;
+  if (std::isdigit(c))
+    return CharClass::DIGIT;
+  return CharClass::OTHER;
+}
+
+/**
+ * @brief length of the word starting at pos by the GPT-2 pattern
+ * 's|'t|'re|'ve|'m|'ll|'d| ?\p{L}+| ?\p{N}+| ?[^\s\p{L}\p{N}]+|\s+(?!\S)|\s+
+ */
+size_t wordLength(const std::string &text, size_t pos) {
+  const size_t n = text.size();
+  if (text[pos] == '\'' && pos + 1 < n) {
+    char c = text[pos + 1];
+    if (c == 's' || c == 't' || c == 'm' || c == 'd')
+      return 2;
+    if (pos + 2 < n && (text.compare(pos + 1, 2, "re") == 0 ||
+                        text.compare(pos + 1, 2, "ve") == 0 ||
+                        text.compare(pos + 1, 2, "ll") == 0))
+      return 3;
+  }
+
+  size_t len;
+  size_t end = pos;
+  CharClass cls = classify(text, end, len);
+  if (text[pos] == ' ' && pos + 1 < n) {
+    size_t next_len;
+    CharClass next = classify(text, pos + 1, next_len);
+    if (next != CharClass::SPACE) {
+      end = pos + 1;
+      cls = next;
+      len = next_len;
+    }
+  }
+
+  if (cls != CharClass::SPACE) {
+    do {
+      end += len;
+    } while (end < n && classify(text, end, len) == cls);
+    return end - pos;
+  }
+
+  /** a run of spaces leaves its last one to the word following it */
+  while (end < n && classify(text, end, len) == CharClass::SPACE)
+    end += len;
+  return (end < n && end - pos > 1) ? end - pos - 1 : end - pos;
+}
+
+} // namespace
+
+BPETokenizer::BPETokenizer(unsigned int cache_size_) :
+  mapped(nullptr),
+  mapped_size(0),
+  num_tokens(0),
+  merge_mask(0),
+  offsets(nullptr),
+  token_bytes(nullptr),
+  byte_token(nullptr),
+  merges(nullptr),
+  cache_size(cache_size_),
+  cache_hits(0) {}
+
+BPETokenizer::~BPETokenizer() {
+  if (mapped)
+    munmap(mapped, mapped_size);
+}
+
+std::unique_ptr<BPETokenizer> BPETokenizer::load(const std::string &path,
+                                                 unsigned int cache_size) {
+  int fd = open(path.c_str(), O_RDONLY);
+  NNTR_THROW_IF(fd < 0, std::invalid_argument)
+    << "BPETokenizer: cannot open file: " << path;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(Header)) {
+    close(fd);
+    throw std::invalid_argument("BPETokenizer: not a tokenizer file: " + path);
+  }
+
+  void *ptr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  NNTR_THROW_IF(ptr == MAP_FAILED, std::runtime_error)
+    << "BPETokenizer: mmap file: " << path;
+
+  std::unique_ptr<BPETokenizer> tokenizer(new BPETokenizer(cache_size));
+  tokenizer->mapped = ptr;
+  tokenizer->mapped_size = st.st_size;
+  tokenizer->bind(static_cast<const char *>(ptr), st.st_size);
+  return tokenizer;
+}
+
+std::unique_ptr<BPETokenizer>
+BPETokenizer::loadText(const std::string &vocab_path,
+                       const std::string &merges_path,
+                       unsigned int cache_size) {
+  std::unordered_map<std::string, uint32_t> vocab =
+    parseVocab(readFile(vocab_path), vocab_path);
+
+  /** the tokens keep their raw bytes, mapped back from the byte symbols */
+  std::vector<std::string> symbols = byteSymbols();
+  std::unordered_map<std::string, unsigned char> symbol_byte;
+  for (unsigned int b = 0; b < 256; ++b)
+    symbol_byte.emplace(symbols[b], b);
+
+  uint32_t num_tokens = 0;
+  for (auto &[token, id] : vocab)
+    num_tokens = std::max(num_tokens, id + 1);
+
+  std::vector<std::string> raw(num_tokens);
+  for (auto &[token, id] : vocab) {
+    std::string bytes;
+    size_t pos = 0;
+    while (pos < token.size()) {
+      size_t len;
+      classify(token, pos, len);
+      auto found = symbol_byte.find(token.substr(pos, len));
+      if (found == symbol_byte.end()) {
+        /** special tokens out of the byte symbols are kept as they are */
+        bytes = token;
+        break;
+      }
+      bytes += (char)found->second;
+      pos += len;
+    }
+    raw[id] = std::move(bytes);
+  }
+
+  std::vector<uint32_t> pairs;
+  std::istringstream lines(readFile(merges_path));
+  std::string line;
+  while (std::getline(lines, line)) {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    size_t space = line.find(' ');
+    if (line.empty() || line[0] == '#' || space == std::string::npos)
+      continue;
+
+    std::string left = line.substr(0, space);
+    std::string right = line.substr(space + 1);
+    auto l = vocab.find(left), r = vocab.find(right),
+         m = vocab.find(left + right);
+    if (l == vocab.end() || r == vocab.end() || m == vocab.end())
+      continue;
+    pairs.insert(pairs.end(), {l->second, r->second, m->second});
+  }
+
+  uint32_t num_merges = pairs.size() / 3;
+  uint32_t num_slots = 1;
+  while (num_slots < num_merges * 2)
+    num_slots <<= 1;
+
+  uint32_t num_bytes = 0;
+  for (auto &bytes : raw)
+    num_bytes += bytes.size();
+
+  size_t words = sizeof(Header) / 4 + 256 + (num_tokens + 1) + num_slots * 4;
+  std::unique_ptr<BPETokenizer> tokenizer(new BPETokenizer(cache_size));
+  std::vector<char> &image = tokenizer->owned;
+  image.assign(words * 4 + num_bytes, 0);
+
+  Header *header = reinterpret_cast<Header *>(image.data());
+  *header = {BPE_MAGIC, BPE_VERSION, num_tokens, num_slots, num_bytes, {}};
+
+  uint32_t *byte_token = reinterpret_cast<uint32_t *>(header + 1);
+  for (unsigned int b = 0; b < 256; ++b) {
+    auto found = vocab.find(symbols[b]);
+    byte_token[b] = found == vocab.end() ? NONE : found->second;
+  }
+
+  uint32_t *offsets = byte_token + 256;
+  char *token_bytes = image.data() + words * 4;
+  offsets[0] = 0;
+  for (uint32_t id = 0; id < num_tokens; ++id) {
+    std::memcpy(token_bytes + offsets[id], raw[id].data(), raw[id].size());
+    offsets[id + 1] = offsets[id] + raw[id].size();
+  }
+
+  uint32_t *slots = offsets + num_tokens + 1;
+  for (uint32_t s = 0; s < num_slots; ++s)
+    slots[s * 4] = NONE;
+  for (uint32_t rank = 0; rank < num_merges; ++rank) {
+    uint32_t left = pairs[rank * 3], right = pairs[rank * 3 + 1];
+    uint32_t s = hashPair(left, right) & (num_slots - 1);
+    while (slots[s * 4] != NONE &&
+           !(slots[s * 4] == left && slots[s * 4 + 1] == right))
+      s = (s + 1) & (num_slots - 1);
+    /** a pair merged twice keeps its first rank */
+    if (slots[s * 4] == NONE) {
+      slots[s * 4] = left;
+      slots[s * 4 + 1] = right;
+      slots[s * 4 + 2] = rank;
+      slots[s * 4 + 3] = pairs[rank * 3 + 2];
+    }
+  }
+
+  tokenizer->bind(image.data(), image.size());
+  return tokenizer;
+}
+
+void BPETokenizer::bind(const char *data, size_t size) {
+  const Header *header = reinterpret_cast<const Header *>(data);
+  NNTR_THROW_IF(size < sizeof(Header) || header->magic != BPE_MAGIC ||
+                  header->version != BPE_VERSION,
+                std::invalid_argument)
+    << "BPETokenizer: not a tokenizer image of version " << BPE_VERSION;
+
+  uint32_t num_slots = header->num_slots;
+  NNTR_THROW_IF(num_slots == 0 || (num_slots & (num_slots - 1)) != 0,
+                std::invalid_argument)
+    << "BPETokenizer: merge slots are not a power of 2: " << num_slots;
+
+  size_t words =
+    sizeof(Header) / 4 + 256 + ((size_t)header->num_tokens + 1) + num_slots * 4;
+  NNTR_THROW_IF(size != words * 4 + header->num_bytes, std::invalid_argument)
+    << "BPETokenizer: size of the image: " << size
+    << " is not matched with the header: " << words * 4 + header->num_bytes;
+
+  num_tokens = header->num_tokens;
+  merge_mask = num_slots - 1;
+  byte_token = reinterpret_cast<const uint32_t *>(header + 1);
+  offsets = byte_token + 256;
+  merges = offsets + num_tokens + 1;
+  token_bytes = data + words * 4;
+
+  NNTR_THROW_IF(offsets[num_tokens] != header->num_bytes,
+                std::invalid_argument)
+    << "BPETokenizer: offsets of the tokens are corrupted";
+}
+
+void BPETokenizer::save(const std::string &path) const {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  NNTR_THROW_IF(!file.good(), std::invalid_argument)
+    << "BPETokenizer: cannot open file: " << path;
+
+  const char *data = mapped ? static_cast<const char *>(mapped) : owned.data();
+  size_t size = mapped ? mapped_size : owned.size();
+  file.write(data, size);
+  NNTR_THROW_IF(!file.good(), std::runtime_error)
+    << "BPETokenizer: write file: " << path;
+}
+
+uint32_t BPETokenizer::findMerge(uint32_t left, uint32_t right,
+                                 uint32_t &merged) const {
+  uint32_t s = hashPair(left, right) & merge_mask;
+  while (merges[s * 4] != NONE) {
+    if (merges[s * 4] == left && merges[s * 4 + 1] == right) {
+      merged = merges[s * 4 + 3];
+      return merges[s * 4 + 2];
+    }
+    s = (s + 1) & merge_mask;
+  }
+  return NONE;
+}
+
+void BPETokenizer::encodeWord(const std::string &word,
+                              std::vector<unsigned int> &tokens) const {
+  std::vector<uint32_t> symbols;
+  symbols.reserve(word.size());
+  for (unsigned char b : word) {
+    NNTR_THROW_IF(byte_token[b] == NONE, std::invalid_argument)
+      << "BPETokenizer: no token for the byte " << (unsigned int)b;
+    symbols.push_back(byte_token[b]);
+  }
+
+  /** merge every occurrence of the pair of the lowest rank, until none */
+  while (symbols.size() > 1) {
+    uint32_t best = NONE, left = 0, right = 0, merged = 0;
+    for (size_t i = 0; i + 1 < symbols.size(); ++i) {
+      uint32_t to;
+      uint32_t rank = findMerge(symbols[i], symbols[i + 1], to);
+      if (rank < best) {
+        best = rank;
+        left = symbols[i];
+        right = symbols[i + 1];
+        merged = to;
+      }
+    }
+    if (best == NONE)
+      break;
+
+    size_t out = 0;
+    for (size_t i = 0; i < symbols.size(); ++i) {
+      if (i + 1 < symbols.size() && symbols[i] == left &&
+          symbols[i + 1] == right) {
+        symbols[out++] = merged;
+        ++i;
+      } else {
+        symbols[out++] = symbols[i];
+      }
+    }
+    symbols.resize(out);
+  }
+
+  tokens.insert(tokens.end(), symbols.begin(), symbols.end());
+}
+
+void BPETokenizer::encodeText(const std::string &text,
+                              std::vector<unsigned int> &tokens,
+                              WordCache &word_cache) const {
+  size_t pos = 0;
+  while (pos < text.size()) {
+    size_t len = wordLength(text, pos);
+    std::string word = text.substr(pos, len);
+    pos += len;
+
+    if (cache_size == 0) {
+      encodeWord(word, tokens);
+      continue;
+    }
+
+    auto found = word_cache.words.find(word);
+    if (found != word_cache.words.end()) {
+      word_cache.lru.splice(word_cache.lru.begin(), word_cache.lru,
+                            found->second);
+      tokens.insert(tokens.end(), found->second->second.begin(),
+                    found->second->second.end());
+      ++word_cache.hits;
+      continue;
+    }
+
+    size_t begin = tokens.size();
+    encodeWord(word, tokens);
+
+    if (word_cache.words.size() >= cache_size) {
+      word_cache.words.erase(word_cache.lru.back().first);
+      word_cache.lru.pop_back();
+    }
+    word_cache.lru.emplace_front(
+      word, std::vector<unsigned int>(tokens.begin() + begin, tokens.end()));
+    word_cache.words.emplace(std::move(word), word_cache.lru.begin());
+  }
+}
+
+std::vector<unsigned int> BPETokenizer::encode(const std::string &text) {
+  std::vector<unsigned int> tokens;
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  unsigned long long hits = cache.hits;
+  encodeText(text, tokens, cache);
+  cache_hits += cache.hits - hits;
+  return tokens;
+}
+
+std::vector<std::vector<unsigned int>>
+BPETokenizer::encodeBatch(const std::vector<std::string> &texts) {
+  std::vector<std::vector<unsigned int>> tokens(texts.size());
+  if (texts.empty())
+    return tokens;
+
+  /** every worker owns a word cache, so the workers never wait for a lock */
+  auto job = [this, &texts, &tokens](unsigned int start, unsigned int end,
+                                     unsigned int pid, void *user_data) {
+    WordCache word_cache;
+    for (unsigned int i = start; i < end; ++i)
+      encodeText(texts[i], tokens[i], word_cache);
+    cache_hits += word_cache.hits;
+  };
+
+  auto workers = ParallelBatch(job, texts.size(), nullptr);
+  workers.run();
+  return tokens;
+}
+
+std::string BPETokenizer::decode(const std::vector<unsigned int> &tokens) const {
+  std::string text;
+  for (unsigned int token : tokens) {
+    NNTR_THROW_IF(token >= num_tokens, std::invalid_argument)
+      << "BPETokenizer: token " << token << " is out of the vocabulary of "
+      << num_tokens;
+    text.append(token_bytes + offsets[token],
+                offsets[token + 1] - offsets[token]);
+  }
+  return text;
+}
+
+} // namespace nntrainer
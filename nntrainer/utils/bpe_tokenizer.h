@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   bpe_tokenizer.h
+ * @date   16 Oct 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug    No known bugs except for NYI items
+ * @brief  Byte level BPE tokenizer of the GPT-2 family
+ *
+ * The vocabulary and the merges are kept in a compact binary image: the raw
+ * bytes of every token, the token of every byte and an open addressing table
+ * of the merge ranks. The image is mapped from a file as is, so loading costs
+ * no parsing. The text vocab.json/merges.txt pair is converted to the image
+ * once and can be saved.
+ *
+ * A text is split into words with the GPT-2 pattern, where every non-ASCII
+ * character counts as a letter. The tokens of a word are cached, evicting the
+ * least recently used word. encode() shares one cache between the calls while
+ * every worker of encodeBatch() owns a cache, so the batch takes no lock.
+ */
+
+#ifndef __BPE_TOKENIZER_H__
+#define __BPE_TOKENIZER_H__
+#ifdef __cplusplus
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nntrainer {
+
+/**
+ * @class   BPETokenizer
+ * @brief   encodes texts to tokens with the byte pair merges and decodes them
+ * back
+ */
+class BPETokenizer {
+public:
+  /**
+   * @brief Load the tokenizer from a binary image saved with save()
+   *
+   * @param path path of the binary image, mapped to the memory
+   * @param cache_size number of the words whose tokens are cached
+   * @return std::unique_ptr<BPETokenizer> tokenizer
+   */
+  static std::unique_ptr<BPETokenizer> load(const std::string &path,
+                                            unsigned int cache_size = 8192);
+
+  /**
+   * @brief Load the tokenizer from a vocab.json and a merges.txt
+   *
+   * @param vocab_path path of the json object from the tokens to the ids
+   * @param merges_path path of the merges in the order of the rank
+   * @param cache_size number of the words whose tokens are cached
+   * @return std::unique_ptr<BPETokenizer> tokenizer
+   */
+  static std::unique_ptr<BPETokenizer>
+  loadText(const std::string &vocab_path, const std::string &merges_path,
+           unsigned int cache_size = 8192);
+
+  /**
+   * @brief Destroy the BPE Tokenizer object
+   */
+  ~BPETokenizer();
+
+  /**
+   * @brief Save the binary image to be loaded with load()
+   *
+   * @param path path of the binary image
+   */
+  void save(const std::string &path) const;
+
+  /**
+   * @brief Encode a text
+   *
+   * @param text utf-8 text
+   * @return std::vector<unsigned int> tokens
+   */
+  std::vector<unsigned int> encode(const std::string &text);
+
+  /**
+   * @brief Encode the texts over the threads
+   *
+   * @param texts utf-8 texts
+   * @return std::vector<std::vector<unsigned int>> tokens of every text
+   */
+  std::vector<std::vector<unsigned int>>
+  encodeBatch(const std::vector<std::string> &texts);
+
+  /**
+   * @brief Decode the tokens
+   *
+   * @param tokens tokens
+   * @return std::string utf-8 text
+   */
+  std::string decode(const std::vector<unsigned int> &tokens) const;
+
+  /**
+   * @brief Get the size of the vocabulary
+   */
+  unsigned int getVocabSize() const { return num_tokens; }
+
+  /**
+   * @brief Get the number of the words encoded from the cache
+   */
+  unsigned long long getCacheHits() const { return cache_hits; }
+
+private:
+  /**
+   * @brief Construct a new BPE Tokenizer object
+   *
+   * @param cache_size number of the words whose tokens are cached
+   */
+  BPETokenizer(unsigned int cache_size);
+
+  /**
+   * @brief Point the tables into the binary image after checking it
+   *
+   * @param data binary image
+   * @param size size of the binary image in bytes
+   */
+  void bind(const char *data, size_t size);
+
+  /**
+   * @brief Merge the bytes of a word into the tokens
+   *
+   * @param word bytes of the word
+   * @param[out] tokens tokens appended
+   */
+  void encodeWord(const std::string &word,
+                  std::vector<unsigned int> &tokens) const;
+
+  /**
+   * @brief Get the rank of merging two tokens
+   *
+   * @param left left token
+   * @param right right token
+   * @param[out] merged token of the merge
+   * @return uint32_t rank of the merge, UINT32_MAX if they are not merged
+   */
+  uint32_t findMerge(uint32_t left, uint32_t right, uint32_t &merged) const;
+
+  using LRUList = std::list<std::pair<std::string, std::vector<unsigned int>>>;
+
+  /**
+   * @brief words whose tokens are cached, the least recently used word is
+   * evicted first. This is not thread safe.
+   */
+  struct WordCache {
+    LRUList lru; /**< cached words, most recent first */
+    std::unordered_map<std::string, LRUList::iterator>
+      words;                     /**< cached words by the bytes */
+    unsigned long long hits = 0; /**< words found in the cache */
+  };
+
+  /**
+   * @brief Encode a text with a word cache
+   *
+   * @param text utf-8 text
+   * @param[out] tokens tokens appended
+   * @param word_cache word cache owned by the caller thread
+   */
+  void encodeText(const std::string &text, std::vector<unsigned int> &tokens,
+                  WordCache &word_cache) const;
+
+  std::vector<char> owned; /**< binary image built from the text files */
+  void *mapped;            /**< binary image mapped from a file */
+  size_t mapped_size;      /**< size of the mapped image */
+
+  uint32_t num_tokens;        /**< size of the vocabulary */
+  uint32_t merge_mask;        /**< number of the merge slots - 1 */
+  const uint32_t *offsets;    /**< offset of the bytes of every token */
+  const char *token_bytes;    /**< bytes of the tokens */
+  const uint32_t *byte_token; /**< token of every byte */
+  const uint32_t *merges;     /**< slots of (left, right, rank, merged) */
+
+  unsigned int cache_size;                    /**< number of the cached words */
+  WordCache cache;                            /**< cache shared by encode() */
+  std::mutex cache_mutex;                     /**< guards the shared cache */
+  std::atomic<unsigned long long> cache_hits; /**< words found in the caches */
+};
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __BPE_TOKENIZER_H__ */
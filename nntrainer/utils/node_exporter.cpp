@@ -16,6 +16,7 @@
 #include <activation_layer.h>
 #include <bitset>
 #include <common_properties.h>
+#include <depthwise_conv2d_layer.h>
 #include <fc_layer.h>
 #include <map>
 #include <node_exporter.h>
@@ -92,7 +93,7 @@ void Exporter::saveTflResult(
                    std::vector<props::InputConnection>,
                    std::vector<props::InputShape>, props::SharedFrom,
                    props::ClipGradByGlobalNorm, props::Packed,
-                   props::LossScaleForMixed> &props,
+                   props::LossScaleForMixed, props::Checkpoint> &props,
   const LayerNode *self) {
   createIfNull(tf_node);
   tf_node->setLayerNode(*self);
@@ -214,6 +215,71 @@ void Exporter::saveTflResult(
   tf_node->setBuiltinOptions(tflite::BuiltinOptions_Conv2DOptions, options);
 }
 
+template <>
+void Exporter::saveTflResult(
+  const std::tuple<props::FilterSize, std::array<props::KernelSize, CONV2D_DIM>,
+                   std::array<props::Stride, CONV2D_DIM>, props::Padding2D,
+                   std::array<props::Dilation, CONV2D_DIM>> &props,
+  const DepthwiseConv2DLayer *self) {
+  createIfNull(tf_node);
+
+  auto weight_transform = [](std::vector<const Tensor *> &old_weights) {
+    std::vector<Tensor> new_weights;
+
+    auto &filter_weight = *old_weights[0];
+    // tflite depthwise filter has shape format {1, height, width, channel_out}
+    Tensor filter_view = filter_weight.clone();
+    filter_view.reshape(TensorDim{1, filter_weight.batch(),
+                                  filter_weight.height(),
+                                  filter_weight.width()});
+    Tensor filter(filter_view.transpose("1:2:0"));
+    new_weights.push_back(filter);
+
+    auto &bias_weight = *old_weights[1];
+    TensorDim bias_dim{bias_weight.getTensorType(), std::bitset<4>(0b0001)};
+    bias_dim.setTensorDim(
+      3 /** index **/,
+      bias_weight
+        .channel() /** value **/); // effective dimension = {bias->channel()}
+    Tensor bias(bias_dim);
+    bias.copyData(bias_weight.transpose("1:2:0"));
+    bias.setName(bias_weight.getName());
+
+    new_weights.push_back(bias);
+
+    return new_weights;
+  };
+  tf_node->setWeightTransformFn(weight_transform);
+
+  tf_node->setOpType(tflite::BuiltinOperator_DEPTHWISE_CONV_2D);
+
+  auto &strides = std::get<std::array<props::Stride, CONV2D_DIM>>(props);
+  auto &dilation = std::get<std::array<props::Dilation, CONV2D_DIM>>(props);
+  const auto &padding = std::get<props::Padding2D>(props).get();
+  if (padding != "same" && padding != "valid") {
+    std::ostringstream ss;
+    ss << "Unsupported padding type; \"" << padding
+       << "\" is not supported. Use \"same\" or \"valid\".";
+    throw std::runtime_error(ss.str());
+  }
+  int multiplier = self->getDepthMultiplier();
+  auto options = tflite::CreateDepthwiseConv2DOptions(
+                   *fbb, tflite_padding(padding), strides.at(1), strides.at(0),
+                   multiplier, tflite::ActivationFunctionType_NONE,
+                   dilation.at(1), dilation.at(0))
+                   .Union();
+
+  tf_node->AppendProps(tflite_padding(padding));
+  tf_node->AppendProps(strides.at(1));
+  tf_node->AppendProps(strides.at(0));
+  tf_node->AppendProps(multiplier);
+  tf_node->AppendProps(dilation.at(1));
+  tf_node->AppendProps(dilation.at(0));
+
+  tf_node->setBuiltinOptions(tflite::BuiltinOptions_DepthwiseConv2DOptions,
+                             options);
+}
+
 template <>
 void Exporter::saveTflResult(
   const std::tuple<props::Normalization, props::Standardization> &props,
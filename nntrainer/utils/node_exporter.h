@@ -235,6 +235,7 @@ class Activation;
 class BatchNormalization;
 class Packed;
 class LossScaleForMixed;
+class Checkpoint;
 } // namespace props
 
 class LayerNode;
@@ -248,7 +249,7 @@ void Exporter::saveTflResult(
                    std::vector<props::InputConnection>,
                    std::vector<props::InputShape>, props::SharedFrom,
                    props::ClipGradByGlobalNorm, props::Packed,
-                   props::LossScaleForMixed> &props,
+                   props::LossScaleForMixed, props::Checkpoint> &props,
   const LayerNode *self);
 
 class BatchNormalizationLayer;
@@ -309,6 +310,18 @@ void Exporter::saveTflResult(
                    std::array<props::Dilation, 2>> &props,
   const Conv2DLayer *self);
 
+class DepthwiseConv2DLayer;
+/**
+ * @copydoc template <typename PropsType, typename NodeType> void
+ * Exporter::saveTflResult(const PropsType &props, const NodeType *self);
+ */
+template <>
+void Exporter::saveTflResult(
+  const std::tuple<props::FilterSize, std::array<props::KernelSize, 2>,
+                   std::array<props::Stride, 2>, props::Padding2D,
+                   std::array<props::Dilation, 2>> &props,
+  const DepthwiseConv2DLayer *self);
+
 class InputLayer;
 /**
  * @copydoc template <typename PropsType, typename NodeType> void
@@ -8,14 +8,197 @@
  * @bug		No known bugs except for NYI items
  */
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <util_simd.h>
 #ifdef USE_NEON
 #include <util_simd_neon.h>
 #endif
+#ifdef USE_AVX
+#include <util_simd_avx.h>
+#endif
 
 namespace nntrainer {
 
+namespace {
+
+/**
+ * @brief advance xorshift32 state and return a uniform number in [0, 1)
+ */
+inline float xorshift_uniform(unsigned int &state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return (state >> 8) * (1.0f / 16777216.0f);
+}
+
+template <typename T>
+void softmax_row_fused_fallback(const unsigned int N, T *X, const float scale,
+                                const T *mask, const unsigned int len,
+                                const float dropout_rate,
+                                const unsigned int seed, T *D) {
+  float max_x = -std::numeric_limits<float>::infinity();
+  for (unsigned int i = 0; i < len; ++i) {
+    float x = static_cast<float>(X[i]) * scale;
+    if (mask)
+      x += static_cast<float>(mask[i]);
+    X[i] = static_cast<T>(x);
+    max_x = std::fmax(max_x, static_cast<float>(X[i]));
+  }
+
+  float sum = 0.f;
+  for (unsigned int i = 0; i < len; ++i) {
+    float e = std::exp(static_cast<float>(X[i]) - max_x);
+    X[i] = static_cast<T>(e);
+    sum += e;
+  }
+
+  const float inv_sum = sum > 0.f ? 1.f / sum : 0.f;
+  if (D) {
+    const float keep_scale = 1.f / (1.f - dropout_rate);
+    unsigned int state = xorshift_seed(seed);
+    for (unsigned int i = 0; i < len; ++i) {
+      float p = static_cast<float>(X[i]) * inv_sum;
+      X[i] = static_cast<T>(p);
+      D[i] = static_cast<T>(
+        xorshift_uniform(state) >= dropout_rate ? p * keep_scale : 0.f);
+    }
+  } else {
+    for (unsigned int i = 0; i < len; ++i)
+      X[i] = static_cast<T>(static_cast<float>(X[i]) * inv_sum);
+  }
+
+  for (unsigned int i = len; i < N; ++i) {
+    X[i] = static_cast<T>(0.f);
+    if (D)
+      D[i] = static_cast<T>(0.f);
+  }
+}
+
+template <typename T>
+void softmax_row_fused_deriv_fallback(const unsigned int N, const T *P,
+                                      const T *D, const float dropout_rate,
+                                      T *dY, const T *dE, const float scale,
+                                      T *dM) {
+  const float keep_scale = D ? 1.f / (1.f - dropout_rate) : 1.f;
+  auto dP = [&](unsigned int i) {
+    float dp = static_cast<float>(dY[i]);
+    if (D)
+      dp = static_cast<float>(D[i]) != 0.f ? dp * keep_scale : 0.f;
+    if (dE)
+      dp += static_cast<float>(dE[i]);
+    return dp;
+  };
+
+  float dot = 0.f;
+  for (unsigned int i = 0; i < N; ++i)
+    dot += static_cast<float>(P[i]) * dP(i);
+
+  for (unsigned int i = 0; i < N; ++i) {
+    float dx = static_cast<float>(P[i]) * (dP(i) - dot);
+    if (dM)
+      dM[i] = static_cast<T>(dx);
+    dY[i] = static_cast<T>(dx * scale);
+  }
+}
+
+/**
+ * @brief scalar sigmoid
+ */
+inline float sigmoid_scalar(float x) { return 1.f / (1.f + std::exp(-x)); }
+
+template <typename T>
+void ele_swiglu_fallback(const unsigned int N, const T *X, const T *G, T *Y) {
+  for (unsigned int i = 0; i < N; ++i) {
+    float x = static_cast<float>(X[i]);
+    Y[i] = static_cast<T>(x * sigmoid_scalar(x) * static_cast<float>(G[i]));
+  }
+}
+
+template <typename T>
+void ele_swiglu_deriv_fallback(const unsigned int N, const T *X, const T *G,
+                               const T *dY, T *dX, T *dG) {
+  for (unsigned int i = 0; i < N; ++i) {
+    float x = static_cast<float>(X[i]);
+    float dy = static_cast<float>(dY[i]);
+    float s = sigmoid_scalar(x);
+    float sw = x * s;
+    float dx = (s + sw * (1.f - s)) * static_cast<float>(G[i]) * dy;
+    dG[i] = static_cast<T>(sw * dy);
+    dX[i] = static_cast<T>(dx);
+  }
+}
+
+template <typename T>
+void rotary_emb_fallback(const unsigned int half, T *X, const float *cos_,
+                         const float *sin_, bool inverse) {
+  const float sign = inverse ? -1.f : 1.f;
+  T *X2 = X + half;
+  for (unsigned int i = 0; i < half; ++i) {
+    float x1 = static_cast<float>(X[i]);
+    float x2 = static_cast<float>(X2[i]);
+    float s = sin_[i] * sign;
+    X[i] = static_cast<T>(x1 * cos_[i] - x2 * s);
+    X2[i] = static_cast<T>(x2 * cos_[i] + x1 * s);
+  }
+}
+
+/**
+ * @brief scalar derivative of gelu
+ */
+inline float gelu_deriv_scalar(float x) {
+  constexpr float t = 0.70710678118654752f; /**< 1 / sqrt(2) */
+  constexpr float c = 1.12837916709551257f; /**< 2 / sqrt(pi) */
+  float xt = x * t;
+  return 0.5f * (1.f + std::erf(xt) + x * c * std::exp(-xt * xt) * t);
+}
+
+/** elements summed sequentially before the pairwise summation */
+constexpr unsigned int REDUCE_BLOCK = 256;
+
+/**
+ * @brief sum of a block of X, or of X * X if square
+ */
+template <bool square>
+inline float reduce_block(const unsigned int N, const float *X) {
+#ifdef USE_NEON
+  return square ? nntrainer::neon::reduce_sum_squares(N, X)
+                : nntrainer::neon::reduce_sum(N, X);
+#elif defined(USE_AVX)
+  return square ? nntrainer::avx::reduce_sum_squares(N, X)
+                : nntrainer::avx::reduce_sum(N, X);
+#else
+  float acc[8] = {0.f};
+  unsigned int i = 0;
+  for (; N - i >= 8; i += 8) {
+    for (unsigned int k = 0; k < 8; ++k)
+      acc[k] += square ? X[i + k] * X[i + k] : X[i + k];
+  }
+  float sum = ((acc[0] + acc[1]) + (acc[2] + acc[3])) +
+              ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+  for (; i < N; ++i)
+    sum += square ? X[i] * X[i] : X[i];
+  return sum;
+#endif
+}
+
+/**
+ * @brief pairwise summation over the blocks of X
+ */
+template <bool square>
+float reduce_pairwise(const unsigned int N, const float *X) {
+  if (N <= REDUCE_BLOCK)
+    return reduce_block<square>(N, X);
+
+  /** split on a block boundary so that the leaves are full blocks */
+  unsigned int half = (N / REDUCE_BLOCK + 1) / 2 * REDUCE_BLOCK;
+  return reduce_pairwise<square>(half, X) +
+         reduce_pairwise<square>(N - half, X + half);
+}
+
+} // namespace
+
 void calc_trigonometric_vals_dup(unsigned int N_half, float *angle, float *cos_,
                                  float *sin_, unsigned int alpha) {
 #ifdef USE_NEON
@@ -68,6 +251,161 @@ void softmax(const unsigned int N, float *X, float *Y) {
 #endif
 }
 
+void softmax_row_fused(const unsigned int N, float *X, const float scale,
+                       const float *mask, const unsigned int len,
+                       const float dropout_rate, const unsigned int seed,
+                       float *D) {
+#ifdef USE_NEON
+  nntrainer::neon::softmax_row_fused(N, X, scale, mask, len, dropout_rate,
+                                     seed, D);
+#elif defined(USE_AVX)
+  nntrainer::avx::softmax_row_fused(N, X, scale, mask, len, dropout_rate, seed,
+                                    D);
+#else
+  softmax_row_fused_fallback(N, X, scale, mask, len, dropout_rate, seed, D);
+#endif
+}
+
+void softmax_row_fused_deriv(const unsigned int N, const float *P,
+                             const float *D, const float dropout_rate,
+                             float *dY, const float *dE, const float scale,
+                             float *dM) {
+#ifdef USE_NEON
+  nntrainer::neon::softmax_row_fused_deriv(N, P, D, dropout_rate, dY, dE,
+                                           scale, dM);
+#elif defined(USE_AVX)
+  nntrainer::avx::softmax_row_fused_deriv(N, P, D, dropout_rate, dY, dE, scale,
+                                          dM);
+#else
+  softmax_row_fused_deriv_fallback(N, P, D, dropout_rate, dY, dE, scale, dM);
+#endif
+}
+
+void ele_sigmoid(const unsigned int N, const float *X, float *Y) {
+#ifdef USE_NEON
+  nntrainer::neon::ele_sigmoid(N, X, Y);
+#elif defined(USE_AVX)
+  nntrainer::avx::ele_sigmoid(N, X, Y);
+#else
+  for (unsigned int i = 0; i < N; ++i)
+    Y[i] = sigmoid_scalar(X[i]);
+#endif
+}
+
+void ele_tanh(const unsigned int N, const float *X, float *Y) {
+#ifdef USE_NEON
+  nntrainer::neon::ele_tanh(N, X, Y);
+#elif defined(USE_AVX)
+  nntrainer::avx::ele_tanh(N, X, Y);
+#else
+  for (unsigned int i = 0; i < N; ++i)
+    Y[i] = 2.f * sigmoid_scalar(2.f * X[i]) - 1.f;
+#endif
+}
+
+void ele_gelu(const unsigned int N, const float *X, float *Y) {
+#ifdef USE_NEON
+  nntrainer::neon::ele_gelu(N, X, Y);
+#elif defined(USE_AVX)
+  nntrainer::avx::ele_gelu(N, X, Y);
+#else
+  constexpr float t = 0.70710678118654752f;
+  for (unsigned int i = 0; i < N; ++i)
+    Y[i] = 0.5f * X[i] * (1.f + std::erf(X[i] * t));
+#endif
+}
+
+void ele_gelu_deriv(const unsigned int N, const float *X, const float *dY,
+                    float *dX) {
+#ifdef USE_NEON
+  nntrainer::neon::ele_gelu_deriv(N, X, dY, dX);
+#elif defined(USE_AVX)
+  nntrainer::avx::ele_gelu_deriv(N, X, dY, dX);
+#else
+  for (unsigned int i = 0; i < N; ++i)
+    dX[i] = gelu_deriv_scalar(X[i]) * dY[i];
+#endif
+}
+
+void ele_swish(const unsigned int N, const float *X, float *Y) {
+#ifdef USE_NEON
+  nntrainer::neon::ele_swish(N, X, Y);
+#elif defined(USE_AVX)
+  nntrainer::avx::ele_swish(N, X, Y);
+#else
+  for (unsigned int i = 0; i < N; ++i)
+    Y[i] = X[i] * sigmoid_scalar(X[i]);
+#endif
+}
+
+void ele_swish_deriv(const unsigned int N, const float *X, const float *Y,
+                     const float *dY, float *dX) {
+#ifdef USE_NEON
+  nntrainer::neon::ele_swish_deriv(N, X, Y, dY, dX);
+#elif defined(USE_AVX)
+  nntrainer::avx::ele_swish_deriv(N, X, Y, dY, dX);
+#else
+  for (unsigned int i = 0; i < N; ++i) {
+    float s = sigmoid_scalar(X[i]);
+    dX[i] = (s * (1.f - Y[i]) + Y[i]) * dY[i];
+  }
+#endif
+}
+
+float reduce_sum(const unsigned int N, const float *X) {
+  return reduce_pairwise<false>(N, X);
+}
+
+float reduce_sum_squares(const unsigned int N, const float *X) {
+  return reduce_pairwise<true>(N, X);
+}
+
+unsigned int argmax(const unsigned int N, const float *X) {
+#ifdef USE_NEON
+  const float max_x = nntrainer::neon::max(N, const_cast<float *>(X));
+#elif defined(USE_AVX)
+  const float max_x = nntrainer::avx::reduce_max(N, X);
+#else
+  const float max_x = *std::max_element(X, X + N);
+#endif
+  /** the vectorized maximum leaves a single scan for its first position */
+  const float *found = std::find(X, X + N, max_x);
+  return found == X + N ? 0 : std::distance(X, found);
+}
+
+void ele_swiglu(const unsigned int N, const float *X, const float *G,
+                float *Y) {
+#ifdef USE_NEON
+  nntrainer::neon::ele_swiglu(N, X, G, Y);
+#elif defined(USE_AVX)
+  nntrainer::avx::ele_swiglu(N, X, G, Y);
+#else
+  ele_swiglu_fallback(N, X, G, Y);
+#endif
+}
+
+void ele_swiglu_deriv(const unsigned int N, const float *X, const float *G,
+                      const float *dY, float *dX, float *dG) {
+#ifdef USE_NEON
+  nntrainer::neon::ele_swiglu_deriv(N, X, G, dY, dX, dG);
+#elif defined(USE_AVX)
+  nntrainer::avx::ele_swiglu_deriv(N, X, G, dY, dX, dG);
+#else
+  ele_swiglu_deriv_fallback(N, X, G, dY, dX, dG);
+#endif
+}
+
+void rotary_emb(const unsigned int half, float *X, const float *cos_,
+                const float *sin_, bool inverse) {
+#ifdef USE_NEON
+  nntrainer::neon::rotary_emb(half, X, cos_, sin_, inverse);
+#elif defined(USE_AVX)
+  nntrainer::avx::rotary_emb(half, X, cos_, sin_, inverse);
+#else
+  rotary_emb_fallback(half, X, cos_, sin_, inverse);
+#endif
+}
+
 #ifdef ENABLE_FP16
 
 void compute_rotary_embedding_value(unsigned int dim, unsigned int half_,
@@ -124,6 +462,47 @@ void softmax(const unsigned int N, _FP16 *X, _FP16 *Y) {
   }
 #endif
 }
+
+void softmax_row_fused(const unsigned int N, _FP16 *X, const float scale,
+                       const _FP16 *mask, const unsigned int len,
+                       const float dropout_rate, const unsigned int seed,
+                       _FP16 *D) {
+  softmax_row_fused_fallback(N, X, scale, mask, len, dropout_rate, seed, D);
+}
+
+void softmax_row_fused_deriv(const unsigned int N, const _FP16 *P,
+                             const _FP16 *D, const float dropout_rate,
+                             _FP16 *dY, const _FP16 *dE, const float scale,
+                             _FP16 *dM) {
+  softmax_row_fused_deriv_fallback(N, P, D, dropout_rate, dY, dE, scale, dM);
+}
+
+void ele_swiglu(const unsigned int N, const _FP16 *X, const _FP16 *G,
+                _FP16 *Y) {
+#ifdef USE_NEON
+  nntrainer::neon::ele_swiglu(N, X, G, Y);
+#else
+  ele_swiglu_fallback(N, X, G, Y);
+#endif
+}
+
+void ele_swiglu_deriv(const unsigned int N, const _FP16 *X, const _FP16 *G,
+                      const _FP16 *dY, _FP16 *dX, _FP16 *dG) {
+#ifdef USE_NEON
+  nntrainer::neon::ele_swiglu_deriv(N, X, G, dY, dX, dG);
+#else
+  ele_swiglu_deriv_fallback(N, X, G, dY, dX, dG);
+#endif
+}
+
+void rotary_emb(const unsigned int half, _FP16 *X, const float *cos_,
+                const float *sin_, bool inverse) {
+#ifdef USE_NEON
+  nntrainer::neon::rotary_emb(half, X, cos_, sin_, inverse);
+#else
+  rotary_emb_fallback(half, X, cos_, sin_, inverse);
+#endif
+}
 #endif
 
 } // namespace nntrainer
@@ -59,6 +59,187 @@ float max(const unsigned int N, float *X);
  */
 void softmax(const unsigned int N, float *X, float *Y);
 
+/**
+ * @brief derive a non-zero xorshift32 state from a seed (murmur3 finalizer)
+ *
+ * @param seed seed value
+ * @return unsigned int initial state of the generator
+ */
+inline unsigned int xorshift_seed(unsigned int seed) {
+  seed ^= seed >> 16;
+  seed *= 0x85ebca6bu;
+  seed ^= seed >> 13;
+  seed *= 0xc2b2ae35u;
+  seed ^= seed >> 16;
+  return seed ? seed : 0x9e3779b9u;
+}
+
+/**
+ * @brief fused attention softmax of a single row : P = softmax(X * scale +
+ * mask), where the elements from @a len on are masked out (causal mask), and
+ * optionally D = dropout(P) with an inline random number generator. The row is
+ * read once and written once (twice when dropout is applied).
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X, overwritten by P
+ * @param scale scale factor multiplied to X
+ * @param mask float * additive mask for Vector X, nullptr if not masked
+ * @param len number of leading elements of X that are visible
+ * @param dropout_rate dropout rate, dropout is not applied if 0
+ * @param seed seed of the random number generator for this row
+ * @param D float * for dropped out Vector P, nullptr if dropout_rate is 0
+ */
+void softmax_row_fused(const unsigned int N, float *X, const float scale,
+                       const float *mask, const unsigned int len,
+                       const float dropout_rate, const unsigned int seed,
+                       float *D);
+
+/**
+ * @brief derivative of softmax_row_fused : dX = P * (dP - sum(P * dP)) *
+ * scale, where dP = dropout'(dY) + dE
+ *
+ * @param N number of elements in P
+ * @param P float * for softmax output of the row
+ * @param D float * for dropped out P, nullptr if dropout is not applied
+ * @param dropout_rate dropout rate used in the forward pass
+ * @param dY float * for incoming derivative, overwritten by dX
+ * @param dE float * for extra derivative added after dropout, nullable
+ * @param scale scale factor used in the forward pass
+ * @param dM float * for the derivative of the additive mask, nullable
+ */
+void softmax_row_fused_deriv(const unsigned int N, const float *P,
+                             const float *D, const float dropout_rate,
+                             float *dY, const float *dE, const float scale,
+                             float *dM);
+
+/**
+ * @brief sigmoid of each element : Y = 1 / (1 + exp(-X))
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @param Y float * for Vector Y, may be X
+ */
+void ele_sigmoid(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief tanh of each element : Y = 2 * sigmoid(2 * X) - 1
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @param Y float * for Vector Y, may be X
+ */
+void ele_tanh(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief gelu of each element : Y = 0.5 * X * (1 + erf(X / sqrt(2)))
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @param Y float * for Vector Y, may be X
+ */
+void ele_gelu(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief derivative of gelu multiplied by the incoming derivative : dX =
+ * gelu'(X) * dY
+ *
+ * @param N number of elements in X
+ * @param X float * for the input of gelu
+ * @param dY float * for incoming derivative
+ * @param dX float * for outgoing derivative, may be dY
+ */
+void ele_gelu_deriv(const unsigned int N, const float *X, const float *dY,
+                    float *dX);
+
+/**
+ * @brief swish of each element : Y = X * sigmoid(X)
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @param Y float * for Vector Y, may be X
+ */
+void ele_swish(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief derivative of swish multiplied by the incoming derivative : dX =
+ * (sigmoid(X) * (1 - Y) + Y) * dY
+ *
+ * @param N number of elements in X
+ * @param X float * for the input of swish
+ * @param Y float * for the output of swish
+ * @param dY float * for incoming derivative
+ * @param dX float * for outgoing derivative, may be dY
+ */
+void ele_swish_deriv(const unsigned int N, const float *X, const float *Y,
+                     const float *dY, float *dX);
+
+/**
+ * @brief sum of the elements by pairwise summation, the rounding error grows
+ * with log(N) instead of N
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @return float sum of X
+ */
+float reduce_sum(const unsigned int N, const float *X);
+
+/**
+ * @brief sum of the squared elements by pairwise summation
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @return float sum of X * X
+ */
+float reduce_sum_squares(const unsigned int N, const float *X);
+
+/**
+ * @brief index of the first maximum of the vector X
+ *
+ * @param N number of elements in X, larger than 0
+ * @param X float * for Vector X
+ * @return unsigned int index of the maximum
+ */
+unsigned int argmax(const unsigned int N, const float *X);
+
+/**
+ * @brief gated swish of each element : Y = X * sigmoid(X) * G
+ *
+ * @param N number of elements in X
+ * @param X float * for the input of swish
+ * @param G float * for the gate
+ * @param Y float * for Vector Y, may be X or G
+ */
+void ele_swiglu(const unsigned int N, const float *X, const float *G,
+                float *Y);
+
+/**
+ * @brief derivative of ele_swiglu : dX = (s + X * s * (1 - s)) * G * dY and
+ * dG = X * s * dY where s = sigmoid(X)
+ *
+ * @param N number of elements in X
+ * @param X float * for the input of swish
+ * @param G float * for the gate
+ * @param dY float * for incoming derivative
+ * @param dX float * for outgoing derivative of X, may be dY
+ * @param dG float * for outgoing derivative of G, may be dY
+ */
+void ele_swiglu_deriv(const unsigned int N, const float *X, const float *G,
+                      const float *dY, float *dX, float *dG);
+
+/**
+ * @brief rotate the pairs (X[i], X[i + half]) of a head in place by the
+ * angles of a position : X[i] = X[i] * cos - X[i + half] * sin and
+ * X[i + half] = X[i + half] * cos + X[i] * sin
+ *
+ * @param half half of the head dimension
+ * @param X float * for the head of 2 * half elements
+ * @param cos_ cosine of the angles, half elements
+ * @param sin_ sine of the angles, half elements
+ * @param inverse rotate by the negated angles, which gives the derivative
+ */
+void rotary_emb(const unsigned int half, float *X, const float *cos_,
+                const float *sin_, bool inverse = false);
+
 #ifdef ENABLE_FP16
 /**
  * @brief Accelerating function for rotary embedding layer forwarding
@@ -103,6 +284,79 @@ _FP16 max(const unsigned int N, _FP16 *X);
  * @param Y  _FP16 * for Vector Y
  */
 void softmax(const unsigned int N, _FP16 *X, _FP16 *Y);
+
+/**
+ * @brief fused attention softmax of a single row. Note that half-precision
+ * values are accumulated with single-precision
+ *
+ * @param N number of elements in X
+ * @param X _FP16 * for Vector X, overwritten by P
+ * @param scale scale factor multiplied to X
+ * @param mask _FP16 * additive mask for Vector X, nullptr if not masked
+ * @param len number of leading elements of X that are visible
+ * @param dropout_rate dropout rate, dropout is not applied if 0
+ * @param seed seed of the random number generator for this row
+ * @param D _FP16 * for dropped out Vector P, nullptr if dropout_rate is 0
+ */
+void softmax_row_fused(const unsigned int N, _FP16 *X, const float scale,
+                       const _FP16 *mask, const unsigned int len,
+                       const float dropout_rate, const unsigned int seed,
+                       _FP16 *D);
+
+/**
+ * @brief derivative of softmax_row_fused for half-precision
+ *
+ * @param N number of elements in P
+ * @param P _FP16 * for softmax output of the row
+ * @param D _FP16 * for dropped out P, nullptr if dropout is not applied
+ * @param dropout_rate dropout rate used in the forward pass
+ * @param dY _FP16 * for incoming derivative, overwritten by dX
+ * @param dE _FP16 * for extra derivative added after dropout, nullable
+ * @param scale scale factor used in the forward pass
+ * @param dM _FP16 * for the derivative of the additive mask, nullable
+ */
+void softmax_row_fused_deriv(const unsigned int N, const _FP16 *P,
+                             const _FP16 *D, const float dropout_rate,
+                             _FP16 *dY, const _FP16 *dE, const float scale,
+                             _FP16 *dM);
+
+/**
+ * @brief gated swish of each element for half-precision, computed with
+ * single-precision
+ *
+ * @param N number of elements in X
+ * @param X _FP16 * for the input of swish
+ * @param G _FP16 * for the gate
+ * @param Y _FP16 * for Vector Y, may be X or G
+ */
+void ele_swiglu(const unsigned int N, const _FP16 *X, const _FP16 *G,
+                _FP16 *Y);
+
+/**
+ * @brief derivative of ele_swiglu for half-precision
+ *
+ * @param N number of elements in X
+ * @param X _FP16 * for the input of swish
+ * @param G _FP16 * for the gate
+ * @param dY _FP16 * for incoming derivative
+ * @param dX _FP16 * for outgoing derivative of X, may be dY
+ * @param dG _FP16 * for outgoing derivative of G, may be dY
+ */
+void ele_swiglu_deriv(const unsigned int N, const _FP16 *X, const _FP16 *G,
+                      const _FP16 *dY, _FP16 *dX, _FP16 *dG);
+
+/**
+ * @brief rotate the pairs of a half-precision head in place, computed with
+ * single-precision
+ *
+ * @param half half of the head dimension
+ * @param X _FP16 * for the head of 2 * half elements
+ * @param cos_ cosine of the angles, half elements
+ * @param sin_ sine of the angles, half elements
+ * @param inverse rotate by the negated angles, which gives the derivative
+ */
+void rotary_emb(const unsigned int half, _FP16 *X, const float *cos_,
+                const float *sin_, bool inverse = false);
 #endif
 
 } /* namespace nntrainer */
@@ -0,0 +1,444 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file	util_simd_avx.cpp
+ * @date	16 Oct 2026
+ * @brief	This is a collection of simd util avx2 functions
+ * @see		https://github.com/nnstreamer/nntrainer
+ * @author	agent <agent@local>
+ * @bug		No known bugs except for NYI items
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <immintrin.h>
+#include <limits>
+
+#include <util_simd.h>
+#include <util_simd_avx.h>
+
+namespace nntrainer::avx {
+
+namespace {
+
+/**
+ * @brief exponential of 8 single-precision values (cephes polynomial)
+ */
+inline __m256 exp_ps(__m256 x) {
+  const __m256 one = _mm256_set1_ps(1.f);
+  x = _mm256_min_ps(x, _mm256_set1_ps(88.3762626647949f));
+  x = _mm256_max_ps(x, _mm256_set1_ps(-88.3762626647949f));
+
+  /** exp(x) = exp(g + n * log(2)) */
+  __m256 fx = _mm256_fmadd_ps(x, _mm256_set1_ps(1.44269504088896341f),
+                              _mm256_set1_ps(0.5f));
+  fx = _mm256_floor_ps(fx);
+  x = _mm256_fnmadd_ps(fx, _mm256_set1_ps(0.693359375f), x);
+  x = _mm256_fnmadd_ps(fx, _mm256_set1_ps(-2.12194440e-4f), x);
+
+  __m256 y = _mm256_set1_ps(1.9875691500E-4f);
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.3981999507E-3f));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(8.3334519073E-3f));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(4.1665795894E-2f));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.6666665459E-1f));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(5.0000001201E-1f));
+  y = _mm256_fmadd_ps(y, _mm256_mul_ps(x, x), _mm256_add_ps(x, one));
+
+  __m256i n = _mm256_add_epi32(_mm256_cvttps_epi32(fx), _mm256_set1_epi32(127));
+  return _mm256_mul_ps(y, _mm256_castsi256_ps(_mm256_slli_epi32(n, 23)));
+}
+
+/**
+ * @brief horizontal sum of 8 single-precision values
+ */
+inline float hsum_ps(__m256 v) {
+  __m128 lo = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+  lo = _mm_add_ss(lo, _mm_movehdup_ps(lo));
+  return _mm_cvtss_f32(lo);
+}
+
+/**
+ * @brief horizontal max of 8 single-precision values
+ */
+inline float hmax_ps(__m256 v) {
+  __m128 lo = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  lo = _mm_max_ps(lo, _mm_movehl_ps(lo, lo));
+  lo = _mm_max_ss(lo, _mm_movehdup_ps(lo));
+  return _mm_cvtss_f32(lo);
+}
+
+/**
+ * @brief sigmoid of 8 single-precision values
+ */
+inline __m256 sigmoid_ps(__m256 x) {
+  const __m256 one = _mm256_set1_ps(1.f);
+  return _mm256_div_ps(
+    one, _mm256_add_ps(one, exp_ps(_mm256_sub_ps(_mm256_setzero_ps(), x))));
+}
+
+/**
+ * @brief erf of 8 single-precision values (Abramowitz and Stegun 7.1.26,
+ * absolute error below 1.5e-7)
+ */
+inline __m256 erf_ps(__m256 x) {
+  const __m256 sign_mask = _mm256_set1_ps(-0.f);
+  const __m256 one = _mm256_set1_ps(1.f);
+  __m256 sign = _mm256_and_ps(x, sign_mask);
+  __m256 a = _mm256_andnot_ps(sign_mask, x);
+
+  __m256 t = _mm256_div_ps(
+    one, _mm256_fmadd_ps(_mm256_set1_ps(0.3275911f), a, one));
+  __m256 y = _mm256_set1_ps(1.061405429f);
+  y = _mm256_fmadd_ps(y, t, _mm256_set1_ps(-1.453152027f));
+  y = _mm256_fmadd_ps(y, t, _mm256_set1_ps(1.421413741f));
+  y = _mm256_fmadd_ps(y, t, _mm256_set1_ps(-0.284496736f));
+  y = _mm256_fmadd_ps(y, t, _mm256_set1_ps(0.254829592f));
+  y = _mm256_mul_ps(y, t);
+
+  __m256 e = exp_ps(_mm256_sub_ps(_mm256_setzero_ps(), _mm256_mul_ps(a, a)));
+  y = _mm256_fnmadd_ps(y, e, one);
+  return _mm256_or_ps(y, sign);
+}
+
+} // namespace
+
+void softmax_row_fused(const unsigned int N, float *X, const float scale,
+                       const float *mask, const unsigned int len,
+                       const float dropout_rate, const unsigned int seed,
+                       float *D) {
+  unsigned int i = 0;
+  float max_x = -std::numeric_limits<float>::infinity();
+  const __m256 scale_v = _mm256_set1_ps(scale);
+  __m256 max_v = _mm256_set1_ps(max_x);
+  for (; len - i >= 8; i += 8) {
+    __m256 x = _mm256_mul_ps(_mm256_loadu_ps(&X[i]), scale_v);
+    if (mask)
+      x = _mm256_add_ps(x, _mm256_loadu_ps(&mask[i]));
+    _mm256_storeu_ps(&X[i], x);
+    max_v = _mm256_max_ps(max_v, x);
+  }
+  max_x = hmax_ps(max_v);
+  for (; i < len; ++i) {
+    X[i] = X[i] * scale + (mask ? mask[i] : 0.f);
+    max_x = std::fmax(max_x, X[i]);
+  }
+
+  i = 0;
+  __m256 sum_v = _mm256_setzero_ps();
+  max_v = _mm256_set1_ps(max_x);
+  for (; len - i >= 8; i += 8) {
+    __m256 e = exp_ps(_mm256_sub_ps(_mm256_loadu_ps(&X[i]), max_v));
+    _mm256_storeu_ps(&X[i], e);
+    sum_v = _mm256_add_ps(sum_v, e);
+  }
+  float sum = hsum_ps(sum_v);
+  for (; i < len; ++i) {
+    X[i] = std::exp(X[i] - max_x);
+    sum += X[i];
+  }
+
+  i = 0;
+  const float inv_sum = sum > 0.f ? 1.f / sum : 0.f;
+  const __m256 inv_sum_v = _mm256_set1_ps(inv_sum);
+  if (D) {
+    const float keep_scale = 1.f / (1.f - dropout_rate);
+    const __m256 keep_v = _mm256_set1_ps(keep_scale);
+    const __m256 rate_v = _mm256_set1_ps(dropout_rate);
+    const __m256 norm_v = _mm256_set1_ps(1.f / 16777216.f);
+    __m256i state = _mm256_setr_epi32(
+      xorshift_seed(seed), xorshift_seed(seed + 1), xorshift_seed(seed + 2),
+      xorshift_seed(seed + 3), xorshift_seed(seed + 4), xorshift_seed(seed + 5),
+      xorshift_seed(seed + 6), xorshift_seed(seed + 7));
+    for (; len - i >= 8; i += 8) {
+      state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 13));
+      state = _mm256_xor_si256(state, _mm256_srli_epi32(state, 17));
+      state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 5));
+      __m256 u =
+        _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(state, 8)), norm_v);
+      __m256 p = _mm256_mul_ps(_mm256_loadu_ps(&X[i]), inv_sum_v);
+      _mm256_storeu_ps(&X[i], p);
+      _mm256_storeu_ps(&D[i], _mm256_and_ps(_mm256_cmp_ps(u, rate_v, _CMP_GE_OQ),
+                                            _mm256_mul_ps(p, keep_v)));
+    }
+    unsigned int s = (unsigned int)_mm256_extract_epi32(state, 0);
+    for (; i < len; ++i) {
+      s ^= s << 13;
+      s ^= s >> 17;
+      s ^= s << 5;
+      X[i] *= inv_sum;
+      D[i] = (s >> 8) * (1.f / 16777216.f) >= dropout_rate ? X[i] * keep_scale
+                                                            : 0.f;
+    }
+  } else {
+    for (; len - i >= 8; i += 8)
+      _mm256_storeu_ps(&X[i], _mm256_mul_ps(_mm256_loadu_ps(&X[i]), inv_sum_v));
+    for (; i < len; ++i)
+      X[i] *= inv_sum;
+  }
+
+  for (i = len; i < N; ++i) {
+    X[i] = 0.f;
+    if (D)
+      D[i] = 0.f;
+  }
+}
+
+void softmax_row_fused_deriv(const unsigned int N, const float *P,
+                             const float *D, const float dropout_rate,
+                             float *dY, const float *dE, const float scale,
+                             float *dM) {
+  const float keep_scale = D ? 1.f / (1.f - dropout_rate) : 1.f;
+  const __m256 keep_v = _mm256_set1_ps(keep_scale);
+  const __m256 zero_v = _mm256_setzero_ps();
+
+  auto dP_v = [&](unsigned int i) {
+    __m256 dp = _mm256_loadu_ps(&dY[i]);
+    if (D)
+      dp = _mm256_and_ps(
+        _mm256_cmp_ps(_mm256_loadu_ps(&D[i]), zero_v, _CMP_NEQ_UQ),
+        _mm256_mul_ps(dp, keep_v));
+    if (dE)
+      dp = _mm256_add_ps(dp, _mm256_loadu_ps(&dE[i]));
+    return dp;
+  };
+  auto dP = [&](unsigned int i) {
+    float dp = dY[i];
+    if (D)
+      dp = D[i] != 0.f ? dp * keep_scale : 0.f;
+    if (dE)
+      dp += dE[i];
+    return dp;
+  };
+
+  unsigned int i = 0;
+  __m256 dot_v = _mm256_setzero_ps();
+  for (; N - i >= 8; i += 8)
+    dot_v = _mm256_fmadd_ps(_mm256_loadu_ps(&P[i]), dP_v(i), dot_v);
+  float dot = hsum_ps(dot_v);
+  for (; i < N; ++i)
+    dot += P[i] * dP(i);
+
+  i = 0;
+  const __m256 dot_b = _mm256_set1_ps(dot);
+  const __m256 scale_v = _mm256_set1_ps(scale);
+  for (; N - i >= 8; i += 8) {
+    __m256 dx =
+      _mm256_mul_ps(_mm256_loadu_ps(&P[i]), _mm256_sub_ps(dP_v(i), dot_b));
+    if (dM)
+      _mm256_storeu_ps(&dM[i], dx);
+    _mm256_storeu_ps(&dY[i], _mm256_mul_ps(dx, scale_v));
+  }
+  for (; i < N; ++i) {
+    float dx = P[i] * (dP(i) - dot);
+    if (dM)
+      dM[i] = dx;
+    dY[i] = dx * scale;
+  }
+}
+
+void ele_sigmoid(const unsigned int N, const float *X, float *Y) {
+  unsigned int i = 0;
+  for (; N - i >= 8; i += 8)
+    _mm256_storeu_ps(&Y[i], sigmoid_ps(_mm256_loadu_ps(&X[i])));
+  for (; i < N; ++i)
+    Y[i] = 1.f / (1.f + std::exp(-X[i]));
+}
+
+void ele_tanh(const unsigned int N, const float *X, float *Y) {
+  const __m256 one = _mm256_set1_ps(1.f);
+  const __m256 two = _mm256_set1_ps(2.f);
+  unsigned int i = 0;
+  for (; N - i >= 8; i += 8) {
+    __m256 s = sigmoid_ps(_mm256_mul_ps(two, _mm256_loadu_ps(&X[i])));
+    _mm256_storeu_ps(&Y[i], _mm256_fmsub_ps(two, s, one));
+  }
+  for (; i < N; ++i)
+    Y[i] = 2.f / (1.f + std::exp(-2.f * X[i])) - 1.f;
+}
+
+void ele_gelu(const unsigned int N, const float *X, float *Y) {
+  constexpr float t = 0.70710678118654752f; /**< 1 / sqrt(2) */
+  const __m256 half = _mm256_set1_ps(0.5f);
+  const __m256 t_v = _mm256_set1_ps(t);
+  unsigned int i = 0;
+  for (; N - i >= 8; i += 8) {
+    __m256 x = _mm256_loadu_ps(&X[i]);
+    __m256 e = erf_ps(_mm256_mul_ps(x, t_v));
+    __m256 hx = _mm256_mul_ps(half, x);
+    _mm256_storeu_ps(&Y[i], _mm256_fmadd_ps(hx, e, hx));
+  }
+  for (; i < N; ++i)
+    Y[i] = 0.5f * X[i] * (1.f + std::erf(X[i] * t));
+}
+
+void ele_gelu_deriv(const unsigned int N, const float *X, const float *dY,
+                    float *dX) {
+  constexpr float t = 0.70710678118654752f; /**< 1 / sqrt(2) */
+  constexpr float c = 1.12837916709551257f; /**< 2 / sqrt(pi) */
+  const __m256 half = _mm256_set1_ps(0.5f);
+  const __m256 t_v = _mm256_set1_ps(t);
+  const __m256 ct_v = _mm256_set1_ps(c * t);
+  unsigned int i = 0;
+  for (; N - i >= 8; i += 8) {
+    __m256 x = _mm256_loadu_ps(&X[i]);
+    __m256 xt = _mm256_mul_ps(x, t_v);
+    __m256 e =
+      exp_ps(_mm256_sub_ps(_mm256_setzero_ps(), _mm256_mul_ps(xt, xt)));
+    /** 0.5 * (1 + erf(xt) + x * c * t * exp(-xt^2)) */
+    __m256 d = _mm256_add_ps(_mm256_set1_ps(1.f), erf_ps(xt));
+    d = _mm256_fmadd_ps(_mm256_mul_ps(x, ct_v), e, d);
+    d = _mm256_mul_ps(half, d);
+    _mm256_storeu_ps(&dX[i], _mm256_mul_ps(d, _mm256_loadu_ps(&dY[i])));
+  }
+  for (; i < N; ++i) {
+    float xt = X[i] * t;
+    float d =
+      0.5f * (1.f + std::erf(xt) + X[i] * c * t * std::exp(-xt * xt));
+    dX[i] = d * dY[i];
+  }
+}
+
+void ele_swish(const unsigned int N, const float *X, float *Y) {
+  unsigned int i = 0;
+  for (; N - i >= 8; i += 8) {
+    __m256 x = _mm256_loadu_ps(&X[i]);
+    _mm256_storeu_ps(&Y[i], _mm256_mul_ps(x, sigmoid_ps(x)));
+  }
+  for (; i < N; ++i)
+    Y[i] = X[i] / (1.f + std::exp(-X[i]));
+}
+
+void ele_swish_deriv(const unsigned int N, const float *X, const float *Y,
+                     const float *dY, float *dX) {
+  const __m256 one = _mm256_set1_ps(1.f);
+  unsigned int i = 0;
+  for (; N - i >= 8; i += 8) {
+    __m256 s = sigmoid_ps(_mm256_loadu_ps(&X[i]));
+    __m256 y = _mm256_loadu_ps(&Y[i]);
+    __m256 d = _mm256_fmadd_ps(s, _mm256_sub_ps(one, y), y);
+    _mm256_storeu_ps(&dX[i], _mm256_mul_ps(d, _mm256_loadu_ps(&dY[i])));
+  }
+  for (; i < N; ++i) {
+    float s = 1.f / (1.f + std::exp(-X[i]));
+    dX[i] = (s * (1.f - Y[i]) + Y[i]) * dY[i];
+  }
+}
+
+float reduce_sum(const unsigned int N, const float *X) {
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  unsigned int i = 0;
+  for (; N - i >= 16; i += 16) {
+    acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(&X[i]));
+    acc1 = _mm256_add_ps(acc1, _mm256_loadu_ps(&X[i + 8]));
+  }
+  if (N - i >= 8) {
+    acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(&X[i]));
+    i += 8;
+  }
+  float sum = hsum_ps(_mm256_add_ps(acc0, acc1));
+  for (; i < N; ++i)
+    sum += X[i];
+  return sum;
+}
+
+float reduce_sum_squares(const unsigned int N, const float *X) {
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  unsigned int i = 0;
+  for (; N - i >= 16; i += 16) {
+    __m256 x0 = _mm256_loadu_ps(&X[i]);
+    __m256 x1 = _mm256_loadu_ps(&X[i + 8]);
+    acc0 = _mm256_fmadd_ps(x0, x0, acc0);
+    acc1 = _mm256_fmadd_ps(x1, x1, acc1);
+  }
+  if (N - i >= 8) {
+    __m256 x0 = _mm256_loadu_ps(&X[i]);
+    acc0 = _mm256_fmadd_ps(x0, x0, acc0);
+    i += 8;
+  }
+  float sum = hsum_ps(_mm256_add_ps(acc0, acc1));
+  for (; i < N; ++i)
+    sum += X[i] * X[i];
+  return sum;
+}
+
+float reduce_max(const unsigned int N, const float *X) {
+  float max_x = -std::numeric_limits<float>::infinity();
+  unsigned int i = 0;
+  if (N >= 16) {
+    __m256 max0 = _mm256_loadu_ps(&X[0]);
+    __m256 max1 = _mm256_loadu_ps(&X[8]);
+    for (i = 16; N - i >= 16; i += 16) {
+      max0 = _mm256_max_ps(max0, _mm256_loadu_ps(&X[i]));
+      max1 = _mm256_max_ps(max1, _mm256_loadu_ps(&X[i + 8]));
+    }
+    max_x = hmax_ps(_mm256_max_ps(max0, max1));
+  }
+  for (; i < N; ++i)
+    max_x = std::max(max_x, X[i]);
+  return max_x;
+}
+
+void ele_swiglu(const unsigned int N, const float *X, const float *G,
+                float *Y) {
+  unsigned int i = 0;
+  for (; N - i >= 8; i += 8) {
+    __m256 x = _mm256_loadu_ps(&X[i]);
+    __m256 sw = _mm256_mul_ps(x, sigmoid_ps(x));
+    _mm256_storeu_ps(&Y[i], _mm256_mul_ps(sw, _mm256_loadu_ps(&G[i])));
+  }
+  for (; i < N; ++i)
+    Y[i] = X[i] / (1.f + std::exp(-X[i])) * G[i];
+}
+
+void ele_swiglu_deriv(const unsigned int N, const float *X, const float *G,
+                      const float *dY, float *dX, float *dG) {
+  const __m256 one = _mm256_set1_ps(1.f);
+  unsigned int i = 0;
+  for (; N - i >= 8; i += 8) {
+    __m256 x = _mm256_loadu_ps(&X[i]);
+    __m256 dy = _mm256_loadu_ps(&dY[i]);
+    __m256 s = sigmoid_ps(x);
+    __m256 sw = _mm256_mul_ps(x, s);
+    /** s + sw * (1 - s) */
+    __m256 d = _mm256_fmadd_ps(sw, _mm256_sub_ps(one, s), s);
+    __m256 dx = _mm256_mul_ps(d, _mm256_mul_ps(_mm256_loadu_ps(&G[i]), dy));
+    _mm256_storeu_ps(&dG[i], _mm256_mul_ps(sw, dy));
+    _mm256_storeu_ps(&dX[i], dx);
+  }
+  for (; i < N; ++i) {
+    float s = 1.f / (1.f + std::exp(-X[i]));
+    float sw = X[i] * s;
+    float dy = dY[i];
+    float dx = (s + sw * (1.f - s)) * G[i] * dy;
+    dG[i] = sw * dy;
+    dX[i] = dx;
+  }
+}
+
+void rotary_emb(const unsigned int half, float *X, const float *cos_,
+                const float *sin_, bool inverse) {
+  const float sign = inverse ? -1.f : 1.f;
+  const __m256 sign_v = _mm256_set1_ps(sign);
+  float *X2 = X + half;
+  unsigned int i = 0;
+  for (; half - i >= 8; i += 8) {
+    __m256 x1 = _mm256_loadu_ps(&X[i]);
+    __m256 x2 = _mm256_loadu_ps(&X2[i]);
+    __m256 c = _mm256_loadu_ps(&cos_[i]);
+    __m256 s = _mm256_mul_ps(_mm256_loadu_ps(&sin_[i]), sign_v);
+    _mm256_storeu_ps(&X[i], _mm256_fnmadd_ps(x2, s, _mm256_mul_ps(x1, c)));
+    _mm256_storeu_ps(&X2[i], _mm256_fmadd_ps(x1, s, _mm256_mul_ps(x2, c)));
+  }
+  for (; i < half; ++i) {
+    float x1 = X[i], x2 = X2[i], s = sin_[i] * sign;
+    X[i] = x1 * cos_[i] - x2 * s;
+    X2[i] = x2 * cos_[i] + x1 * s;
+  }
+}
+
+} // namespace nntrainer::avx
@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file	util_simd_avx.h
+ * @date	16 Oct 2026
+ * @brief	This is a collection of simd util avx2 functions
+ * @see		https://github.com/nnstreamer/nntrainer
+ * @author	agent <agent@local>
+ * @bug		No known bugs except for NYI items
+ */
+
+#ifndef __UTIL_SIMD_AVX_H__
+#define __UTIL_SIMD_AVX_H__
+
+#ifdef __cplusplus
+
+namespace nntrainer::avx {
+
+/**
+ * @brief fused attention softmax of a single row with AVX2 : P = softmax(X *
+ * scale + mask) over the first len elements, D = dropout(P)
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X, overwritten by P
+ * @param scale scale factor multiplied to X
+ * @param mask float * additive mask for Vector X, nullptr if not masked
+ * @param len number of leading elements of X that are visible
+ * @param dropout_rate dropout rate, dropout is not applied if 0
+ * @param seed seed of the random number generator for this row
+ * @param D float * for dropped out Vector P, nullptr if dropout_rate is 0
+ */
+void softmax_row_fused(const unsigned int N, float *X, const float scale,
+                       const float *mask, const unsigned int len,
+                       const float dropout_rate, const unsigned int seed,
+                       float *D);
+
+/**
+ * @brief derivative of softmax_row_fused with AVX2
+ *
+ * @param N number of elements in P
+ * @param P float * for softmax output of the row
+ * @param D float * for dropped out P, nullptr if dropout is not applied
+ * @param dropout_rate dropout rate used in the forward pass
+ * @param dY float * for incoming derivative, overwritten by dX
+ * @param dE float * for extra derivative added after dropout, nullable
+ * @param scale scale factor used in the forward pass
+ * @param dM float * for the derivative of the additive mask, nullable
+ */
+void softmax_row_fused_deriv(const unsigned int N, const float *P,
+                             const float *D, const float dropout_rate,
+                             float *dY, const float *dE, const float scale,
+                             float *dM);
+
+/**
+ * @brief sigmoid of each element with AVX2
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @param Y float * for Vector Y
+ */
+void ele_sigmoid(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief tanh of each element with AVX2
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @param Y float * for Vector Y
+ */
+void ele_tanh(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief gelu of each element with AVX2
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @param Y float * for Vector Y
+ */
+void ele_gelu(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief derivative of gelu multiplied by the incoming derivative with AVX2
+ *
+ * @param N number of elements in X
+ * @param X float * for the input of gelu
+ * @param dY float * for incoming derivative
+ * @param dX float * for outgoing derivative
+ */
+void ele_gelu_deriv(const unsigned int N, const float *X, const float *dY,
+                    float *dX);
+
+/**
+ * @brief swish of each element with AVX2
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @param Y float * for Vector Y
+ */
+void ele_swish(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief derivative of swish multiplied by the incoming derivative with AVX2
+ *
+ * @param N number of elements in X
+ * @param X float * for the input of swish
+ * @param Y float * for the output of swish
+ * @param dY float * for incoming derivative
+ * @param dX float * for outgoing derivative
+ */
+void ele_swish_deriv(const unsigned int N, const float *X, const float *Y,
+                     const float *dY, float *dX);
+
+/**
+ * @brief sum of the elements with AVX2
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @return float sum of X
+ */
+float reduce_sum(const unsigned int N, const float *X);
+
+/**
+ * @brief sum of the squared elements with AVX2
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @return float sum of X * X
+ */
+float reduce_sum_squares(const unsigned int N, const float *X);
+
+/**
+ * @brief maximum of the elements with AVX2
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @return float maximum of X, -inf if N is 0
+ */
+float reduce_max(const unsigned int N, const float *X);
+
+/**
+ * @brief gated swish of each element with AVX2
+ *
+ * @param N number of elements in X
+ * @param X float * for the input of swish
+ * @param G float * for the gate
+ * @param Y float * for Vector Y
+ */
+void ele_swiglu(const unsigned int N, const float *X, const float *G,
+                float *Y);
+
+/**
+ * @brief derivative of the gated swish with AVX2
+ *
+ * @param N number of elements in X
+ * @param X float * for the input of swish
+ * @param G float * for the gate
+ * @param dY float * for incoming derivative
+ * @param dX float * for outgoing derivative of X
+ * @param dG float * for outgoing derivative of G
+ */
+void ele_swiglu_deriv(const unsigned int N, const float *X, const float *G,
+                      const float *dY, float *dX, float *dG);
+
+/**
+ * @brief rotate the pairs of a head in place with AVX2
+ *
+ * @param half half of the head dimension
+ * @param X float * for the head
+ * @param cos_ cosine of the angles
+ * @param sin_ sine of the angles
+ * @param inverse rotate by the negated angles if true
+ */
+void rotary_emb(const unsigned int half, float *X, const float *cos_,
+                const float *sin_, bool inverse);
+
+} // namespace nntrainer::avx
+
+#endif /* __cplusplus */
+#endif /* __UTIL_SIMD_AVX_H__ */
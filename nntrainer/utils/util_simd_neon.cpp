@@ -9,6 +9,8 @@
  */
 
 #include <blas_neon.h>
+#include <limits>
+#include <util_simd.h>
 #include <util_simd_neon.h>
 
 namespace nntrainer::neon {
@@ -111,6 +113,380 @@ void exp_i(const unsigned int N, float *X) {
   }
 }
 
+void softmax_row_fused(const unsigned int N, float *X, const float scale,
+                       const float *mask, const unsigned int len,
+                       const float dropout_rate, const unsigned int seed,
+                       float *D) {
+  unsigned int i = 0;
+  float max_x = -std::numeric_limits<float>::infinity();
+  float32x4_t max_v = vmovq_n_f32(max_x);
+  for (; len - i >= VL_FP32; i += VL_FP32) {
+    float32x4_t x0_3 = vmulq_n_f32(vld1q_f32(&X[i]), scale);
+    if (mask)
+      x0_3 = vaddq_f32(x0_3, vld1q_f32(&mask[i]));
+    vst1q_f32(&X[i], x0_3);
+    max_v = vmaxq_f32(max_v, x0_3);
+  }
+  max_x = vmaxvq_f32(max_v);
+  for (; i < len; ++i) {
+    X[i] = X[i] * scale + (mask ? mask[i] : 0.f);
+    max_x = std::fmax(max_x, X[i]);
+  }
+
+  i = 0;
+  float sum = 0.f;
+  float32x4_t sum_v = vmovq_n_f32(0.f);
+  max_v = vmovq_n_f32(max_x);
+  for (; len - i >= VL_FP32; i += VL_FP32) {
+    float32x4_t exp0_3 = exp_ps(vsubq_f32(vld1q_f32(&X[i]), max_v));
+    vst1q_f32(&X[i], exp0_3);
+    sum_v = vaddq_f32(sum_v, exp0_3);
+  }
+  sum = vaddvq_f32(sum_v);
+  for (; i < len; ++i) {
+    X[i] = std::exp(X[i] - max_x);
+    sum += X[i];
+  }
+
+  i = 0;
+  const float inv_sum = sum > 0.f ? 1.f / sum : 0.f;
+  if (D) {
+    const float keep_scale = 1.f / (1.f - dropout_rate);
+    const float32x4_t rate_v = vmovq_n_f32(dropout_rate);
+    const float32x4_t zero_v = vmovq_n_f32(0.f);
+    uint32_t lanes[VL_FP32] = {xorshift_seed(seed), xorshift_seed(seed + 1),
+                               xorshift_seed(seed + 2),
+                               xorshift_seed(seed + 3)};
+    uint32x4_t state = vld1q_u32(lanes);
+    for (; len - i >= VL_FP32; i += VL_FP32) {
+      state = veorq_u32(state, vshlq_n_u32(state, 13));
+      state = veorq_u32(state, vshrq_n_u32(state, 17));
+      state = veorq_u32(state, vshlq_n_u32(state, 5));
+      float32x4_t u0_3 =
+        vmulq_n_f32(vcvtq_f32_u32(vshrq_n_u32(state, 8)), 1.f / 16777216.f);
+      float32x4_t p0_3 = vmulq_n_f32(vld1q_f32(&X[i]), inv_sum);
+      vst1q_f32(&X[i], p0_3);
+      vst1q_f32(&D[i], vbslq_f32(vcgeq_f32(u0_3, rate_v),
+                                 vmulq_n_f32(p0_3, keep_scale), zero_v));
+    }
+    vst1q_u32(lanes, state);
+    unsigned int s = lanes[0];
+    for (; i < len; ++i) {
+      s ^= s << 13;
+      s ^= s >> 17;
+      s ^= s << 5;
+      X[i] *= inv_sum;
+      D[i] = (s >> 8) * (1.f / 16777216.f) >= dropout_rate ? X[i] * keep_scale
+                                                            : 0.f;
+    }
+  } else {
+    for (; len - i >= VL_FP32; i += VL_FP32)
+      vst1q_f32(&X[i], vmulq_n_f32(vld1q_f32(&X[i]), inv_sum));
+    for (; i < len; ++i)
+      X[i] *= inv_sum;
+  }
+
+  for (i = len; i < N; ++i) {
+    X[i] = 0.f;
+    if (D)
+      D[i] = 0.f;
+  }
+}
+
+void softmax_row_fused_deriv(const unsigned int N, const float *P,
+                             const float *D, const float dropout_rate,
+                             float *dY, const float *dE, const float scale,
+                             float *dM) {
+  const float keep_scale = D ? 1.f / (1.f - dropout_rate) : 1.f;
+  const float32x4_t zero_v = vmovq_n_f32(0.f);
+
+  auto dP_v = [&](unsigned int i) {
+    float32x4_t dp0_3 = vld1q_f32(&dY[i]);
+    if (D) {
+      uint32x4_t kept = vmvnq_u32(vceqq_f32(vld1q_f32(&D[i]), zero_v));
+      dp0_3 = vbslq_f32(kept, vmulq_n_f32(dp0_3, keep_scale), zero_v);
+    }
+    if (dE)
+      dp0_3 = vaddq_f32(dp0_3, vld1q_f32(&dE[i]));
+    return dp0_3;
+  };
+  auto dP = [&](unsigned int i) {
+    float dp = dY[i];
+    if (D)
+      dp = D[i] != 0.f ? dp * keep_scale : 0.f;
+    if (dE)
+      dp += dE[i];
+    return dp;
+  };
+
+  unsigned int i = 0;
+  float32x4_t dot_v = vmovq_n_f32(0.f);
+  for (; N - i >= VL_FP32; i += VL_FP32)
+    dot_v = vmlaq_f32(dot_v, vld1q_f32(&P[i]), dP_v(i));
+  float dot = vaddvq_f32(dot_v);
+  for (; i < N; ++i)
+    dot += P[i] * dP(i);
+
+  i = 0;
+  const float32x4_t dot_b = vmovq_n_f32(dot);
+  for (; N - i >= VL_FP32; i += VL_FP32) {
+    float32x4_t dx0_3 = vmulq_f32(vld1q_f32(&P[i]), vsubq_f32(dP_v(i), dot_b));
+    if (dM)
+      vst1q_f32(&dM[i], dx0_3);
+    vst1q_f32(&dY[i], vmulq_n_f32(dx0_3, scale));
+  }
+  for (; i < N; ++i) {
+    float dx = P[i] * (dP(i) - dot);
+    if (dM)
+      dM[i] = dx;
+    dY[i] = dx * scale;
+  }
+}
+
+namespace {
+
+/**
+ * @brief sigmoid of 4 single-precision values
+ */
+inline float32x4_t sigmoid_f32(float32x4_t x) {
+  const float32x4_t one = vmovq_n_f32(1.f);
+  return vdivq_f32(one, vaddq_f32(one, exp_ps(vnegq_f32(x))));
+}
+
+/**
+ * @brief erf of 4 single-precision values (Abramowitz and Stegun 7.1.26,
+ * absolute error below 1.5e-7)
+ */
+inline float32x4_t erf_f32(float32x4_t x) {
+  const float32x4_t one = vmovq_n_f32(1.f);
+  uint32x4_t sign =
+    vandq_u32(vreinterpretq_u32_f32(x), vdupq_n_u32(0x80000000u));
+  float32x4_t a = vabsq_f32(x);
+
+  float32x4_t t =
+    vdivq_f32(one, vmlaq_f32(one, vmovq_n_f32(0.3275911f), a));
+  float32x4_t y = vmovq_n_f32(1.061405429f);
+  y = vmlaq_f32(vmovq_n_f32(-1.453152027f), y, t);
+  y = vmlaq_f32(vmovq_n_f32(1.421413741f), y, t);
+  y = vmlaq_f32(vmovq_n_f32(-0.284496736f), y, t);
+  y = vmlaq_f32(vmovq_n_f32(0.254829592f), y, t);
+  y = vmulq_f32(y, t);
+
+  float32x4_t e = exp_ps(vnegq_f32(vmulq_f32(a, a)));
+  y = vmlsq_f32(one, y, e);
+  return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(y), sign));
+}
+
+} // namespace
+
+void ele_sigmoid(const unsigned int N, const float *X, float *Y) {
+  unsigned int i = 0;
+  for (; N - i >= VL_FP32; i += VL_FP32)
+    vst1q_f32(&Y[i], sigmoid_f32(vld1q_f32(&X[i])));
+  for (; i < N; ++i)
+    Y[i] = 1.f / (1.f + std::exp(-X[i]));
+}
+
+void ele_tanh(const unsigned int N, const float *X, float *Y) {
+  const float32x4_t one = vmovq_n_f32(1.f);
+  unsigned int i = 0;
+  for (; N - i >= VL_FP32; i += VL_FP32) {
+    float32x4_t s = sigmoid_f32(vmulq_n_f32(vld1q_f32(&X[i]), 2.f));
+    vst1q_f32(&Y[i], vsubq_f32(vmulq_n_f32(s, 2.f), one));
+  }
+  for (; i < N; ++i)
+    Y[i] = 2.f / (1.f + std::exp(-2.f * X[i])) - 1.f;
+}
+
+void ele_gelu(const unsigned int N, const float *X, float *Y) {
+  constexpr float t = 0.70710678118654752f; /**< 1 / sqrt(2) */
+  unsigned int i = 0;
+  for (; N - i >= VL_FP32; i += VL_FP32) {
+    float32x4_t x0_3 = vld1q_f32(&X[i]);
+    float32x4_t e0_3 = erf_f32(vmulq_n_f32(x0_3, t));
+    float32x4_t hx0_3 = vmulq_n_f32(x0_3, 0.5f);
+    vst1q_f32(&Y[i], vmlaq_f32(hx0_3, hx0_3, e0_3));
+  }
+  for (; i < N; ++i)
+    Y[i] = 0.5f * X[i] * (1.f + std::erf(X[i] * t));
+}
+
+void ele_gelu_deriv(const unsigned int N, const float *X, const float *dY,
+                    float *dX) {
+  constexpr float t = 0.70710678118654752f; /**< 1 / sqrt(2) */
+  constexpr float c = 1.12837916709551257f; /**< 2 / sqrt(pi) */
+  const float32x4_t one = vmovq_n_f32(1.f);
+  unsigned int i = 0;
+  for (; N - i >= VL_FP32; i += VL_FP32) {
+    float32x4_t x0_3 = vld1q_f32(&X[i]);
+    float32x4_t xt0_3 = vmulq_n_f32(x0_3, t);
+    float32x4_t e0_3 = exp_ps(vnegq_f32(vmulq_f32(xt0_3, xt0_3)));
+    /** 0.5 * (1 + erf(xt) + x * c * t * exp(-xt^2)) */
+    float32x4_t d0_3 = vaddq_f32(one, erf_f32(xt0_3));
+    d0_3 = vmlaq_f32(d0_3, vmulq_n_f32(x0_3, c * t), e0_3);
+    d0_3 = vmulq_n_f32(d0_3, 0.5f);
+    vst1q_f32(&dX[i], vmulq_f32(d0_3, vld1q_f32(&dY[i])));
+  }
+  for (; i < N; ++i) {
+    float xt = X[i] * t;
+    float d =
+      0.5f * (1.f + std::erf(xt) + X[i] * c * t * std::exp(-xt * xt));
+    dX[i] = d * dY[i];
+  }
+}
+
+void ele_swish(const unsigned int N, const float *X, float *Y) {
+  unsigned int i = 0;
+  for (; N - i >= VL_FP32; i += VL_FP32) {
+    float32x4_t x0_3 = vld1q_f32(&X[i]);
+    vst1q_f32(&Y[i], vmulq_f32(x0_3, sigmoid_f32(x0_3)));
+  }
+  for (; i < N; ++i)
+    Y[i] = X[i] / (1.f + std::exp(-X[i]));
+}
+
+void ele_swish_deriv(const unsigned int N, const float *X, const float *Y,
+                     const float *dY, float *dX) {
+  const float32x4_t one = vmovq_n_f32(1.f);
+  unsigned int i = 0;
+  for (; N - i >= VL_FP32; i += VL_FP32) {
+    float32x4_t s0_3 = sigmoid_f32(vld1q_f32(&X[i]));
+    float32x4_t y0_3 = vld1q_f32(&Y[i]);
+    float32x4_t d0_3 = vmlaq_f32(y0_3, s0_3, vsubq_f32(one, y0_3));
+    vst1q_f32(&dX[i], vmulq_f32(d0_3, vld1q_f32(&dY[i])));
+  }
+  for (; i < N; ++i) {
+    float s = 1.f / (1.f + std::exp(-X[i]));
+    dX[i] = (s * (1.f - Y[i]) + Y[i]) * dY[i];
+  }
+}
+
+float reduce_sum(const unsigned int N, const float *X) {
+  float32x4_t acc0 = vmovq_n_f32(0.f);
+  float32x4_t acc1 = vmovq_n_f32(0.f);
+  unsigned int i = 0;
+  for (; N - i >= 2 * VL_FP32; i += 2 * VL_FP32) {
+    acc0 = vaddq_f32(acc0, vld1q_f32(&X[i]));
+    acc1 = vaddq_f32(acc1, vld1q_f32(&X[i + VL_FP32]));
+  }
+  if (N - i >= VL_FP32) {
+    acc0 = vaddq_f32(acc0, vld1q_f32(&X[i]));
+    i += VL_FP32;
+  }
+  float sum = vaddvq_f32(vaddq_f32(acc0, acc1));
+  for (; i < N; ++i)
+    sum += X[i];
+  return sum;
+}
+
+float reduce_sum_squares(const unsigned int N, const float *X) {
+  float32x4_t acc0 = vmovq_n_f32(0.f);
+  float32x4_t acc1 = vmovq_n_f32(0.f);
+  unsigned int i = 0;
+  for (; N - i >= 2 * VL_FP32; i += 2 * VL_FP32) {
+    float32x4_t x0_3 = vld1q_f32(&X[i]);
+    float32x4_t x4_7 = vld1q_f32(&X[i + VL_FP32]);
+    acc0 = vmlaq_f32(acc0, x0_3, x0_3);
+    acc1 = vmlaq_f32(acc1, x4_7, x4_7);
+  }
+  if (N - i >= VL_FP32) {
+    float32x4_t x0_3 = vld1q_f32(&X[i]);
+    acc0 = vmlaq_f32(acc0, x0_3, x0_3);
+    i += VL_FP32;
+  }
+  float sum = vaddvq_f32(vaddq_f32(acc0, acc1));
+  for (; i < N; ++i)
+    sum += X[i] * X[i];
+  return sum;
+}
+
+namespace {
+
+/**
+ * @brief scalar derivative of the gated swish, dG is written before dX
+ */
+inline void swiglu_deriv_scalar(float x, float g, float dy, float &dx,
+                                float &dg) {
+  float s = 1.f / (1.f + std::exp(-x));
+  float sw = x * s;
+  dg = sw * dy;
+  dx = (s + sw * (1.f - s)) * g * dy;
+}
+
+/**
+ * @brief derivative of the gated swish of 4 single-precision values
+ */
+inline void swiglu_deriv_f32(float32x4_t x, float32x4_t g, float32x4_t dy,
+                             float32x4_t &dx, float32x4_t &dg) {
+  const float32x4_t one = vmovq_n_f32(1.f);
+  float32x4_t s = sigmoid_f32(x);
+  float32x4_t sw = vmulq_f32(x, s);
+  dg = vmulq_f32(sw, dy);
+  dx = vmulq_f32(vmlaq_f32(s, sw, vsubq_f32(one, s)), vmulq_f32(g, dy));
+}
+
+/**
+ * @brief rotate 4 pairs of single-precision values
+ */
+inline void rotate_f32(float32x4_t &x1, float32x4_t &x2, float32x4_t c,
+                       float32x4_t s) {
+  float32x4_t y1 = vmlsq_f32(vmulq_f32(x1, c), x2, s);
+  x2 = vmlaq_f32(vmulq_f32(x2, c), x1, s);
+  x1 = y1;
+}
+
+} // namespace
+
+void ele_swiglu(const unsigned int N, const float *X, const float *G,
+                float *Y) {
+  unsigned int i = 0;
+  for (; N - i >= VL_FP32; i += VL_FP32) {
+    float32x4_t x0_3 = vld1q_f32(&X[i]);
+    vst1q_f32(&Y[i], vmulq_f32(vmulq_f32(x0_3, sigmoid_f32(x0_3)),
+                               vld1q_f32(&G[i])));
+  }
+  for (; i < N; ++i)
+    Y[i] = X[i] / (1.f + std::exp(-X[i])) * G[i];
+}
+
+void ele_swiglu_deriv(const unsigned int N, const float *X, const float *G,
+                      const float *dY, float *dX, float *dG) {
+  unsigned int i = 0;
+  for (; N - i >= VL_FP32; i += VL_FP32) {
+    float32x4_t dx0_3, dg0_3;
+    swiglu_deriv_f32(vld1q_f32(&X[i]), vld1q_f32(&G[i]), vld1q_f32(&dY[i]),
+                     dx0_3, dg0_3);
+    vst1q_f32(&dG[i], dg0_3);
+    vst1q_f32(&dX[i], dx0_3);
+  }
+  for (; i < N; ++i) {
+    float dx, dg;
+    swiglu_deriv_scalar(X[i], G[i], dY[i], dx, dg);
+    dG[i] = dg;
+    dX[i] = dx;
+  }
+}
+
+void rotary_emb(const unsigned int half, float *X, const float *cos_,
+                const float *sin_, bool inverse) {
+  const float sign = inverse ? -1.f : 1.f;
+  float *X2 = X + half;
+  unsigned int i = 0;
+  for (; half - i >= VL_FP32; i += VL_FP32) {
+    float32x4_t x1 = vld1q_f32(&X[i]);
+    float32x4_t x2 = vld1q_f32(&X2[i]);
+    rotate_f32(x1, x2, vld1q_f32(&cos_[i]),
+               vmulq_n_f32(vld1q_f32(&sin_[i]), sign));
+    vst1q_f32(&X[i], x1);
+    vst1q_f32(&X2[i], x2);
+  }
+  for (; i < half; ++i) {
+    float x1 = X[i], x2 = X2[i], s = sin_[i] * sign;
+    X[i] = x1 * cos_[i] - x2 * s;
+    X2[i] = x2 * cos_[i] + x1 * s;
+  }
+}
+
 #ifdef ENABLE_FP16
 void compute_rotary_embedding_value(unsigned int dim, unsigned int half_,
                                     unsigned int w, __fp16 *in, __fp16 *out,
@@ -267,6 +643,60 @@ void softmax(const unsigned int N, __fp16 *X, __fp16 *Y) {
     ++i;
   }
 }
+
+void ele_swiglu(const unsigned int N, const __fp16 *X, const __fp16 *G,
+                __fp16 *Y) {
+  unsigned int i = 0;
+  for (; N - i >= VL_FP32; i += VL_FP32) {
+    float32x4_t x0_3 = vcvt_f32_f16(vld1_f16(&X[i]));
+    float32x4_t g0_3 = vcvt_f32_f16(vld1_f16(&G[i]));
+    float32x4_t y0_3 = vmulq_f32(vmulq_f32(x0_3, sigmoid_f32(x0_3)), g0_3);
+    vst1_f16(&Y[i], vcvt_f16_f32(y0_3));
+  }
+  for (; i < N; ++i) {
+    float x = X[i];
+    Y[i] = x / (1.f + std::exp(-x)) * static_cast<float>(G[i]);
+  }
+}
+
+void ele_swiglu_deriv(const unsigned int N, const __fp16 *X, const __fp16 *G,
+                      const __fp16 *dY, __fp16 *dX, __fp16 *dG) {
+  unsigned int i = 0;
+  for (; N - i >= VL_FP32; i += VL_FP32) {
+    float32x4_t dx0_3, dg0_3;
+    swiglu_deriv_f32(vcvt_f32_f16(vld1_f16(&X[i])),
+                     vcvt_f32_f16(vld1_f16(&G[i])),
+                     vcvt_f32_f16(vld1_f16(&dY[i])), dx0_3, dg0_3);
+    vst1_f16(&dG[i], vcvt_f16_f32(dg0_3));
+    vst1_f16(&dX[i], vcvt_f16_f32(dx0_3));
+  }
+  for (; i < N; ++i) {
+    float dx, dg;
+    swiglu_deriv_scalar(X[i], G[i], dY[i], dx, dg);
+    dG[i] = dg;
+    dX[i] = dx;
+  }
+}
+
+void rotary_emb(const unsigned int half, __fp16 *X, const float *cos_,
+                const float *sin_, bool inverse) {
+  const float sign = inverse ? -1.f : 1.f;
+  __fp16 *X2 = X + half;
+  unsigned int i = 0;
+  for (; half - i >= VL_FP32; i += VL_FP32) {
+    float32x4_t x1 = vcvt_f32_f16(vld1_f16(&X[i]));
+    float32x4_t x2 = vcvt_f32_f16(vld1_f16(&X2[i]));
+    rotate_f32(x1, x2, vld1q_f32(&cos_[i]),
+               vmulq_n_f32(vld1q_f32(&sin_[i]), sign));
+    vst1_f16(&X[i], vcvt_f16_f32(x1));
+    vst1_f16(&X2[i], vcvt_f16_f32(x2));
+  }
+  for (; i < half; ++i) {
+    float x1 = X[i], x2 = X2[i], s = sin_[i] * sign;
+    X[i] = x1 * cos_[i] - x2 * s;
+    X2[i] = x2 * cos_[i] + x1 * s;
+  }
+}
 #endif
 
 } // namespace nntrainer::neon
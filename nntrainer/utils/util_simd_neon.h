@@ -66,6 +66,154 @@ void softmax(const unsigned int N, float *X, float *Y);
  * @param X float * for Vector X
  */
 void exp_i(const unsigned int N, float *X);
+
+/**
+ * @brief fused attention softmax of a single row with neon : P = softmax(X *
+ * scale + mask) over the first len elements, D = dropout(P)
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X, overwritten by P
+ * @param scale scale factor multiplied to X
+ * @param mask float * additive mask for Vector X, nullptr if not masked
+ * @param len number of leading elements of X that are visible
+ * @param dropout_rate dropout rate, dropout is not applied if 0
+ * @param seed seed of the random number generator for this row
+ * @param D float * for dropped out Vector P, nullptr if dropout_rate is 0
+ */
+void softmax_row_fused(const unsigned int N, float *X, const float scale,
+                       const float *mask, const unsigned int len,
+                       const float dropout_rate, const unsigned int seed,
+                       float *D);
+
+/**
+ * @brief derivative of softmax_row_fused with neon
+ *
+ * @param N number of elements in P
+ * @param P float * for softmax output of the row
+ * @param D float * for dropped out P, nullptr if dropout is not applied
+ * @param dropout_rate dropout rate used in the forward pass
+ * @param dY float * for incoming derivative, overwritten by dX
+ * @param dE float * for extra derivative added after dropout, nullable
+ * @param scale scale factor used in the forward pass
+ * @param dM float * for the derivative of the additive mask, nullable
+ */
+void softmax_row_fused_deriv(const unsigned int N, const float *P,
+                             const float *D, const float dropout_rate,
+                             float *dY, const float *dE, const float scale,
+                             float *dM);
+
+/**
+ * @brief sigmoid of each element with neon
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @param Y float * for Vector Y
+ */
+void ele_sigmoid(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief tanh of each element with neon
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @param Y float * for Vector Y
+ */
+void ele_tanh(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief gelu of each element with neon
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @param Y float * for Vector Y
+ */
+void ele_gelu(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief derivative of gelu multiplied by the incoming derivative with neon
+ *
+ * @param N number of elements in X
+ * @param X float * for the input of gelu
+ * @param dY float * for incoming derivative
+ * @param dX float * for outgoing derivative
+ */
+void ele_gelu_deriv(const unsigned int N, const float *X, const float *dY,
+                    float *dX);
+
+/**
+ * @brief swish of each element with neon
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @param Y float * for Vector Y
+ */
+void ele_swish(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief derivative of swish multiplied by the incoming derivative with neon
+ *
+ * @param N number of elements in X
+ * @param X float * for the input of swish
+ * @param Y float * for the output of swish
+ * @param dY float * for incoming derivative
+ * @param dX float * for outgoing derivative
+ */
+void ele_swish_deriv(const unsigned int N, const float *X, const float *Y,
+                     const float *dY, float *dX);
+
+/**
+ * @brief sum of the elements with neon
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @return float sum of X
+ */
+float reduce_sum(const unsigned int N, const float *X);
+
+/**
+ * @brief sum of the squared elements with neon
+ *
+ * @param N number of elements in X
+ * @param X float * for Vector X
+ * @return float sum of X * X
+ */
+float reduce_sum_squares(const unsigned int N, const float *X);
+
+/**
+ * @brief gated swish of each element with neon
+ *
+ * @param N number of elements in X
+ * @param X float * for the input of swish
+ * @param G float * for the gate
+ * @param Y float * for Vector Y
+ */
+void ele_swiglu(const unsigned int N, const float *X, const float *G,
+                float *Y);
+
+/**
+ * @brief derivative of the gated swish with neon
+ *
+ * @param N number of elements in X
+ * @param X float * for the input of swish
+ * @param G float * for the gate
+ * @param dY float * for incoming derivative
+ * @param dX float * for outgoing derivative of X
+ * @param dG float * for outgoing derivative of G
+ */
+void ele_swiglu_deriv(const unsigned int N, const float *X, const float *G,
+                      const float *dY, float *dX, float *dG);
+
+/**
+ * @brief rotate the pairs of a head in place with neon
+ *
+ * @param half half of the head dimension
+ * @param X float * for the head
+ * @param cos_ cosine of the angles
+ * @param sin_ sine of the angles
+ * @param inverse rotate by the negated angles if true
+ */
+void rotary_emb(const unsigned int half, float *X, const float *cos_,
+                const float *sin_, bool inverse);
 #ifdef ENABLE_FP16
 /**
  * @brief Accelerating function for rotary embedding layer forwarding
@@ -110,6 +258,44 @@ __fp16 max(const unsigned int N, __fp16 *X);
  * @param Y  __fp16 * for Vector Y
  */
 void softmax(const unsigned int N, __fp16 *X, __fp16 *Y);
+
+/**
+ * @brief gated swish of each element with neon, computed in single-precision
+ *
+ * @param N number of elements in X
+ * @param X __fp16 * for the input of swish
+ * @param G __fp16 * for the gate
+ * @param Y __fp16 * for Vector Y
+ */
+void ele_swiglu(const unsigned int N, const __fp16 *X, const __fp16 *G,
+                __fp16 *Y);
+
+/**
+ * @brief derivative of the gated swish with neon, computed in
+ * single-precision
+ *
+ * @param N number of elements in X
+ * @param X __fp16 * for the input of swish
+ * @param G __fp16 * for the gate
+ * @param dY __fp16 * for incoming derivative
+ * @param dX __fp16 * for outgoing derivative of X
+ * @param dG __fp16 * for outgoing derivative of G
+ */
+void ele_swiglu_deriv(const unsigned int N, const __fp16 *X, const __fp16 *G,
+                      const __fp16 *dY, __fp16 *dX, __fp16 *dG);
+
+/**
+ * @brief rotate the pairs of a head in place with neon, computed in
+ * single-precision
+ *
+ * @param half half of the head dimension
+ * @param X __fp16 * for the head
+ * @param cos_ cosine of the angles
+ * @param sin_ sine of the angles
+ * @param inverse rotate by the negated angles if true
+ */
+void rotary_emb(const unsigned int half, __fp16 *X, const float *cos_,
+                const float *sin_, bool inverse);
 #endif
 
 } // namespace nntrainer::neon
@@ -111,6 +111,37 @@ class PositionalEncoding(tf.keras.layers.Layer):
         return inputs
 
 
+class RMSNorm(tf.keras.layers.Layer):
+    """_summary_
+
+    RMSNorm class to scale the inputs by their root mean square over the width
+    """
+
+    def __init__(self, epsilon=1e-3):
+        super().__init__()
+        self.epsilon = epsilon
+        self.gamma = None
+
+    def build(self, input_shape):
+        """_summary_
+
+        build function for RMSNorm
+        """
+        self.gamma = self.add_weight(
+            shape=(input_shape[-1],),
+            initializer=K.initializers.RandomUniform(0.5, 1.5),
+            name="gamma",
+        )
+
+    def call(self, inputs):
+        """_summary_
+
+        call function for RMSNorm
+        """
+        mean_square = tf.reduce_mean(tf.square(inputs), axis=-1, keepdims=True)
+        return inputs * tf.math.rsqrt(mean_square + self.epsilon) * self.gamma
+
+
 if __name__ == "__main__":
     fc = K.layers.Dense(5)
     record_single(fc, (3, 1, 1, 10), "fc_plain")
@@ -171,6 +202,18 @@ if __name__ == "__main__":
     record_single(conv, (1, 3, 11, 11), "conv2d_sb_same_dilation")
     record_single(conv, (3, 3, 11, 11), "conv2d_mb_same_dilation")
 
+    conv = K.layers.DepthwiseConv2D(3, depth_multiplier=2, padding="same")
+    record_single(conv, (1, 2, 5, 5), "depthwise_conv2d_sb_same_multiplier")
+    record_single(conv, (2, 2, 5, 5), "depthwise_conv2d_mb_same_multiplier")
+    record_single(conv, (2, 2, 5, 5), "depthwise_conv2d_mb_same_multiplier_nhwc",
+                  channels_last=True)
+
+    conv = K.layers.DepthwiseConv2D(3, strides=2)
+    record_single(conv, (1, 3, 7, 7), "depthwise_conv2d_sb_valid_stride")
+    record_single(conv, (3, 3, 7, 7), "depthwise_conv2d_mb_valid_stride")
+    record_single(conv, (3, 3, 7, 7), "depthwise_conv2d_mb_valid_stride_nhwc",
+                  channels_last=True)
+
     # use float data to generate input here
     attention = K.layers.Attention()
     record_single(
@@ -469,6 +512,14 @@ if __name__ == "__main__":
     record_single(positional_encoding, [(3, 1, 7, 6)], "positional_encoding_partial")
     record_single(positional_encoding, [(3, 1, 10, 6)], "positional_encoding")
 
+    rms_norm = RMSNorm()
+    record_single(rms_norm, (2, 3, 3, 6), "rms_norm", input_type="float")
+
+    rms_norm = RMSNorm()
+    record_single(
+        rms_norm, (1, 2, 4, 5), "rms_norm_single_batch", input_type="float"
+    )
+
     # embedding
 
     embedding = K.layers.Embedding(10, 10)
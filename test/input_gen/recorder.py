@@ -402,7 +402,10 @@ def record(
 
 ##
 # @brief record a single layer
-def record_single(layer, input_shape, test_name, call_args={}, input_type='int'):
+# @param channels_last if True, inputs, outputs and derivatives are saved in
+# NHWC layout while weights and gradients are kept as they are
+def record_single(layer, input_shape, test_name, call_args={}, input_type='int',
+                  channels_last=False):
     layer = attach_trans_layer(layer)
     layer.build(input_shape)
     if isinstance(input_shape, list):
@@ -435,20 +438,22 @@ def record_single(layer, input_shape, test_name, call_args={}, input_type='int')
     with open(test_name + ".nnlayergolden", "wb") as f:
         writer = _get_writer(f)
 
-        def write_tensor(tensors):
+        def write_tensor(tensors, to_channels_last=False):
             if not isinstance(tensors, list):
                 tensors = [tensors]
             for tensor in tensors:
+                if to_channels_last:
+                    tensor = tf.transpose(tensor, perm=(0, 2, 3, 1))
                 writer(tf.size(tensor), tensor)
 
         ## @todo inputs outputs derivatives can be more than one
         ## @note please update genLayerTests.py comments when updating below
         write_tensor(initial_weights)
-        write_tensor(inputs)
-        write_tensor(outputs)
+        write_tensor(inputs, channels_last)
+        write_tensor(outputs, channels_last)
         write_tensor(gradients)
         write_tensor(weights)
-        write_tensor(derivatives)
+        write_tensor(derivatives, channels_last)
 
 
 def record_single_fp16(layer, input_shape, test_name, call_args={}, input_type='int'):
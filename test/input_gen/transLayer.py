@@ -152,6 +152,23 @@ class ChannelLastTransLayer(AbstractTransLayer):
         return [self._nntr_kernel(t) for t in weights]
 
 
+##
+# @brief Translayer for depthwise convolution layer
+# @note depthwise kernel of tf is (height, width, channel, multiplier) while
+# nntrainer keeps (channel * multiplier, 1, height, width)
+class DepthwiseConvTransLayer(ChannelLastTransLayer):
+    # height, width, channel, multiplier -> channel, multiplier, height, width
+    TO_NNTR_DEPTHWISE_KERNEL = (2, 3, 0, 1)
+
+    @classmethod
+    def _nntr_kernel(cls, tensor):
+        if tf.rank(tensor).numpy() == 4:
+            kernel = tf.transpose(tensor, perm=cls.TO_NNTR_DEPTHWISE_KERNEL)
+            shape = kernel.shape
+            return tf.reshape(kernel, (shape[0] * shape[1], 1, shape[2], shape[3]))
+        return tensor
+
+
 CHANNEL_LAST_LAYERS = (
     K.layers.Conv2D,
     K.layers.Conv1D,
@@ -325,6 +342,10 @@ def attach_trans_layer(layer):
     ):
         return LayerNormTransLayer(layer)
 
+    # DepthwiseConv2D is a subclass of Conv2D, so it has to be checked first
+    if isinstance(layer, K.layers.DepthwiseConv2D):
+        return DepthwiseConvTransLayer(layer)
+
     if isinstance(layer, CHANNEL_LAST_LAYERS):
         return ChannelLastTransLayer(layer)
 
@@ -0,0 +1,318 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file unittest_layers_centroid_knn.cpp
+ * @date 16 Oct 2026
+ * @brief Centroid KNN Layer Test
+ * @see	https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug No known bugs except for NYI items
+ */
+#include <tuple>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <centroid_knn.h>
+#include <layer_context.h>
+#include <layers_common_tests.h>
+#include <var_grad.h>
+#include <weight.h>
+
+auto semantic_centroid_knn_top_k = LayerSemanticsParamType(
+  nntrainer::createLayer<nntrainer::CentroidKNN>, nntrainer::CentroidKNN::type,
+  {"num_class=4", "top_k=2"},
+  LayerCreateSetPropertyOptions::AVAILABLE_FROM_APP_CONTEXT, false, 1);
+
+auto semantic_centroid_knn_ivf = LayerSemanticsParamType(
+  nntrainer::createLayer<nntrainer::CentroidKNN>, nntrainer::CentroidKNN::type,
+  {"num_class=4", "ivf_lists=2", "ivf_probes=1"},
+  LayerCreateSetPropertyOptions::AVAILABLE_FROM_APP_CONTEXT, false, 1);
+
+GTEST_PARAMETER_TEST(CentroidKNN, LayerSemantics,
+                     ::testing::Values(semantic_centroid_knn_top_k,
+                                       semantic_centroid_knn_ivf));
+
+/**
+ * @brief CentroidKNN layer with its tensors allocated
+ */
+class CentroidKNNRunner {
+public:
+  /**
+   * @brief Construct a new CentroidKNNRunner object
+   *
+   * @param props properties of the layer
+   * @param batch batch size
+   * @param feature_len length of a feature
+   */
+  CentroidKNNRunner(const std::vector<std::string> &props, unsigned int batch,
+                    unsigned int feature_len) {
+    layer.setProperty(props);
+
+    nntrainer::TensorDim in_dim(batch, 1, 1, feature_len);
+    nntrainer::InitLayerContext init_context({in_dim}, {true}, false, "knn");
+    layer.finalize(init_context);
+
+    auto out_dim = init_context.getOutSpecs()[0].variable_spec.dim;
+    out_dim.batch(batch);
+
+    weights.reserve(init_context.getWeightsSpec().size());
+    for (auto &spec : init_context.getWeightsSpec()) {
+      weights.emplace_back(spec, true);
+      weights.back().getVariableRef().setZero();
+    }
+    inputs.emplace_back(in_dim, nntrainer::Tensor::Initializer::NONE, true,
+                        true, "input");
+    outputs.emplace_back(out_dim, nntrainer::Tensor::Initializer::NONE, true,
+                         true, "output");
+
+    std::vector<nntrainer::Weight *> w;
+    for (auto &weight : weights)
+      w.push_back(&weight);
+    context = std::make_unique<nntrainer::RunLayerContext>(
+      "knn", false, 0.0f, false, w,
+      std::vector<nntrainer::Var_Grad *>{&inputs[0]},
+      std::vector<nntrainer::Var_Grad *>{&outputs[0]},
+      std::vector<nntrainer::Var_Grad *>{});
+  }
+
+  /**
+   * @brief Get the centroid of each class
+   */
+  nntrainer::Tensor &map() { return weights[0].getVariableRef(); }
+
+  /**
+   * @brief Get the samples seen for each class
+   */
+  nntrainer::Tensor &numSamples() { return weights[1].getVariableRef(); }
+
+  /**
+   * @brief Get the input
+   */
+  nntrainer::Tensor &input() { return inputs[0].getVariableRef(); }
+
+  /**
+   * @brief Forward the input
+   *
+   * @param training training mode
+   * @return nntrainer::Tensor& scores of the classes
+   */
+  nntrainer::Tensor &forward(bool training = false) {
+    layer.forwarding(*context, training);
+    return outputs[0].getVariableRef();
+  }
+
+  /**
+   * @brief Get the label used in the training mode
+   */
+  nntrainer::Tensor &label() { return outputs[0].getGradientRef(); }
+
+private:
+  nntrainer::CentroidKNN layer;
+  std::vector<nntrainer::Weight> weights;
+  std::vector<nntrainer::Var_Grad> inputs;
+  std::vector<nntrainer::Var_Grad> outputs;
+  std::unique_ptr<nntrainer::RunLayerContext> context;
+};
+
+/**
+ * @brief negative euclidean distance of two features
+ */
+static float referenceScore(const float *a, const float *b, unsigned int len) {
+  float sum = 0.0f;
+  for (unsigned int i = 0; i < len; ++i)
+    sum += (a[i] - b[i]) * (a[i] - b[i]);
+  return -std::sqrt(sum);
+}
+
+TEST(CentroidKNN, gemm_distance_p) {
+  constexpr unsigned int batch = 3, num_class = 6, feature_len = 7;
+  CentroidKNNRunner knn({"num_class=6"}, batch, feature_len);
+
+  knn.map().setRandUniform(-1.0f, 1.0f);
+  knn.numSamples().setValue(1.0f);
+  knn.numSamples().setValue(0, 0, 0, 2, 0.0f);
+  knn.input().setRandUniform(-1.0f, 1.0f);
+
+  auto &out = knn.forward();
+  for (unsigned int b = 0; b < batch; ++b) {
+    for (unsigned int c = 0; c < num_class; ++c) {
+      float expected = c == 2 ? std::numeric_limits<float>::min()
+                              : referenceScore(
+                                  knn.input().getAddress(b * feature_len),
+                                  knn.map().getAddress(c * feature_len),
+                                  feature_len);
+      EXPECT_NEAR(out.getValue(b, 0, 0, c), expected, 1e-4);
+    }
+  }
+}
+
+TEST(CentroidKNN, train_then_infer_p) {
+  CentroidKNNRunner knn({"num_class=2"}, 1, 3);
+
+  /// same as the features of the simpleshot test
+  float feature1[] = {0, 1, 2}, feature2[] = {3, 2, 1}, test[] = {5, 5, 5};
+  std::copy(feature1, feature1 + 3, knn.input().getData());
+  knn.label().setValue(0.0f);
+  knn.label().setValue(0, 0, 0, 0, 1.0f);
+  knn.forward(true);
+  std::copy(feature2, feature2 + 3, knn.input().getData());
+  knn.label().setValue(0.0f);
+  knn.label().setValue(0, 0, 0, 1, 1.0f);
+  knn.forward(true);
+
+  std::copy(test, test + 3, knn.input().getData());
+  auto &out = knn.forward();
+  EXPECT_NEAR(out.getValue(0, 0, 0, 0), -7.0710, 1e-4);
+  EXPECT_NEAR(out.getValue(0, 0, 0, 1), -5.38516, 1e-4);
+}
+
+TEST(CentroidKNN, top_k_p) {
+  constexpr unsigned int batch = 4, num_class = 10, feature_len = 5;
+  CentroidKNNRunner exact({"num_class=10"}, batch, feature_len);
+  CentroidKNNRunner top_k({"num_class=10", "top_k=3"}, batch, feature_len);
+
+  exact.map().setRandUniform(-1.0f, 1.0f);
+  exact.numSamples().setValue(1.0f);
+  exact.input().setRandUniform(-1.0f, 1.0f);
+  top_k.map().copy(exact.map());
+  top_k.numSamples().copy(exact.numSamples());
+  top_k.input().copy(exact.input());
+
+  auto &all = exact.forward();
+  auto &kept = top_k.forward();
+  for (unsigned int b = 0; b < batch; ++b) {
+    std::vector<float> sorted(all.getAddress(b * num_class),
+                              all.getAddress(b * num_class) + num_class);
+    std::sort(sorted.begin(), sorted.end(), std::greater<float>());
+
+    unsigned int num_kept = 0;
+    for (unsigned int c = 0; c < num_class; ++c) {
+      float score = kept.getValue(b, 0, 0, c);
+      if (score == std::numeric_limits<float>::lowest())
+        continue;
+      num_kept++;
+      EXPECT_FLOAT_EQ(score, all.getValue(b, 0, 0, c));
+      EXPECT_GE(score, sorted[2]);
+    }
+    EXPECT_EQ(num_kept, 3u);
+  }
+}
+
+TEST(CentroidKNN, ivf_search_p) {
+  constexpr unsigned int num_groups = 8, per_group = 8, feature_len = 4;
+  constexpr unsigned int num_class = num_groups * per_group;
+  std::vector<std::string> props = {"num_class=64", "ivf_lists=8",
+                                    "ivf_probes=1"};
+  CentroidKNNRunner ivf(props, num_groups, feature_len);
+  CentroidKNNRunner exact({"num_class=64"}, num_groups, feature_len);
+
+  /// classes in well separated groups, a query near each group
+  exact.map().setRandUniform(-0.1f, 0.1f);
+  exact.input().setRandUniform(-0.1f, 0.1f);
+  for (unsigned int c = 0; c < num_class; ++c)
+    exact.map().getAddress(c * feature_len)[(c / per_group) % feature_len] +=
+      10.0f * (c / per_group + 1);
+  for (unsigned int b = 0; b < num_groups; ++b)
+    exact.input().getAddress(b * feature_len)[b % feature_len] +=
+      10.0f * (b + 1);
+  exact.numSamples().setValue(1.0f);
+  ivf.map().copy(exact.map());
+  ivf.numSamples().copy(exact.numSamples());
+  ivf.input().copy(exact.input());
+
+  auto &all = exact.forward();
+  auto &searched = ivf.forward();
+  for (unsigned int b = 0; b < num_groups; ++b) {
+    for (unsigned int c = 0; c < num_class; ++c) {
+      if (c / per_group == b) {
+        EXPECT_FLOAT_EQ(searched.getValue(b, 0, 0, c),
+                        referenceScore(ivf.input().getAddress(b * feature_len),
+                                       ivf.map().getAddress(c * feature_len),
+                                       feature_len));
+      } else {
+        EXPECT_EQ(searched.getValue(b, 0, 0, c),
+                  std::numeric_limits<float>::lowest());
+      }
+    }
+  }
+  EXPECT_EQ(searched.argmax(), all.argmax());
+}
+
+TEST(CentroidKNN, ivf_map_reloaded_p) {
+  constexpr unsigned int num_groups = 8, per_group = 8, feature_len = 4;
+  constexpr unsigned int num_class = num_groups * per_group;
+  CentroidKNNRunner ivf({"num_class=64", "ivf_lists=8", "ivf_probes=1"},
+                        num_groups, feature_len);
+  CentroidKNNRunner exact({"num_class=64"}, num_groups, feature_len);
+
+  /// classes in well separated groups, class c in group c / per_group + shift
+  auto place = [&](unsigned int shift) {
+    exact.map().setRandUniform(-0.1f, 0.1f);
+    for (unsigned int c = 0; c < num_class; ++c) {
+      unsigned int group = (c / per_group + shift) % num_groups;
+      exact.map().getAddress(c * feature_len)[group % feature_len] +=
+        10.0f * (group + 1);
+    }
+    ivf.map().copy(exact.map());
+  };
+  exact.input().setRandUniform(-0.1f, 0.1f);
+  for (unsigned int b = 0; b < num_groups; ++b)
+    exact.input().getAddress(b * feature_len)[b % feature_len] +=
+      10.0f * (b + 1);
+  exact.numSamples().setValue(1.0f);
+  ivf.numSamples().copy(exact.numSamples());
+  ivf.input().copy(exact.input());
+  place(0);
+  ivf.forward();
+
+  /// other centroids loaded with the same samples seen rebuild the index
+  place(1);
+  auto &all = exact.forward();
+  auto &searched = ivf.forward();
+  for (unsigned int b = 0; b < num_groups; ++b) {
+    for (unsigned int c = 0; c < num_class; ++c) {
+      if ((c / per_group + 1) % num_groups == b) {
+        EXPECT_FLOAT_EQ(searched.getValue(b, 0, 0, c),
+                        referenceScore(ivf.input().getAddress(b * feature_len),
+                                       ivf.map().getAddress(c * feature_len),
+                                       feature_len));
+      } else {
+        EXPECT_EQ(searched.getValue(b, 0, 0, c),
+                  std::numeric_limits<float>::lowest());
+      }
+    }
+  }
+  EXPECT_EQ(searched.argmax(), all.argmax());
+}
+
+TEST(CentroidKNN, ivf_all_probes_exact_p) {
+  constexpr unsigned int batch = 5, num_class = 20, feature_len = 6;
+  CentroidKNNRunner ivf({"num_class=20", "ivf_lists=4", "ivf_probes=4"},
+                        batch, feature_len);
+  CentroidKNNRunner exact({"num_class=20"}, batch, feature_len);
+
+  exact.map().setRandUniform(-1.0f, 1.0f);
+  exact.numSamples().setValue(1.0f);
+  exact.numSamples().setValue(0, 0, 0, 7, 0.0f);
+  exact.input().setRandUniform(-1.0f, 1.0f);
+  ivf.map().copy(exact.map());
+  ivf.numSamples().copy(exact.numSamples());
+  ivf.input().copy(exact.input());
+
+  auto &all = exact.forward();
+  auto &searched = ivf.forward();
+  for (unsigned int i = 0; i < batch * num_class; ++i)
+    EXPECT_NEAR(searched.getValue(i), all.getValue(i), 1e-4);
+
+  /// a class seen after the index is built is found by the rebuilt index
+  ivf.map().setValue(0, 0, 7, 0, 1.0f);
+  ivf.numSamples().setValue(0, 0, 0, 7, 1.0f);
+  ivf.forward();
+  for (unsigned int b = 0; b < batch; ++b)
+    EXPECT_NE(searched.getValue(b, 0, 0, 7), std::numeric_limits<float>::min());
+}
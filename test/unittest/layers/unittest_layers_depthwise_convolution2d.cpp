@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file unittest_layers_depthwise_convolution2d.cpp
+ * @date 16 Oct 2026
+ * @brief Depthwise Conv2d Layer Test
+ * @see	https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug No known bugs except for NYI items
+ */
+#include <tuple>
+
+#include <gtest/gtest.h>
+
+#include <depthwise_conv2d_layer.h>
+#include <layers_common_tests.h>
+
+auto semantic_depthwise_conv2d = LayerSemanticsParamType(
+  nntrainer::createLayer<nntrainer::DepthwiseConv2DLayer>,
+  nntrainer::DepthwiseConv2DLayer::type,
+  {"filters=1", "kernel_size=1,1", "padding=1,1"},
+  LayerCreateSetPropertyOptions::AVAILABLE_FROM_APP_CONTEXT, false, 1);
+
+GTEST_PARAMETER_TEST(DepthwiseConvolution2D, LayerSemantics,
+                     ::testing::Values(semantic_depthwise_conv2d));
+
+auto depthwise_conv2d_sb_same_multiplier = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::DepthwiseConv2DLayer>,
+  {"filters=4", "kernel_size=3,3", "padding=same"}, "1:2:5:5",
+  "depthwise_conv2d_sb_same_multiplier.nnlayergolden",
+  LayerGoldenTestParamOptions::DEFAULT, "nchw", "fp32", "fp32");
+
+auto depthwise_conv2d_mb_same_multiplier = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::DepthwiseConv2DLayer>,
+  {"filters=4", "kernel_size=3,3", "padding=same"}, "2:2:5:5",
+  "depthwise_conv2d_mb_same_multiplier.nnlayergolden",
+  LayerGoldenTestParamOptions::DEFAULT, "nchw", "fp32", "fp32");
+
+auto depthwise_conv2d_sb_valid_stride = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::DepthwiseConv2DLayer>,
+  {"filters=3", "kernel_size=3,3", "stride=2,2"}, "1:3:7:7",
+  "depthwise_conv2d_sb_valid_stride.nnlayergolden",
+  LayerGoldenTestParamOptions::DEFAULT, "nchw", "fp32", "fp32");
+
+auto depthwise_conv2d_mb_valid_stride = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::DepthwiseConv2DLayer>,
+  {"filters=3", "kernel_size=3,3", "stride=2,2"}, "3:3:7:7",
+  "depthwise_conv2d_mb_valid_stride.nnlayergolden",
+  LayerGoldenTestParamOptions::DEFAULT, "nchw", "fp32", "fp32");
+
+auto depthwise_conv2d_mb_same_multiplier_nhwc = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::DepthwiseConv2DLayer>,
+  {"filters=4", "kernel_size=3,3", "padding=same"}, "2:2:5:5",
+  "depthwise_conv2d_mb_same_multiplier_nhwc.nnlayergolden",
+  LayerGoldenTestParamOptions::DEFAULT, "nhwc", "fp32", "fp32");
+
+auto depthwise_conv2d_mb_valid_stride_nhwc = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::DepthwiseConv2DLayer>,
+  {"filters=3", "kernel_size=3,3", "stride=2,2"}, "3:3:7:7",
+  "depthwise_conv2d_mb_valid_stride_nhwc.nnlayergolden",
+  LayerGoldenTestParamOptions::DEFAULT, "nhwc", "fp32", "fp32");
+
+GTEST_PARAMETER_TEST(
+  DepthwiseConvolution2D, LayerGoldenTest,
+  ::testing::Values(depthwise_conv2d_sb_same_multiplier,
+                    depthwise_conv2d_mb_same_multiplier,
+                    depthwise_conv2d_sb_valid_stride,
+                    depthwise_conv2d_mb_valid_stride,
+                    depthwise_conv2d_mb_same_multiplier_nhwc,
+                    depthwise_conv2d_mb_valid_stride_nhwc));
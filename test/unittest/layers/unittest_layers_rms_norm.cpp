@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file unittest_layers_rms_norm.cpp
+ * @date 16 Oct 2026
+ * @brief RMS Normalization Layer Test
+ * @see	https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug No known bugs except for NYI items
+ */
+#include <tuple>
+
+#include <gtest/gtest.h>
+
+#include <layers_common_tests.h>
+#include <rms_norm_layer.h>
+
+auto semantic_rms_norm = LayerSemanticsParamType(
+  nntrainer::createLayer<nntrainer::RMSNormLayer>,
+  nntrainer::RMSNormLayer::type, {},
+  LayerCreateSetPropertyOptions::AVAILABLE_FROM_APP_CONTEXT, false, 1);
+
+auto semantic_rms_norm_epsilon = LayerSemanticsParamType(
+  nntrainer::createLayer<nntrainer::RMSNormLayer>,
+  nntrainer::RMSNormLayer::type, {"epsilon=0.000001"},
+  LayerCreateSetPropertyOptions::AVAILABLE_FROM_APP_CONTEXT, false, 1);
+
+GTEST_PARAMETER_TEST(RMSNorm, LayerSemantics,
+                     ::testing::Values(semantic_rms_norm,
+                                       semantic_rms_norm_epsilon));
+
+auto rms_norm_basic = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::RMSNormLayer>, {}, "2:3:3:6",
+  "rms_norm.nnlayergolden", LayerGoldenTestParamOptions::DEFAULT, "nchw",
+  "fp32", "fp32");
+
+auto rms_norm_single_batch = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::RMSNormLayer>, {}, "1:2:4:5",
+  "rms_norm_single_batch.nnlayergolden", LayerGoldenTestParamOptions::DEFAULT,
+  "nchw", "fp32", "fp32");
+
+GTEST_PARAMETER_TEST(RMSNorm, LayerGoldenTest,
+                     ::testing::Values(rms_norm_basic, rms_norm_single_batch));
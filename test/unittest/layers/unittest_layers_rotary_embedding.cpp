@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file unittest_layers_rotary_embedding.cpp
+ * @date 16 Oct 2026
+ * @brief Rotary Embedding Layer Test
+ * @see	https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug No known bugs except for NYI items
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <layer_context.h>
+#include <nntrainer_test_util.h>
+#include <rotary_embedding_layer.h>
+#include <var_grad.h>
+
+/**
+ * @brief RotaryEmbeddingLayer with its tensors allocated
+ */
+class RotaryEmbeddingRunner {
+public:
+  /**
+   * @brief Construct a new RotaryEmbeddingRunner object
+   *
+   * @param props properties of the layer
+   * @param dim dimension of the input
+   */
+  RotaryEmbeddingRunner(const std::vector<std::string> &props,
+                        const nntrainer::TensorDim &dim) {
+    layer.setProperty(props);
+
+    nntrainer::InitLayerContext init_context({dim}, {true}, false, "rope");
+    layer.finalize(init_context);
+
+    inputs.emplace_back(dim, nntrainer::Tensor::Initializer::NONE, true, true,
+                        "input");
+    outputs.emplace_back(dim, nntrainer::Tensor::Initializer::NONE, true,
+                         true, "output");
+    context = std::make_unique<nntrainer::RunLayerContext>(
+      "rope", false, 0.0f, false, std::vector<nntrainer::Weight *>{},
+      std::vector<nntrainer::Var_Grad *>{&inputs[0]},
+      std::vector<nntrainer::Var_Grad *>{&outputs[0]},
+      std::vector<nntrainer::Var_Grad *>{});
+  }
+
+  nntrainer::RotaryEmbeddingLayer layer;
+  std::vector<nntrainer::Var_Grad> inputs;
+  std::vector<nntrainer::Var_Grad> outputs;
+  std::unique_ptr<nntrainer::RunLayerContext> context;
+};
+
+/**
+ * @brief rotate the head of the row at the position as the reference
+ */
+static void rotateReference(float *head, unsigned int head_dim,
+                            unsigned int position, float theta) {
+  const unsigned int half = head_dim / 2;
+  for (unsigned int i = 0; i < half; ++i) {
+    float angle = position * std::pow(theta, -2.0f * i / head_dim);
+    float x1 = head[i], x2 = head[i + half];
+    head[i] = x1 * std::cos(angle) - x2 * std::sin(angle);
+    head[i + half] = x2 * std::cos(angle) + x1 * std::sin(angle);
+  }
+}
+
+TEST(nntrainer_RotaryEmbedding, forwarding_p) {
+  const int batch = 2, channel = 1, height = 5, width = 12, num_heads = 3;
+  nntrainer::TensorDim dim(batch, channel, height, width);
+  RotaryEmbeddingRunner runner({"num_heads=3", "rope_theta=100"}, dim);
+
+  nntrainer::Tensor &input = runner.context->getInput(0);
+  GEN_TEST_INPUT(input, std::sin(i * 0.3f + j * 0.7f + k * 1.1f + l * 0.5f));
+  nntrainer::Tensor expected = input.clone();
+
+  runner.layer.forwarding(*runner.context, false);
+
+  for (int b = 0; b < batch; ++b) {
+    for (int h = 0; h < height; ++h) {
+      float *row = expected.getAddress<float>(b, 0, h, 0);
+      for (int w = 0; w < width; w += width / num_heads)
+        rotateReference(row + w, width / num_heads, h, 100.0f);
+    }
+  }
+
+  nntrainer::Tensor &output = runner.context->getOutput(0);
+  for (unsigned int i = 0; i < output.size(); ++i)
+    EXPECT_NEAR(output.getData()[i], expected.getData()[i], tolerance);
+}
+
+TEST(nntrainer_RotaryEmbedding, incremental_forwarding_p) {
+  const int batch = 1, channel = 1, height = 4, width = 8;
+  nntrainer::TensorDim dim(batch, channel, height, width);
+  RotaryEmbeddingRunner runner({"num_heads=2"}, dim);
+
+  nntrainer::Tensor &input = runner.context->getInput(0);
+  GEN_TEST_INPUT(input, std::cos(k * 0.9f + l * 0.4f));
+  nntrainer::Tensor expected = input.clone();
+
+  /** a step of two rows at the position 7, beyond the initial tables */
+  runner.layer.incremental_forwarding(*runner.context, 7, 9, false);
+
+  for (unsigned int h = 0; h < 2; ++h) {
+    float *row = expected.getAddress<float>(0, 0, h, 0);
+    rotateReference(row, width / 2, 7 + h, 10000.0f);
+    rotateReference(row + width / 2, width / 2, 7 + h, 10000.0f);
+  }
+
+  nntrainer::Tensor &output = runner.context->getOutput(0);
+  for (unsigned int h = 0; h < 2; ++h) {
+    for (int w = 0; w < width; ++w)
+      EXPECT_NEAR(output.getValue(0, 0, h, w), expected.getValue(0, 0, h, w),
+                  tolerance);
+  }
+}
+
+TEST(nntrainer_RotaryEmbedding, calcDerivative_p) {
+  const int batch = 1, channel = 2, height = 3, width = 4;
+  nntrainer::TensorDim dim(batch, channel, height, width);
+  RotaryEmbeddingRunner runner({}, dim);
+
+  nntrainer::Tensor &input = runner.context->getInput(0);
+  GEN_TEST_INPUT(input, std::sin(j * 0.8f + k * 0.3f + l));
+
+  /** the derivative of the rotation is the inverse rotation */
+  runner.layer.forwarding(*runner.context, true);
+  runner.outputs[0].getGradientRef().copyData(runner.context->getOutput(0));
+  runner.layer.calcDerivative(*runner.context);
+
+  nntrainer::Tensor &d_input = runner.context->getOutgoingDerivative(0);
+  for (unsigned int i = 0; i < input.size(); ++i)
+    EXPECT_NEAR(d_input.getData()[i], input.getData()[i], tolerance);
+}
+
+TEST(nntrainer_RotaryEmbedding, finalize_odd_head_dim_n) {
+  nntrainer::RotaryEmbeddingLayer layer;
+  layer.setProperty({"num_heads=2"});
+
+  nntrainer::InitLayerContext init_context({nntrainer::TensorDim(1, 1, 2, 6)},
+                                           {true}, false, "rope");
+  EXPECT_THROW(layer.finalize(init_context), std::invalid_argument);
+}
@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file unittest_layers_swiglu.cpp
+ * @date 16 Oct 2026
+ * @brief SwiGLU Layer Test
+ * @see	https://github.com/nnstreamer/nntrainer
+ * @author agent <agent@local>
+ * @bug No known bugs except for NYI items
+ */
+#include <tuple>
+
+#include <gtest/gtest.h>
+
+#include <layers_common_tests.h>
+#include <swiglu_layer.h>
+
+auto semantic_swiglu = LayerSemanticsParamType(
+  nntrainer::createLayer<nntrainer::SwiGLULayer>, nntrainer::SwiGLULayer::type,
+  {}, LayerCreateSetPropertyOptions::AVAILABLE_FROM_APP_CONTEXT, false, 2);
+
+GTEST_PARAMETER_TEST(SwiGLU, LayerSemantics,
+                     ::testing::Values(semantic_swiglu));
+
+auto swiglu_basic = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::SwiGLULayer>, {}, "2:3:3:3,2:3:3:3",
+  "swiglu.nnlayergolden", LayerGoldenTestParamOptions::DEFAULT, "nchw", "fp32",
+  "fp32");
+
+GTEST_PARAMETER_TEST(SwiGLU, LayerGoldenTest,
+                     ::testing::Values(swiglu_basic));
@@ -466,6 +466,43 @@ TEST(nntrainer_activation, geluPrime_01_p) {
   }
 }
 
+TEST(nntrainer_activation, run_prime_fn_fused_p) {
+  int batch = 3;
+  int channel = 2;
+  int height = 1;
+  int width = 13;
+
+  for (bool in_place : {false, true}) {
+    for (auto type : {nntrainer::ActivationType::ACT_SIGMOID,
+                      nntrainer::ActivationType::ACT_TANH}) {
+      nntrainer::ActiFunc act(type, in_place);
+      float (*fn)(float);
+      float (*prime)(float);
+      ASSERT_TRUE(act.getElementwiseFn(fn, prime));
+
+      nntrainer::Tensor input(batch, channel, height, width);
+      GEN_TEST_INPUT(input, (l - 4) * 0.1 * (i + 1));
+      nntrainer::Tensor incoming(batch, channel, height, width);
+      GEN_TEST_INPUT(incoming, (l + 1) * 0.05);
+
+      nntrainer::Tensor output(batch, channel, height, width);
+      act.run_fn(input, output);
+      nntrainer::Tensor expected_out = input.apply<float>(fn);
+
+      nntrainer::Tensor outgoing(batch, channel, height, width);
+      act.run_prime_fn(output, outgoing, incoming);
+      nntrainer::Tensor expected = expected_out.apply<float>(prime);
+      expected.multiply_i(incoming);
+
+      for (unsigned int i = 0; i < output.size(); ++i) {
+        EXPECT_NEAR(output.getData()[i], expected_out.getData()[i],
+                    tolerance);
+        EXPECT_NEAR(outgoing.getData()[i], expected.getData()[i], tolerance);
+      }
+    }
+  }
+}
+
 TEST(nntrainer_activation, elu_01_p) {
   int batch = 3;
   int channel = 1;
@@ -22,12 +22,28 @@
  */
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <numeric>
 
+#include <adam.h>
+#include <data_producer.h>
+#include <databuffer.h>
+#include <feature_cache.h>
+#include <generation_engine.h>
+#include <layer_node.h>
 #include <neuralnet.h>
 #include <nntrainer_error.h>
 #include <optimizer.h>
+#include <optimizer_context.h>
+#include <optimizer_wrapped.h>
+#include <prefix_cache.h>
+#include <sgd.h>
+#include <speculative_decoder.h>
+#include <token_sampler.h>
 #include <util_func.h>
+#include <weight.h>
 
 #include <nntrainer_test_util.h>
 
@@ -79,6 +95,965 @@ TEST(nntrainer_Optimizer, setType_04_n) {
     op = ac.createObject<nntrainer::Optimizer>("non-existing type", {}));
 }
 
+/**
+ * @brief make a weight of 6 rows of 4 columns whose gradient is row sparse
+ * over rows 1 and 4, dense_grad is the same gradient in the dense layout
+ */
+static nntrainer::Weight makeSparseWeight(nntrainer::Tensor &dense_grad) {
+  nntrainer::TensorDim dim(1, 1, 6, 4);
+  nntrainer::Tensor var(dim), grad(dim);
+  var.setRandNormal(0.0f, 1.0f);
+  grad.setRandNormal(0.0f, 1.0f);
+
+  dense_grad = nntrainer::Tensor(dim);
+  dense_grad.setZero();
+  const unsigned int rows[] = {1, 4};
+  for (unsigned int k = 0; k < 2; ++k)
+    for (unsigned int i = 0; i < 4; ++i)
+      dense_grad.setValue(0, 0, rows[k], i, grad.getValue(0, 0, k, i));
+
+  nntrainer::Weight w(var, grad, "sparse");
+  w.setSparseGradientAllowed(true);
+  w.setGradientRows({1, 4});
+  return w;
+}
+
+/**
+ * @brief sparse gradient is scattered to the dense layout
+ */
+TEST(nntrainer_Optimizer, sparse_densify_p) {
+  nntrainer::Tensor dense_grad;
+  nntrainer::Weight w = makeSparseWeight(dense_grad);
+
+  w.densifyGradient();
+  EXPECT_FALSE(w.isGradientSparse());
+  EXPECT_EQ(w.getGradientRef(), dense_grad);
+}
+
+/**
+ * @brief sparse gradient is refused if not allowed
+ */
+TEST(nntrainer_Optimizer, sparse_not_allowed_n) {
+  nntrainer::TensorDim dim(1, 1, 6, 4);
+  nntrainer::Tensor var(dim), grad(dim);
+  nntrainer::Weight w(var, grad, "w");
+  EXPECT_THROW(w.setGradientRows({0}), std::runtime_error);
+}
+
+/**
+ * @brief sgd with a sparse gradient matches sgd with the dense gradient
+ */
+TEST(nntrainer_Optimizer, sgd_sparse_p) {
+  nntrainer::Tensor dense_grad;
+  nntrainer::Weight w = makeSparseWeight(dense_grad);
+  nntrainer::Tensor expected = w.getVariableRef().clone();
+  expected.add_i(dense_grad, -0.1f);
+
+  nntrainer::SGD sgd;
+  EXPECT_TRUE(sgd.supportsSparseGradient());
+  nntrainer::RunOptimizerContext context(&w, 0, 0.1);
+  sgd.applyGradient(context);
+  EXPECT_EQ(w.getVariableRef(), expected);
+}
+
+/**
+ * @brief lazy adam with a sparse gradient matches adam with the dense
+ * gradient on the first iteration, when the moments of the other rows are 0
+ */
+TEST(nntrainer_Optimizer, adam_lazy_sparse_p) {
+  for (auto torch_ref : {"torch_ref=false", "torch_ref=true"}) {
+    nntrainer::Tensor dense_grad;
+    nntrainer::Weight w = makeSparseWeight(dense_grad);
+    nntrainer::TensorDim dim = w.getDim();
+    nntrainer::Weight dense(w.getVariableRef().clone(), dense_grad, "dense");
+
+    nntrainer::Tensor wm(dim), wv(dim), dense_wm(dim), dense_wv(dim);
+    for (auto t : {&wm, &wv, &dense_wm, &dense_wv})
+      t->setZero();
+    w.setOptimizerVariables({&wm, &wv});
+    dense.setOptimizerVariables({&dense_wm, &dense_wv});
+
+    nntrainer::Adam adam;
+    EXPECT_FALSE(adam.supportsSparseGradient());
+    adam.setProperty({"lazy_update=true", torch_ref});
+    EXPECT_TRUE(adam.supportsSparseGradient());
+
+    nntrainer::RunOptimizerContext sparse_context(&w, 0, 0.01);
+    nntrainer::RunOptimizerContext dense_context(&dense, 0, 0.01);
+    adam.applyGradient(sparse_context);
+    adam.applyGradient(dense_context);
+
+    const float *a = w.getVariableRef().getData();
+    const float *b = dense.getVariableRef().getData();
+    for (unsigned int i = 0; i < dim.getDataLen(); ++i)
+      EXPECT_NEAR(a[i], b[i], 1e-6f);
+    EXPECT_EQ(wm, dense_wm);
+  }
+}
+
+/**
+ * @brief gradients of the micro-batches are averaged on the last one
+ */
+TEST(nntrainer_Optimizer, accumulate_gradient_p) {
+  nntrainer::TensorDim dim(1, 1, 2, 3);
+  nntrainer::Tensor var(dim), grad(dim), acc(dim), expected(dim);
+  nntrainer::Weight w(var, grad, "w");
+  w.setGradientAccumulator(&acc, 3);
+
+  expected.setZero();
+  for (unsigned int step = 0; step < 3; ++step) {
+    w.getGradientRef().setRandNormal(0.0f, 1.0f);
+    expected.add_i(w.getGradientRef(), 1.0f / 3);
+    EXPECT_EQ(w.accumulateGradient(), step == 2);
+  }
+  EXPECT_EQ(w.getGradientRef(), expected);
+
+  /** the next update starts from scratch */
+  w.getGradientRef().setValue(1.0f);
+  EXPECT_FALSE(w.accumulateGradient());
+}
+
+/**
+ * @brief a weight without accumulator applies every gradient
+ */
+TEST(nntrainer_Optimizer, accumulate_gradient_disabled_p) {
+  nntrainer::TensorDim dim(1, 1, 2, 3);
+  nntrainer::Tensor var(dim), grad(dim), acc(dim);
+  nntrainer::Weight w(var, grad, "w");
+  EXPECT_TRUE(w.accumulateGradient());
+  w.setGradientAccumulator(&acc, 1);
+  EXPECT_TRUE(w.accumulateGradient());
+}
+
+/**
+ * @brief features are stored and loaded by the sample index
+ */
+TEST(nntrainer_FeatureCache, store_load_p) {
+  for (std::string path : {"", "feature_cache_test.bin"}) {
+    {
+      nntrainer::FeatureCache cache(5, path);
+      std::vector<float> feature(5), loaded(5);
+      for (unsigned int idx = 0; idx < 100; ++idx) {
+        std::iota(feature.begin(), feature.end(), static_cast<float>(idx));
+        cache.store(idx * 3, feature.data());
+      }
+
+      EXPECT_EQ(cache.size(), 100u);
+      EXPECT_TRUE(cache.contains({0, 3, 297}));
+      EXPECT_FALSE(cache.contains({0, 1}));
+      EXPECT_FALSE(cache.contains(std::vector<unsigned int>()));
+
+      cache.load(297, loaded.data());
+      for (unsigned int i = 0; i < 5; ++i)
+        EXPECT_EQ(loaded[i], 99.0f + i);
+      EXPECT_THROW(cache.load(1, loaded.data()), std::out_of_range);
+    }
+
+    if (!path.empty()) {
+      EXPECT_FALSE(std::ifstream(path).good());
+    }
+  }
+}
+
+/**
+ * @brief producer of samples of a known size, the inputs of a sample given
+ * again are NaN if poisoned
+ */
+class IndexedProducer : public nntrainer::DataProducer {
+public:
+  IndexedProducer(unsigned int num_samples_, bool poison_) :
+    num_samples(num_samples_), poison(poison_), produced(num_samples_, 0) {}
+
+  const std::string getType() const override { return "indexed"; }
+
+  Generator finalize(const std::vector<nntrainer::TensorDim> &input_dims,
+                     const std::vector<nntrainer::TensorDim> &label_dims,
+                     void *user_data = nullptr) override {
+    return [this](unsigned int idx, std::vector<nntrainer::Tensor> &inputs,
+                  std::vector<nntrainer::Tensor> &labels) {
+      bool again = produced[idx]++ > 0;
+      float *input = inputs[0].getData();
+      for (unsigned int i = 0; i < inputs[0].size(); ++i)
+        input[i] = poison && again ? NAN : 0.1f * (idx + i);
+      labels[0].setValue(0.05f * idx);
+      return false;
+    };
+  }
+
+  unsigned int
+  size(const std::vector<nntrainer::TensorDim> &input_dims,
+       const std::vector<nntrainer::TensorDim> &label_dims) const override {
+    return num_samples;
+  }
+
+private:
+  unsigned int num_samples;
+  bool poison;
+  std::vector<unsigned int> produced;
+};
+
+/**
+ * @brief train a model of a frozen fc and a trainable fc, and get the weight
+ * of the trainable one
+ */
+static std::vector<float> trainFrozenModel(bool feature_cache, bool poison,
+                                           const std::string &path = "") {
+  nntrainer::NeuralNetwork nn;
+  std::vector<std::shared_ptr<nntrainer::LayerNode>> layers = {
+    nntrainer::createLayerNode("input", {"name=in", "input_shape=1:1:4"}),
+    nntrainer::createLayerNode("fully_connected",
+                               {"name=frozen", "unit=3", "trainable=false",
+                                "weight_initializer=ones"}),
+    nntrainer::createLayerNode("fully_connected", {"name=head", "unit=2",
+                                                   "weight_initializer=ones"})};
+  for (auto &layer : layers)
+    nn.addLayer(layer);
+  nn.setOptimizer(
+    nntrainer::createOptimizerWrapped("sgd", {"learning_rate=0.01"}));
+  nn.setProperty({"loss=mse", "batch_size=3", "epochs=3",
+                  feature_cache ? "feature_cache=true" : "feature_cache=false"});
+  if (!path.empty())
+    nn.setProperty({"feature_cache_path=" + path});
+  nn.setDataBuffer(ml::train::DatasetModeType::MODE_TRAIN,
+                   std::make_shared<nntrainer::DataBuffer>(
+                     std::make_unique<IndexedProducer>(7, poison)));
+
+  EXPECT_EQ(nn.compile(), ML_ERROR_NONE);
+  EXPECT_EQ(nn.initialize(), ML_ERROR_NONE);
+  EXPECT_EQ(nn.train(), ML_ERROR_NONE);
+
+  std::vector<float> weight;
+  nn.forEachLayer([&weight](ml::train::Layer &l, nntrainer::RunLayerContext &rc,
+                            void *) {
+    if (l.getName() == "head") {
+      auto &w = rc.getWeight(0);
+      weight.assign(w.getData(), w.getData() + w.size());
+    }
+  });
+  return weight;
+}
+
+/**
+ * @brief the frozen layers are skipped after the first epoch, so the inputs
+ * given again are never read
+ */
+TEST(nntrainer_FeatureCache, skip_frozen_layers_p) {
+  std::vector<float> expected = trainFrozenModel(false, false);
+  for (std::string path : {"", "feature_cache_model.bin"}) {
+    std::vector<float> cached = trainFrozenModel(true, true, path);
+
+    ASSERT_EQ(cached.size(), expected.size());
+    for (unsigned int i = 0; i < expected.size(); ++i)
+      EXPECT_FLOAT_EQ(cached[i], expected[i]);
+  }
+}
+
+/**
+ * @brief without the cache the inputs given again are read
+ */
+TEST(nntrainer_FeatureCache, no_cache_reads_inputs_n) {
+  std::vector<float> weight = trainFrozenModel(false, true);
+  EXPECT_TRUE(std::any_of(weight.begin(), weight.end(),
+                          [](float w) { return std::isnan(w); }));
+}
+
+/**
+ * @brief a dropout before the trainable layers is random at every epoch, so
+ * its output is not cached but computed again after the first epoch
+ */
+TEST(nntrainer_FeatureCache, dropout_not_cached_p) {
+  nntrainer::NeuralNetwork nn;
+  std::vector<std::shared_ptr<nntrainer::LayerNode>> layers = {
+    nntrainer::createLayerNode("input", {"name=in", "input_shape=1:1:8"}),
+    nntrainer::createLayerNode("dropout", {"name=drop", "dropout_rate=0.5"}),
+    nntrainer::createLayerNode("fully_connected", {"name=head", "unit=2"})};
+  for (auto &layer : layers)
+    nn.addLayer(layer);
+  nn.setOptimizer(
+    nntrainer::createOptimizerWrapped("sgd", {"learning_rate=0.01"}));
+  nn.setProperty({"loss=mse", "batch_size=3", "epochs=3", "feature_cache=true"});
+  nn.setDataBuffer(ml::train::DatasetModeType::MODE_TRAIN,
+                   std::make_shared<nntrainer::DataBuffer>(
+                     std::make_unique<IndexedProducer>(3, false)));
+
+  EXPECT_EQ(nn.compile(), ML_ERROR_NONE);
+  EXPECT_EQ(nn.initialize(), ML_ERROR_NONE);
+
+  /** the output of the dropout at the single iteration of every epoch */
+  std::vector<std::vector<float>> dropped;
+  auto epoch_complete = [&nn, &dropped](void *) {
+    nn.forEachLayer(
+      [&dropped](ml::train::Layer &l, nntrainer::RunLayerContext &rc, void *) {
+        if (l.getName() == "drop") {
+          auto &out = rc.getOutput(0);
+          dropped.emplace_back(out.getData(), out.getData() + out.size());
+        }
+      });
+  };
+  EXPECT_EQ(nn.train({}, [](void *) { return false; }, nullptr,
+                     epoch_complete),
+            ML_ERROR_NONE);
+
+  ASSERT_EQ(dropped.size(), 3u);
+  EXPECT_NE(dropped[1], dropped[0]);
+  EXPECT_NE(dropped[2], dropped[1]);
+}
+
+/**
+ * @brief model of a chain of fully connected layers trained on the given
+ * number of samples. The second activation is a checkpoint if given, the wider
+ * layers after it reuse the memory of the recomputed ones
+ */
+static std::unique_ptr<nntrainer::NeuralNetwork>
+createChainModel(bool checkpoint,
+                 const std::vector<std::string> &model_props = {},
+                 unsigned int num_samples = 3) {
+  auto nn = std::make_unique<nntrainer::NeuralNetwork>();
+  std::string is_checkpoint = checkpoint ? "true" : "false";
+  std::vector<std::shared_ptr<nntrainer::LayerNode>> layers = {
+    nntrainer::createLayerNode("input", {"name=in", "input_shape=1:1:4"}),
+    nntrainer::createLayerNode("fully_connected", {"name=fc1", "unit=16"}),
+    nntrainer::createLayerNode("activation",
+                               {"name=act1", "activation=tanh"}),
+    nntrainer::createLayerNode("fully_connected", {"name=fc2", "unit=16"}),
+    nntrainer::createLayerNode("activation",
+                               {"name=act2", "activation=sigmoid",
+                                "checkpoint=" + is_checkpoint}),
+    nntrainer::createLayerNode("fully_connected", {"name=fc3", "unit=32"}),
+    nntrainer::createLayerNode("activation",
+                               {"name=act3", "activation=tanh"}),
+    nntrainer::createLayerNode("fully_connected", {"name=fc4", "unit=2"})};
+  for (auto &layer : layers)
+    nn->addLayer(layer);
+  nn->setOptimizer(
+    nntrainer::createOptimizerWrapped("sgd", {"learning_rate=1"}));
+  nn->setProperty({"loss=mse", "batch_size=3", "epochs=1"});
+  nn->setProperty(model_props);
+  nn->setDataBuffer(ml::train::DatasetModeType::MODE_TRAIN,
+                    std::make_shared<nntrainer::DataBuffer>(
+                      std::make_unique<IndexedProducer>(num_samples, false)));
+
+  EXPECT_EQ(nn->compile(), ML_ERROR_NONE);
+  EXPECT_EQ(nn->initialize(), ML_ERROR_NONE);
+  return nn;
+}
+
+/**
+ * @brief get all the weights of a model
+ */
+static std::vector<float> getWeights(nntrainer::NeuralNetwork &nn) {
+  std::vector<float> weights;
+  nn.forEachLayer(
+    [&weights](ml::train::Layer &l, nntrainer::RunLayerContext &rc, void *) {
+      for (unsigned int i = 0; i < rc.getNumWeights(); ++i) {
+        auto &w = rc.getWeight(i);
+        weights.insert(weights.end(), w.getData(), w.getData() + w.size());
+      }
+    });
+  return weights;
+}
+
+/**
+ * @brief train a model a step from the weights saved in the path
+ */
+static std::vector<float> trainStep(nntrainer::NeuralNetwork &nn,
+                                    const std::string &path) {
+  nn.load(path);
+  EXPECT_EQ(nn.train(), ML_ERROR_NONE);
+  return getWeights(nn);
+}
+
+/**
+ * @brief the weights updated after recomputing the layers between checkpoints
+ * are the ones updated with all the activations kept
+ */
+TEST(nntrainer_NeuralNetwork, recompute_same_gradient_p) {
+  auto nn = createChainModel(false);
+  nn->save("recompute_init.bin");
+  std::vector<float> initial = getWeights(*nn);
+  std::vector<float> expected = trainStep(*nn, "recompute_init.bin");
+
+  std::vector<std::unique_ptr<nntrainer::NeuralNetwork>> recomputed;
+  recomputed.push_back(createChainModel(true));
+  recomputed.push_back(createChainModel(false, {"checkpoint_segments=2"}));
+  recomputed.push_back(createChainModel(false, {"checkpoint_segments=3"}));
+  for (auto &model : recomputed) {
+    std::vector<float> weights = trainStep(*model, "recompute_init.bin");
+
+    ASSERT_EQ(weights.size(), expected.size());
+    for (unsigned int i = 0; i < expected.size(); ++i)
+      EXPECT_FLOAT_EQ(weights[i], expected[i]);
+  }
+  std::remove("recompute_init.bin");
+
+  ASSERT_EQ(initial.size(), expected.size());
+  EXPECT_FALSE(std::equal(initial.begin(), initial.end(), expected.begin()));
+}
+
+/**
+ * @brief the weights updated after accumulating the gradients of micro-batches
+ * are the ones updated by a single batch of all their samples
+ */
+TEST(nntrainer_NeuralNetwork, accumulation_steps_same_gradient_p) {
+  auto nn = createChainModel(false, {"batch_size=6"}, 6);
+  nn->save("accumulation_init.bin");
+  std::vector<float> initial = getWeights(*nn);
+  std::vector<float> expected = trainStep(*nn, "accumulation_init.bin");
+
+  for (unsigned int batch_size : {1u, 2u, 3u}) {
+    nn = createChainModel(
+      false,
+      {"batch_size=" + std::to_string(batch_size),
+       "accumulation_steps=" + std::to_string(6 / batch_size)},
+      6);
+    std::vector<float> weights = trainStep(*nn, "accumulation_init.bin");
+
+    ASSERT_EQ(weights.size(), expected.size());
+    for (unsigned int i = 0; i < expected.size(); ++i)
+      EXPECT_NEAR(weights[i], expected[i], tolerance) << batch_size;
+  }
+  std::remove("accumulation_init.bin");
+
+  ASSERT_EQ(initial.size(), expected.size());
+  EXPECT_FALSE(std::equal(initial.begin(), initial.end(), expected.begin()));
+}
+
+/**
+ * @brief model of a token and a position input of which the logits come from
+ * a multi head attention over the tokens so far
+ */
+static std::unique_ptr<nntrainer::NeuralNetwork> createGenerationModel() {
+  auto nn = std::make_unique<nntrainer::NeuralNetwork>();
+  std::vector<std::shared_ptr<nntrainer::LayerNode>> layers = {
+    nntrainer::createLayerNode("input", {"name=token", "input_shape=1:1:1"}),
+    nntrainer::createLayerNode(
+      "embedding",
+      {"name=wte", "in_dim=16", "out_dim=8", "input_layers=token"}),
+    nntrainer::createLayerNode("input", {"name=pos", "input_shape=1:1:1"}),
+    nntrainer::createLayerNode(
+      "embedding", {"name=wpe", "in_dim=12", "out_dim=8", "input_layers=pos"}),
+    nntrainer::createLayerNode("addition",
+                               {"name=add", "input_layers=wte,wpe"}),
+    nntrainer::createLayerNode("multi_head_attention",
+                               {"name=mha", "num_heads=2", "max_timestep=12",
+                                "input_layers=add,add,add"}),
+    nntrainer::createLayerNode("fully_connected",
+                               {"name=logits", "unit=16", "input_layers=mha"})};
+  for (auto &layer : layers)
+    nn->addLayer(layer);
+  nn->setProperty({"batch_size=1", "input_layers=token,pos"});
+
+  EXPECT_EQ(nn->compile(), ML_ERROR_NONE);
+  EXPECT_EQ(nn->initialize(), ML_ERROR_NONE);
+  return nn;
+}
+
+/**
+ * @brief sequences batched at different positions generate the same tokens
+ * as generated one by one
+ */
+TEST(nntrainer_GenerationEngine, continuous_batching_p) {
+  auto nn = createGenerationModel();
+  std::vector<std::vector<unsigned int>> prompts = {
+    {1, 2, 3}, {4, 5, 6, 7, 8}, {9, 10}};
+  std::vector<unsigned int> max_new_tokens = {2, 6, 4};
+
+  std::vector<std::vector<unsigned int>> expected;
+  {
+    nntrainer::GenerationEngine engine(*nn, 1, 12);
+    for (unsigned int i = 0; i < prompts.size(); ++i) {
+      unsigned int id = engine.submit(prompts[i], max_new_tokens[i]);
+      engine.run();
+      ASSERT_TRUE(engine.isFinished(id));
+      expected.push_back(engine.getTokens(id));
+      EXPECT_EQ(expected.back().size(), max_new_tokens[i]);
+    }
+  }
+
+  nntrainer::GenerationEngine engine(*nn, 2, 12);
+  std::vector<unsigned int> ids;
+  for (unsigned int i = 0; i < prompts.size(); ++i)
+    ids.push_back(engine.submit(prompts[i], max_new_tokens[i]));
+
+  /// the third sequence is admitted as soon as the first one is retired
+  bool admitted_while_running = false;
+  while (engine.step()) {
+    if (engine.getNumWaiting() == 0 && engine.getNumActive() == 2)
+      admitted_while_running = true;
+  }
+  EXPECT_TRUE(admitted_while_running);
+
+  for (unsigned int i = 0; i < prompts.size(); ++i) {
+    EXPECT_TRUE(engine.isFinished(ids[i]));
+    EXPECT_EQ(engine.getTokens(ids[i]), expected[i]);
+    EXPECT_GE(engine.getTimeToFirstToken(ids[i]), 0.0);
+  }
+
+  const auto &stats = engine.getStats();
+  EXPECT_EQ(stats.prompt_tokens, 10u);
+  EXPECT_EQ(stats.generated_tokens, 12u);
+  EXPECT_EQ(stats.first_tokens, 3u);
+  /// 10 prompt and 12 generated tokens, of which the first of every sequence
+  /// comes with its last prompt token, in less steps than one by one
+  EXPECT_LT(stats.steps, 19u);
+  EXPECT_GT(stats.tokensPerSecond(), 0.0);
+
+  engine.release(ids[0]);
+  EXPECT_THROW(engine.isFinished(ids[0]), std::out_of_range);
+}
+
+/**
+ * @brief a prompt longer than the cache is rejected
+ */
+TEST(nntrainer_GenerationEngine, prompt_too_long_n) {
+  auto nn = createGenerationModel();
+  nntrainer::GenerationEngine engine(*nn, 2, 12);
+  EXPECT_THROW(engine.submit(std::vector<unsigned int>(13, 1), 1),
+               std::invalid_argument);
+  EXPECT_THROW(engine.submit({}, 1), std::invalid_argument);
+}
+
+/**
+ * @brief model of which the attention reads a prompt of up to 12 tokens
+ * @param attention_props additional properties of the attention
+ */
+static std::unique_ptr<nntrainer::NeuralNetwork>
+createPrefillModel(const std::vector<std::string> &attention_props = {}) {
+  auto nn = std::make_unique<nntrainer::NeuralNetwork>();
+  std::vector<std::string> mha_props = {"name=mha", "num_heads=2",
+                                        "input_layers=add,add,add"};
+  mha_props.insert(mha_props.end(), attention_props.begin(),
+                   attention_props.end());
+  std::vector<std::shared_ptr<nntrainer::LayerNode>> layers = {
+    nntrainer::createLayerNode("input", {"name=token", "input_shape=1:1:12"}),
+    nntrainer::createLayerNode(
+      "embedding",
+      {"name=wte", "in_dim=16", "out_dim=8", "input_layers=token"}),
+    nntrainer::createLayerNode("input", {"name=pos", "input_shape=1:1:12"}),
+    nntrainer::createLayerNode(
+      "embedding", {"name=wpe", "in_dim=12", "out_dim=8", "input_layers=pos"}),
+    nntrainer::createLayerNode("addition",
+                               {"name=add", "input_layers=wte,wpe"}),
+    nntrainer::createLayerNode("multi_head_attention", mha_props),
+    nntrainer::createLayerNode("fully_connected",
+                               {"name=logits", "unit=16", "input_layers=mha"})};
+  for (auto &layer : layers)
+    nn->addLayer(layer);
+  nn->setProperty({"batch_size=1", "input_layers=token,pos"});
+
+  EXPECT_EQ(nn->compile(), ML_ERROR_NONE);
+  EXPECT_EQ(nn->initialize(), ML_ERROR_NONE);
+  return nn;
+}
+
+/**
+ * @brief token and position inputs of the prompt
+ */
+static nntrainer::sharedConstTensors
+createPrompt(const std::vector<unsigned int> &tokens) {
+  nntrainer::Tensor token(1, 1, 1, 12);
+  nntrainer::Tensor pos(1, 1, 1, 12);
+  token.setZero();
+  for (unsigned int i = 0; i < 12; ++i) {
+    if (i < tokens.size())
+      token.setValue(0, 0, 0, i, tokens[i]);
+    pos.setValue(0, 0, 0, i, i);
+  }
+  return {MAKE_SHARED_TENSOR(token), MAKE_SHARED_TENSOR(pos)};
+}
+
+/**
+ * @brief logits at the last token of the prompt read at once
+ */
+static std::vector<float>
+prefillAtOnce(nntrainer::NeuralNetwork &nn,
+              const std::vector<unsigned int> &tokens) {
+  unsigned int len = tokens.size();
+  auto out = nn.incremental_inference(createPrompt(tokens), 12, 0, len);
+  const float *data = out[0]->getData() + (len - 1) * 16;
+  return std::vector<float>(data, data + 16);
+}
+
+/**
+ * @brief prompt read in chunks against the growing cache gives the logits of
+ * the prompt read at once
+ */
+TEST(nntrainer_NeuralNetwork, incremental_prefill_chunks_p) {
+  auto nn = createPrefillModel();
+  std::vector<unsigned int> tokens = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+  auto expected = prefillAtOnce(*nn, tokens);
+
+  for (unsigned int chunk_size : {1u, 3u, 4u, 12u}) {
+    auto out = nn->incremental_prefill(createPrompt(tokens), 12, tokens.size(),
+                                       chunk_size);
+    ASSERT_EQ(out[0]->getDim().getDataLen(), 16u);
+    for (unsigned int i = 0; i < 16; ++i)
+      EXPECT_NEAR(out[0]->getData()[i], expected[i], 1e-5) << chunk_size;
+  }
+}
+
+/**
+ * @brief chunks of the prompt are attended with the attention weight kept as
+ * well, giving the logits of the prompt read at once
+ */
+TEST(nntrainer_NeuralNetwork, incremental_prefill_chunks_attention_weight_p) {
+  auto nn = createPrefillModel();
+  auto weighted = createPrefillModel({"return_attention_weight=after"});
+  nn->allocate(nntrainer::ExecutionMode::INFERENCE);
+  nn->save("attention_weight.bin");
+  weighted->load("attention_weight.bin");
+  std::remove("attention_weight.bin");
+
+  std::vector<unsigned int> tokens = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+  auto expected = prefillAtOnce(*nn, tokens);
+
+  for (unsigned int chunk_size : {1u, 3u, 4u}) {
+    auto out = weighted->incremental_prefill(createPrompt(tokens), 12,
+                                             tokens.size(), chunk_size);
+    ASSERT_EQ(out[0]->getDim().getDataLen(), 16u);
+    for (unsigned int i = 0; i < 16; ++i)
+      EXPECT_NEAR(out[0]->getData()[i], expected[i], 1e-5) << chunk_size;
+  }
+}
+
+/**
+ * @brief prompts sharing a prefix restore its blocks instead of computing
+ */
+TEST(nntrainer_NeuralNetwork, incremental_prefill_prefix_cache_p) {
+  auto nn = createPrefillModel();
+  nntrainer::PrefixCache prefix_cache(4, 16);
+
+  std::vector<unsigned int> first = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+  std::vector<unsigned int> shared = {3, 1, 4, 1, 5, 9, 2, 6, 7, 7, 8};
+  std::vector<unsigned int> diverged = {3, 1, 4, 1, 0, 9, 2, 6, 7};
+  std::vector<unsigned int> prefix_only = {3, 1, 4, 1, 5, 9, 2, 6};
+
+  nn->incremental_prefill(createPrompt(first), 12, first.size(), 3,
+                          &prefix_cache);
+  EXPECT_EQ(prefix_cache.size(), 2u);
+  EXPECT_EQ(prefix_cache.getNumRestoredTokens(), 0u);
+
+  std::vector<std::pair<std::vector<unsigned int>, size_t>> prompts = {
+    {shared, 8}, {diverged, 4}, {prefix_only, 4}};
+  size_t restored = 0;
+  for (auto &[tokens, num_restored] : prompts) {
+    auto expected = prefillAtOnce(*nn, tokens);
+    auto out = nn->incremental_prefill(createPrompt(tokens), 12, tokens.size(),
+                                       3, &prefix_cache);
+
+    restored += num_restored;
+    EXPECT_EQ(prefix_cache.getNumRestoredTokens(), restored);
+    for (unsigned int i = 0; i < 16; ++i)
+      EXPECT_NEAR(out[0]->getData()[i], expected[i], 1e-5);
+  }
+
+  /** the second block of the diverged prompt is added */
+  EXPECT_EQ(prefix_cache.size(), 3u);
+}
+
+/**
+ * @brief the least recently used block is evicted
+ */
+TEST(nntrainer_NeuralNetwork, incremental_prefill_prefix_cache_evict_p) {
+  auto nn = createPrefillModel();
+  nntrainer::PrefixCache prefix_cache(4, 2);
+
+  std::vector<unsigned int> first = {3, 1, 4, 1, 5, 9, 2, 6, 5};
+  std::vector<unsigned int> second = {2, 7, 1, 8, 2};
+
+  nn->incremental_prefill(createPrompt(first), 12, first.size(), 4,
+                          &prefix_cache);
+  nn->incremental_prefill(createPrompt(second), 12, second.size(), 4,
+                          &prefix_cache);
+  EXPECT_EQ(prefix_cache.size(), 2u);
+
+  /** the second block of the first prompt is evicted but its first block */
+  nn->incremental_prefill(createPrompt(first), 12, first.size(), 4,
+                          &prefix_cache);
+  EXPECT_EQ(prefix_cache.getNumRestoredTokens(), 4u);
+}
+
+/**
+ * @brief a prompt exceeding the input is rejected
+ */
+TEST(nntrainer_NeuralNetwork, incremental_prefill_too_long_n) {
+  auto nn = createPrefillModel();
+  EXPECT_THROW(nn->incremental_prefill(createPrompt({1, 2}), 12, 13, 4),
+               std::invalid_argument);
+  EXPECT_THROW(nn->incremental_prefill(createPrompt({1, 2}), 12, 2, 0),
+               std::invalid_argument);
+}
+
+/**
+ * @brief an int8 key/value cache gives logits close to the ones of the float
+ * cache, and its scales are restored with the prefix blocks
+ */
+TEST(nntrainer_NeuralNetwork, incremental_prefill_int8_cache_p) {
+  auto nn = createPrefillModel();
+  auto quantized = createPrefillModel({"kv_cache_dtype=int8"});
+  nn->allocate(nntrainer::ExecutionMode::INFERENCE);
+  nn->save("int8_cache.bin");
+  quantized->load("int8_cache.bin");
+  std::remove("int8_cache.bin");
+
+  std::vector<unsigned int> tokens = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+  auto expected = prefillAtOnce(*nn, tokens);
+  auto quantized_expected = prefillAtOnce(*quantized, tokens);
+  for (unsigned int i = 0; i < 16; ++i)
+    EXPECT_NEAR(quantized_expected[i], expected[i], 5e-2);
+
+  nntrainer::PrefixCache prefix_cache(4, 16);
+  quantized->incremental_prefill(createPrompt(tokens), 12, tokens.size(), 3,
+                                 &prefix_cache);
+  auto out = quantized->incremental_prefill(createPrompt(tokens), 12,
+                                            tokens.size(), 3, &prefix_cache);
+  EXPECT_EQ(prefix_cache.getNumRestoredTokens(), 8u);
+  for (unsigned int i = 0; i < 16; ++i)
+    EXPECT_NEAR(out[0]->getData()[i], quantized_expected[i], 1e-5);
+}
+
+#ifdef ENABLE_FP16
+/**
+ * @brief a fp16 key/value cache gives logits close to the ones of the float
+ * cache, whether the prompt is read at once or in chunks against the cache
+ */
+TEST(nntrainer_NeuralNetwork, incremental_prefill_fp16_cache_p) {
+  auto nn = createPrefillModel();
+  auto half = createPrefillModel({"kv_cache_dtype=fp16"});
+  nn->allocate(nntrainer::ExecutionMode::INFERENCE);
+  nn->save("fp16_cache.bin");
+  half->load("fp16_cache.bin");
+  std::remove("fp16_cache.bin");
+
+  std::vector<unsigned int> tokens = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+  auto expected = prefillAtOnce(*nn, tokens);
+  auto half_expected = prefillAtOnce(*half, tokens);
+  for (unsigned int i = 0; i < 16; ++i)
+    EXPECT_NEAR(half_expected[i], expected[i], 1e-3);
+
+  for (unsigned int chunk_size : {1u, 3u}) {
+    auto out = half->incremental_prefill(createPrompt(tokens), 12,
+                                         tokens.size(), chunk_size);
+    for (unsigned int i = 0; i < 16; ++i)
+      EXPECT_NEAR(out[0]->getData()[i], expected[i], 1e-3) << chunk_size;
+  }
+}
+#endif
+
+/**
+ * @brief an unknown data type of the key/value cache is rejected
+ */
+TEST(nntrainer_NeuralNetwork, kv_cache_dtype_n) {
+  EXPECT_THROW(nntrainer::createLayerNode(
+                 "multi_head_attention",
+                 {"name=mha", "num_heads=2", "kv_cache_dtype=int4"}),
+               std::invalid_argument);
+}
+
+/**
+ * @brief tokens generated greedily by reading the whole sequence every step
+ */
+static std::vector<unsigned int>
+decodeGreedy(nntrainer::NeuralNetwork &nn, std::vector<unsigned int> sequence,
+             unsigned int num_tokens) {
+  std::vector<unsigned int> generated;
+  for (unsigned int i = 0; i < num_tokens; ++i) {
+    auto logits = prefillAtOnce(nn, sequence);
+    unsigned int token =
+      std::max_element(logits.begin(), logits.end()) - logits.begin();
+    sequence.push_back(token);
+    generated.push_back(token);
+  }
+  return generated;
+}
+
+/**
+ * @brief a draft model of the target weights has all the proposals accepted
+ */
+TEST(nntrainer_SpeculativeDecoder, same_draft_p) {
+  auto target = createPrefillModel();
+  auto draft = createPrefillModel();
+  target->allocate(nntrainer::ExecutionMode::INFERENCE);
+  target->save("speculative_target.bin");
+  draft->load("speculative_target.bin");
+  std::remove("speculative_target.bin");
+
+  std::vector<unsigned int> prompt = {3, 1, 4};
+  auto expected = decodeGreedy(*target, prompt, 8);
+
+  nntrainer::SpeculativeDecoder decoder(*target, *draft, 3, 12);
+  EXPECT_EQ(decoder.generate(prompt, 8), expected);
+
+  const auto &stats = decoder.getStats();
+  EXPECT_EQ(stats.generated, 8u);
+  EXPECT_EQ(stats.drafted, 6u);
+  EXPECT_EQ(stats.accepted, 6u);
+  EXPECT_EQ(stats.target_passes, 2u);
+  EXPECT_DOUBLE_EQ(stats.acceptanceRate(), 1.0);
+  EXPECT_DOUBLE_EQ(stats.speedup(), 4.0);
+}
+
+/**
+ * @brief the proposals of another draft model do not change the tokens
+ */
+TEST(nntrainer_SpeculativeDecoder, other_draft_p) {
+  auto target = createPrefillModel();
+  auto draft = createPrefillModel();
+
+  std::vector<unsigned int> prompt = {2, 7, 1, 8};
+  auto expected = decodeGreedy(*target, prompt, 7);
+
+  nntrainer::SpeculativeDecoder decoder(*target, *draft, 2, 12);
+  EXPECT_EQ(decoder.generate(prompt, 7), expected);
+  /** a sequence after another one starts from the first position again */
+  EXPECT_EQ(decoder.generate(prompt, 7), expected);
+
+  const auto &stats = decoder.getStats();
+  EXPECT_EQ(stats.generated, 14u);
+  EXPECT_LE(stats.accepted, stats.drafted);
+  EXPECT_LE(stats.target_passes, 14u);
+  EXPECT_GE(stats.speedup(), 1.0);
+}
+
+/**
+ * @brief the generation stops at max_length
+ */
+TEST(nntrainer_SpeculativeDecoder, max_length_p) {
+  auto target = createPrefillModel();
+  auto draft = createPrefillModel();
+
+  std::vector<unsigned int> prompt = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+  nntrainer::SpeculativeDecoder decoder(*target, *draft, 4, 12);
+  EXPECT_EQ(decoder.generate(prompt, 8), decodeGreedy(*target, prompt, 2));
+}
+
+/**
+ * @brief a prompt leaving no room for a token is rejected
+ */
+TEST(nntrainer_SpeculativeDecoder, prompt_too_long_n) {
+  auto target = createPrefillModel();
+  auto draft = createPrefillModel();
+
+  nntrainer::SpeculativeDecoder decoder(*target, *draft, 4, 12);
+  EXPECT_THROW(decoder.generate(std::vector<unsigned int>(12, 1), 1),
+               std::invalid_argument);
+  EXPECT_THROW(nntrainer::SpeculativeDecoder(*target, *draft, 4, 13),
+               std::invalid_argument);
+}
+
+/**
+ * @brief logits with distinct values in a shuffled order
+ */
+static std::vector<float> createLogits(unsigned int num_vocab) {
+  std::vector<float> logits(num_vocab);
+  for (unsigned int i = 0; i < num_vocab; ++i)
+    logits[i] = (float)((i * 37) % num_vocab) / 100.0f;
+  return logits;
+}
+
+/**
+ * @brief top-k picks the same tokens as sorting the vocabulary
+ */
+TEST(nntrainer_TokenSampler, top_k_p) {
+  std::vector<float> logits = createLogits(1000);
+  std::vector<unsigned int> sorted(logits.size());
+  std::iota(sorted.begin(), sorted.end(), 0);
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [&](unsigned int a, unsigned int b) {
+                     return logits[a] > logits[b];
+                   });
+
+  std::vector<unsigned int> top =
+    nntrainer::TokenSampler::topK(logits.data(), logits.size(), 10);
+  EXPECT_EQ(top, std::vector<unsigned int>(sorted.begin(), sorted.begin() + 10));
+}
+
+/**
+ * @brief zero temperature picks the most probable token of every row
+ */
+TEST(nntrainer_TokenSampler, greedy_batch_p) {
+  std::vector<float> logits = createLogits(100);
+  logits.insert(logits.end(), logits.rbegin(), logits.rend());
+
+  nntrainer::TokenSampler::Options options;
+  options.temperature = 0.0f;
+  nntrainer::TokenSampler sampler(options, 0);
+
+  std::vector<unsigned int> tokens =
+    sampler.sampleBatch(logits.data(), 2, 100);
+  EXPECT_EQ(tokens, std::vector<unsigned int>({27, 72}));
+}
+
+/**
+ * @brief sampled tokens stay in the top-k and top-p candidates, and the same
+ * seed draws the same tokens
+ */
+TEST(nntrainer_TokenSampler, top_k_top_p_seeded_p) {
+  const std::vector<float> logits = createLogits(1000);
+  std::vector<unsigned int> top =
+    nntrainer::TokenSampler::topK(logits.data(), logits.size(), 4);
+
+  nntrainer::TokenSampler::Options options;
+  options.temperature = 0.01f;
+  options.top_k = 4;
+  options.top_p = 0.9f;
+  nntrainer::TokenSampler sampler(options, 7);
+  nntrainer::TokenSampler other(options, 7);
+
+  for (unsigned int i = 0; i < 100; ++i) {
+    std::vector<float> row = logits;
+    unsigned int token = sampler.sample(row.data(), row.size());
+    EXPECT_NE(std::find(top.begin(), top.begin() + 3, token),
+              top.begin() + 3);
+
+    row = logits;
+    EXPECT_EQ(other.sample(row.data(), row.size()), token);
+  }
+}
+
+/**
+ * @brief bad words are never picked and repeated tokens are penalized
+ */
+TEST(nntrainer_TokenSampler, penalties_p) {
+  std::vector<float> logits = {1.0f, 3.0f, 2.9f, 2.0f, -1.0f};
+
+  nntrainer::TokenSampler::Options options;
+  options.temperature = 0.0f;
+  options.bad_words = {1};
+  options.repetition_penalty = 2.0f;
+  nntrainer::TokenSampler sampler(options, 0);
+
+  std::vector<float> row = logits;
+  EXPECT_EQ(sampler.sample(row.data(), row.size()), 2u);
+
+  row = logits;
+  EXPECT_EQ(sampler.sample(row.data(), row.size(), {2, 2, 4}), 3u);
+  EXPECT_FLOAT_EQ(row[2], 1.45f);
+  EXPECT_FLOAT_EQ(row[4], -2.0f);
+}
+
+/**
+ * @brief invalid options and tokens out of the vocabulary are rejected
+ */
+TEST(nntrainer_TokenSampler, invalid_n) {
+  nntrainer::TokenSampler::Options options;
+  options.top_p = 0.0f;
+  EXPECT_THROW(nntrainer::TokenSampler(options, 0), std::invalid_argument);
+
+  options.top_p = 1.0f;
+  options.temperature = -1.0f;
+  EXPECT_THROW(nntrainer::TokenSampler(options, 0), std::invalid_argument);
+
+  options.temperature = 1.0f;
+  options.bad_words = {5};
+  nntrainer::TokenSampler sampler(options, 0);
+  std::vector<float> logits = createLogits(5);
+  EXPECT_THROW(sampler.sample(logits.data(), logits.size()),
+               std::invalid_argument);
+  EXPECT_THROW(nntrainer::TokenSampler::topK(logits.data(), 5, 6),
+               std::invalid_argument);
+}
+
 TEST(nntrainer_throw_if, throw_invalid_arg_p) {
   try {
     NNTR_THROW_IF(1 == 1, std::invalid_argument) << "error msg";
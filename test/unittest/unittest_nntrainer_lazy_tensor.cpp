@@ -161,6 +161,51 @@ TEST_F(nntrainer_LazyTensorOpsTest, LazyTensorOps_08_p) {
   EXPECT_TRUE(target.chain().sum(3).run() == expected);
 }
 
+// fused element-wise chain with broadcast operands
+TEST_F(nntrainer_LazyTensorOpsTest, LazyTensorOps_09_p) {
+  nntrainer::Tensor row = ranged(1, 1, 1, 10);
+  nntrainer::Tensor col = ranged(3, 1, 2, 1);
+  col.add_i(1.0f);
+
+  expected.copy(target);
+  expected.multiply_i(2.0f);
+  expected.add_i(row, 0.5f);
+  expected.divide_i(col);
+  expected.subtract_i(1.0f);
+  expected = expected.apply<float>([](float x) { return x * x; });
+
+  nntrainer::Tensor result = target.chain()
+                               .multiply_i(2.0f)
+                               .add_i(row, 0.5f)
+                               .divide_i(col)
+                               .subtract_i(1.0f)
+                               .apply([](float x) { return x * x; })
+                               .run();
+  EXPECT_EQ(result, expected);
+  EXPECT_EQ(target, original);
+}
+
+// fused chain evaluated in place, mixed with an unfused operation
+TEST_F(nntrainer_LazyTensorOpsTest, LazyTensorOps_10_p) {
+  nntrainer::Tensor other = target.clone();
+  target.chain().multiply_i(other).add_i(other, -1.0f).run(target);
+
+  expected = original.multiply(original).subtract(original);
+  EXPECT_EQ(target, expected);
+
+  expected = expected.sum(3).add(1.0f);
+  EXPECT_EQ(target.chain().sum(3).add_i(1.0f).run(), expected);
+}
+
+// fused chain errors
+TEST_F(nntrainer_LazyTensorOpsTest, LazyTensorOps_09_n) {
+  EXPECT_THROW(target.chain().add_i(1.0f).divide_i(0.0f).run(),
+               std::runtime_error);
+
+  nntrainer::Tensor output(1, 1, 1, 1);
+  EXPECT_THROW(target.chain().add_i(1.0f).run(output), std::runtime_error);
+}
+
 /**
  * @brief Main gtest
  */
@@ -16,7 +16,9 @@
 #include <fstream>
 #include <nntrainer_error.h>
 #include <tensor.h>
+#include <tensor_allocator.h>
 #include <tensor_dim.h>
+#include <thread>
 
 TEST(nntrainer_TensorDim, ctor_initializer_p) {
   unsigned int b = 3;
@@ -4704,6 +4706,226 @@ TEST(nntrainer_Tensor, inv_sqrt_i_uncontiguous_p) {
   }
 }
 
+TEST(nntrainer_Tensor, allocator_reuse_p) {
+  auto &allocator = nntrainer::TensorAllocator::Global();
+  allocator.release();
+  allocator.resetStats();
+
+  float *addr = nullptr;
+  {
+    nntrainer::Tensor t(3, 5, 7, 11);
+    addr = t.getData();
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(addr) %
+                nntrainer::TensorAllocator::ALIGNMENT,
+              0u);
+    t.setValue(3.0f);
+  }
+
+  /** a tensor of the same size class reuses the memory zero filled */
+  nntrainer::Tensor t(3, 5, 7, 10);
+  EXPECT_EQ(t.getData(), addr);
+  EXPECT_EQ(t.getValue(2, 4, 6, 9), 0.0f);
+
+  auto stats = allocator.getStats();
+  EXPECT_EQ(stats.allocations, 2u);
+  EXPECT_EQ(stats.system_allocations, 1u);
+  EXPECT_EQ(stats.bytes, (3 * 5 * 7 * 11 + 3 * 5 * 7 * 10) * sizeof(float));
+}
+
+TEST(nntrainer_Tensor, allocator_size_class_p) {
+  using nntrainer::TensorAllocator;
+  EXPECT_EQ(TensorAllocator::getAllocationSize(1), 64u);
+  EXPECT_EQ(TensorAllocator::getAllocationSize(64), 64u);
+  EXPECT_EQ(TensorAllocator::getAllocationSize(65), 80u);
+  EXPECT_EQ(TensorAllocator::getAllocationSize(128), 128u);
+  EXPECT_EQ(TensorAllocator::getAllocationSize(1000), 1024u);
+  EXPECT_EQ(TensorAllocator::getAllocationSize(1025), 1280u);
+  size_t unpooled = TensorAllocator::MAX_POOLED_BYTES + 1;
+  EXPECT_EQ(TensorAllocator::getAllocationSize(unpooled),
+            TensorAllocator::MAX_POOLED_BYTES + TensorAllocator::ALIGNMENT);
+}
+
+TEST(nntrainer_Tensor, transform_unary_p) {
+  nntrainer::Tensor input = ranged(2, 3, 4, 5);
+
+  nntrainer::Tensor output;
+  input.transform<float>([](float x) { return x * x + 1.0f; }, output);
+  ASSERT_EQ(output.getDim(), input.getDim());
+
+  for (unsigned int i = 0; i < input.size(); ++i)
+    EXPECT_FLOAT_EQ(output.getData()[i],
+                    input.getData()[i] * input.getData()[i] + 1.0f);
+
+  /** non contiguous input goes through the strided path */
+  nntrainer::Tensor shared = input.getSharedDataTensor({2, 3, 4, 2}, 3, false);
+  nntrainer::Tensor shared_out;
+  shared.transform<float>([](float x) { return -x; }, shared_out);
+  for (unsigned int h = 0; h < 4; ++h)
+    for (unsigned int w = 0; w < 2; ++w)
+      EXPECT_FLOAT_EQ(shared_out.getValue(1, 2, h, w),
+                      -input.getValue(1, 2, h, w + 3));
+}
+
+TEST(nntrainer_Tensor, transform_binary_broadcast_p) {
+  nntrainer::Tensor input = ranged(2, 3, 4, 5);
+  nntrainer::Tensor m = ranged(1, 3, 1, 5);
+
+  nntrainer::Tensor output;
+  input.transform<float>([](float a, float b) { return a * 2.0f - b; }, m,
+                         output);
+
+  nntrainer::Tensor expected = input.multiply(2.0f);
+  expected.subtract_i(m);
+  EXPECT_EQ(output, expected);
+
+  /** in place with a broadcast scalar */
+  nntrainer::Tensor s(1, 1, 1, 1);
+  s.setValue(3.0f);
+  input.transform<float>([](float a, float b) { return a + b; }, s, input);
+  EXPECT_FLOAT_EQ(input.getValue(1, 2, 3, 4), 119.0f + 3.0f);
+}
+
+TEST(nntrainer_Tensor, transform_binary_large_serial_p) {
+  nntrainer::Tensor input(1, 3, 300, 301);
+  input.setValue(1.0f);
+
+  /** a stateful functor is called on the calling thread only, even for the
+   * tensors large enough to split the element-wise ops over the threads */
+  const std::thread::id caller = std::this_thread::get_id();
+  for (const auto &m_dim : {nntrainer::TensorDim(1, 3, 300, 301),
+                            nntrainer::TensorDim(1, 3, 1, 301)}) {
+    nntrainer::Tensor m(m_dim);
+    m.setValue(2.0f);
+    size_t calls = 0, other_thread = 0;
+    nntrainer::Tensor output;
+    input.transform<float>(
+      [&](float a, float b) {
+        calls++;
+        other_thread += std::this_thread::get_id() != caller;
+        return a + b;
+      },
+      m, output);
+
+    EXPECT_EQ(calls, input.size());
+    EXPECT_EQ(other_thread, 0u);
+    EXPECT_FLOAT_EQ(output.getValue(0, 2, 299, 300), 3.0f);
+  }
+}
+
+TEST(nntrainer_Tensor, sum_axes_single_pass_p) {
+  nntrainer::Tensor t(3, 4, 5, 6);
+  float v = 0.0f;
+  t = t.apply<float>([&v](float) { return std::sin(v++) * 10.0f; });
+
+  for (unsigned int mask = 1; mask < 16; ++mask) {
+    std::vector<unsigned int> axes;
+    nntrainer::TensorDim ret_dim = t.getDim();
+    for (unsigned int axis = 0; axis < 4; ++axis) {
+      if (mask & (1 << axis)) {
+        axes.push_back(axis);
+        ret_dim.setTensorDim(axis, 1);
+      }
+    }
+
+    nntrainer::Tensor result = t.sum(axes, 0.5f);
+    ASSERT_EQ(result.getDim(), ret_dim);
+
+    std::vector<double> expected(ret_dim.getDataLen(), 0.0);
+    for (unsigned int b = 0; b < 3; ++b)
+      for (unsigned int c = 0; c < 4; ++c)
+        for (unsigned int h = 0; h < 5; ++h)
+          for (unsigned int w = 0; w < 6; ++w) {
+            unsigned int idx[4] = {b, c, h, w};
+            for (auto axis : axes)
+              idx[axis] = 0;
+            size_t o = result.getIndex(idx[0], idx[1], idx[2], idx[3]);
+            expected[o] += 0.5 * t.getValue(b, c, h, w);
+          }
+
+    for (size_t i = 0; i < expected.size(); ++i)
+      EXPECT_NEAR(result.getData()[i], expected[i], 1e-4) << "mask " << mask;
+  }
+}
+
+TEST(nntrainer_Tensor, sum_pairwise_accuracy_p) {
+  const unsigned int len = 1 << 22;
+  nntrainer::Tensor t(1, 1, 1, len);
+  t.setValue(0.1f);
+
+  double expected = static_cast<double>(0.1f) * len;
+  EXPECT_NEAR(t.sum(3).getValue(0, 0, 0, 0), expected, expected * 1e-6);
+  EXPECT_NEAR(t.average().getValue(0, 0, 0, 0), 0.1f, 1e-6);
+  EXPECT_NEAR(t.l2norm(), std::sqrt(static_cast<double>(0.1f) * 0.1f * len),
+              1e-3);
+}
+
+TEST(nntrainer_Tensor, l2norm_no_overflow_underflow_p) {
+  nntrainer::Tensor t(1, 1, 3, 7);
+  for (float scale : {1e25f, 1e-25f, 1e-35f}) {
+    t.setValue(3.0f * scale);
+    t.setValue(0, 0, 1, 2, 4.0f * scale);
+
+    double expected = std::sqrt(20.0 * 9.0 + 16.0) * scale;
+    EXPECT_NEAR(t.l2norm(), expected, expected * 1e-5) << "scale " << scale;
+  }
+
+  t.setValue(0.0f);
+  EXPECT_EQ(t.l2norm(), 0.0f);
+}
+
+TEST(nntrainer_Tensor, multiply_broadcast_large_p) {
+  nntrainer::Tensor t(2, 4, 256, 300);
+  float v = 0.0f;
+  t = t.apply<float>([&v](float) { return std::sin(v++); });
+
+  std::vector<nntrainer::TensorDim> m_dims = {
+    {1, 4, 1, 300}, {2, 1, 256, 1}, {1, 1, 1, 1}, {2, 4, 256, 1},
+    {1, 4, 256, 300}, {2, 4, 256, 300}};
+
+  for (auto &m_dim : m_dims) {
+    nntrainer::Tensor m(m_dim);
+    m = m.apply<float>([&v](float) { return std::cos(v++); });
+
+    nntrainer::Tensor product = t.multiply(m);
+    nntrainer::Tensor sum = t.clone();
+    EXPECT_EQ(sum.add_i(m, 2.0f), ML_ERROR_NONE);
+
+    for (unsigned int b = 0; b < t.batch(); ++b)
+      for (unsigned int c = 0; c < t.channel(); ++c)
+        for (unsigned int h = 0; h < t.height(); ++h)
+          for (unsigned int w = 0; w < t.width(); ++w) {
+            float x = t.getValue(b, c, h, w);
+            float y = m.getValue(b % m_dim.batch(), c % m_dim.channel(),
+                                 h % m_dim.height(), w % m_dim.width());
+            ASSERT_FLOAT_EQ(product.getValue(b, c, h, w), x * y) << m_dim;
+            ASSERT_FLOAT_EQ(sum.getValue(b, c, h, w), x + 2.0f * y) << m_dim;
+          }
+  }
+}
+
+TEST(nntrainer_Tensor, elementwise_scalar_large_p) {
+  nntrainer::Tensor t(1, 3, 300, 301);
+  float v = 0.0f;
+  t = t.apply<float>([&v](float) { return v++; });
+
+  nntrainer::Tensor added = t.add(1.5f);
+  nntrainer::Tensor divided = t.divide(4.0f);
+  nntrainer::Tensor copied(t.getDim());
+  copied.copyData(t);
+  t.multiply_i(2.0f);
+
+  const float *data = t.getData();
+  for (size_t i = 0; i < t.size(); ++i) {
+    ASSERT_FLOAT_EQ(added.getData()[i], i + 1.5f);
+    ASSERT_FLOAT_EQ(divided.getData()[i], i / 4.0f);
+    ASSERT_FLOAT_EQ(copied.getData()[i], i);
+    ASSERT_FLOAT_EQ(data[i], i * 2.0f);
+  }
+
+  t.setZero();
+  EXPECT_EQ(t.l2norm(), 0.0f);
+}
+
 int main(int argc, char **argv) {
   int result = -1;
 
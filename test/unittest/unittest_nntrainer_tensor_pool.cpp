@@ -405,6 +405,58 @@ TEST(TensorPool, allocate_deallocate_03_p) {
   EXPECT_FALSE(t3->isAllocated());
 }
 
+/**
+ * @brief smaller batch bound to the allocated memory
+ */
+TEST(TensorPool, unbind_bind_smaller_batch_p) {
+  nntrainer::TensorPool pool;
+  nntrainer::Tensor *t1 = nullptr, *t2 = nullptr;
+
+  EXPECT_NO_THROW(
+    t1 = pool.request("abc", nntrainer::TensorDim({4, 1, 1, 3}), {0}, max_ls));
+  EXPECT_NO_THROW(t2 = pool.view("abc1", "abc",
+                                 nntrainer::TensorDim({4, 1, 1, 3}), {1},
+                                 max_ls));
+
+  EXPECT_FALSE(pool.unbind());
+
+  EXPECT_NO_THROW(pool.finalize(nntrainer::BasicPlanner(), 0, 2));
+  EXPECT_NO_THROW(pool.allocate());
+  float *data = t1->getData<float>();
+
+  EXPECT_TRUE(pool.unbind());
+  EXPECT_TRUE(pool.isAllocated());
+  EXPECT_FALSE(t1->isAllocated());
+  EXPECT_FALSE(t2->isAllocated());
+
+  EXPECT_NO_THROW(pool.setBatchSize("abc", 2));
+  EXPECT_NO_THROW(pool.setBatchSize("abc1", 2));
+  EXPECT_NO_THROW(pool.bind());
+  EXPECT_EQ(t1->batch(), 2u);
+  EXPECT_EQ(t1->getData<float>(), data);
+  EXPECT_EQ(t2->getData<float>(), data);
+
+  EXPECT_NO_THROW(pool.deallocate());
+}
+
+/**
+ * @brief larger batch does not fit in the allocated memory
+ */
+TEST(TensorPool, unbind_bind_larger_batch_n) {
+  nntrainer::TensorPool pool;
+
+  EXPECT_NO_THROW(
+    pool.request("abc", nntrainer::TensorDim({2, 1, 1, 3}), {0}, max_ls));
+  EXPECT_NO_THROW(pool.finalize(nntrainer::BasicPlanner(), 0, 2));
+  EXPECT_NO_THROW(pool.allocate());
+
+  EXPECT_TRUE(pool.unbind());
+  EXPECT_NO_THROW(pool.setBatchSize("abc", 4));
+  EXPECT_THROW(pool.bind(), std::invalid_argument);
+
+  EXPECT_NO_THROW(pool.deallocate());
+}
+
 /**
  * @brief validate memory full overlap
  */
@@ -874,6 +926,83 @@ TEST(TensorPool, createOrExtend_unmanaged_n) {
     pool.requestOrExtend("t", {10}, {0}, nntrainer::TensorLifespan::UNMANAGED));
 }
 
+/**
+ * @brief request the activations of a chain of four layers followed by a loss
+ * where the output of layer i is used at forward orders i, i + 1 and at the
+ * backward orders of layers i and i + 1
+ */
+static std::vector<nntrainer::Tensor *>
+requestChain(nntrainer::TensorPool &pool) {
+  constexpr auto ls = nntrainer::TensorLifespan::ITERATION_LIFESPAN;
+  std::vector<nntrainer::Tensor *> ts;
+  for (unsigned int i = 0; i < 4; ++i) {
+    ts.push_back(pool.request("a" + std::to_string(i),
+                              nntrainer::TensorDim({100}),
+                              {i, i + 1, 8 - i, 9 - i}, ls));
+  }
+  return ts;
+}
+
+/**
+ * @brief recomputing the layers before two checkpoints lowers the peak
+ */
+TEST(TensorPool, recompute_p) {
+  nntrainer::TensorPool kept, recomputed;
+  requestChain(kept);
+  auto ts = requestChain(recomputed);
+
+  /** layer 1 and 3 are checkpoints, recomputed before orders 8 and 6 */
+  EXPECT_NO_THROW(recomputed.requestRecompute("a0", 0, 1, 8));
+  EXPECT_NO_THROW(recomputed.requestRecompute("a2", 2, 3, 6));
+  EXPECT_NO_THROW(recomputed.requestRecomputeInput("a1", 6));
+
+  kept.finalize(nntrainer::OptimizedV1Planner(), 0, 9);
+  recomputed.finalize(nntrainer::OptimizedV1Planner(), 0, 9);
+  EXPECT_TRUE(recomputed.isRecomputed(0));
+  EXPECT_TRUE(recomputed.isRecomputed(2));
+  EXPECT_FALSE(recomputed.isRecomputed(1));
+  EXPECT_EQ(kept.size(), 400u * sizeof(float));
+  EXPECT_EQ(recomputed.size(), 300u * sizeof(float));
+
+  /** a2 is recomputed while a1 and a3 are alive */
+  recomputed.allocate();
+  float *forward = ts[2]->getData<float>();
+  EXPECT_NO_THROW(recomputed.bindRecomputeMemory(6));
+  for (auto alive : {ts[1], ts[3]}) {
+    EXPECT_GE(std::abs(ts[2]->getData<float>() - alive->getData<float>()),
+              100);
+  }
+  EXPECT_NO_THROW(recomputed.bindForwardMemory());
+  EXPECT_EQ(ts[2]->getData<float>(), forward);
+  recomputed.deallocate();
+}
+
+/**
+ * @brief a tensor used between the segment and its recompute order is kept
+ */
+TEST(TensorPool, recompute_used_after_segment_n) {
+  nntrainer::TensorPool pool;
+  requestChain(pool);
+
+  /** a1 is used at order 2, after the segment ending at order 1 */
+  EXPECT_NO_THROW(pool.requestRecompute("a0", 0, 1, 8));
+  EXPECT_NO_THROW(pool.requestRecompute("a1", 0, 1, 8));
+
+  pool.finalize(nntrainer::OptimizedV1Planner(), 0, 9);
+  EXPECT_FALSE(pool.isRecomputed(0));
+  EXPECT_EQ(pool.size(), 400u * sizeof(float));
+}
+
+/**
+ * @brief recompute order must come after the segment
+ */
+TEST(TensorPool, recompute_invalid_order_n) {
+  nntrainer::TensorPool pool;
+  requestChain(pool);
+
+  EXPECT_THROW(pool.requestRecompute("a0", 0, 8, 1), std::invalid_argument);
+}
+
 /**
  * @brief Main gtest
  */
@@ -22,11 +22,22 @@
  */
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+#include <bpe_tokenizer.h>
+#include <conv2d_kernel.h>
+#include <flash_attention.h>
 #include <nntrainer_error.h>
 #include <nntrainer_log.h>
 #include <nntrainer_logger.h>
 #include <nntrainer_test_util.h>
+#include <normalization_kernel.h>
+#include <recurrent_kernel.h>
 #include <util_func.h>
+#include <util_simd.h>
 
 TEST(nntrainer_util_func, sqrtFloat_01_p) {
   float x = 9871.0;
@@ -138,6 +149,1247 @@ TEST(nntrainer_util_func, throw_status_default_n) {
   EXPECT_THROW(nntrainer::throw_status(-12345), std::runtime_error);
 }
 
+TEST(nntrainer_util_simd, softmax_row_fused_01_p) {
+  const unsigned int N = 13;
+  const float scale = 0.5f;
+  std::vector<float> x(N), mask(N), ref(N);
+  for (unsigned int i = 0; i < N; ++i) {
+    x[i] = std::sin(i * 1.3f) * 3;
+    mask[i] = i % 3 ? 0.0f : -1.0f;
+  }
+
+  float max_x = -1e10f, sum = 0.0f;
+  for (unsigned int i = 0; i < N; ++i) {
+    ref[i] = x[i] * scale + mask[i];
+    max_x = std::max(max_x, ref[i]);
+  }
+  for (unsigned int i = 0; i < N; ++i) {
+    ref[i] = std::exp(ref[i] - max_x);
+    sum += ref[i];
+  }
+
+  nntrainer::softmax_row_fused(N, x.data(), scale, mask.data(), N, 0.0f, 0,
+                               nullptr);
+  for (unsigned int i = 0; i < N; ++i) {
+    EXPECT_NEAR(x[i], ref[i] / sum, tolerance);
+  }
+}
+
+TEST(nntrainer_util_simd, softmax_row_fused_causal_p) {
+  const unsigned int N = 11;
+  const unsigned int len = 6;
+  std::vector<float> x(N, 1.0f);
+
+  nntrainer::softmax_row_fused(N, x.data(), 1.0f, nullptr, len, 0.0f, 0,
+                               nullptr);
+  for (unsigned int i = 0; i < N; ++i) {
+    EXPECT_FLOAT_EQ(x[i], i < len ? 1.0f / len : 0.0f);
+  }
+}
+
+TEST(nntrainer_util_simd, softmax_row_fused_dropout_p) {
+  const unsigned int N = 1000;
+  const float rate = 0.3f;
+  std::vector<float> x(N, 0.0f), dropped(N);
+
+  nntrainer::softmax_row_fused(N, x.data(), 1.0f, nullptr, N, rate, 7,
+                               dropped.data());
+  unsigned int kept = 0;
+  for (unsigned int i = 0; i < N; ++i) {
+    EXPECT_FLOAT_EQ(x[i], 1.0f / N);
+    if (dropped[i] != 0.0f) {
+      EXPECT_FLOAT_EQ(dropped[i], x[i] / (1.0f - rate));
+      ++kept;
+    }
+  }
+  EXPECT_NEAR(kept / (float)N, 1.0f - rate, 0.05f);
+}
+
+TEST(nntrainer_util_simd, softmax_row_fused_deriv_p) {
+  const unsigned int N = 9;
+  const float scale = 0.25f;
+  const float rate = 0.5f;
+  std::vector<float> x(N), p, dropped(N), dy(N), d_mask(N);
+  for (unsigned int i = 0; i < N; ++i) {
+    x[i] = std::cos(i * 0.7f);
+    dy[i] = std::sin(i * 1.1f);
+  }
+  p = x;
+  nntrainer::softmax_row_fused(N, p.data(), scale, nullptr, N, rate, 3,
+                               dropped.data());
+
+  std::vector<float> dp(N), ref(N);
+  float dot = 0.0f;
+  for (unsigned int i = 0; i < N; ++i) {
+    dp[i] = dropped[i] != 0.0f ? dy[i] / (1.0f - rate) : 0.0f;
+    dot += p[i] * dp[i];
+  }
+  for (unsigned int i = 0; i < N; ++i) {
+    ref[i] = p[i] * (dp[i] - dot);
+  }
+
+  nntrainer::softmax_row_fused_deriv(N, p.data(), dropped.data(), rate,
+                                     dy.data(), nullptr, scale, d_mask.data());
+  for (unsigned int i = 0; i < N; ++i) {
+    EXPECT_NEAR(d_mask[i], ref[i], tolerance);
+    EXPECT_NEAR(dy[i], ref[i] * scale, tolerance);
+  }
+}
+
+TEST(nntrainer_util_simd, swiglu_p) {
+  const unsigned int N = 21;
+  std::vector<float> x(N), g(N), y(N);
+  for (unsigned int i = 0; i < N; ++i) {
+    x[i] = std::sin(i * 0.9f) * 4;
+    g[i] = std::cos(i * 0.4f);
+  }
+
+  nntrainer::ele_swiglu(N, x.data(), g.data(), y.data());
+  for (unsigned int i = 0; i < N; ++i) {
+    EXPECT_NEAR(y[i], x[i] / (1.0f + std::exp(-x[i])) * g[i], tolerance);
+  }
+}
+
+TEST(nntrainer_util_simd, swiglu_deriv_p) {
+  const unsigned int N = 19;
+  std::vector<float> x(N), g(N), dy(N), dx(N), dg(N);
+  for (unsigned int i = 0; i < N; ++i) {
+    x[i] = std::sin(i * 0.9f) * 4;
+    g[i] = std::cos(i * 0.4f);
+    dy[i] = std::sin(i * 1.7f);
+  }
+
+  nntrainer::ele_swiglu_deriv(N, x.data(), g.data(), dy.data(), dx.data(),
+                              dg.data());
+  for (unsigned int i = 0; i < N; ++i) {
+    float s = 1.0f / (1.0f + std::exp(-x[i]));
+    EXPECT_NEAR(dx[i], (s + x[i] * s * (1.0f - s)) * g[i] * dy[i], tolerance);
+    EXPECT_NEAR(dg[i], x[i] * s * dy[i], tolerance);
+  }
+}
+
+TEST(nntrainer_util_simd, rotary_emb_p) {
+  const unsigned int half = 11;
+  std::vector<float> x(2 * half), out, cos_(half), sin_(half);
+  for (unsigned int i = 0; i < half; ++i) {
+    x[i] = std::sin(i * 0.3f);
+    x[i + half] = std::cos(i * 0.5f);
+    cos_[i] = std::cos(i * 0.7f);
+    sin_[i] = std::sin(i * 0.7f);
+  }
+
+  out = x;
+  nntrainer::rotary_emb(half, out.data(), cos_.data(), sin_.data());
+  for (unsigned int i = 0; i < half; ++i) {
+    EXPECT_NEAR(out[i], x[i] * cos_[i] - x[i + half] * sin_[i], tolerance);
+    EXPECT_NEAR(out[i + half], x[i + half] * cos_[i] + x[i] * sin_[i],
+                tolerance);
+  }
+
+  /** the inverse rotation restores the input */
+  nntrainer::rotary_emb(half, out.data(), cos_.data(), sin_.data(), true);
+  for (unsigned int i = 0; i < 2 * half; ++i) {
+    EXPECT_NEAR(out[i], x[i], tolerance);
+  }
+}
+
+TEST(nntrainer_util_simd, rms_norm_p) {
+  const unsigned int rows = 3, cols = 13;
+  const float epsilon = 1e-5f;
+  std::vector<float> x(rows * cols), gamma(cols), xhat(rows * cols),
+    y(rows * cols), inv_rms(rows), dy(rows * cols), dx(rows * cols),
+    dgamma(cols);
+  for (unsigned int i = 0; i < rows * cols; ++i) {
+    x[i] = std::sin(i * 0.6f) * 2;
+    dy[i] = std::cos(i * 1.3f);
+  }
+  for (unsigned int j = 0; j < cols; ++j)
+    gamma[j] = 0.5f + j * 0.1f;
+
+  nntrainer::rms_norm_forward<float, float>(x.data(), xhat.data(), y.data(),
+                                            rows, cols, gamma.data(),
+                                            inv_rms.data(), epsilon);
+  nntrainer::rms_norm_backward<float, float>(dy.data(), xhat.data(), dx.data(),
+                                             rows, cols, gamma.data(),
+                                             inv_rms.data(), dgamma.data());
+
+  std::vector<float> ref_dgamma(cols, 0.0f);
+  for (unsigned int r = 0; r < rows; ++r) {
+    const float *in = x.data() + r * cols;
+    float sum = 0.0f;
+    for (unsigned int j = 0; j < cols; ++j)
+      sum += in[j] * in[j];
+    float s = 1.0f / std::sqrt(sum / cols + epsilon);
+    EXPECT_NEAR(inv_rms[r], s, tolerance);
+
+    float dot = 0.0f;
+    for (unsigned int j = 0; j < cols; ++j)
+      dot += dy[r * cols + j] * gamma[j] * in[j] * s;
+
+    for (unsigned int j = 0; j < cols; ++j) {
+      float h = in[j] * s;
+      EXPECT_NEAR(y[r * cols + j], h * gamma[j], tolerance);
+      EXPECT_NEAR(dx[r * cols + j],
+                  s * (dy[r * cols + j] * gamma[j] - h * dot / cols),
+                  tolerance);
+      ref_dgamma[j] += dy[r * cols + j] * h;
+    }
+  }
+  for (unsigned int j = 0; j < cols; ++j) {
+    EXPECT_NEAR(dgamma[j], ref_dgamma[j], tolerance);
+  }
+
+  /** the gradient of gamma is accumulated to */
+  nntrainer::rms_norm_backward<float, float>(dy.data(), xhat.data(), nullptr,
+                                             rows, cols, gamma.data(),
+                                             inv_rms.data(), dgamma.data());
+  for (unsigned int j = 0; j < cols; ++j) {
+    EXPECT_NEAR(dgamma[j], 2 * ref_dgamma[j], tolerance);
+  }
+}
+
+/**
+ * @brief input of the normalization tests, a wave around the offset
+ */
+static std::vector<float> normalizationInput(size_t size, float offset) {
+  std::vector<float> x(size);
+  for (size_t i = 0; i < size; ++i)
+    x[i] = offset + std::sin(i * 0.37f) * 2 + std::cos(i * 1.7f);
+  return x;
+}
+
+/**
+ * @brief compare the batch normalization kernels with a naive two-pass
+ * reference in double on the [outer, channel, inner] view
+ */
+static void testBatchNorm(unsigned int outer, unsigned int channel,
+                          unsigned int inner, float offset) {
+  const size_t size = static_cast<size_t>(outer) * channel * inner;
+  const float epsilon = 1e-3f, momentum = 0.9f;
+  /** the rounding of the deviation from the mean grows with the offset */
+  const float tol = tolerance * (1.0f + offset / 100);
+
+  std::vector<float> x = normalizationInput(size, offset);
+  std::vector<float> dy = normalizationInput(size, 0.0f);
+  std::vector<float> xhat(size), y(size), dx(size), mu(channel, 0.3f),
+    var(channel, 0.7f), gamma(channel), beta(channel), invstd(channel),
+    dgamma(channel), dbeta(channel);
+  for (unsigned int c = 0; c < channel; ++c) {
+    gamma[c] = 0.5f + c * 0.25f;
+    beta[c] = c * 0.1f - 0.2f;
+  }
+
+  nntrainer::batch_norm_forward<float, float>(
+    x.data(), xhat.data(), y.data(), outer, channel, inner, mu.data(),
+    var.data(), gamma.data(), beta.data(), invstd.data(), epsilon, momentum,
+    true);
+  nntrainer::batch_norm_backward<float, float>(
+    dy.data(), xhat.data(), dx.data(), outer, channel, inner, gamma.data(),
+    invstd.data(), dgamma.data());
+  nntrainer::batch_norm_channel_sum<float, float>(dy.data(), outer, channel,
+                                                  inner, dbeta.data());
+
+  const double n = static_cast<double>(outer) * inner;
+  auto at = [&](unsigned int o, unsigned int c, unsigned int i) {
+    return (static_cast<size_t>(o) * channel + c) * inner + i;
+  };
+
+  for (unsigned int c = 0; c < channel; ++c) {
+    double mean = 0.0, m2 = 0.0;
+    for (unsigned int o = 0; o < outer; ++o)
+      for (unsigned int i = 0; i < inner; ++i)
+        mean += x[at(o, c, i)];
+    mean /= n;
+    for (unsigned int o = 0; o < outer; ++o)
+      for (unsigned int i = 0; i < inner; ++i)
+        m2 += (x[at(o, c, i)] - mean) * (x[at(o, c, i)] - mean);
+    const double batch_var = m2 / n;
+    const double s = 1.0 / std::sqrt(batch_var + epsilon);
+
+    EXPECT_NEAR(mu[c], 0.3 * momentum + mean * (1 - momentum), tol);
+    EXPECT_NEAR(var[c], 0.7 * momentum + batch_var * (1 - momentum), tol);
+    EXPECT_NEAR(invstd[c], s, tol * s);
+
+    double sum_dy = 0.0, sum_dyx = 0.0;
+    for (unsigned int o = 0; o < outer; ++o) {
+      for (unsigned int i = 0; i < inner; ++i) {
+        const double h = (x[at(o, c, i)] - mean) * s;
+        EXPECT_NEAR(xhat[at(o, c, i)], h, tol);
+        EXPECT_NEAR(y[at(o, c, i)], gamma[c] * h + beta[c], tol);
+        sum_dy += dy[at(o, c, i)];
+        sum_dyx += dy[at(o, c, i)] * h;
+      }
+    }
+    EXPECT_NEAR(dgamma[c], sum_dyx, tol * n);
+    EXPECT_NEAR(dbeta[c], sum_dy, tolerance * n);
+
+    for (unsigned int o = 0; o < outer; ++o) {
+      for (unsigned int i = 0; i < inner; ++i) {
+        const double h = (x[at(o, c, i)] - mean) * s;
+        const double ref = gamma[c] * s *
+                           (dy[at(o, c, i)] - sum_dy / n - h * sum_dyx / n);
+        EXPECT_NEAR(dx[at(o, c, i)], ref, tol);
+      }
+    }
+  }
+
+  /** inference normalizes with the moving statistics */
+  nntrainer::batch_norm_forward<float, float>(
+    x.data(), nullptr, y.data(), outer, channel, inner, mu.data(), var.data(),
+    gamma.data(), beta.data(), invstd.data(), epsilon, momentum, false);
+  for (unsigned int c = 0; c < channel; ++c) {
+    const double s = 1.0 / std::sqrt(static_cast<double>(var[c]) + epsilon);
+    for (unsigned int o = 0; o < outer; ++o)
+      for (unsigned int i = 0; i < inner; ++i)
+        EXPECT_NEAR(y[at(o, c, i)],
+                    gamma[c] * (x[at(o, c, i)] - mu[c]) * s + beta[c],
+                    tol * (1.0f + offset / 100));
+  }
+}
+
+TEST(nntrainer_normalization_kernel, batch_norm_channel_first_p) {
+  testBatchNorm(3, 4, 37, 0.0f);
+}
+
+TEST(nntrainer_normalization_kernel, batch_norm_channel_last_p) {
+  testBatchNorm(29, 6, 1, 0.0f);
+}
+
+TEST(nntrainer_normalization_kernel, batch_norm_short_slab_p) {
+  testBatchNorm(5, 3, 5, 0.0f);
+}
+
+TEST(nntrainer_normalization_kernel, batch_norm_large_offset_p) {
+  testBatchNorm(4, 3, 50, 1000.0f);
+  testBatchNorm(40, 3, 1, 1000.0f);
+}
+
+/**
+ * @brief compare the layer normalization kernels with a naive two-pass
+ * reference in double on the [rows, cols] view
+ */
+static void testLayerNorm(unsigned int rows, unsigned int cols, float offset) {
+  const size_t size = static_cast<size_t>(rows) * cols;
+  const float epsilon = 1e-3f;
+  const float tol = tolerance * (1.0f + offset / 100);
+
+  std::vector<float> x = normalizationInput(size, offset);
+  std::vector<float> dy = normalizationInput(size, 0.0f);
+  std::vector<float> xhat(size), y(size), dx(size), gamma(cols), beta(cols),
+    inv_std(rows), dgamma(cols), dbeta(cols);
+  for (unsigned int j = 0; j < cols; ++j) {
+    gamma[j] = 0.5f + j * 0.05f;
+    beta[j] = j * 0.02f - 0.3f;
+  }
+
+  nntrainer::layer_norm_forward<float, float>(x.data(), xhat.data(), y.data(),
+                                              rows, cols, gamma.data(),
+                                              beta.data(), inv_std.data(),
+                                              epsilon);
+  nntrainer::layer_norm_backward<float, float>(
+    dy.data(), xhat.data(), dx.data(), rows, cols, gamma.data(),
+    inv_std.data(), dgamma.data());
+  nntrainer::layer_norm_column_sum<float, float>(dy.data(), rows, cols,
+                                                 dbeta.data());
+
+  std::vector<double> ref_dgamma(cols, 0.0), ref_dbeta(cols, 0.0);
+  for (unsigned int r = 0; r < rows; ++r) {
+    const float *in = x.data() + static_cast<size_t>(r) * cols;
+    const float *d = dy.data() + static_cast<size_t>(r) * cols;
+
+    double mean = 0.0, m2 = 0.0;
+    for (unsigned int j = 0; j < cols; ++j)
+      mean += in[j];
+    mean /= cols;
+    for (unsigned int j = 0; j < cols; ++j)
+      m2 += (in[j] - mean) * (in[j] - mean);
+    const double s = 1.0 / std::sqrt(m2 / cols + epsilon);
+    EXPECT_NEAR(inv_std[r], s, tol * s);
+
+    double sum_g = 0.0, sum_gx = 0.0;
+    for (unsigned int j = 0; j < cols; ++j) {
+      const double h = (in[j] - mean) * s;
+      EXPECT_NEAR(xhat[r * cols + j], h, tol);
+      EXPECT_NEAR(y[r * cols + j], gamma[j] * h + beta[j], tol);
+      sum_g += d[j] * gamma[j];
+      sum_gx += d[j] * gamma[j] * h;
+      ref_dgamma[j] += d[j] * h;
+      ref_dbeta[j] += d[j];
+    }
+
+    for (unsigned int j = 0; j < cols; ++j) {
+      const double h = (in[j] - mean) * s;
+      const double ref =
+        s * (d[j] * gamma[j] - sum_g / cols - h * sum_gx / cols);
+      EXPECT_NEAR(dx[r * cols + j], ref, tol);
+    }
+  }
+
+  for (unsigned int j = 0; j < cols; ++j) {
+    EXPECT_NEAR(dgamma[j], ref_dgamma[j], tol * rows);
+    EXPECT_NEAR(dbeta[j], ref_dbeta[j], tolerance * rows);
+  }
+}
+
+TEST(nntrainer_normalization_kernel, layer_norm_p) { testLayerNorm(4, 37, 0.0f); }
+
+TEST(nntrainer_normalization_kernel, layer_norm_short_row_p) {
+  testLayerNorm(3, 5, 0.0f);
+}
+
+TEST(nntrainer_normalization_kernel, layer_norm_large_offset_p) {
+  testLayerNorm(4, 64, 1000.0f);
+}
+
+/**
+ * @brief naive attention which stores the whole attention weight
+ */
+static void naiveAttention(const nntrainer::FlashAttentionDim &dim,
+                           const std::vector<float> &q,
+                           const std::vector<float> &k,
+                           const std::vector<float> &v,
+                           const std::vector<float> &mask, float scale,
+                           int causal_from, std::vector<float> &o,
+                           std::vector<float> &p) {
+  const unsigned int H = dim.num_heads, D = dim.head_dim, Dv = dim.value_dim;
+  const unsigned int mask_rows = mask.size() / dim.kv_len;
+  p.assign(dim.batch * H * dim.q_len * dim.kv_len, 0.0f);
+  o.assign(dim.batch * dim.q_len * H * Dv, 0.0f);
+
+  for (unsigned int b = 0; b < dim.batch; ++b) {
+    for (unsigned int h = 0; h < H; ++h) {
+      for (unsigned int i = 0; i < dim.q_len; ++i) {
+        const unsigned int row = (b * H + h) * dim.q_len + i;
+        float *pr = p.data() + row * dim.kv_len;
+        unsigned int len = dim.kv_len;
+        if (causal_from >= 0)
+          len = std::min(len, causal_from + i + 1);
+        float max_s = -1e30f, sum = 0.0f;
+        for (unsigned int j = 0; j < len; ++j) {
+          float s = 0.0f;
+          for (unsigned int c = 0; c < D; ++c)
+            s += q[((b * dim.q_len + i) * H + h) * D + c] *
+                 k[((b * dim.kv_capacity + j) * H + h) * D + c];
+          pr[j] = s * scale +
+                  (mask.empty() ? 0.0f
+                                : mask[(row % mask_rows) * dim.kv_len + j]);
+          max_s = std::max(max_s, pr[j]);
+        }
+        for (unsigned int j = 0; j < len; ++j) {
+          pr[j] = std::exp(pr[j] - max_s);
+          sum += pr[j];
+        }
+        for (unsigned int j = 0; j < len; ++j) {
+          pr[j] /= sum;
+          for (unsigned int c = 0; c < Dv; ++c)
+            o[((b * dim.q_len + i) * H + h) * Dv + c] +=
+              pr[j] * v[((b * dim.kv_capacity + j) * H + h) * Dv + c];
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief fill the vector with deterministic values in [-1, 1]
+ */
+static std::vector<float> attentionInput(size_t size, float seed) {
+  std::vector<float> x(size);
+  for (size_t i = 0; i < size; ++i)
+    x[i] = std::sin(i * 0.37f + seed);
+  return x;
+}
+
+TEST(nntrainer_flash_attention, forward_mask_p) {
+  /** lengths are not multiple of the block sizes */
+  const nntrainer::FlashAttentionDim dim = {2, 3, 45, 150, 150, 8, 5};
+  const float scale = 0.35f;
+  auto q = attentionInput(dim.batch * dim.q_len * 3 * 8, 0.1f);
+  auto k = attentionInput(dim.batch * dim.kv_capacity * 3 * 8, 0.7f);
+  auto v = attentionInput(dim.batch * dim.kv_capacity * 3 * 5, 1.3f);
+  /** mask broadcast over batch and heads */
+  auto mask = attentionInput(dim.q_len * dim.kv_len, 2.1f);
+
+  std::vector<float> ref, p;
+  naiveAttention(dim, q, k, v, mask, scale, -1, ref, p);
+
+  std::vector<float> o(ref.size()), lse(dim.batch * 3 * dim.q_len);
+  nntrainer::flash_attention_forward(dim, q.data(), k.data(), v.data(),
+                                     mask.data(), dim.q_len, scale, -1,
+                                     o.data(), lse.data());
+  for (size_t i = 0; i < o.size(); ++i)
+    EXPECT_NEAR(o[i], ref[i], tolerance);
+}
+
+TEST(nntrainer_flash_attention, forward_causal_cache_p) {
+  /** 40 new queries attending 100 cached keys out of a cache of 128 */
+  const nntrainer::FlashAttentionDim dim = {1, 2, 40, 100, 128, 4, 4};
+  const float scale = 0.5f;
+  auto q = attentionInput(dim.q_len * 2 * 4, 0.3f);
+  auto k = attentionInput(dim.kv_capacity * 2 * 4, 0.9f);
+  auto v = attentionInput(dim.kv_capacity * 2 * 4, 1.7f);
+
+  std::vector<float> ref, p, empty_mask;
+  naiveAttention(dim, q, k, v, empty_mask, scale, 60, ref, p);
+
+  std::vector<float> o(ref.size());
+  nntrainer::flash_attention_forward(dim, q.data(), k.data(), v.data(),
+                                     nullptr, 0, scale, 60, o.data(), nullptr);
+  for (size_t i = 0; i < o.size(); ++i)
+    EXPECT_NEAR(o[i], ref[i], tolerance);
+}
+
+TEST(nntrainer_flash_attention, forward_int8_cache_p) {
+  const nntrainer::FlashAttentionDim dim = {2, 3, 20, 90, 96, 8, 5};
+  const unsigned int H = dim.num_heads, D = dim.head_dim, Dv = dim.value_dim;
+  const float scale = 0.35f;
+  auto q = attentionInput(dim.batch * dim.q_len * H * D, 0.4f);
+  auto k = attentionInput(dim.batch * dim.kv_capacity * H * D, 1.2f);
+  auto v = attentionInput(dim.batch * dim.kv_capacity * H * Dv, 2.3f);
+
+  const unsigned int num_vectors = dim.batch * dim.kv_capacity * H;
+  std::vector<int8_t> qk(k.size()), qv(v.size());
+  std::vector<float> k_scale(num_vectors), v_scale(num_vectors);
+  nntrainer::flash_attention_quantize(num_vectors, D, k.data(), qk.data(),
+                                      k_scale.data());
+  nntrainer::flash_attention_quantize(num_vectors, Dv, v.data(), qv.data(),
+                                      v_scale.data());
+
+  /** every element is within half a step of the scale */
+  std::vector<float> dk(k.size()), dv(v.size());
+  for (size_t i = 0; i < k.size(); ++i) {
+    dk[i] = k_scale[i / D] * qk[i];
+    EXPECT_LE(std::abs(dk[i] - k[i]), k_scale[i / D] * 0.5f + 1e-6f);
+  }
+  for (size_t i = 0; i < v.size(); ++i) {
+    dv[i] = v_scale[i / Dv] * qv[i];
+    EXPECT_LE(std::abs(dv[i] - v[i]), v_scale[i / Dv] * 0.5f + 1e-6f);
+  }
+
+  std::vector<float> ref, p, empty_mask;
+  naiveAttention(dim, q, dk, dv, empty_mask, scale, 70, ref, p);
+
+  std::vector<float> o(ref.size());
+  nntrainer::flash_attention_forward(dim, q.data(), qk.data(), k_scale.data(),
+                                     qv.data(), v_scale.data(), nullptr, 0,
+                                     scale, 70, o.data(), nullptr);
+  for (size_t i = 0; i < o.size(); ++i)
+    EXPECT_NEAR(o[i], ref[i], tolerance);
+}
+
+TEST(nntrainer_flash_attention, backward_p) {
+  const nntrainer::FlashAttentionDim dim = {1, 2, 70, 70, 70, 6, 3};
+  const unsigned int H = dim.num_heads, D = dim.head_dim, Dv = dim.value_dim;
+  const float scale = 0.4f;
+  const int causal_from = 0;
+  auto q = attentionInput(dim.q_len * H * D, 0.2f);
+  auto k = attentionInput(dim.kv_len * H * D, 0.5f);
+  auto v = attentionInput(dim.kv_len * H * Dv, 1.1f);
+  auto d_o = attentionInput(dim.q_len * H * Dv, 2.9f);
+  auto mask = attentionInput(H * dim.q_len * dim.kv_len, 0.8f);
+
+  std::vector<float> o, p;
+  naiveAttention(dim, q, k, v, mask, scale, causal_from, o, p);
+
+  /** reference derivative through the stored attention weight */
+  std::vector<float> ref_dq(q.size(), 0.0f), ref_dk(k.size(), 0.0f),
+    ref_dv(v.size(), 0.0f), ref_dmask(p.size(), 0.0f);
+  for (unsigned int h = 0; h < H; ++h) {
+    for (unsigned int i = 0; i < dim.q_len; ++i) {
+      const float *pr = p.data() + (h * dim.q_len + i) * dim.kv_len;
+      float *ds = ref_dmask.data() + (h * dim.q_len + i) * dim.kv_len;
+      float delta = 0.0f;
+      for (unsigned int j = 0; j < dim.kv_len; ++j) {
+        float dp = 0.0f;
+        for (unsigned int c = 0; c < Dv; ++c) {
+          dp += d_o[(i * H + h) * Dv + c] * v[(j * H + h) * Dv + c];
+          ref_dv[(j * H + h) * Dv + c] += pr[j] * d_o[(i * H + h) * Dv + c];
+        }
+        ds[j] = dp;
+        delta += pr[j] * dp;
+      }
+      for (unsigned int j = 0; j < dim.kv_len; ++j) {
+        ds[j] = pr[j] * (ds[j] - delta);
+        for (unsigned int c = 0; c < D; ++c) {
+          ref_dq[(i * H + h) * D + c] += scale * ds[j] * k[(j * H + h) * D + c];
+          ref_dk[(j * H + h) * D + c] += scale * ds[j] * q[(i * H + h) * D + c];
+        }
+      }
+    }
+  }
+
+  std::vector<float> lse(H * dim.q_len), fo(o.size());
+  nntrainer::flash_attention_forward(dim, q.data(), k.data(), v.data(),
+                                     mask.data(), H * dim.q_len, scale,
+                                     causal_from, fo.data(), lse.data());
+
+  std::vector<float> dq(q.size()), dk(k.size()), dv(v.size()),
+    dmask(p.size());
+  nntrainer::flash_attention_backward(
+    dim, q.data(), k.data(), v.data(), mask.data(), H * dim.q_len, scale,
+    causal_from, fo.data(), lse.data(), d_o.data(), dq.data(), dk.data(),
+    dv.data(), dmask.data());
+
+  for (size_t i = 0; i < dq.size(); ++i)
+    EXPECT_NEAR(dq[i], ref_dq[i], tolerance);
+  for (size_t i = 0; i < dk.size(); ++i)
+    EXPECT_NEAR(dk[i], ref_dk[i], tolerance);
+  for (size_t i = 0; i < dv.size(); ++i)
+    EXPECT_NEAR(dv[i], ref_dv[i], tolerance);
+  for (size_t i = 0; i < dmask.size(); ++i)
+    EXPECT_NEAR(dmask[i], ref_dmask[i], tolerance);
+}
+
+/**
+ * @brief naive convolution of a single image
+ */
+static std::vector<float> naiveConv2D(const nntrainer::Conv2DShape &s,
+                                      const std::vector<float> &in,
+                                      const std::vector<float> &filter) {
+  std::vector<float> out(s.out_channel * s.out_height * s.out_width, 0.0f);
+  for (unsigned int k = 0; k < s.out_channel; ++k)
+    for (unsigned int oh = 0; oh < s.out_height; ++oh)
+      for (unsigned int ow = 0; ow < s.out_width; ++ow) {
+        float sum = 0.0f;
+        for (unsigned int c = 0; c < s.in_channel; ++c)
+          for (unsigned int kh = 0; kh < s.k_height; ++kh)
+            for (unsigned int kw = 0; kw < s.k_width; ++kw) {
+              int ih = oh * s.stride_h + kh * s.dilation_h - s.pad_top;
+              int iw = ow * s.stride_w + kw * s.dilation_w - s.pad_left;
+              if (ih < 0 || iw < 0 || ih >= (int)s.in_height ||
+                  iw >= (int)s.in_width)
+                continue;
+              sum += in[(c * s.in_height + ih) * s.in_width + iw] *
+                     filter[((k * s.in_channel + c) * s.k_height + kh) *
+                              s.k_width +
+                            kw];
+            }
+        out[(k * s.out_height + oh) * s.out_width + ow] = sum;
+      }
+  return out;
+}
+
+/**
+ * @brief compare a conv2d kernel against the naive convolution
+ */
+static void testConv2DKernel(const nntrainer::Conv2DShape &s,
+                             nntrainer::Conv2DAlgorithm algo) {
+  auto in = attentionInput(s.in_channel * s.in_height * s.in_width, 0.2f);
+  auto filter = attentionInput(
+    s.out_channel * s.in_channel * s.k_height * s.k_width, 1.1f);
+  auto ref = naiveConv2D(s, in, filter);
+
+  std::vector<float> out(ref.size(), -1.0f);
+  if (algo == nntrainer::Conv2DAlgorithm::DIRECT) {
+    nntrainer::conv2d_direct(s, in.data(), filter.data(), out.data());
+  } else {
+    std::vector<float> u(nntrainer::conv2d_winograd_filter_size(s, algo));
+    nntrainer::conv2d_winograd_transform_filter(s, algo, filter.data(),
+                                                u.data());
+    nntrainer::conv2d_winograd(s, algo, in.data(), u.data(), out.data());
+  }
+
+  for (size_t i = 0; i < out.size(); ++i)
+    EXPECT_NEAR(out[i], ref[i], tolerance * 10);
+}
+
+TEST(nntrainer_conv2d_kernel, winograd_2x2_p) {
+  /** 3x3 same padding, odd output size */
+  nntrainer::Conv2DShape s = {8, 9, 7, 9, 9, 7, 3, 3, 1, 1, 1, 1, 1, 1};
+  EXPECT_EQ(nntrainer::conv2d_select_algorithm(s),
+            nntrainer::Conv2DAlgorithm::WINOGRAD_2X2);
+  testConv2DKernel(s, nntrainer::Conv2DAlgorithm::WINOGRAD_2X2);
+}
+
+TEST(nntrainer_conv2d_kernel, winograd_4x4_p) {
+  /** more tiles than a tile block, output not a multiple of 4 */
+  nntrainer::Conv2DShape s = {8, 38, 35, 8, 36, 33, 3, 3, 1, 1, 1, 1, 0, 0};
+  EXPECT_EQ(nntrainer::conv2d_select_algorithm(s),
+            nntrainer::Conv2DAlgorithm::WINOGRAD_4X4);
+  testConv2DKernel(s, nntrainer::Conv2DAlgorithm::WINOGRAD_4X4);
+}
+
+TEST(nntrainer_conv2d_kernel, direct_dilation_p) {
+  /** 3 channels, 2x3 kernel with dilation and padding */
+  nntrainer::Conv2DShape s = {3, 11, 13, 4, 11, 11, 2, 3, 1, 1, 2, 2, 1, 1};
+  EXPECT_EQ(nntrainer::conv2d_select_algorithm(s),
+            nntrainer::Conv2DAlgorithm::DIRECT);
+  testConv2DKernel(s, nntrainer::Conv2DAlgorithm::DIRECT);
+}
+
+TEST(nntrainer_conv2d_kernel, direct_stride_dilation_p) {
+  /** 3 channels, 2x3 kernel with stride, dilation and padding */
+  nntrainer::Conv2DShape s = {3, 11, 13, 4, 6, 6, 2, 3, 2, 2, 2, 2, 1, 1};
+  testConv2DKernel(s, nntrainer::Conv2DAlgorithm::DIRECT);
+}
+
+TEST(nntrainer_conv2d_kernel, select_im2col_p) {
+  nntrainer::Conv2DShape s = {16, 8, 8, 16, 4, 4, 3, 3, 2, 2, 1, 1, 1, 1};
+  EXPECT_EQ(nntrainer::conv2d_select_algorithm(s),
+            nntrainer::Conv2DAlgorithm::IM2COL);
+
+  /** few channels but strided, like a 7x7 stride 2 stem on an RGB image */
+  s = {3, 224, 224, 64, 112, 112, 7, 7, 2, 2, 1, 1, 3, 3};
+  EXPECT_EQ(nntrainer::conv2d_select_algorithm(s),
+            nntrainer::Conv2DAlgorithm::IM2COL);
+
+  /** few channels at unit stride but a large kernel */
+  s = {3, 32, 32, 8, 26, 26, 7, 7, 1, 1, 1, 1, 0, 0};
+  EXPECT_EQ(nntrainer::conv2d_select_algorithm(s),
+            nntrainer::Conv2DAlgorithm::IM2COL);
+}
+
+/**
+ * @brief naive depthwise convolution of a single NCHW image, computing the
+ * output and, if dy is given, the input and filter derivatives
+ */
+static void naiveDepthwiseConv2D(const nntrainer::Conv2DShape &s,
+                                 const std::vector<float> &in,
+                                 const std::vector<float> &filter,
+                                 std::vector<float> &out,
+                                 const std::vector<float> *dy = nullptr,
+                                 std::vector<float> *dx = nullptr,
+                                 std::vector<float> *dfilter = nullptr) {
+  unsigned int m = s.out_channel / s.in_channel;
+  out.assign(s.out_channel * s.out_height * s.out_width, 0.0f);
+  if (dy) {
+    dx->assign(in.size(), 0.0f);
+    dfilter->assign(filter.size(), 0.0f);
+  }
+  for (unsigned int o = 0; o < s.out_channel; ++o)
+    for (unsigned int oh = 0; oh < s.out_height; ++oh)
+      for (unsigned int ow = 0; ow < s.out_width; ++ow)
+        for (unsigned int kh = 0; kh < s.k_height; ++kh)
+          for (unsigned int kw = 0; kw < s.k_width; ++kw) {
+            int ih = oh * s.stride_h + kh * s.dilation_h - s.pad_top;
+            int iw = ow * s.stride_w + kw * s.dilation_w - s.pad_left;
+            if (ih < 0 || iw < 0 || ih >= (int)s.in_height ||
+                iw >= (int)s.in_width)
+              continue;
+            size_t x = ((o / m) * s.in_height + ih) * s.in_width + iw;
+            size_t w = (o * s.k_height + kh) * s.k_width + kw;
+            size_t y = (o * s.out_height + oh) * s.out_width + ow;
+            out[y] += in[x] * filter[w];
+            if (dy) {
+              (*dx)[x] += (*dy)[y] * filter[w];
+              (*dfilter)[w] += (*dy)[y] * in[x];
+            }
+          }
+}
+
+/**
+ * @brief transpose a [channel, height * width] image to channel last
+ */
+static std::vector<float> toChannelLast(const std::vector<float> &chw,
+                                        unsigned int channel) {
+  size_t hw = chw.size() / channel;
+  std::vector<float> hwc(chw.size());
+  for (unsigned int c = 0; c < channel; ++c)
+    for (size_t i = 0; i < hw; ++i)
+      hwc[i * channel + c] = chw[c * hw + i];
+  return hwc;
+}
+
+/**
+ * @brief compare the depthwise kernels against the naive convolution
+ */
+static void testDepthwiseConv2D(const nntrainer::Conv2DShape &s, bool nhwc) {
+  auto in = attentionInput(s.in_channel * s.in_height * s.in_width, 0.3f);
+  auto filter =
+    attentionInput(s.out_channel * s.k_height * s.k_width, 0.7f);
+  auto dy = attentionInput(s.out_channel * s.out_height * s.out_width, 1.3f);
+  std::vector<float> ref, ref_dx, ref_dw;
+  naiveDepthwiseConv2D(s, in, filter, ref, &dy, &ref_dx, &ref_dw);
+
+  if (nhwc) {
+    in = toChannelLast(in, s.in_channel);
+    dy = toChannelLast(dy, s.out_channel);
+    ref = toChannelLast(ref, s.out_channel);
+    ref_dx = toChannelLast(ref_dx, s.in_channel);
+  }
+
+  std::vector<float> out(ref.size(), -1.0f);
+  std::vector<float> dx(ref_dx.size(), -1.0f);
+  std::vector<float> dw(ref_dw.size(), 0.0f);
+  nntrainer::depthwise_conv2d(s, nhwc, in.data(), filter.data(), out.data());
+  nntrainer::depthwise_conv2d_derivative(s, nhwc, dy.data(), filter.data(),
+                                         dx.data());
+  nntrainer::depthwise_conv2d_gradient(s, nhwc, dy.data(), in.data(),
+                                       dw.data());
+
+  for (size_t i = 0; i < out.size(); ++i)
+    EXPECT_NEAR(out[i], ref[i], tolerance);
+  for (size_t i = 0; i < dx.size(); ++i)
+    EXPECT_NEAR(dx[i], ref_dx[i], tolerance);
+  for (size_t i = 0; i < dw.size(); ++i)
+    EXPECT_NEAR(dw[i], ref_dw[i], tolerance * 10);
+}
+
+TEST(nntrainer_conv2d_kernel, depthwise_nchw_p) {
+  /** 3x3 same padding, stride 1 */
+  nntrainer::Conv2DShape s = {6, 9, 11, 6, 9, 11, 3, 3, 1, 1, 1, 1, 1, 1};
+  testDepthwiseConv2D(s, false);
+}
+
+TEST(nntrainer_conv2d_kernel, depthwise_nchw_multiplier_stride_p) {
+  /** depth multiplier 2 with stride, dilation and padding */
+  nntrainer::Conv2DShape s = {3, 11, 13, 6, 6, 6, 2, 3, 2, 2, 2, 2, 1, 1};
+  testDepthwiseConv2D(s, false);
+}
+
+TEST(nntrainer_conv2d_kernel, depthwise_nhwc_p) {
+  nntrainer::Conv2DShape s = {10, 7, 8, 10, 7, 8, 3, 3, 1, 1, 1, 1, 1, 1};
+  testDepthwiseConv2D(s, true);
+}
+
+TEST(nntrainer_conv2d_kernel, depthwise_nhwc_multiplier_stride_p) {
+  nntrainer::Conv2DShape s = {3, 11, 13, 9, 6, 6, 2, 3, 2, 2, 2, 2, 1, 1};
+  testDepthwiseConv2D(s, true);
+}
+
+/**
+ * @brief sigmoid of the recurrent kernel tests
+ */
+static float testSigmoid(float x) { return 1.0f / (1.0f + std::exp(-x)); }
+
+/**
+ * @brief derivative of testSigmoid from its output
+ */
+static float testSigmoidPrime(float y) { return y * (1.0f - y); }
+
+/**
+ * @brief tanh of the recurrent kernel tests
+ */
+static float testTanh(float x) { return std::tanh(x); }
+
+/**
+ * @brief derivative of testTanh from its output
+ */
+static float testTanhPrime(float y) { return 1.0f - y * y; }
+
+static const nntrainer::RecurrentActivation test_tanh = {testTanh,
+                                                         testTanhPrime};
+static const nntrainer::RecurrentActivation test_sigmoid = {testSigmoid,
+                                                            testSigmoidPrime};
+
+/** batch, timestep and unit of the recurrent kernel tests */
+static constexpr unsigned int RB = 3, RT = 4, RU = 5;
+
+/**
+ * @brief run an LSTM over [RB, RT] with the batched step kernels
+ */
+static void runLSTMKernel(const std::vector<float> &x_proj,
+                          const std::vector<float> &w_hh,
+                          const std::vector<float> &dy, std::vector<float> &h,
+                          std::vector<float> &c, std::vector<float> &d_ifgo,
+                          std::vector<float> &dw) {
+  const unsigned int G = 4 * RU, ld_gate = RT * G, ld_state = RT * RU;
+  std::vector<float> ifgo = x_proj;
+  h.assign(RB * RT * RU, 0.0f);
+  c.assign(RB * RT * RU, 0.0f);
+  for (unsigned int t = 0; t < RT; ++t)
+    nntrainer::lstm_step_forward(
+      RB, RU, ifgo.data() + t * G, ld_gate,
+      t ? h.data() + (t - 1) * RU : nullptr,
+      t ? c.data() + (t - 1) * RU : nullptr, h.data() + t * RU,
+      c.data() + t * RU, ld_state, w_hh.data(), test_tanh, test_sigmoid);
+
+  std::vector<float> dh = dy, dc(RB * RT * RU, 0.0f);
+  d_ifgo.assign(RB * RT * G, 0.0f);
+  dw.assign(RU * G, 0.0f);
+  for (unsigned int t = RT; t-- > 0;) {
+    const size_t gate = t * G, state = t * RU;
+    nntrainer::lstm_step_backward(
+      RB, RU, ifgo.data() + gate, d_ifgo.data() + gate, ld_gate,
+      t ? h.data() + state - RU : nullptr,
+      t ? dh.data() + state - RU : nullptr,
+      t ? c.data() + state - RU : nullptr, c.data() + state,
+      dh.data() + state, dc.data() + state,
+      t ? dc.data() + state - RU : nullptr, ld_state, w_hh.data(), dw.data(),
+      test_tanh, test_sigmoid);
+  }
+}
+
+TEST(nntrainer_recurrent_kernel, lstm_p) {
+  const unsigned int G = 4 * RU;
+  auto x_proj = attentionInput(RB * RT * G, 0.4f);
+  auto w_hh = attentionInput(RU * G, 1.1f);
+  auto dy = attentionInput(RB * RT * RU, 2.3f);
+
+  std::vector<float> h, c, d_ifgo, dw;
+  runLSTMKernel(x_proj, w_hh, dy, h, c, d_ifgo, dw);
+
+  /** naive forward and backpropagation through time per sample */
+  std::vector<float> ref_dw(RU * G, 0.0f);
+  for (unsigned int b = 0; b < RB; ++b) {
+    std::vector<float> act(RT * G), cell(RT * RU), hidden(RT * RU);
+    std::vector<float> h_prev(RU, 0.0f), c_prev(RU, 0.0f);
+    for (unsigned int t = 0; t < RT; ++t) {
+      const float *gate = x_proj.data() + (b * RT + t) * G;
+      float *a = act.data() + t * G;
+      for (unsigned int u = 0; u < RU; ++u) {
+        float pre[4];
+        for (unsigned int k = 0; k < 4; ++k) {
+          pre[k] = gate[k * RU + u];
+          for (unsigned int j = 0; j < RU; ++j)
+            pre[k] += h_prev[j] * w_hh[j * G + k * RU + u];
+        }
+        a[u] = testSigmoid(pre[0]);
+        a[RU + u] = testSigmoid(pre[1]);
+        a[2 * RU + u] = std::tanh(pre[2]);
+        a[3 * RU + u] = testSigmoid(pre[3]);
+        cell[t * RU + u] = a[RU + u] * c_prev[u] + a[u] * a[2 * RU + u];
+        hidden[t * RU + u] = a[3 * RU + u] * std::tanh(cell[t * RU + u]);
+        EXPECT_NEAR(c[(b * RT + t) * RU + u], cell[t * RU + u], tolerance);
+        EXPECT_NEAR(h[(b * RT + t) * RU + u], hidden[t * RU + u], tolerance);
+      }
+      std::copy(cell.begin() + t * RU, cell.begin() + (t + 1) * RU,
+                c_prev.begin());
+      std::copy(hidden.begin() + t * RU, hidden.begin() + (t + 1) * RU,
+                h_prev.begin());
+    }
+
+    std::vector<float> dh_next(RU, 0.0f), dc_next(RU, 0.0f), d_pre(G);
+    for (unsigned int t = RT; t-- > 0;) {
+      const float *a = act.data() + t * G;
+      for (unsigned int u = 0; u < RU; ++u) {
+        const float i = a[u], f = a[RU + u], g = a[2 * RU + u],
+                    o = a[3 * RU + u];
+        const float tanh_c = std::tanh(cell[t * RU + u]);
+        const float dh = dy[(b * RT + t) * RU + u] + dh_next[u];
+        const float dc = dh * o * (1 - tanh_c * tanh_c) + dc_next[u];
+        const float c_before = t ? cell[(t - 1) * RU + u] : 0.0f;
+        d_pre[u] = dc * g * i * (1 - i);
+        d_pre[RU + u] = dc * c_before * f * (1 - f);
+        d_pre[2 * RU + u] = dc * i * (1 - g * g);
+        d_pre[3 * RU + u] = dh * tanh_c * o * (1 - o);
+        dc_next[u] = dc * f;
+      }
+      for (unsigned int k = 0; k < G; ++k)
+        EXPECT_NEAR(d_ifgo[(b * RT + t) * G + k], d_pre[k], tolerance);
+
+      for (unsigned int j = 0; j < RU; ++j) {
+        dh_next[j] = 0.0f;
+        for (unsigned int k = 0; k < G; ++k) {
+          dh_next[j] += d_pre[k] * w_hh[j * G + k];
+          if (t)
+            ref_dw[j * G + k] += hidden[(t - 1) * RU + j] * d_pre[k];
+        }
+      }
+    }
+  }
+
+  for (size_t i = 0; i < dw.size(); ++i)
+    EXPECT_NEAR(dw[i], ref_dw[i], tolerance);
+}
+
+/**
+ * @brief run a GRU over [RB, RT] with the batched step kernels and compare
+ * the forward and the backward with a naive backpropagation through time
+ */
+static void testGRUKernel(bool reset_after) {
+  const unsigned int G = 3 * RU, ld_gate = RT * G, ld_state = RT * RU;
+  auto x_proj = attentionInput(RB * RT * G, 0.6f);
+  auto w_hh = attentionInput(RU * G, 1.9f);
+  auto bias_hh_g = attentionInput(RU, 0.2f);
+  auto dy = attentionInput(RB * RT * RU, 2.7f);
+
+  std::vector<float> zrg = x_proj, h(RB * RT * RU, 0.0f);
+  std::vector<float> workspace(2 * RB * RU, 0.0f);
+  for (unsigned int t = 0; t < RT; ++t)
+    nntrainer::gru_step_forward(
+      RB, RU, zrg.data() + t * G, ld_gate,
+      t ? h.data() + (t - 1) * RU : nullptr, h.data() + t * RU, ld_state,
+      w_hh.data(), bias_hh_g.data(), reset_after, test_tanh, test_sigmoid,
+      workspace.data());
+
+  std::vector<float> dh = dy, d_zrg(RB * RT * G, 0.0f);
+  std::vector<float> dw(RU * G, 0.0f), db(RU, 0.0f);
+  for (unsigned int t = RT; t-- > 0;) {
+    const size_t gate = t * G, state = t * RU;
+    nntrainer::gru_step_backward(
+      RB, RU, zrg.data() + gate, d_zrg.data() + gate, ld_gate,
+      t ? h.data() + state - RU : nullptr, dh.data() + state,
+      t ? dh.data() + state - RU : nullptr, ld_state, w_hh.data(),
+      bias_hh_g.data(), reset_after, dw.data(), db.data(), test_tanh,
+      test_sigmoid, workspace.data());
+  }
+
+  /** naive forward and backpropagation through time per sample */
+  std::vector<float> ref_dw(RU * G, 0.0f), ref_db(RU, 0.0f);
+  for (unsigned int b = 0; b < RB; ++b) {
+    std::vector<float> z(RT * RU), r(RT * RU), g(RT * RU), hw(RT * RU),
+      hidden((RT + 1) * RU, 0.0f);
+    for (unsigned int t = 0; t < RT; ++t) {
+      const float *gate = x_proj.data() + (b * RT + t) * G;
+      const float *h_prev = hidden.data() + t * RU;
+      for (unsigned int u = 0; u < RU; ++u) {
+        float pre_z = gate[u], pre_r = gate[RU + u];
+        for (unsigned int j = 0; j < RU; ++j) {
+          pre_z += h_prev[j] * w_hh[j * G + u];
+          pre_r += h_prev[j] * w_hh[j * G + RU + u];
+        }
+        z[t * RU + u] = testSigmoid(pre_z);
+        r[t * RU + u] = testSigmoid(pre_r);
+      }
+      for (unsigned int u = 0; u < RU; ++u) {
+        float proj = 0.0f;
+        for (unsigned int j = 0; j < RU; ++j)
+          proj += (reset_after ? h_prev[j] : r[t * RU + j] * h_prev[j]) *
+                  w_hh[j * G + 2 * RU + u];
+        hw[t * RU + u] = proj + bias_hh_g[u];
+        const float recurrent =
+          reset_after ? r[t * RU + u] * hw[t * RU + u] : proj;
+        g[t * RU + u] = std::tanh(gate[2 * RU + u] + recurrent);
+        hidden[(t + 1) * RU + u] =
+          z[t * RU + u] * h_prev[u] + (1.0f - z[t * RU + u]) * g[t * RU + u];
+        EXPECT_NEAR(h[(b * RT + t) * RU + u], hidden[(t + 1) * RU + u],
+                    tolerance);
+      }
+    }
+
+    std::vector<float> dh_next(RU, 0.0f), d_pre(G), d_hw(RU), d_reset(RU);
+    for (unsigned int t = RT; t-- > 0;) {
+      const float *h_prev = hidden.data() + t * RU;
+      std::vector<float> dh_prev(RU, 0.0f);
+      for (unsigned int u = 0; u < RU; ++u) {
+        const float zu = z[t * RU + u], gu = g[t * RU + u];
+        const float d = dy[(b * RT + t) * RU + u] + dh_next[u];
+        d_pre[u] = d * (h_prev[u] - gu) * zu * (1 - zu);
+        d_pre[2 * RU + u] = d * (1 - zu) * (1 - gu * gu);
+        dh_prev[u] += d * zu;
+      }
+
+      if (reset_after) {
+        for (unsigned int u = 0; u < RU; ++u) {
+          d_reset[u] = d_pre[2 * RU + u] * hw[t * RU + u];
+          d_hw[u] = d_pre[2 * RU + u] * r[t * RU + u];
+          ref_db[u] += d_hw[u];
+        }
+        for (unsigned int j = 0; j < RU; ++j) {
+          for (unsigned int u = 0; u < RU; ++u) {
+            dh_prev[j] += d_hw[u] * w_hh[j * G + 2 * RU + u];
+            ref_dw[j * G + 2 * RU + u] += h_prev[j] * d_hw[u];
+          }
+        }
+      } else {
+        /** the candidate bias is a part of the input projection here */
+        for (unsigned int u = 0; u < RU; ++u)
+          ref_db[u] += d_pre[2 * RU + u];
+        for (unsigned int j = 0; j < RU; ++j) {
+          float d_reset_h = 0.0f;
+          for (unsigned int u = 0; u < RU; ++u) {
+            d_reset_h += d_pre[2 * RU + u] * w_hh[j * G + 2 * RU + u];
+            ref_dw[j * G + 2 * RU + u] +=
+              r[t * RU + j] * h_prev[j] * d_pre[2 * RU + u];
+          }
+          d_reset[j] = d_reset_h * h_prev[j];
+          dh_prev[j] += d_reset_h * r[t * RU + j];
+        }
+      }
+
+      for (unsigned int u = 0; u < RU; ++u) {
+        const float ru = r[t * RU + u];
+        d_pre[RU + u] = d_reset[u] * ru * (1 - ru);
+      }
+      for (unsigned int k = 0; k < G; ++k)
+        EXPECT_NEAR(d_zrg[(b * RT + t) * G + k], d_pre[k], tolerance);
+
+      for (unsigned int j = 0; j < RU; ++j) {
+        for (unsigned int k = 0; k < 2 * RU; ++k) {
+          dh_prev[j] += d_pre[k] * w_hh[j * G + k];
+          ref_dw[j * G + k] += h_prev[j] * d_pre[k];
+        }
+      }
+      dh_next = dh_prev;
+    }
+  }
+
+  for (size_t i = 0; i < dw.size(); ++i)
+    EXPECT_NEAR(dw[i], ref_dw[i], tolerance);
+  for (unsigned int u = 0; u < RU; ++u)
+    EXPECT_NEAR(db[u], ref_db[u], tolerance);
+}
+
+TEST(nntrainer_recurrent_kernel, gru_p) { testGRUKernel(false); }
+
+TEST(nntrainer_recurrent_kernel, gru_reset_after_p) { testGRUKernel(true); }
+
+TEST(nntrainer_recurrent_kernel, rnn_p) {
+  const unsigned int ld_state = RT * RU;
+  auto x_proj = attentionInput(RB * RT * RU, 0.8f);
+  auto w_hh = attentionInput(RU * RU, 1.4f);
+  auto dy = attentionInput(RB * RT * RU, 0.5f);
+
+  std::vector<float> h = x_proj;
+  for (unsigned int t = 0; t < RT; ++t)
+    nntrainer::rnn_step_forward(RB, RU, t ? h.data() + (t - 1) * RU : nullptr,
+                                h.data() + t * RU, ld_state, w_hh.data(),
+                                test_tanh);
+
+  /** naive forward and backward per sample */
+  std::vector<float> ref_dx(RB * RT * RU, 0.0f), ref_dw(RU * RU, 0.0f);
+  for (unsigned int b = 0; b < RB; ++b) {
+    std::vector<float> h_prev(RU, 0.0f);
+    for (unsigned int t = 0; t < RT; ++t) {
+      for (unsigned int u = 0; u < RU; ++u) {
+        float pre = x_proj[(b * RT + t) * RU + u];
+        for (unsigned int j = 0; j < RU; ++j)
+          pre += h_prev[j] * w_hh[j * RU + u];
+        EXPECT_NEAR(h[(b * RT + t) * RU + u], std::tanh(pre), tolerance);
+      }
+      std::copy(h.begin() + (b * RT + t) * RU,
+                h.begin() + (b * RT + t + 1) * RU, h_prev.begin());
+    }
+
+    std::vector<float> dh_next(RU, 0.0f);
+    for (unsigned int t = RT; t-- > 0;) {
+      std::vector<float> d_pre(RU);
+      for (unsigned int u = 0; u < RU; ++u) {
+        const float y = h[(b * RT + t) * RU + u];
+        d_pre[u] = (dy[(b * RT + t) * RU + u] + dh_next[u]) * (1 - y * y);
+        ref_dx[(b * RT + t) * RU + u] = d_pre[u];
+      }
+      for (unsigned int j = 0; j < RU; ++j) {
+        dh_next[j] = 0.0f;
+        for (unsigned int u = 0; u < RU; ++u) {
+          dh_next[j] += d_pre[u] * w_hh[j * RU + u];
+          if (t)
+            ref_dw[j * RU + u] += h[(b * RT + t - 1) * RU + j] * d_pre[u];
+        }
+      }
+    }
+  }
+
+  std::vector<float> dh = dy, dw(RU * RU, 0.0f);
+  for (unsigned int t = RT; t-- > 0;)
+    nntrainer::rnn_step_backward(
+      RB, RU, t ? h.data() + (t - 1) * RU : nullptr, h.data() + t * RU,
+      dh.data() + t * RU, t ? dh.data() + (t - 1) * RU : nullptr, ld_state,
+      w_hh.data(), dw.data(), test_tanh);
+
+  for (size_t i = 0; i < dh.size(); ++i)
+    EXPECT_NEAR(dh[i], ref_dx[i], tolerance);
+  for (size_t i = 0; i < dw.size(); ++i)
+    EXPECT_NEAR(dw[i], ref_dw[i], tolerance);
+}
+
+/**
+ * @brief write a small byte level vocabulary and its merges
+ */
+static void writeTokenizerFiles(const std::string &vocab_path,
+                                const std::string &merges_path) {
+  std::ofstream vocab(vocab_path);
+  vocab << R"({"h": 0, "e": 1, "l": 2, "o": 3, "Ġ": 4, "w": 5, "r": 6,)"
+        << R"( "d": 7, "he": 8, "ll": 9, "hell": 10, "hello": 11,)"
+        << R"( "Ġw": 12, "or": 13, "Ġwor": 14, "!": 15})";
+
+  std::ofstream merges(merges_path);
+  merges << "#version: 0.2\nh e\nl l\nhe ll\nhell o\n\xc4\xa0 w\no r\n"
+         << "\xc4\xa0w or\n";
+}
+
+TEST(nntrainer_bpe_tokenizer, encode_decode_p) {
+  writeTokenizerFiles("bpe_vocab.json", "bpe_merges.txt");
+  auto tokenizer =
+    nntrainer::BPETokenizer::loadText("bpe_vocab.json", "bpe_merges.txt");
+
+  std::vector<unsigned int> tokens = tokenizer->encode("hello world!");
+  EXPECT_EQ(tokens, std::vector<unsigned int>({11, 14, 2, 7, 15}));
+  EXPECT_EQ(tokenizer->decode(tokens), "hello world!");
+  EXPECT_EQ(tokenizer->getVocabSize(), 16u);
+
+  EXPECT_EQ(tokenizer->encode("hello hello"),
+            std::vector<unsigned int>({11, 4, 11}));
+  EXPECT_GT(tokenizer->getCacheHits(), 0u);
+
+  std::remove("bpe_vocab.json");
+  std::remove("bpe_merges.txt");
+}
+
+TEST(nntrainer_bpe_tokenizer, save_load_batch_p) {
+  writeTokenizerFiles("bpe_vocab.json", "bpe_merges.txt");
+  auto tokenizer =
+    nntrainer::BPETokenizer::loadText("bpe_vocab.json", "bpe_merges.txt", 0);
+  tokenizer->save("bpe_tokenizer.bin");
+  auto loaded = nntrainer::BPETokenizer::load("bpe_tokenizer.bin");
+
+  std::vector<std::string> texts;
+  for (unsigned int i = 0; i < 100; ++i)
+    texts.push_back(std::string(i % 7, 'l') + " world hello  " +
+                    std::string(i % 3, '!'));
+
+  std::vector<std::vector<unsigned int>> batch = loaded->encodeBatch(texts);
+  ASSERT_EQ(batch.size(), texts.size());
+  for (unsigned int i = 0; i < texts.size(); ++i) {
+    EXPECT_EQ(batch[i], tokenizer->encode(texts[i]));
+    EXPECT_EQ(loaded->decode(batch[i]), texts[i]);
+  }
+
+  std::remove("bpe_vocab.json");
+  std::remove("bpe_merges.txt");
+  std::remove("bpe_tokenizer.bin");
+}
+
+TEST(nntrainer_bpe_tokenizer, batch_throughput_p) {
+  writeTokenizerFiles("bpe_vocab.json", "bpe_merges.txt");
+  auto serial =
+    nntrainer::BPETokenizer::loadText("bpe_vocab.json", "bpe_merges.txt");
+  auto batched =
+    nntrainer::BPETokenizer::loadText("bpe_vocab.json", "bpe_merges.txt");
+
+  /** many short words repeated over the texts, so that most of them are
+   * encoded from the caches */
+  const std::string letters = "helowrd!";
+  std::mt19937 rng(0);
+  std::vector<std::string> texts(2000);
+  for (auto &text : texts) {
+    for (unsigned int w = 0; w < 64; ++w) {
+      text += ' ';
+      for (unsigned int c = rng() % 6 + 1; c > 0; --c)
+        text += letters[rng() % letters.size()];
+    }
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::vector<unsigned int>> expected;
+  for (auto &text : texts)
+    expected.push_back(serial->encode(text));
+  auto serial_time = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  std::vector<std::vector<unsigned int>> batch = batched->encodeBatch(texts);
+  auto batch_time = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(batch, expected);
+  EXPECT_GT(batched->getCacheHits(), 0u);
+  /** the workers do not share a lock, so the batch is never much slower than
+   * a single thread even without spare cores */
+  EXPECT_LT(batch_time, serial_time * 2);
+
+  std::remove("bpe_vocab.json");
+  std::remove("bpe_merges.txt");
+}
+
+TEST(nntrainer_bpe_tokenizer, invalid_n) {
+  writeTokenizerFiles("bpe_vocab.json", "bpe_merges.txt");
+  EXPECT_THROW(nntrainer::BPETokenizer::load("bpe_not_exist.bin"),
+               std::invalid_argument);
+  EXPECT_THROW(nntrainer::BPETokenizer::load("bpe_vocab.json"),
+               std::invalid_argument);
+  EXPECT_THROW(
+    nntrainer::BPETokenizer::loadText("bpe_merges.txt", "bpe_merges.txt"),
+    std::invalid_argument);
+
+  auto tokenizer =
+    nntrainer::BPETokenizer::loadText("bpe_vocab.json", "bpe_merges.txt");
+  EXPECT_THROW(tokenizer->encode("x"), std::invalid_argument);
+  EXPECT_THROW(tokenizer->decode({16}), std::invalid_argument);
+
+  std::remove("bpe_vocab.json");
+  std::remove("bpe_merges.txt");
+}
+
 /**
  * @brief Main gtest
  */